@@ -247,6 +247,8 @@ DemoEntityManager::DemoEntityManager ()
 	,m_suspendPhysicsUpdate(false)
 	,m_asynchronousPhysicsUpdate(false)
 	,m_solveLargeIslandInParallel(false)
+	,m_recordProfilerTrace(false)
+	,m_profilerRecording(false)
 {
 	// Setup window
 	glfwSetErrorCallback(ErrorCallback);
@@ -388,6 +390,10 @@ DemoEntityManager::~DemoEntityManager ()
 		NewtonWaitForUpdateToFinish (m_world);
 	}
 
+	if (m_profilerRecording) {
+		NewtonProfilerStop();
+	}
+
 	Cleanup ();
 
 	// destroy the empty world
@@ -650,6 +656,16 @@ void DemoEntityManager::ApplyMenuOptions()
 	NewtonSelectBroadphaseAlgorithm(m_world, m_broadPhaseType);
 	NewtonSetParallelSolverOnLargeIsland (m_world, m_solveLargeIslandInParallel ? 1 : 0);	
 
+	// the trace is saved to newtonTrace.json when the option is turned off
+	if (m_recordProfilerTrace != m_profilerRecording) {
+		if (m_recordProfilerTrace) {
+			m_recordProfilerTrace = NewtonProfilerStart("newtonTrace.json") ? true : false;
+		} else {
+			NewtonProfilerStop();
+		}
+		m_profilerRecording = m_recordProfilerTrace;
+	}
+
 	void* plugin = NULL;
 	if (m_currentPlugin) {
 		int index = 1;
@@ -728,6 +744,7 @@ void DemoEntityManager::ShowMainMenuBar()
 			ImGui::Checkbox("show stats", &m_showStats);
 			ImGui::Checkbox("concurrent physics update", &m_asynchronousPhysicsUpdate);
 			ImGui::Checkbox("solve large island in parallel", &m_solveLargeIslandInParallel);
+			ImGui::Checkbox("record profiler trace", &m_recordProfilerTrace);
 			ImGui::Separator();
 
 			int index = 0;
@@ -750,6 +767,7 @@ void DemoEntityManager::ShowMainMenuBar()
 
 			ImGui::RadioButton("default broad phase", &m_broadPhaseType, 0);
 			ImGui::RadioButton("persistence broad phase", &m_broadPhaseType, 1);
+			ImGui::RadioButton("simd bvh4 broad phase", &m_broadPhaseType, 2);
 			ImGui::Separator();
 
 			ImGui::RadioButton("hide collision Mesh", &m_collisionDisplayMode, 0);
@@ -938,6 +956,34 @@ void DemoEntityManager::RenderStats()
 			sprintf(text, "iterations:	%d", NewtonGetSolverIterations(m_world));
 			ImGui::Text(text);
 
+			NewtonWorldStepStats stepStats;
+			NewtonWorldGetStepStats(m_world, &stepStats);
+			sprintf (text, "contacts:      %d", stepStats.m_contactCount);
+			ImGui::Text(text);
+
+			sprintf (text, "islands:       %d", stepStats.m_islandCount);
+			ImGui::Text(text);
+
+			sprintf (text, "broadphase:    %6.3f ms", stepStats.m_broadPhaseTime * 1000.0f);
+			ImGui::Text(text);
+
+			sprintf (text, "narrowphase:   %6.3f ms", stepStats.m_narrowPhaseTime * 1000.0f);
+			ImGui::Text(text);
+
+			sprintf (text, "islands build: %6.3f ms", stepStats.m_clusterBuildTime * 1000.0f);
+			ImGui::Text(text);
+
+			sprintf (text, "solver:        %6.3f ms", stepStats.m_solverTime * 1000.0f);
+			ImGui::Text(text);
+
+			sprintf (text, "transforms:    %6.3f ms", stepStats.m_transformUpdateTime * 1000.0f);
+			ImGui::Text(text);
+
+			for (int i = 0; i < stepStats.m_threadCount; i ++) {
+				sprintf (text, "thread %2d busy: %6.3f ms", i, stepStats.m_threadBusyTime[i] * 1000.0f);
+				ImGui::Text(text);
+			}
+
 			m_suspendPhysicsUpdate = m_suspendPhysicsUpdate || (ImGui::IsMouseHoveringWindow() && ImGui::IsMouseDown(0));  
 			ImGui::End();
 		}
@@ -202,6 +202,8 @@ class DemoEntityManager: public dList <DemoEntity*>
 	bool m_suspendPhysicsUpdate;
 	bool m_asynchronousPhysicsUpdate;
 	bool m_solveLargeIslandInParallel;
+	bool m_recordProfilerTrace;
+	bool m_profilerRecording;
 
 	static SDKDemos m_demosSelection[];
 	friend class DemoEntityListener;
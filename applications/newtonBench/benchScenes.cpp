@@ -0,0 +1,731 @@
+/* Copyright (c) <2003-2016> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+#include "newtonBenchStdafx.h"
+#include "benchScenes.h"
+#include "dCustomHinge.h"
+#include "dCustomBallAndSocket.h"
+
+#define BENCH_GRAVITY	dFloat (-10.0f)
+
+
+static void ApplyGravity (const NewtonBody* const body, dFloat timestep, int threadIndex)
+{
+	dFloat mass;
+	dFloat Ixx;
+	dFloat Iyy;
+	dFloat Izz;
+	NewtonBodyGetMass (body, &mass, &Ixx, &Iyy, &Izz);
+	dVector force (0.0f, mass * BENCH_GRAVITY, 0.0f, 0.0f);
+	NewtonBodySetForce (body, &force.m_x);
+}
+
+// all scenes are built from a fixed seed, so that every run simulates the same content
+static dFloat BenchRandom (unsigned& seed)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return dFloat (seed >> 8) / dFloat (1 << 24);
+}
+
+static int ScaleCount (int count, dFloat scale, int minCount)
+{
+	return dMax (minCount, int (dFloat (count) * scale + 0.5f));
+}
+
+static NewtonCollision* CreateRandomConvexHull (NewtonWorld* const world, dFloat radius, unsigned& seed)
+{
+	dVector points[16];
+	for (int i = 0; i < 16; i ++) {
+		dVector dir (BenchRandom (seed) * 2.0f - 1.0f, BenchRandom (seed) * 2.0f - 1.0f, BenchRandom (seed) * 2.0f - 1.0f, 0.0f);
+		dir = dir.Scale (radius / dSqrt (dir.DotProduct3 (dir) + 1.0e-6f));
+		points[i] = dir;
+	}
+	return NewtonCreateConvexHull (world, 16, &points[0].m_x, sizeof (dVector), 0.0f, 0, NULL);
+}
+
+static NewtonCollision* CreateMixedShape (NewtonWorld* const world, int index, unsigned& seed)
+{
+	switch (index % 6)
+	{
+		case 0:
+			return NewtonCreateBox (world, 0.8f, 0.8f, 0.8f, 0, NULL);
+		case 1:
+			return NewtonCreateSphere (world, 0.4f, 0, NULL);
+		case 2:
+			return NewtonCreateCapsule (world, 0.3f, 0.3f, 1.0f, 0, NULL);
+		case 3:
+			return NewtonCreateCylinder (world, 0.4f, 0.4f, 0.8f, 0, NULL);
+		case 4:
+			return NewtonCreateChamferCylinder (world, 0.4f, 0.3f, 0, NULL);
+		default:
+			return CreateRandomConvexHull (world, 0.5f, seed);
+	}
+}
+
+
+BenchScene::BenchScene(NewtonWorld* const world)
+	:m_world(world)
+{
+}
+
+BenchScene::~BenchScene()
+{
+}
+
+void BenchScene::PreUpdate(int step, dFloat timestep)
+{
+}
+
+bool BenchScene::HasQueries() const
+{
+	return false;
+}
+
+void BenchScene::RunQueries(int step)
+{
+}
+
+NewtonWorld* BenchScene::GetWorld() const
+{
+	return m_world;
+}
+
+NewtonBody* BenchScene::CreateSolid(NewtonCollision* const collision, const dMatrix& matrix, dFloat mass)
+{
+	NewtonBody* const body = NewtonCreateDynamicBody (m_world, collision, &matrix[0][0]);
+	if (mass > 0.0f) {
+		NewtonBodySetMassProperties (body, mass, collision);
+		NewtonBodySetForceAndTorqueCallback (body, ApplyGravity);
+	}
+	return body;
+}
+
+void BenchScene::AddFloorBox(const dVector& size)
+{
+	// the top face of the floor is at zero elevation
+	NewtonCollision* const collision = NewtonCreateBox (m_world, size.m_x, size.m_y, size.m_z, 0, NULL);
+	dMatrix matrix (dGetIdentityMatrix());
+	matrix.m_posit.m_y = -size.m_y * 0.5f;
+	CreateSolid (collision, matrix, 0.0f);
+	NewtonDestroyCollision (collision);
+}
+
+
+// BasicStacking: box pyramids and box towers on a flat floor
+class StackingScene: public BenchScene
+{
+	public:
+	StackingScene(NewtonWorld* const world, dFloat scale)
+		:BenchScene(world)
+	{
+		AddFloorBox (dVector (200.0f, 1.0f, 200.0f, 0.0f));
+
+		const int base = ScaleCount (20, dSqrt (scale), 4);
+		for (int i = 0; i < 4; i ++) {
+			BuildPyramid (dVector (-15.0f + i * 10.0f, 0.0f, 0.0f, 0.0f), dVector (0.5f, 0.25f, 0.8f, 0.0f), base);
+		}
+
+		const int high = ScaleCount (20, scale, 4);
+		for (int i = 0; i < 4; i ++) {
+			BuildTower (dVector (-15.0f + i * 10.0f, 0.0f, 15.0f, 0.0f), dVector (0.5f, 0.5f, 0.5f, 0.0f), high);
+		}
+	}
+
+	void BuildPyramid (const dVector& origin, const dVector& size, int count)
+	{
+		NewtonCollision* const collision = NewtonCreateBox (m_world, size.m_x, size.m_y, size.m_z, 0, NULL);
+
+		const dFloat stepz = size.m_z + 0.03125f;
+		const dFloat stepy = size.m_y - 0.01f;
+
+		dMatrix matrix (dGetIdentityMatrix());
+		matrix.m_posit = origin;
+		matrix.m_posit.m_w = 1.0f;
+		matrix.m_posit.m_y = size.m_y * 0.5f;
+
+		dFloat z0 = origin.m_z - stepz * count / 2;
+		for (int j = 0; j < count; j ++) {
+			matrix.m_posit.m_z = z0;
+			for (int i = 0; i < (count - j); i ++) {
+				CreateSolid (collision, matrix, 10.0f);
+				matrix.m_posit.m_z += stepz;
+			}
+			z0 += stepz * 0.5f;
+			matrix.m_posit.m_y += stepy;
+		}
+		NewtonDestroyCollision (collision);
+	}
+
+	void BuildTower (const dVector& origin, const dVector& size, int count)
+	{
+		NewtonCollision* const collision = NewtonCreateBox (m_world, size.m_x, size.m_y, size.m_z, 0, NULL);
+
+		dMatrix matrix (dGetIdentityMatrix());
+		matrix.m_posit = origin;
+		matrix.m_posit.m_w = 1.0f;
+		matrix.m_posit.m_y = size.m_y * 0.5f;
+		for (int i = 0; i < count; i ++) {
+			CreateSolid (collision, matrix, 5.0f);
+			matrix.m_posit.m_y += size.m_y;
+		}
+		NewtonDestroyCollision (collision);
+	}
+};
+
+
+// DynamicRagdoll: piles of ragdolls made of capsules linked by ball and socket joints with cone limits
+class RagdollScene: public BenchScene
+{
+	public:
+	RagdollScene(NewtonWorld* const world, dFloat scale)
+		:BenchScene(world)
+		,m_ragdollID(0)
+	{
+		AddFloorBox (dVector (200.0f, 1.0f, 200.0f, 0.0f));
+
+		// like the sandbox ragdolls, bones of the same ragdoll do not collide with each other
+		const int defaultMaterial = NewtonMaterialGetDefaultGroupID (m_world);
+		NewtonMaterialSetCollisionCallback (m_world, defaultMaterial, defaultMaterial, SelfCollisionTest, NULL);
+
+		const int count = ScaleCount (24, scale, 1);
+		for (int i = 0; i < count; i ++) {
+			// collision user ids tag the bones with their ragdoll, the floor keeps id zero
+			m_ragdollID = unsigned (i + 1);
+			const int column = i % 24;
+			const int layer = i / 24;
+			dMatrix frame (dYawMatrix (dFloat (i) * 0.7f));
+			frame.m_posit = dVector ((column % 6) * 3.0f - 7.5f, 0.5f + layer * 2.2f, (column / 6) * 3.0f - 4.5f, 1.0f);
+			BuildRagdoll (frame);
+		}
+	}
+
+	static int SelfCollisionTest (const NewtonJoint* const contact, dFloat timestep, int threadIndex)
+	{
+		const unsigned id0 = NewtonCollisionGetUserID (NewtonBodyGetCollision (NewtonJointGetBody0 (contact)));
+		const unsigned id1 = NewtonCollisionGetUserID (NewtonBodyGetCollision (NewtonJointGetBody1 (contact)));
+		return (id0 && (id0 == id1)) ? 0 : 1;
+	}
+
+	NewtonBody* AddBone (NewtonCollision* const collision, const dMatrix& frame, const dMatrix& localMatrix, dFloat mass)
+	{
+		NewtonCollisionSetUserID (collision, m_ragdollID);
+		NewtonBody* const body = CreateSolid (collision, localMatrix * frame, mass);
+		NewtonDestroyCollision (collision);
+		return body;
+	}
+
+	void AddJoint (const dMatrix& frame, const dVector& pivot, const dVector& pin, NewtonBody* const child, NewtonBody* const parent, dFloat coneAngle)
+	{
+		// the core ball joint does not enforce its cone limits, so the limbs would fold
+		// into the body and fight the contacts, the custom joint does enforce them
+		// once the limits are enabled, they are off by default
+		dMatrix pinAndPivot (dGrammSchmidt (frame.RotateVector (pin)));
+		pinAndPivot.m_posit = frame.TransformVector (pivot);
+		dCustomBallAndSocket* const joint = new dCustomBallAndSocket (pinAndPivot, child, parent);
+		joint->EnableCone (true);
+		joint->SetConeLimits (coneAngle);
+		joint->EnableTwist (true);
+		joint->SetTwistLimits (-30.0f * dDegreeToRad, 30.0f * dDegreeToRad);
+	}
+
+	void BuildRagdoll (const dMatrix& frame)
+	{
+		// capsules are aligned to the x axis, the roll matrix makes them vertical
+		const dMatrix vertical (dRollMatrix (0.5f * dPi));
+		const dVector up (0.0f, 1.0f, 0.0f, 0.0f);
+		const dVector down (0.0f, -1.0f, 0.0f, 0.0f);
+		const dVector side (1.0f, 0.0f, 0.0f, 0.0f);
+
+		dMatrix matrix (dGetIdentityMatrix());
+		matrix.m_posit = dVector (0.0f, 1.0f, 0.0f, 1.0f);
+		NewtonBody* const pelvis = AddBone (NewtonCreateBox (m_world, 0.35f, 0.2f, 0.2f, 0, NULL), frame, matrix, 10.0f);
+
+		matrix = vertical;
+		matrix.m_posit = dVector (0.0f, 1.4f, 0.0f, 1.0f);
+		NewtonBody* const torso = AddBone (NewtonCreateCapsule (m_world, 0.15f, 0.15f, 0.5f, 0, NULL), frame, matrix, 15.0f);
+		AddJoint (frame, dVector (0.0f, 1.12f, 0.0f, 1.0f), up, torso, pelvis, 30.0f * dDegreeToRad);
+
+		matrix = dGetIdentityMatrix();
+		matrix.m_posit = dVector (0.0f, 1.82f, 0.0f, 1.0f);
+		NewtonBody* const head = AddBone (NewtonCreateSphere (m_world, 0.12f, 0, NULL), frame, matrix, 4.0f);
+		AddJoint (frame, dVector (0.0f, 1.7f, 0.0f, 1.0f), up, head, torso, 45.0f * dDegreeToRad);
+
+		for (int i = 0; i < 2; i ++) {
+			const dFloat sign = i ? -1.0f : 1.0f;
+			const dVector armPin (side.Scale (sign));
+
+			matrix = dGetIdentityMatrix();
+			matrix.m_posit = dVector (sign * 0.38f, 1.55f, 0.0f, 1.0f);
+			NewtonBody* const upperArm = AddBone (NewtonCreateCapsule (m_world, 0.06f, 0.06f, 0.3f, 0, NULL), frame, matrix, 2.0f);
+			AddJoint (frame, dVector (sign * 0.2f, 1.55f, 0.0f, 1.0f), armPin, upperArm, torso, 80.0f * dDegreeToRad);
+
+			matrix.m_posit = dVector (sign * 0.72f, 1.55f, 0.0f, 1.0f);
+			NewtonBody* const lowerArm = AddBone (NewtonCreateCapsule (m_world, 0.05f, 0.05f, 0.3f, 0, NULL), frame, matrix, 1.5f);
+			AddJoint (frame, dVector (sign * 0.55f, 1.55f, 0.0f, 1.0f), armPin, lowerArm, upperArm, 60.0f * dDegreeToRad);
+
+			matrix = vertical;
+			matrix.m_posit = dVector (sign * 0.1f, 0.68f, 0.0f, 1.0f);
+			NewtonBody* const thigh = AddBone (NewtonCreateCapsule (m_world, 0.08f, 0.08f, 0.4f, 0, NULL), frame, matrix, 5.0f);
+			AddJoint (frame, dVector (sign * 0.1f, 0.9f, 0.0f, 1.0f), down, thigh, pelvis, 50.0f * dDegreeToRad);
+
+			matrix.m_posit = dVector (sign * 0.1f, 0.24f, 0.0f, 1.0f);
+			NewtonBody* const shin = AddBone (NewtonCreateCapsule (m_world, 0.07f, 0.07f, 0.4f, 0, NULL), frame, matrix, 3.5f);
+			AddJoint (frame, dVector (sign * 0.1f, 0.46f, 0.0f, 1.0f), down, shin, thigh, 40.0f * dDegreeToRad);
+		}
+	}
+
+	unsigned m_ragdollID;
+};
+
+
+// HeavyVehicles: six wheeled trucks driving over a height field terrain,
+// the wheels are hinged to the chassis and driven by a torque along the axle
+class VehicleScene: public BenchScene
+{
+	public:
+	VehicleScene(NewtonWorld* const world, dFloat scale)
+		:BenchScene(world)
+	{
+		const int size = 129;
+		const dFloat cellSize = 1.0f;
+		dFloat* const elevation = new dFloat[size * size];
+		char* const attributes = new char[size * size];
+		for (int z = 0; z < size; z ++) {
+			for (int x = 0; x < size; x ++) {
+				elevation[z * size + x] = Elevation (x * cellSize, z * cellSize);
+				attributes[z * size + x] = 0;
+			}
+		}
+		NewtonCollision* const terrain = NewtonCreateHeightFieldCollision (m_world, size, size, 0, 0, elevation, attributes, 1.0f, cellSize, cellSize, 0);
+		delete[] attributes;
+		delete[] elevation;
+
+		m_origin = dVector (-0.5f * (size - 1) * cellSize, 0.0f, -0.5f * (size - 1) * cellSize, 1.0f);
+		dMatrix matrix (dGetIdentityMatrix());
+		matrix.m_posit = m_origin;
+		CreateSolid (terrain, matrix, 0.0f);
+		NewtonDestroyCollision (terrain);
+
+		const int count = ScaleCount (8, scale, 1);
+		for (int i = 0; i < count; i ++) {
+			const dFloat x = (i % 6) * 12.0f - 30.0f;
+			const dFloat z = (i / 6) * 14.0f - 40.0f;
+			BuildVehicle (dVector (x, Elevation (x - m_origin.m_x, z - m_origin.m_z) + 3.0f, z, 1.0f));
+		}
+	}
+
+	static dFloat Elevation (dFloat x, dFloat z)
+	{
+		return 1.5f * dSin (x * 0.15f) * dCos (z * 0.11f) + 0.5f * dSin (x * 0.37f + z * 0.23f) + 2.0f;
+	}
+
+	static void ApplyDriveTorque (const NewtonBody* const body, dFloat timestep, int threadIndex)
+	{
+		ApplyGravity (body, timestep, threadIndex);
+
+		// wheels are chamfer cylinders aligned to the x axis, which is also the hinge pin
+		dMatrix matrix;
+		NewtonBodyGetMatrix (body, &matrix[0][0]);
+		dVector torque (matrix.m_front.Scale (1500.0f));
+		NewtonBodySetTorque (body, &torque.m_x);
+	}
+
+	void BuildVehicle (const dVector& origin)
+	{
+		dMatrix matrix (dGetIdentityMatrix());
+		matrix.m_posit = origin;
+
+		NewtonCollision* const chassisShape = NewtonCreateBox (m_world, 3.0f, 1.0f, 7.0f, 0, NULL);
+		NewtonBody* const chassis = CreateSolid (chassisShape, matrix, 3000.0f);
+		NewtonDestroyCollision (chassisShape);
+
+		NewtonCollision* const wheelShape = NewtonCreateChamferCylinder (m_world, 0.6f, 0.5f, 0, NULL);
+		for (int i = 0; i < 6; i ++) {
+			dMatrix wheelMatrix (matrix);
+			wheelMatrix.m_posit += dVector ((i & 1) ? 1.8f : -1.8f, -0.7f, (i / 2) * 2.5f - 2.5f, 0.0f);
+			NewtonBody* const wheel = CreateSolid (wheelShape, wheelMatrix, 80.0f);
+			NewtonBodySetForceAndTorqueCallback (wheel, ApplyDriveTorque);
+			new dCustomHinge (wheelMatrix, wheel, chassis);
+		}
+		NewtonDestroyCollision (wheelShape);
+	}
+
+	dVector m_origin;
+};
+
+
+// MeshCollision: a pile of mixed convex shapes dropped on a bumpy polygon soup level
+class MeshScene: public BenchScene
+{
+	public:
+	MeshScene(NewtonWorld* const world, dFloat scale)
+		:BenchScene(world)
+	{
+		const int cells = 48;
+		const dFloat cellSize = 2.0f;
+		NewtonCollision* const level = NewtonCreateTreeCollision (m_world, 0);
+		NewtonTreeCollisionBeginBuild (level);
+		for (int z = 0; z < cells; z ++) {
+			for (int x = 0; x < cells; x ++) {
+				dVector p0 (Point (x + 0, z + 0, cellSize));
+				dVector p1 (Point (x + 1, z + 0, cellSize));
+				dVector p2 (Point (x + 1, z + 1, cellSize));
+				dVector p3 (Point (x + 0, z + 1, cellSize));
+				dVector face0[] = {p0, p2, p1};
+				dVector face1[] = {p0, p3, p2};
+				NewtonTreeCollisionAddFace (level, 3, &face0[0].m_x, sizeof (dVector), 0);
+				NewtonTreeCollisionAddFace (level, 3, &face1[0].m_x, sizeof (dVector), 0);
+			}
+		}
+		NewtonTreeCollisionEndBuild (level, 1);
+
+		dMatrix matrix (dGetIdentityMatrix());
+		matrix.m_posit = dVector (-0.5f * cells * cellSize, 0.0f, -0.5f * cells * cellSize, 1.0f);
+		CreateSolid (level, matrix, 0.0f);
+		NewtonDestroyCollision (level);
+
+		unsigned seed = 12345;
+		NewtonCollision* shapes[6];
+		for (int i = 0; i < 6; i ++) {
+			shapes[i] = CreateMixedShape (m_world, i, seed);
+		}
+
+		const int count = ScaleCount (600, scale, 8);
+		for (int i = 0; i < count; i ++) {
+			const int slot = i % 144;
+			const int layer = i / 144;
+			dMatrix bodyMatrix (dYawMatrix (BenchRandom (seed) * dPi) * dRollMatrix (BenchRandom (seed) * dPi));
+			bodyMatrix.m_posit = dVector ((slot % 12) * 2.5f - 13.75f, 6.0f + layer * 2.5f, (slot / 12) * 2.5f - 13.75f, 1.0f);
+			CreateSolid (shapes[i % 6], bodyMatrix, 1.0f);
+		}
+
+		for (int i = 0; i < 6; i ++) {
+			NewtonDestroyCollision (shapes[i]);
+		}
+	}
+
+	static dVector Point (int x, int z, dFloat cellSize)
+	{
+		const dFloat px = x * cellSize;
+		const dFloat pz = z * cellSize;
+		return dVector (px, 2.0f * dSin (px * 0.1f) * dSin (pz * 0.13f), pz, 0.0f);
+	}
+};
+
+
+// MultiRayCasting: a field of resting bodies, each step casts a batch of vertical rays over it
+class RayCastScene: public BenchScene
+{
+	public:
+	RayCastScene(NewtonWorld* const world, dFloat scale)
+		:BenchScene(world)
+	{
+		AddFloorBox (dVector (200.0f, 1.0f, 200.0f, 0.0f));
+
+		unsigned seed = 54321;
+		NewtonCollision* shapes[6];
+		for (int i = 0; i < 6; i ++) {
+			shapes[i] = CreateMixedShape (m_world, i, seed);
+		}
+
+		const int count = ScaleCount (400, scale, 8);
+		const int side = int (dSqrt (dFloat (count))) + 1;
+		m_extend = side * 1.5f;
+		for (int i = 0; i < count; i ++) {
+			dMatrix matrix (dYawMatrix (BenchRandom (seed) * dPi));
+			matrix.m_posit = dVector ((i % side) * 3.0f - m_extend, 1.0f, (i / side) * 3.0f - m_extend, 1.0f);
+			CreateSolid (shapes[i % 6], matrix, 1.0f);
+		}
+
+		for (int i = 0; i < 6; i ++) {
+			NewtonDestroyCollision (shapes[i]);
+		}
+
+		m_rayCount = ScaleCount (2048, scale, 64);
+		m_p0 = new dVector[m_rayCount];
+		m_p1 = new dVector[m_rayCount];
+		m_hits = new NewtonWorldCastBatchHit[m_rayCount];
+	}
+
+	~RayCastScene()
+	{
+		delete[] m_hits;
+		delete[] m_p1;
+		delete[] m_p0;
+	}
+
+	virtual bool HasQueries() const
+	{
+		return true;
+	}
+
+	virtual void RunQueries(int step)
+	{
+		unsigned seed = unsigned (step) * 7919u + 1u;
+		for (int i = 0; i < m_rayCount; i ++) {
+			const dFloat x = (BenchRandom (seed) * 2.0f - 1.0f) * m_extend;
+			const dFloat z = (BenchRandom (seed) * 2.0f - 1.0f) * m_extend;
+			m_p0[i] = dVector (x, 20.0f, z, 0.0f);
+			m_p1[i] = dVector (x + 2.0f, -5.0f, z - 2.0f, 0.0f);
+		}
+		NewtonWorldRayCastBatch (m_world, &m_p0[0].m_x, &m_p1[0].m_x, sizeof (dVector), m_rayCount, NULL, NULL, m_hits);
+	}
+
+	dVector* m_p0;
+	dVector* m_p1;
+	NewtonWorldCastBatchHit* m_hits;
+	dFloat m_extend;
+	int m_rayCount;
+};
+
+
+// SimpleConvexFracturing: falling boxes that shatter into eight convex chunks once they land
+class FractureScene: public BenchScene
+{
+	public:
+	FractureScene(NewtonWorld* const world, dFloat scale)
+		:BenchScene(world)
+		,m_count(ScaleCount (100, scale, 4))
+	{
+		AddFloorBox (dVector (200.0f, 1.0f, 200.0f, 0.0f));
+
+		// one chunk per octant of the unit box, with the inner corners jittered so that the pieces are irregular
+		unsigned seed = 777;
+		for (int i = 0; i < 8; i ++) {
+			const dVector octant ((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f, 0.0f);
+			dVector points[8];
+			for (int j = 0; j < 8; j ++) {
+				dVector corner ((j & 1) ? octant.m_x : 0.0f, (j & 2) ? octant.m_y : 0.0f, (j & 4) ? octant.m_z : 0.0f, 0.0f);
+				if (j != 7) {
+					corner += dVector (octant.m_x * BenchRandom (seed), octant.m_y * BenchRandom (seed), octant.m_z * BenchRandom (seed), 0.0f).Scale (0.2f);
+				}
+				points[j] = corner;
+			}
+			m_chunks[i] = NewtonCreateConvexHull (m_world, 8, &points[0].m_x, sizeof (dVector), 0.0f, 0, NULL);
+		}
+
+		NewtonCollision* const box = NewtonCreateBox (m_world, 1.0f, 1.0f, 1.0f, 0, NULL);
+		m_boxes = new NewtonBody*[m_count];
+		for (int i = 0; i < m_count; i ++) {
+			const int slot = i % 100;
+			const int layer = i / 100;
+			dMatrix matrix (dYawMatrix (BenchRandom (seed) * dPi));
+			matrix.m_posit = dVector ((slot % 10) * 2.0f - 9.0f, 3.0f + layer * 2.0f, (slot / 10) * 2.0f - 9.0f, 1.0f);
+			m_boxes[i] = CreateSolid (box, matrix, 8.0f);
+		}
+		NewtonDestroyCollision (box);
+	}
+
+	~FractureScene()
+	{
+		delete[] m_boxes;
+		for (int i = 0; i < 8; i ++) {
+			NewtonDestroyCollision (m_chunks[i]);
+		}
+	}
+
+	virtual void PreUpdate(int step, dFloat timestep)
+	{
+		if (step != 60) {
+			return;
+		}
+
+		for (int i = 0; i < m_count; i ++) {
+			NewtonBody* const box = m_boxes[i];
+			dMatrix matrix;
+			dVector veloc (0.0f);
+			dVector omega (0.0f);
+			NewtonBodyGetMatrix (box, &matrix[0][0]);
+			NewtonBodyGetVelocity (box, &veloc.m_x);
+			NewtonBodyGetOmega (box, &omega.m_x);
+			NewtonDestroyBody (box);
+
+			for (int j = 0; j < 8; j ++) {
+				NewtonBody* const chunk = CreateSolid (m_chunks[j], matrix, 1.0f);
+				NewtonBodySetVelocity (chunk, &veloc.m_x);
+				NewtonBodySetOmega (chunk, &omega.m_x);
+			}
+		}
+	}
+
+	NewtonCollision* m_chunks[8];
+	NewtonBody** m_boxes;
+	int m_count;
+};
+
+
+// compound piles: l shapes, dumbbells and tables stacked in columns
+class CompoundScene: public BenchScene
+{
+	public:
+	CompoundScene(NewtonWorld* const world, dFloat scale)
+		:BenchScene(world)
+	{
+		AddFloorBox (dVector (200.0f, 1.0f, 200.0f, 0.0f));
+
+		NewtonCollision* shapes[3];
+		shapes[0] = NewtonCreateCompoundCollision (m_world, 0);
+		NewtonCompoundCollisionBeginAddRemove (shapes[0]);
+		AddSubShape (shapes[0], NewtonCreateBox (m_world, 1.2f, 0.3f, 0.3f, 0, NULL), dVector (0.0f, 0.0f, 0.0f, 1.0f));
+		AddSubShape (shapes[0], NewtonCreateBox (m_world, 0.3f, 0.9f, 0.3f, 0, NULL), dVector (0.45f, 0.6f, 0.0f, 1.0f));
+		NewtonCompoundCollisionEndAddRemove (shapes[0]);
+
+		shapes[1] = NewtonCreateCompoundCollision (m_world, 0);
+		NewtonCompoundCollisionBeginAddRemove (shapes[1]);
+		AddSubShape (shapes[1], NewtonCreateSphere (m_world, 0.3f, 0, NULL), dVector (-0.6f, 0.0f, 0.0f, 1.0f));
+		AddSubShape (shapes[1], NewtonCreateSphere (m_world, 0.3f, 0, NULL), dVector (0.6f, 0.0f, 0.0f, 1.0f));
+		AddSubShape (shapes[1], NewtonCreateCapsule (m_world, 0.1f, 0.1f, 1.2f, 0, NULL), dVector (0.0f, 0.0f, 0.0f, 1.0f));
+		NewtonCompoundCollisionEndAddRemove (shapes[1]);
+
+		shapes[2] = NewtonCreateCompoundCollision (m_world, 0);
+		NewtonCompoundCollisionBeginAddRemove (shapes[2]);
+		AddSubShape (shapes[2], NewtonCreateBox (m_world, 1.0f, 0.1f, 0.7f, 0, NULL), dVector (0.0f, 0.3f, 0.0f, 1.0f));
+		for (int i = 0; i < 4; i ++) {
+			AddSubShape (shapes[2], NewtonCreateBox (m_world, 0.1f, 0.5f, 0.1f, 0, NULL), dVector ((i & 1) ? 0.42f : -0.42f, 0.0f, (i & 2) ? 0.27f : -0.27f, 1.0f));
+		}
+		NewtonCompoundCollisionEndAddRemove (shapes[2]);
+
+		unsigned seed = 4242;
+		const int count = ScaleCount (200, scale, 4);
+		for (int i = 0; i < count; i ++) {
+			const int slot = i % 36;
+			const int layer = i / 36;
+			dMatrix matrix (dYawMatrix (BenchRandom (seed) * dPi));
+			matrix.m_posit = dVector ((slot % 6) * 3.0f - 7.5f, 1.0f + layer * 1.5f, (slot / 6) * 3.0f - 7.5f, 1.0f);
+			CreateSolid (shapes[i % 3], matrix, 5.0f);
+		}
+
+		for (int i = 0; i < 3; i ++) {
+			NewtonDestroyCollision (shapes[i]);
+		}
+	}
+
+	void AddSubShape (NewtonCollision* const compound, NewtonCollision* const shape, const dVector& posit)
+	{
+		dMatrix matrix (dGetIdentityMatrix());
+		matrix.m_posit = posit;
+		NewtonCollisionSetMatrix (shape, &matrix[0][0]);
+		NewtonCompoundCollisionAddSubCollision (compound, shape);
+		NewtonDestroyCollision (shape);
+	}
+};
+
+
+// debris: a pen full of small boxes, spheres and capsules, mostly primitive pairs of the same kind
+class DebrisScene: public BenchScene
+{
+	public:
+	DebrisScene(NewtonWorld* const world, dFloat scale)
+		:BenchScene(world)
+	{
+		AddFloorBox (dVector (200.0f, 1.0f, 200.0f, 0.0f));
+
+		const dFloat extend = 10.0f;
+		NewtonCollision* const wall = NewtonCreateBox (m_world, 2.0f * extend + 1.0f, 4.0f, 1.0f, 0, NULL);
+		for (int i = 0; i < 4; i ++) {
+			dMatrix matrix (dYawMatrix (i * dPi * 0.5f));
+			matrix.m_posit = matrix.m_right.Scale (extend + 0.5f);
+			matrix.m_posit.m_y = 2.0f;
+			matrix.m_posit.m_w = 1.0f;
+			CreateSolid (wall, matrix, 0.0f);
+		}
+		NewtonDestroyCollision (wall);
+
+		NewtonCollision* shapes[3];
+		shapes[0] = NewtonCreateBox (m_world, 0.5f, 0.4f, 0.6f, 0, NULL);
+		shapes[1] = NewtonCreateSphere (m_world, 0.3f, 0, NULL);
+		shapes[2] = NewtonCreateCapsule (m_world, 0.2f, 0.2f, 0.8f, 0, NULL);
+
+		unsigned seed = 9876;
+		const int count = ScaleCount (1000, scale, 8);
+		for (int i = 0; i < count; i ++) {
+			const int slot = i % 256;
+			const int layer = i / 256;
+			dMatrix matrix (dYawMatrix (BenchRandom (seed) * dPi) * dRollMatrix (BenchRandom (seed) * dPi));
+			matrix.m_posit = dVector ((slot % 16) * 1.2f - 9.0f, 1.0f + layer * 1.2f, (slot / 16) * 1.2f - 9.0f, 1.0f);
+			CreateSolid (shapes[(i / 4) % 3], matrix, 1.0f);
+		}
+
+		for (int i = 0; i < 3; i ++) {
+			NewtonDestroyCollision (shapes[i]);
+		}
+	}
+};
+
+
+// freefall: a large grid of spinning spheres falling together, far enough apart that they never touch,
+// so the step is dominated by the per body force, integration, transform and aabb loops
+class FreefallScene: public BenchScene
+{
+	public:
+	FreefallScene(NewtonWorld* const world, dFloat scale)
+		:BenchScene(world)
+	{
+		NewtonCollision* const sphere = NewtonCreateSphere (m_world, 0.5f, 0, NULL);
+
+		unsigned seed = 2468;
+		const dFloat spacing = 4.0f;
+		const int count = ScaleCount (100000, scale, 8);
+		const int side = dMax (2, int (dSqrt (dFloat (count) / 16.0f) + 0.5f));
+		for (int i = 0; i < count; i ++) {
+			const int slot = i % (side * side);
+			const int layer = i / (side * side);
+			dMatrix matrix (dGetIdentityMatrix());
+			matrix.m_posit = dVector ((slot % side - side / 2) * spacing, 100.0f + layer * spacing, (slot / side - side / 2) * spacing, 1.0f);
+			NewtonBody* const body = CreateSolid (sphere, matrix, 1.0f);
+
+			dVector omega (BenchRandom (seed) * 2.0f - 1.0f, BenchRandom (seed) * 2.0f - 1.0f, BenchRandom (seed) * 2.0f - 1.0f, 0.0f);
+			omega = omega.Scale (4.0f);
+			NewtonBodySetOmega (body, &omega.m_x);
+		}
+
+		NewtonDestroyCollision (sphere);
+	}
+};
+
+template<class SCENE>
+static BenchScene* CreateScene (NewtonWorld* const world, dFloat scale)
+{
+	return new SCENE (world, scale);
+}
+
+static BenchSceneDescriptor benchScenes[] =
+{
+	{"stacking", "box pyramids and towers (BasicStacking)", CreateScene<StackingScene>},
+	{"ragdoll", "piles of jointed ragdolls (DynamicRagdoll)", CreateScene<RagdollScene>},
+	{"vehicles", "six wheeled trucks on a height field (HeavyVehicles)", CreateScene<VehicleScene>},
+	{"mesh", "mixed convex pile on a polygon soup level (MeshCollision)", CreateScene<MeshScene>},
+	{"raycast", "ray batches over a field of bodies (MultiRayCasting)", CreateScene<RayCastScene>},
+	{"fracture", "boxes shattering into convex chunks (SimpleConvexFracturing)", CreateScene<FractureScene>},
+	{"compound", "piles of compound shapes", CreateScene<CompoundScene>},
+	{"debris", "a pen of small boxes, spheres and capsules", CreateScene<DebrisScene>},
+	{"freefall", "a grid of 100k spinning spheres that never touch", CreateScene<FreefallScene>},
+};
+
+int BenchSceneCount()
+{
+	return int (sizeof (benchScenes) / sizeof (benchScenes[0]));
+}
+
+const BenchSceneDescriptor* BenchSceneGet(int index)
+{
+	return &benchScenes[index];
+}
+
+const BenchSceneDescriptor* BenchSceneFind(const char* const name)
+{
+	for (int i = 0; i < BenchSceneCount(); i ++) {
+		if (!strcmp (benchScenes[i].m_name, name)) {
+			return &benchScenes[i];
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,55 @@
+/* Copyright (c) <2003-2016> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+#ifndef _BENCH_SCENES_H_
+#define _BENCH_SCENES_H_
+
+#include "newtonBenchStdafx.h"
+
+// headless versions of the demosSandbox scenes, they build the same kind of
+// content with the plain newton interface and no visual meshes, so that they
+// can run on machines without a display.
+class BenchScene
+{
+	public:
+	BenchScene(NewtonWorld* const world);
+	virtual ~BenchScene();
+
+	// called before each world update, scenes that spawn or destroy bodies do it here
+	virtual void PreUpdate(int step, dFloat timestep);
+
+	// scenes with a query workload run it here, it is timed as a separate phase
+	virtual bool HasQueries() const;
+	virtual void RunQueries(int step);
+
+	NewtonWorld* GetWorld() const;
+
+	protected:
+	NewtonBody* CreateSolid(NewtonCollision* const collision, const dMatrix& matrix, dFloat mass);
+	void AddFloorBox(const dVector& size);
+
+	NewtonWorld* m_world;
+};
+
+typedef BenchScene* (*BenchSceneFactory)(NewtonWorld* const world, dFloat scale);
+
+struct BenchSceneDescriptor
+{
+	const char* m_name;
+	const char* m_description;
+	BenchSceneFactory m_create;
+};
+
+int BenchSceneCount();
+const BenchSceneDescriptor* BenchSceneGet(int index);
+const BenchSceneDescriptor* BenchSceneFind(const char* const name);
+
+#endif
@@ -0,0 +1,204 @@
+/* Copyright (c) <2003-2016> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+#include "newtonBenchStdafx.h"
+#include "kernelBench.h"
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#define KERNEL_BENCH_MAX_CONTACTS	16
+#define KERNEL_BENCH_ROUNDS			5
+
+enum KernelBenchShape
+{
+	m_benchSphere,
+	m_benchCapsule,
+	m_benchBox,
+	m_benchShapeCount,
+};
+
+static const char* kernelBenchShapeNames[m_benchShapeCount] = {"sphere", "capsule", "box"};
+
+// radius of the sphere that bounds each test shape
+static const dFloat kernelBenchShapeRadius[m_benchShapeCount] = {0.5f, 0.8f, 0.71f};
+
+struct KernelBenchPose
+{
+	dMatrix m_matrix0;
+	dMatrix m_matrix1;
+};
+
+struct KernelBenchContacts
+{
+	int m_count;
+	dFloat m_points[KERNEL_BENCH_MAX_CONTACTS][3];
+	dFloat m_normals[KERNEL_BENCH_MAX_CONTACTS][3];
+	dFloat m_penetration[KERNEL_BENCH_MAX_CONTACTS];
+};
+
+static double GetTimeInNanoseconds()
+{
+	return double (std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// fixed seed, so that every run collides the same poses
+static dFloat KernelBenchRandom (unsigned& seed)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return dFloat (seed >> 8) / dFloat (1 << 24);
+}
+
+static dMatrix RandomRotation (unsigned& seed)
+{
+	dQuaternion rotation (KernelBenchRandom (seed) * 2.0f - 1.0f, KernelBenchRandom (seed) * 2.0f - 1.0f, KernelBenchRandom (seed) * 2.0f - 1.0f, KernelBenchRandom (seed) * 2.0f - 1.0f);
+	rotation.Normalize();
+	return dMatrix (rotation, dVector (0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+static NewtonCollision* CreateBenchShape (NewtonWorld* const world, KernelBenchShape shape)
+{
+	switch (shape)
+	{
+		case m_benchSphere:
+			return NewtonCreateSphere (world, 0.5f, 0, NULL);
+		case m_benchCapsule:
+			return NewtonCreateCapsule (world, 0.3f, 0.3f, 1.0f, 0, NULL);
+		default:
+			return NewtonCreateBox (world, 1.0f, 0.6f, 0.8f, 0, NULL);
+	}
+}
+
+static void Collide (NewtonWorld* const world, NewtonCollision* const collision0, NewtonCollision* const collision1, const KernelBenchPose& pose, KernelBenchContacts& contacts)
+{
+	dLong attribute0[KERNEL_BENCH_MAX_CONTACTS];
+	dLong attribute1[KERNEL_BENCH_MAX_CONTACTS];
+	contacts.m_count = NewtonCollisionCollide (world, KERNEL_BENCH_MAX_CONTACTS, collision0, &pose.m_matrix0[0][0], collision1, &pose.m_matrix1[0][0],
+		&contacts.m_points[0][0], &contacts.m_normals[0][0], contacts.m_penetration, attribute0, attribute1, 0);
+}
+
+static double TimePoses (NewtonWorld* const world, NewtonCollision* const collision0, NewtonCollision* const collision1, const std::vector<KernelBenchPose>& poses)
+{
+	KernelBenchContacts contacts;
+	double best = 1.0e20;
+	for (int round = 0; round < KERNEL_BENCH_ROUNDS; round ++) {
+		const double start = GetTimeInNanoseconds();
+		for (size_t i = 0; i < poses.size(); i ++) {
+			Collide (world, collision0, collision1, poses[i], contacts);
+		}
+		best = dMin (best, GetTimeInNanoseconds() - start);
+	}
+	return best / double (poses.size());
+}
+
+static dVector Centroid (const KernelBenchContacts& contacts)
+{
+	dVector centroid (0.0f, 0.0f, 0.0f, 0.0f);
+	for (int i = 0; i < contacts.m_count; i ++) {
+		centroid += dVector (contacts.m_points[i][0], contacts.m_points[i][1], contacts.m_points[i][2], 0.0f);
+	}
+	return centroid.Scale (1.0f / contacts.m_count);
+}
+
+static void RunPair (NewtonWorld* const world, KernelBenchShape shape0, KernelBenchShape shape1, int poseCount, dFloat scale0 = 1.0f, dFloat scale1 = 1.0f)
+{
+	NewtonCollision* const collision0 = CreateBenchShape (world, shape0);
+	NewtonCollision* const collision1 = CreateBenchShape (world, shape1);
+	NewtonCollisionSetScale (collision0, scale0, scale0, scale0);
+	NewtonCollisionSetScale (collision1, scale1, scale1, scale1);
+
+	// the second shape is placed anywhere in a cube around the first one, about two
+	// thirds of the poses touch and the rest are separated by less than the bounding radii
+	unsigned seed = 0x2545f491u + unsigned (shape0 * m_benchShapeCount + shape1);
+	const dFloat extend = (kernelBenchShapeRadius[shape0] * scale0 + kernelBenchShapeRadius[shape1] * scale1) * 0.75f;
+	std::vector<KernelBenchPose> poses (poseCount);
+	for (int i = 0; i < poseCount; i ++) {
+		poses[i].m_matrix0 = RandomRotation (seed);
+		poses[i].m_matrix1 = RandomRotation (seed);
+		poses[i].m_matrix1.m_posit = dVector ((KernelBenchRandom (seed) * 2.0f - 1.0f) * extend, (KernelBenchRandom (seed) * 2.0f - 1.0f) * extend, (KernelBenchRandom (seed) * 2.0f - 1.0f) * extend, 1.0f);
+	}
+
+	NewtonSetAnalyticContacts (world, 0);
+	const double genericTime = TimePoses (world, collision0, collision1, poses);
+	NewtonSetAnalyticContacts (world, 1);
+	const double kernelTime = TimePoses (world, collision0, collision1, poses);
+
+	int touching = 0;
+	int presenceMismatch = 0;
+	int normalMismatch = 0;
+	double genericCount = 0.0;
+	double kernelCount = 0.0;
+	std::vector<dFloat> penetrationError;
+	std::vector<dFloat> centroidError;
+	for (int i = 0; i < poseCount; i ++) {
+		KernelBenchContacts generic;
+		KernelBenchContacts kernel;
+		NewtonSetAnalyticContacts (world, 0);
+		Collide (world, collision0, collision1, poses[i], generic);
+		NewtonSetAnalyticContacts (world, 1);
+		Collide (world, collision0, collision1, poses[i], kernel);
+
+		if ((generic.m_count > 0) != (kernel.m_count > 0)) {
+			presenceMismatch ++;
+		} else if (generic.m_count && kernel.m_count) {
+			touching ++;
+			genericCount += generic.m_count;
+			kernelCount += kernel.m_count;
+			const dVector normal0 (generic.m_normals[0][0], generic.m_normals[0][1], generic.m_normals[0][2], 0.0f);
+			const dVector normal1 (kernel.m_normals[0][0], kernel.m_normals[0][1], kernel.m_normals[0][2], 0.0f);
+			if (normal0.DotProduct3 (normal1) < 0.99f) {
+				normalMismatch ++;
+			} else {
+				const dVector error (Centroid (generic) - Centroid (kernel));
+				penetrationError.push_back (dAbs (generic.m_penetration[0] - kernel.m_penetration[0]));
+				centroidError.push_back (dSqrt (error.DotProduct3 (error)));
+			}
+		}
+	}
+
+	std::sort (penetrationError.begin(), penetrationError.end());
+	std::sort (centroidError.begin(), centroidError.end());
+	const int matched = int (penetrationError.size());
+	const int p99 = dMax (0, (matched * 99) / 100 - 1);
+
+	printf ("{\"pair\":\"%s-%s\",\"scale\":[%g,%g],\"poses\":%d,\"touching\":%d,\"genericNs\":%.0f,\"kernelNs\":%.0f,\"speedup\":%.2f,",
+		kernelBenchShapeNames[shape0], kernelBenchShapeNames[shape1], scale0, scale1, poseCount, touching, genericTime, kernelTime, genericTime / kernelTime);
+	printf ("\"presenceMismatch\":%d,\"normalMismatch\":%d,\"genericContacts\":%.2f,\"kernelContacts\":%.2f,",
+		presenceMismatch, normalMismatch, genericCount / dMax (touching, 1), kernelCount / dMax (touching, 1));
+	printf ("\"penetrationError99\":%.5f,\"centroidError99\":%.5f}\n", matched ? penetrationError[p99] : 0.0f, matched ? centroidError[p99] : 0.0f);
+	fflush (stdout);
+
+	NewtonDestroyCollision (collision0);
+	NewtonDestroyCollision (collision1);
+}
+
+bool RunKernelBench(int poses)
+{
+	NewtonWorld* const world = NewtonCreate();
+	for (int i = 0; i < m_benchShapeCount; i ++) {
+		for (int j = i; j < m_benchShapeCount; j ++) {
+			RunPair (world, KernelBenchShape (i), KernelBenchShape (j), poses);
+		}
+	}
+	// the mirrored order runs the same kernels with the shapes swapped
+	RunPair (world, m_benchBox, m_benchSphere, poses);
+	RunPair (world, m_benchBox, m_benchCapsule, poses);
+
+	// uniformly scaled shapes take the same kernels
+	for (int i = 0; i < m_benchShapeCount; i ++) {
+		for (int j = i; j < m_benchShapeCount; j ++) {
+			RunPair (world, KernelBenchShape (i), KernelBenchShape (j), poses, 1.5f, 0.75f);
+		}
+	}
+	NewtonDestroy (world);
+	return true;
+}
@@ -0,0 +1,23 @@
+/* Copyright (c) <2003-2016> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+#ifndef _KERNEL_BENCH_H_
+#define _KERNEL_BENCH_H_
+
+#include "newtonBenchStdafx.h"
+
+// collides each primitive pair that has a closed form contact kernel on a set of
+// random poses, once through the kernels and once through the general convex solver,
+// and prints one json line per pair with the time per call and how far the two
+// contact manifolds are apart.
+bool RunKernelBench(int poses);
+
+#endif
@@ -0,0 +1,534 @@
+/* Copyright (c) <2003-2016> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+// newtonBench runs the sandbox scenes without rendering for a fixed number of steps
+// and prints one json line per scene with the mean, median and 99th percentile
+// of the step time and of each engine phase, all times are in milliseconds.
+//
+// every frame it also hashes the matrix and velocities of all bodies, the frame hashes
+// can be recorded to golden files and checked against them later, or compared with a
+// run of the same binary on a different thread count, so that a change that is meant
+// to only make the engine faster can be verified to leave the simulation untouched.
+//
+// with --kernel-bench it instead times the closed form contact kernels against the
+// general convex solver on random poses of each primitive pair.
+
+#include "newtonBenchStdafx.h"
+#include "benchScenes.h"
+#include "kernelBench.h"
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+enum BenchPhase
+{
+	m_stepPhase,
+	m_broadPhase,
+	m_narrowPhase,
+	m_clusterPhase,
+	m_solverPhase,
+	m_transformPhase,
+	m_queryPhase,
+	m_phaseCount,
+};
+
+static const char* phaseNames[m_phaseCount] = {"step", "broadphase", "narrowphase", "cluster", "solver", "transform", "raycast"};
+static const char* broadphaseNames[] = {"default", "persistent", "bvh4", "hashgrid"};
+
+struct BenchOptions
+{
+	BenchOptions()
+		:m_scene("all")
+		,m_solver("default")
+		,m_pluginPath(NULL)
+		,m_recordPath(NULL)
+		,m_checkPath(NULL)
+		,m_scale(1.0f)
+		,m_steps(300)
+		,m_warmup(30)
+		,m_threads(1)
+		,m_substeps(1)
+		,m_iterations(0)
+		,m_broadphase(0)
+		,m_compareThreads(0)
+		,m_analyticContacts(1)
+		,m_batchedContacts(0)
+		,m_kernelBenchPoses(0)
+	{
+	}
+
+	const char* m_scene;
+	const char* m_solver;
+	const char* m_pluginPath;
+	const char* m_recordPath;
+	const char* m_checkPath;
+	dFloat m_scale;
+	int m_steps;
+	int m_warmup;
+	int m_threads;
+	int m_substeps;
+	int m_iterations;
+	int m_broadphase;
+	int m_compareThreads;
+	int m_analyticContacts;
+	int m_batchedContacts;
+	int m_kernelBenchPoses;
+};
+
+typedef std::vector<dCRCTYPE> FrameHashes;
+
+static double GetTimeInMilliseconds()
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void PrintUsage()
+{
+	printf ("usage: newtonBench [options]\n");
+	printf ("  --scene <name|all>        scene to run, default all\n");
+	printf ("  --steps <n>               measured steps, default 300\n");
+	printf ("  --warmup <n>              steps run before measuring, default 30\n");
+	printf ("  --threads <n>             worker threads, default 1\n");
+	printf ("  --broadphase <name|n>     default, persistent, bvh4 or hashgrid\n");
+	printf ("  --solver <name>           default, reference or one of the listed plugins\n");
+	printf ("  --plugins <path>          folder with solver plugins to load\n");
+	printf ("  --substeps <n>            substeps per update, default 1\n");
+	printf ("  --iterations <n>          solver passes, default is the engine setting\n");
+	printf ("  --scale <f>               multiplier for the body count of every scene, default 1\n");
+	printf ("  --record <path>           write the single thread frame hashes of each scene to path/<scene>.golden\n");
+	printf ("  --check <path>            compare the single thread frame hashes with path/<scene>.golden\n");
+	printf ("  --compare-threads <n>     compare the frame hashes with a run on n threads\n");
+	printf ("  --analytic-contacts <0|1> use the closed form contact kernels, default 1\n");
+	printf ("  --batched-contacts <0|1>  collide primitive pairs of the same kind four at the time, default 0\n");
+	printf ("  --kernel-bench <n>        compare the contact kernels with the convex solver on n random poses per pair\n");
+	printf ("  --list                    list scenes and solvers and exit\n");
+}
+
+static bool ParseBroadphase(const char* const name, int& type)
+{
+	for (int i = 0; i < int (sizeof (broadphaseNames) / sizeof (broadphaseNames[0])); i ++) {
+		if (!strcmp (name, broadphaseNames[i])) {
+			type = i;
+			return true;
+		}
+	}
+	char* end;
+	type = int (strtol (name, &end, 10));
+	return (*end == 0) && (type >= 0) && (type < int (sizeof (broadphaseNames) / sizeof (broadphaseNames[0])));
+}
+
+static bool ParseOptions(int argc, char** argv, BenchOptions& options, bool& list)
+{
+	list = false;
+	for (int i = 1; i < argc; i ++) {
+		const char* const arg = argv[i];
+		const char* const value = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if (!strcmp (arg, "--list")) {
+			list = true;
+			continue;
+		}
+		if (!value) {
+			fprintf (stderr, "missing value for %s\n", arg);
+			return false;
+		}
+		i ++;
+		if (!strcmp (arg, "--scene")) {
+			options.m_scene = value;
+		} else if (!strcmp (arg, "--steps")) {
+			options.m_steps = atoi (value);
+		} else if (!strcmp (arg, "--warmup")) {
+			options.m_warmup = atoi (value);
+		} else if (!strcmp (arg, "--threads")) {
+			options.m_threads = atoi (value);
+		} else if (!strcmp (arg, "--broadphase")) {
+			if (!ParseBroadphase (value, options.m_broadphase)) {
+				fprintf (stderr, "unknown broadphase %s\n", value);
+				return false;
+			}
+		} else if (!strcmp (arg, "--solver")) {
+			options.m_solver = value;
+		} else if (!strcmp (arg, "--plugins")) {
+			options.m_pluginPath = value;
+		} else if (!strcmp (arg, "--substeps")) {
+			options.m_substeps = atoi (value);
+		} else if (!strcmp (arg, "--iterations")) {
+			options.m_iterations = atoi (value);
+		} else if (!strcmp (arg, "--scale")) {
+			options.m_scale = dFloat (atof (value));
+		} else if (!strcmp (arg, "--record")) {
+			options.m_recordPath = value;
+		} else if (!strcmp (arg, "--check")) {
+			options.m_checkPath = value;
+		} else if (!strcmp (arg, "--compare-threads")) {
+			options.m_compareThreads = atoi (value);
+		} else if (!strcmp (arg, "--analytic-contacts")) {
+			options.m_analyticContacts = atoi (value);
+		} else if (!strcmp (arg, "--batched-contacts")) {
+			options.m_batchedContacts = atoi (value);
+		} else if (!strcmp (arg, "--kernel-bench")) {
+			options.m_kernelBenchPoses = atoi (value);
+		} else {
+			fprintf (stderr, "unknown option %s\n", arg);
+			return false;
+		}
+	}
+	return (options.m_steps > 0) && (options.m_warmup >= 0) && (options.m_threads > 0) && (options.m_substeps > 0) && (options.m_scale > 0.0f) && (options.m_compareThreads >= 0) && (options.m_kernelBenchPoses >= 0);
+}
+
+static NewtonWorld* CreateWorld(const BenchOptions& options, int threads)
+{
+	NewtonWorld* const world = NewtonCreate();
+	if (options.m_pluginPath) {
+		NewtonLoadPlugins (world, options.m_pluginPath);
+	}
+
+	if (!strcmp (options.m_solver, "reference")) {
+		NewtonSelectPlugin (world, NULL);
+	} else if (strcmp (options.m_solver, "default")) {
+		void* selected = NULL;
+		for (void* plugin = NewtonGetFirstPlugin (world); plugin; plugin = NewtonGetNextPlugin (world, plugin)) {
+			if (!strcmp (NewtonGetPluginString (world, plugin), options.m_solver)) {
+				selected = plugin;
+			}
+		}
+		if (!selected) {
+			fprintf (stderr, "solver %s is not available\n", options.m_solver);
+			NewtonDestroy (world);
+			return NULL;
+		}
+		NewtonSelectPlugin (world, selected);
+	}
+
+	NewtonSelectBroadphaseAlgorithm (world, options.m_broadphase);
+	NewtonSetThreadsCount (world, threads);
+	NewtonSetNumberOfSubsteps (world, options.m_substeps);
+	NewtonSetAnalyticContacts (world, options.m_analyticContacts);
+	NewtonSetBatchedContacts (world, options.m_batchedContacts);
+	if (options.m_iterations > 0) {
+		NewtonSetSolverIterations (world, options.m_iterations);
+	}
+	return world;
+}
+
+static void ListScenesAndSolvers(const BenchOptions& options)
+{
+	printf ("scenes:\n");
+	for (int i = 0; i < BenchSceneCount(); i ++) {
+		printf ("  %-10s %s\n", BenchSceneGet(i)->m_name, BenchSceneGet(i)->m_description);
+	}
+
+	NewtonWorld* const world = NewtonCreate();
+	if (options.m_pluginPath) {
+		NewtonLoadPlugins (world, options.m_pluginPath);
+	}
+	printf ("solvers:\n");
+	printf ("  reference\n");
+	for (void* plugin = NewtonGetFirstPlugin (world); plugin; plugin = NewtonGetNextPlugin (world, plugin)) {
+		printf ("  %s%s\n", NewtonGetPluginString (world, plugin), (plugin == NewtonGetPreferedPlugin (world)) ? " (default)" : "");
+	}
+	NewtonDestroy (world);
+}
+
+static void PrintPhase(const char* const name, std::vector<double>& samples, bool comma)
+{
+	std::sort (samples.begin(), samples.end());
+	double sum = 0.0;
+	for (size_t i = 0; i < samples.size(); i ++) {
+		sum += samples[i];
+	}
+	// nearest rank percentiles
+	const size_t count = samples.size();
+	const size_t p50 = dMax (size_t (1), size_t (ceil (count * 0.50))) - 1;
+	const size_t p99 = dMax (size_t (1), size_t (ceil (count * 0.99))) - 1;
+	printf ("\"%s\":{\"mean\":%.4f,\"p50\":%.4f,\"p99\":%.4f,\"max\":%.4f}%s", name, sum / count, samples[p50], samples[p99], samples[count - 1], comma ? "," : "");
+}
+
+// hash of the matrix and the linear and angular velocity of every body, in creation order
+static dCRCTYPE HashWorldState(NewtonWorld* const world)
+{
+	dCRCTYPE crc = 0;
+	for (NewtonBody* body = NewtonWorldGetFirstBody (world); body; body = NewtonWorldGetNextBody (world, body)) {
+		dMatrix matrix;
+		dVector veloc;
+		dVector omega;
+		NewtonBodyGetMatrix (body, &matrix[0][0]);
+		NewtonBodyGetVelocity (body, &veloc.m_x);
+		NewtonBodyGetOmega (body, &omega.m_x);
+		crc = dCRC64 (&matrix[0][0], sizeof (matrix), crc);
+		crc = dCRC64 (&veloc.m_x, 3 * sizeof (dFloat), crc);
+		crc = dCRC64 (&omega.m_x, 3 * sizeof (dFloat), crc);
+	}
+	return crc;
+}
+
+struct SceneRun
+{
+	SceneRun()
+		:m_contacts(0.0)
+		,m_islands(0.0)
+		,m_cacheQueries(0.0)
+		,m_cacheHits(0.0)
+		,m_bodies(0)
+		,m_threads(0)
+		,m_hasQueries(false)
+	{
+		m_solver[0] = 0;
+	}
+
+	dCRCTYPE GetRunHash() const
+	{
+		dCRCTYPE crc = 0;
+		for (size_t i = 0; i < m_frameHashes.size(); i ++) {
+			crc = dCRC64 (&m_frameHashes[i], sizeof (dCRCTYPE), crc);
+		}
+		return crc;
+	}
+
+	std::vector<double> m_samples[m_phaseCount];
+	FrameHashes m_frameHashes;
+	double m_contacts;
+	double m_islands;
+	double m_cacheQueries;
+	double m_cacheHits;
+	int m_bodies;
+	int m_threads;
+	bool m_hasQueries;
+	char m_solver[64];
+};
+
+static bool RunScene(const BenchSceneDescriptor* const descriptor, const BenchOptions& options, int threads, SceneRun& run)
+{
+	NewtonWorld* const world = CreateWorld (options, threads);
+	if (!world) {
+		return false;
+	}
+
+	BenchScene* const scene = descriptor->m_create (world, options.m_scale);
+	run.m_hasQueries = scene->HasQueries();
+	const dFloat timestep = 1.0f / 60.0f;
+
+	for (int step = 0; step < options.m_warmup + options.m_steps; step ++) {
+		scene->PreUpdate (step, timestep);
+
+		const double startTime = GetTimeInMilliseconds();
+		NewtonUpdate (world, timestep);
+		const double updateTime = GetTimeInMilliseconds();
+		if (run.m_hasQueries) {
+			scene->RunQueries (step);
+		}
+		const double queryTime = GetTimeInMilliseconds();
+		run.m_frameHashes.push_back (HashWorldState (world));
+
+		if (step >= options.m_warmup) {
+			NewtonWorldStepStats stats;
+			NewtonWorldGetStepStats (world, &stats);
+			run.m_samples[m_stepPhase].push_back (updateTime - startTime);
+			run.m_samples[m_broadPhase].push_back (stats.m_broadPhaseTime * 1000.0);
+			run.m_samples[m_narrowPhase].push_back (stats.m_narrowPhaseTime * 1000.0);
+			run.m_samples[m_clusterPhase].push_back (stats.m_clusterBuildTime * 1000.0);
+			run.m_samples[m_solverPhase].push_back (stats.m_solverTime * 1000.0);
+			run.m_samples[m_transformPhase].push_back (stats.m_transformUpdateTime * 1000.0);
+			run.m_samples[m_queryPhase].push_back (queryTime - updateTime);
+			run.m_contacts += stats.m_contactCount;
+			run.m_islands += stats.m_islandCount;
+			run.m_cacheQueries += stats.m_simplexCacheQueries;
+			run.m_cacheHits += stats.m_simplexCacheHits;
+		}
+	}
+
+	const void* const plugin = NewtonCurrentPlugin (world);
+	snprintf (run.m_solver, sizeof (run.m_solver), "%s", plugin ? NewtonGetPluginString (world, plugin) : "reference");
+	run.m_bodies = NewtonWorldGetBodyCount (world);
+	run.m_threads = NewtonGetThreadsCount (world);
+
+	delete scene;
+	NewtonDestroy (world);
+	return true;
+}
+
+// returns the first frame where the two runs diverge, or -1 when they are identical
+static int FindFirstDivergence(const FrameHashes& hashes0, const FrameHashes& hashes1)
+{
+	const size_t count = dMin (hashes0.size(), hashes1.size());
+	for (size_t i = 0; i < count; i ++) {
+		if (hashes0[i] != hashes1[i]) {
+			return int (i);
+		}
+	}
+	return (hashes0.size() == hashes1.size()) ? -1 : int (count);
+}
+
+// golden files are text, a header line with the settings that change the simulation followed by one hash per frame
+static void GetGoldenHeader(const BenchSceneDescriptor* const descriptor, const BenchOptions& options, const SceneRun& run, char* const header, int size)
+{
+	snprintf (header, size, "# newtonBench scene %s solver %s broadphase %s substeps %d iterations %d scale %g analytic %d batched %d\n",
+		descriptor->m_name, run.m_solver, broadphaseNames[options.m_broadphase], options.m_substeps, options.m_iterations, options.m_scale, options.m_analyticContacts ? 1 : 0, options.m_batchedContacts ? 1 : 0);
+}
+
+static void GetGoldenFileName(const char* const path, const BenchSceneDescriptor* const descriptor, char* const name, int size)
+{
+	snprintf (name, size, "%s/%s.golden", path, descriptor->m_name);
+}
+
+static bool WriteGolden(const BenchSceneDescriptor* const descriptor, const BenchOptions& options, const SceneRun& run)
+{
+	char name[1024];
+	char header[512];
+	GetGoldenFileName (options.m_recordPath, descriptor, name, sizeof (name));
+	GetGoldenHeader (descriptor, options, run, header, sizeof (header));
+
+	FILE* const file = fopen (name, "wb");
+	if (!file) {
+		fprintf (stderr, "can not write golden file %s\n", name);
+		return false;
+	}
+	fputs (header, file);
+	for (size_t i = 0; i < run.m_frameHashes.size(); i ++) {
+		fprintf (file, "%016llx\n", (unsigned long long) run.m_frameHashes[i]);
+	}
+	fclose (file);
+	return true;
+}
+
+// returns the first frame that does not match the golden file, -1 when all match and -2 when the file can not be used
+static int CheckGolden(const BenchSceneDescriptor* const descriptor, const BenchOptions& options, const SceneRun& run)
+{
+	char name[1024];
+	char header[512];
+	char line[512];
+	GetGoldenFileName (options.m_checkPath, descriptor, name, sizeof (name));
+	GetGoldenHeader (descriptor, options, run, header, sizeof (header));
+
+	FILE* const file = fopen (name, "rb");
+	if (!file) {
+		fprintf (stderr, "can not read golden file %s\n", name);
+		return -2;
+	}
+	if (!fgets (line, sizeof (line), file) || strcmp (line, header)) {
+		fprintf (stderr, "golden file %s was recorded with different settings\n", name);
+		fclose (file);
+		return -2;
+	}
+
+	FrameHashes golden;
+	while (fgets (line, sizeof (line), file)) {
+		golden.push_back ((dCRCTYPE) strtoull (line, NULL, 16));
+	}
+	fclose (file);
+
+	// a shorter run is checked against the first frames of a longer golden file
+	if (golden.size() > run.m_frameHashes.size()) {
+		golden.resize (run.m_frameHashes.size());
+	}
+	return FindFirstDivergence (golden, run.m_frameHashes);
+}
+
+static bool RunBenchmark(const BenchSceneDescriptor* const descriptor, const BenchOptions& options)
+{
+	SceneRun run;
+	if (!RunScene (descriptor, options, options.m_threads, run)) {
+		return false;
+	}
+
+	// golden files describe the single thread path
+	SceneRun singleThreadRun;
+	const SceneRun* goldenRun = &run;
+	if ((options.m_recordPath || options.m_checkPath) && (run.m_threads != 1)) {
+		if (!RunScene (descriptor, options, 1, singleThreadRun)) {
+			return false;
+		}
+		goldenRun = &singleThreadRun;
+	}
+
+	bool passed = true;
+	char goldenStatus[64] = "";
+	if (options.m_recordPath) {
+		if (!WriteGolden (descriptor, options, *goldenRun)) {
+			return false;
+		}
+		snprintf (goldenStatus, sizeof (goldenStatus), ",\"golden\":\"recorded\"");
+	} else if (options.m_checkPath) {
+		const int frame = CheckGolden (descriptor, options, *goldenRun);
+		if (frame == -2) {
+			return false;
+		}
+		passed = passed && (frame < 0);
+		if (frame < 0) {
+			snprintf (goldenStatus, sizeof (goldenStatus), ",\"golden\":\"pass\"");
+		} else {
+			snprintf (goldenStatus, sizeof (goldenStatus), ",\"golden\":\"fail\",\"goldenFrame\":%d", frame);
+		}
+	}
+
+	char threadStatus[96] = "";
+	if (options.m_compareThreads) {
+		SceneRun compareRun;
+		if (!RunScene (descriptor, options, options.m_compareThreads, compareRun)) {
+			return false;
+		}
+		const int frame = FindFirstDivergence (run.m_frameHashes, compareRun.m_frameHashes);
+		passed = passed && (frame < 0);
+		if (frame < 0) {
+			snprintf (threadStatus, sizeof (threadStatus), ",\"threadCompare\":%d,\"threadCheck\":\"pass\"", compareRun.m_threads);
+		} else {
+			snprintf (threadStatus, sizeof (threadStatus), ",\"threadCompare\":%d,\"threadCheck\":\"fail\",\"threadFrame\":%d", compareRun.m_threads, frame);
+		}
+	}
+
+	printf ("{\"scene\":\"%s\",\"bodies\":%d,\"threads\":%d,\"broadphase\":\"%s\",\"solver\":\"%s\",\"substeps\":%d,\"analyticContacts\":%d,\"batchedContacts\":%d,\"scale\":%g,\"steps\":%d,\"warmup\":%d,",
+		descriptor->m_name, run.m_bodies, run.m_threads, broadphaseNames[options.m_broadphase], run.m_solver, options.m_substeps, options.m_analyticContacts ? 1 : 0, options.m_batchedContacts ? 1 : 0, options.m_scale, options.m_steps, options.m_warmup);
+	printf ("\"hash\":\"%016llx\"%s%s,", (unsigned long long) run.GetRunHash(), goldenStatus, threadStatus);
+	printf ("\"contacts\":%.1f,\"islands\":%.1f,\"simplexCacheHitRate\":%.3f,\"phases\":{", run.m_contacts / options.m_steps, run.m_islands / options.m_steps, run.m_cacheHits / dMax (run.m_cacheQueries, 1.0));
+	const int phaseCount = run.m_hasQueries ? m_phaseCount : m_phaseCount - 1;
+	for (int i = 0; i < phaseCount; i ++) {
+		PrintPhase (phaseNames[i], run.m_samples[i], i < (phaseCount - 1));
+	}
+	printf ("}}\n");
+	fflush (stdout);
+	return passed;
+}
+
+int main(int argc, char** argv)
+{
+	bool list;
+	BenchOptions options;
+	if (!ParseOptions (argc, argv, options, list)) {
+		PrintUsage();
+		return 1;
+	}
+
+	if (list) {
+		ListScenesAndSolvers (options);
+		return 0;
+	}
+
+	if (options.m_kernelBenchPoses) {
+		return RunKernelBench (options.m_kernelBenchPoses) ? 0 : 1;
+	}
+
+	if (!strcmp (options.m_scene, "all")) {
+		// keep going after a failed check, so that one run reports every scene that changed
+		bool passed = true;
+		for (int i = 0; i < BenchSceneCount(); i ++) {
+			passed = RunBenchmark (BenchSceneGet(i), options) && passed;
+		}
+		return passed ? 0 : 1;
+	}
+
+	const BenchSceneDescriptor* const descriptor = BenchSceneFind (options.m_scene);
+	if (!descriptor) {
+		fprintf (stderr, "unknown scene %s\n", options.m_scene);
+		PrintUsage();
+		return 1;
+	}
+	return RunBenchmark (descriptor, options) ? 0 : 1;
+}
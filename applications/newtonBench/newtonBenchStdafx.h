@@ -9,17 +9,20 @@
 * freely
 */
 
-#ifndef __dCRC__
-#define __dCRC__
+#ifndef _NEWTON_BENCH_STDAFX_H_
+#define _NEWTON_BENCH_STDAFX_H_
 
-#include "dContainersAlloc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
 
-#define dCRCTYPE long long
-
-DCONTAINERS_API dCRCTYPE dCRC64 (const char* const string, dCRCTYPE  crcAcc = 0);
-DCONTAINERS_API dCRCTYPE dCRC64 (const void* const buffer, int size, dCRCTYPE crcAcc);
-
-DCONTAINERS_API dCRCTYPE dCombineCRC (dCRCTYPE a, dCRCTYPE b);
+#include <Newton.h>
+#include <dVector.h>
+#include <dMatrix.h>
+#include <dQuaternion.h>
+#include <dMathDefines.h>
+#include <dCRC.h>
 
 #endif
-
@@ -15,166 +15,96 @@
 
 #include "stdafx.h"
 #include "dTimeTracker.h"
-#include "dTimeTrackerRecord.h"
 
-
-#if _MSC_VER < 1900
+#if defined (_MSC_VER) && (_MSC_VER < 1900)
 #define thread_local __declspec(thread)
 #endif
 
-#define DG_TIME_TRACKER_PAGE_ENTRIES (1<<DG_TIME_TRACKER_ENTRIES_POWER)
+#define DG_TIME_TRACKER_RING_POWER		16
+#define DG_TIME_TRACKER_RING_ENTRIES	(1<<DG_TIME_TRACKER_RING_POWER)
 
-class dTimeTrack
+class dTimeTrackerEvent
 {
 	public:
-	class dTrackerString
-	{
-		public:
-		dTrackerString()
-		{
-			m_string[0] = 0;
-		}
-
-		dTrackerString(const char* const string)
-		{
-			strncpy (m_string, string, sizeof (m_string) - 1);
-		}
-
-		dTrackerString(const dTrackerString& src)
-		{
-			strcpy (m_string, src.m_string);
-		}
-
-		char m_string[128];
-	};
+	const char* m_name;
+	long long m_start;
+	long long m_duration;
+};
 
-	dTimeTrack(const char* const name)
+// each thread writes its records to its own ring buffer, with no locks, 
+// the oldest records are overwritten when a thread runs out of entries.
+class dTimeTrack
+{
+	public:
+	dTimeTrack(const char* const name, int threadId)
 		:m_count(0)
-		,m_threadName (name)
-	{
-		m_banks[0] = DG_TIME_TRACKER_PAGE_ENTRIES;
-		m_banks[1] = DG_TIME_TRACKER_PAGE_ENTRIES;
-	}
-
-	~dTimeTrack()
+		,m_threadId(threadId)
+		,m_alive(true)
 	{
+		SetName(name);
 	}
 
 	void Clear()
 	{
-		m_count = 0;
-		m_banks[0] = DG_TIME_TRACKER_PAGE_ENTRIES;
-		m_banks[1] = DG_TIME_TRACKER_PAGE_ENTRIES;
-		memset (m_buffer, 0, sizeof (m_buffer));
-		m_nameMap.RemoveAll();
+		m_count.store(0, std::memory_order_relaxed);
 	}
 
-	int AddEntry(const char* const name);
-	void CloseEntry(int index);
-
 	void SetName(const char* const name)
 	{
-		m_threadName = name;
-	}
-
-	const dTrackerString& GetName() const
-	{
-		return m_threadName;
+		strncpy(m_threadName, name, sizeof (m_threadName) - 1);
+		m_threadName[sizeof (m_threadName) - 1] = 0;
 	}
 
-	dMap<dTrackerString, unsigned>& GetStringMap()
+	int AddEntry(const char* const name, long long time)
 	{
-		return m_nameMap;
+		const unsigned index = m_count.load(std::memory_order_relaxed);
+		dTimeTrackerEvent& record = m_buffer[index & (DG_TIME_TRACKER_RING_ENTRIES - 1)];
+		record.m_name = name;
+		record.m_start = time;
+		record.m_duration = -1;
+		m_count.store(index + 1, std::memory_order_release);
+		return int (index & 0x7fffffff);
 	}
 
-	const dTimeTrackerRecord* GetBuffer() const
+	void CloseEntry(int index, long long time)
 	{
-		return m_buffer;
+		// the entry is gone if the ring wrapped around since it was opened
+		const unsigned count = m_count.load(std::memory_order_relaxed) & 0x7fffffff;
+		if (((count - unsigned(index)) & 0x7fffffff) <= DG_TIME_TRACKER_RING_ENTRIES) {
+			dTimeTrackerEvent& record = m_buffer[index & (DG_TIME_TRACKER_RING_ENTRIES - 1)];
+			record.m_duration = time - record.m_start;
+		}
 	}
 
-	private:
-	void SaveBuffer(int bank);
+	void Save(FILE* const file, bool& firstEvent) const;
 
-	int m_count;
-	int m_banks[2];
-	dTimeTrackerRecord m_buffer[DG_TIME_TRACKER_PAGE_ENTRIES * 2];
-	dMap<dTrackerString, unsigned> m_nameMap;
-	dTrackerString m_threadName;
+	std::atomic<unsigned> m_count;
+	int m_threadId;
+	bool m_alive;
+	char m_threadName[64];
+	dTimeTrackerEvent m_buffer[DG_TIME_TRACKER_RING_ENTRIES];
 };
 
-
 class dTimeTrackerServer
 {
-	class dNetworkSupport
-	{
-		public:
-		dNetworkSupport ()
-		{
-			#ifdef _WIN32__
-				m_socket = NULL;
-				memset(&m_client, 0, sizeof(m_client));
-				memset(&m_server, 0, sizeof(m_server));
-				memset(&m_wsaData, 0, sizeof(m_wsaData));
-			#endif
-		}	
-
-		bool Start() 
-		{
-			bool ret = true;
-
-			#ifdef _WIN32__
-				WORD version = MAKEWORD(2, 2);
-				int state = WSAStartup(version, &m_wsaData);
-				if (!state) {
-					// bind socket to ip address
-					m_socket = socket(AF_INET, SOCK_DGRAM, 0);
-
-					m_server.sin_addr.S_un.S_addr = ADDR_ANY;
-					m_server.sin_family = AF_INET;
-					if (!bind(m_socket, (SOCKADDR*)&m_server, sizeof(m_server))) {
-						ret = true;
-					}
-				}
-			#endif
-			return ret;
-		}
-
-		void Close()
-		{
-			#ifdef _WIN32__
-				closesocket(m_socket);
-				WSACleanup();
-			#endif
-		}
-
-		SOCKET m_socket;
-		SOCKADDR_IN m_client;
-		SOCKADDR_IN m_server;
-		WSADATA m_wsaData;
-	};
-
 	public:
 	dTimeTrackerServer()
 		:m_criticalSection()
 		,m_tracks()
-		,m_baseCount(__rdtsc())
+		,m_baseTime(std::chrono::steady_clock::now())
 		,m_currentFile(NULL)
 		,m_trackEnum(0)
-		,m_initialized(false)
-		,m_networkSupport()
+		,m_recording(false)
 	{
 	}
 
 	~dTimeTrackerServer()
 	{
-		while (m_tracks.GetCount()) {
-			dMap<dTimeTrack*, DWORD>::dTreeNode* const node = m_tracks.GetRoot();
-			delete node->GetInfo();
-			m_tracks.Remove(node);
+		if (m_currentFile) {
+			StopRecording();
 		}
-
-		if (m_initialized) {
-			m_networkSupport.Close();
+		for (size_t i = 0; i < m_tracks.size(); i ++) {
+			delete m_tracks[i];
 		}
 	}
 
@@ -184,139 +114,137 @@ class dTimeTrackerServer
 		return server;
 	}
 
-	unsigned GetTime() const
-	{
-		return unsigned ((__rdtsc() - m_baseCount) >> 10);
-	}
-
-	bool StartServer()
+	long long GetTime() const
 	{
-		if (!m_initialized) {
-			// initialized win socket
-			m_initialized = m_networkSupport.Start();
-		}
-		return m_initialized;
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_baseTime).count();
 	}
 
-	bool IsValid() const
+	bool IsRecording() const
 	{
-		return m_initialized;
+		return m_recording.load(std::memory_order_relaxed);
 	}
 
 	dTimeTrack& GetFrame()
 	{
-		// I have to do this because VS 2013 do not fully supports thread_local initialization 
-		static thread_local dTimeTrack* frame = NULL;
-		if (!frame) {
+		if (!m_frame) {
+			std::lock_guard<std::mutex> lock(m_criticalSection);
 			char name[64];
 			sprintf(name, "thread_%2d", m_trackEnum);
-			frame = new dTimeTrack (name);
-			DWORD threadID = GetThreadId(GetCurrentThread());
-			m_tracks.Insert(frame, threadID);
+			m_frame = new dTimeTrack(name, m_trackEnum);
+			m_tracks.push_back(m_frame);
 			m_trackEnum ++;
 		}
-		return *frame;
+		return *m_frame;
 	}
 
 	void DeleteTrack()
 	{
-		DWORD threadID = GetThreadId(GetCurrentThread());
-		dMap<dTimeTrack*, DWORD>::dTreeNode* const node = m_tracks.Find(threadID);
-		if (node) {
-			delete node->GetInfo();
-			m_tracks.Remove(node);
+		// the track keeps its records until they are saved
+		if (m_frame) {
+			std::lock_guard<std::mutex> lock(m_criticalSection);
+			m_frame->m_alive = false;
+			if (!m_currentFile) {
+				RemoveDeadTracks();
+			}
+			m_frame = NULL;
 		}
 	}
 
 	void StartRecording(const char* const fileName)
 	{
-		dMap<dTimeTrack*, DWORD>::Iterator iter(m_tracks);
-		for (iter.Begin(); iter; iter++) {
-			dTimeTrack* const track = iter.GetNode()->GetInfo();
-			track->Clear();
-		}
-
 		if (m_currentFile) {
 			StopRecording();
 		}
 
+		std::lock_guard<std::mutex> lock(m_criticalSection);
+		RemoveDeadTracks();
+		for (size_t i = 0; i < m_tracks.size(); i ++) {
+			m_tracks[i]->Clear();
+		}
+
 		m_currentFile = fopen (fileName, "wb");
-		dAssert(m_currentFile);
-		m_baseCount = __rdtsc();
+		assert(m_currentFile);
+		m_recording.store(m_currentFile ? true : false, std::memory_order_release);
 	}
 
 	void StopRecording()
 	{
-		dAssert(m_currentFile);
-
-		m_criticalSection.lock();
-		dMap<unsigned, unsigned> filter;
-		dMap<dTimeTrack*, DWORD>::Iterator iter(m_tracks);
-		int chunkType = m_traceLabel;
-		fwrite(&chunkType, sizeof(unsigned), 1, m_currentFile);
-		for (iter.Begin(); iter; iter++) {
-			dTimeTrack* const track = iter.GetNode()->GetInfo();
-			dMap<dTimeTrack::dTrackerString, unsigned>& nameMap = track->GetStringMap();
-
-			const dTimeTrack::dTrackerString& threadName = track->GetName();
-			unsigned threadNameCrc = unsigned(dCRC64(threadName.m_string));
-			nameMap.Insert(threadName, threadNameCrc);
-
-			dMap<dTimeTrack::dTrackerString, unsigned>::Iterator nameIter (nameMap);
-			for (nameIter.Begin(); nameIter; nameIter++) {
-				unsigned key = nameIter.GetKey();
-				if (!filter.Find(key)) {
-					const dTimeTrack::dTrackerString& name = nameIter.GetNode()->GetInfo();
-					int size = int (strlen(name.m_string));
-					fwrite(&chunkType, sizeof(unsigned), 1, m_currentFile);
-					fwrite(&key, sizeof(unsigned), 1, m_currentFile);
-					fwrite(&size, sizeof(unsigned), 1, m_currentFile);
-					fwrite(name.m_string, size,1,  m_currentFile);
-					filter.Insert(key, key);
-				}
+		m_recording.store(false, std::memory_order_release);
+
+		std::lock_guard<std::mutex> lock(m_criticalSection);
+		if (m_currentFile) {
+			bool firstEvent = true;
+			fprintf(m_currentFile, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+			for (size_t i = 0; i < m_tracks.size(); i ++) {
+				m_tracks[i]->Save(m_currentFile, firstEvent);
 			}
+			fprintf(m_currentFile, "\n]}\n");
+			fclose(m_currentFile);
+			m_currentFile = NULL;
 		}
-
-		chunkType = 0;
-		fwrite(&chunkType, sizeof(int), 1, m_currentFile);
-
-		chunkType = m_traceEnd;
-		fwrite(&chunkType, sizeof(int), 1, m_currentFile);
-		fclose(m_currentFile);
-
-		m_currentFile = NULL;
-		m_criticalSection.unlock();
+		RemoveDeadTracks();
 	}
 
-	void SaveTrack(dTimeTrack& track, int bank)
+	private:
+	void RemoveDeadTracks()
 	{
-		int sizeInByte = sizeof(dTimeTrackerRecord) * DG_TIME_TRACKER_PAGE_ENTRIES;
-		const dTimeTrackerRecord* const trackBuffer = track.GetBuffer();
-
-		int chunkType = m_traceSamples;
-		unsigned threadName = unsigned(dCRC64(track.GetName().m_string));
-
-		m_criticalSection.lock();
-		fwrite(&chunkType, sizeof(unsigned), 1, m_currentFile);
-		fwrite(&threadName, sizeof(unsigned), 1, m_currentFile);
-		fwrite(&sizeInByte, sizeof(unsigned), 1, m_currentFile);
-		fwrite(&trackBuffer[bank * DG_TIME_TRACKER_PAGE_ENTRIES], sizeInByte, 1, m_currentFile);
-		m_criticalSection.unlock();
+		size_t count = 0;
+		for (size_t i = 0; i < m_tracks.size(); i ++) {
+			if (m_tracks[i]->m_alive) {
+				m_tracks[count] = m_tracks[i];
+				count ++;
+			} else {
+				delete m_tracks[i];
+			}
+		}
+		m_tracks.resize(count);
 	}
 
 	std::mutex m_criticalSection;
-	dMap<dTimeTrack*, DWORD> m_tracks;
-	DWORD64 m_baseCount;
+	std::vector<dTimeTrack*> m_tracks;
+	std::chrono::steady_clock::time_point m_baseTime;
 	FILE* m_currentFile;
 	int m_trackEnum;
-	bool m_initialized;
-	dNetworkSupport m_networkSupport;
+	std::atomic<bool> m_recording;
+	static thread_local dTimeTrack* m_frame;
 };
 
-bool StartServer()
+thread_local dTimeTrack* dTimeTrackerServer::m_frame = NULL;
+
+static void SaveString(FILE* const file, const char* const string)
 {
-	dTimeTrackerServer& server = dTimeTrackerServer::GetServer();
-	return server.StartServer();
+	fputc('"', file);
+	for (const char* ptr = string; *ptr; ptr ++) {
+		if ((*ptr == '"') || (*ptr == '\\')) {
+			fputc('\\', file);
+		}
+		fputc(*ptr, file);
+	}
+	fputc('"', file);
+}
+
+void dTimeTrack::Save(FILE* const file, bool& firstEvent) const
+{
+	const unsigned count = m_count.load(std::memory_order_acquire);
+	const unsigned start = (count > DG_TIME_TRACKER_RING_ENTRIES) ? count - DG_TIME_TRACKER_RING_ENTRIES : 0;
+	if (count == start) {
+		return;
+	}
+
+	fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":", firstEvent ? "" : ",", m_threadId);
+	SaveString(file, m_threadName);
+	fprintf(file, "}}");
+	firstEvent = false;
+
+	for (unsigned i = start; i < count; i ++) {
+		const dTimeTrackerEvent& record = m_buffer[i & (DG_TIME_TRACKER_RING_ENTRIES - 1)];
+		// records still open when the recording stopped are skipped
+		if (record.m_duration >= 0) {
+			fprintf(file, ",\n{\"name\":");
+			SaveString(file, record.m_name);
+			fprintf(file, ",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", m_threadId, double(record.m_start) * 1.0e-3, double(record.m_duration) * 1.0e-3);
+		}
+	}
 }
 
 void ttStartRecording(const char* const fileName)
@@ -331,7 +259,6 @@ void ttStopRecording()
 	server.StopRecording();
 }
 
-
 void ttSetTrackName(const char* const threadName)
 {
 	dTimeTrackerServer& server = dTimeTrackerServer::GetServer();
@@ -348,54 +275,18 @@ void ttDeleteTrack()
 int ttOpenRecord(const char* const name)
 {
 	dTimeTrackerServer& server = dTimeTrackerServer::GetServer();
+	if (!server.IsRecording()) {
+		return -1;
+	}
 	dTimeTrack& frame = server.GetFrame();
-	return frame.AddEntry(name);
+	return frame.AddEntry(name, server.GetTime());
 }
 
 void ttCloseRecord(int recordIndex)
 {
-	dTimeTrackerServer& server = dTimeTrackerServer::GetServer();
-	dTimeTrack& frame = server.GetFrame();
-	frame.CloseEntry(recordIndex);
-}
-
-int dTimeTrack::AddEntry(const char* const name)
-{
-	dTimeTrackerServer& server = dTimeTrackerServer::GetServer();
-	int index = m_count;
-	dTimeTrackerRecord& record = m_buffer[index];
-	record.m_start = server.GetTime();
-
-	unsigned  nameHash = unsigned  (dCRC64(name));
-	m_nameMap.Insert(name, nameHash);
-	record.m_nameHash = nameHash;
-
-	m_count = (m_count + 1) & (DG_TIME_TRACKER_PAGE_ENTRIES * 2 - 1);
-	return index;
-}
-
-void dTimeTrack::CloseEntry(int index)
-{
-	dTimeTrackerServer& server = dTimeTrackerServer::GetServer();
-	dTimeTrackerRecord& record = m_buffer[index];
-	record.m_duration = server.GetTime() - record.m_start;
-
-	int bank = index >> DG_TIME_TRACKER_ENTRIES_POWER;
-	m_banks[bank]--;
-	dAssert(m_banks[bank] >= 0);
-	if (!m_banks[bank]) {
-		SaveBuffer(bank);
-	}
-}
-
-void dTimeTrack::SaveBuffer(int bank)
-{
-	int recordIndex = ttOpenRecord("profiler");
-	dAssert((bank && (m_count < DG_TIME_TRACKER_PAGE_ENTRIES)) || (!bank && (m_count >= DG_TIME_TRACKER_PAGE_ENTRIES)));
-	dTimeTrackerServer& server = dTimeTrackerServer::GetServer();
-	if (server.m_currentFile) {
-		server.SaveTrack(*this, bank);
+	if (recordIndex >= 0) {
+		dTimeTrackerServer& server = dTimeTrackerServer::GetServer();
+		dTimeTrack& frame = server.GetFrame();
+		frame.CloseEntry(recordIndex, server.GetTime());
 	}
-	m_banks[bank] = DG_TIME_TRACKER_PAGE_ENTRIES;
-	ttCloseRecord(recordIndex);
 }
@@ -19,12 +19,19 @@
 // that uses this DLL. This way any other project whose source files include this file see 
 // DTIMETRACKER_API functions as being imported from a DLL, whereas this DLL sees symbols
 // defined with this macro as being exported.
-#ifdef DTIMETRACKER_EXPORTS
-#define DTIMETRACKER_API __declspec(dllexport)
+#ifdef _MSC_VER
+	#ifdef DTIMETRACKER_EXPORTS
+		#define DTIMETRACKER_API __declspec(dllexport)
+	#else
+		#define DTIMETRACKER_API __declspec(dllimport)
+	#endif
 #else
-#define DTIMETRACKER_API __declspec(dllimport)
+	#define DTIMETRACKER_API __attribute__ ((visibility("default")))
 #endif
 
+// records are only taken between ttStartRecording and ttStopRecording, 
+// ttStopRecording saves them to fileName in chrome trace event json format 
+// (chrome://tracing or ui.perfetto.dev). record names must be static strings.
 DTIMETRACKER_API void ttStartRecording(const char* const fileName);
 DTIMETRACKER_API void ttStopRecording();
 
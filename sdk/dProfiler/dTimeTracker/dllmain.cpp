@@ -14,10 +14,9 @@
 #include "stdafx.h"
 #include "dTimeTracker.h"
 
+#ifdef _MSC_VER
 #pragma warning (disable: 4100) //unreferenced formal parameter
 
-extern bool StartServer();
-
 BOOL APIENTRY DllMain( HMODULE hModule,
                        DWORD  ul_reason_for_call,
                        LPVOID lpReserved
@@ -31,6 +30,6 @@ BOOL APIENTRY DllMain( HMODULE hModule,
 	case DLL_PROCESS_DETACH:
 		break;
 	}
-	return StartServer() ? TRUE : FALSE;
+	return TRUE;
 }
-
+#endif
@@ -9,7 +9,6 @@
 * freely
 */
 
-
 // stdafx.h : include file for standard system include files,
 // or project specific include files that are used frequently, but
 // are changed infrequently
@@ -19,16 +18,19 @@
 #ifndef _STDAFX_TIMETRACKER__
 #define _STDAFX_TIMETRACKER__
 
-#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
-// Windows Header Files:
-#include <windows.h>
-#include <winsock2.h>
-#include <mutex>
-#include <thread>
-#include <condition_variable>
+#ifdef _MSC_VER
+	#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+	// Windows Header Files:
+	#include <windows.h>
+#endif
 
-#include <dMap.h>
-#include <dCRC.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <vector>
 
 #endif
 
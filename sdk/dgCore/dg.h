@@ -47,6 +47,7 @@
 #include "dgFastQueue.h"
 #include "dgPolyhedra.h"
 #include "dgThreadHive.h"
+#include "dgFrameArena.h"
 #include "dgPathFinder.h"
 #include "dgRefCounter.h"
 #include "dgQuaternion.h"
@@ -0,0 +1,135 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+* 
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* 
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "dgStdafx.h"
+#include "dgDebug.h"
+#include "dgMemory.h"
+#include "dgFrameArena.h"
+
+
+dgFrameArena::dgFrameArena (dgMemoryAllocator* const allocator)
+	:m_allocator(allocator)
+	,m_heapAllocationsCount(0)
+{
+	memset (m_arenas, 0, sizeof (m_arenas));
+	ResizeBuffer (m_arenas[0], DG_FRAME_ARENA_DEFAULT_SIZE);
+}
+
+dgFrameArena::~dgFrameArena ()
+{
+	Reset ();
+	for (dgInt32 i = 0; i < DG_FRAME_ARENA_COUNT; i ++) {
+		if (m_arenas[i].m_buffer) {
+			dgFree (m_arenas[i].m_buffer);
+		}
+	}
+}
+
+void dgFrameArena::ResizeBuffer (dgSubArena& arena, dgInt32 sizeInBytes)
+{
+	dgAssert (!arena.m_used);
+	if (arena.m_buffer) {
+		dgFree (arena.m_buffer);
+	}
+	arena.m_size = (sizeInBytes + DG_FRAME_ARENA_ALIGNMENT - 1) & -DG_FRAME_ARENA_ALIGNMENT;
+	arena.m_buffer = (dgInt8*) dgMalloc (size_t (arena.m_size), m_allocator);
+	dgAtomicExchangeAndAdd (&m_heapAllocationsCount, 1);
+}
+
+// the sub arena is full, get a chunk from the heap that lives until the next reset
+void* dgFrameArena::AllocOverflow (dgSubArena& arena, dgInt32 sizeInBytes)
+{
+	dgOverflowChunk* const chunk = (dgOverflowChunk*) dgMalloc (size_t (sizeInBytes + DG_FRAME_ARENA_ALIGNMENT), m_allocator);
+	chunk->m_next = arena.m_overflow;
+	arena.m_overflow = chunk;
+	arena.m_overflowUsed += sizeInBytes;
+	dgAtomicExchangeAndAdd (&m_heapAllocationsCount, 1);
+	return ((dgInt8*)chunk) + DG_FRAME_ARENA_ALIGNMENT;
+}
+
+// must be called when no thread is allocating, it releases everything allocated since the last reset.
+// jobs are stolen, so next step any job thread can end up with the largest share of the work, 
+// the scratch sub arenas of threads 1 to threadCount - 1 are all sized to the largest of their high-water marks.
+// sub arena zero also serves the serial phases and is sized from its own mark.
+void dgFrameArena::Reset (dgInt32 threadCount)
+{
+	dgInt32 jobHighWaterMark = 0;
+	for (dgInt32 i = 1; i < threadCount; i ++) {
+		jobHighWaterMark = dgMax (jobHighWaterMark, GetHighWaterMark (i));
+	}
+
+	for (dgInt32 i = 0; i < DG_FRAME_ARENA_COUNT; i ++) {
+		dgSubArena& arena = m_arenas[i];
+		const dgInt32 used = arena.m_used + arena.m_overflowUsed;
+		arena.m_highWaterMark = dgMax (arena.m_highWaterMark, used);
+		arena.m_used = 0;
+
+		bool overflow = false;
+		if (arena.m_overflow) {
+			for (dgOverflowChunk* chunk = arena.m_overflow; chunk; ) {
+				dgOverflowChunk* const next = chunk->m_next;
+				dgFree (chunk);
+				chunk = next;
+			}
+			arena.m_overflow = NULL;
+			arena.m_overflowUsed = 0;
+			overflow = true;
+		}
+
+		dgInt32 size = arena.m_highWaterMark;
+		if ((i > 0) && (i < threadCount)) {
+			size = dgMax (size, jobHighWaterMark);
+		}
+		if (overflow || (size > arena.m_size)) {
+			ResizeBuffer (arena, size + size / 4);
+		}
+	}
+}
+
+void dgFrameArena::Reserve (dgInt32 sizeInBytes, dgInt32 threadIndex)
+{
+	dgAssert (threadIndex >= 0);
+	dgAssert (threadIndex < DG_FRAME_ARENA_COUNT);
+	dgSubArena& arena = m_arenas[threadIndex];
+	if (sizeInBytes > arena.m_size) {
+		ResizeBuffer (arena, sizeInBytes);
+	}
+}
+
+dgInt32 dgFrameArena::GetHighWaterMark (dgInt32 threadIndex) const
+{
+	const dgSubArena& arena = m_arenas[threadIndex];
+	return dgMax (arena.m_highWaterMark, arena.m_used + arena.m_overflowUsed);
+}
+
+dgInt32 dgFrameArena::GetHighWaterMark () const
+{
+	dgInt32 size = 0;
+	for (dgInt32 i = 0; i < DG_FRAME_ARENA_COUNT; i ++) {
+		size += GetHighWaterMark (i);
+	}
+	return size;
+}
+
+dgInt32 dgFrameArena::GetHeapAllocationsCount () const
+{
+	return m_heapAllocationsCount;
+}
@@ -0,0 +1,246 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+* 
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* 
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef __dgFrameArena__
+#define __dgFrameArena__
+
+#include "dgStdafx.h"
+#include "dgMemory.h"
+
+#define DG_FRAME_ARENA_ALIGNMENT		64
+#define DG_FRAME_ARENA_DEFAULT_SIZE		(1024 * 256)
+#define DG_FRAME_ARENA_ARRAYS_BASE		DG_MAX_THREADS_HIVE_COUNT
+#define DG_FRAME_ARENA_COUNT			(DG_MAX_THREADS_HIVE_COUNT * 2)
+
+#define dgFrameAlloca(arena, type, count, threadIndex) (type*) (arena).Alloc (dgInt32 (sizeof (type) * (count)), threadIndex)
+
+// bump allocator for memory that only lives for one simulation step.
+// each worker thread allocates from the sub arena of its thread index, 
+// code that runs outside a job uses sub arena zero.
+// when a sub arena runs out the allocation is served from the heap, 
+// and on the next reset the sub arena grows to its high-water mark.
+// the sub arenas starting at DG_FRAME_ARENA_ARRAYS_BASE back the dgFrameArrays 
+// of each thread, they are never rewound by a scope.
+class dgFrameArena
+{
+	public:
+	dgFrameArena (dgMemoryAllocator* const allocator);
+	~dgFrameArena ();
+
+	void Reset (dgInt32 threadCount = 1);
+	void Reserve (dgInt32 sizeInBytes, dgInt32 threadIndex = 0);
+	DG_INLINE void* Alloc (dgInt32 sizeInBytes, dgInt32 threadIndex);
+
+	dgInt32 GetHighWaterMark () const;
+	dgInt32 GetHighWaterMark (dgInt32 threadIndex) const;
+	dgInt32 GetHeapAllocationsCount () const;
+
+	private:
+	class dgOverflowChunk
+	{
+		public:
+		dgOverflowChunk* m_next;
+	};
+
+	class dgSubArena
+	{
+		public:
+		dgInt8* m_buffer;
+		dgOverflowChunk* m_overflow;
+		dgInt32 m_size;
+		dgInt32 m_used;
+		dgInt32 m_overflowUsed;
+		dgInt32 m_highWaterMark;
+	};
+
+	void* AllocOverflow (dgSubArena& arena, dgInt32 sizeInBytes);
+	void ResizeBuffer (dgSubArena& arena, dgInt32 sizeInBytes);
+	DG_INLINE void Rewind (dgInt32 threadIndex, dgInt32 mark);
+
+	dgMemoryAllocator* m_allocator;
+	dgSubArena m_arenas[DG_FRAME_ARENA_COUNT];
+	dgInt32 m_heapAllocationsCount;
+
+	friend class dgFrameArenaScope;
+};
+
+// growable array that lives in a frame arena for one step, it has the same interface as dgArray.
+// growing copies the items to a new block, the old block is given back on the next arena reset.
+// the owner must call Reset after every arena reset, the array keeps its capacity but not its items.
+template<class T>
+class dgFrameArray
+{
+	public:
+	dgFrameArray ();
+	dgFrameArray (dgFrameArena* const arena, dgInt32 threadIndex);
+
+	void SetArena (dgFrameArena* const arena, dgInt32 threadIndex);
+	void Reset ();
+	DG_INLINE T& operator[] (dgInt32 i);
+	DG_INLINE const T& operator[] (dgInt32 i) const;
+
+	dgInt32 GetElementsCapacity () const;
+	void Resize (dgInt32 size) const;
+	DG_INLINE void ResizeIfNecessary (dgInt32 size) const;
+
+	private:
+	mutable T* m_array;
+	mutable dgInt32 m_maxSize;
+	dgFrameArena* m_arena;
+	dgInt32 m_arenaIndex;
+};
+
+// scratch memory allocated from a sub arena while the scope is alive is given back when it goes out of scope
+class dgFrameArenaScope
+{
+	public:
+	DG_INLINE dgFrameArenaScope (dgFrameArena& arena, dgInt32 threadIndex)
+		:m_arena(arena)
+		,m_threadIndex(threadIndex)
+		,m_mark(arena.m_arenas[threadIndex].m_used)
+	{
+	}
+
+	DG_INLINE ~dgFrameArenaScope ()
+	{
+		m_arena.Rewind (m_threadIndex, m_mark);
+	}
+
+	private:
+	dgFrameArena& m_arena;
+	dgInt32 m_threadIndex;
+	dgInt32 m_mark;
+};
+
+DG_INLINE void* dgFrameArena::Alloc (dgInt32 sizeInBytes, dgInt32 threadIndex)
+{
+	dgAssert (threadIndex >= 0);
+	dgAssert (threadIndex < DG_FRAME_ARENA_COUNT);
+	dgSubArena& arena = m_arenas[threadIndex];
+	const dgInt32 size = (sizeInBytes + DG_FRAME_ARENA_ALIGNMENT - 1) & -DG_FRAME_ARENA_ALIGNMENT;
+	if ((arena.m_used + size) <= arena.m_size) {
+		void* const ptr = &arena.m_buffer[arena.m_used];
+		arena.m_used += size;
+		return ptr;
+	}
+	return AllocOverflow (arena, size);
+}
+
+DG_INLINE void dgFrameArena::Rewind (dgInt32 threadIndex, dgInt32 mark)
+{
+	dgSubArena& arena = m_arenas[threadIndex];
+	dgAssert (mark <= arena.m_used);
+	arena.m_highWaterMark = dgMax (arena.m_highWaterMark, arena.m_used + arena.m_overflowUsed);
+	arena.m_used = mark;
+}
+
+template<class T>
+dgFrameArray<T>::dgFrameArray ()
+	:m_array(NULL)
+	,m_maxSize(0)
+	,m_arena(NULL)
+	,m_arenaIndex(DG_FRAME_ARENA_ARRAYS_BASE)
+{
+}
+
+template<class T>
+dgFrameArray<T>::dgFrameArray (dgFrameArena* const arena, dgInt32 threadIndex)
+	:m_array(NULL)
+	,m_maxSize(0)
+	,m_arena(NULL)
+	,m_arenaIndex(DG_FRAME_ARENA_ARRAYS_BASE)
+{
+	SetArena (arena, threadIndex);
+}
+
+template<class T>
+void dgFrameArray<T>::SetArena (dgFrameArena* const arena, dgInt32 threadIndex)
+{
+	dgAssert (!m_array);
+	dgAssert (threadIndex >= 0);
+	dgAssert (threadIndex < DG_MAX_THREADS_HIVE_COUNT);
+	m_arena = arena;
+	m_arenaIndex = DG_FRAME_ARENA_ARRAYS_BASE + threadIndex;
+}
+
+template<class T>
+void dgFrameArray<T>::Reset ()
+{
+	const dgInt32 size = m_maxSize;
+	m_array = NULL;
+	m_maxSize = 0;
+	if (size) {
+		Resize (size);
+	}
+}
+
+template<class T>
+DG_INLINE const T& dgFrameArray<T>::operator[] (dgInt32 i) const
+{ 
+	dgAssert (i >= 0);
+	while (i >= m_maxSize) {
+		Resize (i * 2);
+	}
+	return m_array[i];
+}
+
+template<class T>
+DG_INLINE T& dgFrameArray<T>::operator[] (dgInt32 i)
+{
+	dgAssert (i >= 0);
+	while (i >= m_maxSize) {
+		Resize (i * 2);
+	}
+	return m_array[i];
+}
+
+template<class T>
+dgInt32 dgFrameArray<T>::GetElementsCapacity () const
+{
+	return m_maxSize;
+}
+
+template<class T>
+void dgFrameArray<T>::Resize (dgInt32 size) const
+{
+	size = dgMax (size, 16);
+	if (size != m_maxSize) {
+		T* const newArray = (T*) m_arena->Alloc (dgInt32 (sizeof (T) * size), m_arenaIndex);
+		if (m_array) {
+			const dgInt32 count = dgMin (size, m_maxSize);
+			for (dgInt32 i = 0; i < count; i ++) {
+				newArray[i] = m_array[i];
+			}
+		}
+		m_array = newArray;
+		m_maxSize = size;
+	}
+}
+
+template<class T>
+DG_INLINE void dgFrameArray<T>::ResizeIfNecessary (dgInt32 size) const
+{
+	while (size >= m_maxSize) {
+		Resize (m_maxSize * 2);
+	}
+}
+
+#endif
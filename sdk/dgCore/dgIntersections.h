@@ -387,6 +387,7 @@ class dgFastAABBInfo: public dgObb
 	friend class dgAABBPolygonSoup;
 	friend class dgCollisionUserMesh;
 	friend class dgCollisionHeightField;
+	friend class dgCollisionTiledHeightField;
 } DG_GCC_VECTOR_ALIGMENT;
 
 
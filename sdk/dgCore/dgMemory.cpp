@@ -25,6 +25,58 @@
 #include "dgMemory.h"
 
 dgInt32 dgMemoryAllocator::m_lock = 0;
+dgInt32 dgMemoryAllocator::m_lockContention = 0;
+
+// counts how many times a thread found the global lock already taken
+class dgMemoryScopeLock
+{
+	public:
+	DG_INLINE dgMemoryScopeLock()
+	{
+		if (dgInterlockedExchange(&dgMemoryAllocator::m_lock, 1)) {
+			dgAtomicExchangeAndAdd(&dgMemoryAllocator::m_lockContention, 1);
+			while (dgInterlockedExchange(&dgMemoryAllocator::m_lock, 1)) {
+				dgThreadPause();
+			}
+		}
+	}
+
+	DG_INLINE ~dgMemoryScopeLock()
+	{
+		dgSpinUnlock(&dgMemoryAllocator::m_lock);
+	}
+};
+
+// each thread claims one of the allocator thread cache slots the first time it allocates, 
+// and gives it back when it exits, threads that can not get a slot use the global lock  
+class dgMemoryThreadCacheIndex
+{
+	public:
+	dgMemoryThreadCacheIndex()
+		:m_index(DG_MEMORY_NO_THREAD_CACHE)
+	{
+		for (dgInt32 i = 0; i < DG_MEMORY_THREAD_CACHE_COUNT; i ++) {
+			if (!dgInterlockedExchange(&m_slotsInUse[i], 1)) {
+				m_index = i;
+				break;
+			}
+		}
+	}
+
+	~dgMemoryThreadCacheIndex()
+	{
+		if (m_index != DG_MEMORY_NO_THREAD_CACHE) {
+			dgInterlockedExchange(&m_slotsInUse[m_index], 0);
+			m_index = DG_MEMORY_NO_THREAD_CACHE;
+		}
+	}
+
+	dgInt32 m_index;
+	static dgInt32 m_slotsInUse[DG_MEMORY_THREAD_CACHE_COUNT];
+};
+
+dgInt32 dgMemoryThreadCacheIndex::m_slotsInUse[DG_MEMORY_THREAD_CACHE_COUNT];
+
 #if 0
 class dgAllocDebugCheck
 {
@@ -41,7 +93,7 @@ class dgAllocDebugCheck
 };
 #define DG_MEMORY_LOCK() dgAllocDebugCheck m_lock;
 #else 
-#define DG_MEMORY_LOCK() dgScopeSpinPause lock (&dgMemoryAllocator::m_lock);
+#define DG_MEMORY_LOCK() dgMemoryScopeLock lock;
 #endif
 
 class dgMemoryAllocator::dgMemoryBin
@@ -74,6 +126,7 @@ class dgMemoryAllocator::dgMemoryInfo
 	dgMemoryAllocator* m_allocator;
 	dgInt32 m_size;
 	dgInt32 m_enum;
+	dgInt32 m_owner;
 
 	#ifdef _DEBUG
 	dgInt32 m_workingSize;
@@ -86,6 +139,7 @@ class dgMemoryAllocator::dgMemoryInfo
 		m_enum = enumerator;
 		enumerator++;
 		m_allocator = allocator;
+		m_owner = DG_MEMORY_NO_THREAD_CACHE;
 #ifdef _DEBUG
 		m_workingSize = workingSize;
 #endif
@@ -145,9 +199,11 @@ dgMemoryAllocator::dgMemoryAllocator ()
 	,m_enumerator(0)
 	,m_memoryUsed(0)
 	,m_isInList(1)
+	,m_useThreadCaches(1)
 {
 	SetAllocatorsCallback (dgGlobalAllocator::GetGlobalAllocator().m_malloc, dgGlobalAllocator::GetGlobalAllocator().m_free);
 	memset (m_memoryDirectory, 0, sizeof (m_memoryDirectory));
+	memset (m_threadCache, 0, sizeof (m_threadCache));
 	dgGlobalAllocator::GetGlobalAllocator().Append(this);
 }
 
@@ -157,9 +213,13 @@ dgMemoryAllocator::dgMemoryAllocator (dgMemAlloc memAlloc, dgMemFree memFree)
 	,m_enumerator(0)
 	,m_memoryUsed(0)
 	,m_isInList(0)
+	,m_useThreadCaches(0)
 {
+	// the global allocator is rarely used, so it does not keep thread caches
+	// and its memory use is always exact
 	SetAllocatorsCallback (memAlloc, memFree);
 	memset (m_memoryDirectory, 0, sizeof (m_memoryDirectory));
+	memset (m_threadCache, 0, sizeof (m_threadCache));
 }
 
 dgMemoryAllocator::~dgMemoryAllocator  ()
@@ -167,6 +227,7 @@ dgMemoryAllocator::~dgMemoryAllocator  ()
 	if (m_isInList) {
 		dgGlobalAllocator::GetGlobalAllocator().Remove(this);
 	}
+	FlushThreadCaches ();
 	dgAssert (m_memoryUsed == 0);
 }
 
@@ -228,76 +289,217 @@ void dgMemoryAllocator::FreeLow (void* const retPtr)
 	m_free (info->m_ptr, dgUnsigned32 (info->m_size));
 }
 
-// alloca memory on pool that are quantized to DG_MEMORY_GRANULARITY
-// if memory size is larger than DG_MEMORY_BIN_ENTRIES then the memory is not placed into a pool
-void *dgMemoryAllocator::Malloc (dgInt32 memsize)
+dgInt32 dgMemoryAllocator::GetThreadCacheIndex ()
 {
-	dgAssert (dgInt32 (sizeof (dgMemoryCacheEntry) + sizeof (dgInt32) + sizeof(dgInt32)) <= DG_MEMORY_GRANULARITY);
+	static thread_local dgMemoryThreadCacheIndex threadCache;
+	return threadCache.m_index;
+}
 
-	dgInt32 size = memsize + DG_MEMORY_GRANULARITY - 1;
-	size &= (-DG_MEMORY_GRANULARITY);
+// take one entry from the shared bins, allocating a new bin if all are full
+// must be called with the global lock held
+dgMemoryAllocator::dgMemoryCacheEntry* dgMemoryAllocator::PopFromDirectory (dgInt32 entry, dgInt32 paddedSize, dgInt32 memsize)
+{
+	if (!m_memoryDirectory[entry].m_cache) {
+		dgMemoryBin* const bin = (dgMemoryBin*) MallocLow (sizeof (dgMemoryBin));
+
+		dgInt32 count = dgInt32 (sizeof (bin->m_pool) / paddedSize);
+		bin->m_info.m_count = 0;
+		bin->m_info.m_totalCount = count;
+		bin->m_info.m_stepInBites = paddedSize;
+		bin->m_info.m_next = m_memoryDirectory[entry].m_first;
+		bin->m_info.m_prev = NULL;
+		if (bin->m_info.m_next) {
+			bin->m_info.m_next->m_info.m_prev = bin;
+		}
 
-	dgInt32 paddedSize = size + DG_MEMORY_GRANULARITY; 
-	dgInt32 entry = paddedSize >> DG_MEMORY_GRANULARITY_BITS;	
+		m_memoryDirectory[entry].m_first = bin;
 
-	void* ptr;
-	if (entry >= DG_MEMORY_BIN_ENTRIES) {
-		ptr = MallocLow (size);
-	} else {
-		if (!m_memoryDirectory[entry].m_cache) {
-			dgMemoryBin* const bin = (dgMemoryBin*) MallocLow (sizeof (dgMemoryBin));
-
-			dgInt32 count = dgInt32 (sizeof (bin->m_pool) / paddedSize);
-			bin->m_info.m_count = 0;
-			bin->m_info.m_totalCount = count;
-			bin->m_info.m_stepInBites = paddedSize;
-			bin->m_info.m_next = m_memoryDirectory[entry].m_first;
-			bin->m_info.m_prev = NULL;
-			if (bin->m_info.m_next) {
-				bin->m_info.m_next->m_info.m_prev = bin;
-			}
+		dgInt8* charPtr = reinterpret_cast<dgInt8*>(bin->m_pool);
+		m_memoryDirectory[entry].m_cache = (dgMemoryCacheEntry*)charPtr;
+
+		for (dgInt32 i = 0; i < count; i ++) {
+			dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) charPtr;
+			cashe->m_next = (dgMemoryCacheEntry*) (charPtr + paddedSize);
+			cashe->m_prev = (dgMemoryCacheEntry*) (charPtr - paddedSize);
+			dgMemoryInfo* const info = ((dgMemoryInfo*) (charPtr + DG_MEMORY_GRANULARITY)) - 1;						
+			info->SaveInfo(this, bin, entry, m_enumerator, memsize);
+			charPtr += paddedSize;
+		}
+		dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) (charPtr - paddedSize);
+		cashe->m_next = NULL;
+		m_memoryDirectory[entry].m_cache->m_prev = NULL;
+	}
+
+	dgAssert (m_memoryDirectory[entry].m_cache);
+
+	dgMemoryCacheEntry* const cashe = m_memoryDirectory[entry].m_cache;
+	m_memoryDirectory[entry].m_cache = cashe->m_next;
+	if (cashe->m_next) {
+		cashe->m_next->m_prev = NULL;
+	}
+
+	dgMemoryInfo* const info = ((dgMemoryInfo*) (((dgInt8*)cashe) + DG_MEMORY_GRANULARITY)) - 1;
+	dgAssert (info->m_allocator == this);
+
+	dgMemoryBin* const bin = (dgMemoryBin*) info->m_ptr;
+	bin->m_info.m_count ++;
+	return cashe;
+}
+
+// give one entry back to the shared bins, releasing the bin when it becomes empty
+// must be called with the global lock held
+void dgMemoryAllocator::PushToDirectory (dgMemoryCacheEntry* const cashe, dgInt32 entry)
+{
+	dgMemoryCacheEntry* const tmpCashe = m_memoryDirectory[entry].m_cache;
+	if (tmpCashe) {
+		dgAssert (!tmpCashe->m_prev);
+		tmpCashe->m_prev = cashe;
+	}
+	cashe->m_next = tmpCashe;
+	cashe->m_prev = NULL;
+
+	m_memoryDirectory[entry].m_cache = cashe;
+
+	dgMemoryInfo* const info = ((dgMemoryInfo*) (((dgInt8*)cashe) + DG_MEMORY_GRANULARITY)) - 1;
+	dgMemoryBin* const bin = (dgMemoryBin *) info->m_ptr;
+	dgAssert (bin);
 
-			m_memoryDirectory[entry].m_first = bin;
+	bin->m_info.m_count --;
+	if (bin->m_info.m_count == 0) {
 
-			dgInt8* charPtr = reinterpret_cast<dgInt8*>(bin->m_pool);
-			m_memoryDirectory[entry].m_cache = (dgMemoryCacheEntry*)charPtr;
+		dgInt32 count = bin->m_info.m_totalCount;
+		dgInt32 sizeInBytes = bin->m_info.m_stepInBites;
+		char* charPtr = bin->m_pool;
+		for (dgInt32 i = 0; i < count; i ++) {
+			dgMemoryCacheEntry* const tmpCashe1 = (dgMemoryCacheEntry*)charPtr;
+			charPtr += sizeInBytes;
 
-			for (dgInt32 i = 0; i < count; i ++) {
-				dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) charPtr;
-				cashe->m_next = (dgMemoryCacheEntry*) (charPtr + paddedSize);
-				cashe->m_prev = (dgMemoryCacheEntry*) (charPtr - paddedSize);
-				dgMemoryInfo* const info = ((dgMemoryInfo*) (charPtr + DG_MEMORY_GRANULARITY)) - 1;						
-				info->SaveInfo(this, bin, entry, m_enumerator, memsize);
-				charPtr += paddedSize;
+			if (tmpCashe1 == m_memoryDirectory[entry].m_cache) {
+				m_memoryDirectory[entry].m_cache = tmpCashe1->m_next;
 			}
-			dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) (charPtr - paddedSize);
-			cashe->m_next = NULL;
-			m_memoryDirectory[entry].m_cache->m_prev = NULL;
+
+			if (tmpCashe1->m_prev) {
+				tmpCashe1->m_prev->m_next = tmpCashe1->m_next;
+			}
+
+			if (tmpCashe1->m_next) {
+				tmpCashe1->m_next->m_prev = tmpCashe1->m_prev;
+			}
+		}
+
+		if (m_memoryDirectory[entry].m_first == bin) {
+			m_memoryDirectory[entry].m_first = bin->m_info.m_next;
+		}
+
+		if (bin->m_info.m_next) {
+			bin->m_info.m_next->m_info.m_prev = bin->m_info.m_prev;
+		}
+		if (bin->m_info.m_prev) {
+			bin->m_info.m_prev->m_info.m_next = bin->m_info.m_next;
 		}
 
+		FreeLow (bin);
+	}
+}
+
+// first try to reclaim the entries other threads returned, 
+// only go to the shared bins when there are none
+void dgMemoryAllocator::RefillMagazine (dgMemoryMagazine& magazine, dgInt32 entry, dgInt32 paddedSize, dgInt32 memsize)
+{
+	dgAssert (!magazine.m_local);
+	dgMemoryCacheEntry* cashe = (dgMemoryCacheEntry*) dgInterlockedExchange ((void**)&magazine.m_remote, NULL);
+	if (cashe) {
+		magazine.m_local = cashe;
+		for (; cashe; cashe = cashe->m_next) {
+			magazine.m_count ++;
+		}
+	} else {
+		DG_MEMORY_LOCK();
+		for (dgInt32 i = 0; i < DG_MEMORY_MAGAZINE_SIZE; i ++) {
+			dgMemoryCacheEntry* const newCashe = PopFromDirectory (entry, paddedSize, memsize);
+			newCashe->m_next = magazine.m_local;
+			magazine.m_local = newCashe;
+		}
+		magazine.m_count += DG_MEMORY_MAGAZINE_SIZE;
+	}
+}
 
-		dgAssert (m_memoryDirectory[entry].m_cache);
+void dgMemoryAllocator::FlushMagazine (dgMemoryMagazine& magazine, dgInt32 entry, dgInt32 count)
+{
+	DG_MEMORY_LOCK();
+	for (dgInt32 i = 0; (i < count) && magazine.m_local; i ++) {
+		dgMemoryCacheEntry* const cashe = magazine.m_local;
+		magazine.m_local = cashe->m_next;
+		magazine.m_count --;
+		PushToDirectory (cashe, entry);
+	}
+}
 
-		dgMemoryCacheEntry* const cashe = m_memoryDirectory[entry].m_cache;
-		m_memoryDirectory[entry].m_cache = cashe->m_next;
-		if (cashe->m_next) {
-			cashe->m_next->m_prev = NULL;
+// return every cached entry to the shared bins so that the bins can be released
+void dgMemoryAllocator::FlushThreadCaches ()
+{
+	for (dgInt32 i = 0; i < DG_MEMORY_THREAD_CACHE_COUNT; i ++) {
+		for (dgInt32 entry = 0; entry < DG_MEMORY_BIN_ENTRIES; entry ++) {
+			dgMemoryMagazine& magazine = m_threadCache[i].m_magazines[entry];
+			dgMemoryCacheEntry* cashe = (dgMemoryCacheEntry*) dgInterlockedExchange ((void**)&magazine.m_remote, NULL);
+			while (cashe) {
+				dgMemoryCacheEntry* const next = cashe->m_next;
+				cashe->m_next = magazine.m_local;
+				magazine.m_local = cashe;
+				magazine.m_count ++;
+				cashe = next;
+			}
+			if (magazine.m_local) {
+				FlushMagazine (magazine, entry, magazine.m_count);
+			}
+			dgAssert (!magazine.m_count);
 		}
+	}
+}
 
-		ptr = ((dgInt8*)cashe) + DG_MEMORY_GRANULARITY;
+// alloca memory on pool that are quantized to DG_MEMORY_GRANULARITY
+// if memory size is larger than DG_MEMORY_BIN_ENTRIES then the memory is not placed into a pool
+// small blocks are taken from the calling thread magazine, the global lock is only used for refills
+void *dgMemoryAllocator::Malloc (dgInt32 memsize)
+{
+	dgAssert (dgInt32 (sizeof (dgMemoryCacheEntry) + sizeof (dgMemoryInfo)) <= DG_MEMORY_GRANULARITY);
 
-		dgMemoryInfo* info;
-		info = ((dgMemoryInfo*) (ptr)) - 1;
-		dgAssert (info->m_allocator == this);
+	dgInt32 size = memsize + DG_MEMORY_GRANULARITY - 1;
+	size &= (-DG_MEMORY_GRANULARITY);
 
-		dgMemoryBin* const bin = (dgMemoryBin*) info->m_ptr;
-		bin->m_info.m_count ++;
+	dgInt32 paddedSize = size + DG_MEMORY_GRANULARITY; 
+	dgInt32 entry = paddedSize >> DG_MEMORY_GRANULARITY_BITS;	
+
+	if (entry >= DG_MEMORY_BIN_ENTRIES) {
+		DG_MEMORY_LOCK();
+		return MallocLow (size);
+	} 
+
+	dgMemoryCacheEntry* cashe;
+	const dgInt32 threadIndex = m_useThreadCaches ? GetThreadCacheIndex () : DG_MEMORY_NO_THREAD_CACHE;
+	if (threadIndex == DG_MEMORY_NO_THREAD_CACHE) {
+		DG_MEMORY_LOCK();
+		cashe = PopFromDirectory (entry, paddedSize, memsize);
+	} else {
+		dgMemoryMagazine& magazine = m_threadCache[threadIndex].m_magazines[entry];
+		if (!magazine.m_local) {
+			RefillMagazine (magazine, entry, paddedSize, memsize);
+		}
+		cashe = magazine.m_local;
+		magazine.m_local = cashe->m_next;
+		magazine.m_count --;
 	}
+
+	void* const ptr = ((dgInt8*)cashe) + DG_MEMORY_GRANULARITY;
+	dgMemoryInfo* const info = ((dgMemoryInfo*) (ptr)) - 1;
+	dgAssert (info->m_allocator == this);
+	info->m_owner = threadIndex;
 	return ptr;
 }
 
 // alloca memory on pool that are quantized to DG_MEMORY_GRANULARITY
 // if memory size is larger than DG_MEMORY_BIN_ENTRIES then the memory is not placed into a pool
+// blocks allocated by a different thread are pushed back to the owner magazine without locking
 void dgMemoryAllocator::Free (void* const retPtr)
 {
 	dgMemoryInfo* const info = ((dgMemoryInfo*) (retPtr)) - 1;
@@ -306,63 +508,36 @@ void dgMemoryAllocator::Free (void* const retPtr)
 	dgInt32 entry = info->m_size;
 
 	if (entry >= DG_MEMORY_BIN_ENTRIES) {
+		DG_MEMORY_LOCK();
 		FreeLow (retPtr);
 	} else {
-		dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) (((char*)retPtr) - DG_MEMORY_GRANULARITY) ;
-
-		dgMemoryCacheEntry* const tmpCashe = m_memoryDirectory[entry].m_cache;
-		if (tmpCashe) {
-			dgAssert (!tmpCashe->m_prev);
-			tmpCashe->m_prev = cashe;
-		}
-		cashe->m_next = tmpCashe;
-		cashe->m_prev = NULL;
-
-		m_memoryDirectory[entry].m_cache = cashe;
-
-		dgMemoryBin* const bin = (dgMemoryBin *) info->m_ptr;
-
-		dgAssert (bin);
 #ifdef _DEBUG
+		dgMemoryBin* const bin = (dgMemoryBin *) info->m_ptr;
 		dgAssert ((bin->m_info.m_stepInBites - DG_MEMORY_GRANULARITY) > 0);
 		memset (retPtr, 0, size_t(bin->m_info.m_stepInBites - DG_MEMORY_GRANULARITY));
 #endif
 
-		bin->m_info.m_count --;
-		if (bin->m_info.m_count == 0) {
-
-			dgInt32 count = bin->m_info.m_totalCount;
-			dgInt32 sizeInBytes = bin->m_info.m_stepInBites;
-			char* charPtr = bin->m_pool;
-			for (dgInt32 i = 0; i < count; i ++) {
-				dgMemoryCacheEntry* const tmpCashe1 = (dgMemoryCacheEntry*)charPtr;
-				charPtr += sizeInBytes;
-
-				if (tmpCashe1 == m_memoryDirectory[entry].m_cache) {
-					m_memoryDirectory[entry].m_cache = tmpCashe1->m_next;
-				}
-
-				if (tmpCashe1->m_prev) {
-					tmpCashe1->m_prev->m_next = tmpCashe1->m_next;
-				}
-
-				if (tmpCashe1->m_next) {
-					tmpCashe1->m_next->m_prev = tmpCashe1->m_prev;
-				}
-			}
-
-			if (m_memoryDirectory[entry].m_first == bin) {
-				m_memoryDirectory[entry].m_first = bin->m_info.m_next;
-			}
-
-			if (bin->m_info.m_next) {
-				bin->m_info.m_next->m_info.m_prev = bin->m_info.m_prev;
+		dgMemoryCacheEntry* const cashe = (dgMemoryCacheEntry*) (((char*)retPtr) - DG_MEMORY_GRANULARITY);
+		const dgInt32 owner = info->m_owner;
+		const dgInt32 threadIndex = m_useThreadCaches ? GetThreadCacheIndex () : DG_MEMORY_NO_THREAD_CACHE;
+		if (threadIndex == DG_MEMORY_NO_THREAD_CACHE) {
+			DG_MEMORY_LOCK();
+			PushToDirectory (cashe, entry);
+		} else if ((owner == threadIndex) || (owner == DG_MEMORY_NO_THREAD_CACHE)) {
+			dgMemoryMagazine& magazine = m_threadCache[threadIndex].m_magazines[entry];
+			cashe->m_next = magazine.m_local;
+			magazine.m_local = cashe;
+			magazine.m_count ++;
+			if (magazine.m_count > DG_MEMORY_MAGAZINE_SIZE * 2) {
+				FlushMagazine (magazine, entry, DG_MEMORY_MAGAZINE_SIZE);
 			}
-			if (bin->m_info.m_prev) {
-				bin->m_info.m_prev->m_info.m_next = bin->m_info.m_next;
-			}
-
-			FreeLow (bin);
+		} else {
+			dgMemoryMagazine& magazine = m_threadCache[owner].m_magazines[entry];
+			dgMemoryCacheEntry* head;
+			do {
+				head = magazine.m_remote;
+				cashe->m_next = head;
+			} while (dgInterlockedCompareExchange ((void**)&magazine.m_remote, cashe, head) != head);
 		}
 	}
 }
@@ -378,6 +553,11 @@ dgInt32 dgMemoryAllocator::GetGlobalMemoryUsed ()
 	return dgGlobalAllocator::GetGlobalAllocator().GetMemoryUsed();
 }
 
+dgInt32 dgMemoryAllocator::GetLockContention ()
+{
+	return m_lockContention;
+}
+
 // this can be used by function that allocates large memory pools memory locally on the stack
 // this by pases the pool allocation because this should only be used for very large memory blocks.
 // this was using virtual memory on windows but 
@@ -412,7 +592,6 @@ void* dgApi dgMalloc (size_t size, dgMemoryAllocator* const allocator)
 	void* ptr = NULL;
 	dgAssert (allocator);
 
-	DG_MEMORY_LOCK();
 	if (size) {
 		ptr = allocator->Malloc (dgInt32 (size));
 	}
@@ -423,7 +602,6 @@ void* dgApi dgMalloc (size_t size, dgMemoryAllocator* const allocator)
 void dgApi dgFree (void* const ptr)
 {
 	if (ptr) {
-		DG_MEMORY_LOCK();
 		dgMemoryAllocator::dgMemoryInfo* const info = ((dgMemoryAllocator::dgMemoryInfo*) ptr) - 1;
 		dgAssert (info->m_allocator);
 		info->m_allocator->Free (ptr);
@@ -68,6 +68,9 @@ class dgMemoryAllocator
 	#define DG_MEMORY_SIZE						(1024 - 64)
 	#define DG_MEMORY_BIN_SIZE					(1024 * 16)
 	#define DG_MEMORY_BIN_ENTRIES				(DG_MEMORY_SIZE / DG_MEMORY_GRANULARITY)
+	#define DG_MEMORY_THREAD_CACHE_COUNT		(DG_MAX_THREADS_HIVE_COUNT * 2)
+	#define DG_MEMORY_MAGAZINE_SIZE				32
+	#define DG_MEMORY_NO_THREAD_CACHE			-1
 
 	public: 
 	class dgMemoryBin;
@@ -81,6 +84,22 @@ class dgMemoryAllocator
 		dgMemoryCacheEntry* m_cache;
 	};
 
+	// per thread list of free blocks of one bin size, only the owner thread touches m_local, 
+	// other threads return blocks allocated by the owner by pushing them on m_remote
+	class dgMemoryMagazine
+	{
+		public: 
+		dgMemoryCacheEntry* m_local;
+		dgMemoryCacheEntry* m_remote;
+		dgInt32 m_count;
+	};
+
+	class dgMemoryThreadCache
+	{
+		public: 
+		dgMemoryMagazine m_magazines[DG_MEMORY_BIN_ENTRIES + 1];
+	};
+
 	dgMemoryAllocator ();
 	virtual ~dgMemoryAllocator ();
 
@@ -95,6 +114,7 @@ class dgMemoryAllocator
 	virtual void Free (void* const retPtr);
 
 	static dgInt32 GetGlobalMemoryUsed ();
+	static dgInt32 GetLockContention ();
 	static void SetGlobalAllocators (dgMemAlloc alloc, dgMemFree free);
 
 	protected:
@@ -104,20 +124,34 @@ class dgMemoryAllocator
 		,m_enumerator(0)
 		,m_memoryUsed(0)
 		,m_isInList(0)
+		,m_useThreadCaches(0)
 	{	
+		memset (m_threadCache, 0, sizeof (m_threadCache));
 	}
 
 	dgMemoryAllocator (dgMemAlloc memAlloc, dgMemFree memFree);
 
+	private:
+	dgMemoryCacheEntry* PopFromDirectory (dgInt32 entry, dgInt32 paddedSize, dgInt32 memsize);
+	void PushToDirectory (dgMemoryCacheEntry* const cashe, dgInt32 entry);
+	void RefillMagazine (dgMemoryMagazine& magazine, dgInt32 entry, dgInt32 paddedSize, dgInt32 memsize);
+	void FlushMagazine (dgMemoryMagazine& magazine, dgInt32 entry, dgInt32 count);
+	void FlushThreadCaches ();
+	static dgInt32 GetThreadCacheIndex ();
+
+	protected:
 	dgMemFree m_free;
 	dgMemAlloc m_malloc;
 	dgMemDirectory m_memoryDirectory[DG_MEMORY_BIN_ENTRIES + 1]; 
+	dgMemoryThreadCache m_threadCache[DG_MEMORY_THREAD_CACHE_COUNT];
 	dgInt32 m_enumerator;
 	dgInt32 m_memoryUsed;
 	dgInt32 m_isInList;
+	dgInt32 m_useThreadCaches;
 
 	public:
 	static dgInt32 m_lock;
+	static dgInt32 m_lockContention;
 };
 
 class dgStackMemoryAllocator: public dgMemoryAllocator 
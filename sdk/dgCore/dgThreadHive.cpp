@@ -26,12 +26,74 @@
 #include "dgThreadHive.h"
 
 
+dgThreadHive::dgJobDeque::dgJobDeque()
+	:m_top(0)
+	,m_bottom(0)
+	,m_busyTime(0)
+	,m_jobs()
+{
+}
+
+void dgThreadHive::dgJobDeque::SetAllocator(dgMemoryAllocator* const allocator)
+{
+	m_jobs.SetAllocator(allocator);
+}
+
+void dgThreadHive::dgJobDeque::Push(const dgThreadJob& job)
+{
+	// only the parent pushes, and only while no thread is popping or stealing
+	m_jobs[m_bottom] = job;
+	m_bottom ++;
+}
+
+bool dgThreadHive::dgJobDeque::Pop(dgThreadJob& job)
+{
+	// claim the bottom job before looking at the top, so a thief and the owner never both take it
+	const dgInt32 bottom = m_bottom - 1;
+	dgInterlockedExchange(&m_bottom, bottom);
+	const dgInt32 top = dgAtomicExchangeAndAdd(&m_top, 0);
+	if (top > bottom) {
+		dgInterlockedExchange(&m_bottom, top);
+		return false;
+	}
+
+	const dgArray<dgThreadJob>& jobs = m_jobs;
+	job = jobs[bottom];
+	if (top == bottom) {
+		// last job, race the thieves for it
+		const bool won = (dgInterlockedCompareExchange(&m_top, top + 1, top) == top);
+		dgInterlockedExchange(&m_bottom, top + 1);
+		return won;
+	}
+	return true;
+}
+
+dgInt32 dgThreadHive::dgJobDeque::Steal(dgThreadJob& job)
+{
+	// return 1 if a job was stolen, 0 if the deque is empty and -1 if another thread took the job first
+	const dgInt32 top = dgAtomicExchangeAndAdd(&m_top, 0);
+	const dgInt32 bottom = dgAtomicExchangeAndAdd(&m_bottom, 0);
+	if (top >= bottom) {
+		return 0;
+	}
+	const dgArray<dgThreadJob>& jobs = m_jobs;
+	job = jobs[top];
+	return (dgInterlockedCompareExchange(&m_top, top + 1, top) == top) ? 1 : -1;
+}
+
+void dgThreadHive::dgJobDeque::Reset()
+{
+	m_top = 0;
+	m_bottom = 0;
+}
+
 dgThreadHive::dgWorkerThread::dgWorkerThread()
 	:dgThread()
 	,m_hive(NULL)
 	,m_allocator(NULL)
 	,m_isBusy(0)
-	,m_jobsCount(0)
+	,m_isParked(0)
+	,m_hasJobs(0)
 	,m_workerSemaphore()
 {
 }
@@ -41,7 +103,9 @@ dgThreadHive::dgWorkerThread::~dgWorkerThread()
 	while (IsBusy());
 
 	dgInterlockedExchange(&m_terminate, 1);
-	m_workerSemaphore.Release();
+	if (dgInterlockedExchange(&m_isParked, 0)) {
+		m_workerSemaphore.Release();
+	}
 	Close();
 }
 
@@ -69,11 +133,11 @@ void dgThreadHive::dgWorkerThread::Execute (dgInt32 threadId)
 
 	while (!m_terminate) {
 		dgInterlockedExchange(&m_isBusy, 0);
-		SuspendExecution(m_workerSemaphore);
+		WaitForJobs();
 		dgInterlockedExchange(&m_isBusy, 1);
 		if (!m_terminate) {
-			RunNextJobInQueue(threadId);
-			m_hive->m_semaphore[threadId].Release();
+			m_hive->RunJobs(m_id);
+			m_hive->WorkerIdle();
 		}
 	}
 
@@ -82,31 +146,50 @@ void dgThreadHive::dgWorkerThread::Execute (dgInt32 threadId)
 	m_hive->OnEndWorkerThread (threadId);
 }
 
-dgInt32 dgThreadHive::dgWorkerThread::PushJob(const dgThreadJob& job)
+void dgThreadHive::dgWorkerThread::WaitForJobs()
 {
-	dgAssert (m_jobsCount < sizeof (m_jobPool)/ sizeof (m_jobPool[0]));
-	m_jobPool[m_jobsCount] = job;
-	m_jobsCount ++;
-	return m_jobsCount;
+	// spin for a little while, most of the time the next batch of jobs is only a few micro seconds away 
+	for (dgInt32 i = 0; i < DG_THREAD_HIVE_SPIN_COUNT; i ++) {
+		if (m_terminate || dgInterlockedExchange(&m_hasJobs, 0)) {
+			return;
+		}
+		dgThreadPause();
+	}
+
+	// nothing came, park the thread until the hive wakes it up
+	dgInterlockedExchange(&m_isParked, 1);
+	if (m_terminate || dgInterlockedExchange(&m_hasJobs, 0)) {
+		if (dgInterlockedExchange(&m_isParked, 0)) {
+			return;
+		}
+		// the hive already claimed the wake up, consume the pending semaphore signal
+		SuspendExecution(m_workerSemaphore);
+		return;
+	}
+	SuspendExecution(m_workerSemaphore);
+	dgInterlockedExchange(&m_hasJobs, 0);
 }
 
-void dgThreadHive::dgWorkerThread::RunNextJobInQueue(dgInt32 threadId)
+void dgThreadHive::dgWorkerThread::WakeUp()
 {
-	for (dgInt32 i = 0; i < m_jobsCount; i ++) {
-		const dgThreadJob& job = m_jobPool[i];
-		DG_TRACKTIME_NAMED(job.m_jobName);
-		job.m_callback (job.m_context0, job.m_context1, m_id);
+	dgInterlockedExchange(&m_hasJobs, 1);
+	if (dgInterlockedExchange(&m_isParked, 0)) {
+		m_workerSemaphore.Release();
 	}
-	m_jobsCount = 0;
 }
 
 dgThreadHive::dgThreadHive(dgMemoryAllocator* const allocator)
 	:m_parentThread(NULL)
 	,m_workerThreads(NULL)
+	,m_jobQueues(NULL)
 	,m_allocator(allocator)
 	,m_jobsCount(0)
 	,m_workerThreadsCount(0)
+	,m_activeWorkersCount(0)
+	,m_idleWorkersCount(0)
+	,m_parentParked(0)
 	,m_globalCriticalSection(0)
+	,m_parentSemaphore()
 {
 }
 
@@ -124,7 +207,9 @@ void dgThreadHive::DestroyThreads()
 {
 	if (m_workerThreadsCount) {
 		delete[] m_workerThreads;
+		delete[] m_jobQueues;
 		m_workerThreads = NULL;
+		m_jobQueues = NULL;
 		m_workerThreadsCount = 0;
 	}
 }
@@ -133,14 +218,17 @@ void dgThreadHive::SetThreadsCount (dgInt32 threads)
 {
 	DestroyThreads();
 
-	m_workerThreadsCount = dgMin (threads, DG_MAX_THREADS_HIVE_COUNT);
-	if (m_workerThreadsCount == 1) {
-		m_workerThreadsCount = 0;
-	}
+	// the parent thread is one of the threads of the hive, so it only needs threads - 1 workers
+	const dgInt32 threadsCount = dgMin (threads, DG_MAX_THREADS_HIVE_COUNT);
+	m_workerThreadsCount = dgMax (threadsCount - 1, 0);
 
 	if (m_workerThreadsCount) {
 		m_workerThreads = new (m_allocator) dgWorkerThread[dgUnsigned32 (m_workerThreadsCount)];
+		m_jobQueues = new (m_allocator) dgJobDeque[dgUnsigned32 (m_workerThreadsCount + 1)];
 
+		for (dgInt32 i = 0; i <= m_workerThreadsCount; i ++) {
+			m_jobQueues[i].SetAllocator(m_allocator);
+		}
 		for (dgInt32 i = 0; i < m_workerThreadsCount; i ++) {
 			char name[256];
 			sprintf (name, "dgWorkerThread%d", i);
@@ -155,16 +243,14 @@ void dgThreadHive::QueueJob (dgWorkerThreadTaskCallback callback, void* const co
 		DG_TRACKTIME(functionName);
 		callback (context0, context1, 0);
 	} else {
-		dgInt32 workerTreadEntry = m_jobsCount % m_workerThreadsCount;
+		// the first job goes to the parent, so batches smaller than the hive do not wake every worker
+		const dgInt32 threadsCount = m_workerThreadsCount + 1;
+		const dgInt32 threadId = (m_jobsCount + m_workerThreadsCount) % threadsCount;
 		#ifdef DG_USE_THREAD_EMULATION
 			DG_TRACKTIME(functionName);
-			callback (context0, context1, workerTreadEntry);
+			callback (context0, context1, threadId);
 		#else 
-			dgInt32 index = m_workerThreads[workerTreadEntry].PushJob(dgThreadJob(context0, context1, callback, functionName));
-			if (index >= DG_THREAD_POOL_JOB_SIZE) {
-				dgAssert (0);
-				SynchronizationBarrier ();
-			}
+			m_jobQueues[threadId].Push(dgThreadJob(context0, context1, callback, functionName));
 		#endif
 	}
 
@@ -179,15 +265,111 @@ void dgThreadHive::OnEndWorkerThread (dgInt32 threadId)
 {
 }
 
+void dgThreadHive::RunJob(const dgThreadJob& job, dgInt32 threadId)
+{
+	// only the callback counts as busy time, not stealing, spinning or waiting on the barrier. 
+	// the time is written before the thread reports idle, so the parent sees it after the barrier.
+	DG_TRACKTIME_NAMED(job.m_jobName);
+	const dgUnsigned64 startTime = dgGetTimeInMicrosenconds();
+	job.m_callback (job.m_context0, job.m_context1, threadId);
+	m_jobQueues[threadId].m_busyTime += dgGetTimeInMicrosenconds() - startTime;
+}
+
+void dgThreadHive::RunJobs(dgInt32 threadId)
+{
+	// the callback gets the id of the thread running the job, so per thread scratch is never shared 
+	// by two jobs at the same time. no job is pushed during a barrier, so once a thread finds every 
+	// deque empty there is nothing left for it to do.
+	dgThreadJob job;
+	dgJobDeque& queue = m_jobQueues[threadId];
+	while (queue.Pop(job)) {
+		RunJob(job, threadId);
+	}
+
+	const dgInt32 threadsCount = m_workerThreadsCount + 1;
+	for (dgInt32 i = 1; i < threadsCount; i ++) {
+		dgJobDeque& victim = m_jobQueues[(threadId + i) % threadsCount];
+		for (dgInt32 state = victim.Steal(job); state; state = victim.Steal(job)) {
+			if (state > 0) {
+				RunJob(job, threadId);
+			}
+		}
+	}
+}
+
+void dgThreadHive::WorkerIdle()
+{
+	// the last worker running out of jobs releases the parent thread if it is parked
+	if (dgAtomicExchangeAndAdd(&m_idleWorkersCount, 1) == (m_activeWorkersCount - 1)) {
+		if (dgInterlockedExchange(&m_parentParked, 0)) {
+			m_parentSemaphore.Release();
+		}
+	}
+}
+
+void dgThreadHive::WaitForWorkers()
+{
+	for (dgInt32 i = 0; i < DG_THREAD_HIVE_SPIN_COUNT; i ++) {
+		if (dgAtomicExchangeAndAdd(&m_idleWorkersCount, 0) == m_activeWorkersCount) {
+			return;
+		}
+		dgThreadPause();
+	}
+
+	dgInterlockedExchange(&m_parentParked, 1);
+	if (dgAtomicExchangeAndAdd(&m_idleWorkersCount, 0) == m_activeWorkersCount) {
+		if (dgInterlockedExchange(&m_parentParked, 0)) {
+			return;
+		}
+	}
+	m_parentSemaphore.Wait();
+}
+
 void dgThreadHive::SynchronizationBarrier ()
 {
 	if (m_workerThreadsCount) {
 		DG_TRACKTIME(__FUNCTION__);
-		for (dgInt32 i = 0; i < m_workerThreadsCount; i ++) {
-			m_workerThreads[i].m_workerSemaphore.Release();
+		// only wake as many workers as there are jobs besides the one of the parent
+		m_activeWorkersCount = dgMin (dgMax (m_jobsCount - 1, 0), m_workerThreadsCount);
+		dgInterlockedExchange(&m_idleWorkersCount, 0);
+		for (dgInt32 i = 0; i < m_activeWorkersCount; i ++) {
+			m_workerThreads[i].WakeUp();
+		}
+		RunJobs(m_workerThreadsCount);
+		WaitForWorkers();
+		for (dgInt32 i = 0; i <= m_workerThreadsCount; i ++) {
+			m_jobQueues[i].Reset();
 		}
-		m_parentThread->SuspendExecution(m_workerThreadsCount, m_semaphore);
 	}
 	m_jobsCount = 0;
 }
 
+void dgThreadHive::ParallelForKernel (void* const context0, void* const context1, dgInt32 threadID)
+{
+	dgParallelForDescriptor* const descriptor = (dgParallelForDescriptor*) context0;
+	const dgInt32 end = descriptor->m_end;
+	const dgInt32 grain = descriptor->m_grain;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, grain); i < end; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, grain)) {
+		descriptor->m_callback (descriptor->m_context, i, dgMin (i + grain, end), threadID);
+	}
+}
+
+void dgThreadHive::ParallelFor (dgInt32 begin, dgInt32 end, dgInt32 grain, dgParallelForCallback callback, void* const context, const char* const functionName)
+{
+	if (begin >= end) {
+		return;
+	}
+
+	const dgInt32 threadsCount = GetThreadCount();
+	if (threadsCount == 1) {
+		DG_TRACKTIME(functionName);
+		callback (context, begin, end, 0);
+	} else {
+		const dgInt32 maxGrain = dgMax ((end - begin) / (threadsCount * DG_PARALLEL_FOR_CHUNKS_PER_THREAD), 1);
+		dgParallelForDescriptor descriptor (callback, context, begin, end, (grain > 0) ? dgMin (grain, maxGrain) : maxGrain);
+		for (dgInt32 i = 0; i < threadsCount; i ++) {
+			QueueJob (ParallelForKernel, &descriptor, NULL, functionName);
+		}
+		SynchronizationBarrier();
+	}
+}
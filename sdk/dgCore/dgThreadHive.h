@@ -25,10 +25,17 @@
 
 #include "dgThread.h"
 #include "dgMemory.h"
+#include "dgArray.h"
 #include "dgFastQueue.h"
 
-#define DG_THREAD_POOL_JOB_SIZE (256)
+// number of times an idle thread spins before parking on its semaphore
+#define DG_THREAD_HIVE_SPIN_COUNT (256)
+
+// minimum number of chunks per thread a parallel for loop is split into
+#define DG_PARALLEL_FOR_CHUNKS_PER_THREAD (8)
+
 typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const context1, dgInt32 threadID);
+typedef void (*dgParallelForCallback) (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
 
 class dgThreadHive  
 {
@@ -54,6 +61,46 @@ class dgThreadHive
 		dgWorkerThreadTaskCallback m_callback;
 	};
 
+	class dgParallelForDescriptor
+	{
+		public:
+		dgParallelForDescriptor(dgParallelForCallback callback, void* const context, dgInt32 begin, dgInt32 end, dgInt32 grain)
+			:m_callback(callback)
+			,m_context(context)
+			,m_atomicIndex(begin)
+			,m_end(end)
+			,m_grain(grain)
+		{
+		}
+
+		dgParallelForCallback m_callback;
+		void* m_context;
+		dgInt32 m_atomicIndex;
+		dgInt32 m_end;
+		dgInt32 m_grain;
+	};
+
+	// per thread job deque, jobs are only pushed by the parent thread while the workers are idle. 
+	// during a barrier the owner thread pops from the bottom and the other threads steal from the top.
+	class dgJobDeque
+	{
+		public:
+		DG_CLASS_ALLOCATOR(allocator)
+
+		dgJobDeque();
+
+		void SetAllocator(dgMemoryAllocator* const allocator);
+		void Push(const dgThreadJob& job);
+		bool Pop(dgThreadJob& job);
+		dgInt32 Steal(dgThreadJob& job);
+		void Reset();
+
+		dgInt32 m_top;
+		dgInt32 m_bottom;
+		dgUnsigned64 m_busyTime;
+		dgArray<dgThreadJob> m_jobs;
+	};
+
 	class dgWorkerThread: public dgThread
 	{
 		public:
@@ -66,15 +113,15 @@ class dgThreadHive
 		void SetUp(dgMemoryAllocator* const allocator, const char* const name, dgInt32 id, dgThreadHive* const hive);
 		virtual void Execute (dgInt32 threadId);
 
-		dgInt32 PushJob(const dgThreadJob& job);
-		void RunNextJobInQueue(dgInt32 threadId);
+		void WaitForJobs();
+		void WakeUp();
 
 		dgThreadHive* m_hive;
 		dgMemoryAllocator* m_allocator; 
 		dgInt32 m_isBusy;
-		dgInt32 m_jobsCount;
+		dgInt32 m_isParked;
+		dgInt32 m_hasJobs;
 		dgSemaphore m_workerSemaphore;
-		dgThreadJob m_jobPool[DG_THREAD_POOL_JOB_SIZE];
 	};
 
 	dgThreadHive(dgMemoryAllocator* const allocator);
@@ -95,24 +142,44 @@ class dgThreadHive
 	dgInt32 GetMaxThreadCount() const;
 	void SetThreadsCount (dgInt32 count);
 
+	// accumulated micro seconds the hive thread spent inside job callbacks since the threads were created, 
+	// the last index is the parent thread
+	dgUnsigned64 GetThreadBusyTime (dgInt32 threadIndex) const;
+
 	virtual void QueueJob (dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, const char* const functionName);
 	virtual void SynchronizationBarrier ();
 
+	// call callback over [begin, end) in chunks of up to grain items, chunks are handed out dynamically 
+	// to the worker threads so uneven work balances itself. a grain of zero selects a chunk size 
+	// from the range and the thread count. the call ends with a synchronization barrier.
+	void ParallelFor (dgInt32 begin, dgInt32 end, dgInt32 grain, dgParallelForCallback callback, void* const context, const char* const functionName);
+
 	private:
+	static void ParallelForKernel (void* const context0, void* const context1, dgInt32 threadID);
+
 	void DestroyThreads();
+	void RunJob(const dgThreadJob& job, dgInt32 threadId);
+	void RunJobs(dgInt32 threadId);
+	void WaitForWorkers();
+	void WorkerIdle();
 
 	dgThread* m_parentThread;
 	dgWorkerThread* m_workerThreads;
+	dgJobDeque* m_jobQueues;
 	dgMemoryAllocator* m_allocator;
 	dgInt32 m_jobsCount;
 	dgInt32 m_workerThreadsCount;
+	dgInt32 m_activeWorkersCount;
+	dgInt32 m_idleWorkersCount;
+	dgInt32 m_parentParked;
 	mutable dgInt32 m_globalCriticalSection;
-	dgThread::dgSemaphore m_semaphore[DG_MAX_THREADS_HIVE_COUNT];
+	dgThread::dgSemaphore m_parentSemaphore;
 };
 
 DG_INLINE dgInt32 dgThreadHive::GetThreadCount() const
 {
-	return m_workerThreadsCount ? m_workerThreadsCount : 1;
+	// the parent thread runs jobs too, it is the last thread of the hive
+	return m_workerThreadsCount + 1;
 }
 
 DG_INLINE dgInt32 dgThreadHive::GetMaxThreadCount() const
@@ -120,6 +187,11 @@ DG_INLINE dgInt32 dgThreadHive::GetMaxThreadCount() const
 	return DG_MAX_THREADS_HIVE_COUNT;
 }
 
+DG_INLINE dgUnsigned64 dgThreadHive::GetThreadBusyTime (dgInt32 threadIndex) const
+{
+	return (m_jobQueues && (threadIndex <= m_workerThreadsCount)) ? m_jobQueues[threadIndex].m_busyTime : 0;
+}
+
 
 DG_INLINE void dgThreadHive::GlobalLock() const
 {
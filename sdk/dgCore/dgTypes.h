@@ -123,6 +123,9 @@
 			#include <mmintrin.h> 
 		} 
 	#endif
+	#if (defined (__i386__) || defined (__x86_64__))
+		#include <cpuid.h>
+	#endif
 #endif
 
 #ifdef _MACOSX_VER
@@ -134,6 +137,7 @@
 		#include <pmmintrin.h> 
 		#include <emmintrin.h>  //sse3
         #include <mmintrin.h> 
+		#include <cpuid.h>
     #endif
 #endif
 
@@ -162,7 +166,7 @@
 	#include <condition_variable>
 #endif
 
-#if defined (_DG_USE_PROFILER) && (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+#ifdef _DG_USE_PROFILER
 	#include <dTimeTracker.h>
 #endif
 
@@ -208,6 +212,7 @@
 
 #define DG_VECTOR_SIMD_SIZE		16
 #define DG_VECTOR_AVX2_SIZE		32
+#define DG_VECTOR_AVX512_SIZE	64
 
 #if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
 	#define	DG_GCC_VECTOR_ALIGMENT	
@@ -225,6 +230,14 @@
 	#define	DG_MSC_AVX_ALIGMENT			
 #endif
 
+#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+	#define	DG_GCC_AVX512_ALIGMENT	
+	#define	DG_MSC_AVX512_ALIGMENT		__declspec(align(DG_VECTOR_AVX512_SIZE))
+#else
+	#define	DG_GCC_AVX512_ALIGMENT		__attribute__ ((aligned (DG_VECTOR_AVX512_SIZE)))
+	#define	DG_MSC_AVX512_ALIGMENT			
+#endif
+
 
 
 #if ((defined (_WIN_32_VER) || defined (_WIN_64_VER)) && (_MSC_VER  >= 1600))
@@ -527,7 +540,7 @@ void dgRadixSort (T* const array, T* const tmpArray, dgInt32 elements, dgInt32 r
 			
 			dgInt32 radixShift = (radix + 1) << 3;
 			for (dgInt32 i = 0; i < elements; i ++) {
-				dgInt32 key = (getRadixKey (&array[i], context) >> radixShift) & 0xff;
+				dgInt32 key = (getRadixKey (&tmpArray[i], context) >> radixShift) & 0xff;
 				dgInt32 index = scanCount[key];
 				array[index] = tmpArray[i];
 				scanCount[key] = index + 1;
@@ -844,6 +857,45 @@ DG_INLINE dgInt32 dgInterlockedExchange(dgInt32* const ptr, dgInt32 value)
 	#endif
 }
 
+DG_INLINE void* dgInterlockedExchange(void** const ptr, void* const value)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		return _InterlockedExchangePointer(ptr, value);
+	#elif (defined (_MINGW_32_VER) || defined (_MINGW_64_VER))
+		return InterlockedExchangePointer(ptr, value);
+	#elif (defined (_POSIX_VER) || defined (_POSIX_VER_64) ||defined (_MACOSX_VER))
+		return __sync_lock_test_and_set(ptr, value);
+	#else
+		#error "dgInterlockedExchange implementation required"
+	#endif
+}
+
+DG_INLINE dgInt32 dgInterlockedCompareExchange(dgInt32* const ptr, dgInt32 value, dgInt32 comparand)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		return _InterlockedCompareExchange((long*)ptr, value, comparand);
+	#elif (defined (_MINGW_32_VER) || defined (_MINGW_64_VER))
+		return InterlockedCompareExchange((long*)ptr, value, comparand);
+	#elif (defined (_POSIX_VER) || defined (_POSIX_VER_64) ||defined (_MACOSX_VER))
+		return __sync_val_compare_and_swap((int32_t*)ptr, comparand, value);
+	#else
+		#error "dgInterlockedCompareExchange implementation required"
+	#endif
+}
+
+DG_INLINE void* dgInterlockedCompareExchange(void** const ptr, void* const value, void* const comparand)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		return _InterlockedCompareExchangePointer(ptr, value, comparand);
+	#elif (defined (_MINGW_32_VER) || defined (_MINGW_64_VER))
+		return InterlockedCompareExchangePointer(ptr, value, comparand);
+	#elif (defined (_POSIX_VER) || defined (_POSIX_VER_64) ||defined (_MACOSX_VER))
+		return __sync_val_compare_and_swap(ptr, comparand, value);
+	#else
+		#error "dgInterlockedCompareExchange implementation required"
+	#endif
+}
+
 DG_INLINE dgInt32 dgInterlockedTest(dgInt32* const ptr, dgInt32 value)
 {
 	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
@@ -890,7 +942,7 @@ DG_INLINE void dgThreadYield()
 DG_INLINE void dgThreadPause()
 {
 #ifndef DG_USE_THREAD_EMULATION
-	#if defined (_WIN_32_VER) || defined (_WIN_64_VER) || defined (WIN32) || defined (i386_) || defined (x86_64_)
+	#if defined (_WIN_32_VER) || defined (_WIN_64_VER) || defined (WIN32) || defined (i386_) || defined (x86_64_) || defined (__i386__) || defined (__x86_64__)
 		_mm_pause();
 	#endif
 #endif
@@ -956,6 +1008,86 @@ class dgScopeSpinPause
 
 
 
+// instruction set extensions reported by dgGetCpuFeatures
+#define DG_CPU_FEATURE_SSE2			(1<<0)
+#define DG_CPU_FEATURE_SSE3			(1<<1)
+#define DG_CPU_FEATURE_SSE4_2		(1<<2)
+#define DG_CPU_FEATURE_FMA			(1<<3)
+#define DG_CPU_FEATURE_AVX			(1<<4)
+#define DG_CPU_FEATURE_AVX2			(1<<5)
+#define DG_CPU_FEATURE_AVX512F		(1<<6)
+
+DG_INLINE void dgCpuId(dgInt32* const info, dgInt32 function, dgInt32 subFunction = 0)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		__cpuidex(info, function, subFunction);
+	#elif defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__))
+		__cpuid_count(function, subFunction, info[0], info[1], info[2], info[3]);
+	#else
+		info[0] = 0;
+		info[1] = 0;
+		info[2] = 0;
+		info[3] = 0;
+	#endif
+}
+
+DG_INLINE dgUnsigned64 dgGetExtendedControlRegister(dgUnsigned32 index)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		return _xgetbv(index);
+	#elif defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__))
+		// xgetbv opcode, so that it does not require compiling with -mxsave
+		dgUnsigned32 eax;
+		dgUnsigned32 edx;
+		__asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (eax), "=d" (edx) : "c" (index));
+		return (dgUnsigned64 (edx) << 32) | eax;
+	#else
+		return 0;
+	#endif
+}
+
+DG_INLINE dgUnsigned32 dgGetCpuFeatures()
+{
+	dgInt32 info[4];
+	dgUnsigned32 features = 0;
+
+	dgCpuId(info, 0);
+	const dgInt32 maxFunction = info[0];
+	if (maxFunction >= 1) {
+		dgCpuId(info, 1);
+		features |= (info[3] & (1 << 26)) ? DG_CPU_FEATURE_SSE2 : 0;
+		features |= (info[2] & (1 << 0)) ? DG_CPU_FEATURE_SSE3 : 0;
+		features |= (info[2] & (1 << 20)) ? DG_CPU_FEATURE_SSE4_2 : 0;
+
+		// avx registers are only usable if the os saves the ymm (and zmm) state on context switches
+		const dgUnsigned64 xcr0 = (info[2] & (1 << 27)) ? dgGetExtendedControlRegister(0) : 0;
+		const bool ymmState = (xcr0 & 0x06) == 0x06;
+		const bool zmmState = (xcr0 & 0xe6) == 0xe6;
+		features |= (ymmState && (info[2] & (1 << 28))) ? DG_CPU_FEATURE_AVX : 0;
+		features |= (ymmState && (info[2] & (1 << 12))) ? DG_CPU_FEATURE_FMA : 0;
+
+		if (maxFunction >= 7) {
+			dgCpuId(info, 7);
+			features |= (ymmState && (info[1] & (1 << 5))) ? DG_CPU_FEATURE_AVX2 : 0;
+			features |= (zmmState && (info[1] & (1 << 16))) ? DG_CPU_FEATURE_AVX512F : 0;
+		}
+	}
+	return features;
+}
+
+// returns true if the cpu vendor string is GenuineIntel
+DG_INLINE bool dgIsIntelCpu()
+{
+	dgInt32 info[4];
+	char vendor[16];
+	dgCpuId(info, 0);
+	memcpy(&vendor[0], &info[1], sizeof (dgInt32));
+	memcpy(&vendor[4], &info[3], sizeof (dgInt32));
+	memcpy(&vendor[8], &info[2], sizeof (dgInt32));
+	vendor[12] = 0;
+	return !strcmp(vendor, "GenuineIntel");
+}
+
 #ifdef _MACOSX_VER
 #include <sys/time.h>
 #define CLOCK_REALTIME 0
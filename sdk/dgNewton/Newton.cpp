@@ -104,6 +104,61 @@ int NewtonGetMemoryUsed()
 	return dgMemoryAllocator::GetGlobalMemoryUsed();
 }
 
+/*!
+  Return the number of times a thread had to wait for the engine global memory lock.
+
+  @return accumulated lock contention count since the library was loaded.
+
+  Small allocations are served from per thread caches, and the global lock is only taken
+  to refill or drain those caches and for large allocations. Applications can sample this
+  counter before and after a simulation step to measure allocator contention.
+
+  See also: ::NewtonGetMemoryUsed
+*/
+int NewtonGetMemoryLockContention()
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	return dgMemoryAllocator::GetLockContention();
+}
+
+/*!
+  Start recording the engine profiler time records.
+
+  @param traceFileName name of the file the trace is saved to when ::NewtonProfilerStop is called.
+
+  @return 1 if the engine was built with the profiler (cmake option BUILD_PROFILER), 0 otherwise.
+
+  Every engine thread records its timed scopes in its own ring buffer, so that only the most 
+  recent records are kept if the recording runs for a long time. The trace is saved in chrome 
+  trace event json format, which can be opened with chrome://tracing or ui.perfetto.dev.
+  This function must not be called while a world is being updated.
+
+  See also: ::NewtonProfilerStop
+*/
+int NewtonProfilerStart(const char* const traceFileName)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+#ifdef _DG_USE_PROFILER
+	DG_START_RECORDING(traceFileName);
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+/*!
+  Stop the recording started with ::NewtonProfilerStart and save the trace file.
+
+  This function must not be called while a world is being updated.
+
+  See also: ::NewtonProfilerStart
+*/
+void NewtonProfilerStop()
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	DG_STOP_RECORDING();
+}
+
 // fixme: needs docu
 // @param mallocFnt is a pointer to the memory allocator callback function. If this parameter is NULL the standard *malloc* function is used.
 // @param mfreeFnt is a pointer to the memory release callback function. If this parameter is NULL the standard *free* function is used.
@@ -579,6 +634,85 @@ int NewtonGetParallelSolverOnLargeIsland(const NewtonWorld* const newtonWorld)
 	return world->GetParallelSolverOnLargeIsland();
 }
 
+/*!
+  Enable/disable the closed form contact kernels (enabled by default).
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param mode 1: enabled (default)  0: disabled
+
+  @return Nothing
+
+  Pairs of unscaled or uniformly scaled spheres, capsules and boxes are collided
+  with dedicated separating axis and clipping kernels instead of the general convex
+  solver. Non uniformly scaled shapes and pairs with a convex hull or any other convex
+  shape always use the general solver. The batched kernels only take unscaled shapes.
+  Disabling them sends every convex pair through the general solver, which is
+  useful to compare the two paths.
+
+  See also: ::NewtonGetAnalyticContacts
+*/
+void NewtonSetAnalyticContacts(const NewtonWorld* const newtonWorld, int mode)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->EnableAnalyticContacts (mode);
+}
+
+/*!
+  Return 1 when the closed form contact kernels are enabled.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  See also: ::NewtonSetAnalyticContacts
+*/
+int NewtonGetAnalyticContacts(const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetAnalyticContacts();
+}
+
+/*!
+  Enable or disable the batched contact kernels.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param mode 1: enabled  0: disabled (default)
+
+  @return Nothing
+
+  When the closed form contact kernels are enabled, the broadphase collects the
+  sphere, capsule and box pairs of the same kind and collides them four at the
+  time with vector instructions. Disabling it collides each pair on its own
+  with the same kernels.
+
+  Batching is off by default. It did not measurably speed up the narrow phase,
+  a few box pairs with nearly equal separating axes get a different manifold
+  than the scalar kernel, and the deferred pairs change the order of the
+  active contact joints.
+
+  See also: ::NewtonGetBatchedContacts, ::NewtonSetAnalyticContacts
+*/
+void NewtonSetBatchedContacts(const NewtonWorld* const newtonWorld, int mode)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->EnableBatchedContacts (mode);
+}
+
+/*!
+  Return 1 when the batched contact kernels are enabled.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  See also: ::NewtonSetBatchedContacts
+*/
+int NewtonGetBatchedContacts(const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetBatchedContacts();
+}
+
 /*!
   Set the solver precision mode.
 
@@ -661,6 +795,106 @@ dFloat NewtonGetLastUpdateTime (const NewtonWorld* const newtonWorld)
 	return world->GetUpdateTime();
 }
 
+/*!
+  Get the per phase timing and counters of the last world update.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *stats pointer to the structure that receives the statistics.
+
+  @return Nothing.
+
+  The times are in seconds and are added over all sub steps of the update. Body, contact and
+  island counts are the ones of the last sub step. m_threadBusyTime has one entry per
+  thread in m_threadCount, each being the time the thread spent inside job callbacks, the
+  remainder of the step time is time the thread was idle, stealing or waiting on a barrier.
+  The last entry is the thread that called the update, which runs jobs too.
+
+  m_simplexCacheQueries counts the convex pairs that ran the closest point solver and
+  m_simplexCacheHits the ones that the simplex saved by the previous update of the same
+  pair resolved with a single support query. Both are added over all sub steps.
+
+  The statistics are always collected, the cost is a few timer reads per step.
+
+  See also: ::NewtonGetLastUpdateTime
+*/
+void NewtonWorldGetStepStats (const NewtonWorld* const newtonWorld, NewtonWorldStepStats* const stats)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	const dgWorldStepStats& info = world->GetStepStats();
+
+	dgAssert (NEWTON_MAX_THREADS_COUNT == DG_MAX_THREADS_HIVE_COUNT);
+	const dFloat scale = dFloat (1.0e-6f);
+	stats->m_stepTime = dFloat (info.m_stepTime) * scale;
+	stats->m_broadPhaseTime = dFloat (info.m_broadPhaseTime) * scale;
+	stats->m_narrowPhaseTime = dFloat (info.m_narrowPhaseTime) * scale;
+	stats->m_clusterBuildTime = dFloat (info.m_clusterTime) * scale;
+	stats->m_solverTime = dFloat (info.m_solverTime) * scale;
+	stats->m_transformUpdateTime = dFloat (info.m_transformTime) * scale;
+	for (dgInt32 i = 0; i < NEWTON_MAX_THREADS_COUNT; i ++) {
+		stats->m_threadBusyTime[i] = dFloat (info.m_threadBusyTime[i]) * scale;
+	}
+	stats->m_bodyCount = info.m_bodyCount;
+	stats->m_contactCount = info.m_contactCount;
+	stats->m_islandCount = info.m_clusterCount;
+	stats->m_threadCount = info.m_threadCount;
+	stats->m_simplexCacheQueries = info.m_simplexCacheQueries;
+	stats->m_simplexCacheHits = info.m_simplexCacheHits;
+}
+
+/*!
+  Return the largest amount of per step scratch memory used so far.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return size in bytes, added over all thread arenas.
+
+  Transient solver and collision buffers are taken from a frame arena that is reset at
+  the start of every sub step. When an arena runs out of memory the engine falls back to the
+  heap for the rest of the step and grows the arena to its high-water mark on the next reset.
+
+  See also: ::NewtonReserveFrameMemory, ::NewtonGetFrameMemoryHeapAllocations
+*/
+int NewtonGetFrameMemoryHighWaterMark (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetFrameArena().GetHighWaterMark();
+}
+
+/*!
+  Pre size the frame arena used by the serial phases of the step.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param sizeInBytes arena size in bytes, usually a value returned by ::NewtonGetFrameMemoryHighWaterMark.
+
+  This function must not be called while the world is updating.
+
+  See also: ::NewtonGetFrameMemoryHighWaterMark
+*/
+void NewtonReserveFrameMemory (const NewtonWorld* const newtonWorld, int sizeInBytes)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->GetFrameArena().Reserve(sizeInBytes);
+}
+
+/*!
+  Return the number of heap allocations made by the frame arenas since the world was created.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return heap allocation count, this number stops changing once the arenas reach a steady state.
+
+  See also: ::NewtonGetFrameMemoryHighWaterMark
+*/
+int NewtonGetFrameMemoryHeapAllocations (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetFrameArena().GetHeapAllocationsCount();
+}
+
 
 void NewtonSetNumberOfSubsteps (const NewtonWorld* const newtonWorld, int subSteps)
 {
@@ -1204,6 +1438,56 @@ int NewtonWorldCollide (const NewtonWorld* const newtonWorld, const dFloat* cons
 	return world->GetBroadPhase()->Collide((dgCollisionInstance*)shape, dgMatrix(matrix), (OnRayPrecastAction)prefilter, userData, (dgConvexCastReturnInfo*)info, maxContactsCount, threadIndex);
 }
 
+/*!
+  cast a batch of rays and get the closest hit of each one.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *p0 pointer to the first ray origin, each origin is at least three floats.
+  @param *p1 pointer to the first ray destination, each destination is at least three floats.
+  @param strideInBytes distance in bytes between consecutive origins and consecutive destinations.
+  @param rayCount number of rays in the batch.
+  @param *userData user data to be passed to the prefilter callback.
+  @param prefilter user define function to be called for each body before intersection, can be NULL.
+  @param *hits array of at least rayCount entries, entry i receives the closest hit of ray i.
+
+  the rays are traversed four at a time and the batch is spread over the worker threads,
+  so rays that are close to each other should also be next to each other in the arrays.
+  the prefilter may be called from several threads at once.
+  this function uses the worker threads and can not be called from inside an update callback.
+
+  See also: ::NewtonWorldRayCast, ::NewtonWorldConvexCastBatch
+*/
+void NewtonWorldRayCastBatch(const NewtonWorld* const newtonWorld, const dFloat* const p0, const dFloat* const p1, int strideInBytes, int rayCount, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldCastBatchHit* const hits)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->GetBroadPhase()->RayCastBatch(p0, p1, strideInBytes, rayCount, (OnRayPrecastAction)prefilter, userData, (dgCastBatchHit*)hits);
+}
+
+/*!
+  cast a shape along a batch of segments and get the first contact of each cast.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *matrices array of castCount matrices of sixteen floats with the start orientation and position of each cast.
+  @param *targets pointer to the first cast destination, each destination is at least three floats.
+  @param strideInBytes distance in bytes between consecutive destinations.
+  @param castCount number of casts in the batch.
+  @param shape collision shape swept by all the casts.
+  @param *userData user data to be passed to the prefilter callback.
+  @param prefilter user define function to be called for each body before intersection, can be NULL.
+  @param *hits array of at least castCount entries, entry i receives the first contact of cast i.
+
+  the same rules as ::NewtonWorldRayCastBatch apply.
+
+  See also: ::NewtonWorldConvexCast, ::NewtonWorldRayCastBatch
+*/
+void NewtonWorldConvexCastBatch(const NewtonWorld* const newtonWorld, const dFloat* const matrices, const dFloat* const targets, int strideInBytes, int castCount, const NewtonCollision* const shape, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldCastBatchHit* const hits)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->GetBroadPhase()->ConvexCastBatch((dgCollisionInstance*)shape, matrices, targets, strideInBytes, castCount, (OnRayPrecastAction)prefilter, userData, (dgCastBatchHit*)hits);
+}
+
 
 /*!
   Retrieve body by index from island.
@@ -3249,6 +3533,31 @@ void NewtonHeightFieldSetHorizontalDisplacement (const NewtonCollision* const he
 	}
 }
 
+/*!
+  Replace a rectangle of the elevation map of a height field.
+
+  @param *heightField pointer to the height field collision.
+  @param x0 first column of the rectangle.
+  @param z0 first row of the rectangle.
+  @param width number of columns of the rectangle.
+  @param height number of rows of the rectangle.
+  @param *elevationMap width x height elevations, one row after another, of the same data type the height field was created with.
+
+  only the part of the elevation bounds covering the rectangle is updated, so the cost is proportional to the rectangle size.
+  the broad phase box of the body that owns the height field is not changed until the body matrix is set again.
+
+  See also: ::NewtonCreateHeightFieldCollision
+*/
+void NewtonHeightFieldSetElevation (const NewtonCollision* const heightField, int x0, int z0, int width, int height, const void* const elevationMap)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)heightField;
+	if (collision->IsType(dgCollision::dgCollisionHeightField_RTTI)) {
+		dgCollisionHeightField* const shape = (dgCollisionHeightField*)collision->GetChildShape();
+		shape->SetElevation (x0, z0, width, height, elevationMap);
+	}
+}
+
 /*!
   Prepare a *TreeCollision* to begin to accept the polygons that comprise the collision mesh.
 
@@ -3465,6 +3774,148 @@ int NewtonTreeCollisionGetVertexListTriangleListInAABB(const NewtonCollision* co
 	return (NewtonCollision*) collision;
 }
 
+/*!
+  Create an empty tiled height field collision geometry.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param tileSize number of cells along each side of a tile, every tile holds (tileSize + 1) x (tileSize + 1) elevation samples.
+  @param gridsDiagonals cell diagonal construction mode, same values as ::NewtonCreateHeightFieldCollision.
+  @param elevationdatType 0 for 32 bit float elevations, 1 for unsigned 16 bit elevations.
+  @param verticalScale scale applied to the elevation samples.
+  @param horizontalScale_x cell size in the x direction.
+  @param horizontalScale_z cell size in the z direction.
+  @param shapeID user id of the shape.
+
+  @return Pointer to the collision.
+
+  tile (x, z) covers the cells that start at (x * tileSize, z * tileSize), and shares its last row and column of samples
+  with its neighbors. tiles can be added, replaced, removed and edited from any thread, the changes are applied by
+  ::NewtonTiledHeightFieldCommitChanges. the alternating diagonal modes only line up across tiles when tileSize is even.
+
+  See also: ::NewtonTiledHeightFieldAddTile, ::NewtonTiledHeightFieldCommitChanges
+*/
+NewtonCollision* NewtonCreateTiledHeightFieldCollision (const NewtonWorld* const newtonWorld, int tileSize, int gridsDiagonals, int elevationdatType, dFloat verticalScale, dFloat horizontalScale_x, dFloat horizontalScale_z, int shapeID)
+{
+	Newton* const world = (Newton *)newtonWorld;
+
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = world->CreateTiledHeightField(tileSize, gridsDiagonals, elevationdatType, verticalScale, horizontalScale_x, horizontalScale_z);
+	collision->SetUserDataID(dgUnsigned32 (shapeID));
+	return (NewtonCollision*) collision;
+}
+
+/*!
+  Queue a tile for a tiled height field, replacing the tile at the same coordinates if there is one.
+
+  @param *tiledHeightField pointer to the tiled height field collision.
+  @param tileX tile column, it can be negative.
+  @param tileZ tile row, it can be negative.
+  @param *elevationMap (tileSize + 1) x (tileSize + 1) elevations, one row after another, of the data type the shape was created with.
+  @param *attributeMap (tileSize + 1) x (tileSize + 1) face attributes, or NULL for all zeros.
+
+  the tile is built by the calling thread, so this can be called from a streaming thread while the world is updating.
+  the tile becomes part of the shape on the next ::NewtonTiledHeightFieldCommitChanges.
+
+  See also: ::NewtonCreateTiledHeightFieldCollision
+*/
+void NewtonTiledHeightFieldAddTile (const NewtonCollision* const tiledHeightField, int tileX, int tileZ, const void* const elevationMap, const char* const attributeMap)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)tiledHeightField;
+	if (collision->IsType(dgCollision::dgCollisionTiledHeightField_RTTI)) {
+		dgCollisionTiledHeightField* const shape = (dgCollisionTiledHeightField*)collision->GetChildShape();
+		shape->AddTile (tileX, tileZ, elevationMap, (const dgInt8*) attributeMap);
+	}
+}
+
+/*!
+  Queue the removal of a tile of a tiled height field.
+
+  @param *tiledHeightField pointer to the tiled height field collision.
+  @param tileX tile column.
+  @param tileZ tile row.
+
+  the tile is removed on the next ::NewtonTiledHeightFieldCommitChanges, removing a tile that does not exist does nothing.
+
+  See also: ::NewtonTiledHeightFieldAddTile
+*/
+void NewtonTiledHeightFieldRemoveTile (const NewtonCollision* const tiledHeightField, int tileX, int tileZ)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)tiledHeightField;
+	if (collision->IsType(dgCollision::dgCollisionTiledHeightField_RTTI)) {
+		dgCollisionTiledHeightField* const shape = (dgCollisionTiledHeightField*)collision->GetChildShape();
+		shape->RemoveTile (tileX, tileZ);
+	}
+}
+
+/*!
+  Queue a change to a rectangle of elevation samples of a tiled height field.
+
+  @param *tiledHeightField pointer to the tiled height field collision.
+  @param x0 first sample column of the rectangle, in samples of the whole terrain.
+  @param z0 first sample row of the rectangle, in samples of the whole terrain.
+  @param width number of columns of the rectangle.
+  @param height number of rows of the rectangle.
+  @param *elevationMap width x height elevations, one row after another, of the data type the shape was created with.
+
+  the data is copied, so the buffer can be reused as soon as the call returns. the rectangle can span several tiles,
+  samples on tiles that are not resident at commit time are ignored.
+
+  See also: ::NewtonTiledHeightFieldCommitChanges
+*/
+void NewtonTiledHeightFieldSetElevation (const NewtonCollision* const tiledHeightField, int x0, int z0, int width, int height, const void* const elevationMap)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)tiledHeightField;
+	if (collision->IsType(dgCollision::dgCollisionTiledHeightField_RTTI)) {
+		dgCollisionTiledHeightField* const shape = (dgCollisionTiledHeightField*)collision->GetChildShape();
+		shape->SetElevation (x0, z0, width, height, elevationMap);
+	}
+}
+
+/*!
+  Apply the queued tile and elevation changes of a tiled height field.
+
+  @param *tiledHeightField pointer to the tiled height field collision.
+
+  @return the number of changes applied.
+
+  must be called from the thread that updates the world, and not while the update is running.
+  the broad phase box of the bodies using the shape is refreshed, and the bodies over the changed regions
+  are woken up with their contacts on the terrain regenerated.
+
+  See also: ::NewtonTiledHeightFieldAddTile, ::NewtonTiledHeightFieldSetElevation
+*/
+int NewtonTiledHeightFieldCommitChanges (const NewtonCollision* const tiledHeightField)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)tiledHeightField;
+	if (collision->IsType(dgCollision::dgCollisionTiledHeightField_RTTI)) {
+		dgCollisionTiledHeightField* const shape = (dgCollisionTiledHeightField*)collision->GetChildShape();
+		return shape->CommitChanges ();
+	}
+	return 0;
+}
+
+/*!
+  Return the number of resident tiles of a tiled height field.
+
+  @param *tiledHeightField pointer to the tiled height field collision.
+
+  @return the number of tiles, changes waiting for a commit are not counted.
+*/
+int NewtonTiledHeightFieldGetTileCount (const NewtonCollision* const tiledHeightField)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)tiledHeightField;
+	if (collision->IsType(dgCollision::dgCollisionTiledHeightField_RTTI)) {
+		dgCollisionTiledHeightField* const shape = (dgCollisionTiledHeightField*)collision->GetChildShape();
+		return shape->GetTileCount ();
+	}
+	return 0;
+}
+
 
 
 /*!
@@ -5416,7 +5867,7 @@ void* NewtonContactJointGetFirstContact(const NewtonJoint* const contactJoint)
 	TRACE_FUNCTION(__FUNCTION__);
 	dgContact* const joint = (dgContact *)contactJoint;
 	if ((joint->GetId() == dgConstraint::m_contactConstraint) && joint->GetCount() && joint->GetMaxDOF()){
-		return joint->GetFirst();
+		return joint->GetFirstContact();
 	} else {
 		return NULL;
 	}
@@ -5438,8 +5889,7 @@ void* NewtonContactJointGetNextContact(const NewtonJoint* const contactJoint, vo
 	dgContact* const joint = (dgContact *)contactJoint;
 
 	if ((joint->GetId() == dgConstraint::m_contactConstraint) && joint->GetCount()){
-		dgList<dgContactMaterial>::dgListNode* const node = (dgList<dgContactMaterial>::dgListNode*) contact;
-		return node->GetNext();
+		return joint->GetNextContact((dgContactMaterial*) contact);
 	} else {
 		return NULL;
 	}
@@ -5462,15 +5912,13 @@ void NewtonContactJointRemoveContact(const NewtonJoint* const contactJoint, void
 	dgContact* const joint = (dgContact *)contactJoint;
 
 	if ((joint->GetId() == dgConstraint::m_contactConstraint) && joint->GetCount()){
-		dgList<dgContactMaterial>::dgListNode* const node = (dgList<dgContactMaterial>::dgListNode*) contact;
-
 		dgAssert (joint->GetBody0());
 		dgAssert (joint->GetBody1());
 		//dgBody* const body = joint->GetBody0() ? joint->GetBody0() : joint->GetBody1();
 		//dgWorld* const world = body->GetWorld();
 		dgWorld* const world = joint->GetBody0()->GetWorld();
 		world->GlobalLock();
-		joint->Remove(node);
+		joint->RemoveContact((dgContactMaterial*) contact);
 		joint->GetBody0()->SetSleepState(false);
 		joint->GetBody1()->SetSleepState(false);
 		world->GlobalUnlock();
@@ -5504,17 +5952,15 @@ NewtonMaterial* NewtonContactGetMaterial(const void* const contact)
 {
 	TRACE_FUNCTION(__FUNCTION__);
 
-	dgList<dgContactMaterial>::dgListNode* const node = (dgList<dgContactMaterial>::dgListNode*) contact;
-	dgContactMaterial& contactMaterial = node->GetInfo();
-	return (NewtonMaterial*) &contactMaterial;
+	dgContactMaterial* const contactMaterial = (dgContactMaterial*) contact;
+	return (NewtonMaterial*) contactMaterial;
 }
 
 NewtonCollision* NewtonContactGetCollision0(const void* const contact)
 {
 	TRACE_FUNCTION(__FUNCTION__);
 
-	dgList<dgContactMaterial>::dgListNode* const node = (dgList<dgContactMaterial>::dgListNode*) contact;
-	dgContactMaterial& contactMaterial = node->GetInfo();
+	const dgContactMaterial& contactMaterial = *((dgContactMaterial*) contact);
 	return (NewtonCollision*) contactMaterial.m_collision0;
 }
 
@@ -5522,8 +5968,7 @@ NewtonCollision* NewtonContactGetCollision1(const void* const contact)
 {
 	TRACE_FUNCTION(__FUNCTION__);
 
-	dgList<dgContactMaterial>::dgListNode* const node = (dgList<dgContactMaterial>::dgListNode*) contact;
-	dgContactMaterial& contactMaterial = node->GetInfo();
+	const dgContactMaterial& contactMaterial = *((dgContactMaterial*) contact);
 	return (NewtonCollision*) contactMaterial.m_collision1;
 }
 
@@ -5531,8 +5976,7 @@ void* NewtonContactGetCollisionID0(const void* const contact)
 {
 	TRACE_FUNCTION(__FUNCTION__);
 
-	dgList<dgContactMaterial>::dgListNode* const node = (dgList<dgContactMaterial>::dgListNode*) contact;
-	dgContactMaterial& contactMaterial = node->GetInfo();
+	const dgContactMaterial& contactMaterial = *((dgContactMaterial*) contact);
 	return (void*) contactMaterial.m_shapeId0;
 }
 
@@ -5540,8 +5984,7 @@ void* NewtonContactGetCollisionID1(const void* const contact)
 {
 	TRACE_FUNCTION(__FUNCTION__);
 
-	dgList<dgContactMaterial>::dgListNode* const node = (dgList<dgContactMaterial>::dgListNode*) contact;
-	dgContactMaterial& contactMaterial = node->GetInfo();
+	const dgContactMaterial& contactMaterial = *((dgContactMaterial*) contact);
 	return (NewtonCollision*) contactMaterial.m_shapeId1;
 }
 
@@ -72,6 +72,10 @@ extern "C" {
 	
 	#define NEWTON_BROADPHASE_DEFAULT						0
 	#define NEWTON_BROADPHASE_PERSINTENT					1
+	#define NEWTON_BROADPHASE_BVH4							2
+	#define NEWTON_BROADPHASE_HASH_GRID						3
+
+	#define NEWTON_MAX_THREADS_COUNT						16
 
 	#define NEWTON_DYNAMIC_BODY								0
 	#define NEWTON_KINEMATIC_BODY							1
@@ -94,6 +98,7 @@ extern "C" {
 	#define SERIALIZE_ID_USERMESH							13
 	#define SERIALIZE_ID_SCENE								14
 	#define SERIALIZE_ID_FRACTURED_COMPOUND					15
+	#define SERIALIZE_ID_TILED_HEIGHTFIELD					16
 
 #ifdef __cplusplus
 	class NewtonMesh;
@@ -209,6 +214,17 @@ extern "C" {
 		char* m_atributes;
 	} NewtonHeightFieldCollisionParam;
 
+	typedef struct NewtonTiledHeightFieldCollisionParam
+	{
+		int m_tileSize;
+		int m_tileCount;
+		int m_gridsDiagonals;
+		int m_elevationDataType;	// 0 = 32 bit floats, 1 = unsigned 16 bit integers
+		dFloat m_verticalScale;
+		dFloat m_horizonalScale_x;
+		dFloat m_horizonalScale_z;
+	} NewtonTiledHeightFieldCollisionParam;
+
 	typedef struct NewtonSceneCollisionParam
 	{
 		int m_childrenProxyCount;
@@ -231,6 +247,7 @@ extern "C" {
 			NewtonCompoundCollisionParam m_compoundCollision;
 			NewtonCollisionTreeParam m_collisionTree;
 			NewtonHeightFieldCollisionParam m_heightField;
+			NewtonTiledHeightFieldCollisionParam m_tiledHeightField;
 			NewtonSceneCollisionParam m_sceneCollision;
 			dFloat m_paramArray[64];		    // user define collision can use this to store information
 		};
@@ -288,7 +305,33 @@ extern "C" {
 		const NewtonBody* m_hitBody;			// body hit at contact point
 		dFloat m_penetration;                   // contact penetration at collision point
 	} NewtonWorldConvexCastReturnInfo;
+
+	typedef struct NewtonWorldCastBatchHit
+	{
+		dFloat m_point[4];						// closest hit point in global space
+		dFloat m_normal[4];						// surface normal at the hit point in global space
+		dLong m_contactID;						// collision ID at the hit point
+		const NewtonBody* m_hitBody;			// body hit, NULL when the query hit nothing
+		dFloat m_param;							// fraction of the segment at the hit, one when the query hit nothing
+	} NewtonWorldCastBatchHit;
 	
+	typedef struct NewtonWorldStepStats
+	{
+		dFloat m_stepTime;						// wall time of the whole update in seconds
+		dFloat m_broadPhaseTime;				// force and torque callbacks, sleep states and pair finding
+		dFloat m_narrowPhaseTime;				// contact generation for the colliding pairs
+		dFloat m_clusterBuildTime;				// island building
+		dFloat m_solverTime;					// joint and contact solver and velocity integration
+		dFloat m_transformUpdateTime;			// matrix integration and transform callbacks
+		dFloat m_threadBusyTime[NEWTON_MAX_THREADS_COUNT];	// time each thread spent running jobs
+		int m_bodyCount;
+		int m_contactCount;
+		int m_islandCount;
+		int m_threadCount;
+		int m_simplexCacheQueries;				// convex pairs that ran the closest point solver with a simplex cache
+		int m_simplexCacheHits;					// pairs resolved by the cached simplex in the first iteration
+	} NewtonWorldStepStats;
+
 	typedef struct NewtonUserMeshCollisionRayHitDesc
 	{
 		dFloat m_p0[4];							// ray origin in collision local space
@@ -438,6 +481,9 @@ extern "C" {
 	NEWTON_API int NewtonWorldFloatSize ();
 
 	NEWTON_API int NewtonGetMemoryUsed ();
+	NEWTON_API int NewtonGetMemoryLockContention ();
+	NEWTON_API int NewtonProfilerStart (const char* const traceFileName);
+	NEWTON_API void NewtonProfilerStop ();
 	NEWTON_API void NewtonSetMemorySystem (NewtonAllocMemory malloc, NewtonFreeMemory free);
 
 	NEWTON_API NewtonWorld* NewtonCreate ();
@@ -469,6 +515,11 @@ extern "C" {
 	NEWTON_API void NewtonSetParallelSolverOnLargeIsland (const NewtonWorld* const newtonWorld, int mode);
 	NEWTON_API int NewtonGetParallelSolverOnLargeIsland (const NewtonWorld* const newtonWorld);
 
+	NEWTON_API void NewtonSetAnalyticContacts (const NewtonWorld* const newtonWorld, int mode);
+	NEWTON_API int NewtonGetAnalyticContacts (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonSetBatchedContacts (const NewtonWorld* const newtonWorld, int mode);
+	NEWTON_API int NewtonGetBatchedContacts (const NewtonWorld* const newtonWorld);
+
 	NEWTON_API int NewtonGetBroadphaseAlgorithm (const NewtonWorld* const newtonWorld);
 	NEWTON_API void NewtonSelectBroadphaseAlgorithm (const NewtonWorld* const newtonWorld, int algorithmType);
 	NEWTON_API void NewtonResetBroadphase(const NewtonWorld* const newtonWorld);
@@ -480,6 +531,11 @@ extern "C" {
 	NEWTON_API int NewtonGetNumberOfSubsteps (const NewtonWorld* const newtonWorld);
 	NEWTON_API void NewtonSetNumberOfSubsteps (const NewtonWorld* const newtonWorld, int subSteps);
 	NEWTON_API dFloat NewtonGetLastUpdateTime (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonWorldGetStepStats (const NewtonWorld* const newtonWorld, NewtonWorldStepStats* const stats);
+
+	NEWTON_API int NewtonGetFrameMemoryHighWaterMark (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonReserveFrameMemory (const NewtonWorld* const newtonWorld, int sizeInBytes);
+	NEWTON_API int NewtonGetFrameMemoryHeapAllocations (const NewtonWorld* const newtonWorld);
 
 	NEWTON_API void NewtonSerializeToFile (const NewtonWorld* const newtonWorld, const char* const filename, NewtonOnBodySerializationCallback bodyCallback, void* const bodyUserData);
 	NEWTON_API void NewtonDeserializeFromFile (const NewtonWorld* const newtonWorld, const char* const filename, NewtonOnBodyDeserializationCallback bodyCallback, void* const bodyUserData);
@@ -536,6 +592,8 @@ extern "C" {
 	NEWTON_API void NewtonWorldRayCast (const NewtonWorld* const newtonWorld, const dFloat* const p0, const dFloat* const p1, NewtonWorldRayFilterCallback filter, void* const userData, NewtonWorldRayPrefilterCallback prefilter, int threadIndex);
 	NEWTON_API int NewtonWorldConvexCast (const NewtonWorld* const newtonWorld, const dFloat* const matrix, const dFloat* const target, const NewtonCollision* const shape, dFloat* const param, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
 	NEWTON_API int NewtonWorldCollide (const NewtonWorld* const newtonWorld, const dFloat* const matrix, const NewtonCollision* const shape, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
+	NEWTON_API void NewtonWorldRayCastBatch (const NewtonWorld* const newtonWorld, const dFloat* const p0, const dFloat* const p1, int strideInBytes, int rayCount, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldCastBatchHit* const hits);
+	NEWTON_API void NewtonWorldConvexCastBatch (const NewtonWorld* const newtonWorld, const dFloat* const matrices, const dFloat* const targets, int strideInBytes, int castCount, const NewtonCollision* const shape, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldCastBatchHit* const hits);
 	
 	// world utility functions
 	NEWTON_API int NewtonWorldGetBodyCount(const NewtonWorld* const newtonWorld);
@@ -757,6 +815,14 @@ extern "C" {
 	NEWTON_API NewtonCollision* NewtonCreateHeightFieldCollision (const NewtonWorld* const newtonWorld, int width, int height, int gridsDiagonals, int elevationdatType, const void* const elevationMap, const char* const attributeMap, dFloat verticalScale, dFloat horizontalScale_x, dFloat horizontalScale_z, int shapeID);
 	NEWTON_API void NewtonHeightFieldSetUserRayCastCallback (const NewtonCollision* const heightfieldCollision, NewtonHeightFieldRayCastCallback rayHitCallback);
 	NEWTON_API void NewtonHeightFieldSetHorizontalDisplacement (const NewtonCollision* const heightfieldCollision, const unsigned short* const horizontalMap, dFloat scale);
+	NEWTON_API void NewtonHeightFieldSetElevation (const NewtonCollision* const heightfieldCollision, int x0, int z0, int width, int height, const void* const elevationMap);
+
+	NEWTON_API NewtonCollision* NewtonCreateTiledHeightFieldCollision (const NewtonWorld* const newtonWorld, int tileSize, int gridsDiagonals, int elevationdatType, dFloat verticalScale, dFloat horizontalScale_x, dFloat horizontalScale_z, int shapeID);
+	NEWTON_API void NewtonTiledHeightFieldAddTile (const NewtonCollision* const tiledHeightfieldCollision, int tileX, int tileZ, const void* const elevationMap, const char* const attributeMap);
+	NEWTON_API void NewtonTiledHeightFieldRemoveTile (const NewtonCollision* const tiledHeightfieldCollision, int tileX, int tileZ);
+	NEWTON_API void NewtonTiledHeightFieldSetElevation (const NewtonCollision* const tiledHeightfieldCollision, int x0, int z0, int width, int height, const void* const elevationMap);
+	NEWTON_API int NewtonTiledHeightFieldCommitChanges (const NewtonCollision* const tiledHeightfieldCollision);
+	NEWTON_API int NewtonTiledHeightFieldGetTileCount (const NewtonCollision* const tiledHeightfieldCollision);
 
 	NEWTON_API NewtonCollision* NewtonCreateTreeCollision (const NewtonWorld* const newtonWorld, int shapeID);
 	NEWTON_API NewtonCollision* NewtonCreateTreeCollisionFromMesh (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, int shapeID);
@@ -22,19 +22,26 @@
 #ifndef _DG_NEWTON_PLUGIN_STDADX_
 #define _DG_NEWTON_PLUGIN_STDADX_
 
-// Exclude rarely-used stuff from Windows headers
-#define WIN32_LEAN_AND_MEAN             
-#include <windows.h>
+#ifdef _MSC_VER
+	// Exclude rarely-used stuff from Windows headers
+	#define WIN32_LEAN_AND_MEAN             
+	#include <windows.h>
+#endif
 
 #include <dg.h>
 #include <dgPhysics.h>
 
-#ifdef NEWTONCPU_EXPORTS
-	#define NEWTONCPU_API __declspec(dllexport)
+#ifdef _MSC_VER
+	#ifdef NEWTONCPU_EXPORTS
+		#define NEWTONCPU_API __declspec(dllexport)
+	#else
+		#define NEWTONCPU_API __declspec(dllimport)
+	#endif
+
+	#pragma warning (disable: 4100) //unreferenced formal parameter
 #else
-	#define NEWTONCPU_API __declspec(dllimport)
+	#include <immintrin.h>
+	#define NEWTONCPU_API __attribute__ ((visibility("default")))
 #endif
 
-#pragma warning (disable: 4100) //unreferenced formal parameter
-
 #endif
@@ -26,36 +26,14 @@
 // This is an example of an exported function.
 dgWorldPlugin* GetPlugin(dgWorld* const world, dgMemoryAllocator* const allocator)
 {
-	union cpuInfo
-	{
-		int m_data[4];
-		struct
-		{
-			int m_eax;
-			int m_ebx;
-			int m_ecx;
-			int m_edx;
-		};
-	} info;
-
-	// check for instruction set support (avx is bit 28 in reg ecx)
-	__cpuid(info.m_data, 1);
-	if (!(info.m_ecx & (1 << 28))) {
+	// check for instruction set support (avx, including os support for the ymm registers)
+	const dgUnsigned32 requiredFeatures = DG_CPU_FEATURE_AVX;
+	if ((dgGetCpuFeatures() & requiredFeatures) != requiredFeatures) {
 		return NULL;
 	}
-	
-	static dgWorldBase module(world, allocator);
-	union {
-		char m_vendor[256];
-		int m_reg[3];
-	};
-	memset(m_vendor, 0, sizeof(m_vendor));
-	__cpuid(info.m_data, 0);
 
-	m_reg[0] = info.m_ebx;
-	m_reg[1] = info.m_edx;
-	m_reg[2] = info.m_ecx;
-	module.m_score = _stricmp(m_vendor, "GenuineIntel") ? 2 : 3;
+	static dgWorldBase module(world, allocator);
+	module.m_score = dgIsIntelCpu() ? 3 : 2;
 	return &module;
 }
 
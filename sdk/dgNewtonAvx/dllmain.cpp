@@ -22,6 +22,7 @@
 #include "dgNewtonPluginStdafx.h"
 
 
+#ifdef _MSC_VER
 BOOL APIENTRY DllMain( HMODULE hModule,
                        DWORD  ul_reason_for_call,
                        LPVOID lpReserved
@@ -55,4 +56,4 @@ BOOL APIENTRY DllMain( HMODULE hModule,
 	}
 	return TRUE;
 }
-
+#endif
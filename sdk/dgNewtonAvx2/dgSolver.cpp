@@ -98,6 +98,7 @@ void dgSolver::InitWeights()
 
 void dgSolver::InitBodyArray()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(InitBodyArrayKernel, this, NULL, "dgSolver::InitBodyArray");
 	}
@@ -116,16 +117,15 @@ void dgSolver::InitBodyArray(dgInt32 threadID)
 	const dgBodyInfo* const bodyArray = m_bodyArray;
 	dgBodyProxy* const bodyProxyArray = m_bodyProxyArray;
 
-	const dgInt32 step = m_threadCounts;;
 	const dgInt32 bodyCount = m_cluster->m_bodyCount;
-	for (dgInt32 i = threadID; i < bodyCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		const dgBodyInfo* const bodyInfo = &bodyArray[i];
 		dgBody* const body = (dgDynamicBody*)bodyInfo->m_body;
 		body->AddDampingAcceleration(m_timestep);
 		body->CalcInvInertiaMatrix();
 
-		body->m_accel = body->m_veloc;
-		body->m_alpha = body->m_omega;
+		body->GetStateAccel() = body->GetStateVeloc();
+		body->m_alpha = body->GetStateOmega();
 
 		const dgFloat32 w = bodyProxyArray[i].m_weight ? bodyProxyArray[i].m_weight : dgFloat32(1.0f);
 		bodyProxyArray[i].m_weight = w;
@@ -147,9 +147,8 @@ void dgSolver::InitInternalForces(dgInt32 threadID)
 	const dgRightHandSide* const rightHandSide = &m_world->GetSolverMemory().m_righHandSizeBuffer[0];
 	const dgSoaFloat* const leftHandSide = (dgSoaFloat*) &m_world->GetSolverMemory().m_leftHandSizeBuffer[0].m_Jt.m_jacobianM0;
 
-	const dgInt32 step = m_threadCounts;;
 	const dgInt32 bodyCount = m_cluster->m_bodyCount;
-	for (dgInt32 i = threadID; i < bodyCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgSoaFloat forceAcc (m_soaZero);
 
 		const dgBodyProxy* const startJoints = &bodyProxyArray[i];
@@ -191,6 +190,7 @@ DG_INLINE void dgSolver::SortWorkGroup(dgInt32 base) const
 void dgSolver::InitJacobianMatrix()
 {
 	m_jacobianMatrixRowAtomicIndex = 0;
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(InitJacobianMatrixKernel, this, NULL, "dgSolver::InitJacobianMatrix");
 	}
@@ -205,6 +205,7 @@ void dgSolver::InitJacobianMatrix()
 		bodyProxyArray[index].m_jointStart = i;
 	}
 
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(InitInternalForcesKernel, this, NULL, "dgSolver::InitInternalForces");
 	}
@@ -240,6 +241,7 @@ void dgSolver::InitJacobianMatrix()
 	m_massMatrix.ResizeIfNecessary(size);
 
 	m_soaRowsCount = 0;
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(TransposeMassMatrixKernel, this, NULL, "dgSolver::TransposeMassMatrix");
 	}
@@ -298,9 +300,8 @@ void dgSolver::InitJacobianMatrix(dgInt32 threadID)
 	constraintParams.m_timestep = m_timestep;
 	constraintParams.m_invTimestep = m_invTimestep;
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_cluster->m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgJointInfo* const jointInfo = &m_jointArray[i];
 		dgConstraint* const constraint = jointInfo->m_joint;
 		dgAssert(jointInfo->m_m0 >= 0);
@@ -421,9 +422,8 @@ void dgSolver::TransposeMassMatrix(dgInt32 threadID)
 	const dgJointInfo* const jointInfoArray = m_jointArray;
 	dgSoaMatrixElement* const massMatrixArray = &m_massMatrix[0];
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		const dgInt32 index = i * DG_SOA_WORD_GROUP_SIZE;
 		const dgInt32 rowCount = jointInfoArray[index].m_pairCount;
 		const dgInt32 rowSoaStart = dgAtomicExchangeAndAdd(&m_soaRowsCount, rowCount);
@@ -559,12 +559,14 @@ void dgSolver::UpdateRowAccelerationKernel(void* const context, void* const, dgI
 
 void dgSolver::CalculateJointsAcceleration()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(CalculateJointsAccelerationKernel, this, NULL, "dgSolver::CalculateJointsAcceleration");
 	}
 	m_world->SynchronizationBarrier();
 	m_firstPassCoef = dgFloat32(1.0f);
 
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(UpdateRowAccelerationKernel, this, NULL, "dgSolver::UpdateRowAcceleration");
 	}
@@ -573,6 +575,7 @@ void dgSolver::CalculateJointsAcceleration()
 
 void dgSolver::CalculateBodiesAcceleration()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(CalculateBodiesAccelerationKernel, this, NULL, "dgSolver::CalculateBodiesAcceleration");
 	}
@@ -581,7 +584,9 @@ void dgSolver::CalculateBodiesAcceleration()
 
 void dgSolver::CalculateJointsForce()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
+		m_accelNorm[i] = dgFloat32(0.0f);
 		m_world->QueueJob(CalculateJointsForceKernel, this, NULL, "dgSolver::CalculateJointsForce");
 	}
 	m_world->SynchronizationBarrier();
@@ -589,6 +594,7 @@ void dgSolver::CalculateJointsForce()
 
 void dgSolver::CalculateBodyForce()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(CalculateBodyForceKernel, this, NULL, "dgSolver::CalculateBodyForce");
 	}
@@ -601,6 +607,7 @@ void dgSolver::CalculateBodyForce()
 
 void dgSolver::IntegrateBodiesVelocity()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(IntegrateBodiesVelocityKernel, this, NULL, "dgSolver::IntegrateBodiesVelocity");
 	}
@@ -610,7 +617,9 @@ void dgSolver::IntegrateBodiesVelocity()
 
 void dgSolver::UpdateForceFeedback()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
+		m_hasJointFeeback[i] = 0;
 		m_world->QueueJob(UpdateForceFeedbackKernel, this, NULL, "dgSolver::UpdateForceFeedback");
 	}
 	m_world->SynchronizationBarrier();
@@ -618,6 +627,7 @@ void dgSolver::UpdateForceFeedback()
 
 void dgSolver::UpdateKinematicFeedback()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(UpdateKinematicFeedbackKernel, this, NULL, "dgSolver::UpdateKinematicFeedback");
 	}
@@ -633,9 +643,8 @@ void dgSolver::CalculateJointsAcceleration(dgInt32 threadID)
 	dgRightHandSide* const rightHandSide = &m_world->GetSolverMemory().m_righHandSizeBuffer[0];
 	const dgLeftHandSide* const leftHandSide = &m_world->GetSolverMemory().m_leftHandSizeBuffer[0];
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_cluster->m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgJointInfo* const jointInfo = &m_jointArray[i];
 		dgConstraint* const constraint = jointInfo->m_joint;
 		const dgInt32 pairStart = jointInfo->m_pairStart;
@@ -832,9 +841,8 @@ void dgSolver::CalculateJointsForce(dgInt32 threadID)
 	dgSoaFloat* const internalForces = (dgSoaFloat*)&m_world->GetSolverMemory().m_internalForcesBuffer[0];
 	dgFloat32 accNorm = dgFloat32(0.0f);
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		const dgInt32 rowStart = soaRowStart[i];
 		dgJointInfo* const jointInfo = &m_jointArray[i * DG_SOA_WORD_GROUP_SIZE];
 
@@ -866,7 +874,7 @@ void dgSolver::CalculateJointsForce(dgInt32 threadID)
 			}
 		}
 	}
-	m_accelNorm[threadID] = accNorm;
+	m_accelNorm[threadID] += accNorm;
 }
 
 void dgSolver::UpdateRowAcceleration(dgInt32 threadID)
@@ -877,9 +885,8 @@ void dgSolver::UpdateRowAcceleration(dgInt32 threadID)
 	const dgInt32* const soaRowStart = m_soaRowStart;
 	const dgJointInfo* const jointInfoArray = m_jointArray;
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		const dgJointInfo* const jointInfoBase = &jointInfoArray[i * DG_SOA_WORD_GROUP_SIZE];
 
 		const dgInt32 rowStart = soaRowStart[i];
@@ -905,9 +912,8 @@ void dgSolver::CalculateBodyForce(dgInt32 threadID)
 	const dgRightHandSide* const rightHandSide = &m_world->GetSolverMemory().m_righHandSizeBuffer[0];
 	const dgSoaFloat* const leftHandSide = (dgSoaFloat*)&m_world->GetSolverMemory().m_leftHandSizeBuffer[0].m_Jt.m_jacobianM0;
 
-	const dgInt32 step = m_threadCounts;;
 	const dgInt32 bodyCount = m_cluster->m_bodyCount;
-	for (dgInt32 i = threadID; i < bodyCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgSoaFloat forceAcc (m_soaZero);
 
 		const dgBodyProxy* const startJoints = &bodyProxyArray[i];
@@ -940,9 +946,8 @@ void dgSolver::IntegrateBodiesVelocity(dgInt32 threadID)
 	const dgBodyProxy* const bodyProxyArray = m_bodyProxyArray;
 	dgJacobian* const internalForces = &m_world->GetSolverMemory().m_internalForcesBuffer[0];
 
-	const dgInt32 step = m_threadCounts;;
 	const dgInt32 bodyCount = m_cluster->m_bodyCount;
-	for (dgInt32 i = threadID; i < bodyCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgDynamicBody* const body = (dgDynamicBody*)m_bodyArray[i].m_body;
 		dgAssert(body->m_index == i);
 
@@ -956,8 +961,8 @@ void dgSolver::IntegrateBodiesVelocity(dgInt32 threadID)
 			const dgVector omegaStep((body->m_invWorldInertiaMatrix.RotateVector(torque)) * timestep4);
 
 			if (!body->m_resting) {
-				body->m_veloc += velocStep;
-				body->m_omega += omegaStep;
+				body->GetStateVeloc() += velocStep;
+				body->GetStateOmega() += omegaStep;
 			} else {
 				const dgVector velocStep2(velocStep.DotProduct(velocStep));
 				const dgVector omegaStep2(omegaStep.DotProduct(omegaStep));
@@ -965,8 +970,8 @@ void dgSolver::IntegrateBodiesVelocity(dgInt32 threadID)
 				const dgInt32 equilibrium = test.GetSignMask() ? 0 : 1;
 				body->m_resting &= equilibrium;
 			}
-			dgAssert(body->m_veloc.m_w == dgFloat32(0.0f));
-			dgAssert(body->m_omega.m_w == dgFloat32(0.0f));
+			dgAssert(body->GetStateVeloc().m_w == dgFloat32(0.0f));
+			dgAssert(body->GetStateOmega().m_w == dgFloat32(0.0f));
 		}
 	}
 }
@@ -976,9 +981,8 @@ void dgSolver::CalculateBodiesAcceleration(dgInt32 threadID)
 	dgVector invTime(m_invTimestep);
 	dgFloat32 maxAccNorm2 = DG_SOLVER_MAX_ERROR * DG_SOLVER_MAX_ERROR;
 
-	const dgInt32 step = m_threadCounts;;
 	const dgInt32 bodyCount = m_cluster->m_bodyCount;
-	for (dgInt32 i = threadID; i < bodyCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgDynamicBody* const body = (dgDynamicBody*)m_bodyArray[i].m_body;
 		m_world->CalculateNetAcceleration(body, invTime, maxAccNorm2);
 	}
@@ -989,9 +993,8 @@ void dgSolver::UpdateForceFeedback(dgInt32 threadID)
 	const dgRightHandSide* const rightHandSide = &m_world->GetSolverMemory().m_righHandSizeBuffer[0];
 	dgInt32 hasJointFeeback = 0;
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_cluster->m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgJointInfo* const jointInfo = &m_jointArray[i];
 		dgConstraint* const constraint = jointInfo->m_joint;
 		const dgInt32 first = jointInfo->m_pairStart;
@@ -1005,15 +1008,14 @@ void dgSolver::UpdateForceFeedback(dgInt32 threadID)
 		}
 		hasJointFeeback |= (constraint->GetUpdateFeedbackFunction() ? 1 : 0);
 	}
-	m_hasJointFeeback[threadID] = hasJointFeeback;
+	m_hasJointFeeback[threadID] |= hasJointFeeback;
 }
 
 
 void dgSolver::UpdateKinematicFeedback(dgInt32 threadID)
 {
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_cluster->m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgJointInfo* const jointInfo = &m_jointArray[i];
 		if (jointInfo->m_joint->GetUpdateFeedbackFunction()) {
 			jointInfo->m_joint->GetUpdateFeedbackFunction()(*jointInfo->m_joint, m_timestep, threadID);
@@ -1035,7 +1037,7 @@ void dgSolver::CalculateForces()
 			CalculateBodyForce();
 			accNorm = dgFloat32(0.0f);
 			for (dgInt32 i = 0; i < threadCounts; i++) {
-				accNorm = dgMax(accNorm, m_accelNorm[i]);
+				accNorm += m_accelNorm[i];
 			}
 		}
 		IntegrateBodiesVelocity();
@@ -1044,7 +1046,7 @@ void dgSolver::CalculateForces()
 	UpdateForceFeedback();
 
 	dgInt32 hasJointFeeback = 0;
-	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i++) {
+	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		hasJointFeeback |= m_hasJointFeeback[i];
 	}
 	CalculateBodiesAcceleration();
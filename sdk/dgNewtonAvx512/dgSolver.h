@@ -0,0 +1,355 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+* 
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* 
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _DG_SOLVER_H_
+#define _DG_SOLVER_H_
+
+
+#include "dgPhysicsStdafx.h"
+
+
+#define DG_SOA_WORD_GROUP_SIZE	16 
+
+
+// eight wide register, holds the linear and angular parts of one body jacobian
+DG_MSC_AVX_ALIGMENT
+class dgAvxFloat
+{
+	public:
+	DG_INLINE dgAvxFloat()
+	{
+	}
+
+	DG_INLINE dgAvxFloat(const float val)
+		:m_type(_mm256_set1_ps (val))
+	{
+	}
+
+	DG_INLINE dgAvxFloat(const __m256 type)
+		:m_type(type)
+	{
+	}
+
+	DG_INLINE dgAvxFloat(const dgAvxFloat& copy)
+		:m_type(copy.m_type)
+	{
+	}
+
+	DG_INLINE dgAvxFloat(const dgVector& low, const dgVector& high)
+		:m_type(_mm256_loadu2_m128(&high.m_x, &low.m_x))
+	{
+	}
+
+	DG_INLINE dgAvxFloat operator* (const dgAvxFloat& A) const
+	{
+		return _mm256_mul_ps(m_type, A.m_type);
+	}
+
+	DG_INLINE dgAvxFloat MulAdd(const dgAvxFloat& A, const dgAvxFloat& B) const
+	{
+		return _mm256_fmadd_ps(A.m_type, B.m_type, m_type);
+	}
+
+	DG_INLINE float AddHorizontal() const
+	{
+		__m128 tmp0(_mm_add_ps(_mm256_castps256_ps128(m_type), _mm256_extractf128_ps(m_type, 1)));
+		__m128 tmp1(_mm_hadd_ps(tmp0, tmp0));
+		return _mm_cvtss_f32(_mm_hadd_ps(tmp1, tmp1));
+	}
+
+	__m256 m_type;
+} DG_GCC_AVX_ALIGMENT;
+
+
+// one bit per lane, result of a compare
+class dgSoaMask
+{
+	public:
+	DG_INLINE dgSoaMask(const __mmask16 mask)
+		:m_mask(mask)
+	{
+	}
+
+	DG_INLINE dgSoaMask operator| (const dgSoaMask& A) const
+	{
+		return _mm512_kor(m_mask, A.m_mask);
+	}
+
+	__mmask16 m_mask;
+};
+
+DG_MSC_AVX512_ALIGMENT
+class dgSoaInt
+{
+	public:
+	DG_INLINE dgSoaInt()
+	{
+	}
+
+	DG_INLINE dgSoaInt(const int val)
+		:m_type(_mm512_set1_epi32 (val))
+	{
+	}
+
+	DG_INLINE dgSoaInt(const __m512i type)
+		:m_type(type)
+	{
+	}
+
+	DG_INLINE dgSoaInt operator+ (const dgSoaInt& A) const
+	{
+		return _mm512_add_epi32(m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaInt ShiftLeft (const int bits) const
+	{
+		return _mm512_sll_epi32(m_type, _mm_cvtsi32_si128(bits));
+	}
+
+	union
+	{
+		__m512i m_type;
+		int m_i[DG_SOA_WORD_GROUP_SIZE];
+	};
+} DG_GCC_AVX512_ALIGMENT;
+
+DG_MSC_AVX512_ALIGMENT
+class dgSoaFloat
+{
+	public:
+	DG_INLINE dgSoaFloat()
+	{
+	}
+
+	DG_INLINE dgSoaFloat(const float val)
+		:m_type(_mm512_set1_ps (val))
+	{
+	}
+
+	DG_INLINE dgSoaFloat(const __m512 type)
+		:m_type(type)
+	{
+	}
+
+	DG_INLINE dgSoaFloat(const dgSoaFloat& copy)
+		:m_type(copy.m_type)
+	{
+	}
+
+	DG_INLINE float& operator[] (dgInt32 i)
+	{
+		dgAssert(i < DG_SOA_WORD_GROUP_SIZE);
+		dgAssert(i >= 0);
+		return m_f[i];
+	}
+
+	DG_INLINE const float& operator[] (dgInt32 i) const
+	{
+		dgAssert(i < DG_SOA_WORD_GROUP_SIZE);
+		dgAssert(i >= 0);
+		return m_f[i];
+	}
+
+	DG_INLINE dgSoaFloat operator+ (const dgSoaFloat& A) const
+	{
+		return _mm512_add_ps(m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloat operator- (const dgSoaFloat& A) const
+	{
+		return _mm512_sub_ps(m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloat operator* (const dgSoaFloat& A) const
+	{
+		return _mm512_mul_ps(m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloat MulAdd(const dgSoaFloat& A, const dgSoaFloat& B) const
+	{
+		return _mm512_fmadd_ps(A.m_type, B.m_type, m_type);
+	}
+
+	DG_INLINE dgSoaFloat MulSub(const dgSoaFloat& A, const dgSoaFloat& B) const
+	{
+		return _mm512_fnmadd_ps(A.m_type, B.m_type, m_type);
+	}
+
+	DG_INLINE dgSoaMask operator> (const dgSoaFloat& A) const
+	{
+		return _mm512_cmp_ps_mask (m_type, A.m_type, _CMP_GT_OQ);
+	}
+
+	DG_INLINE dgSoaMask operator< (const dgSoaFloat& A) const
+	{
+		return _mm512_cmp_ps_mask (m_type, A.m_type, _CMP_LT_OQ);
+	}
+
+	DG_INLINE dgSoaFloat AndNot (const dgSoaMask& A) const
+	{
+		return _mm512_maskz_mov_ps (_mm512_knot(A.m_mask), m_type);
+	}
+
+	DG_INLINE dgSoaFloat GetMin(const dgSoaFloat& A) const
+	{
+		return _mm512_min_ps (m_type, A.m_type);
+	}
+
+	DG_INLINE dgSoaFloat GetMax(const dgSoaFloat& A) const
+	{
+		return _mm512_max_ps (m_type, A.m_type);
+	}
+
+	// lanes not in the mask keep the value of this
+	DG_INLINE dgSoaFloat Gather(const float* const base, const dgSoaInt& index, const dgSoaMask& mask) const
+	{
+		return _mm512_mask_i32gather_ps (m_type, mask.m_mask, index.m_type, base, 4);
+	}
+
+	DG_INLINE dgSoaFloat Gather(const float* const base, const dgSoaInt& index) const
+	{
+		return _mm512_i32gather_ps (index.m_type, base, 4);
+	}
+
+	DG_INLINE float AddHorizontal() const
+	{
+		return _mm512_reduce_add_ps (m_type);
+	}
+
+	union
+	{
+		__m512 m_type;
+		int m_i[DG_SOA_WORD_GROUP_SIZE];
+		float m_f[DG_SOA_WORD_GROUP_SIZE];
+	};
+} DG_GCC_AVX512_ALIGMENT;
+
+DG_MSC_AVX512_ALIGMENT
+class dgSoaVector3
+{
+	public:
+	dgSoaFloat m_x;
+	dgSoaFloat m_y;
+	dgSoaFloat m_z;
+} DG_GCC_AVX512_ALIGMENT;
+
+
+DG_MSC_AVX512_ALIGMENT
+class dgSoaVector6
+{
+	public:
+	dgSoaVector3 m_linear;
+	dgSoaVector3 m_angular;
+} DG_GCC_AVX512_ALIGMENT;
+
+DG_MSC_AVX512_ALIGMENT
+class dgSoaJacobianPair
+{
+	public:
+	dgSoaVector6 m_jacobianM0;
+	dgSoaVector6 m_jacobianM1;
+} DG_GCC_AVX512_ALIGMENT;
+
+DG_MSC_AVX512_ALIGMENT
+class dgSoaMatrixElement
+{
+	public:
+	dgSoaJacobianPair m_Jt;
+	dgSoaJacobianPair m_JMinv;
+
+	dgSoaFloat m_force;
+	dgSoaFloat m_diagDamp;
+	dgSoaFloat m_invJinvMJt;
+	dgSoaFloat m_coordenateAccel;
+	dgSoaInt m_normalForceIndex;
+	dgSoaFloat m_lowerBoundFrictionCoefficent;
+	dgSoaFloat m_upperBoundFrictionCoefficent;
+} DG_GCC_AVX512_ALIGMENT;
+
+// joints are solved in groups of sixteen, the last group of a cluster is not padded 
+// with dummy joints, the lanes past the end of the joint array are masked out instead.
+DG_MSC_AVX512_ALIGMENT
+class dgSolver: public dgParallelBodySolver
+{
+	public:
+	dgSolver(dgWorld* const world, dgMemoryAllocator* const allocator);
+	~dgSolver();
+	void CalculateJointForces(const dgBodyCluster& cluster, dgBodyInfo* const bodyArray, dgJointInfo* const jointArray, float timestep);
+
+	private:
+	void InitWeights();
+	void InitBodyArray();
+	void CalculateForces();
+	void InitJacobianMatrix();
+	void CalculateBodyForce();
+	void UpdateForceFeedback();
+	void CalculateJointsForce();
+	void IntegrateBodiesVelocity();
+	void UpdateKinematicFeedback();
+	void CalculateJointsAcceleration();
+	void CalculateBodiesAcceleration();
+	
+	void InitBodyArray(dgInt32 threadID);
+	void InitInternalForces(dgInt32 threadID);
+	void InitJacobianMatrix(dgInt32 threadID);
+	void CalculateBodyForce(dgInt32 threadID);
+	void UpdateForceFeedback(dgInt32 threadID);
+	void TransposeMassMatrix(dgInt32 threadID);
+	void CalculateJointsForce(dgInt32 threadID);
+	void UpdateRowAcceleration(dgInt32 threadID);
+	void IntegrateBodiesVelocity(dgInt32 threadID);
+	void UpdateKinematicFeedback(dgInt32 threadID);
+	void CalculateJointsAcceleration(dgInt32 threadID);
+	void CalculateBodiesAcceleration(dgInt32 threadID);
+
+	static void InitBodyArrayKernel(void* const context, void* const, dgInt32 threadID);
+	static void InitInternalForcesKernel(void* const context, void* const, dgInt32 threadID);
+	static void InitJacobianMatrixKernel(void* const context, void* const, dgInt32 threadID);
+	static void CalculateBodyForceKernel(void* const context, void* const, dgInt32 threadID);
+	static void UpdateForceFeedbackKernel(void* const context, void* const, dgInt32 threadID);
+	static void TransposeMassMatrixKernel(void* const context, void* const, dgInt32 threadID);
+	static void CalculateJointsForceKernel(void* const context, void* const, dgInt32 threadID);
+	static void UpdateRowAccelerationKernel(void* const context, void* const, dgInt32 threadID);
+	static void IntegrateBodiesVelocityKernel(void* const context, void* const, dgInt32 threadID);
+	static void UpdateKinematicFeedbackKernel(void* const context, void* const, dgInt32 threadID);
+	static void CalculateBodiesAccelerationKernel(void* const context, void* const, dgInt32 threadID);
+	static void CalculateJointsAccelerationKernel(void* const context, void* const, dgInt32 threadID);
+	
+	static dgInt32 CompareJointInfos(const dgJointInfo* const infoA, const dgJointInfo* const infoB, void* notUsed);
+	static dgInt32 CompareBodyJointsPairs(const dgBodyJacobianPair* const pairA, const dgBodyJacobianPair* const pairB, void* notUsed);
+
+	DG_INLINE dgInt32 GetLaneCount(dgInt32 group) const;
+	DG_INLINE void SortWorkGroup(dgInt32 base, dgInt32 count) const;
+	DG_INLINE void TransposeRow (dgSoaMatrixElement* const row, const dgJointInfo* const jointInfoArray, dgInt32 laneCount, dgInt32 index);
+	DG_INLINE void BuildJacobianMatrix(dgJointInfo* const jointInfo, dgLeftHandSide* const leftHandSide, dgRightHandSide* const righHandSide);
+	DG_INLINE float CalculateJointForce(const dgJointInfo* const jointInfo, dgInt32 laneCount, dgSoaMatrixElement* const massMatrix, const dgAvxFloat* const internalForces) const;
+
+	dgSoaFloat m_soaOne;
+	dgSoaFloat m_soaZero;
+	dgSoaInt m_soaLaneIndex;
+	dgVector m_zero;
+	dgVector m_negOne;
+	dgArray<dgSoaMatrixElement> m_massMatrix;
+} DG_GCC_AVX512_ALIGMENT;
+
+
+#endif
+
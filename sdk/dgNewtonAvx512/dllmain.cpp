@@ -0,0 +1,59 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "dgNewtonPluginStdafx.h"
+
+
+#ifdef _MSC_VER
+BOOL APIENTRY DllMain( HMODULE hModule,
+                       DWORD  ul_reason_for_call,
+                       LPVOID lpReserved
+					 )
+{
+	switch (ul_reason_for_call)
+	{
+		case DLL_PROCESS_ATTACH:
+		case DLL_THREAD_ATTACH:
+		case DLL_THREAD_DETACH:
+		case DLL_PROCESS_DETACH:
+			break;
+	}
+
+	union cpuInfo
+	{
+		int m_data[4];
+		struct
+		{
+			int m_eax;
+			int m_ebx;
+			int m_ecx;
+			int m_edx;
+		};
+	} info;
+
+	// check for instruction set support (avx is bit 28 in reg ecx)
+	__cpuid(info.m_data, 1);
+	if (!(info.m_ecx & (1 << 28))) {
+		return FALSE;
+	}
+	return TRUE;
+}
+#endif
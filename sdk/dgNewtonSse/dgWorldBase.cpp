@@ -26,6 +26,12 @@
 // This is an example of an exported function.
 dgWorldPlugin* GetPlugin(dgWorld* const world, dgMemoryAllocator* const allocator)
 {
+	// check for instruction set support (sse3)
+	const dgUnsigned32 requiredFeatures = DG_CPU_FEATURE_SSE3;
+	if ((dgGetCpuFeatures() & requiredFeatures) != requiredFeatures) {
+		return NULL;
+	}
+
 	static dgWorldBase module(world, allocator);
 	module.m_score = 1;
 	return &module;
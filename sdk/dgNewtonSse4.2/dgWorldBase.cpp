@@ -26,36 +26,14 @@
 // This is an example of an exported function.
 dgWorldPlugin* GetPlugin(dgWorld* const world, dgMemoryAllocator* const allocator)
 {
-	union cpuInfo
-	{
-		int m_data[4];
-		struct
-		{
-			int m_eax;
-			int m_ebx;
-			int m_ecx;
-			int m_edx;
-		};
-	} info;
-
-	//static bool FMA(void) { return CPU_Rep.f_1_ECX_[12]; }
-	__cpuid(info.m_data, 1);
-	if (!(info.m_ecx & (1 << 12))) {
+	// check for instruction set support (sse4.2 and fmad3)
+	const dgUnsigned32 requiredFeatures = DG_CPU_FEATURE_SSE4_2 | DG_CPU_FEATURE_FMA;
+	if ((dgGetCpuFeatures() & requiredFeatures) != requiredFeatures) {
 		return NULL;
 	}
-	
-	static dgWorldBase module(world, allocator);
-	union {
-		char m_vendor[256];
-		int m_reg[3];
-	};
-	memset(m_vendor, 0, sizeof(m_vendor));
-	__cpuid(info.m_data, 0);
 
-	m_reg[0] = info.m_ebx;
-	m_reg[1] = info.m_edx;
-	m_reg[2] = info.m_ecx;
-	module.m_score = _stricmp(m_vendor, "GenuineIntel") ? 4 : 2;
+	static dgWorldBase module(world, allocator);
+	module.m_score = dgIsIntelCpu() ? 2 : 4;
 	return &module;
 }
 
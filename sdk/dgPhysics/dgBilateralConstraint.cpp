@@ -242,10 +242,10 @@ void dgBilateralConstraint::SetSpringDamperAcceleration (dgInt32 index, dgContra
 		const dgJacobian &jacobian0 = desc.m_jacobian[index].m_jacobianM0; 
 		const dgJacobian &jacobian1 = desc.m_jacobian[index].m_jacobianM1; 
 
-		const dgVector& veloc0 = m_body0->m_veloc;
-		const dgVector& omega0 = m_body0->m_omega;
-		const dgVector& veloc1 = m_body1->m_veloc;
-		const dgVector& omega1 = m_body1->m_omega;
+		const dgVector& veloc0 = m_body0->GetStateVeloc();
+		const dgVector& omega0 = m_body0->GetStateOmega();
+		const dgVector& veloc1 = m_body1->GetStateVeloc();
+		const dgVector& omega1 = m_body1->GetStateOmega();
 
 		//dgFloat32 relPosit = (p1Global - p0Global) % jacobian0.m_linear + jointAngle;
 		dgFloat32 relPosit = desc.m_penetration[index];
@@ -388,10 +388,10 @@ void dgBilateralConstraint::CalculatePointDerivative (dgInt32 index, dgContraint
 		//dgFloat32 relCentr = centrError.DotProduct(dir).GetScalar(); 
 		//relCentr = dgClamp (relCentr, dgFloat32(-100000.0f), dgFloat32(100000.0f));
 
-		const dgVector& bodyVeloc0 = m_body0->m_veloc;
-		const dgVector& bodyOmega0 = m_body0->m_omega;
-		const dgVector& bodyVeloc1 = m_body1->m_veloc;
-		const dgVector& bodyOmega1 = m_body1->m_omega;
+		const dgVector& bodyVeloc0 = m_body0->GetStateVeloc();
+		const dgVector& bodyOmega0 = m_body0->GetStateOmega();
+		const dgVector& bodyVeloc1 = m_body1->GetStateVeloc();
+		const dgVector& bodyOmega1 = m_body1->GetStateOmega();
 		dgVector accel(bodyVeloc0 * bodyOmega0.CrossProduct(jacobian0.m_linear) + bodyOmega0 * bodyOmega0.CrossProduct(jacobian0.m_angular) +
 					   bodyVeloc1 * bodyOmega1.CrossProduct(jacobian1.m_linear) + bodyOmega1 * bodyOmega1.CrossProduct(jacobian1.m_angular));
 		dgFloat32 relCentr = -accel.AddHorizontal().GetScalar();
@@ -427,10 +427,10 @@ void dgBilateralConstraint::CalculatePointDerivative (dgInt32 index, dgContraint
 
 void dgBilateralConstraint::JointAccelerations(dgJointAccelerationDecriptor* const params)
 {
-	const dgVector& bodyVeloc0 = m_body0->m_veloc;
-	const dgVector& bodyOmega0 = m_body0->m_omega;
-	const dgVector& bodyVeloc1 = m_body1->m_veloc;
-	const dgVector& bodyOmega1 = m_body1->m_omega;
+	const dgVector& bodyVeloc0 = m_body0->GetStateVeloc();
+	const dgVector& bodyOmega0 = m_body0->GetStateOmega();
+	const dgVector& bodyVeloc1 = m_body1->GetStateVeloc();
+	const dgVector& bodyOmega1 = m_body1->GetStateOmega();
 
 // remember the impulse branch 
 //dgAssert (params->m_timeStep > dgFloat32 (0.0f));
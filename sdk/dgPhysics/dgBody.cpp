@@ -36,40 +36,37 @@
 //////////////////////////////////////////////////////////////////////
 
 dgBody::dgBody()
-	:m_matrix (dgGetIdentityMatrix())
+	:m_statePage(NULL)
+	,m_stateIndex(-1)
 	,m_rotation(dgFloat32 (1.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f))
-	,m_invWorldInertiaMatrix(dgGetZeroMatrix())
-	,m_mass(dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f))
-	,m_invMass(dgFloat32 (0.0f))
-	,m_veloc(dgFloat32 (0.0f))
-	,m_omega(dgFloat32 (0.0f))
-	,m_accel(dgFloat32 (0.0f))
-	,m_alpha(dgFloat32 (0.0f))
-	,m_minAABB(dgFloat32 (0.0f))
-	,m_maxAABB(dgFloat32 (0.0f))
 	,m_localCentreOfMass(dgFloat32 (0.0f))	
 	,m_globalCentreOfMass(dgFloat32 (0.0f))	
+	,m_collision(NULL)
+	,m_broadPhaseNode(NULL)
+	,m_broadPhaseaggregateNode(NULL)
+	,m_masterNode(NULL)
+	,m_world(NULL)
+	,m_matrixUpdate(NULL)
+	,m_criticalSectionLock(0)
+	,m_flags(0)
+	,m_rtti(m_baseBodyRTTI)
+	,m_index(0)
+	,m_graphIndex(-1)
+	,m_dynamicsLru(0)
+	,m_invMass(dgFloat32 (0.0f))
+	,m_alpha(dgFloat32 (0.0f))
+	,m_invWorldInertiaMatrix(dgGetZeroMatrix())
+	,m_mass(dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f))
 	,m_impulseForce(dgFloat32 (0.0f))		
 	,m_impulseTorque(dgFloat32 (0.0f))	
 	,m_gyroTorque(dgFloat32 (0.0f))
 	,m_gyroRotation(dgFloat32 (1.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f))
-	,m_criticalSectionLock(0)
-	,m_flags(0)
 	,m_userData(NULL)
-	,m_world(NULL)
-	,m_collision(NULL)
-	,m_broadPhaseNode(NULL)
-	,m_masterNode(NULL)
-	,m_broadPhaseaggregateNode(NULL)
 	,m_destructor(NULL)
-	,m_matrixUpdate(NULL)
-	,m_index(0)
 	,m_uniqueID(0)
 	,m_bodyGroupId(0)
-	,m_rtti(m_baseBodyRTTI)
 	,m_type(0)
 	,m_serializedEnum(-1)
-	,m_dynamicsLru(0)
 	,m_genericLRUMark(0)
 {
 	m_autoSleep = true;
@@ -82,40 +79,37 @@ dgBody::dgBody()
 }
 
 dgBody::dgBody (dgWorld* const world, const dgTree<const dgCollision*, dgInt32>* const collisionCashe, dgDeserialize serializeCallback, void* const userData, dgInt32 revisionNumber)
-	:m_matrix (dgGetIdentityMatrix())
+	:m_statePage(NULL)
+	,m_stateIndex(-1)
 	,m_rotation(dgFloat32 (1.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f))
-	,m_invWorldInertiaMatrix(dgGetZeroMatrix())
-	,m_mass(dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f))
-	,m_invMass(dgFloat32 (0.0f))
-	,m_veloc(dgFloat32 (0.0f))
-	,m_omega(dgFloat32 (0.0f))
-	,m_accel(dgFloat32 (0.0f))
-	,m_alpha(dgFloat32 (0.0f))
-	,m_minAABB(dgFloat32 (0.0f))
-	,m_maxAABB(dgFloat32 (0.0f))
 	,m_localCentreOfMass(dgFloat32 (0.0f))	
 	,m_globalCentreOfMass(dgFloat32 (0.0f))	
-	,m_impulseForce(dgFloat32 (0.0f))		
-	,m_impulseTorque(dgFloat32 (0.0f))		
-	,m_gyroTorque(dgFloat32 (0.0f))
-	,m_gyroRotation(dgFloat32 (1.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f))
-	,m_criticalSectionLock(0)
-	,m_flags(0)
-	,m_userData(NULL)
-	,m_world(world)
 	,m_collision(NULL)
 	,m_broadPhaseNode(NULL)
-	,m_masterNode(NULL)
 	,m_broadPhaseaggregateNode(NULL)
-	,m_destructor(NULL)
+	,m_masterNode(NULL)
+	,m_world(world)
 	,m_matrixUpdate(NULL)
+	,m_criticalSectionLock(0)
+	,m_flags(0)
+	,m_rtti(m_baseBodyRTTI)
 	,m_index(0)
+	,m_graphIndex(-1)
+	,m_dynamicsLru(0)
+	,m_invMass(dgFloat32 (0.0f))
+	,m_alpha(dgFloat32 (0.0f))
+	,m_invWorldInertiaMatrix(dgGetZeroMatrix())
+	,m_mass(dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f), dgFloat32 (DG_INFINITE_MASS * 2.0f))
+	,m_impulseForce(dgFloat32 (0.0f))		
+	,m_impulseTorque(dgFloat32 (0.0f))	
+	,m_gyroTorque(dgFloat32 (0.0f))
+	,m_gyroRotation(dgFloat32 (1.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f))
+	,m_userData(NULL)
+	,m_destructor(NULL)
 	,m_uniqueID(0)
 	,m_bodyGroupId(0)
-	,m_rtti(m_baseBodyRTTI)
 	,m_type(0)
 	,m_serializedEnum(-1)
-	,m_dynamicsLru(0)
 	,m_genericLRUMark(0)
 {
 	m_autoSleep = true;
@@ -124,12 +118,13 @@ dgBody::dgBody (dgWorld* const world, const dgTree<const dgCollision*, dgInt32>*
 	m_collideWithLinkedBodies = true;
 	m_invWorldInertiaMatrix[3][3] = dgFloat32 (1.0f);
 
+	world->m_bodyState.AddBody(this);
 	serializeCallback (userData, &m_rotation, sizeof (m_rotation));
-	serializeCallback (userData, &m_matrix, sizeof (m_matrix));
-	serializeCallback (userData, &m_veloc, sizeof (m_veloc));
-	serializeCallback (userData, &m_omega, sizeof (m_omega));
-	serializeCallback (userData, &m_accel, sizeof (m_veloc));
-	serializeCallback (userData, &m_alpha, sizeof (m_omega));
+	serializeCallback (userData, &GetStateMatrix(), sizeof (dgMatrix));
+	serializeCallback (userData, &GetStateVeloc(), sizeof (dgVector));
+	serializeCallback (userData, &GetStateOmega(), sizeof (dgVector));
+	serializeCallback (userData, &GetStateAccel(), sizeof (dgVector));
+	serializeCallback (userData, &m_alpha, sizeof (dgVector));
 	serializeCallback (userData, &m_localCentreOfMass, sizeof (m_localCentreOfMass));
 	serializeCallback (userData, &m_mass, sizeof (m_mass));
 	serializeCallback (userData, &m_flags, sizeof (m_flags));
@@ -186,11 +181,11 @@ void dgBody::AttachCollision (dgCollisionInstance* const collisionSrc)
 void dgBody::Serialize (const dgTree<dgInt32, const dgCollision*>& collisionRemapId, dgSerialize serializeCallback, void* const userData)
 {
 	serializeCallback (userData, &m_rotation, sizeof (m_rotation));
-	serializeCallback (userData, &m_matrix, sizeof (m_matrix));
-	serializeCallback (userData, &m_veloc, sizeof (m_veloc));
-	serializeCallback (userData, &m_omega, sizeof (m_omega));
-	serializeCallback (userData, &m_accel, sizeof (m_veloc));
-	serializeCallback (userData, &m_alpha, sizeof (m_omega));
+	serializeCallback (userData, &GetStateMatrix(), sizeof (dgMatrix));
+	serializeCallback (userData, &GetStateVeloc(), sizeof (dgVector));
+	serializeCallback (userData, &GetStateOmega(), sizeof (dgVector));
+	serializeCallback (userData, &GetStateAccel(), sizeof (dgVector));
+	serializeCallback (userData, &m_alpha, sizeof (dgVector));
 	serializeCallback (userData, &m_localCentreOfMass, sizeof (m_localCentreOfMass));
 	serializeCallback(userData, &m_mass, sizeof (m_mass));
 	serializeCallback (userData, &m_flags, sizeof (m_flags));
@@ -236,21 +231,23 @@ void dgBody::SetMatrixResetSleep(const dgMatrix& matrix)
 
 void dgBody::UpdateWorlCollisionMatrix() const
 {
-	m_collision->SetGlobalMatrix (m_collision->GetLocalMatrix() * m_matrix);
+	m_collision->SetGlobalMatrix (m_collision->GetLocalMatrix() * GetStateMatrix());
 }
 
 
 
 void dgBody::UpdateCollisionMatrix (dgFloat32 timestep, dgInt32 threadIndex)
 {
+	dgVector& minBox = GetStateMinAABB();
+	dgVector& maxBox = GetStateMaxAABB();
 	m_transformIsDirty = true;
-	m_collision->SetGlobalMatrix (m_collision->GetLocalMatrix() * m_matrix);
-	m_collision->CalcAABB (m_collision->GetGlobalMatrix(), m_minAABB, m_maxAABB);
+	m_collision->SetGlobalMatrix (m_collision->GetLocalMatrix() * GetStateMatrix());
+	m_collision->CalcAABB (m_collision->GetGlobalMatrix(), minBox, maxBox);
 
 	if (m_continueCollisionMode) {
 		dgVector predictiveVeloc (PredictLinearVelocity(timestep));
 		dgVector predictiveOmega (PredictAngularVelocity(timestep));
-		dgMovingAABB (m_minAABB, m_maxAABB, predictiveVeloc, predictiveOmega, timestep, m_collision->GetBoxMaxRadius(), m_collision->GetBoxMinRadius());
+		dgMovingAABB (minBox, maxBox, predictiveVeloc, predictiveOmega, timestep, m_collision->GetBoxMaxRadius(), m_collision->GetBoxMinRadius());
 	}
 
 	if (m_broadPhaseNode) {
@@ -267,7 +264,7 @@ dgFloat32 dgBody::RayCast (const dgLineBox& line, OnRayCastAction filter, OnRayP
 	dgAssert (filter);
 	dgVector l0 (line.m_l0);
 	dgVector l1 (line.m_l0 + (line.m_l1 - line.m_l0).Scale (dgMin(maxT, dgFloat32 (1.0f))));
-	if (dgRayBoxClip (l0, l1, m_minAABB, m_maxAABB)) {
+	if (dgRayBoxClip (l0, l1, GetStateMinAABB(), GetStateMaxAABB())) {
 //	if (1) {
 //l0 = dgVector (-20.3125000f, 3.54991579f, 34.3441200f, 0.0f);
 //l1 = dgVector (-19.6875000f, 3.54257250f, 35.2211456f, 0.0f);
@@ -301,32 +298,35 @@ dgFloat32 dgBody::RayCast (const dgLineBox& line, OnRayCastAction filter, OnRayP
 
 void dgBody::IntegrateVelocity (dgFloat32 timestep)
 {
-	dgAssert (m_veloc.m_w == dgFloat32 (0.0f));
-	dgAssert (m_omega.m_w == dgFloat32 (0.0f));
-	m_globalCentreOfMass += m_veloc.Scale (timestep); 
-	dgFloat32 omegaMag2 = m_omega.DotProduct(m_omega).GetScalar();
+	dgMatrix& matrix = GetStateMatrix();
+	const dgVector& veloc = GetStateVeloc();
+	const dgVector& omega = GetStateOmega();
+	dgAssert (veloc.m_w == dgFloat32 (0.0f));
+	dgAssert (omega.m_w == dgFloat32 (0.0f));
+	m_globalCentreOfMass += veloc.Scale (timestep); 
+	dgFloat32 omegaMag2 = omega.DotProduct(omega).GetScalar();
 #ifdef _DEBUG
 	const dgFloat32 err = dgFloat32(90.0f * dgDEG2RAD);
 	const dgFloat32 err2 = err * err;
 	const dgFloat32 step2 = omegaMag2 * timestep * timestep;
 	if (step2 > err2) {
-		dgTrace (("warning bodies %d w(%f %f %f) with very high angular velocity, may be unstable\n", m_uniqueID, m_omega.m_x, m_omega.m_y, m_omega.m_z));
+		dgTrace (("warning bodies %d w(%f %f %f) with very high angular velocity, may be unstable\n", m_uniqueID, omega.m_x, omega.m_y, omega.m_z));
 	}
 #endif
 
 	// this is correct
 	if (omegaMag2 > ((dgFloat32 (0.0125f) * dgDEG2RAD) * (dgFloat32 (0.0125f) * dgDEG2RAD))) {
 		dgFloat32 invOmegaMag = dgRsqrt (omegaMag2);
-		dgVector omegaAxis (m_omega.Scale (invOmegaMag));
+		dgVector omegaAxis (omega.Scale (invOmegaMag));
 		dgFloat32 omegaAngle = invOmegaMag * omegaMag2 * timestep;
 		dgQuaternion rotation (omegaAxis, omegaAngle);
 		m_rotation = m_rotation * rotation;
 		m_rotation.Scale(dgRsqrt (m_rotation.DotProduct (m_rotation)));
-		m_matrix = dgMatrix (m_rotation, m_matrix.m_posit);
+		matrix = dgMatrix (m_rotation, matrix.m_posit);
 	}
 
-	m_matrix.m_posit = m_globalCentreOfMass - m_matrix.RotateVector(m_localCentreOfMass);
-	dgAssert (m_matrix.TestOrthogonal());
+	matrix.m_posit = m_globalCentreOfMass - matrix.RotateVector(m_localCentreOfMass);
+	dgAssert (matrix.TestOrthogonal());
 }
 
 dgVector dgBody::CalculateInverseDynamicForce (const dgVector& desiredVeloc, dgFloat32 timestep) const
@@ -340,7 +340,7 @@ dgVector dgBody::CalculateInverseDynamicForce (const dgVector& desiredVeloc, dgF
 			massAccel *= (dgFloat32 (2.0f) * dgFloat32 (LINEAR_SOLVER_SUB_STEPS) / dgFloat32 (LINEAR_SOLVER_SUB_STEPS + 1));
 		} 
 	}
-	return (desiredVeloc - m_veloc).Scale (massAccel);
+	return (desiredVeloc - GetStateVeloc()).Scale (massAccel);
 */
 }
 
@@ -483,6 +483,7 @@ void dgBody::SetMassMatrix(dgFloat32 mass, const dgMatrix& inertia)
 				dgBodyMasterList& masterList (*m_world);
 				if (masterList.GetFirst() != m_masterNode) {
 					masterList.InsertAfter (masterList.GetFirst(), m_masterNode);
+					masterList.InvalidateBodyArray();
 				}
 			}
 		}
@@ -513,6 +514,7 @@ void dgBody::SetMassMatrix(dgFloat32 mass, const dgMatrix& inertia)
 			if (m_invMass.m_w == dgFloat32 (0.0f)) {
 				dgBodyMasterList& masterList(*m_world);
 				masterList.RotateToEnd(m_masterNode);
+				masterList.InvalidateBodyArray();
 			}
 		}
 
@@ -581,55 +583,57 @@ dgMatrix dgBody::CalculateLocalInertiaMatrix () const
 
 dgMatrix dgBody::CalculateInertiaMatrix () const
 {
+	const dgMatrix& matrix = GetStateMatrix();
 #if 0
-	dgMatrix tmp (m_matrix.Transpose4X4());
+	dgMatrix tmp (matrix.Transpose4X4());
 	dgVector mass (m_mass & dgVector::m_triplexMask);
 	tmp[0] = tmp[0] * mass;
 	tmp[1] = tmp[1] * mass;
 	tmp[2] = tmp[2] * mass;
-	return dgMatrix (m_matrix.RotateVector(tmp[0]), m_matrix.RotateVector(tmp[1]), m_matrix.RotateVector(tmp[2]), dgVector::m_wOne);
+	return dgMatrix (matrix.RotateVector(tmp[0]), matrix.RotateVector(tmp[1]), matrix.RotateVector(tmp[2]), dgVector::m_wOne);
 #else
 	const dgVector Ixx(m_mass[0]);
 	const dgVector Iyy(m_mass[1]);
 	const dgVector Izz(m_mass[2]);
-	return dgMatrix (m_matrix.m_front.Scale(m_matrix.m_front[0]) * Ixx +
-					 m_matrix.m_up.Scale(m_matrix.m_up[0])		  * Iyy +
-					 m_matrix.m_right.Scale(m_matrix.m_right[0]) * Izz,
+	return dgMatrix (matrix.m_front.Scale(matrix.m_front[0]) * Ixx +
+					 matrix.m_up.Scale(matrix.m_up[0])		  * Iyy +
+					 matrix.m_right.Scale(matrix.m_right[0]) * Izz,
 
-					 m_matrix.m_front.Scale(m_matrix.m_front[1]) * Ixx +
-					 m_matrix.m_up.Scale(m_matrix.m_up[1])       * Iyy +
-					 m_matrix.m_right.Scale(m_matrix.m_right[1]) * Izz,
+					 matrix.m_front.Scale(matrix.m_front[1]) * Ixx +
+					 matrix.m_up.Scale(matrix.m_up[1])       * Iyy +
+					 matrix.m_right.Scale(matrix.m_right[1]) * Izz,
 
-					 m_matrix.m_front.Scale(m_matrix.m_front[2]) * Ixx +
-					 m_matrix.m_up.Scale(m_matrix.m_up[2])       * Iyy +
-					 m_matrix.m_right.Scale(m_matrix.m_right[2]) * Izz,
+					 matrix.m_front.Scale(matrix.m_front[2]) * Ixx +
+					 matrix.m_up.Scale(matrix.m_up[2])       * Iyy +
+					 matrix.m_right.Scale(matrix.m_right[2]) * Izz,
 					 dgVector::m_wOne);
 #endif
 }
 
 dgMatrix dgBody::CalculateInvInertiaMatrix () const
 {
+	const dgMatrix& matrix = GetStateMatrix();
 #if 0
-	dgMatrix tmp (m_matrix.Transpose4X4());
+	dgMatrix tmp (matrix.Transpose4X4());
 	tmp[0] = tmp[0] * m_invMass;
 	tmp[1] = tmp[1] * m_invMass;
 	tmp[2] = tmp[2] * m_invMass;
-	return dgMatrix (m_matrix.RotateVector(tmp[0]), m_matrix.RotateVector(tmp[1]), m_matrix.RotateVector(tmp[2]), dgVector::m_wOne);
+	return dgMatrix (matrix.RotateVector(tmp[0]), matrix.RotateVector(tmp[1]), matrix.RotateVector(tmp[2]), dgVector::m_wOne);
 #else
 	const dgVector invIxx(m_invMass[0]);
 	const dgVector invIyy(m_invMass[1]);
 	const dgVector invIzz(m_invMass[2]);
-	return dgMatrix(m_matrix.m_front.Scale(m_matrix.m_front[0]) * invIxx +
-					m_matrix.m_up.Scale(m_matrix.m_up[0])		 * invIyy +
-					m_matrix.m_right.Scale(m_matrix.m_right[0]) * invIzz,
+	return dgMatrix(matrix.m_front.Scale(matrix.m_front[0]) * invIxx +
+					matrix.m_up.Scale(matrix.m_up[0])		 * invIyy +
+					matrix.m_right.Scale(matrix.m_right[0]) * invIzz,
 
-					m_matrix.m_front.Scale(m_matrix.m_front[1]) * invIxx +
-					m_matrix.m_up.Scale(m_matrix.m_up[1])		 * invIyy +
-					m_matrix.m_right.Scale(m_matrix.m_right[1]) * invIzz,
+					matrix.m_front.Scale(matrix.m_front[1]) * invIxx +
+					matrix.m_up.Scale(matrix.m_up[1])		 * invIyy +
+					matrix.m_right.Scale(matrix.m_right[1]) * invIzz,
 
-					m_matrix.m_front.Scale(m_matrix.m_front[2]) * invIxx +
-					m_matrix.m_up.Scale(m_matrix.m_up[2])		 * invIyy +
-					m_matrix.m_right.Scale(m_matrix.m_right[2]) * invIzz,
+					matrix.m_front.Scale(matrix.m_front[2]) * invIxx +
+					matrix.m_up.Scale(matrix.m_up[2])		 * invIyy +
+					matrix.m_right.Scale(matrix.m_right[2]) * invIzz,
 					dgVector::m_wOne);
 #endif
 }
@@ -640,7 +644,7 @@ void dgBody::InvalidateCache ()
 	m_sleeping = false;
 	m_equilibrium = false;
 	m_genericLRUMark = 0;
-	dgMatrix matrix (m_matrix);
+	dgMatrix matrix (GetStateMatrix());
 	SetMatrixOriginAndRotation(matrix);
 }
 
@@ -24,6 +24,7 @@
 
 #include "dgPhysicsStdafx.h"
 #include "dgCollision.h"
+#include "dgBodyStateTable.h"
 #include "dgBodyMasterList.h"
 
 class dgLink;
@@ -40,7 +41,7 @@ class dgBroadPhaseAggregate;
 #define DG_MINIMUM_MASS		dgFloat32(1.0e-5f)
 #define DG_INFINITE_MASS	dgFloat32(1.0e15f)
 
-#define OverlapTest(body0,body1) dgOverlapTest ((body0)->m_minAABB, (body0)->m_maxAABB, (body1)->m_minAABB, (body1)->m_maxAABB)
+#define OverlapTest(body0,body1) dgOverlapTest ((body0)->GetStateMinAABB(), (body0)->GetStateMaxAABB(), (body1)->GetStateMinAABB(), (body1)->GetStateMaxAABB())
 
 
 
@@ -93,6 +94,7 @@ class dgBody
 			m_bodyCount = 1;
 			m_jointCount = 0;
 			m_rowCount = 0;
+			m_equilibrium = 1;
 		}
 
 		dgBody* m_parent;
@@ -100,6 +102,7 @@ class dgBody
 		dgInt32 m_bodyCount;
 		dgInt32 m_jointCount;
 		dgInt32 m_rowCount;
+		dgInt32 m_equilibrium;
 	};
 
 	DG_CLASS_ALLOCATOR(allocator)
@@ -247,24 +250,33 @@ class dgBody
 	dgVector CalculateLinearMomentum() const; 
 	dgVector CalculateAngularMomentum() const; 
 
-	dgMatrix m_matrix;
+	// the matrix, velocities, acceleration and aabb live in the world body state table
+	DG_INLINE dgMatrix& GetStateMatrix();
+	DG_INLINE dgVector& GetStateVeloc();
+	DG_INLINE dgVector& GetStateOmega();
+	DG_INLINE dgVector& GetStateAccel();
+	DG_INLINE dgVector& GetStateMinAABB();
+	DG_INLINE dgVector& GetStateMaxAABB();
+	DG_INLINE const dgMatrix& GetStateMatrix() const;
+	DG_INLINE const dgVector& GetStateVeloc() const;
+	DG_INLINE const dgVector& GetStateOmega() const;
+	DG_INLINE const dgVector& GetStateAccel() const;
+	DG_INLINE const dgVector& GetStateMinAABB() const;
+	DG_INLINE const dgVector& GetStateMaxAABB() const;
+
+	dgBodyStatePage* m_statePage;
+	dgInt32 m_stateIndex;
+
 	dgQuaternion m_rotation;
-	dgMatrix m_invWorldInertiaMatrix;
-	dgVector m_mass;
-	dgVector m_invMass;
-	dgVector m_veloc;
-	dgVector m_omega;
-	dgVector m_accel;
-	dgVector m_alpha;
-	dgVector m_minAABB;
-	dgVector m_maxAABB;
 	dgVector m_localCentreOfMass;	
 	dgVector m_globalCentreOfMass;	
-	dgVector m_impulseForce;	
-	dgVector m_impulseTorque;	
-	dgVector m_gyroTorque;
-	dgQuaternion m_gyroRotation;
 
+	dgCollisionInstance* m_collision;
+	dgBroadPhaseBodyNode* m_broadPhaseNode;
+	dgBroadPhaseAggregate* m_broadPhaseaggregateNode;
+	dgBodyMasterList::dgListNode* m_masterNode;
+	dgWorld* m_world;
+	OnMatrixUpdateCallback m_matrixUpdate;
 	mutable dgInt32 m_criticalSectionLock;
 	union 
 	{
@@ -283,34 +295,45 @@ class dgBody
 			dgUnsigned32 m_transformIsDirty			: 1;
 		};
 	};
+	dgInt32 m_rtti;
+	dgInt32 m_index;
+
+	dgSetInfo m_disjointInfo;
+	dgInt32 m_graphIndex;
+	dgUnsigned32 m_dynamicsLru;
+	dgVector m_invMass;
+	dgVector m_alpha;
+
+	// solver state
+	dgMatrix m_invWorldInertiaMatrix;
+	dgVector m_mass;
+	dgVector m_impulseForce;	
+	dgVector m_impulseTorque;	
+	dgVector m_gyroTorque;
+	dgQuaternion m_gyroRotation;
 
+	// cold data, only read by the application and by serialization
 	void* m_userData;
-	dgWorld* m_world;
-	dgCollisionInstance* m_collision;
-	dgBroadPhaseBodyNode* m_broadPhaseNode;
-	dgBodyMasterList::dgListNode* m_masterNode;
-	dgBroadPhaseAggregate* m_broadPhaseaggregateNode;
 	OnBodyDestroy m_destructor;
-	OnMatrixUpdateCallback m_matrixUpdate;
-
-	dgSetInfo m_disjointInfo;
-	dgInt32 m_index;
 	dgInt32 m_uniqueID;
 	dgInt32 m_bodyGroupId;
-	dgInt32 m_rtti;
 	dgInt32 m_type;
 	dgInt32 m_serializedEnum;
-	dgUnsigned32 m_dynamicsLru;
 	dgUnsigned32 m_genericLRUMark;
 
 	friend class dgWorld;
 	friend class dgSolver;
+	friend class dgSolverSse::dgSolver;
+	friend class dgSolverAvx::dgSolver;
+	friend class dgSolverAvx2::dgSolver;
+	friend class dgSolverAvx512::dgSolver;
 	friend class dgContact;
 	friend class dgConstraint;	
 	friend class dgBroadPhase;
 	friend class dgCollisionBVH;
 	friend class dgBroadPhaseNode;
 	friend class dgBodyMasterList;
+	friend class dgBodyStateTable;
 	friend class dgCollisionScene;
 	friend class dgCollisionConvex;
 	friend class dgInverseDynamics;
@@ -319,6 +342,8 @@ class dgBody
 	friend class dgBodyMasterListRow;
 	friend class dgParallelBodySolver;
 	friend class dgWorldDynamicUpdate;
+	friend class dgBroadPhaseBvh4;
+	friend class dgBroadPhaseHashGrid;
 	friend class dgBroadPhaseBodyNode;
 	friend class dgBilateralConstraint;
 	friend class dgBroadPhaseAggregate;
@@ -333,6 +358,78 @@ class dgBody
 //	 Implementation	
 // 
 // *****************************************************************************
+DG_INLINE dgMatrix& dgBody::GetStateMatrix()
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_matrix[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
+DG_INLINE dgVector& dgBody::GetStateVeloc()
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_veloc[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
+DG_INLINE dgVector& dgBody::GetStateOmega()
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_omega[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
+DG_INLINE dgVector& dgBody::GetStateAccel()
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_accel[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
+DG_INLINE dgVector& dgBody::GetStateMinAABB()
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_minAABB[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
+DG_INLINE dgVector& dgBody::GetStateMaxAABB()
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_maxAABB[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
+DG_INLINE const dgMatrix& dgBody::GetStateMatrix() const
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_matrix[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
+DG_INLINE const dgVector& dgBody::GetStateVeloc() const
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_veloc[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
+DG_INLINE const dgVector& dgBody::GetStateOmega() const
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_omega[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
+DG_INLINE const dgVector& dgBody::GetStateAccel() const
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_accel[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
+DG_INLINE const dgVector& dgBody::GetStateMinAABB() const
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_minAABB[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
+DG_INLINE const dgVector& dgBody::GetStateMaxAABB() const
+{
+	dgAssert (m_statePage);
+	return m_statePage->m_maxAABB[m_stateIndex & DG_BODY_STATE_PAGE_MASK];
+}
+
 DG_INLINE const dgMatrix& dgBody::GetInvInertiaMatrix () const 
 {
 	return m_invWorldInertiaMatrix;
@@ -399,27 +496,29 @@ DG_INLINE dgBodyMasterList::dgListNode* dgBody::GetMasterList() const
 
 DG_INLINE void dgBody::GetAABB (dgVector &p0, dgVector &p1) const
 {
-	p0.m_x = m_minAABB.m_x;
-	p0.m_y = m_minAABB.m_y;
-	p0.m_z = m_minAABB.m_z;
-	p1.m_x = m_maxAABB.m_x;
-	p1.m_y = m_maxAABB.m_y;
-	p1.m_z = m_maxAABB.m_z;
+	const dgVector& minBox = GetStateMinAABB();
+	const dgVector& maxBox = GetStateMaxAABB();
+	p0.m_x = minBox.m_x;
+	p0.m_y = minBox.m_y;
+	p0.m_z = minBox.m_z;
+	p1.m_x = maxBox.m_x;
+	p1.m_y = maxBox.m_y;
+	p1.m_z = maxBox.m_z;
 }
 
 DG_INLINE const dgVector& dgBody::GetOmega() const
 {
-	return m_omega;
+	return GetStateOmega();
 }
 
 DG_INLINE const dgVector& dgBody::GetVelocity() const
 {
-	return m_veloc; 
+	return GetStateVeloc(); 
 }
 
 DG_INLINE void dgBody::SetOmegaNoSleep(const dgVector& omega)
 {
-	m_omega = omega;
+	GetStateOmega() = omega;
 }
 
 
@@ -432,12 +531,12 @@ DG_INLINE void dgBody::SetOmega (const dgVector& omega)
 
 DG_INLINE dgVector dgBody::GetVelocityAtPoint (const dgVector& point) const
 {
-	return m_veloc + m_omega.CrossProduct(point - m_globalCentreOfMass);
+	return GetStateVeloc() + GetStateOmega().CrossProduct(point - m_globalCentreOfMass);
 }
 
 DG_INLINE void dgBody::SetVelocityNoSleep(const dgVector& velocity)
 {
-	m_veloc = velocity;
+	GetStateVeloc() = velocity;
 }
 
 DG_INLINE void dgBody::SetVelocity (const dgVector& velocity)
@@ -449,12 +548,12 @@ DG_INLINE void dgBody::SetVelocity (const dgVector& velocity)
 
 DG_INLINE const dgMatrix& dgBody::GetMatrix() const
 {
-	return m_matrix;
+	return GetStateMatrix();
 }
 
 DG_INLINE const dgVector& dgBody::GetPosition() const
 {
-	return m_matrix.m_posit;
+	return GetStateMatrix().m_posit;
 }
 
 DG_INLINE const dgQuaternion& dgBody::GetRotation() const
@@ -473,7 +572,7 @@ DG_INLINE void dgBody::SetCentreOfMass (const dgVector& com)
 	m_localCentreOfMass.m_y = com.m_y;
 	m_localCentreOfMass.m_z = com.m_z;
 	m_localCentreOfMass.m_w = dgFloat32 (1.0f);
-	m_globalCentreOfMass = m_matrix.TransformVector (m_localCentreOfMass);
+	m_globalCentreOfMass = GetStateMatrix().TransformVector (m_localCentreOfMass);
 }
 
 
@@ -567,11 +666,12 @@ DG_INLINE bool dgBody::IsCollidable() const
 
 DG_INLINE void dgBody::SetMatrixOriginAndRotation(const dgMatrix& matrix)
 {
-	m_matrix = matrix;
-	dgAssert (m_matrix.TestOrthogonal(dgFloat32 (1.0e-4f)));
+	dgMatrix& bodyMatrix = GetStateMatrix();
+	bodyMatrix = matrix;
+	dgAssert (bodyMatrix.TestOrthogonal(dgFloat32 (1.0e-4f)));
 
-	m_rotation = dgQuaternion (m_matrix);
-	m_globalCentreOfMass = m_matrix.TransformVector (m_localCentreOfMass);
+	m_rotation = dgQuaternion (bodyMatrix);
+	m_globalCentreOfMass = bodyMatrix.TransformVector (m_localCentreOfMass);
 	UpdateLumpedMatrix();
 }
 
@@ -613,14 +713,15 @@ DG_INLINE void dgBody::CalcInvInertiaMatrix ()
 
 DG_INLINE dgVector dgBody::CalculateLinearMomentum() const
 {
-	return dgVector (m_veloc.Scale (m_mass.m_w));
+	return dgVector (GetStateVeloc().Scale (m_mass.m_w));
 }
 
 DG_INLINE dgVector dgBody::CalculateAngularMomentum() const
 {
-	dgVector localOmega(m_matrix.UnrotateVector(m_omega));
+	const dgMatrix& matrix = GetStateMatrix();
+	dgVector localOmega(matrix.UnrotateVector(GetStateOmega()));
 	dgVector localAngularMomentum(m_mass * localOmega);
-	return m_matrix.RotateVector(localAngularMomentum);
+	return matrix.RotateVector(localAngularMomentum);
 }
 
 DG_INLINE dgSkeletonContainer* dgBody::GetSkeleton() const
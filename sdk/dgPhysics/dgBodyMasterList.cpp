@@ -131,8 +131,14 @@ void dgBodyMasterListRow::SortList()
 
 dgBodyMasterList::dgBodyMasterList (dgMemoryAllocator* const allocator)
 	:dgList<dgBodyMasterListRow>(allocator)
+	,m_bodyState(allocator)
+	,m_bodyArray(allocator)
+	,m_jointGraphStart(allocator)
+	,m_jointGraph(allocator)
 	,m_disableBodies(allocator)
 	,m_constraintCount (0)
+	,m_bodyArrayIsDirty(1)
+	,m_jointGraphIsDirty(1)
 {
 }
 
@@ -150,6 +156,7 @@ void dgBodyMasterList::AddBody (dgBody* const body)
 	if (GetFirst() != node) {
 		InsertAfter (GetFirst(), node);
 	}
+	InvalidateBodyArray();
 }
 
 void dgBodyMasterList::RemoveBody (dgBody* const body)
@@ -162,6 +169,7 @@ void dgBodyMasterList::RemoveBody (dgBody* const body)
 
 	Remove (node);
 	body->m_masterNode = NULL;
+	InvalidateBodyArray();
 }
 
 dgBodyMasterListRow::dgListNode* dgBodyMasterList::FindConstraintLink (const dgBody* const body0, const dgBody* const body1) const
@@ -181,7 +189,20 @@ dgBodyMasterListRow::dgListNode* dgBodyMasterList::FindConstraintLink (const dgB
 
 dgBilateralConstraint* dgBodyMasterList::FindBilateralJoint (const dgBody* body0, const dgBody* body1) const
 {
-	return body0->m_masterNode->GetInfo().FindBilateralJoint (body1);
+	if (m_jointGraphIsDirty) {
+		return body0->m_masterNode->GetInfo().FindBilateralJoint (body1);
+	}
+
+	// same search order as the row, the last joint appended to the row is found first
+	const dgInt32 row = body0->m_graphIndex;
+	const dgBodyMasterListCell* const jointGraph = &m_jointGraph[0];
+	for (dgInt32 i = m_jointGraphStart[row + 1] - 1; i >= m_jointGraphStart[row]; i --) {
+		if (jointGraph[i].m_bodyNode == body1) {
+			dgAssert (jointGraph[i].m_joint->IsBilateral());
+			return (dgBilateralConstraint*) jointGraph[i].m_joint;
+		}
+	}
+	return NULL;
 }
 
 void dgBodyMasterList::AttachConstraint(dgConstraint* const constraint,	dgBody* const body0, dgBody* const otherBody)
@@ -212,6 +233,7 @@ void dgBodyMasterList::AttachConstraint(dgConstraint* const constraint,	dgBody*
 	constraint->m_link0 = body0->m_masterNode->GetInfo().AddBilateralJoint (constraint, body1);
 	constraint->m_link1 = body1->m_masterNode->GetInfo().AddBilateralJoint (constraint, body0);
 	dgAtomicExchangeAndAdd((dgInt32*) &m_constraintCount, 1);
+	InvalidateJointGraph();
 }
 
 void dgBodyMasterList::RemoveConstraint (dgConstraint* const constraint)
@@ -252,6 +274,7 @@ void dgBodyMasterList::RemoveConstraint (dgConstraint* const constraint)
 	} else {
 		dgWorld* const world = body0->GetWorld();
 		world->m_skelListIsDirty = true;
+		InvalidateJointGraph();
 
 		if (body0->GetSkeleton()) {
 			world->DestroySkeletonContainer (body0->GetSkeleton());
@@ -317,6 +340,7 @@ DG_INLINE dgUnsigned32 dgBodyMasterList::MakeSortMask(const dgBody* const body)
 
 void dgBodyMasterList::SortMasterList()
 {
+	InvalidateBodyArray();
 	GetFirst()->GetInfo().SortList();
 
 	for (dgListNode* node = GetFirst()->GetNext(); node; ) { 
@@ -347,4 +371,90 @@ void dgBodyMasterList::SortMasterList()
 			InsertAfter (prev, entry);
 		}
 	}
+
+	SortBodyState();
+}
+
+// lay the body state table out in list order, the disabled bodies go at the end
+void dgBodyMasterList::SortBodyState()
+{
+	dgStack<dgBody*> bodies (GetCount() + m_disableBodies.GetCount());
+	dgInt32 count = 0;
+	for (dgListNode* node = GetFirst(); node; node = node->GetNext()) {
+		bodies[count] = node->GetInfo().GetBody();
+		count ++;
+	}
+	dgTree<int, dgBody*>::Iterator iter (m_disableBodies);
+	for (iter.Begin(); iter; iter ++) {
+		bodies[count] = iter.GetKey();
+		count ++;
+	}
+	m_bodyState.SortBodies (&bodies[0], count);
+}
+
+dgInt32 dgBodyMasterList::BuildBodyArray()
+{
+	// flatten the body master list, skipping the sentinel body, so that parallel loops can index it.
+	// new bodies and mass changes move bodies in the list, a few out of order rows are cheaper than
+	// copying the state, so the body state table is only laid out again in list order when more than 
+	// one in sixteen rows does not follow the previous one in the table
+	DG_TRACKTIME(__FUNCTION__);
+	dgInt32 count = 0;
+	if (m_bodyArrayIsDirty) {
+		m_bodyArrayIsDirty = 0;
+		m_jointGraphIsDirty = 1;
+		m_bodyArray.ResizeIfNecessary(GetCount());
+		dgBody** const bodyArray = &m_bodyArray[0];
+		dgInt32 outOfOrderCount = 0;
+		dgInt32 stateIndex = GetFirst()->GetInfo().GetBody()->m_stateIndex;
+		for (dgListNode* node = GetFirst()->GetNext(); node; node = node->GetNext()) {
+			dgBody* const body = node->GetInfo().GetBody();
+			body->m_graphIndex = count;
+			bodyArray[count] = body;
+			count ++;
+			outOfOrderCount += (body->m_stateIndex < stateIndex) ? 1 : 0;
+			stateIndex = body->m_stateIndex;
+		}
+		GetFirst()->GetInfo().GetBody()->m_graphIndex = count;
+		if (outOfOrderCount > (count >> 4)) {
+			SortBodyState();
+		}
+	} else {
+		count = GetCount() - 1;
+	}
+	return count;
+}
+
+dgInt32 dgBodyMasterList::BuildJointGraph()
+{
+	DG_TRACKTIME(__FUNCTION__);
+	const dgInt32 bodyCount = BuildBodyArray();
+	if (m_jointGraphIsDirty) {
+		m_jointGraphIsDirty = 0;
+		m_jointGraphStart.ResizeIfNecessary(bodyCount + 2);
+		dgInt32* const jointStart = &m_jointGraphStart[0];
+		dgBody** const bodyArray = &m_bodyArray[0];
+
+		// contacts are at the top of the row and bilateral joints are appended at the end
+		dgInt32 index = 0;
+		for (dgInt32 i = 0; i <= bodyCount; i ++) {
+			const dgBodyMasterListRow& row = (i < bodyCount) ? bodyArray[i]->m_masterNode->GetInfo() : GetFirst()->GetInfo();
+			jointStart[i] = index;
+			dgBodyMasterListRow::dgListNode* node = row.GetLast();
+			for (; node && (node->GetInfo().m_joint->GetId() != dgConstraint::m_contactConstraint); node = node->GetPrev()) {
+				index ++;
+			}
+
+			m_jointGraph.ResizeIfNecessary(index);
+			dgBodyMasterListCell* const jointGraph = &m_jointGraph[0];
+			dgInt32 cell = jointStart[i];
+			for (node = node ? node->GetNext() : row.GetFirst(); node; node = node->GetNext()) {
+				jointGraph[cell] = node->GetInfo();
+				cell ++;
+			}
+			dgAssert (cell == index);
+		}
+		jointStart[bodyCount + 1] = index;
+	}
+	return bodyCount;
 }
@@ -76,10 +76,39 @@ class dgBodyMasterList: public dgList<dgBodyMasterListRow>
 	dgBodyMasterListRow::dgListNode* FindConstraintLink (const dgBody* const body0, const dgBody* const body1) const;
 	dgUnsigned32 MakeSortMask(const dgBody* const body) const;
 	void SortMasterList();
+	void SortBodyState();
+
+	dgInt32 BuildBodyArray();
+	dgInt32 BuildJointGraph();
+	void InvalidateBodyArray();
+	void InvalidateJointGraph();
 
 	public:
+	// flat copy of the list for the per step loops, m_bodyArray has the bodies in list order without the sentinel 
+	// and each body has its graph index. the bilateral joints of row i are m_jointGraph[m_jointGraphStart[i]] to m_jointGraph[m_jointGraphStart[i + 1] - 1], 
+	// in row order, the sentinel row is the last one. contacts are not in the graph, they come and go every step and are 
+	// walked through the contact list, so the arrays are only rebuilt after bodies or bilateral joints are added, removed or reordered.
+	// joints can be created from callbacks on worker threads, so the graph is only rebuilt by the serial phases of the step 
+	// and readers walk the list while it is dirty
+	dgBodyStateTable m_bodyState;
+	dgArray<dgBody*> m_bodyArray;
+	dgArray<dgInt32> m_jointGraphStart;
+	dgArray<dgBodyMasterListCell> m_jointGraph;
 	dgTree<int, dgBody*> m_disableBodies;
 	dgUnsigned32 m_constraintCount;
+	dgInt32 m_bodyArrayIsDirty;
+	dgInt32 m_jointGraphIsDirty;
 };
 
+DG_INLINE void dgBodyMasterList::InvalidateJointGraph()
+{
+	dgInterlockedExchange(&m_jointGraphIsDirty, 1);
+}
+
+DG_INLINE void dgBodyMasterList::InvalidateBodyArray()
+{
+	dgInterlockedExchange(&m_bodyArrayIsDirty, 1);
+	InvalidateJointGraph();
+}
+
 #endif
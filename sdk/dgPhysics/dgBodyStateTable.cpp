@@ -0,0 +1,162 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+* 
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* 
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "dgPhysicsStdafx.h"
+#include "dgBody.h"
+#include "dgBodyStateTable.h"
+
+
+dgBodyStateTable::dgBodyStateTable (dgMemoryAllocator* const allocator)
+	:m_pages(allocator)
+	,m_freeSlots(allocator)
+	,m_scratchPage(NULL)
+	,m_allocator(allocator)
+	,m_pageCount(0)
+	,m_slotCount(0)
+	,m_freeCount(0)
+{
+	dgAssert (2 * DG_MAX_THREADS_HIVE_COUNT <= DG_BODY_STATE_PAGE_SIZE);
+	m_scratchPage = new (m_allocator) dgBodyStatePage;
+	memset (m_scratchPage->m_body, 0, sizeof (m_scratchPage->m_body));
+}
+
+dgBodyStateTable::~dgBodyStateTable ()
+{
+	dgAssert (m_slotCount == m_freeCount);
+	for (dgInt32 i = 0; i < m_pageCount; i ++) {
+		delete m_pages[i];
+	}
+	delete m_scratchPage;
+}
+
+dgInt32 dgBodyStateTable::GetSlotCount () const
+{
+	return m_slotCount;
+}
+
+dgBodyStatePage* dgBodyStateTable::AddPage ()
+{
+	dgBodyStatePage* const page = new (m_allocator) dgBodyStatePage;
+	memset (page->m_body, 0, sizeof (page->m_body));
+	m_pages[m_pageCount] = page;
+	m_pageCount ++;
+	return page;
+}
+
+void dgBodyStateTable::InitSlot (dgBodyStatePage* const page, dgInt32 slot, dgBody* const body) const
+{
+	page->m_matrix[slot] = dgGetIdentityMatrix();
+	page->m_veloc[slot] = dgVector::m_zero;
+	page->m_omega[slot] = dgVector::m_zero;
+	page->m_accel[slot] = dgVector::m_zero;
+	page->m_minAABB[slot] = dgVector::m_zero;
+	page->m_maxAABB[slot] = dgVector::m_zero;
+	page->m_body[slot] = body;
+}
+
+void dgBodyStateTable::AddBody (dgBody* const body)
+{
+	dgAssert (!body->m_statePage);
+	dgInt32 slot = m_slotCount;
+	if (m_freeCount) {
+		m_freeCount --;
+		slot = m_freeSlots[m_freeCount];
+	} else {
+		m_slotCount ++;
+		if ((slot >> DG_BODY_STATE_PAGE_BITS) == m_pageCount) {
+			AddPage();
+		}
+	}
+
+	dgBodyStatePage* const page = m_pages[slot >> DG_BODY_STATE_PAGE_BITS];
+	dgAssert (!page->m_body[slot & DG_BODY_STATE_PAGE_MASK]);
+	InitSlot (page, slot & DG_BODY_STATE_PAGE_MASK, body);
+	body->m_statePage = page;
+	body->m_stateIndex = slot;
+}
+
+void dgBodyStateTable::RemoveBody (dgBody* const body)
+{
+	dgBodyStatePage* const page = body->m_statePage;
+	const dgInt32 slot = body->m_stateIndex;
+	dgAssert (page == m_pages[slot >> DG_BODY_STATE_PAGE_BITS]);
+	dgAssert (page->m_body[slot & DG_BODY_STATE_PAGE_MASK] == body);
+
+	page->m_body[slot & DG_BODY_STATE_PAGE_MASK] = NULL;
+	m_freeSlots[m_freeCount] = slot;
+	m_freeCount ++;
+	body->m_statePage = NULL;
+	body->m_stateIndex = -1;
+}
+
+// the collision queries run on the caller thread, so each thread index has its own two slots
+void dgBodyStateTable::AttachScratchBody (dgBody* const body, dgInt32 threadIndex, dgInt32 index)
+{
+	dgAssert (!body->m_statePage);
+	dgAssert ((index >= 0) && (index < 2));
+	dgAssert ((threadIndex >= 0) && (threadIndex < DG_MAX_THREADS_HIVE_COUNT));
+	const dgInt32 slot = threadIndex * 2 + index;
+	InitSlot (m_scratchPage, slot, NULL);
+	body->m_statePage = m_scratchPage;
+	body->m_stateIndex = slot;
+}
+
+// lay the state out again in the order of the array, this also packs the free slots. 
+// the state is copied to new pages so that the old slots can be read while the new ones are written.
+void dgBodyStateTable::SortBodies (dgBody** const bodyArray, dgInt32 count)
+{
+	dgAssert (count == (m_slotCount - m_freeCount));
+	const dgInt32 pageCount = (count + DG_BODY_STATE_PAGE_SIZE - 1) >> DG_BODY_STATE_PAGE_BITS;
+	dgArray<dgBodyStatePage*> pages (m_allocator);
+	for (dgInt32 i = 0; i < pageCount; i ++) {
+		pages[i] = new (m_allocator) dgBodyStatePage;
+		memset (pages[i]->m_body, 0, sizeof (pages[i]->m_body));
+	}
+
+	for (dgInt32 i = 0; i < count; i ++) {
+		dgBody* const body = bodyArray[i];
+		const dgBodyStatePage* const src = body->m_statePage;
+		const dgInt32 srcSlot = body->m_stateIndex & DG_BODY_STATE_PAGE_MASK;
+		dgAssert (src->m_body[srcSlot] == body);
+
+		dgBodyStatePage* const dst = pages[i >> DG_BODY_STATE_PAGE_BITS];
+		const dgInt32 dstSlot = i & DG_BODY_STATE_PAGE_MASK;
+		dst->m_matrix[dstSlot] = src->m_matrix[srcSlot];
+		dst->m_veloc[dstSlot] = src->m_veloc[srcSlot];
+		dst->m_omega[dstSlot] = src->m_omega[srcSlot];
+		dst->m_accel[dstSlot] = src->m_accel[srcSlot];
+		dst->m_minAABB[dstSlot] = src->m_minAABB[srcSlot];
+		dst->m_maxAABB[dstSlot] = src->m_maxAABB[srcSlot];
+		dst->m_body[dstSlot] = body;
+		body->m_statePage = dst;
+		body->m_stateIndex = i;
+	}
+
+	for (dgInt32 i = 0; i < m_pageCount; i ++) {
+		delete m_pages[i];
+	}
+	for (dgInt32 i = 0; i < pageCount; i ++) {
+		m_pages[i] = pages[i];
+	}
+	m_pageCount = pageCount;
+	m_slotCount = count;
+	m_freeCount = 0;
+}
@@ -0,0 +1,87 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+* 
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* 
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef __DG_BODY_STATE_TABLE_H__
+#define __DG_BODY_STATE_TABLE_H__
+
+#include "dgPhysicsStdafx.h"
+
+class dgBody;
+
+#define DG_BODY_STATE_PAGE_BITS		8
+#define DG_BODY_STATE_PAGE_SIZE		(1<<DG_BODY_STATE_PAGE_BITS)
+#define DG_BODY_STATE_PAGE_MASK		(DG_BODY_STATE_PAGE_SIZE - 1)
+
+// one page of the body state table, each field of the integration and aabb state is a separate array
+DG_MSC_VECTOR_ALIGMENT
+class dgBodyStatePage
+{
+	public:
+	DG_CLASS_ALLOCATOR(allocator)
+
+	dgMatrix m_matrix[DG_BODY_STATE_PAGE_SIZE];
+	dgVector m_veloc[DG_BODY_STATE_PAGE_SIZE];
+	dgVector m_omega[DG_BODY_STATE_PAGE_SIZE];
+	dgVector m_accel[DG_BODY_STATE_PAGE_SIZE];
+	dgVector m_minAABB[DG_BODY_STATE_PAGE_SIZE];
+	dgVector m_maxAABB[DG_BODY_STATE_PAGE_SIZE];
+	dgBody* m_body[DG_BODY_STATE_PAGE_SIZE];
+} DG_GCC_VECTOR_ALIGMENT;
+
+// world owned table with the hot state of all bodies, each body keeps the page and the slot of its state.
+// adding or removing a body does not move the state of other bodies, free slots are reused before a new 
+// page is added. the master list lays the table out again in list order from the serial phases of the step, 
+// so the force, aabb, integration and transform loops walk the table front to back.
+// temporary bodies of the collision queries use the scratch page, two slots per thread index.
+class dgBodyStateTable
+{
+	public:
+	dgBodyStateTable (dgMemoryAllocator* const allocator);
+	~dgBodyStateTable ();
+
+	void AddBody (dgBody* const body);
+	void RemoveBody (dgBody* const body);
+	void AttachScratchBody (dgBody* const body, dgInt32 threadIndex, dgInt32 index);
+	void SortBodies (dgBody** const bodyArray, dgInt32 count);
+
+	dgInt32 GetSlotCount () const;
+	DG_INLINE dgBody* GetBody (dgInt32 slot) const;
+
+	private:
+	dgBodyStatePage* AddPage ();
+	void InitSlot (dgBodyStatePage* const page, dgInt32 slot, dgBody* const body) const;
+
+	dgArray<dgBodyStatePage*> m_pages;
+	dgArray<dgInt32> m_freeSlots;
+	dgBodyStatePage* m_scratchPage;
+	dgMemoryAllocator* m_allocator;
+	dgInt32 m_pageCount;
+	dgInt32 m_slotCount;
+	dgInt32 m_freeCount;
+};
+
+DG_INLINE dgBody* dgBodyStateTable::GetBody (dgInt32 slot) const
+{
+	dgAssert (slot < m_slotCount);
+	return m_pages[slot >> DG_BODY_STATE_PAGE_BITS]->m_body[slot & DG_BODY_STATE_PAGE_MASK];
+}
+
+#endif
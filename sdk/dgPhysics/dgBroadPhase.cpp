@@ -33,7 +33,6 @@
 #include "dgCollisionLumpedMassParticles.h"
 //#include "dgCollisionLumpedMassParticles.h"
 
-#define DG_CONVEX_CAST_POOLSIZE			32
 #define DG_BROADPHASE_AABB_SCALE		dgFloat32 (8.0f)
 #define DG_BROADPHASE_AABB_INV_SCALE	(dgFloat32 (1.0f) / DG_BROADPHASE_AABB_SCALE)
 #define DG_CONTACT_TRANSLATION_ERROR	dgFloat32 (1.0e-3f)
@@ -41,6 +40,12 @@
 #define DG_NARROW_PHASE_DIST			dgFloat32 (0.2f)
 #define DG_CONTACT_DELAY_FRAMES			4
 
+#define DG_BROADPHASE_BUILD_BINS				16
+#define DG_BROADPHASE_BUILD_MIN_TASK			256
+#define DG_BROADPHASE_BUILD_TASKS_PER_THREAD	4
+#define DG_BROADPHASE_BUILD_SEGMENT_GAP			6
+#define DG_BROADPHASE_BUILD_MAX_SEGMENTS		64
+
 //#define DG_USE_OLD_SCANNER
 
 dgVector dgBroadPhase::m_velocTol(dgFloat32(1.0e-16f)); 
@@ -152,6 +157,8 @@ dgBroadPhase::dgBroadPhase(dgWorld* const world)
 	,m_aggregateList(world->GetAllocator())
 	,m_lru(DG_CONTACT_DELAY_FRAMES)
 	,m_contactCache(world->GetAllocator())
+	,m_updateArray(world->GetAllocator())
+	,m_contactArray(world->GetAllocator())
 	,m_pendingSoftBodyCollisions(world->GetAllocator(), 64)
 	,m_pendingSoftBodyPairsCount(0)
 	,m_contacJointLock(0)
@@ -239,26 +246,24 @@ void dgBroadPhase::UpdateAggregateEntropyKernel(void* const context, void* const
 	broadPhase->UpdateAggregateEntropy(descriptor, (dgList<dgBroadPhaseAggregate*>::dgListNode*) node, threadID);
 }
 
-void dgBroadPhase::ForceAndToqueKernel(void* const context, void* const node, dgInt32 threadID)
+void dgBroadPhase::ForceAndToqueKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
-	broadPhase->ApplyForceAndtorque(descriptor, (dgBodyMasterList::dgListNode*) node, threadID);
+	broadPhase->ApplyForceAndtorque(descriptor, start, end, threadID);
 }
 
-void dgBroadPhase::SleepingStateKernel(void* const context, void* const node, dgInt32 threadID)
+void dgBroadPhase::SleepingStateKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
-	broadPhase->SleepingState(descriptor, (dgBodyMasterList::dgListNode*) node, threadID);
+	broadPhase->SleepingState(descriptor, start, end, threadID);
 }
 
-bool dgBroadPhase::DoNeedUpdate(dgBodyMasterList::dgListNode* const node) const
+bool dgBroadPhase::DoNeedUpdate(dgBody* const body) const
 {
-	dgBody* const body = node->GetInfo().GetBody();
-
 	bool state = body->GetInvMass().m_w != dgFloat32 (0.0f);
 	state = state || !body->m_equilibrium || (body->GetExtForceAndTorqueCallback() != NULL);
 	return state;
@@ -277,42 +282,37 @@ void dgBroadPhase::UpdateAggregateEntropy (dgBroadphaseSyncDescriptor* const des
 }
 
 
-void dgBroadPhase::ApplyForceAndtorque(dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID)
+void dgBroadPhase::ApplyForceAndtorque(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dgFloat32 timestep = descriptor->m_timestep;
 
-	const dgInt32 threadCount = m_world->GetThreadCount();
-	while (node) {
-		dgBody* const body = node->GetInfo().GetBody();
+	dgBody** const bodyArray = &m_world->m_bodyArray[0];
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBody* const body = bodyArray[i];
 		body->InitJointSet();
-		if (DoNeedUpdate(node)) {
+		if (DoNeedUpdate(body)) {
 			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
 				dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
 				dynamicBody->ApplyExtenalForces(timestep, threadID);
 			}
 		}
-
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			node = node ? node->GetNext() : NULL;
-		}
 	}
 }
 
-void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID)
+void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	DG_TRACKTIME(__FUNCTION__);
 	dgFloat32 timestep = descriptor->m_timestep;
 
-	const dgInt32 threadCount = m_world->GetThreadCount();
+	dgBody** const bodyArray = &m_world->m_bodyArray[0];
 	dgBodyInfo* const pendingBodies = &m_world->m_bodiesMemory[0];
 
 	dgInt32* const atomicBodiesCount = &descriptor->m_atomicDynamicsCount;
 	dgInt32* const atomicPendingBodiesCount = &descriptor->m_atomicPendingBodiesCount;
 
-	while (node) {
-		if (DoNeedUpdate(node)) {
-			dgBody* const body = node->GetInfo().GetBody();
-
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBody* const body = bodyArray[i];
+		if (DoNeedUpdate(body)) {
 			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
 				dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
 
@@ -363,10 +363,6 @@ void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, d
 				}
 			}
 		}
-
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			node = node ? node->GetNext() : NULL;
-		}
 	}
 }
 
@@ -380,7 +376,7 @@ void dgBroadPhase::ForEachBodyInAABB(const dgBroadPhaseNode** stackPool, dgInt32
 
 			dgBody* const body = rootNode->GetBody();
 			if (body) {
-				if (dgOverlapTest(body->m_minAABB, body->m_maxAABB, minBox, maxBox)) {
+				if (dgOverlapTest(body->GetStateMinAABB(), body->GetStateMaxAABB(), minBox, maxBox)) {
 					if (!callback(body, userData)) {
 						break;
 					}
@@ -442,7 +438,7 @@ dgInt32 dgBroadPhase::ConvexCast(const dgBroadPhaseNode** stackPool, dgFloat32*
 			dgBody* const body = me->GetBody();
 			if (body) {
 				if (!PREFILTER_RAYCAST(prefilter, body, body->m_collision, userData)) {
-					dgInt32 count = m_world->CollideContinue(shape, matrix, velocA, velocB, body->m_collision, body->m_matrix, velocB, velocB, timeToImpact, points, normals, penetration, attributeA, attributeB, maxContacts, threadIndex);
+					dgInt32 count = m_world->CollideContinue(shape, matrix, velocA, velocB, body->m_collision, body->GetStateMatrix(), velocB, velocB, timeToImpact, points, normals, penetration, attributeA, attributeB, maxContacts, threadIndex);
 
 					if (timeToImpact < maxParam) {
 						if ((timeToImpact - maxParam) < dgFloat32(-1.0e-3f)) {
@@ -554,7 +550,7 @@ dgInt32 dgBroadPhase::Collide(const dgBroadPhaseNode** stackPool, dgInt32* const
 			dgBody* const body = me->GetBody();
 			if (body) {
 				if (!PREFILTER_RAYCAST(prefilter, body, body->m_collision, userData)) {
-					dgInt32 count = m_world->Collide(shape, matrix, body->m_collision, body->m_matrix, points, normals, penetration, attributeA, attributeB, DG_CONVEX_CAST_POOLSIZE, threadIndex);
+					dgInt32 count = m_world->Collide(shape, matrix, body->m_collision, body->GetStateMatrix(), points, normals, penetration, attributeA, attributeB, DG_CONVEX_CAST_POOLSIZE, threadIndex);
 
 					if (count) {
 						bool teminate = false;
@@ -695,6 +691,217 @@ void dgBroadPhase::RayCast(const dgBroadPhaseNode** stackPool, dgFloat32* const
 	}
 }
 
+dgFloat32 dgApi dgBroadPhase::CastBatchRayFilter(const dgBody* const body, const dgCollisionInstance* const collision, const dgVector& contact, const dgVector& normal, dgInt64 collisionID, void* const userData, dgFloat32 intersetParam)
+{
+	dgCastBatchRay* const ray = (dgCastBatchRay*)userData;
+	dgCastBatchHit& hit = *ray->m_hit;
+	if (intersetParam < hit.m_param) {
+		for (dgInt32 i = 0; i < 3; i ++) {
+			hit.m_point[i] = contact[i];
+			hit.m_normal[i] = normal[i];
+		}
+		hit.m_contactID = collisionID;
+		hit.m_hitBody = body;
+		hit.m_param = intersetParam;
+	}
+	return hit.m_param;
+}
+
+dgUnsigned32 dgApi dgBroadPhase::CastBatchRayPrefilter(const dgBody* const body, const dgCollisionInstance* const collision, void* const userData)
+{
+	const dgCastBatchRay* const ray = (dgCastBatchRay*)userData;
+	return ray->m_descriptor->m_prefilter(body, collision, ray->m_descriptor->m_userData);
+}
+
+void dgBroadPhase::SetCastBatchHit(dgCastBatchHit& hit, const dgConvexCastReturnInfo& info, dgFloat32 param)
+{
+	for (dgInt32 i = 0; i < 3; i ++) {
+		hit.m_point[i] = info.m_point[i];
+		hit.m_normal[i] = info.m_normal[i];
+	}
+	hit.m_contactID = info.m_contaID;
+	hit.m_hitBody = info.m_hitBody;
+	hit.m_param = param;
+}
+
+void dgBroadPhase::InitCastPacket(const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 first) const
+{
+	const dgInt32 count = dgMin(dgInt32(4), descriptor->m_count - first);
+	dgAssert(count > 0);
+
+	dgFloat32 lo[3][4];
+	dgFloat32 hi[3][4];
+	dgFloat32 invDir[3][4];
+	packet.m_hits = &descriptor->m_hits[first];
+	packet.m_activeMask = 0;
+	for (dgInt32 i = 0; i < 4; i ++) {
+		// the unused lanes repeat the last query and stay masked out
+		const dgInt32 index = first + dgMin(i, count - 1);
+		const dgFloat32* const origin = &descriptor->m_origin[index * descriptor->m_originStride];
+		const dgFloat32* const target = &descriptor->m_target[index * descriptor->m_targetStride];
+
+		dgVector p0;
+		dgVector boxP0;
+		dgVector boxP1;
+		const dgVector p1(target[0], target[1], target[2], dgFloat32(0.0f));
+		if (descriptor->m_shape) {
+			packet.m_matrix[i] = dgMatrix(origin);
+			p0 = packet.m_matrix[i].m_posit & dgVector::m_triplexMask;
+			descriptor->m_shape->CalcAABB(packet.m_matrix[i], boxP0, boxP1);
+		} else {
+			p0 = dgVector(origin[0], origin[1], origin[2], dgFloat32(0.0f));
+			boxP0 = p0;
+			boxP1 = p0;
+			dgLineBox& line = packet.m_line[i];
+			line.m_l0 = p0;
+			line.m_l1 = p1;
+			dgVector test(line.m_l0 <= line.m_l1);
+			line.m_boxL0 = (line.m_l0 & test) | line.m_l1.AndNot(test);
+			line.m_boxL1 = (line.m_l1 & test) | line.m_l0.AndNot(test);
+		}
+		packet.m_target[i] = p1;
+		packet.m_veloc[i] = (p1 - p0) & dgVector::m_triplexMask;
+
+		for (dgInt32 j = 0; j < 3; j ++) {
+			const dgFloat32 dir = packet.m_veloc[i][j];
+			lo[j][i] = boxP0[j];
+			hi[j][i] = boxP1[j];
+			invDir[j][i] = (dgAbs(dir) > dgFloat32(1.0e-12f)) ? dgFloat32(1.0f) / dir : dgFloat32(1.0e30f);
+		}
+
+		if (i < count) {
+			dgCastBatchHit& hit = packet.m_hits[i];
+			memset(&hit, 0, sizeof(dgCastBatchHit));
+			hit.m_param = dgFloat32(1.0f);
+			// degenerated rays hit nothing, degenerated casts still report overlaps
+			const dgFloat32 length2 = packet.m_veloc[i].DotProduct(packet.m_veloc[i]).GetScalar();
+			if (descriptor->m_shape || (length2 > dgFloat32(1.0e-8f))) {
+				packet.m_activeMask |= 1 << i;
+			}
+		}
+	}
+
+	for (dgInt32 j = 0; j < 3; j ++) {
+		packet.m_lo[j] = dgVector(lo[j][0], lo[j][1], lo[j][2], lo[j][3]);
+		packet.m_hi[j] = dgVector(hi[j][0], hi[j][1], hi[j][2], hi[j][3]);
+		packet.m_invDir[j] = dgVector(invDir[j][0], invDir[j][1], invDir[j][2], invDir[j][3]);
+	}
+	packet.m_maxParam = dgVector::m_one;
+}
+
+void dgBroadPhase::CastPacketLane(const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 lane, const dgBroadPhaseNode* const node, dgFloat32 dist, dgInt32 threadID) const
+{
+	// one query continues alone from a leaf or a subtree, with the same sorted walk as the single queries
+	const dgBroadPhaseNode* stackPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+	dgFloat32 distance[DG_BROADPHASE_MAX_STACK_DEPTH];
+	stackPool[0] = node;
+	distance[0] = dist;
+
+	dgCastBatchHit& hit = packet.m_hits[lane];
+	if (descriptor->m_shape) {
+		dgConvexCastReturnInfo info;
+		dgFloat32 param = hit.m_param;
+		dgFastRayTest ray(dgVector::m_zero, packet.m_veloc[lane]);
+		const dgInt32 count = dgBroadPhase::ConvexCast(stackPool, distance, 1, packet.m_veloc[lane], dgVector::m_zero, ray, descriptor->m_shape, packet.m_matrix[lane], packet.m_target[lane], &param, descriptor->m_prefilter, descriptor->m_userData, &info, 1, threadID);
+		if (count && (param < hit.m_param)) {
+			SetCastBatchHit(hit, info, param);
+		}
+	} else {
+		dgCastBatchRay ray;
+		ray.m_descriptor = descriptor;
+		ray.m_hit = &hit;
+		const dgLineBox& line = packet.m_line[lane];
+		OnRayPrecastAction prefilter = descriptor->m_prefilter ? CastBatchRayPrefilter : NULL;
+		dgBody* const body = node->GetBody();
+		if (body) {
+			body->RayCast(line, CastBatchRayFilter, prefilter, &ray, hit.m_param);
+		} else {
+			dgFastRayTest fastRay(line.m_l0, line.m_l1);
+			dgBroadPhase::RayCast(stackPool, distance, 1, line.m_l0, line.m_l1, fastRay, CastBatchRayFilter, prefilter, &ray);
+		}
+	}
+	packet.m_maxParam[lane] = hit.m_param;
+}
+
+void dgBroadPhase::CastPacket(const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 threadID) const
+{
+	// broad phases without a packet traversal run each query on its own
+	for (dgInt32 i = 0; i < 4; i ++) {
+		if (packet.m_activeMask & (1 << i)) {
+			dgCastBatchHit& hit = packet.m_hits[i];
+			if (descriptor->m_shape) {
+				dgConvexCastReturnInfo info;
+				dgFloat32 param = hit.m_param;
+				const dgInt32 count = ConvexCast(descriptor->m_shape, packet.m_matrix[i], packet.m_target[i], &param, descriptor->m_prefilter, descriptor->m_userData, &info, 1, threadID);
+				if (count && (param < hit.m_param)) {
+					SetCastBatchHit(hit, info, param);
+				}
+			} else {
+				dgCastBatchRay ray;
+				ray.m_descriptor = descriptor;
+				ray.m_hit = &hit;
+				const dgLineBox& line = packet.m_line[i];
+				RayCast(line.m_l0, line.m_l1, CastBatchRayFilter, descriptor->m_prefilter ? CastBatchRayPrefilter : NULL, &ray);
+			}
+		}
+	}
+}
+
+void dgBroadPhase::CastBatchKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	const dgCastBatchDescriptor* const descriptor = (dgCastBatchDescriptor*)context;
+	const dgBroadPhase* const broadPhase = descriptor->m_broadPhase;
+	for (dgInt32 i = start; i < end; i ++) {
+		dgCastPacket packet;
+		broadPhase->InitCastPacket(descriptor, packet, i * 4);
+		broadPhase->CastPacket(descriptor, packet, threadID);
+	}
+}
+
+void dgBroadPhase::CastBatch(dgCastBatchDescriptor* const descriptor, const char* const name) const
+{
+	// consecutive queries share a packet, so coherent queries should be next to each other
+	const dgInt32 packetCount = (descriptor->m_count + 3) >> 2;
+	if (packetCount) {
+		m_world->ParallelFor(0, packetCount, DG_PARALLEL_CAST_GRAIN_SIZE, CastBatchKernel, descriptor, name);
+	}
+}
+
+void dgBroadPhase::RayCastBatch(const dgFloat32* const p0, const dgFloat32* const p1, dgInt32 strideInBytes, dgInt32 count, OnRayPrecastAction prefilter, void* const userData, dgCastBatchHit* const hits) const
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgCastBatchDescriptor descriptor;
+	descriptor.m_broadPhase = this;
+	descriptor.m_origin = p0;
+	descriptor.m_target = p1;
+	descriptor.m_shape = NULL;
+	descriptor.m_prefilter = prefilter;
+	descriptor.m_userData = userData;
+	descriptor.m_hits = hits;
+	descriptor.m_originStride = strideInBytes / sizeof(dgFloat32);
+	descriptor.m_targetStride = strideInBytes / sizeof(dgFloat32);
+	descriptor.m_count = count;
+	CastBatch(&descriptor, "dgBroadPhase::RayCastBatch");
+}
+
+void dgBroadPhase::ConvexCastBatch(dgCollisionInstance* const shape, const dgFloat32* const matrices, const dgFloat32* const targets, dgInt32 strideInBytes, dgInt32 count, OnRayPrecastAction prefilter, void* const userData, dgCastBatchHit* const hits) const
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgCastBatchDescriptor descriptor;
+	descriptor.m_broadPhase = this;
+	descriptor.m_origin = matrices;
+	descriptor.m_target = targets;
+	descriptor.m_shape = shape;
+	descriptor.m_prefilter = prefilter;
+	descriptor.m_userData = userData;
+	descriptor.m_hits = hits;
+	descriptor.m_originStride = 16;
+	descriptor.m_targetStride = strideInBytes / sizeof(dgFloat32);
+	descriptor.m_count = count;
+	CastBatch(&descriptor, "dgBroadPhase::ConvexCastBatch");
+}
+
 void dgBroadPhase::CollisionChange (dgBody* const body, dgCollisionInstance* const collision)
 {
 	dgCollisionInstance* const bodyCollision = body->GetCollision();
@@ -727,9 +934,9 @@ void dgBroadPhase::UpdateBody(dgBody* const body, dgInt32 threadIndex)
 			aggregate->m_isInEquilibrium = body1->m_equilibrium;
 		}
 		
-		if (!dgBoxInclusionTest(body1->m_minAABB, body1->m_maxAABB, node->m_minBox, node->m_maxBox)) {
+		if (!dgBoxInclusionTest(body1->GetStateMinAABB(), body1->GetStateMaxAABB(), node->m_minBox, node->m_maxBox)) {
 			dgAssert(!node->IsAggregate());
-			node->SetAABB(body1->m_minAABB, body1->m_maxAABB);
+			node->SetAABB(body1->GetStateMinAABB(), body1->GetStateMaxAABB());
 
 			const dgBroadPhaseNode* const root = (m_rootNode->GetLeft() && m_rootNode->GetRight()) ? NULL : m_rootNode;
 			for (dgBroadPhaseNode* parent = node->m_parent; parent != root; parent = parent->m_parent) {
@@ -756,6 +963,338 @@ void dgBroadPhase::UpdateBody(dgBody* const body, dgInt32 threadIndex)
 }
 
 
+DG_INLINE dgInt32 dgBroadPhase::GetAreaBucket(dgFloat32 area)
+{
+	// the bucket is the binary exponent of the area, so two buckets apart is at least a factor of two 
+	dgDoubleInt value;
+	value.m_float = area;
+	const dgInt32 exponent = ((value.m_intH >> 20) & 0x7ff) - 1023 + 128;
+	return dgClamp (exponent, 0, 255);
+}
+
+DG_INLINE dgInt32 dgBroadPhaseMortonSpread(dgInt32 x)
+{
+	x = (x | (x << 8)) & 0x0300f00f;
+	x = (x | (x << 4)) & 0x030c30c3;
+	x = (x | (x << 2)) & 0x09249249;
+	return x;
+}
+
+dgInt32 dgBroadPhase::GetBuildLeafKey(const dgBuildLeaf* const leaf, void* const)
+{
+	return leaf->m_key;
+}
+
+void dgBroadPhase::BuildBoundsKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	dgBuildDescriptor* const descriptor = (dgBuildDescriptor*)context;
+	dgBroadPhaseNode** const leafArray = descriptor->m_leafArray;
+	dgInt32* const histogram = descriptor->m_histogram[threadID];
+
+	dgVector centerMin (descriptor->m_centerMin[threadID]);
+	dgVector centerMax (descriptor->m_centerMax[threadID]);
+	for (dgInt32 i = start; i < end; i ++) {
+		const dgBroadPhaseNode* const node = leafArray[i];
+		const dgVector center (node->m_minBox + node->m_maxBox);
+		centerMin = centerMin.GetMin(center);
+		centerMax = centerMax.GetMax(center);
+		histogram[GetAreaBucket(node->m_surfaceArea)] ++;
+	}
+	descriptor->m_centerMin[threadID] = centerMin;
+	descriptor->m_centerMax[threadID] = centerMax;
+}
+
+void dgBroadPhase::BuildKeysKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	dgBuildDescriptor* const descriptor = (dgBuildDescriptor*)context;
+	dgBroadPhaseNode** const leafArray = descriptor->m_leafArray;
+	dgBuildLeaf* const sortArray = descriptor->m_sortArray;
+	const dgInt32* const segment = descriptor->m_segment;
+	const dgVector origin (descriptor->m_origin);
+	const dgVector scale (descriptor->m_scale);
+	const dgInt32 segmentShift = descriptor->m_segmentShift;
+
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBroadPhaseNode* const node = leafArray[i];
+		const dgVector cell ((node->m_minBox + node->m_maxBox - origin) * scale);
+		const dgInt32 x = dgClamp (dgInt32 (cell.m_x), 0, 255);
+		const dgInt32 y = dgClamp (dgInt32 (cell.m_y), 0, 255);
+		const dgInt32 z = dgClamp (dgInt32 (cell.m_z), 0, 255);
+		const dgInt32 code = (dgBroadPhaseMortonSpread(x) << 2) | (dgBroadPhaseMortonSpread(y) << 1) | dgBroadPhaseMortonSpread(z);
+		sortArray[i].m_node = node;
+		sortArray[i].m_key = (segment[GetAreaBucket(node->m_surfaceArea)] << segmentShift) | code;
+	}
+}
+
+void dgBroadPhase::BuildBoxesKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	dgBuildDescriptor* const descriptor = (dgBuildDescriptor*)context;
+	const dgBuildLeaf* const sortArray = descriptor->m_sortArray;
+	dgBroadPhaseNode** const leafArray = descriptor->m_leafArray;
+	dgBuildBox* const boxArray = descriptor->m_boxArray;
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBroadPhaseNode* const node = sortArray ? sortArray[i].m_node : leafArray[i];
+		boxArray[i].m_minBox = node->m_minBox;
+		boxArray[i].m_maxBox = node->m_maxBox;
+		boxArray[i].m_node = node;
+	}
+}
+
+void dgBroadPhase::BuildSubtreeKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	dgBuildDescriptor* const descriptor = (dgBuildDescriptor*)context;
+	for (dgInt32 i = start; i < end; i ++) {
+		const dgBuildRange& task = descriptor->m_tasks[i];
+		BuildBinnedTree(&descriptor->m_boxArray[task.m_first], task.m_count, &descriptor->m_nodeArray[task.m_nodeIndex]);
+	}
+}
+
+dgInt32 dgBroadPhase::SplitMortonRange(const dgBuildLeaf* const sortArray, dgInt32 count)
+{
+	const dgInt32 diff = sortArray[0].m_key ^ sortArray[count - 1].m_key;
+	if (!diff) {
+		return count >> 1;
+	}
+
+	// split where the highest differing bit of the sorted keys flips
+	dgInt32 mask = 1 << 30;
+	while (!(diff & mask)) {
+		mask >>= 1;
+	}
+
+	dgInt32 i0 = 0;
+	dgInt32 i1 = count - 1;
+	while (i0 < i1) {
+		const dgInt32 middle = (i0 + i1) >> 1;
+		if (sortArray[middle].m_key & mask) {
+			i1 = middle;
+		} else {
+			i0 = middle + 1;
+		}
+	}
+	dgAssert(i0 > 0);
+	dgAssert(i0 < count);
+	return i0;
+}
+
+// builds the subtree of a leaf range with a binned surface area heuristic, the tree nodes are 
+// taken in pre order from nodeArray so the range of every subtree is known before it is built.
+dgBroadPhaseNode* dgBroadPhase::BuildBinnedTree(dgBuildBox* const boxArray, dgInt32 leafCount, dgBroadPhaseTreeNode** const nodeArray)
+{
+	if (leafCount == 1) {
+		return boxArray[0].m_node;
+	}
+
+	DG_MSC_VECTOR_ALIGMENT
+	class dgBinnedRange
+	{
+		public:
+		void CalculateBounds(const dgBuildBox* const boxes)
+		{
+			m_minBox = dgVector (dgFloat32 (1.0e15f));
+			m_maxBox = dgVector (dgFloat32 (-1.0e15f));
+			m_centerMin = m_minBox;
+			m_centerMax = m_maxBox;
+			for (dgInt32 i = 0; i < m_count; i ++) {
+				const dgBuildBox& box = boxes[m_first + i];
+				const dgVector center (box.m_minBox + box.m_maxBox);
+				m_minBox = m_minBox.GetMin(box.m_minBox);
+				m_maxBox = m_maxBox.GetMax(box.m_maxBox);
+				m_centerMin = m_centerMin.GetMin(center);
+				m_centerMax = m_centerMax.GetMax(center);
+			}
+		}
+
+		dgVector m_minBox;
+		dgVector m_maxBox;
+		dgVector m_centerMin;
+		dgVector m_centerMax;
+		dgInt32 m_first;
+		dgInt32 m_count;
+		dgInt32 m_nodeIndex;
+	} DG_GCC_VECTOR_ALIGMENT;
+
+	dgBinnedRange stack[DG_BROADPHASE_MAX_STACK_DEPTH];
+	stack[0].m_first = 0;
+	stack[0].m_count = leafCount;
+	stack[0].m_nodeIndex = 0;
+	stack[0].CalculateBounds(boxArray);
+	dgInt32 stackIndex = 1;
+
+	while (stackIndex) {
+		stackIndex --;
+		const dgBinnedRange range (stack[stackIndex]);
+		dgBuildBox* const boxes = &boxArray[range.m_first];
+		const dgInt32 count = range.m_count;
+
+		dgBinnedRange left;
+		dgBinnedRange right;
+		dgInt32 leftCount = 0;
+		if (count > 2) {
+			// small ranges get fewer bins, or clearing and sweeping the bins would cost more than the binning 
+			const dgInt32 binsCount = dgMin (count, DG_BROADPHASE_BUILD_BINS);
+			dgVector scale (dgFloat32 (0.0f));
+			const dgVector extend (range.m_centerMax - range.m_centerMin);
+			for (dgInt32 axis = 0; axis < 3; axis ++) {
+				if (extend[axis] > dgFloat32 (1.0e-6f)) {
+					scale[axis] = dgFloat32 (binsCount) * dgFloat32 (0.999f) / extend[axis];
+				}
+			}
+
+			dgVector binMin[3][DG_BROADPHASE_BUILD_BINS];
+			dgVector binMax[3][DG_BROADPHASE_BUILD_BINS];
+			dgInt32 binCount[3][DG_BROADPHASE_BUILD_BINS];
+			for (dgInt32 axis = 0; axis < 3; axis ++) {
+				for (dgInt32 j = 0; j < binsCount; j ++) {
+					binMin[axis][j] = dgVector (dgFloat32 (1.0e15f));
+					binMax[axis][j] = dgVector (dgFloat32 (-1.0e15f));
+					binCount[axis][j] = 0;
+				}
+			}
+
+			for (dgInt32 i = 0; i < count; i ++) {
+				const dgBuildBox& box = boxes[i];
+				const dgVector bin ((box.m_minBox + box.m_maxBox - range.m_centerMin) * scale);
+				for (dgInt32 axis = 0; axis < 3; axis ++) {
+					const dgInt32 j = dgInt32 (bin[axis]);
+					dgAssert(j >= 0);
+					dgAssert(j < binsCount);
+					binMin[axis][j] = binMin[axis][j].GetMin(box.m_minBox);
+					binMax[axis][j] = binMax[axis][j].GetMax(box.m_maxBox);
+					binCount[axis][j] ++;
+				}
+			}
+
+			dgInt32 bestAxis = -1;
+			dgInt32 bestBin = 0;
+			dgFloat32 bestCost = dgFloat32 (1.0e30f);
+			for (dgInt32 axis = 0; axis < 3; axis ++) {
+				if (scale[axis] > dgFloat32 (0.0f)) {
+					dgVector rightMin[DG_BROADPHASE_BUILD_BINS];
+					dgVector rightMax[DG_BROADPHASE_BUILD_BINS];
+					dgFloat32 rightArea[DG_BROADPHASE_BUILD_BINS];
+					dgInt32 rightCount[DG_BROADPHASE_BUILD_BINS];
+					dgVector boxP0 (dgFloat32 (1.0e15f));
+					dgVector boxP1 (dgFloat32 (-1.0e15f));
+					dgInt32 sum = 0;
+					for (dgInt32 j = binsCount - 1; j > 0; j --) {
+						boxP0 = boxP0.GetMin(binMin[axis][j]);
+						boxP1 = boxP1.GetMax(binMax[axis][j]);
+						sum += binCount[axis][j];
+						const dgVector side (boxP1 - boxP0);
+						rightMin[j] = boxP0;
+						rightMax[j] = boxP1;
+						rightArea[j] = sum ? side.DotProduct(side.ShiftTripleRight()).GetScalar() : dgFloat32 (0.0f);
+						rightCount[j] = sum;
+					}
+
+					boxP0 = dgVector (dgFloat32 (1.0e15f));
+					boxP1 = dgVector (dgFloat32 (-1.0e15f));
+					sum = 0;
+					for (dgInt32 j = 0; j < binsCount - 1; j ++) {
+						boxP0 = boxP0.GetMin(binMin[axis][j]);
+						boxP1 = boxP1.GetMax(binMax[axis][j]);
+						sum += binCount[axis][j];
+						if (sum && rightCount[j + 1]) {
+							const dgVector side (boxP1 - boxP0);
+							const dgFloat32 cost = side.DotProduct(side.ShiftTripleRight()).GetScalar() * dgFloat32 (sum) + rightArea[j + 1] * dgFloat32 (rightCount[j + 1]);
+							if (cost < bestCost) {
+								bestCost = cost;
+								bestAxis = axis;
+								bestBin = j;
+								left.m_minBox = boxP0;
+								left.m_maxBox = boxP1;
+								right.m_minBox = rightMin[j + 1];
+								right.m_maxBox = rightMax[j + 1];
+							}
+						}
+					}
+				}
+			}
+
+			if (bestAxis >= 0) {
+				// the children centers bounds are collected while partitioning
+				left.m_centerMin = dgVector (dgFloat32 (1.0e15f));
+				left.m_centerMax = dgVector (dgFloat32 (-1.0e15f));
+				right.m_centerMin = left.m_centerMin;
+				right.m_centerMax = left.m_centerMax;
+
+				const dgFloat32 origin = range.m_centerMin[bestAxis];
+				const dgFloat32 axisScale = scale[bestAxis];
+				dgInt32 i0 = 0;
+				dgInt32 i1 = count - 1;
+				while (i0 <= i1) {
+					const dgVector center (boxes[i0].m_minBox + boxes[i0].m_maxBox);
+					const dgInt32 j = dgInt32 ((center[bestAxis] - origin) * axisScale);
+					if (j <= bestBin) {
+						left.m_centerMin = left.m_centerMin.GetMin(center);
+						left.m_centerMax = left.m_centerMax.GetMax(center);
+						i0 ++;
+					} else {
+						right.m_centerMin = right.m_centerMin.GetMin(center);
+						right.m_centerMax = right.m_centerMax.GetMax(center);
+						dgSwap(boxes[i0], boxes[i1]);
+						i1 --;
+					}
+				}
+				dgAssert(i0 > 0);
+				dgAssert(i0 < count);
+				leftCount = i0;
+			}
+		}
+
+		const bool binned = leftCount ? true : false;
+		if (!binned) {
+			// two leaves, or all the centers are at the same spot
+			leftCount = count >> 1;
+		}
+		left.m_first = range.m_first;
+		left.m_count = leftCount;
+		left.m_nodeIndex = range.m_nodeIndex + 1;
+		right.m_first = range.m_first + leftCount;
+		right.m_count = count - leftCount;
+		right.m_nodeIndex = range.m_nodeIndex + leftCount;
+		if (!binned) {
+			if (left.m_count > 1) {
+				left.CalculateBounds(boxArray);
+			}
+			if (right.m_count > 1) {
+				right.CalculateBounds(boxArray);
+			}
+		}
+
+		dgBroadPhaseTreeNode* const parent = nodeArray[range.m_nodeIndex];
+		parent->SetAABB(range.m_minBox, range.m_maxBox);
+		parent->m_left = (left.m_count == 1) ? boxes[0].m_node : nodeArray[left.m_nodeIndex];
+		parent->m_right = (right.m_count == 1) ? boxes[leftCount].m_node : nodeArray[right.m_nodeIndex];
+		parent->m_left->m_parent = parent;
+		parent->m_right->m_parent = parent;
+
+		// the smaller side is popped first so the stack never gets deeper than the log of the leaf count
+		if (left.m_count > right.m_count) {
+			if (left.m_count > 1) {
+				stack[stackIndex] = left;
+				stackIndex ++;
+			}
+			if (right.m_count > 1) {
+				stack[stackIndex] = right;
+				stackIndex ++;
+			}
+		} else {
+			if (right.m_count > 1) {
+				stack[stackIndex] = right;
+				stackIndex ++;
+			}
+			if (left.m_count > 1) {
+				stack[stackIndex] = left;
+				stackIndex ++;
+			}
+		}
+		dgAssert(stackIndex < dgInt32 (sizeof (stack) / sizeof (stack[0])));
+	}
+	return nodeArray[0];
+}
+
 dgBroadPhaseNode* dgBroadPhase::BuildTopDown(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgFitnessList::dgListNode** const nextNode)
 {
 	dgAssert(firstBox >= 0);
@@ -839,6 +1378,191 @@ dgInt32 dgBroadPhase::CompareNodes(const dgBroadPhaseNode* const nodeA, const dg
 }
 
 
+// rebuilds a tree from its leaves reusing the tree nodes in nodeArray, there must be exactly leafCount - 1 of them.
+// the leaves are presorted along a morton curve and the top levels are split at the morton code boundaries 
+// until the ranges are small enough to go around the threads, each range is then built with the binned 
+// surface area heuristic. leaves much bigger than the rest are built into separate subtrees, 
+// which are joined at the root biggest last, the same way the old builder peeled them off.
+dgBroadPhaseNode* dgBroadPhase::BuildTree(dgBroadPhaseNode** const leafArray, dgInt32 leafCount, dgBroadPhaseTreeNode** const nodeArray, dgInt32 threadIndex, bool parallel)
+{
+	if (leafCount == 1) {
+		leafArray[0]->m_parent = NULL;
+		return leafArray[0];
+	}
+
+	DG_TRACKTIME(__FUNCTION__);
+	dgFrameArena& arena = m_world->m_frameArena;
+	dgFrameArenaScope scratchScope (arena, threadIndex);
+	dgBuildBox* const boxArray = dgFrameAlloca(arena, dgBuildBox, leafCount, threadIndex);
+
+	const dgInt32 threadCount = parallel ? m_world->GetThreadCount() : 1;
+
+	dgBuildDescriptor descriptor;
+	descriptor.m_leafArray = leafArray;
+	descriptor.m_nodeArray = nodeArray;
+	descriptor.m_sortArray = NULL;
+	descriptor.m_boxArray = boxArray;
+	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		descriptor.m_centerMin[i] = dgVector (dgFloat32 (1.0e15f));
+		descriptor.m_centerMax[i] = dgVector (dgFloat32 (-1.0e15f));
+	}
+	memset (descriptor.m_histogram, 0, sizeof (descriptor.m_histogram));
+
+	if (parallel) {
+		m_world->ParallelFor(0, leafCount, 0, BuildBoundsKernel, &descriptor, "dgBroadPhase::BuildBounds");
+	} else {
+		BuildBoundsKernel(&descriptor, 0, leafCount, threadIndex);
+	}
+
+	dgVector centerMin (descriptor.m_centerMin[0]);
+	dgVector centerMax (descriptor.m_centerMax[0]);
+	for (dgInt32 i = 1; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		centerMin = centerMin.GetMin(descriptor.m_centerMin[i]);
+		centerMax = centerMax.GetMax(descriptor.m_centerMax[i]);
+		for (dgInt32 j = 0; j < 256; j ++) {
+			descriptor.m_histogram[0][j] += descriptor.m_histogram[i][j];
+		}
+	}
+
+	// a bucket more than DG_BROADPHASE_BUILD_SEGMENT_GAP above the previous one starts a segment of leaves at least 64 times bigger
+	dgInt32 segmentCount = 0;
+	dgInt32 lastBucket = 0;
+	for (dgInt32 i = 0; i < 256; i ++) {
+		if (descriptor.m_histogram[0][i]) {
+			if (!segmentCount || (((i - lastBucket) > DG_BROADPHASE_BUILD_SEGMENT_GAP) && (segmentCount < DG_BROADPHASE_BUILD_MAX_SEGMENTS))) {
+				segmentCount ++;
+			}
+			lastBucket = i;
+		}
+		descriptor.m_segment[i] = dgMax (segmentCount - 1, 0);
+	}
+
+	const dgInt32 taskSize = (threadCount > 1) ? dgMax (leafCount / (threadCount * DG_BROADPHASE_BUILD_TASKS_PER_THREAD), DG_BROADPHASE_BUILD_MIN_TASK) : leafCount;
+	const bool mortonOrder = taskSize < leafCount;
+	const dgInt32 maxTasks = mortonOrder ? leafCount : segmentCount;
+	dgBuildRange* const tasks = dgFrameAlloca(arena, dgBuildRange, maxTasks, threadIndex);
+	dgBuildRange* const topNodes = dgFrameAlloca(arena, dgBuildRange, maxTasks, threadIndex);
+	descriptor.m_tasks = tasks;
+
+	dgBuildLeaf* sortArray = NULL;
+	if (mortonOrder || (segmentCount > 1)) {
+		// the leaves are grouped by segment, and sorted along a morton curve only when the top levels are split across threads 
+		dgVector scale (dgFloat32 (0.0f));
+		const dgVector extend (centerMax - centerMin);
+		for (dgInt32 axis = 0; axis < 3; axis ++) {
+			if (mortonOrder && (extend[axis] > dgFloat32 (1.0e-6f))) {
+				scale[axis] = dgFloat32 (255.9f) / extend[axis];
+			}
+		}
+		descriptor.m_origin = centerMin;
+		descriptor.m_scale = scale;
+		descriptor.m_segmentShift = mortonOrder ? 24 : 0;
+		sortArray = dgFrameAlloca(arena, dgBuildLeaf, leafCount * 2, threadIndex);
+		descriptor.m_sortArray = sortArray;
+
+		if (parallel) {
+			m_world->ParallelFor(0, leafCount, 0, BuildKeysKernel, &descriptor, "dgBroadPhase::BuildKeys");
+		} else {
+			BuildKeysKernel(&descriptor, 0, leafCount, threadIndex);
+		}
+		dgRadixSort(sortArray, &sortArray[leafCount], leafCount, mortonOrder ? ((segmentCount > 1) ? 4 : 3) : 1, GetBuildLeafKey);
+	}
+
+	// the builder works on a copy of the leaf boxes
+	if (parallel) {
+		m_world->ParallelFor(0, leafCount, 0, BuildBoxesKernel, &descriptor, "dgBroadPhase::BuildBoxes");
+	} else {
+		BuildBoxesKernel(&descriptor, 0, leafCount, threadIndex);
+	}
+
+	dgBuildRange segments[DG_BROADPHASE_BUILD_MAX_SEGMENTS];
+	dgInt32 nodeIndex = 0;
+	dgInt32 taskCount = 0;
+	dgInt32 topCount = 0;
+	dgInt32 segment = 0;
+	for (dgInt32 first = 0; first < leafCount; segment ++) {
+		dgInt32 count = leafCount - first;
+		if (sortArray) {
+			const dgInt32 key = sortArray[first].m_key >> descriptor.m_segmentShift;
+			count = 1;
+			while (((first + count) < leafCount) && ((sortArray[first + count].m_key >> descriptor.m_segmentShift) == key)) {
+				count ++;
+			}
+		}
+		segments[segment].m_first = first;
+		segments[segment].m_count = count;
+		segments[segment].m_nodeIndex = nodeIndex;
+
+		dgBuildRange stack[DG_BROADPHASE_MAX_STACK_DEPTH];
+		stack[0] = segments[segment];
+		dgInt32 stackIndex = (count > 1) ? 1 : 0;
+		while (stackIndex) {
+			stackIndex --;
+			const dgBuildRange range (stack[stackIndex]);
+			if (range.m_count <= taskSize) {
+				tasks[taskCount] = range;
+				taskCount ++;
+			} else {
+				const dgInt32 leftCount = SplitMortonRange(&sortArray[range.m_first], range.m_count);
+				const dgInt32 rightCount = range.m_count - leftCount;
+				dgBroadPhaseTreeNode* const parent = nodeArray[range.m_nodeIndex];
+				parent->m_left = (leftCount == 1) ? boxArray[range.m_first].m_node : nodeArray[range.m_nodeIndex + 1];
+				parent->m_right = (rightCount == 1) ? boxArray[range.m_first + leftCount].m_node : nodeArray[range.m_nodeIndex + leftCount];
+				parent->m_left->m_parent = parent;
+				parent->m_right->m_parent = parent;
+				topNodes[topCount] = range;
+				topCount ++;
+
+				if (leftCount > 1) {
+					stack[stackIndex].m_first = range.m_first;
+					stack[stackIndex].m_count = leftCount;
+					stack[stackIndex].m_nodeIndex = range.m_nodeIndex + 1;
+					stackIndex ++;
+				}
+				if (rightCount > 1) {
+					stack[stackIndex].m_first = range.m_first + leftCount;
+					stack[stackIndex].m_count = rightCount;
+					stack[stackIndex].m_nodeIndex = range.m_nodeIndex + leftCount;
+					stackIndex ++;
+				}
+				dgAssert(stackIndex < dgInt32 (sizeof (stack) / sizeof (stack[0])));
+			}
+		}
+		nodeIndex += count - 1;
+		first += count;
+	}
+	dgAssert(segment == segmentCount);
+
+	if (parallel) {
+		m_world->ParallelFor(0, taskCount, 1, BuildSubtreeKernel, &descriptor, "dgBroadPhase::BuildSubtree");
+	} else {
+		BuildSubtreeKernel(&descriptor, 0, taskCount, threadIndex);
+	}
+
+	// the top levels are refitted bottom up once the subtrees are done
+	for (dgInt32 i = topCount - 1; i >= 0; i --) {
+		dgBroadPhaseTreeNode* const parent = nodeArray[topNodes[i].m_nodeIndex];
+		parent->SetAABB(parent->m_left->m_minBox.GetMin(parent->m_right->m_minBox), parent->m_left->m_maxBox.GetMax(parent->m_right->m_maxBox));
+	}
+
+	dgBroadPhaseNode* root = (segments[0].m_count == 1) ? boxArray[segments[0].m_first].m_node : nodeArray[segments[0].m_nodeIndex];
+	for (dgInt32 i = 1; i < segmentCount; i ++) {
+		dgBroadPhaseNode* const segmentRoot = (segments[i].m_count == 1) ? boxArray[segments[i].m_first].m_node : nodeArray[segments[i].m_nodeIndex];
+		dgBroadPhaseTreeNode* const parent = nodeArray[nodeIndex];
+		nodeIndex ++;
+		parent->m_left = root;
+		parent->m_right = segmentRoot;
+		parent->m_left->m_parent = parent;
+		parent->m_right->m_parent = parent;
+		parent->SetAABB(root->m_minBox.GetMin(segmentRoot->m_minBox), root->m_maxBox.GetMax(segmentRoot->m_maxBox));
+		root = parent;
+	}
+	dgAssert(nodeIndex == (leafCount - 1));
+	root->m_parent = NULL;
+	return root;
+}
+
+
 void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy, dgBroadPhaseNode** const root)
 {
 	if (*root) {
@@ -849,16 +1573,20 @@ void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy,
 
 		if ((entropy > oldEntropy * dgFloat32(1.5f)) || (entropy < oldEntropy * dgFloat32(0.75f))) {
 			if (fitness.GetFirst()) {
-				m_world->m_solverJacobiansMemory.ResizeIfNecessary ((fitness.GetCount() * 2 + 16) * sizeof (dgBroadPhaseNode*));
-				dgBroadPhaseNode** const leafArray = (dgBroadPhaseNode**)&m_world->m_solverJacobiansMemory[0];
+				dgFrameArenaScope scratchScope (m_world->m_frameArena, 0);
+				dgBroadPhaseNode** const leafArray = dgFrameAlloca(m_world->m_frameArena, dgBroadPhaseNode*, fitness.GetCount() + 1, 0);
+				dgBroadPhaseTreeNode** const nodeArray = dgFrameAlloca(m_world->m_frameArena, dgBroadPhaseTreeNode*, fitness.GetCount(), 0);
 
+				dgInt32 nodeCount = 0;
 				dgInt32 leafNodesCount = 0;
 				for (dgFitnessList::dgListNode* nodePtr = fitness.GetFirst(); nodePtr; nodePtr = nodePtr->GetNext()) {
-					dgBroadPhaseNode* const node = nodePtr->GetInfo();
+					dgBroadPhaseTreeNode* const node = nodePtr->GetInfo();
+					nodeArray[nodeCount] = node;
+					nodeCount++;
 					dgBroadPhaseNode* const leftNode = node->GetLeft();
 					dgBody* const leftBody = leftNode->GetBody();
 					if (leftBody) {
-						node->SetAABB(leftBody->m_minAABB, leftBody->m_maxAABB);
+						leftNode->SetAABB(leftBody->GetStateMinAABB(), leftBody->GetStateMaxAABB());
 						leafArray[leafNodesCount] = leftNode;
 						leafNodesCount++;
 					} else if (leftNode->IsAggregate()) {
@@ -868,7 +1596,7 @@ void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy,
 					dgBroadPhaseNode* const rightNode = node->GetRight();
 					dgBody* const rightBody = rightNode->GetBody();
 					if (rightBody) {
-						rightNode->SetAABB(rightBody->m_minAABB, rightBody->m_maxAABB);
+						rightNode->SetAABB(rightBody->GetStateMinAABB(), rightBody->GetStateMaxAABB());
 						leafArray[leafNodesCount] = rightNode;
 						leafNodesCount++;
 					} else if (rightNode->IsAggregate()) {
@@ -876,11 +1604,16 @@ void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy,
 						leafNodesCount++;
 					}
 				}
+				dgAssert(leafNodesCount == (nodeCount + 1));
 
-				dgFitnessList::dgListNode* nodePtr = fitness.GetFirst();
-
-				dgSortIndirect(leafArray, leafNodesCount, CompareNodes);
-				*root = BuildTopDownBig(leafArray, 0, leafNodesCount - 1, &nodePtr);
+				if (m_world->GetThreadCount() > 1) {
+					*root = BuildTree(leafArray, leafNodesCount, nodeArray, 0, true);
+				} else {
+					// the top down builder is still faster when there are no worker threads to share the binning
+					dgFitnessList::dgListNode* nodePtr = fitness.GetFirst();
+					dgSortIndirect(leafArray, leafNodesCount, CompareNodes);
+					*root = BuildTopDownBig(leafArray, 0, leafNodesCount - 1, &nodePtr);
+				}
 				dgAssert(!(*root)->m_parent);
 				//entropy = CalculateEntropy(fitness, root);
 				entropy = fitness.TotalCost();
@@ -1048,13 +1781,13 @@ bool dgBroadPhase::ValidateContactCache(dgContact* const contact, dgFloat32 time
 		dgBody* const body1 = contact->GetBody1();
 
 		dgVector deltaTime(timestep);
-		dgVector positStep(deltaTime * (body0->m_veloc - body1->m_veloc));
+		dgVector positStep(deltaTime * (body0->GetStateVeloc() - body1->GetStateVeloc()));
 		positStep = ((positStep.DotProduct(positStep)) > m_velocTol) & positStep;
 		contact->m_positAcc += positStep;
 
 		dgVector positError2(contact->m_positAcc.DotProduct(contact->m_positAcc));
 		if ((positError2 < m_linearContactError2).GetSignMask()) {
-			dgVector rotationStep(deltaTime * (body0->m_omega - body1->m_omega));
+			dgVector rotationStep(deltaTime * (body0->GetStateOmega() - body1->GetStateOmega()));
 			rotationStep = ((rotationStep.DotProduct(rotationStep)) > m_velocTol) & rotationStep;
 			contact->m_rotationAcc = contact->m_rotationAcc * dgQuaternion(dgFloat32(1.0f), rotationStep.m_x, rotationStep.m_y, rotationStep.m_z);
 
@@ -1076,7 +1809,11 @@ void dgBroadPhase::CalculatePairContacts (dgPair* const pair, dgInt32 threadID)
 	pair->m_cacheIsValid = false;
 	pair->m_contactBuffer = contacts;
 	m_world->CalculateContacts(pair, threadID, false, false);
+	UpdatePairContacts (pair, threadID);
+}
 
+void dgBroadPhase::UpdatePairContacts (dgPair* const pair, dgInt32 threadID)
+{
 	if (pair->m_contactCount) {
 //		if (pair->m_contact->m_body0->m_invMass.m_w != dgFloat32 (0.0f)) {
 //			pair->m_contact->m_body0->m_equilibrium = false;
@@ -1097,7 +1834,7 @@ void dgBroadPhase::CalculatePairContacts (dgPair* const pair, dgInt32 threadID)
 	}
 }
 
-void dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt32 threadIndex)
+bool dgBroadPhase::ValidatePair (dgContact* const contact, dgFloat32 timestep, dgInt32 threadIndex) const
 {
 	dgWorld* const world = (dgWorld*) m_world;
 	dgBody* const body0 = contact->m_body0;
@@ -1112,7 +1849,7 @@ void dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt3
 	dgAssert (body1->GetWorld() == world);
 	if (!(body0->m_collideWithLinkedBodies & body1->m_collideWithLinkedBodies)) {
 		if (world->AreBodyConnectedByJoints (body0, body1)) {
-			return;
+			return false;
 		}
 	}
 
@@ -1122,15 +1859,21 @@ void dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt3
 		if (material->m_aabbOverlap) {
 			processContacts = material->m_aabbOverlap(*contact, timestep, threadIndex);
 		}
-		if (processContacts) {
-            dgPair pair;
-			dgAssert (!body0->m_collision->IsType (dgCollision::dgCollisionNull_RTTI));
-			dgAssert (!body1->m_collision->IsType (dgCollision::dgCollisionNull_RTTI));
+		return processContacts ? true : false;
+	}
+	return false;
+}
 
-			pair.m_contact = contact;
-			pair.m_timestep = timestep;
-            CalculatePairContacts (&pair, threadIndex);
-		}
+void dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt32 threadIndex)
+{
+	if (ValidatePair (contact, timestep, threadIndex)) {
+		dgPair pair;
+		dgAssert (!contact->m_body0->m_collision->IsType (dgCollision::dgCollisionNull_RTTI));
+		dgAssert (!contact->m_body1->m_collision->IsType (dgCollision::dgCollisionNull_RTTI));
+
+		pair.m_contact = contact;
+		pair.m_timestep = timestep;
+		CalculatePairContacts (&pair, threadIndex);
 	}
 }
 
@@ -1180,10 +1923,10 @@ bool dgBroadPhase::TestOverlaping(const dgBody* const body0, const dgBody* const
 				dgFloat32 distance = ray.BoxIntersect(boxp0, boxp1);
 				ret = (distance < dgFloat32(1.0f));
 			} else {
-				ret = dgOverlapTest(body0->m_minAABB, body0->m_maxAABB, body1->m_minAABB, body1->m_maxAABB) ? 1 : 0;
+				ret = dgOverlapTest(body0->GetStateMinAABB(), body0->GetStateMaxAABB(), body1->GetStateMinAABB(), body1->GetStateMaxAABB()) ? 1 : 0;
 			}
 		} else {
-			ret = dgOverlapTest(body0->m_minAABB, body0->m_maxAABB, body1->m_minAABB, body1->m_maxAABB) ? 1 : 0;
+			ret = dgOverlapTest(body0->GetStateMinAABB(), body0->GetStateMaxAABB(), body1->GetStateMinAABB(), body1->GetStateMaxAABB()) ? 1 : 0;
 			//if (ret) {
 			//	dgVector size0;
 			//	dgVector size1;
@@ -1306,8 +2049,8 @@ void dgBroadPhase::SubmitPairs(dgBroadPhaseNode* const leafNode, dgBroadPhaseNod
 
 	dgAssert (leafNode->IsLeafNode());
 	dgBody* const body0 = leafNode->GetBody();
-	const dgVector boxP0 (body0 ? body0->m_minAABB : leafNode->m_minBox);
-	const dgVector boxP1 (body0 ? body0->m_maxAABB : leafNode->m_maxBox);
+	const dgVector boxP0 (body0 ? body0->GetStateMinAABB() : leafNode->m_minBox);
+	const dgVector boxP1 (body0 ? body0->GetStateMaxAABB() : leafNode->m_maxBox);
 
 	const bool test0 = body0 ? (body0->GetInvMass().m_w != dgFloat32(0.0f)) : true;
 	while (stack) {
@@ -1429,8 +2172,8 @@ void dgBroadPhase::KinematicBodyActivation (dgContact* const contatJoint) const
 		if (body0->IsRTTIType(dgBody::m_kinematicBodyRTTI)) {
 			if (body1->IsRTTIType(dgBody::m_dynamicBodyRTTI) && (body1->GetInvMass().m_w > dgFloat32 (0.0f))) {
 				if (body1->m_equilibrium) {
-					dgVector relVeloc (body0->m_veloc - body1->m_veloc);
-					dgVector relOmega (body0->m_omega - body1->m_omega);
+					dgVector relVeloc (body0->GetStateVeloc() - body1->GetStateVeloc());
+					dgVector relOmega (body0->GetStateOmega() - body1->GetStateOmega());
 					dgVector mask2 ((relVeloc.DotProduct(relVeloc) < dgDynamicBody::m_equilibriumError2) & (relOmega.DotProduct(relOmega) < dgDynamicBody::m_equilibriumError2));
 
 					dgScopeSpinPause lock(&body1->m_criticalSectionLock);
@@ -1441,8 +2184,8 @@ void dgBroadPhase::KinematicBodyActivation (dgContact* const contatJoint) const
 		} else if (body1->IsRTTIType(dgBody::m_kinematicBodyRTTI)) {
 			if (body0->IsRTTIType(dgBody::m_dynamicBodyRTTI) && (body0->GetInvMass().m_w > dgFloat32 (0.0f))) {
 				if (body0->m_equilibrium) {
-					dgVector relVeloc (body0->m_veloc - body1->m_veloc);
-					dgVector relOmega (body0->m_omega - body1->m_omega);
+					dgVector relVeloc (body0->GetStateVeloc() - body1->GetStateVeloc());
+					dgVector relOmega (body0->GetStateOmega() - body1->GetStateOmega());
 					dgVector mask2 ((relVeloc.DotProduct(relVeloc) < dgDynamicBody::m_equilibriumError2) & (relOmega.DotProduct(relOmega) < dgDynamicBody::m_equilibriumError2));
 
 					dgScopeSpinPause lock(&body1->m_criticalSectionLock);
@@ -1454,12 +2197,12 @@ void dgBroadPhase::KinematicBodyActivation (dgContact* const contatJoint) const
 	}
 }
 
-void dgBroadPhase::CollidingPairsKernel(void* const context, void* const node, dgInt32 threadID)
+void dgBroadPhase::CollidingPairsKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
-	broadPhase->FindCollidingPairs(descriptor, (dgList<dgBroadPhaseNode*>::dgListNode*) node, threadID);
+	broadPhase->FindCollidingPairs(descriptor, start, end, threadID);
 }
 
 void dgBroadPhase::AddNewContactsKernel(void* const context, void* const newContactNode, dgInt32 threadID)
@@ -1486,12 +2229,12 @@ void dgBroadPhase::UpdateSoftBodyContactKernel(void* const context, void* const
 	broadPhase->UpdateSoftBodyContacts(descriptor, descriptor->m_timestep, threadID);
 }
 
-void dgBroadPhase::UpdateRigidBodyContactKernel(void* const context, void* const node, dgInt32 threadID)
+void dgBroadPhase::UpdateRigidBodyContactKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
-	broadPhase->UpdateRigidBodyContacts(descriptor, (dgContactList::dgListNode*) node, descriptor->m_timestep, threadID);
+	broadPhase->UpdateRigidBodyContacts(descriptor, start, end, descriptor->m_timestep, threadID);
 }
 
 void dgBroadPhase::UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID)
@@ -1516,27 +2259,28 @@ void dgBroadPhase::UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const desc
 */
 }
 
-void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgContactList::dgListNode* const nodePtr, dgFloat32 timeStep, dgInt32 threadID)
+void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgFloat32 timeStep, dgInt32 threadID)
 {
 	DG_TRACKTIME(__FUNCTION__);
-	dgContactList::dgListNode* node = nodePtr;
 	dgContactList* const contactList = m_world;
 	const dgFloat32 timestep = descriptor->m_timestep;
-	const dgInt32 threadCount = m_world->GetThreadCount();
 	const dgUnsigned32 lru = m_lru - DG_CONTACT_DELAY_FRAMES;
+	dgContactList::dgListNode** const contactArray = &m_contactArray[0];
 
-	dgInt32* const activeContactsCount = &contactList->m_activeContactsCount;
-
-	dgJointInfo* const constraintArray = &m_world->m_jointsMemory[0];
-	const dgInt32 maxActiveCount = m_world->m_jointsMemory.GetElementsCapacity();
+	dgContactBatchQueue queues[dgWorld::m_contactBatchTypes];
+	for (dgInt32 i = 0; i < dgWorld::m_contactBatchTypes; i ++) {
+		queues[i].m_type = i;
+		queues[i].m_count = 0;
+	}
 
-	while (node) {
+	for (dgInt32 i = start; i < end; i ++) {
+		dgContactList::dgListNode* const node = contactArray[i];
 		dgContact* const contact = node->GetInfo();
 
 		dgBody* const body0 = contact->GetBody0();
 		dgBody* const body1 = contact->GetBody1();
+		const dgInt32 contactActive = contact->m_contactActive;
 		if (!(body0->m_equilibrium & body1->m_equilibrium)) {
-			bool contactActive = contact->m_contactActive;
 			if (ValidateContactCache(contact, timestep)) {
 				contact->m_broadphaseLru = m_lru;
 				contact->m_timeOfImpact = dgFloat32(1.0e10f);
@@ -1564,7 +2308,22 @@ void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const des
 					contact->m_separationDistance = distance;
 				}
 				if (distance < DG_NARROW_PHASE_DIST) {
-					AddPair(contact, timestep, threadID);
+					const dgInt32 batchType = m_world->GetContactBatchType(contact);
+					if (batchType < 0) {
+						AddPair(contact, timestep, threadID);
+					} else if (ValidatePair(contact, timestep, threadID)) {
+						// pairs of the same kind are collided together when their queue
+						// fills up, the queue also finishes the update of their state
+						dgContactBatchQueue& queue = queues[batchType];
+						queue.m_nodes[queue.m_count] = node;
+						queue.m_contactActive[queue.m_count] = contactActive;
+						queue.m_count ++;
+						contact->m_broadphaseLru = m_lru;
+						if (queue.m_count == DG_CONTACT_BATCH_SIZE) {
+							CalculateContactBatch(queue, timestep, threadID);
+						}
+						continue;
+					}
 					if (contact->m_maxDOF) {
 						contact->m_timeOfImpact = dgFloat32(1.0e10f);
 					}
@@ -1583,35 +2342,75 @@ void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const des
 					}
 				}
 			}
-			if (contactActive ^ contact->m_contactActive) {
-				if (body0->GetInvMass().m_w) {
-					body0->m_equilibrium = false;
-				}
-				if (body1->GetInvMass().m_w) {
-					body1->m_equilibrium = false;
-				}
-			}
-
 		} else {
 			contact->m_broadphaseLru = m_lru;
 		}
+		UpdateContactState(node, contactActive);
+	}
 
-		if (contact->m_maxDOF && contact->m_contactActive) {
-			dgInt32 activeCount = dgAtomicExchangeAndAdd(activeContactsCount, 1);
-			if (activeCount < maxActiveCount) {
-				constraintArray[activeCount].m_joint = contact;
-			}
-		} else if (body0->m_equilibrium & body1->m_equilibrium) {
-			dgInt32 index = dgAtomicExchangeAndAdd(&contactList->m_deadContactsCount, 1);
-			if (index < sizeof(contactList->m_deadContacts) / sizeof(contactList->m_deadContacts[0])) {
-				contactList->m_deadContacts[index] = node;
-			}
+	for (dgInt32 i = 0; i < dgWorld::m_contactBatchTypes; i ++) {
+		if (queues[i].m_count) {
+			CalculateContactBatch(queues[i], timestep, threadID);
 		}
+	}
+}
 
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			node = node ? node->GetNext() : NULL;
+void dgBroadPhase::UpdateContactState(dgContactList::dgListNode* const node, dgInt32 contactActive)
+{
+	dgContactList* const contactList = m_world;
+	dgContact* const contact = node->GetInfo();
+	dgBody* const body0 = contact->GetBody0();
+	dgBody* const body1 = contact->GetBody1();
+
+	if (contactActive ^ contact->m_contactActive) {
+		if (body0->GetInvMass().m_w) {
+			body0->m_equilibrium = false;
+		}
+		if (body1->GetInvMass().m_w) {
+			body1->m_equilibrium = false;
 		}
 	}
+
+	if (contact->m_maxDOF && contact->m_contactActive) {
+		dgJointInfo* const constraintArray = &m_world->m_jointsMemory[0];
+		dgInt32 activeCount = dgAtomicExchangeAndAdd(&contactList->m_activeContactsCount, 1);
+		if (activeCount < m_world->m_jointsMemory.GetElementsCapacity()) {
+			constraintArray[activeCount].m_joint = contact;
+		}
+	} else if (body0->m_equilibrium & body1->m_equilibrium) {
+		dgInt32 index = dgAtomicExchangeAndAdd(&contactList->m_deadContactsCount, 1);
+		if (index < sizeof(contactList->m_deadContacts) / sizeof(contactList->m_deadContacts[0])) {
+			contactList->m_deadContacts[index] = node;
+		}
+	}
+}
+
+void dgBroadPhase::CalculateContactBatch(dgContactBatchQueue& queue, dgFloat32 timestep, dgInt32 threadID)
+{
+	dgWorld::dgContactBatch batch;
+	batch.m_type = queue.m_type;
+	batch.m_count = queue.m_count;
+	for (dgInt32 i = 0; i < queue.m_count; i ++) {
+		batch.m_contacts[i] = queue.m_nodes[i]->GetInfo();
+	}
+	m_world->CalculateContactBatch(batch);
+
+	dgContactPoint contacts[DG_MAX_CONTATCS];
+	for (dgInt32 i = 0; i < queue.m_count; i ++) {
+		dgPair pair;
+		dgContact* const contact = batch.m_contacts[i];
+		pair.m_contact = contact;
+		pair.m_timestep = timestep;
+		pair.m_cacheIsValid = false;
+		pair.m_contactBuffer = contacts;
+		m_world->CalculateBatchedPairContacts(&pair, batch, i, threadID);
+		UpdatePairContacts(&pair, threadID);
+		if (contact->m_maxDOF) {
+			contact->m_timeOfImpact = dgFloat32(1.0e10f);
+		}
+		UpdateContactState(queue.m_nodes[i], queue.m_contactActive[i]);
+	}
+	queue.m_count = 0;
 }
 
 void dgBroadPhase::AddNewContacts(dgBroadphaseSyncDescriptor* const descriptor, dgContactList::dgListNode* const nodeConstactNode, dgInt32 threadID)
@@ -1717,9 +2516,37 @@ bool dgBroadPhase::SanityCheck() const
 	return true;
 }
 
+dgInt32 dgBroadPhase::BuildUpdateArray()
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgInt32 count = 0;
+	m_updateArray.ResizeIfNecessary(m_updateList.GetCount());
+	dgBroadPhaseNode** const updateArray = &m_updateArray[0];
+	for (dgList<dgBroadPhaseNode*>::dgListNode* node = m_updateList.GetFirst(); node; node = node->GetNext()) {
+		updateArray[count] = node->GetInfo();
+		count ++;
+	}
+	return count;
+}
+
+dgInt32 dgBroadPhase::BuildContactArray()
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgInt32 count = 0;
+	dgContactList* const contactList = m_world;
+	m_contactArray.ResizeIfNecessary(contactList->GetCount());
+	dgContactList::dgListNode** const contactArray = &m_contactArray[0];
+	for (dgContactList::dgListNode* node = contactList->GetFirst(); node; node = node->GetNext()) {
+		contactArray[count] = node;
+		count ++;
+	}
+	return count;
+}
+
 void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 {
 	DG_TRACKTIME(__FUNCTION__);
+	const dgUnsigned64 broadPhaseTime = dgGetTimeInMicrosenconds();
     m_lru = m_lru + 1;
 	m_pendingSoftBodyPairsCount = 0;
 
@@ -1730,12 +2557,9 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	m_world->m_bodiesMemory.ResizeIfNecessary(masterList->GetCount());
 	dgBroadphaseSyncDescriptor syncPoints(timestep, m_world);
 
-	dgBodyMasterList::dgListNode* node = masterList->GetFirst()->GetNext();
-	for (dgInt32 i = 0; i < threadsCount; i++) {
-		m_world->QueueJob(ForceAndToqueKernel, &syncPoints, node, "dgBroadPhase::ForceAndToque");
-		node = node ? node->GetNext() : NULL;
-	}
-	m_world->SynchronizationBarrier();
+	// the pair phase looks up the bilateral joints of new pairs in the joint graph
+	const dgInt32 bodyCount = m_world->BuildJointGraph();
+	m_world->ParallelFor(0, bodyCount, DG_PARALLEL_BODY_GRAIN_SIZE, ForceAndToqueKernel, &syncPoints, "dgBroadPhase::ForceAndToque");
 
 	// update pre-listeners after the force and torque are applied
 	if (m_world->m_listeners.GetCount()) {
@@ -1748,12 +2572,7 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	}
 
 	// check for sleeping bodies states
-	node = masterList->GetFirst()->GetNext();
-	for (dgInt32 i = 0; i < threadsCount; i++) {
-		m_world->QueueJob(SleepingStateKernel, &syncPoints, node, "dgBroadPhase::SleepingState");
-		node = node ? node->GetNext() : NULL;
-	}
-	m_world->SynchronizationBarrier();
+	m_world->ParallelFor(0, bodyCount, DG_PARALLEL_BODY_GRAIN_SIZE, SleepingStateKernel, &syncPoints, "dgBroadPhase::SleepingState");
 
 	// this will move to an asynchronous thread 
 	dgList<dgBroadPhaseAggregate*>::dgListNode* aggregateNode = m_aggregateList.GetFirst();
@@ -1771,26 +2590,23 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	dgContactList::dgListNode* const lastNode = contactList->GetFirst();
 
 	syncPoints.m_fullScan = syncPoints.m_fullScan || (syncPoints.m_atomicPendingBodiesCount >= (syncPoints.m_atomicDynamicsCount / 2));
-	dgList<dgBroadPhaseNode*>::dgListNode* broadPhaseNode = m_updateList.GetFirst();
-	for (dgInt32 i = 0; i < threadsCount; i++) {
-		m_world->QueueJob(CollidingPairsKernel, &syncPoints, broadPhaseNode, "dgBroadPhase::CollidingPairs");
-		broadPhaseNode = broadPhaseNode ? broadPhaseNode->GetNext() : NULL;
+	if (syncPoints.m_fullScan) {
+		const dgInt32 nodeCount = BuildUpdateArray();
+		m_world->ParallelFor(0, nodeCount, DG_PARALLEL_PAIRS_GRAIN_SIZE, CollidingPairsKernel, &syncPoints, "dgBroadPhase::CollidingPairs");
+	} else {
+		m_world->ParallelFor(0, syncPoints.m_atomicPendingBodiesCount, DG_PARALLEL_PAIRS_GRAIN_SIZE, CollidingPairsKernel, &syncPoints, "dgBroadPhase::CollidingPairs");
 	}
-	m_world->SynchronizationBarrier();
 
 	AttachNewContacts(lastNode);
 	dgAssert(SanityCheck());
 
-	dgContactList::dgListNode* contactListNode = contactList->GetFirst();
-	for (dgInt32 i = 0; i < threadsCount; i++) {
-		m_world->QueueJob(UpdateRigidBodyContactKernel, &syncPoints, contactListNode, "dgBroadPhase::UpdateRigidBodyContact");
-		contactListNode = contactListNode ? contactListNode->GetNext() : NULL;
-	}
-	m_world->SynchronizationBarrier();
+	const dgUnsigned64 narrowPhaseTime = dgGetTimeInMicrosenconds();
+	const dgInt32 contactCount = BuildContactArray();
+	m_world->ParallelFor(0, contactCount, DG_PARALLEL_CONTACTS_GRAIN_SIZE, UpdateRigidBodyContactKernel, &syncPoints, "dgBroadPhase::UpdateRigidBodyContact");
 
 	if (m_pendingSoftBodyPairsCount) {
 		for (dgInt32 i = 0; i < threadsCount; i++) {
-			m_world->QueueJob(UpdateSoftBodyContactKernel, &syncPoints, contactListNode, "dgBroadPhase::UpdateSoftBodyContact");
+			m_world->QueueJob(UpdateSoftBodyContactKernel, &syncPoints, m_world, "dgBroadPhase::UpdateSoftBodyContact");
 		}
 		m_world->SynchronizationBarrier();
 	}
@@ -1813,4 +2629,11 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	}
 
 	DeleteDeadContacts();
+
+	dgWorldStepStats& stats = m_world->m_stepStats;
+	const dgUnsigned64 endTime = dgGetTimeInMicrosenconds();
+	stats.m_broadPhaseTime += narrowPhaseTime - broadPhaseTime;
+	stats.m_narrowPhaseTime += endTime - narrowPhaseTime;
+	stats.m_bodyCount = bodyCount;
+	stats.m_contactCount = contactList->m_activeContactsCount;
 }
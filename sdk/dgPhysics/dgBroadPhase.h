@@ -36,8 +36,16 @@ class dgBroadPhaseAggregate;
 
 
 #define DG_CACHE_DIST_TOL				dgFloat32 (1.0e-3f)
+#define DG_CONVEX_CAST_POOLSIZE			32
 #define DG_BROADPHASE_MAX_STACK_DEPTH	256
 
+// maximum chunk sizes for the parallel for loops of the broad phase update
+#define DG_PARALLEL_BODY_GRAIN_SIZE		64
+#define DG_PARALLEL_PAIRS_GRAIN_SIZE	16
+#define DG_PARALLEL_CONTACTS_GRAIN_SIZE	8
+#define DG_PARALLEL_CAST_GRAIN_SIZE		4
+#define DG_CONTACT_BATCH_SIZE			4
+
 class dgConvexCastReturnInfo
 {
 	public:
@@ -50,6 +58,16 @@ class dgConvexCastReturnInfo
 	dgFloat32 m_penetration;                // contact penetration at collision point
 };
 
+class dgCastBatchHit
+{
+	public:
+	dgFloat32 m_point[4];					// closest hit point in global space
+	dgFloat32 m_normal[4];					// surface normal at the hit point
+	dgInt64 m_contactID;					// collision ID at the hit point
+	const dgBody* m_hitBody;				// body hit, NULL when nothing was hit
+	dgFloat32 m_param;						// fraction of the segment at the hit, one on a miss
+};
+
 
 DG_MSC_VECTOR_ALIGMENT
 class dgBroadPhaseNode
@@ -62,6 +80,7 @@ class dgBroadPhaseNode
 		,m_parent(parent)
 		,m_surfaceArea(dgFloat32(1.0e20f))
 		,m_criticalSectionLock(0)
+		,m_flatIndex(-1)
 	{
 	}
 
@@ -123,6 +142,8 @@ class dgBroadPhaseNode
 	dgBroadPhaseNode* m_parent;
 	dgFloat32 m_surfaceArea;
 	dgInt32 m_criticalSectionLock;
+	// slot of a leaf in a flattened tree, node index times four plus the child lane, or its hash grid body index
+	dgInt32 m_flatIndex;
 
 	static dgVector m_broadPhaseScale;
 	static dgVector m_broadInvPhaseScale;
@@ -137,7 +158,7 @@ class dgBroadPhaseBodyNode: public dgBroadPhaseNode
 		,m_body(body)
 		,m_updateNode(NULL)
 	{
-		SetAABB(body->m_minAABB, body->m_maxAABB);
+		SetAABB(body->GetStateMinAABB(), body->GetStateMaxAABB());
 		m_body->SetBroadPhase(this);
 	}
 
@@ -398,6 +419,115 @@ class dgBroadPhase
 	};
 
 	class dgSpliteInfo;
+
+	class dgBuildLeaf
+	{
+		public:
+		dgBroadPhaseNode* m_node;
+		dgInt32 m_key;
+	};
+
+	DG_MSC_VECTOR_ALIGMENT
+	class dgBuildBox
+	{
+		public:
+		dgVector m_minBox;
+		dgVector m_maxBox;
+		dgBroadPhaseNode* m_node;
+	} DG_GCC_VECTOR_ALIGMENT;
+
+	class dgBuildRange
+	{
+		public:
+		dgInt32 m_first;
+		dgInt32 m_count;
+		dgInt32 m_nodeIndex;
+	};
+
+	// leaves are presorted by a morton key of their centers, big leaves are kept apart
+	// by prefixing the key with the surface area segment they belong to.
+	class dgBuildDescriptor
+	{
+		public:
+		dgVector m_centerMin[DG_MAX_THREADS_HIVE_COUNT];
+		dgVector m_centerMax[DG_MAX_THREADS_HIVE_COUNT];
+		dgVector m_origin;
+		dgVector m_scale;
+		dgBroadPhaseNode** m_leafArray;
+		dgBroadPhaseTreeNode** m_nodeArray;
+		dgBuildLeaf* m_sortArray;
+		dgBuildBox* m_boxArray;
+		dgBuildRange* m_tasks;
+		dgInt32 m_histogram[DG_MAX_THREADS_HIVE_COUNT][256];
+		dgInt32 m_segment[256];
+		dgInt32 m_segmentShift;
+	};
+
+	// the queries of a batch, casts carry one matrix per query in place of the ray origin
+	class dgCastBatchDescriptor
+	{
+		public:
+		const dgBroadPhase* m_broadPhase;
+		const dgFloat32* m_origin;
+		const dgFloat32* m_target;
+		dgCollisionInstance* m_shape;
+		OnRayPrecastAction m_prefilter;
+		void* m_userData;
+		dgCastBatchHit* m_hits;
+		dgInt32 m_originStride;
+		dgInt32 m_targetStride;
+		dgInt32 m_count;
+	};
+
+	// up to four queries traversed together, the swept boxes and directions are stored one axis per vector
+	DG_MSC_VECTOR_ALIGMENT
+	class dgCastPacket
+	{
+		public:
+		DG_INLINE dgInt32 Intersect(const dgVector& minBox, const dgVector& maxBox, dgVector& dist) const
+		{
+			dgVector tmin(dgVector::m_zero);
+			dgVector tmax(m_maxParam);
+			for (dgInt32 i = 0; i < 3; i ++) {
+				const dgVector t0((dgVector(minBox[i]) - m_hi[i]) * m_invDir[i]);
+				const dgVector t1((dgVector(maxBox[i]) - m_lo[i]) * m_invDir[i]);
+				tmin = tmin.GetMax(t0.GetMin(t1));
+				tmax = tmax.GetMin(t0.GetMax(t1));
+			}
+			dist = tmin;
+			return (tmin <= tmax).GetSignMask() & m_activeMask;
+		}
+
+		dgLineBox m_line[4];
+		dgMatrix m_matrix[4];
+		dgVector m_target[4];
+		dgVector m_veloc[4];
+		dgVector m_lo[3];
+		dgVector m_hi[3];
+		dgVector m_invDir[3];
+		dgVector m_maxParam;
+		dgCastBatchHit* m_hits;
+		dgInt32 m_activeMask;
+	} DG_GCC_VECTOR_ALIGMENT;
+
+	// contacts of one kind of primitive pair waiting for the narrow phase, with the
+	// activity they had before the update
+	class dgContactBatchQueue
+	{
+		public:
+		dgContactList::dgListNode* m_nodes[DG_CONTACT_BATCH_SIZE];
+		dgInt32 m_contactActive[DG_CONTACT_BATCH_SIZE];
+		dgInt32 m_type;
+		dgInt32 m_count;
+	};
+
+	class dgCastBatchRay
+	{
+		public:
+		const dgCastBatchDescriptor* m_descriptor;
+		dgCastBatchHit* m_hit;
+	};
+
 	class dgBroadphaseSyncDescriptor
 	{
 		public:
@@ -496,11 +626,14 @@ class dgBroadPhase
 	virtual void RayCast (const dgVector& p0, const dgVector& p1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const = 0;
 	virtual dgInt32 Collide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const = 0;
 	virtual dgInt32 ConvexCast (dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const = 0;
-	virtual void FindCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const node, dgInt32 threadID) = 0;
+	virtual void FindCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID) = 0;
+
+	void RayCastBatch (const dgFloat32* const p0, const dgFloat32* const p1, dgInt32 strideInBytes, dgInt32 count, OnRayPrecastAction prefilter, void* const userData, dgCastBatchHit* const hits) const;
+	void ConvexCastBatch (dgCollisionInstance* const shape, const dgFloat32* const matrices, const dgFloat32* const targets, dgInt32 strideInBytes, dgInt32 count, OnRayPrecastAction prefilter, void* const userData, dgCastBatchHit* const hits) const;
 
 	void DeleteDeadContacts();
 	void AttachNewContacts(dgContactList::dgListNode* const lastNode);
-	void UpdateBody(dgBody* const body, dgInt32 threadIndex);
+	virtual void UpdateBody(dgBody* const body, dgInt32 threadIndex);
 	void AddInternallyGeneratedBody(dgBody* const body)
 	{
 		m_generatedBodies.Append(body);
@@ -515,7 +648,9 @@ class dgBroadPhase
 	virtual void LinkAggregate (dgBroadPhaseAggregate* const aggregate) = 0; 
 	virtual void UnlinkAggregate (dgBroadPhaseAggregate* const aggregate) = 0; 
 
-	bool DoNeedUpdate(dgBodyMasterList::dgListNode* const node) const;
+	bool DoNeedUpdate(dgBody* const body) const;
+	dgInt32 BuildUpdateArray();
+	dgInt32 BuildContactArray();
 	dgFloat64 CalculateEntropy (dgFitnessList& fitness, dgBroadPhaseNode** const root);
 	dgBroadPhaseTreeNode* InsertNode (dgBroadPhaseNode* const root, dgBroadPhaseNode* const node);
 
@@ -525,7 +660,11 @@ class dgBroadPhase
 	void ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy, dgBroadPhaseNode** const root);
 
 	void CalculatePairContacts (dgPair* const pair, dgInt32 threadID);
+	void UpdatePairContacts (dgPair* const pair, dgInt32 threadID);
+	void CalculateContactBatch (dgContactBatchQueue& queue, dgFloat32 timestep, dgInt32 threadID);
+	void UpdateContactState (dgContactList::dgListNode* const node, dgInt32 contactActive);
 	bool ValidateContactCache(dgContact* const contact, dgFloat32 timestep) const;
+	bool ValidatePair (dgContact* const contact, dgFloat32 timestep, dgInt32 threadIndex) const;
 	void AddPair (dgContact* const contact, dgFloat32 timestep, dgInt32 threadIndex);
 	void AddPair (dgBody* const body0, dgBody* const body1, dgFloat32 timestep, dgInt32 threadID);	
 
@@ -540,11 +679,17 @@ class dgBroadPhase
 	dgInt32 Collide(const dgBroadPhaseNode** stackPool, dgInt32* const overlap, dgInt32 stack, const dgVector& p0, const dgVector& p1, 
 		            dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
 
-	void SleepingState (dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID);
-	void ApplyForceAndtorque (dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID);
+	virtual void CastPacket (const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 threadID) const;
+	void InitCastPacket (const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 first) const;
+	void CastPacketLane (const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 lane, const dgBroadPhaseNode* const node, dgFloat32 dist, dgInt32 threadID) const;
+	void CastBatch (dgCastBatchDescriptor* const descriptor, const char* const name) const;
+
+	void SleepingState (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	void ApplyForceAndtorque (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
 	
 	void UpdateAggregateEntropy (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseAggregate*>::dgListNode* node, dgInt32 threadID);
 
+	dgBroadPhaseNode* BuildTree(dgBroadPhaseNode** const leafArray, dgInt32 leafCount, dgBroadPhaseTreeNode** const nodeArray, dgInt32 threadIndex, bool parallel);
 	dgBroadPhaseNode* BuildTopDown(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgFitnessList::dgListNode** const nextNode);
 	dgBroadPhaseNode* BuildTopDownBig(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgFitnessList::dgListNode** const nextNode);
 
@@ -552,20 +697,32 @@ class dgBroadPhase
 	
 	void FindGeneratedBodiesCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID);
 	void UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID);
-	void UpdateRigidBodyContacts (dgBroadphaseSyncDescriptor* const descriptor, dgContactList::dgListNode* const node, dgFloat32 timeStep, dgInt32 threadID);
+	void UpdateRigidBodyContacts (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgFloat32 timeStep, dgInt32 threadID);
 	void SubmitPairs (dgBroadPhaseNode* const body, dgBroadPhaseNode* const node, dgFloat32 timestep, dgInt32 threaCount, dgInt32 threadID);
 	void AddNewContacts(dgBroadphaseSyncDescriptor* const descriptor, dgContactList::dgListNode* const nodeConstactNode, dgInt32 threadID);
 	bool SanityCheck() const;
 		
-	static void SleepingStateKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
-	static void ForceAndToqueKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
-	static void CollidingPairsKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void SleepingStateKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void ForceAndToqueKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void CollidingPairsKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
 	static void AddNewContactsKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void UpdateAggregateEntropyKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void AddGeneratedBodiesContactsKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
-	static void UpdateRigidBodyContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void UpdateRigidBodyContactKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
 	static void UpdateSoftBodyContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void BuildBoundsKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void BuildKeysKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void BuildBoxesKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void BuildSubtreeKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void CastBatchKernel(void* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static dgFloat32 dgApi CastBatchRayFilter(const dgBody* const body, const dgCollisionInstance* const collision, const dgVector& contact, const dgVector& normal, dgInt64 collisionID, void* const userData, dgFloat32 intersetParam);
+	static dgUnsigned32 dgApi CastBatchRayPrefilter(const dgBody* const body, const dgCollisionInstance* const collision, void* const userData);
+	static void SetCastBatchHit(dgCastBatchHit& hit, const dgConvexCastReturnInfo& info, dgFloat32 param);
 	static dgInt32 CompareNodes(const dgBroadPhaseNode* const nodeA, const dgBroadPhaseNode* const nodeB, void* const notUsed);
+	static dgBroadPhaseNode* BuildBinnedTree(dgBuildBox* const boxArray, dgInt32 leafCount, dgBroadPhaseTreeNode** const nodeArray);
+	static dgInt32 SplitMortonRange(const dgBuildLeaf* const sortArray, dgInt32 count);
+	static dgInt32 GetBuildLeafKey(const dgBuildLeaf* const leaf, void* const context);
+	static dgInt32 GetAreaBucket(dgFloat32 area);
 
 	class dgPendingCollisionSoftBodies
 	{
@@ -581,6 +738,8 @@ class dgBroadPhase
 	dgList<dgBroadPhaseAggregate*> m_aggregateList;
 	dgUnsigned32 m_lru;
 	dgContactCache m_contactCache;
+	dgArray<dgBroadPhaseNode*> m_updateArray;
+	dgArray<dgContactList::dgListNode*> m_contactArray;
 	dgArray<dgPendingCollisionSoftBodies> m_pendingSoftBodyCollisions;
 	dgInt32 m_pendingSoftBodyPairsCount;
 	dgInt32 m_contacJointLock;
@@ -190,8 +190,8 @@ void dgBroadPhaseAggregate::SummitPairs(dgBody* const body, dgFloat32 timestep,
 			pool[0] = m_root;
 			dgInt32 stack = 1;
 
-			const dgVector& boxP0 = body->m_minAABB;
-			const dgVector& boxP1 = body->m_maxAABB;
+			const dgVector& boxP0 = body->GetStateMinAABB();
+			const dgVector& boxP1 = body->GetStateMaxAABB();
 
 			while (stack) {
 				stack--;
@@ -316,7 +316,7 @@ void dgBroadPhaseAggregate::SubmitSelfPairs(dgBroadPhaseNode* const node0, dgBro
 		if (left->IsLeafNode() && right->IsLeafNode()) {
 			dgBody* const body0 = left->GetBody();
 			dgBody* const body1 = right->GetBody();
-			if (dgOverlapTest(body0->m_minAABB, body0->m_maxAABB, body1->m_minAABB, body1->m_maxAABB)) {
+			if (dgOverlapTest(body0->GetStateMinAABB(), body0->GetStateMaxAABB(), body1->GetStateMinAABB(), body1->GetStateMaxAABB())) {
 				m_broadPhase->AddPair(body0, body1, timestep, threadID);
 			}
 		} else {
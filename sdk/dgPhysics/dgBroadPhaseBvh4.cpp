@@ -0,0 +1,854 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "dgPhysicsStdafx.h"
+#include "dgBody.h"
+#include "dgWorld.h"
+#include "dgCollisionInstance.h"
+#include "dgBroadPhaseBvh4.h"
+#include "dgBroadPhaseAggregate.h"
+
+// number of subtrees per thread the flattening is split into
+#define DG_BVH4_FLATTEN_TASKS_PER_THREAD	8
+
+dgVector dgBroadPhaseBvh4::m_emptyMin (dgFloat32 (1.0e15f));
+dgVector dgBroadPhaseBvh4::m_emptyMax (dgFloat32 (-1.0e15f));
+
+
+// a box broadcast to the four lanes of a flattened node
+class dgBvh4Box
+{
+	public:
+	DG_INLINE dgBvh4Box (const dgVector& minBox, const dgVector& maxBox)
+		:m_minX(minBox.m_x)
+		,m_minY(minBox.m_y)
+		,m_minZ(minBox.m_z)
+		,m_maxX(maxBox.m_x)
+		,m_maxY(maxBox.m_y)
+		,m_maxZ(maxBox.m_z)
+	{
+	}
+
+	// one bit per lane, same strict test as dgOverlapTest
+	DG_INLINE dgInt32 Overlap (const dgBroadPhaseBvh4Node& node) const
+	{
+		const dgVector testX ((node.m_minX < m_maxX) & (node.m_maxX > m_minX));
+		const dgVector testY ((node.m_minY < m_maxY) & (node.m_maxY > m_minY));
+		const dgVector testZ ((node.m_minZ < m_maxZ) & (node.m_maxZ > m_minZ));
+		return (testX & testY & testZ).GetSignMask();
+	}
+
+	dgVector m_minX;
+	dgVector m_minY;
+	dgVector m_minZ;
+	dgVector m_maxX;
+	dgVector m_maxY;
+	dgVector m_maxZ;
+};
+
+// a segment broadcast to the four lanes of a flattened node, the lane boxes are
+// grown by the box of the cast shape, a zero box is a plain ray cast
+class dgBvh4Ray
+{
+	public:
+	DG_INLINE dgBvh4Ray (const dgFastRayTest& ray, const dgVector& boxP0, const dgVector& boxP1)
+		:m_p0X(ray.m_p0.m_x)
+		,m_p0Y(ray.m_p0.m_y)
+		,m_p0Z(ray.m_p0.m_z)
+		,m_dpInvX(ray.m_dpInv.m_x)
+		,m_dpInvY(ray.m_dpInv.m_y)
+		,m_dpInvZ(ray.m_dpInv.m_z)
+		,m_box0X(boxP0.m_x)
+		,m_box0Y(boxP0.m_y)
+		,m_box0Z(boxP0.m_z)
+		,m_box1X(boxP1.m_x)
+		,m_box1Y(boxP1.m_y)
+		,m_box1Z(boxP1.m_z)
+		,m_parallelX(dgVector(ray.m_diff.m_x).Abs() < dgVector(dgFloat32(1.0e-8f)))
+		,m_parallelY(dgVector(ray.m_diff.m_y).Abs() < dgVector(dgFloat32(1.0e-8f)))
+		,m_parallelZ(dgVector(ray.m_diff.m_z).Abs() < dgVector(dgFloat32(1.0e-8f)))
+		,m_missDist(dgFloat32(1.2f))
+	{
+	}
+
+	// entry parameter of the segment for each lane, misses return 1.2 like dgFastRayTest::BoxIntersect
+	DG_INLINE dgVector Intersect (const dgBroadPhaseBvh4Node& node) const
+	{
+		const dgVector minX (node.m_minX - m_box1X);
+		const dgVector minY (node.m_minY - m_box1Y);
+		const dgVector minZ (node.m_minZ - m_box1Z);
+		const dgVector maxX (node.m_maxX - m_box0X);
+		const dgVector maxY (node.m_maxY - m_box0Y);
+		const dgVector maxZ (node.m_maxZ - m_box0Z);
+
+		const dgVector parallelX (((m_p0X <= minX) | (m_p0X >= maxX)) & m_parallelX);
+		const dgVector parallelY (((m_p0Y <= minY) | (m_p0Y >= maxY)) & m_parallelY);
+		const dgVector parallelZ (((m_p0Z <= minZ) | (m_p0Z >= maxZ)) & m_parallelZ);
+
+		const dgVector tx0 (m_dpInvX * (minX - m_p0X));
+		const dgVector tx1 (m_dpInvX * (maxX - m_p0X));
+		const dgVector ty0 (m_dpInvY * (minY - m_p0Y));
+		const dgVector ty1 (m_dpInvY * (maxY - m_p0Y));
+		const dgVector tz0 (m_dpInvZ * (minZ - m_p0Z));
+		const dgVector tz1 (m_dpInvZ * (maxZ - m_p0Z));
+
+		const dgVector t0 (tx0.GetMin(tx1).GetMax(ty0.GetMin(ty1)).GetMax(tz0.GetMin(tz1)).GetMax(dgVector::m_zero));
+		const dgVector t1 (tx0.GetMax(tx1).GetMin(ty0.GetMax(ty1)).GetMin(tz0.GetMax(tz1)).GetMin(dgVector::m_one));
+		const dgVector hit ((t0 < t1).AndNot(parallelX | parallelY | parallelZ));
+		return (t0 & hit) | m_missDist.AndNot(hit);
+	}
+
+	dgVector m_p0X;
+	dgVector m_p0Y;
+	dgVector m_p0Z;
+	dgVector m_dpInvX;
+	dgVector m_dpInvY;
+	dgVector m_dpInvZ;
+	dgVector m_box0X;
+	dgVector m_box0Y;
+	dgVector m_box0Z;
+	dgVector m_box1X;
+	dgVector m_box1Y;
+	dgVector m_box1Z;
+	dgVector m_parallelX;
+	dgVector m_parallelY;
+	dgVector m_parallelZ;
+	dgVector m_missDist;
+};
+
+class dgBvh4StackEntry
+{
+	public:
+	const dgBroadPhaseNode* m_leaf;
+	dgInt32 m_node;
+	dgFloat32 m_dist;
+};
+
+// keep the stack sorted so the closest entry is on top
+DG_INLINE void dgBvh4PushSorted (dgBvh4StackEntry* const stackPool, dgInt32& stack, const dgBroadPhaseNode* const leaf, dgInt32 node, dgFloat32 dist)
+{
+	dgInt32 j = stack;
+	for (; j && (dist > stackPool[j - 1].m_dist); j--) {
+		stackPool[j] = stackPool[j - 1];
+	}
+	stackPool[j].m_leaf = leaf;
+	stackPool[j].m_node = node;
+	stackPool[j].m_dist = dist;
+	stack++;
+	dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+}
+
+
+dgBroadPhaseBvh4::dgBroadPhaseBvh4(dgWorld* const world)
+	:dgBroadPhaseMixed(world)
+	,m_flatNodes(world->GetAllocator())
+	,m_flatEntropy(dgFloat32(0.0f))
+	,m_flatNodesCount(0)
+	,m_flatTreeDirty(true)
+{
+}
+
+dgBroadPhaseBvh4::~dgBroadPhaseBvh4()
+{
+}
+
+dgInt32 dgBroadPhaseBvh4::GetType() const
+{
+	return dgWorld::m_broadphaseBvh4;
+}
+
+bool dgBroadPhaseBvh4::HasFlatTree() const
+{
+	return !m_flatTreeDirty && m_flatNodesCount;
+}
+
+void dgBroadPhaseBvh4::Add(dgBody* const body)
+{
+	dgBroadPhaseMixed::Add(body);
+	m_flatTreeDirty = true;
+}
+
+void dgBroadPhaseBvh4::Remove(dgBody* const body)
+{
+	dgBroadPhaseMixed::Remove(body);
+	m_flatTreeDirty = true;
+}
+
+void dgBroadPhaseBvh4::LinkAggregate(dgBroadPhaseAggregate* const aggregate)
+{
+	dgBroadPhaseMixed::LinkAggregate(aggregate);
+	m_flatTreeDirty = true;
+}
+
+void dgBroadPhaseBvh4::UnlinkAggregate(dgBroadPhaseAggregate* const aggregate)
+{
+	dgBroadPhaseMixed::UnlinkAggregate(aggregate);
+	m_flatTreeDirty = true;
+}
+
+void dgBroadPhaseBvh4::DestroyAggregate(dgBroadPhaseAggregate* const aggregate)
+{
+	dgBroadPhaseMixed::DestroyAggregate(aggregate);
+	m_flatTreeDirty = true;
+}
+
+void dgBroadPhaseBvh4::UpdateBody(dgBody* const body, dgInt32 threadIndex)
+{
+	dgBroadPhase::UpdateBody(body, threadIndex);
+	if (!m_flatTreeDirty && m_flatNodesCount && body->m_masterNode) {
+		dgBroadPhaseAggregate* const aggregate = body->GetBroadPhaseAggregate();
+		RefitLeaf(aggregate ? (dgBroadPhaseNode*)aggregate : body->GetBroadPhase());
+	}
+}
+
+void dgBroadPhaseBvh4::RefitLeaf(const dgBroadPhaseNode* const leaf)
+{
+	// grow the lane of the leaf and its ancestors until one already contains the new box
+	dgBroadPhaseBvh4Node* const nodes = &m_flatNodes[0];
+	dgVector minBox(leaf->m_minBox);
+	dgVector maxBox(leaf->m_maxBox);
+	dgInt32 link = leaf->m_flatIndex;
+	while (link >= 0) {
+		dgBroadPhaseBvh4Node& node = nodes[link >> 2];
+		const dgInt32 lane = link & 3;
+		dgScopeSpinPause lock(&node.m_lock);
+
+		const dgVector laneMin(node.m_minX[lane], node.m_minY[lane], node.m_minZ[lane], dgFloat32(0.0f));
+		const dgVector laneMax(node.m_maxX[lane], node.m_maxY[lane], node.m_maxZ[lane], dgFloat32(0.0f));
+		if (dgBoxInclusionTest(minBox, maxBox, laneMin, laneMax)) {
+			break;
+		}
+		node.m_minX[lane] = minBox.m_x;
+		node.m_minY[lane] = minBox.m_y;
+		node.m_minZ[lane] = minBox.m_z;
+		node.m_maxX[lane] = maxBox.m_x;
+		node.m_maxY[lane] = maxBox.m_y;
+		node.m_maxZ[lane] = maxBox.m_z;
+
+		dgVector min0;
+		dgVector min1;
+		dgVector min2;
+		dgVector min3;
+		dgVector max0;
+		dgVector max1;
+		dgVector max2;
+		dgVector max3;
+		dgVector::Transpose4x4(min0, min1, min2, min3, node.m_minX, node.m_minY, node.m_minZ, node.m_minZ);
+		dgVector::Transpose4x4(max0, max1, max2, max3, node.m_maxX, node.m_maxY, node.m_maxZ, node.m_maxZ);
+		minBox = min0.GetMin(min1).GetMin(min2.GetMin(min3)) & dgVector::m_triplexMask;
+		maxBox = max0.GetMax(max1).GetMax(max2.GetMax(max3)) & dgVector::m_triplexMask;
+		link = node.m_parentLink;
+	}
+}
+
+dgInt32 dgBroadPhaseBvh4::InitFlatNode(dgInt32 nodeIndex, dgBroadPhaseNode* const node, dgInt32 parentLink, dgFlattenTask* const internalNodes)
+{
+	// a node takes the children of its binary node, internal children are replaced by their own two children
+	dgBroadPhaseNode* children[4];
+	dgInt32 count = 0;
+	if (node->IsLeafNode()) {
+		children[0] = node;
+		count = 1;
+	} else {
+		dgBroadPhaseNode* const pair[2] = {node->GetLeft(), node->GetRight()};
+		for (dgInt32 i = 0; i < 2; i ++) {
+			dgBroadPhaseNode* const child = pair[i];
+			dgAssert (child);
+			if (child->IsLeafNode()) {
+				children[count] = child;
+				count ++;
+			} else {
+				children[count] = child->GetLeft();
+				children[count + 1] = child->GetRight();
+				count += 2;
+			}
+		}
+	}
+
+	dgVector minBox[4];
+	dgVector maxBox[4];
+	dgInt32 internalCount = 0;
+	dgBroadPhaseBvh4Node& flatNode = m_flatNodes[nodeIndex];
+	for (dgInt32 i = 0; i < 4; i ++) {
+		flatNode.m_leaf[i] = NULL;
+		flatNode.m_child[i] = -1;
+		minBox[i] = m_emptyMin;
+		maxBox[i] = m_emptyMax;
+	}
+
+	for (dgInt32 i = 0; i < count; i ++) {
+		dgBroadPhaseNode* const child = children[i];
+		minBox[i] = child->m_minBox;
+		maxBox[i] = child->m_maxBox;
+		if (child->IsLeafNode()) {
+			flatNode.m_leaf[i] = child;
+			child->m_flatIndex = nodeIndex * 4 + i;
+		} else {
+			// the child node writes its index in this lane when it is flattened
+			internalNodes[internalCount].m_node = child;
+			internalNodes[internalCount].m_parentLink = nodeIndex * 4 + i;
+			internalNodes[internalCount].m_nodeIndex = -1;
+			internalCount ++;
+		}
+	}
+
+	dgVector unused;
+	dgVector::Transpose4x4(flatNode.m_minX, flatNode.m_minY, flatNode.m_minZ, unused, minBox[0], minBox[1], minBox[2], minBox[3]);
+	dgVector::Transpose4x4(flatNode.m_maxX, flatNode.m_maxY, flatNode.m_maxZ, unused, maxBox[0], maxBox[1], maxBox[2], maxBox[3]);
+	flatNode.m_parentLink = parentLink;
+	flatNode.m_count = count;
+	flatNode.m_lock = 0;
+	return internalCount;
+}
+
+dgInt32 dgBroadPhaseBvh4::CountFlatNodes(dgBroadPhaseNode* const root) const
+{
+	dgBroadPhaseNode* pool[DG_BROADPHASE_MAX_STACK_DEPTH];
+	pool[0] = root;
+	dgInt32 stack = 1;
+	dgInt32 count = 0;
+	while (stack) {
+		stack--;
+		dgBroadPhaseNode* const node = pool[stack];
+		dgAssert (!node->IsLeafNode());
+		count ++;
+		dgBroadPhaseNode* const pair[2] = {node->GetLeft(), node->GetRight()};
+		for (dgInt32 i = 0; i < 2; i ++) {
+			dgBroadPhaseNode* const child = pair[i];
+			if (!child->IsLeafNode()) {
+				if (!child->GetLeft()->IsLeafNode()) {
+					pool[stack] = child->GetLeft();
+					stack ++;
+				}
+				if (!child->GetRight()->IsLeafNode()) {
+					pool[stack] = child->GetRight();
+					stack ++;
+				}
+				dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH - 2);
+			}
+		}
+	}
+	return count;
+}
+
+void dgBroadPhaseBvh4::FlattenSubtree(dgBroadPhaseNode* const root, dgInt32 nodeIndex, dgInt32 parentLink)
+{
+	// depth first so every subtree ends up in a consecutive run of nodes
+	dgBroadPhaseBvh4Node* const nodes = &m_flatNodes[0];
+	dgFlattenTask pool[DG_BROADPHASE_MAX_STACK_DEPTH];
+	pool[0].m_node = root;
+	pool[0].m_parentLink = parentLink;
+	dgInt32 stack = 1;
+	dgInt32 index = nodeIndex;
+	while (stack) {
+		stack--;
+		const dgFlattenTask task (pool[stack]);
+		nodes[task.m_parentLink >> 2].m_child[task.m_parentLink & 3] = index;
+
+		dgFlattenTask internalNodes[4];
+		const dgInt32 count = InitFlatNode(index, task.m_node, task.m_parentLink, internalNodes);
+		index ++;
+		for (dgInt32 i = count - 1; i >= 0; i --) {
+			pool[stack] = internalNodes[i];
+			stack ++;
+			dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+		}
+	}
+}
+
+void dgBroadPhaseBvh4::CountFlatNodesKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgFlattenDescriptor* const descriptor = (dgFlattenDescriptor*)context;
+	for (dgInt32 i = start; i < end; i ++) {
+		dgFlattenTask& task = descriptor->m_tasks[i];
+		task.m_nodeIndex = descriptor->m_broadPhase->CountFlatNodes(task.m_node);
+	}
+}
+
+void dgBroadPhaseBvh4::FlattenSubtreeKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgFlattenDescriptor* const descriptor = (dgFlattenDescriptor*)context;
+	for (dgInt32 i = start; i < end; i ++) {
+		const dgFlattenTask& task = descriptor->m_tasks[i];
+		descriptor->m_broadPhase->FlattenSubtree(task.m_node, task.m_nodeIndex, task.m_parentLink);
+	}
+}
+
+void dgBroadPhaseBvh4::FlatEntropyKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgFlattenDescriptor* const descriptor = (dgFlattenDescriptor*)context;
+	const dgBroadPhaseBvh4Node* const nodes = &descriptor->m_broadPhase->m_flatNodes[0];
+
+	// empty lanes have negative sides and add no area
+	dgVector area(dgVector::m_zero);
+	for (dgInt32 i = start; i < end; i ++) {
+		const dgBroadPhaseBvh4Node& node = nodes[i];
+		const dgVector sideX((node.m_maxX - node.m_minX).GetMax(dgVector::m_zero));
+		const dgVector sideY((node.m_maxY - node.m_minY).GetMax(dgVector::m_zero));
+		const dgVector sideZ((node.m_maxZ - node.m_minZ).GetMax(dgVector::m_zero));
+		area += sideX * sideY + sideY * sideZ + sideZ * sideX;
+	}
+	descriptor->m_entropy[threadID] += area.AddHorizontal().GetScalar();
+}
+
+void dgBroadPhaseBvh4::BuildFlatTree()
+{
+	DG_TRACKTIME(__FUNCTION__);
+	m_flatTreeDirty = false;
+	m_flatNodesCount = 0;
+	if (!m_rootNode) {
+		return;
+	}
+
+	// each node of the flattened tree consumes at least one internal node of the binary tree
+	const dgInt32 maxNodes = m_fitness.GetCount() + 1;
+	m_flatNodes.ResizeIfNecessary(maxNodes);
+	dgBroadPhaseBvh4Node* const nodes = &m_flatNodes[0];
+
+	dgFrameArenaScope scratchScope (m_world->m_frameArena, 0);
+	dgFlattenTask* const queue = dgFrameAlloca(m_world->m_frameArena, dgFlattenTask, maxNodes + 4, 0);
+
+	// the top levels are flattened breadth first until there are enough subtrees to go around the threads
+	const dgInt32 maxTasks = m_world->GetThreadCount() * DG_BVH4_FLATTEN_TASKS_PER_THREAD;
+	dgInt32 head = 0;
+	dgInt32 tail = 1;
+	dgInt32 nodeCount = 0;
+	queue[0].m_node = m_rootNode;
+	queue[0].m_parentLink = -1;
+	while ((head < tail) && ((tail - head) < maxTasks)) {
+		const dgFlattenTask task (queue[head]);
+		head ++;
+		if (task.m_parentLink >= 0) {
+			nodes[task.m_parentLink >> 2].m_child[task.m_parentLink & 3] = nodeCount;
+		}
+		tail += InitFlatNode(nodeCount, task.m_node, task.m_parentLink, &queue[tail]);
+		nodeCount ++;
+	}
+
+	const dgInt32 taskCount = tail - head;
+	if (taskCount) {
+		dgFlattenDescriptor descriptor;
+		descriptor.m_broadPhase = this;
+		descriptor.m_tasks = &queue[head];
+		m_world->ParallelFor(0, taskCount, 1, CountFlatNodesKernel, &descriptor, "dgBroadPhaseBvh4::CountFlatNodes");
+
+		for (dgInt32 i = 0; i < taskCount; i ++) {
+			const dgInt32 count = descriptor.m_tasks[i].m_nodeIndex;
+			descriptor.m_tasks[i].m_nodeIndex = nodeCount;
+			nodeCount += count;
+		}
+		dgAssert(nodeCount <= maxNodes);
+		m_world->ParallelFor(0, taskCount, 1, FlattenSubtreeKernel, &descriptor, "dgBroadPhaseBvh4::FlattenSubtree");
+	}
+	m_flatNodesCount = nodeCount;
+}
+
+dgFloat64 dgBroadPhaseBvh4::CalculateFlatEntropy()
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgFlattenDescriptor descriptor;
+	descriptor.m_broadPhase = this;
+	descriptor.m_tasks = NULL;
+	memset(descriptor.m_entropy, 0, sizeof(descriptor.m_entropy));
+	m_world->ParallelFor(0, m_flatNodesCount, 0, FlatEntropyKernel, &descriptor, "dgBroadPhaseBvh4::FlatEntropy");
+
+	dgFloat64 entropy = dgFloat32(0.0f);
+	const dgInt32 threadCount = m_world->GetThreadCount();
+	for (dgInt32 i = 0; i < threadCount; i ++) {
+		entropy += descriptor.m_entropy[i];
+	}
+	return entropy;
+}
+
+void dgBroadPhaseBvh4::ResetEntropy()
+{
+	dgBroadPhaseMixed::ResetEntropy();
+	m_flatEntropy = dgFloat32(0.0f);
+}
+
+void dgBroadPhaseBvh4::UpdateFitness()
+{
+	DG_TRACKTIME(__FUNCTION__);
+	if (!HasFlatTree()) {
+		// topology changed, let the binary tree settle before flattening it
+		dgBroadPhaseMixed::UpdateFitness();
+		BuildFlatTree();
+		m_flatEntropy = CalculateFlatEntropy();
+	} else {
+		// aggregates may have changed their box while improving their own tree
+		for (dgList<dgBroadPhaseAggregate*>::dgListNode* node = m_aggregateList.GetFirst(); node; node = node->GetNext()) {
+			RefitLeaf(node->GetInfo());
+		}
+
+		// the tree is not rotated every step, it is rebuilt when its cost drifts too far from the last build
+		const dgFloat64 entropy = CalculateFlatEntropy();
+		if ((entropy > m_flatEntropy * dgFloat32(1.5f)) || (entropy < m_flatEntropy * dgFloat32(0.75f))) {
+			dgBroadPhaseMixed::ResetEntropy();
+			dgBroadPhaseMixed::UpdateFitness();
+			BuildFlatTree();
+			m_flatEntropy = CalculateFlatEntropy();
+		}
+	}
+}
+
+void dgBroadPhaseBvh4::InvalidateCache()
+{
+	dgBroadPhaseMixed::InvalidateCache();
+	BuildFlatTree();
+	m_flatEntropy = CalculateFlatEntropy();
+}
+
+void dgBroadPhaseBvh4::SubmitLeafPair(dgBroadPhaseNode* const leaf0, dgBroadPhaseNode* const leaf1, dgFloat32 timestep, dgInt32 threadID)
+{
+	dgBody* const body0 = leaf0->GetBody();
+	dgBody* const body1 = leaf1->GetBody();
+	if (body0) {
+		if (body1) {
+			if ((body0->GetInvMass().m_w != dgFloat32(0.0f)) || (body1->GetInvMass().m_w != dgFloat32(0.0f))) {
+				AddPair(body0, body1, timestep, threadID);
+			}
+		} else {
+			dgAssert (leaf1->IsAggregate());
+			((dgBroadPhaseAggregate*)leaf1)->SummitPairs(body0, timestep, threadID);
+		}
+	} else {
+		dgAssert (leaf0->IsAggregate());
+		dgBroadPhaseAggregate* const aggregate = (dgBroadPhaseAggregate*)leaf0;
+		if (body1) {
+			aggregate->SummitPairs(body1, timestep, threadID);
+		} else {
+			dgAssert (leaf1->IsAggregate());
+			aggregate->SummitPairs((dgBroadPhaseAggregate*)leaf1, timestep, threadID);
+		}
+	}
+}
+
+void dgBroadPhaseBvh4::SubmitFlatPairs(dgBroadPhaseNode* const leaf, dgInt32 nodeIndex, dgInt32 laneMask, const dgBroadPhaseNode* const skipLeaf, dgFloat32 timestep, dgInt32 threadID)
+{
+	const dgBody* const body = leaf->GetBody();
+	const dgBvh4Box box (body ? body->GetStateMinAABB() : leaf->m_minBox, body ? body->GetStateMaxAABB() : leaf->m_maxBox);
+	const dgBroadPhaseBvh4Node* const nodes = &m_flatNodes[0];
+
+	dgInt32 pool[DG_BROADPHASE_MAX_STACK_DEPTH];
+	pool[0] = nodeIndex;
+	dgInt32 stack = 1;
+	while (stack) {
+		stack--;
+		const dgBroadPhaseBvh4Node& node = nodes[pool[stack]];
+		const dgInt32 overlap = box.Overlap(node) & laneMask;
+		laneMask = 0x0f;
+		for (dgInt32 i = 0; i < node.m_count; i ++) {
+			if (overlap & (1 << i)) {
+				dgBroadPhaseNode* const otherLeaf = node.m_leaf[i];
+				if (otherLeaf) {
+					if (otherLeaf != skipLeaf) {
+						SubmitLeafPair(leaf, otherLeaf, timestep, threadID);
+					}
+				} else {
+					pool[stack] = node.m_child[i];
+					stack ++;
+					dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+				}
+			}
+		}
+	}
+}
+
+void dgBroadPhaseBvh4::FindCollidingPairs(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	if (!HasFlatTree()) {
+		dgBroadPhaseMixed::FindCollidingPairs(descriptor, start, end, threadID);
+		return;
+	}
+
+	const dgFloat32 timestep = descriptor->m_timestep;
+	const dgBroadPhaseBvh4Node* const nodes = &m_flatNodes[0];
+	if (descriptor->m_fullScan) {
+		dgBroadPhaseNode** const updateArray = &m_updateArray[0];
+		for (dgInt32 i = start; i < end; i ++) {
+			dgBroadPhaseNode* const leaf = updateArray[i];
+			dgAssert(leaf->IsLeafNode());
+			if (leaf->IsAggregate()) {
+				((dgBroadPhaseAggregate*)leaf)->SubmitSelfPairs(timestep, threadID);
+			}
+
+			// test the lanes after the leaf and after each of its ancestors, so every pair is found once
+			for (dgInt32 link = leaf->m_flatIndex; link >= 0; link = nodes[link >> 2].m_parentLink) {
+				const dgInt32 laneMask = 0x0f & ~((2 << (link & 3)) - 1);
+				if (laneMask) {
+					SubmitFlatPairs(leaf, link >> 2, laneMask, leaf, timestep, threadID);
+				}
+			}
+		}
+	} else {
+		const dgBodyInfo* const bodyArray = &m_world->m_bodiesMemory[0];
+		for (dgInt32 i = start; i < end; i ++) {
+			dgBody* const body = bodyArray[i].m_body;
+			dgBroadPhaseNode* const leaf = body->GetBroadPhase();
+			dgAssert(leaf->IsLeafNode());
+
+			const dgBroadPhaseNode* topLeaf = leaf;
+			dgBroadPhaseAggregate* const aggregate = body->GetBroadPhaseAggregate();
+			if (aggregate) {
+				// pairs inside the aggregate come from its own tree
+				for (dgBroadPhaseNode* ptr = leaf; !ptr->m_parent->IsAggregate(); ptr = ptr->m_parent) {
+					dgBroadPhaseTreeNode* const parent = (dgBroadPhaseTreeNode*)ptr->m_parent;
+					dgBroadPhaseNode* const sibling = (parent->m_right != ptr) ? parent->m_right : parent->m_left;
+					SubmitPairs(leaf, sibling, timestep, 0, threadID);
+				}
+				topLeaf = aggregate;
+			}
+			SubmitFlatPairs(leaf, 0, 0x0f, topLeaf, timestep, threadID);
+		}
+	}
+}
+
+void dgBroadPhaseBvh4::ForEachBodyInAABB(const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const
+{
+	if (!HasFlatTree()) {
+		dgBroadPhaseMixed::ForEachBodyInAABB(minBox, maxBox, callback, userData);
+		return;
+	}
+
+	const dgBvh4Box box (minBox, maxBox);
+	const dgBroadPhaseBvh4Node* const nodes = &m_flatNodes[0];
+	const dgBroadPhaseNode* leafPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+
+	dgInt32 pool[DG_BROADPHASE_MAX_STACK_DEPTH];
+	pool[0] = 0;
+	dgInt32 stack = 1;
+	while (stack) {
+		stack--;
+		const dgBroadPhaseBvh4Node& node = nodes[pool[stack]];
+		const dgInt32 overlap = box.Overlap(node);
+		for (dgInt32 i = 0; i < node.m_count; i ++) {
+			if (overlap & (1 << i)) {
+				const dgBroadPhaseNode* const leaf = node.m_leaf[i];
+				if (leaf) {
+					dgBody* const body = leaf->GetBody();
+					if (body) {
+						if (dgOverlapTest(body->GetStateMinAABB(), body->GetStateMaxAABB(), minBox, maxBox)) {
+							if (!callback(body, userData)) {
+								return;
+							}
+						}
+					} else {
+						leafPool[0] = leaf;
+						dgBroadPhase::ForEachBodyInAABB(leafPool, 1, minBox, maxBox, callback, userData);
+					}
+				} else {
+					pool[stack] = node.m_child[i];
+					stack ++;
+					dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+				}
+			}
+		}
+	}
+}
+
+void dgBroadPhaseBvh4::RayCast(const dgVector& l0, const dgVector& l1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const
+{
+	if (!HasFlatTree()) {
+		dgBroadPhaseMixed::RayCast(l0, l1, filter, prefilter, userData);
+		return;
+	}
+
+	if (filter) {
+		dgVector segment(l1 - l0);
+		dgAssert (segment.m_w == dgFloat32 (0.0f));
+		dgFloat32 dist2 = segment.DotProduct(segment).GetScalar();
+		if (dist2 > dgFloat32(1.0e-8f)) {
+			dgFastRayTest ray(l0, l1);
+			const dgBvh4Ray flatRay(ray, dgVector::m_zero, dgVector::m_zero);
+
+			dgLineBox line;
+			line.m_l0 = l0;
+			line.m_l1 = l1;
+			dgVector test(line.m_l0 <= line.m_l1);
+			line.m_boxL0 = (line.m_l0 & test) | line.m_l1.AndNot(test);
+			line.m_boxL1 = (line.m_l1 & test) | line.m_l0.AndNot(test);
+
+			const dgBroadPhaseBvh4Node* const nodes = &m_flatNodes[0];
+			const dgBroadPhaseNode* leafPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+			dgFloat32 leafDistance[DG_BROADPHASE_MAX_STACK_DEPTH];
+			dgBvh4StackEntry stackPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+
+			dgInt32 stack = 0;
+			dgFloat32 maxParam = dgFloat32 (1.2f);
+			dgBvh4PushSorted(stackPool, stack, NULL, 0, dgFloat32(0.0f));
+			while (stack) {
+				stack--;
+				const dgBvh4StackEntry entry (stackPool[stack]);
+				if (entry.m_dist > maxParam) {
+					break;
+				}
+				if (entry.m_leaf) {
+					dgBody* const body = entry.m_leaf->GetBody();
+					if (body) {
+						dgFloat32 param = body->RayCast(line, filter, prefilter, userData, maxParam);
+						if (param < maxParam) {
+							maxParam = param;
+							if (maxParam < dgFloat32(1.0e-8f)) {
+								break;
+							}
+						}
+					} else {
+						leafPool[0] = entry.m_leaf;
+						leafDistance[0] = entry.m_dist;
+						dgBroadPhase::RayCast(leafPool, leafDistance, 1, l0, l1, ray, filter, prefilter, userData);
+					}
+				} else {
+					const dgBroadPhaseBvh4Node& node = nodes[entry.m_node];
+					const dgVector dist (flatRay.Intersect(node));
+					for (dgInt32 i = 0; i < node.m_count; i ++) {
+						if (dist[i] < maxParam) {
+							dgBvh4PushSorted(stackPool, stack, node.m_leaf[i], node.m_child[i], dist[i]);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+dgInt32 dgBroadPhaseBvh4::Collide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
+{
+	if (!HasFlatTree()) {
+		return dgBroadPhaseMixed::Collide(shape, matrix, prefilter, userData, info, maxContacts, threadIndex);
+	}
+
+	dgVector boxP0;
+	dgVector boxP1;
+	dgAssert(matrix.TestOrthogonal());
+	shape->CalcAABB(matrix, boxP0, boxP1);
+
+	const dgBvh4Box box (boxP0, boxP1);
+	const dgBroadPhaseBvh4Node* const nodes = &m_flatNodes[0];
+	const dgBroadPhaseNode* leafPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+	dgInt32 leafOverlap[DG_BROADPHASE_MAX_STACK_DEPTH];
+
+	dgInt32 totalCount = 0;
+	dgInt32 pool[DG_BROADPHASE_MAX_STACK_DEPTH];
+	pool[0] = 0;
+	dgInt32 stack = 1;
+	while (stack && (totalCount < maxContacts)) {
+		stack--;
+		const dgBroadPhaseBvh4Node& node = nodes[pool[stack]];
+		const dgInt32 overlap = box.Overlap(node);
+		for (dgInt32 i = 0; (i < node.m_count) && (totalCount < maxContacts); i ++) {
+			if (overlap & (1 << i)) {
+				if (node.m_leaf[i]) {
+					leafPool[0] = node.m_leaf[i];
+					leafOverlap[0] = 1;
+					totalCount += dgBroadPhase::Collide(leafPool, leafOverlap, 1, boxP0, boxP1, shape, matrix, prefilter, userData, &info[totalCount], maxContacts - totalCount, threadIndex);
+				} else {
+					pool[stack] = node.m_child[i];
+					stack ++;
+					dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+				}
+			}
+		}
+	}
+	return totalCount;
+}
+
+dgInt32 dgBroadPhaseBvh4::ConvexCast(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
+{
+	if (!HasFlatTree()) {
+		return dgBroadPhaseMixed::ConvexCast(shape, matrix, target, param, prefilter, userData, info, maxContacts, threadIndex);
+	}
+
+	dgVector boxP0;
+	dgVector boxP1;
+	dgAssert(matrix.TestOrthogonal());
+	shape->CalcAABB(matrix, boxP0, boxP1);
+
+	dgVector velocA((target - matrix.m_posit) & dgVector::m_triplexMask);
+	dgVector velocB(dgFloat32(0.0f));
+	dgFastRayTest ray(dgVector(dgFloat32(0.0f)), velocA);
+	const dgBvh4Ray flatRay(ray, boxP0, boxP1);
+
+	const dgBroadPhaseBvh4Node* const nodes = &m_flatNodes[0];
+	const dgBroadPhaseNode* leafPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+	dgFloat32 leafDistance[DG_BROADPHASE_MAX_STACK_DEPTH];
+	dgConvexCastReturnInfo leafInfo[DG_CONVEX_CAST_POOLSIZE];
+	dgBvh4StackEntry stackPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+
+	maxContacts = dgMin (maxContacts, DG_CONVEX_CAST_POOLSIZE);
+	dgAssert (!maxContacts || (maxContacts && info));
+
+	dgInt32 stack = 0;
+	dgInt32 totalCount = 0;
+	dgFloat32 maxParam = dgFloat32 (1.0f);
+	dgBvh4PushSorted(stackPool, stack, NULL, 0, dgFloat32(0.0f));
+	while (stack) {
+		stack--;
+		const dgBvh4StackEntry entry (stackPool[stack]);
+		if (entry.m_dist > maxParam) {
+			break;
+		}
+		if (entry.m_leaf) {
+			// the leaf is cast on its own and the hits are merged the same way the tree walk does
+			leafPool[0] = entry.m_leaf;
+			leafDistance[0] = entry.m_dist;
+			dgFloat32 leafParam = maxParam;
+			dgInt32 count = dgBroadPhase::ConvexCast(leafPool, leafDistance, 1, velocA, velocB, ray, shape, matrix, target, &leafParam, prefilter, userData, leafInfo, maxContacts, threadIndex);
+			if (leafParam < maxParam) {
+				if ((leafParam - maxParam) < dgFloat32(-1.0e-3f)) {
+					totalCount = 0;
+				}
+				maxParam = leafParam;
+				count = dgMin (count, maxContacts - totalCount);
+				if (count) {
+					memcpy (&info[totalCount], leafInfo, count * sizeof (dgConvexCastReturnInfo));
+					totalCount += count;
+				}
+				if (maxParam < dgFloat32 (1.0e-8f)) {
+					break;
+				}
+			}
+		} else {
+			const dgBroadPhaseBvh4Node& node = nodes[entry.m_node];
+			const dgVector dist (flatRay.Intersect(node));
+			for (dgInt32 i = 0; i < node.m_count; i ++) {
+				if (dist[i] < maxParam) {
+					dgBvh4PushSorted(stackPool, stack, node.m_leaf[i], node.m_child[i], dist[i]);
+				}
+			}
+		}
+	}
+	*param = maxParam;
+	return totalCount;
+}
+
+void dgBroadPhaseBvh4::CastPacket(const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 threadID) const
+{
+	if (!HasFlatTree()) {
+		dgBroadPhaseMixed::CastPacket(descriptor, packet, threadID);
+	} else {
+		// the flattened nodes already test four boxes per query at once, so each query walks them on its own
+		dgBroadPhase::CastPacket(descriptor, packet, threadID);
+	}
+}
@@ -0,0 +1,121 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef __DG_BROADPHASE_BVH4_H_
+#define __DG_BROADPHASE_BVH4_H_
+
+#include "dgPhysicsStdafx.h"
+#include "dgBroadPhaseMixed.h"
+
+
+// a node of the flattened tree holds the boxes of its four children one axis per vector,
+// so one vector compare tests all four children. a child is either a leaf (a body or an aggregate)
+// or the index of another node, unused lanes have an empty box.
+DG_MSC_VECTOR_ALIGMENT
+class dgBroadPhaseBvh4Node
+{
+	public:
+	dgVector m_minX;
+	dgVector m_minY;
+	dgVector m_minZ;
+	dgVector m_maxX;
+	dgVector m_maxY;
+	dgVector m_maxZ;
+	dgBroadPhaseNode* m_leaf[4];
+	dgInt32 m_child[4];
+	dgInt32 m_parentLink;
+	dgInt32 m_count;
+	dgInt32 m_lock;
+} DG_GCC_VECTOR_ALIGMENT;
+
+
+// the binary tree of the mixed broad phase is kept for insertion, removal and aggregates,
+// pair finding and scene queries run on a flattened copy with four children per node.
+// body motion refits the flattened tree in place, topology changes flatten it again
+// and the binary tree is only rebuilt when the flattened tree cost drifts too far.
+class dgBroadPhaseBvh4: public dgBroadPhaseMixed
+{
+	public:
+	DG_CLASS_ALLOCATOR(allocator);
+
+	dgBroadPhaseBvh4(dgWorld* const world);
+	virtual ~dgBroadPhaseBvh4();
+
+	protected:
+	class dgFlattenTask
+	{
+		public:
+		dgBroadPhaseNode* m_node;
+		dgInt32 m_parentLink;
+		dgInt32 m_nodeIndex;
+	};
+
+	class dgFlattenDescriptor
+	{
+		public:
+		dgBroadPhaseBvh4* m_broadPhase;
+		dgFlattenTask* m_tasks;
+		dgFloat64 m_entropy[DG_MAX_THREADS_HIVE_COUNT];
+	};
+
+	virtual dgInt32 GetType() const;
+	virtual void Add(dgBody* const body);
+	virtual void Remove(dgBody* const body);
+	virtual void UpdateBody(dgBody* const body, dgInt32 threadIndex);
+	virtual void ResetEntropy();
+	virtual void UpdateFitness();
+	virtual void InvalidateCache();
+	virtual void DestroyAggregate(dgBroadPhaseAggregate* const aggregate);
+	virtual void LinkAggregate(dgBroadPhaseAggregate* const aggregate);
+	virtual void UnlinkAggregate(dgBroadPhaseAggregate* const aggregate);
+	virtual void FindCollidingPairs(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+
+	virtual void ForEachBodyInAABB(const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const;
+	virtual void RayCast(const dgVector& p0, const dgVector& p1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const;
+	virtual dgInt32 Collide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
+	virtual dgInt32 ConvexCast(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
+	virtual void CastPacket(const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 threadID) const;
+
+	private:
+	bool HasFlatTree() const;
+	void BuildFlatTree();
+	void RefitLeaf(const dgBroadPhaseNode* const leaf);
+	dgFloat64 CalculateFlatEntropy();
+	dgInt32 CountFlatNodes(dgBroadPhaseNode* const root) const;
+	dgInt32 InitFlatNode(dgInt32 nodeIndex, dgBroadPhaseNode* const node, dgInt32 parentLink, dgFlattenTask* const internalNodes);
+	void FlattenSubtree(dgBroadPhaseNode* const root, dgInt32 nodeIndex, dgInt32 parentLink);
+	void SubmitFlatPairs(dgBroadPhaseNode* const leaf, dgInt32 nodeIndex, dgInt32 laneMask, const dgBroadPhaseNode* const skipLeaf, dgFloat32 timestep, dgInt32 threadID);
+	void SubmitLeafPair(dgBroadPhaseNode* const leaf0, dgBroadPhaseNode* const leaf1, dgFloat32 timestep, dgInt32 threadID);
+
+	static void CountFlatNodesKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void FlattenSubtreeKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void FlatEntropyKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+
+	dgArray<dgBroadPhaseBvh4Node> m_flatNodes;
+	dgFloat64 m_flatEntropy;
+	dgInt32 m_flatNodesCount;
+	bool m_flatTreeDirty;
+
+	static dgVector m_emptyMin;
+	static dgVector m_emptyMax;
+};
+
+#endif
@@ -0,0 +1,988 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "dgPhysicsStdafx.h"
+#include "dgBody.h"
+#include "dgWorld.h"
+#include "dgCollisionInstance.h"
+#include "dgBroadPhaseHashGrid.h"
+#include "dgBroadPhaseAggregate.h"
+
+
+#define DG_HASHGRID_CELL_SCALE		dgFloat32 (2.0f)
+#define DG_HASHGRID_MIN_CELL_SIZE	dgFloat32 (1.0e-2f)
+#define DG_HASHGRID_MAX_CELL		dgFloat32 (1.0e7f)
+#define DG_HASHGRID_MAX_SPAN		8
+#define DG_HASHGRID_MAX_PASSES		4
+
+
+DG_INLINE dgUnsigned32 dgHashGridKey(dgInt32 x, dgInt32 y, dgInt32 z)
+{
+	dgUnsigned32 key = (dgUnsigned32(x) * 73856093u) ^ (dgUnsigned32(y) * 19349663u) ^ (dgUnsigned32(z) * 83492791u);
+	// spread the bits so that the top byte used for bucketing is well distributed
+	key ^= key >> 16;
+	key *= 0x85ebca6bu;
+	key ^= key >> 13;
+	return key;
+}
+
+class dgHashGridPairContext
+{
+	public:
+	dgBroadPhaseHashGrid* m_broadPhase;
+	dgBody* m_body;
+	dgFloat32 m_timestep;
+	dgInt32 m_threadID;
+};
+
+class dgHashGridCollideContext
+{
+	public:
+	const dgBroadPhaseHashGrid* m_broadPhase;
+	dgCollisionInstance* m_shape;
+	const dgMatrix* m_matrix;
+	dgVector m_boxP0;
+	dgVector m_boxP1;
+	OnRayPrecastAction m_prefilter;
+	void* m_userData;
+	dgConvexCastReturnInfo* m_info;
+	dgInt32 m_maxContacts;
+	dgInt32 m_totalCount;
+	dgInt32 m_threadIndex;
+} DG_GCC_VECTOR_ALIGMENT;
+
+class dgHashGridCastContext: public dgHashGridCollideContext
+{
+	public:
+	dgVector m_velocA;
+	dgVector m_velocB;
+	const dgVector* m_target;
+	dgFastRayTest* m_ray;
+	dgFloat32 m_maxParam;
+} DG_GCC_VECTOR_ALIGMENT;
+
+
+dgBroadPhaseHashGrid::dgBroadPhaseHashGrid(dgWorld* const world)
+	:dgBroadPhaseMixed(world)
+	,m_gridNodes(world->GetAllocator())
+	,m_gridBodies(world->GetAllocator())
+	,m_gridEntries(world->GetAllocator())
+	,m_gridSlots(world->GetAllocator())
+	,m_escapedBodies(world->GetAllocator())
+	,m_gridMinBox(dgFloat32(0.0f))
+	,m_gridMaxBox(dgFloat32(0.0f))
+	,m_cellSize(dgFloat32(0.0f))
+	,m_invCellSize(dgFloat32(0.0f))
+	,m_gridCount(0)
+	,m_gridBodyCount(0)
+	,m_entryCount(0)
+	,m_escapedCount(0)
+	,m_gridValid(false)
+{
+}
+
+dgBroadPhaseHashGrid::~dgBroadPhaseHashGrid()
+{
+	for (dgInt32 i = 0; i < m_gridCount; i ++) {
+		delete m_gridNodes[i];
+	}
+}
+
+dgInt32 dgBroadPhaseHashGrid::GetType() const
+{
+	return dgWorld::m_broadphaseHashGrid;
+}
+
+bool dgBroadPhaseHashGrid::IsGridNode(const dgBroadPhaseNode* const node) const
+{
+	const dgInt32 index = node->m_flatIndex;
+	return (index >= 0) && (index < m_gridCount) && (m_gridNodes[index] == node);
+}
+
+void dgBroadPhaseHashGrid::Add(dgBody* const body)
+{
+	dgAssert (!body->GetCollision()->IsType (dgCollision::dgCollisionNull_RTTI));
+	if (body->GetCollision()->IsType(dgCollision::dgCollisionMesh_RTTI) || (body->GetInvMass().m_w == dgFloat32(0.0f))) {
+		dgBroadPhaseMixed::Add(body);
+	} else {
+		AddGridBody(body);
+	}
+}
+
+void dgBroadPhaseHashGrid::AddGridBody(dgBody* const body)
+{
+	// the body stays out of the cells until the next build
+	dgBroadPhaseBodyNode* const bodyNode = new (m_world->GetAllocator()) dgBroadPhaseBodyNode(body);
+	bodyNode->m_updateNode = m_updateList.Append(bodyNode);
+	m_gridNodes.ResizeIfNecessary(m_gridCount + 1);
+	bodyNode->m_flatIndex = m_gridCount;
+	m_gridNodes[m_gridCount] = bodyNode;
+	m_gridCount ++;
+}
+
+void dgBroadPhaseHashGrid::RemoveGridNode(dgBroadPhaseNode* const node)
+{
+	const dgInt32 index = node->m_flatIndex;
+	m_gridCount --;
+	m_gridNodes[index] = m_gridNodes[m_gridCount];
+	m_gridNodes[index]->m_flatIndex = index;
+	node->m_flatIndex = -1;
+
+	// the cells refer to bodies by index, they can not be used until the next build
+	m_gridValid = false;
+}
+
+void dgBroadPhaseHashGrid::Remove(dgBody* const body)
+{
+	dgBroadPhaseBodyNode* const node = body->GetBroadPhase();
+	if (node && IsGridNode(node)) {
+		if (node->m_updateNode) {
+			m_updateList.Remove(node->m_updateNode);
+		}
+		RemoveGridNode(node);
+		delete node;
+	} else {
+		dgBroadPhaseMixed::Remove(body);
+	}
+}
+
+void dgBroadPhaseHashGrid::CheckStaticDynamic(dgBody* const body, dgFloat32 mass)
+{
+	dgBroadPhaseNode* const node = body->GetBroadPhase();
+	if (node && !body->GetBroadPhaseAggregate()) {
+		const bool static0 = body->GetMass().m_w >= DG_INFINITE_MASS;
+		const bool static1 = mass >= DG_INFINITE_MASS;
+		if (static0 ^ static1) {
+			Remove(body);
+			if (static1) {
+				dgBroadPhaseMixed::Add(body);
+			} else {
+				AddGridBody(body);
+			}
+		}
+	}
+}
+
+void dgBroadPhaseHashGrid::UpdateBody(dgBody* const body, dgInt32 threadIndex)
+{
+	dgBroadPhaseNode* const node = body->GetBroadPhase();
+	if (node && IsGridNode(node)) {
+		// a body leaving its cells is tested linearly by the queries until the next build
+		const dgInt32 index = node->m_flatIndex;
+		if (m_gridValid && (index < m_gridBodyCount)) {
+			dgGridBody& cell = m_gridBodies[index];
+			if (!cell.m_escaped) {
+				dgInt32 cellMin[3];
+				dgInt32 cellMax[3];
+				CalculateCellRange(body->GetStateMinAABB(), body->GetStateMaxAABB(), cellMin, cellMax);
+				const bool inside = (cellMin[0] >= cell.m_cellMin[0]) && (cellMin[1] >= cell.m_cellMin[1]) && (cellMin[2] >= cell.m_cellMin[2]) &&
+									(cellMax[0] <= cell.m_cellMax[0]) && (cellMax[1] <= cell.m_cellMax[1]) && (cellMax[2] <= cell.m_cellMax[2]);
+				if (!inside && !dgInterlockedExchange(&cell.m_escaped, 1)) {
+					const dgInt32 escapedIndex = dgAtomicExchangeAndAdd(&m_escapedCount, 1);
+					m_escapedBodies[escapedIndex] = index;
+				}
+			}
+		}
+	} else {
+		dgBroadPhaseMixed::UpdateBody(body, threadIndex);
+	}
+}
+
+void dgBroadPhaseHashGrid::UpdateFitness()
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgBroadPhaseMixed::UpdateFitness();
+	BuildGrid();
+}
+
+void dgBroadPhaseHashGrid::InvalidateCache()
+{
+	dgBroadPhaseMixed::InvalidateCache();
+	BuildGrid();
+}
+
+void dgBroadPhaseHashGrid::CalculateCellRange(const dgVector& minBox, const dgVector& maxBox, dgInt32* const cellMin, dgInt32* const cellMax) const
+{
+	const dgVector scale(m_invCellSize);
+	const dgVector maxCell(DG_HASHGRID_MAX_CELL);
+	const dgVector minCell(-DG_HASHGRID_MAX_CELL);
+	const dgVector p0((minBox * scale).GetMax(minCell).GetMin(maxCell).Floor());
+	const dgVector p1((maxBox * scale).GetMax(minCell).GetMin(maxCell).Floor());
+	for (dgInt32 i = 0; i < 3; i ++) {
+		cellMin[i] = dgInt32(p0[i]);
+		cellMax[i] = dgInt32(p1[i]);
+	}
+}
+
+void dgBroadPhaseHashGrid::BinBodies(dgGridDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	dgBroadPhaseNode** const nodes = &m_gridNodes[0];
+	dgGridBody* const bodies = &m_gridBodies[0];
+
+	dgVector minBox(descriptor->m_minBox[threadID]);
+	dgVector maxBox(descriptor->m_maxBox[threadID]);
+	dgFloat64 sideSum = dgFloat32(0.0f);
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBroadPhaseNode* const node = nodes[i];
+		const dgBody* const body = node->GetBody();
+		dgGridBody& cell = bodies[i];
+		cell.m_node = node;
+		cell.m_escaped = 0;
+		CalculateCellRange(body->GetStateMinAABB(), body->GetStateMaxAABB(), cell.m_cellMin, cell.m_cellMax);
+
+		const dgInt32 spanX = cell.m_cellMax[0] - cell.m_cellMin[0] + 1;
+		const dgInt32 spanY = cell.m_cellMax[1] - cell.m_cellMin[1] + 1;
+		const dgInt32 spanZ = cell.m_cellMax[2] - cell.m_cellMin[2] + 1;
+		if ((spanX > DG_HASHGRID_MAX_SPAN) || (spanY > DG_HASHGRID_MAX_SPAN) || (spanZ > DG_HASHGRID_MAX_SPAN)) {
+			cell.m_firstSlot = -1;
+			descriptor->m_oversized = 1;
+		} else {
+			// the slot count is turned into the first slot by the prefix sum
+			cell.m_firstSlot = spanX * spanY * spanZ;
+			minBox = minBox.GetMin(body->GetStateMinAABB());
+			maxBox = maxBox.GetMax(body->GetStateMaxAABB());
+			const dgVector side(body->GetStateMaxAABB() - body->GetStateMinAABB());
+			sideSum += dgMax(side.m_x, dgMax(side.m_y, side.m_z));
+		}
+	}
+	descriptor->m_minBox[threadID] = minBox;
+	descriptor->m_maxBox[threadID] = maxBox;
+	descriptor->m_sideSum[threadID] += sideSum;
+}
+
+void dgBroadPhaseHashGrid::MoveOversizedBodies()
+{
+	// bodies spanning too many cells go to the tree, the last records are visited first so the swap is safe
+	for (dgInt32 i = m_gridCount - 1; i >= 0; i --) {
+		if (m_gridBodies[i].m_firstSlot < 0) {
+			dgBroadPhaseNode* const node = m_gridNodes[i];
+			dgBody* const body = node->GetBody();
+			RemoveGridNode(node);
+			node->SetAABB(body->GetStateMinAABB(), body->GetStateMaxAABB());
+			AddNode(node);
+		}
+	}
+}
+
+void dgBroadPhaseHashGrid::BuildEntries(dgGridDescriptor* const descriptor, dgInt32 block)
+{
+	const dgInt32 start = dgInt32(dgInt64(block) * m_gridCount / descriptor->m_blockCount);
+	const dgInt32 end = dgInt32(dgInt64(block + 1) * m_gridCount / descriptor->m_blockCount);
+
+	const dgGridBody* const bodies = &m_gridBodies[0];
+	dgGridSlot* const slots = &m_gridSlots[0];
+	dgGridEntry* const scratch = descriptor->m_scratch;
+	dgInt32* const histogram = descriptor->m_histogram[block];
+	memset(histogram, 0, 256 * sizeof(dgInt32));
+
+	for (dgInt32 i = start; i < end; i ++) {
+		const dgGridBody& cell = bodies[i];
+		dgInt32 slot = cell.m_firstSlot;
+		for (dgInt32 z = cell.m_cellMin[2]; z <= cell.m_cellMax[2]; z ++) {
+			for (dgInt32 y = cell.m_cellMin[1]; y <= cell.m_cellMax[1]; y ++) {
+				for (dgInt32 x = cell.m_cellMin[0]; x <= cell.m_cellMax[0]; x ++) {
+					const dgUnsigned32 key = dgHashGridKey(x, y, z);
+					scratch[slot].m_key = key;
+					scratch[slot].m_slot = slot;
+					slots[slot].m_body = i;
+					histogram[key >> 24] ++;
+					slot ++;
+				}
+			}
+		}
+	}
+}
+
+void dgBroadPhaseHashGrid::ScatterEntries(dgGridDescriptor* const descriptor, dgInt32 block)
+{
+	const dgInt32 start = dgInt32(dgInt64(block) * m_gridCount / descriptor->m_blockCount);
+	const dgInt32 end = dgInt32(dgInt64(block + 1) * m_gridCount / descriptor->m_blockCount);
+
+	const dgGridBody* const bodies = &m_gridBodies[0];
+	const dgInt32 firstSlot = (start < m_gridCount) ? bodies[start].m_firstSlot : m_entryCount;
+	const dgInt32 lastSlot = (end < m_gridCount) ? bodies[end].m_firstSlot : m_entryCount;
+
+	dgGridEntry* const entries = &m_gridEntries[0];
+	const dgGridEntry* const scratch = descriptor->m_scratch;
+	dgInt32* const offsets = descriptor->m_histogram[block];
+	for (dgInt32 i = firstSlot; i < lastSlot; i ++) {
+		const dgGridEntry& entry = scratch[i];
+		const dgInt32 index = offsets[entry.m_key >> 24];
+		offsets[entry.m_key >> 24] = index + 1;
+		entries[index] = entry;
+	}
+}
+
+void dgBroadPhaseHashGrid::SortBucket(dgGridDescriptor* const descriptor, dgInt32 bucket)
+{
+	const dgInt32 start = descriptor->m_bucketStart[bucket];
+	const dgInt32 end = descriptor->m_bucketStart[bucket + 1];
+	dgGridEntry* const entries = &m_gridEntries[0];
+	if ((end - start) > 1) {
+		// all keys of the bucket share the top byte
+		dgRadixSort(&entries[start], &descriptor->m_scratch[start], end - start, 3, GetEntryKey);
+	}
+
+	dgGridSlot* const slots = &m_gridSlots[0];
+	for (dgInt32 i = start; i < end; ) {
+		const dgUnsigned32 key = entries[i].m_key;
+		dgInt32 j = i + 1;
+		while ((j < end) && (entries[j].m_key == key)) {
+			j ++;
+		}
+		for (dgInt32 k = i; k < j; k ++) {
+			dgGridSlot& slot = slots[entries[k].m_slot];
+			slot.m_runStart = i;
+			slot.m_runCount = j - i;
+		}
+		i = j;
+	}
+}
+
+dgInt32 dgBroadPhaseHashGrid::GetEntryKey(const dgGridEntry* const entry, void* const)
+{
+	return dgInt32(entry->m_key & 0xffffff);
+}
+
+void dgBroadPhaseHashGrid::BinBodiesKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgGridDescriptor* const descriptor = (dgGridDescriptor*)context;
+	descriptor->m_broadPhase->BinBodies(descriptor, start, end, threadID);
+}
+
+void dgBroadPhaseHashGrid::BuildEntriesKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgGridDescriptor* const descriptor = (dgGridDescriptor*)context;
+	for (dgInt32 i = start; i < end; i ++) {
+		descriptor->m_broadPhase->BuildEntries(descriptor, i);
+	}
+}
+
+void dgBroadPhaseHashGrid::ScatterEntriesKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgGridDescriptor* const descriptor = (dgGridDescriptor*)context;
+	for (dgInt32 i = start; i < end; i ++) {
+		descriptor->m_broadPhase->ScatterEntries(descriptor, i);
+	}
+}
+
+void dgBroadPhaseHashGrid::SortBucketsKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgGridDescriptor* const descriptor = (dgGridDescriptor*)context;
+	for (dgInt32 i = start; i < end; i ++) {
+		descriptor->m_broadPhase->SortBucket(descriptor, i);
+	}
+}
+
+void dgBroadPhaseHashGrid::BuildGrid()
+{
+	DG_TRACKTIME(__FUNCTION__);
+	m_gridValid = true;
+	m_gridBodyCount = 0;
+	m_entryCount = 0;
+	m_escapedCount = 0;
+	if (!m_gridCount) {
+		return;
+	}
+
+	dgGridDescriptor descriptor;
+	descriptor.m_broadPhase = this;
+	for (dgInt32 pass = 0; ; pass ++) {
+		m_gridBodies.ResizeIfNecessary(m_gridCount);
+		for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+			descriptor.m_minBox[i] = dgVector(dgFloat32(1.0e15f));
+			descriptor.m_maxBox[i] = dgVector(dgFloat32(-1.0e15f));
+			descriptor.m_sideSum[i] = dgFloat32(0.0f);
+		}
+		descriptor.m_oversized = 0;
+		m_world->ParallelFor(0, m_gridCount, DG_PARALLEL_BODY_GRAIN_SIZE, BinBodiesKernel, &descriptor, "dgBroadPhaseHashGrid::BinBodies");
+
+		if (descriptor.m_oversized) {
+			MoveOversizedBodies();
+			m_gridValid = true;
+			if (!m_gridCount) {
+				return;
+			}
+			continue;
+		}
+
+		// the cell is sized after the average body, it only changes when the average drifts too far
+		dgFloat64 sideSum = dgFloat32(0.0f);
+		for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+			sideSum += descriptor.m_sideSum[i];
+		}
+		const dgFloat32 cellSize = dgMax(dgFloat32(sideSum / m_gridCount) * DG_HASHGRID_CELL_SCALE, DG_HASHGRID_MIN_CELL_SIZE);
+		if ((pass < DG_HASHGRID_MAX_PASSES) && ((m_cellSize == dgFloat32(0.0f)) || (cellSize > m_cellSize * dgFloat32(2.0f)) || (cellSize < m_cellSize * dgFloat32(0.5f)))) {
+			m_cellSize = cellSize;
+			m_invCellSize = dgFloat32(1.0f) / cellSize;
+			continue;
+		}
+		break;
+	}
+
+	// the grid box is snapped to whole cells, so it contains the boxes of the bodies that did not leave their cells
+	dgVector minBox(descriptor.m_minBox[0]);
+	dgVector maxBox(descriptor.m_maxBox[0]);
+	for (dgInt32 i = 1; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		minBox = minBox.GetMin(descriptor.m_minBox[i]);
+		maxBox = maxBox.GetMax(descriptor.m_maxBox[i]);
+	}
+	const dgVector scale(m_invCellSize);
+	const dgVector size(m_cellSize);
+	m_gridMinBox = ((minBox * scale).Floor() * size) & dgVector::m_triplexMask;
+	m_gridMaxBox = (((maxBox * scale).Floor() + dgVector::m_one) * size) & dgVector::m_triplexMask;
+
+	dgGridBody* const bodies = &m_gridBodies[0];
+	dgInt32 slotCount = 0;
+	for (dgInt32 i = 0; i < m_gridCount; i ++) {
+		const dgInt32 count = bodies[i].m_firstSlot;
+		bodies[i].m_firstSlot = slotCount;
+		slotCount += count;
+	}
+	m_entryCount = slotCount;
+	m_gridEntries.ResizeIfNecessary(slotCount);
+	m_gridSlots.ResizeIfNecessary(slotCount);
+	m_escapedBodies.ResizeIfNecessary(m_gridCount);
+
+	dgFrameArenaScope scratchScope (m_world->m_frameArena, 0);
+	descriptor.m_scratch = dgFrameAlloca(m_world->m_frameArena, dgGridEntry, slotCount, 0);
+	descriptor.m_blockCount = dgMin(m_world->GetThreadCount(), m_gridCount);
+	m_world->ParallelFor(0, descriptor.m_blockCount, 1, BuildEntriesKernel, &descriptor, "dgBroadPhaseHashGrid::BuildEntries");
+
+	// the entries are bucketed by the top byte of the key, each block writes its part of every bucket
+	dgInt32 offset = 0;
+	for (dgInt32 i = 0; i < 256; i ++) {
+		descriptor.m_bucketStart[i] = offset;
+		for (dgInt32 j = 0; j < descriptor.m_blockCount; j ++) {
+			const dgInt32 count = descriptor.m_histogram[j][i];
+			descriptor.m_histogram[j][i] = offset;
+			offset += count;
+		}
+	}
+	descriptor.m_bucketStart[256] = offset;
+	dgAssert(offset == slotCount);
+
+	m_world->ParallelFor(0, descriptor.m_blockCount, 1, ScatterEntriesKernel, &descriptor, "dgBroadPhaseHashGrid::ScatterEntries");
+	m_world->ParallelFor(0, 256, 1, SortBucketsKernel, &descriptor, "dgBroadPhaseHashGrid::SortBuckets");
+
+	m_gridBodyCount = m_gridCount;
+	m_gridValid = true;
+}
+
+bool dgBroadPhaseHashGrid::FindRun(dgUnsigned32 key, dgInt32& runStart, dgInt32& runCount) const
+{
+	const dgGridEntry* const entries = &m_gridEntries[0];
+	dgInt32 i0 = 0;
+	dgInt32 i1 = m_entryCount;
+	while (i0 < i1) {
+		const dgInt32 middle = (i0 + i1) >> 1;
+		if (entries[middle].m_key < key) {
+			i0 = middle + 1;
+		} else {
+			i1 = middle;
+		}
+	}
+	if ((i0 < m_entryCount) && (entries[i0].m_key == key)) {
+		runStart = i0;
+		runCount = m_gridSlots[entries[i0].m_slot].m_runCount;
+		return true;
+	}
+	return false;
+}
+
+void dgBroadPhaseHashGrid::SubmitGridPairs(dgInt32 index, bool fullScan, dgFloat32 timestep, dgInt32 threadID)
+{
+	const dgGridBody* const bodies = &m_gridBodies[0];
+	const dgGridEntry* const entries = &m_gridEntries[0];
+	const dgGridSlot* const slots = &m_gridSlots[0];
+
+	const dgGridBody& cell = bodies[index];
+	dgBody* const body0 = cell.m_node->GetBody();
+	const bool test0 = (body0->GetInvMass().m_w != dgFloat32(0.0f));
+
+	dgInt32 slot = cell.m_firstSlot;
+	for (dgInt32 z = cell.m_cellMin[2]; z <= cell.m_cellMax[2]; z ++) {
+		for (dgInt32 y = cell.m_cellMin[1]; y <= cell.m_cellMax[1]; y ++) {
+			for (dgInt32 x = cell.m_cellMin[0]; x <= cell.m_cellMax[0]; x ++) {
+				const dgGridSlot& run = slots[slot];
+				slot ++;
+				for (dgInt32 i = 0; i < run.m_runCount; i ++) {
+					const dgInt32 otherIndex = slots[entries[run.m_runStart + i].m_slot].m_body;
+					// a full scan visits every body, so the pair is left to the lower index
+					if ((otherIndex == index) || (fullScan && (otherIndex < index))) {
+						continue;
+					}
+
+					// the pair belongs to the first cell both bodies share, this also rejects hash collisions
+					const dgGridBody& other = bodies[otherIndex];
+					if ((x == dgMax(cell.m_cellMin[0], other.m_cellMin[0])) && (y == dgMax(cell.m_cellMin[1], other.m_cellMin[1])) && (z == dgMax(cell.m_cellMin[2], other.m_cellMin[2])) &&
+						(x <= other.m_cellMax[0]) && (y <= other.m_cellMax[1]) && (z <= other.m_cellMax[2])) {
+						dgBody* const body1 = other.m_node->GetBody();
+						if (test0 || (body1->GetInvMass().m_w != dgFloat32(0.0f))) {
+							AddPair(body0, body1, timestep, threadID);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (m_rootNode) {
+		SubmitPairs(cell.m_node, m_rootNode, timestep, 0, threadID);
+	}
+}
+
+dgInt32 dgBroadPhaseHashGrid::SubmitGridLeafPair(dgBody* const body, void* const context)
+{
+	dgHashGridPairContext* const pairContext = (dgHashGridPairContext*)context;
+	pairContext->m_broadPhase->AddPair(pairContext->m_body, body, pairContext->m_timestep, pairContext->m_threadID);
+	return 1;
+}
+
+void dgBroadPhaseHashGrid::SubmitTreeLeafPairs(dgBroadPhaseNode* const leaf, bool fullScan, dgFloat32 timestep, dgInt32 threadID)
+{
+	if (fullScan) {
+		// the grid bodies find the tree leaves themselves
+		if (leaf->IsAggregate()) {
+			((dgBroadPhaseAggregate*)leaf)->SubmitSelfPairs(timestep, threadID);
+		}
+
+		for (dgBroadPhaseNode* ptr = leaf; ptr->m_parent; ptr = ptr->m_parent) {
+			dgBroadPhaseTreeNode* const parent = (dgBroadPhaseTreeNode*)ptr->m_parent;
+			dgAssert(!parent->IsLeafNode());
+			dgBroadPhaseNode* const sibling = parent->m_right;
+			if (sibling != ptr) {
+				SubmitPairs(leaf, sibling, timestep, 0, threadID);
+			}
+		}
+	} else {
+		for (dgBroadPhaseNode* ptr = leaf; ptr->m_parent; ptr = ptr->m_parent) {
+			dgBroadPhaseTreeNode* const parent = (dgBroadPhaseTreeNode*)ptr->m_parent;
+			if (!parent->IsAggregate()) {
+				dgAssert(!parent->IsLeafNode());
+				dgBroadPhaseNode* const rightSibling = parent->m_right;
+				if (rightSibling != ptr) {
+					SubmitPairs(leaf, rightSibling, timestep, 0, threadID);
+				} else {
+					SubmitPairs(leaf, parent->m_left, timestep, 0, threadID);
+				}
+			}
+		}
+
+		// a moving tree body may touch grid bodies at rest, which do not search
+		dgBody* const body = leaf->GetBody();
+		if (m_gridCount && body) {
+			dgHashGridPairContext context;
+			context.m_broadPhase = this;
+			context.m_body = body;
+			context.m_timestep = timestep;
+			context.m_threadID = threadID;
+			ForEachGridBody(body->GetStateMinAABB(), body->GetStateMaxAABB(), SubmitGridLeafPair, &context);
+		}
+	}
+}
+
+void dgBroadPhaseHashGrid::FindCollidingPairs(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgAssert(m_gridValid && (m_gridBodyCount == m_gridCount));
+	const dgFloat32 timestep = descriptor->m_timestep;
+
+	if (descriptor->m_fullScan) {
+		dgBroadPhaseNode** const updateArray = &m_updateArray[0];
+		for (dgInt32 i = start; i < end; i ++) {
+			dgBroadPhaseNode* const leaf = updateArray[i];
+			dgAssert(leaf->IsLeafNode());
+			if (IsGridNode(leaf)) {
+				SubmitGridPairs(leaf->m_flatIndex, true, timestep, threadID);
+			} else {
+				SubmitTreeLeafPairs(leaf, true, timestep, threadID);
+			}
+		}
+	} else {
+		const dgBodyInfo* const bodyArray = &m_world->m_bodiesMemory[0];
+		for (dgInt32 i = start; i < end; i ++) {
+			dgBroadPhaseNode* const leaf = bodyArray[i].m_body->GetBroadPhase();
+			dgAssert(leaf->IsLeafNode());
+			if (IsGridNode(leaf)) {
+				SubmitGridPairs(leaf->m_flatIndex, false, timestep, threadID);
+			} else {
+				SubmitTreeLeafPairs(leaf, false, timestep, threadID);
+			}
+		}
+	}
+}
+
+bool dgBroadPhaseHashGrid::ForEachGridBody(const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const
+{
+	if (!m_gridValid) {
+		// bodies were removed since the last build
+		for (dgInt32 i = 0; i < m_gridCount; i ++) {
+			dgBody* const body = m_gridNodes[i]->GetBody();
+			if (dgOverlapTest(body->GetStateMinAABB(), body->GetStateMaxAABB(), minBox, maxBox)) {
+				if (!callback(body, userData)) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	const dgGridBody* const bodies = &m_gridBodies[0];
+	if (m_gridBodyCount && dgOverlapTest(m_gridMinBox, m_gridMaxBox, minBox, maxBox)) {
+		dgInt32 cellMin[3];
+		dgInt32 cellMax[3];
+		CalculateCellRange(minBox.GetMax(m_gridMinBox), maxBox.GetMin(m_gridMaxBox), cellMin, cellMax);
+		const dgInt64 cellCount = dgInt64(cellMax[0] - cellMin[0] + 1) * dgInt64(cellMax[1] - cellMin[1] + 1) * dgInt64(cellMax[2] - cellMin[2] + 1);
+		if (cellCount > m_gridBodyCount) {
+			// a query covering more cells than there are bodies is cheaper as a linear scan
+			for (dgInt32 i = 0; i < m_gridBodyCount; i ++) {
+				if (!bodies[i].m_escaped) {
+					dgBody* const body = bodies[i].m_node->GetBody();
+					if (dgOverlapTest(body->GetStateMinAABB(), body->GetStateMaxAABB(), minBox, maxBox)) {
+						if (!callback(body, userData)) {
+							return false;
+						}
+					}
+				}
+			}
+		} else {
+			const dgGridEntry* const entries = &m_gridEntries[0];
+			const dgGridSlot* const slots = &m_gridSlots[0];
+			for (dgInt32 z = cellMin[2]; z <= cellMax[2]; z ++) {
+				for (dgInt32 y = cellMin[1]; y <= cellMax[1]; y ++) {
+					for (dgInt32 x = cellMin[0]; x <= cellMax[0]; x ++) {
+						dgInt32 runStart;
+						dgInt32 runCount;
+						if (FindRun(dgHashGridKey(x, y, z), runStart, runCount)) {
+							for (dgInt32 i = 0; i < runCount; i ++) {
+								// a body is visited in the first of its cells inside the query
+								const dgGridBody& cell = bodies[slots[entries[runStart + i].m_slot].m_body];
+								if (!cell.m_escaped && (x == dgMax(cell.m_cellMin[0], cellMin[0])) && (y == dgMax(cell.m_cellMin[1], cellMin[1])) && (z == dgMax(cell.m_cellMin[2], cellMin[2])) &&
+									(x <= cell.m_cellMax[0]) && (y <= cell.m_cellMax[1]) && (z <= cell.m_cellMax[2])) {
+									dgBody* const body = cell.m_node->GetBody();
+									if (dgOverlapTest(body->GetStateMinAABB(), body->GetStateMaxAABB(), minBox, maxBox)) {
+										if (!callback(body, userData)) {
+											return false;
+										}
+									}
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// escaped bodies and bodies added after the last build are not in the cells
+	for (dgInt32 i = 0; i < m_escapedCount; i ++) {
+		dgBody* const body = bodies[m_escapedBodies[i]].m_node->GetBody();
+		if (dgOverlapTest(body->GetStateMinAABB(), body->GetStateMaxAABB(), minBox, maxBox)) {
+			if (!callback(body, userData)) {
+				return false;
+			}
+		}
+	}
+	for (dgInt32 i = m_gridBodyCount; i < m_gridCount; i ++) {
+		dgBody* const body = m_gridNodes[i]->GetBody();
+		if (dgOverlapTest(body->GetStateMinAABB(), body->GetStateMaxAABB(), minBox, maxBox)) {
+			if (!callback(body, userData)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void dgBroadPhaseHashGrid::ForEachBodyInAABB(const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const
+{
+	dgBroadPhaseMixed::ForEachBodyInAABB(minBox, maxBox, callback, userData);
+	if (m_gridCount) {
+		ForEachGridBody(minBox, maxBox, callback, userData);
+	}
+}
+
+void dgBroadPhaseHashGrid::RayCastGrid(const dgVector& l0, const dgVector& l1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const
+{
+	dgFastRayTest ray(l0, l1);
+
+	dgLineBox line;
+	line.m_l0 = l0;
+	line.m_l1 = l1;
+	dgVector test(line.m_l0 <= line.m_l1);
+	line.m_boxL0 = (line.m_l0 & test) | line.m_l1.AndNot(test);
+	line.m_boxL1 = (line.m_l1 & test) | line.m_l0.AndNot(test);
+
+	dgFloat32 maxParam = dgFloat32 (1.2f);
+	if (!m_gridValid) {
+		for (dgInt32 i = 0; (i < m_gridCount) && (maxParam > dgFloat32(1.0e-8f)); i ++) {
+			dgBody* const body = m_gridNodes[i]->GetBody();
+			if (ray.BoxIntersect(body->GetStateMinAABB(), body->GetStateMaxAABB()) < maxParam) {
+				maxParam = dgMin(maxParam, body->RayCast(line, filter, prefilter, userData, maxParam));
+			}
+		}
+		return;
+	}
+
+	const dgGridBody* const bodies = &m_gridBodies[0];
+	const dgFloat32 entryParam = m_gridBodyCount ? ray.BoxIntersect(m_gridMinBox, m_gridMaxBox) : dgFloat32(1.2f);
+	if (entryParam < dgFloat32(1.0f)) {
+		const dgGridEntry* const entries = &m_gridEntries[0];
+		const dgGridSlot* const slots = &m_gridSlots[0];
+		const dgVector diff(l1 - l0);
+		const dgVector entry(l0 + diff.Scale(entryParam));
+
+		dgInt32 gridMin[3];
+		dgInt32 gridMax[3];
+		dgInt32 cell[3];
+		dgInt32 prev[3];
+		dgInt32 step[3];
+		dgFloat32 next[3];
+		dgFloat32 delta[3];
+		CalculateCellRange(m_gridMinBox, m_gridMaxBox, gridMin, gridMax);
+		CalculateCellRange(entry, entry, cell, prev);
+		for (dgInt32 i = 0; i < 3; i ++) {
+			// the walk starts outside every body so the first cell visits all its bodies
+			cell[i] = dgClamp(cell[i], gridMin[i], gridMax[i]);
+			prev[i] = gridMin[i] - 2;
+			if (diff[i] > dgFloat32(1.0e-12f)) {
+				step[i] = 1;
+				delta[i] = m_cellSize / diff[i];
+				next[i] = (dgFloat32(cell[i] + 1) * m_cellSize - l0[i]) / diff[i];
+			} else if (diff[i] < dgFloat32(-1.0e-12f)) {
+				step[i] = -1;
+				delta[i] = -m_cellSize / diff[i];
+				next[i] = (dgFloat32(cell[i]) * m_cellSize - l0[i]) / diff[i];
+			} else {
+				step[i] = 0;
+				delta[i] = dgFloat32(1.0e10f);
+				next[i] = dgFloat32(1.0e10f);
+			}
+		}
+
+		dgFloat32 cellParam = entryParam;
+		while ((cellParam <= dgFloat32(1.0f)) && (cellParam < maxParam)) {
+			dgInt32 runStart;
+			dgInt32 runCount;
+			if (FindRun(dgHashGridKey(cell[0], cell[1], cell[2]), runStart, runCount)) {
+				for (dgInt32 i = 0; i < runCount; i ++) {
+					// a body is cast in the first cell of the walk inside its range
+					const dgGridBody& record = bodies[slots[entries[runStart + i].m_slot].m_body];
+					const bool inCell = (cell[0] >= record.m_cellMin[0]) && (cell[0] <= record.m_cellMax[0]) &&
+										(cell[1] >= record.m_cellMin[1]) && (cell[1] <= record.m_cellMax[1]) &&
+										(cell[2] >= record.m_cellMin[2]) && (cell[2] <= record.m_cellMax[2]);
+					const bool inPrev = (prev[0] >= record.m_cellMin[0]) && (prev[0] <= record.m_cellMax[0]) &&
+										(prev[1] >= record.m_cellMin[1]) && (prev[1] <= record.m_cellMax[1]) &&
+										(prev[2] >= record.m_cellMin[2]) && (prev[2] <= record.m_cellMax[2]);
+					if (!record.m_escaped && inCell && !inPrev) {
+						dgBody* const body = record.m_node->GetBody();
+						if (ray.BoxIntersect(body->GetStateMinAABB(), body->GetStateMaxAABB()) < maxParam) {
+							maxParam = dgMin(maxParam, body->RayCast(line, filter, prefilter, userData, maxParam));
+							if (maxParam < dgFloat32(1.0e-8f)) {
+								return;
+							}
+						}
+					}
+				}
+			}
+
+			dgInt32 axis = (next[0] < next[1]) ? 0 : 1;
+			axis = (next[axis] < next[2]) ? axis : 2;
+			cellParam = next[axis];
+			next[axis] += delta[axis];
+			prev[0] = cell[0];
+			prev[1] = cell[1];
+			prev[2] = cell[2];
+			cell[axis] += step[axis];
+			if ((cell[axis] < gridMin[axis]) || (cell[axis] > gridMax[axis])) {
+				break;
+			}
+		}
+	}
+
+	for (dgInt32 i = 0; (i < m_escapedCount) && (maxParam > dgFloat32(1.0e-8f)); i ++) {
+		dgBody* const body = bodies[m_escapedBodies[i]].m_node->GetBody();
+		if (ray.BoxIntersect(body->GetStateMinAABB(), body->GetStateMaxAABB()) < maxParam) {
+			maxParam = dgMin(maxParam, body->RayCast(line, filter, prefilter, userData, maxParam));
+		}
+	}
+	for (dgInt32 i = m_gridBodyCount; (i < m_gridCount) && (maxParam > dgFloat32(1.0e-8f)); i ++) {
+		dgBody* const body = m_gridNodes[i]->GetBody();
+		if (ray.BoxIntersect(body->GetStateMinAABB(), body->GetStateMaxAABB()) < maxParam) {
+			maxParam = dgMin(maxParam, body->RayCast(line, filter, prefilter, userData, maxParam));
+		}
+	}
+}
+
+void dgBroadPhaseHashGrid::RayCast(const dgVector& l0, const dgVector& l1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const
+{
+	dgBroadPhaseMixed::RayCast(l0, l1, filter, prefilter, userData);
+	if (filter && m_gridCount) {
+		dgVector segment(l1 - l0);
+		dgAssert (segment.m_w == dgFloat32 (0.0f));
+		dgFloat32 dist2 = segment.DotProduct(segment).GetScalar();
+		if (dist2 > dgFloat32(1.0e-8f)) {
+			RayCastGrid(l0, l1, filter, prefilter, userData);
+		}
+	}
+}
+
+dgInt32 dgBroadPhaseHashGrid::CollideGridBody(dgBody* const body, void* const context)
+{
+	dgHashGridCollideContext* const collideContext = (dgHashGridCollideContext*)context;
+	const dgBroadPhaseNode* leafPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+	dgInt32 leafOverlap[DG_BROADPHASE_MAX_STACK_DEPTH];
+	leafPool[0] = body->GetBroadPhase();
+	leafOverlap[0] = 1;
+
+	const dgInt32 totalCount = collideContext->m_totalCount;
+	collideContext->m_totalCount += collideContext->m_broadPhase->dgBroadPhase::Collide(leafPool, leafOverlap, 1, collideContext->m_boxP0, collideContext->m_boxP1, collideContext->m_shape, *collideContext->m_matrix,
+		collideContext->m_prefilter, collideContext->m_userData, &collideContext->m_info[totalCount], collideContext->m_maxContacts - totalCount, collideContext->m_threadIndex);
+	return (collideContext->m_totalCount < collideContext->m_maxContacts) ? 1 : 0;
+}
+
+dgInt32 dgBroadPhaseHashGrid::Collide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
+{
+	dgInt32 totalCount = dgBroadPhaseMixed::Collide(shape, matrix, prefilter, userData, info, maxContacts, threadIndex);
+	if (m_gridCount && (totalCount < maxContacts)) {
+		dgHashGridCollideContext context;
+		dgAssert(matrix.TestOrthogonal());
+		shape->CalcAABB(matrix, context.m_boxP0, context.m_boxP1);
+		context.m_broadPhase = this;
+		context.m_shape = shape;
+		context.m_matrix = &matrix;
+		context.m_prefilter = prefilter;
+		context.m_userData = userData;
+		context.m_info = info;
+		context.m_maxContacts = maxContacts;
+		context.m_totalCount = totalCount;
+		context.m_threadIndex = threadIndex;
+		ForEachGridBody(context.m_boxP0, context.m_boxP1, CollideGridBody, &context);
+		totalCount = context.m_totalCount;
+	}
+	return totalCount;
+}
+
+dgInt32 dgBroadPhaseHashGrid::ConvexCastGridBody(dgBody* const body, void* const context)
+{
+	dgHashGridCastContext* const castContext = (dgHashGridCastContext*)context;
+	const dgVector minBox(body->GetStateMinAABB() - castContext->m_boxP1);
+	const dgVector maxBox(body->GetStateMaxAABB() - castContext->m_boxP0);
+	const dgFloat32 dist = castContext->m_ray->BoxIntersect(minBox, maxBox);
+	if (dist < castContext->m_maxParam) {
+		// the body is cast on its own and the hits are merged the same way the tree walk does
+		const dgBroadPhaseNode* leafPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+		dgFloat32 leafDistance[DG_BROADPHASE_MAX_STACK_DEPTH];
+		dgConvexCastReturnInfo leafInfo[DG_CONVEX_CAST_POOLSIZE];
+		leafPool[0] = body->GetBroadPhase();
+		leafDistance[0] = dist;
+
+		dgFloat32 leafParam = castContext->m_maxParam;
+		dgInt32 count = castContext->m_broadPhase->dgBroadPhase::ConvexCast(leafPool, leafDistance, 1, castContext->m_velocA, castContext->m_velocB, *castContext->m_ray, castContext->m_shape, *castContext->m_matrix, *castContext->m_target,
+			&leafParam, castContext->m_prefilter, castContext->m_userData, leafInfo, castContext->m_maxContacts, castContext->m_threadIndex);
+		if (leafParam < castContext->m_maxParam) {
+			if ((leafParam - castContext->m_maxParam) < dgFloat32(-1.0e-3f)) {
+				castContext->m_totalCount = 0;
+			}
+			castContext->m_maxParam = leafParam;
+			count = dgMin (count, castContext->m_maxContacts - castContext->m_totalCount);
+			if (count) {
+				memcpy (&castContext->m_info[castContext->m_totalCount], leafInfo, count * sizeof (dgConvexCastReturnInfo));
+				castContext->m_totalCount += count;
+			}
+		}
+	}
+	return (castContext->m_maxParam > dgFloat32 (1.0e-8f)) ? 1 : 0;
+}
+
+dgInt32 dgBroadPhaseHashGrid::ConvexCastGrid(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32& maxParam, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 totalCount, dgInt32 maxContacts, dgInt32 threadIndex) const
+{
+	dgHashGridCastContext context;
+	dgAssert(matrix.TestOrthogonal());
+	shape->CalcAABB(matrix, context.m_boxP0, context.m_boxP1);
+	context.m_velocA = (target - matrix.m_posit) & dgVector::m_triplexMask;
+	context.m_velocB = dgVector(dgFloat32(0.0f));
+	dgFastRayTest ray(dgVector(dgFloat32(0.0f)), context.m_velocA);
+
+	context.m_broadPhase = this;
+	context.m_shape = shape;
+	context.m_matrix = &matrix;
+	context.m_target = &target;
+	context.m_ray = &ray;
+	context.m_prefilter = prefilter;
+	context.m_userData = userData;
+	context.m_info = info;
+	context.m_maxContacts = maxContacts;
+	context.m_totalCount = totalCount;
+	context.m_threadIndex = threadIndex;
+	context.m_maxParam = maxParam;
+
+	// the grid is searched with the box swept along the whole cast
+	const dgVector sweptMin(context.m_boxP0.GetMin(context.m_boxP0 + context.m_velocA));
+	const dgVector sweptMax(context.m_boxP1.GetMax(context.m_boxP1 + context.m_velocA));
+	ForEachGridBody(sweptMin, sweptMax, ConvexCastGridBody, &context);
+	maxParam = context.m_maxParam;
+	return context.m_totalCount;
+}
+
+dgInt32 dgBroadPhaseHashGrid::ConvexCast(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
+{
+	dgFloat32 maxParam = *param;
+	maxContacts = dgMin (maxContacts, DG_CONVEX_CAST_POOLSIZE);
+	dgInt32 totalCount = dgBroadPhaseMixed::ConvexCast(shape, matrix, target, &maxParam, prefilter, userData, info, maxContacts, threadIndex);
+	if (m_gridCount && (maxParam > dgFloat32 (1.0e-8f))) {
+		totalCount = ConvexCastGrid(shape, matrix, target, maxParam, prefilter, userData, info, totalCount, maxContacts, threadIndex);
+	}
+	*param = maxParam;
+	return totalCount;
+}
+
+void dgBroadPhaseHashGrid::CastPacket(const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 threadID) const
+{
+	// the tree part is traversed as a packet, the grid is walked once per query
+	dgBroadPhaseMixed::CastPacket(descriptor, packet, threadID);
+	if (m_gridCount) {
+		for (dgInt32 i = 0; i < 4; i ++) {
+			dgCastBatchHit& hit = packet.m_hits[i];
+			if ((packet.m_activeMask & (1 << i)) && (hit.m_param > dgFloat32(1.0e-8f))) {
+				if (descriptor->m_shape) {
+					dgConvexCastReturnInfo info;
+					dgFloat32 param = hit.m_param;
+					const dgInt32 count = ConvexCastGrid(descriptor->m_shape, packet.m_matrix[i], packet.m_target[i], param, descriptor->m_prefilter, descriptor->m_userData, &info, 0, 1, threadID);
+					if (count && (param < hit.m_param)) {
+						SetCastBatchHit(hit, info, param);
+					}
+				} else {
+					dgCastBatchRay ray;
+					ray.m_descriptor = descriptor;
+					ray.m_hit = &hit;
+					const dgLineBox& line = packet.m_line[i];
+					RayCastGrid(line.m_l0, line.m_l1, CastBatchRayFilter, descriptor->m_prefilter ? CastBatchRayPrefilter : NULL, &ray);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,141 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef __DG_BROADPHASE_HASH_GRID_H_
+#define __DG_BROADPHASE_HASH_GRID_H_
+
+#include "dgPhysicsStdafx.h"
+#include "dgBroadPhaseMixed.h"
+
+
+// the binary tree of the mixed broad phase keeps static bodies, aggregates and bodies too big for the grid.
+// all other bodies are binned every step into the cells of a uniform grid their box overlaps, the hashed
+// cell keys are radix sorted and a pair is submitted in the first cell the two bodies share.
+class dgBroadPhaseHashGrid: public dgBroadPhaseMixed
+{
+	public:
+	DG_CLASS_ALLOCATOR(allocator);
+
+	dgBroadPhaseHashGrid(dgWorld* const world);
+	virtual ~dgBroadPhaseHashGrid();
+
+	protected:
+	// the cells a body was binned into, a body moving out of them is escaped until the next build
+	class dgGridBody
+	{
+		public:
+		dgBroadPhaseNode* m_node;
+		dgInt32 m_cellMin[3];
+		dgInt32 m_cellMax[3];
+		dgInt32 m_firstSlot;
+		dgInt32 m_escaped;
+	};
+
+	// one entry per cell of a body, the slot is the position of the entry before sorting
+	class dgGridEntry
+	{
+		public:
+		dgUnsigned32 m_key;
+		dgInt32 m_slot;
+	};
+
+	// the body of a slot and the run of sorted entries with the same key
+	class dgGridSlot
+	{
+		public:
+		dgInt32 m_body;
+		dgInt32 m_runStart;
+		dgInt32 m_runCount;
+	};
+
+	class dgGridDescriptor
+	{
+		public:
+		dgVector m_minBox[DG_MAX_THREADS_HIVE_COUNT];
+		dgVector m_maxBox[DG_MAX_THREADS_HIVE_COUNT];
+		dgFloat64 m_sideSum[DG_MAX_THREADS_HIVE_COUNT];
+		dgBroadPhaseHashGrid* m_broadPhase;
+		dgGridEntry* m_scratch;
+		dgInt32 m_blockCount;
+		dgInt32 m_oversized;
+		dgInt32 m_bucketStart[257];
+		dgInt32 m_histogram[DG_MAX_THREADS_HIVE_COUNT][256];
+	};
+
+	virtual dgInt32 GetType() const;
+	virtual void Add(dgBody* const body);
+	virtual void Remove(dgBody* const body);
+	virtual void UpdateBody(dgBody* const body, dgInt32 threadIndex);
+	virtual void CheckStaticDynamic(dgBody* const body, dgFloat32 mass);
+	virtual void UpdateFitness();
+	virtual void InvalidateCache();
+	virtual void FindCollidingPairs(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+
+	virtual void ForEachBodyInAABB(const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const;
+	virtual void RayCast(const dgVector& p0, const dgVector& p1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const;
+	virtual dgInt32 Collide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
+	virtual dgInt32 ConvexCast(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
+	virtual void CastPacket(const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 threadID) const;
+
+	private:
+	bool IsGridNode(const dgBroadPhaseNode* const node) const;
+	void AddGridBody(dgBody* const body);
+	void RemoveGridNode(dgBroadPhaseNode* const node);
+	void MoveOversizedBodies();
+	void BuildGrid();
+	void BinBodies(dgGridDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	void BuildEntries(dgGridDescriptor* const descriptor, dgInt32 block);
+	void ScatterEntries(dgGridDescriptor* const descriptor, dgInt32 block);
+	void SortBucket(dgGridDescriptor* const descriptor, dgInt32 bucket);
+	void CalculateCellRange(const dgVector& minBox, const dgVector& maxBox, dgInt32* const cellMin, dgInt32* const cellMax) const;
+	bool FindRun(dgUnsigned32 key, dgInt32& runStart, dgInt32& runCount) const;
+	bool ForEachGridBody(const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const;
+	void RayCastGrid(const dgVector& l0, const dgVector& l1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const;
+	dgInt32 ConvexCastGrid(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32& maxParam, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 totalCount, dgInt32 maxContacts, dgInt32 threadIndex) const;
+	void SubmitGridPairs(dgInt32 index, bool fullScan, dgFloat32 timestep, dgInt32 threadID);
+	void SubmitTreeLeafPairs(dgBroadPhaseNode* const leaf, bool fullScan, dgFloat32 timestep, dgInt32 threadID);
+
+	static void BinBodiesKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void BuildEntriesKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void ScatterEntriesKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void SortBucketsKernel(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static dgInt32 GetEntryKey(const dgGridEntry* const entry, void* const context);
+	static dgInt32 SubmitGridLeafPair(dgBody* const body, void* const context);
+	static dgInt32 CollideGridBody(dgBody* const body, void* const context);
+	static dgInt32 ConvexCastGridBody(dgBody* const body, void* const context);
+
+	dgArray<dgBroadPhaseNode*> m_gridNodes;
+	dgArray<dgGridBody> m_gridBodies;
+	dgArray<dgGridEntry> m_gridEntries;
+	dgArray<dgGridSlot> m_gridSlots;
+	dgArray<dgInt32> m_escapedBodies;
+	dgVector m_gridMinBox;
+	dgVector m_gridMaxBox;
+	dgFloat32 m_cellSize;
+	dgFloat32 m_invCellSize;
+	dgInt32 m_gridCount;
+	dgInt32 m_gridBodyCount;
+	dgInt32 m_entryCount;
+	dgInt32 m_escapedCount;
+	bool m_gridValid;
+};
+
+#endif
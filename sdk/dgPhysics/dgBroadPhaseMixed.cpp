@@ -123,6 +123,58 @@ dgInt32 dgBroadPhaseMixed::ConvexCast(dgCollisionInstance* const shape, const dg
 	return totalCount;
 }
 
+void dgBroadPhaseMixed::CastPacket(const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 threadID) const
+{
+	if (m_rootNode && packet.m_activeMask) {
+		dgVector distance[DG_BROADPHASE_MAX_STACK_DEPTH];
+		dgInt32 laneMask[DG_BROADPHASE_MAX_STACK_DEPTH];
+		const dgBroadPhaseNode* stackPool[DG_BROADPHASE_MAX_STACK_DEPTH];
+
+		// all queries of the packet walk the tree together, each node keeps the lanes that overlap it
+		stackPool[0] = m_rootNode;
+		laneMask[0] = packet.Intersect(m_rootNode->m_minBox, m_rootNode->m_maxBox, distance[0]);
+		dgInt32 stack = laneMask[0] ? 1 : 0;
+		while (stack) {
+			stack--;
+			const dgVector dist(distance[stack]);
+			const dgInt32 mask = laneMask[stack] & (dist <= packet.m_maxParam).GetSignMask();
+			if (mask) {
+				const dgBroadPhaseNode* const me = stackPool[stack];
+				// a leaf, or a node reached by a single query, is finished one query at a time
+				if (me->IsLeafNode() || me->IsAggregate() || !(mask & (mask - 1))) {
+					for (dgInt32 i = 0; i < 4; i ++) {
+						if ((mask & (1 << i)) && (dist[i] <= packet.m_maxParam[i])) {
+							CastPacketLane(descriptor, packet, i, me, dist[i], threadID);
+						}
+					}
+				} else {
+					dgVector leftDist;
+					dgVector rightDist;
+					const dgBroadPhaseNode* const left = me->GetLeft();
+					const dgBroadPhaseNode* const right = me->GetRight();
+					const dgInt32 leftMask = packet.Intersect(left->m_minBox, left->m_maxBox, leftDist) & mask;
+					const dgInt32 rightMask = packet.Intersect(right->m_minBox, right->m_maxBox, rightDist) & mask;
+
+					// push the far child first so that the near one is visited first
+					const bool leftFirst = leftDist.AddHorizontal().GetScalar() <= rightDist.AddHorizontal().GetScalar();
+					const dgBroadPhaseNode* const nodes[] = {leftFirst ? right : left, leftFirst ? left : right};
+					const dgInt32 masks[] = {leftFirst ? rightMask : leftMask, leftFirst ? leftMask : rightMask};
+					const dgVector dists[] = {leftFirst ? rightDist : leftDist, leftFirst ? leftDist : rightDist};
+					for (dgInt32 i = 0; i < 2; i ++) {
+						if (masks[i]) {
+							stackPool[stack] = nodes[i];
+							laneMask[stack] = masks[i];
+							distance[stack] = dists[i];
+							stack++;
+							dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
 dgInt32 dgBroadPhaseMixed::Collide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
 {
 	dgInt32 totalCount = 0;
@@ -339,17 +391,15 @@ void dgBroadPhaseMixed::DestroyAggregate(dgBroadPhaseAggregate* const aggregate)
 	RemoveNode(aggregate);
 }
 
-void dgBroadPhaseMixed::FindCollidingPairs(dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const nodePtr, dgInt32 threadID)
+void dgBroadPhaseMixed::FindCollidingPairs(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	DG_TRACKTIME(__FUNCTION__);
 	const dgFloat32 timestep = descriptor->m_timestep;
 
-	dgList<dgBroadPhaseNode*>::dgListNode* node = nodePtr;
-	const dgInt32 threadCount = descriptor->m_world->GetThreadCount();
-
 	if (descriptor->m_fullScan) {
-		while (node) {
-			dgBroadPhaseNode* const broadPhaseNode = node->GetInfo();
+		dgBroadPhaseNode** const updateArray = &m_updateArray[0];
+		for (dgInt32 i = start; i < end; i ++) {
+			dgBroadPhaseNode* const broadPhaseNode = updateArray[i];
 			dgAssert(broadPhaseNode->IsLeafNode());
 			dgAssert(!broadPhaseNode->GetBody() || (broadPhaseNode->GetBody()->GetBroadPhase() == broadPhaseNode));
 
@@ -365,18 +415,11 @@ void dgBroadPhaseMixed::FindCollidingPairs(dgBroadphaseSyncDescriptor* const des
 					SubmitPairs(broadPhaseNode, sibling, timestep, 0, threadID);
 				}
 			}
-	
-			for (dgInt32 i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
 		}
 
 	} else {
 		const dgBodyInfo* const bodyArray = &m_world->m_bodiesMemory[0];
-		const dgInt32 bodyCount = descriptor->m_atomicPendingBodiesCount;
-		dgInt32* const atomicIndex = &descriptor->m_atomicIndex;
-
-		for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+		for (dgInt32 i = start; i < end; i ++) {
 			dgBroadPhaseNode* const broadPhaseNode = bodyArray[i].m_body->GetBroadPhase();
 			dgAssert(broadPhaseNode->IsLeafNode());
 			dgAssert(!broadPhaseNode->GetBody() || (broadPhaseNode->GetBody()->GetBroadPhase() == broadPhaseNode));
@@ -387,9 +430,9 @@ void dgBroadPhaseMixed::FindCollidingPairs(dgBroadphaseSyncDescriptor* const des
 					dgAssert(!parent->IsLeafNode());
 					dgBroadPhaseNode* const rightSibling = parent->m_right;
 					if (rightSibling != ptr) {
-						SubmitPairs(broadPhaseNode, rightSibling, timestep, threadCount, threadID);
+						SubmitPairs(broadPhaseNode, rightSibling, timestep, 0, threadID);
 					} else {
-						SubmitPairs(broadPhaseNode, parent->m_left, timestep, threadCount, threadID);
+						SubmitPairs(broadPhaseNode, parent->m_left, timestep, 0, threadID);
 					}
 				}
 			}
@@ -46,12 +46,13 @@ class dgBroadPhaseMixed: public dgBroadPhase
 	virtual void LinkAggregate (dgBroadPhaseAggregate* const aggregate); 
 	virtual void UnlinkAggregate (dgBroadPhaseAggregate* const aggregate); 
 	virtual void CheckStaticDynamic(dgBody* const body, dgFloat32 mass) {}
-	virtual void FindCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const node, dgInt32 threadID);
+	virtual void FindCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
 
 	void RayCast (const dgVector& p0, const dgVector& p1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const;
 	dgInt32 Collide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
 	dgInt32 ConvexCast (dgCollisionInstance* const shape, const dgMatrix& p0, const dgVector& p1, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
 	void ForEachBodyInAABB (const dgVector& q0, const dgVector& q1, OnBodiesInAABB callback, void* const userData) const;
+	virtual void CastPacket (const dgCastBatchDescriptor* const descriptor, dgCastPacket& packet, dgInt32 threadID) const;
 
 	void ResetEntropy ();
 	void AddNode(dgBroadPhaseNode* const node);	
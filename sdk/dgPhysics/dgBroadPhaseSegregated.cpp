@@ -520,17 +520,18 @@ dgInt32 dgBroadPhaseSegregated::Collide(dgCollisionInstance* const shape, const
 	return totalCount;
 }
 
-void dgBroadPhaseSegregated::FindCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const nodePtr, dgInt32 threadID)
+void dgBroadPhaseSegregated::FindCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	DG_TRACKTIME(__FUNCTION__);
 	const dgFloat32 timestep = descriptor->m_timestep;
 
-	dgList<dgBroadPhaseNode*>::dgListNode* node = nodePtr;
-	const dgInt32 threadCount = descriptor->m_world->GetThreadCount();
-
 	if (descriptor->m_fullScan) {
-		while (node) {
-			dgBroadPhaseNode* const broadPhaseNode = node->GetInfo();
+		dgBroadPhaseNode** const updateArray = &m_updateArray[0];
+		for (dgInt32 i = start; i < end; i ++) {
+			dgBroadPhaseNode* const broadPhaseNode = updateArray[i];
+			if (!((broadPhaseNode->GetBody() && (broadPhaseNode->GetBody()->GetInvMass().m_w != dgFloat32(0.0f))) || broadPhaseNode->IsAggregate())) {
+				continue;
+			}
 			dgAssert(broadPhaseNode->IsLeafNode());
 			dgAssert(!broadPhaseNode->GetBody() || (broadPhaseNode->GetBody()->GetBroadPhase() == broadPhaseNode));
 
@@ -546,19 +547,11 @@ void dgBroadPhaseSegregated::FindCollidingPairs (dgBroadphaseSyncDescriptor* con
 					SubmitPairs(broadPhaseNode, sibling, timestep, 0, threadID);
 				}
 			}
-
-			for (dgInt32 i = 0; i < threadCount; i++) {
-				dgBroadPhaseNode* const info = node ? node->GetInfo() : NULL;
-				node = (info && ((info->GetBody() && (info->GetBody()->GetInvMass().m_w != dgFloat32(0.0f))) || info->IsAggregate())) ? node->GetNext() : NULL;
-			}
-		}	
+		}
 
 	} else {
 		const dgBodyInfo* const bodyArray = &m_world->m_bodiesMemory[0];
-		const dgInt32 bodyCount = descriptor->m_atomicPendingBodiesCount;
-		dgInt32* const atomicIndex = &descriptor->m_atomicIndex;
-
-		for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(atomicIndex, 1)) {
+		for (dgInt32 i = start; i < end; i ++) {
 			dgBroadPhaseNode* const broadPhaseNode = bodyArray[i].m_body->GetBroadPhase();
 
 			dgAssert(broadPhaseNode->IsLeafNode());
@@ -575,7 +568,7 @@ void dgBroadPhaseSegregated::FindCollidingPairs (dgBroadphaseSyncDescriptor* con
 
 					dgBroadPhaseNode* const leftSibling = parent->m_left;
 					if (leftSibling && (leftSibling != ptr)) {
-						SubmitPairs(broadPhaseNode, leftSibling, timestep, threadCount, threadID);
+						SubmitPairs(broadPhaseNode, leftSibling, timestep, 0, threadID);
 					}
 				}
 			}
@@ -45,7 +45,7 @@ class dgBroadPhaseSegregated : public dgBroadPhase
 	virtual void CheckStaticDynamic(dgBody* const body, dgFloat32 mass);
 	virtual void LinkAggregate(dgBroadPhaseAggregate* const aggregate);
 	virtual void UnlinkAggregate(dgBroadPhaseAggregate* const aggregate);
-	virtual void FindCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const node, dgInt32 threadID);
+	virtual void FindCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 start, dgInt32 end, dgInt32 threadID);
 
 	virtual void ResetEntropy();
 	virtual void UpdateFitness();
@@ -67,6 +67,7 @@ enum dgCollisionID
 	m_userMesh,
 	m_sceneCollision,
 	m_compoundFracturedCollision,
+	m_tiledHeightField,
 
 	// these are for internal use only	
 	m_contactCloud,
@@ -187,6 +188,17 @@ class dgCollisionInfo
 		dgInt32 m_childrenProxyCount;
 	};
 
+	struct dgTiledHeightMapCollisionData
+	{
+		dgInt32 m_tileSize;
+		dgInt32 m_tileCount;
+		dgInt32 m_gridsDiagonals;
+		dgInt32 m_elevationDataType;		// 0 = 32 bit floats, 1 = unsigned 16 bit intergers
+		dgFloat32 m_verticalScale;
+		dgFloat32 m_horizonalScale_x;
+		dgFloat32 m_horizonalScale_z;
+	};
+
 	dgMatrix m_offsetMatrix;
 	dgInstanceMaterial m_collisionMaterial;
 	dgInt32 m_collisionType;
@@ -205,6 +217,7 @@ class dgCollisionInfo
 		dgCollisionBVHData m_bvhCollision;
 		dgHeightMapCollisionData m_heightFieldCollision;
 		dgSceneData m_sceneCollision;
+		dgTiledHeightMapCollisionData m_tiledHeightFieldCollision;
 		dgFloat32 m_paramArray[32];
 	};
 }DG_GCC_VECTOR_ALIGMENT;
@@ -241,6 +254,7 @@ class dgCollision
 		dgCollisionHeightField_RTTI					= 1<<19,
 		dgCollisionScene_RTTI						= 1<<20,
 		dgCollisionCompoundBreakable_RTTI			= 1<<21,
+		dgCollisionTiledHeightField_RTTI			= 1<<22,
 	};													 
 	
 	DG_CLASS_ALLOCATOR(allocator)
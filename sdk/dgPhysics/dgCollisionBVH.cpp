@@ -290,14 +290,6 @@ dgFloat32 dgCollisionBVH::RayCast (const dgVector& localP0, const dgVector& loca
 dgIntersectStatus dgCollisionBVH::GetPolygon (void* const context, const dgFloat32* const polygon, dgInt32 strideInBytes, const dgInt32* const indexArray, dgInt32 indexCount, dgFloat32 hitDistance)
 {
 	dgPolygonMeshDesc& data = (*(dgPolygonMeshDesc*) context);
-	if (data.m_faceCount >= DG_MAX_COLLIDING_FACES) {
-		dgTrace (("buffer Over float, try using a lower resolution mesh for collision\n"));
-		return t_StopSearh;
-	}
-	if ((data.m_globalIndexCount + indexCount * 2 + 3) >= DG_MAX_COLLIDING_INDICES) {
-		dgTrace (("buffer Over float, try using a lower resolution mesh for collision\n"));
-		return t_StopSearh;
-	}
 
 	if (data.m_me->GetDebugCollisionCallback()) { 
 		dgTriplex triplex[128];
@@ -318,6 +310,16 @@ dgIntersectStatus dgCollisionBVH::GetPolygon (void* const context, const dgFloat
 	dgAssert (data.m_vertex == polygon);
 	dgInt32 count = indexCount * 2 + 3;
 
+	// the face buffers grow as needed, there is no limit to the number of faces a query can collect
+	dgPolygonMeshDesc::dgMesh& meshData = *data.m_meshData;
+	if ((data.m_faceCount >= meshData.m_globalFaceIndexCount.GetElementsCapacity()) || ((data.m_globalIndexCount + count) >= meshData.m_globalFaceVertexIndex.GetElementsCapacity())) {
+		data.ReserveFaces (data.m_faceCount * 2, (data.m_globalIndexCount + count) * 2);
+		data.m_faceIndexCount = &meshData.m_globalFaceIndexCount[0];
+		data.m_faceIndexStart = &meshData.m_globalFaceIndexStart[0];
+		data.m_faceVertexIndex = &meshData.m_globalFaceVertexIndex[0];
+		data.m_hitDistance = &meshData.m_globalHitDistance[0];
+	}
+
 	data.m_faceIndexCount[data.m_faceCount] = indexCount;
 //	data.m_faceIndexStart[data.m_faceCount] = data.m_faceCount ? (data.m_faceIndexStart[data.m_faceCount - 1] + data.m_faceIndexCount[data.m_faceCount - 1]) : 0;
 	data.m_faceIndexStart[data.m_faceCount] = data.m_globalIndexCount;
@@ -346,10 +348,11 @@ void dgCollisionBVH::GetCollidingFaces (dgPolygonMeshDesc* const data) const
 
 	data->m_faceCount = 0;
 	data->m_globalIndexCount = 0;
-	data->m_faceIndexCount = data->m_meshData.m_globalFaceIndexCount;
-	data->m_faceIndexStart = data->m_meshData.m_globalFaceIndexStart;
-	data->m_faceVertexIndex = data->m_globalFaceVertexIndex;
-	data->m_hitDistance = data->m_meshData.m_globalHitDistance;
+	data->ReserveFaces (0, 0);
+	data->m_faceIndexCount = &data->m_meshData->m_globalFaceIndexCount[0];
+	data->m_faceIndexStart = &data->m_meshData->m_globalFaceIndexStart[0];
+	data->m_faceVertexIndex = &data->m_meshData->m_globalFaceVertexIndex[0];
+	data->m_hitDistance = &data->m_meshData->m_globalHitDistance[0];
 	ForAllSectors (*data, data->m_boxDistanceTravelInMeshSpace, data->m_maxT, GetPolygon, data);
 }
 
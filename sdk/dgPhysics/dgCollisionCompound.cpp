@@ -27,6 +27,7 @@
 #include "dgCollisionInstance.h"
 #include "dgCollisionUserMesh.h"
 #include "dgCollisionHeightField.h"
+#include "dgCollisionTiledHeightField.h"
 
 
 //////////////////////////////////////////////////////////////////////
@@ -1558,7 +1559,7 @@ dgInt32 dgCollisionCompound::CalculateContacts (dgBroadPhase::dgPair* const pair
 				contactCount = CalculateContactsToCompound (pair, proxy);
 			} else if (body1->m_collision->IsType (dgCollision::dgCollisionBVH_RTTI)) {
 				contactCount = CalculateContactsToCollisionTree (pair, proxy);
-			} else if (body1->m_collision->IsType (dgCollision::dgCollisionHeightField_RTTI)) {
+			} else if (body1->m_collision->IsType (dgCollision::dgCollisionHeightField_RTTI) || body1->m_collision->IsType (dgCollision::dgCollisionTiledHeightField_RTTI)) {
 				contactCount = CalculateContactsToHeightField (pair, proxy);
 			} else {
 				dgAssert (body1->m_collision->IsType (dgCollision::dgCollisionUserMesh_RTTI));
@@ -1920,8 +1921,10 @@ dgInt32 dgCollisionCompound::CalculateContactsToHeightField (dgBroadPhase::dgPai
 	dgCollisionInstance* const terrainInstance = terrainBody->m_collision;
 
 	dgAssert (compoundInstance->GetChildShape() == this);
-	dgAssert (terrainInstance->IsType (dgCollision::dgCollisionHeightField_RTTI));
+	dgAssert (terrainInstance->IsType (dgCollision::dgCollisionHeightField_RTTI) || terrainInstance->IsType (dgCollision::dgCollisionTiledHeightField_RTTI));
+	const bool isTiled = terrainInstance->IsType (dgCollision::dgCollisionTiledHeightField_RTTI);
 	dgCollisionHeightField* const terrainCollision = (dgCollisionHeightField*)terrainInstance->GetChildShape();
+	dgCollisionTiledHeightField* const tiledTerrainCollision = (dgCollisionTiledHeightField*)terrainInstance->GetChildShape();
 
 	proxy.m_body0 = myBody;
 	proxy.m_body1 = terrainBody;
@@ -1950,7 +1953,11 @@ dgInt32 dgCollisionCompound::CalculateContactsToHeightField (dgBroadPhase::dgPai
 		dgVector size (data.m_absMatrix.UnrotateVector(me->m_size));
 		dgVector p0 (origin - size);
 		dgVector p1 (origin + size);
-		terrainCollision->GetLocalAABB (p0, p1, nodeProxi.m_p0, nodeProxi.m_p1);
+		if (isTiled) {
+			tiledTerrainCollision->GetLocalAABB (p0, p1, nodeProxi.m_p0, nodeProxi.m_p1);
+		} else {
+			terrainCollision->GetLocalAABB (p0, p1, nodeProxi.m_p0, nodeProxi.m_p1);
+		}
 		//nodeProxi.m_size = (nodeProxi.m_p1 - nodeProxi.m_p0).Scale (dgFloat32 (0.5f));
 		//nodeProxi.m_origin = (nodeProxi.m_p1 + nodeProxi.m_p0).Scale (dgFloat32 (0.5f));
 		nodeProxi.m_size = dgVector::m_half * (nodeProxi.m_p1 - nodeProxi.m_p0);
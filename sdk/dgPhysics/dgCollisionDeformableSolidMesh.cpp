@@ -213,8 +213,8 @@ dgFloat32 kVolumetricStiffness = dgFloat32(20000000.0f);
 //	dgFloat32* const frictionCoeffecient = dgAlloca(dgFloat32, m_particlesCount);
 
 	dgWorld* const world = m_body->GetWorld();
-	world->m_solverJacobiansMemory.ResizeIfNecessary (GetMemoryBufferSizeInBytes() + 1024);
-	dgVector* const dx = (dgVector*)&world->m_solverJacobiansMemory[0];
+	dgFrameArenaScope scratchScope (world->m_frameArena, 0);
+	dgVector* const dx = (dgVector*)world->m_frameArena.Alloc(GetMemoryBufferSizeInBytes() + 1024, 0);
 	dgVector* const dv = &dx[m_linksCount];
 	dgVector* const dpdv = &dv[m_linksCount];
 	dgVector* const normalAccel = &dpdv[m_linksCount];
@@ -242,7 +242,7 @@ dgFloat32 kVolumetricStiffness = dgFloat32(20000000.0f);
 	dgVector deltaOmega(m_body->m_invWorldInertiaMatrix.RotateVector (m_body->m_externalTorque.Scale (timestep)));
 
 	m_body->m_alpha = dgVector::m_zero;
-	m_body->m_omega = dgVector::m_zero;
+	m_body->GetStateOmega() = dgVector::m_zero;
 	m_body->m_externalForce = dgVector::m_zero;
 	m_body->m_externalTorque = dgVector::m_zero;
 
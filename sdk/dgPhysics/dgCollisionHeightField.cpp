@@ -30,6 +30,7 @@
 dgVector dgCollisionHeightField::m_yMask (0xffffffff, 0, 0xffffffff, 0);
 dgVector dgCollisionHeightField::m_padding (dgFloat32 (0.25f), dgFloat32 (0.25f), dgFloat32 (0.25f), dgFloat32 (0.0f));
 dgVector dgCollisionHeightField::m_elevationPadding (dgFloat32 (0.0f), dgFloat32 (1.0e10f), dgFloat32 (0.0f), dgFloat32 (0.0f));
+dgInt32 dgCollisionHeightField::m_instanceDataLock = 0;
 
 dgInt32 dgCollisionHeightField::m_cellIndices[][4] =
 {
@@ -63,6 +64,8 @@ dgCollisionHeightField::dgCollisionHeightField(
 	,m_height(height)
 	,m_diagonalMode (dgCollisionHeightFieldGridConstruction  (dgClamp (contructionMode, dgInt32 (m_normalDiagonals), dgInt32 (m_starInvertexDiagonals))))
 	,m_horizontalDisplacement(NULL)
+	,m_elevationPyramid(NULL)
+	,m_pyramidLevels(0)
 	,m_verticalScale(verticalScale)
 	,m_horizontalScale_x(horizontalScale_x)
 	,m_horizontalScaleInv_x (dgFloat32 (1.0f) / m_horizontalScale_x)
@@ -230,23 +233,8 @@ dgCollisionHeightField::dgCollisionHeightField(
 	}
 	memcpy (m_atributeMap, atributeMap, m_width * m_height * sizeof (dgInt8));
 
-	dgTree<void*, unsigned>::dgTreeNode* nodeData = world->m_perInstanceData.Find(DG_HIGHTFIELD_DATA_ID);
-	if (!nodeData) {
-		m_instanceData = (dgPerIntanceData*) new dgPerIntanceData();
-		m_instanceData->m_refCount = 0;
-		m_instanceData->m_world = world;
-		for (dgInt32 i = 0 ; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
-			m_instanceData->m_vertex[i] = NULL;
-			m_instanceData->m_vertexCount[i] = 0;
-			m_instanceData->m_vertex[i].SetAllocator(world->GetAllocator());
-			AllocateVertex(world, i);
-		}
-		nodeData = world->m_perInstanceData.Insert (m_instanceData, DG_HIGHTFIELD_DATA_ID);
-	}
-	m_instanceData = (dgPerIntanceData*) nodeData->GetInfo();
-
-	m_instanceData->m_refCount ++;
-
+	AcquireInstanceData(world);
+	BuildElevationPyramid();
 	CalculateAABB();
 	SetCollisionBBox(m_minBox, m_maxBox);
 }
@@ -260,6 +248,8 @@ dgCollisionHeightField::dgCollisionHeightField (dgWorld* const world, dgDeserial
 
 	m_userRayCastCallback = NULL;
 	m_horizontalDisplacement = NULL;
+	m_elevationPyramid = NULL;
+	m_pyramidLevels = 0;
 	deserialization (userData, &m_width, sizeof (dgInt32));
 	deserialization (userData, &m_height, sizeof (dgInt32));
 	deserialization (userData, &m_diagonalMode, sizeof (dgInt32));
@@ -307,40 +297,57 @@ dgCollisionHeightField::dgCollisionHeightField (dgWorld* const world, dgDeserial
 	m_horizontalScaleInv_x = dgFloat32 (1.0f) / m_horizontalScale_x;
 	m_horizontalScaleInv_z = dgFloat32 (1.0f) / m_horizontalScale_z;
 
+	AcquireInstanceData(world);
+	BuildElevationPyramid();
+	SetCollisionBBox(m_minBox, m_maxBox);
+}
+
+dgCollisionHeightField::~dgCollisionHeightField(void)
+{
+	ReleaseInstanceData();
+	dgFreeStack(m_elevationMap);
+	dgFreeStack(m_atributeMap);
+	dgFreeStack(m_diagonals);
+
+	if (m_horizontalDisplacement) {
+		dgFreeStack(m_horizontalDisplacement);
+	}
+
+	if (m_elevationPyramid) {
+		dgFreeStack(m_elevationPyramid);
+	}
+}
+
+void dgCollisionHeightField::AcquireInstanceData(dgWorld* const world)
+{
+	// the tiles of a tiled height field can be created and destroyed from a streaming thread
+	dgScopeSpinLock lock(&m_instanceDataLock);
 	dgTree<void*, unsigned>::dgTreeNode* nodeData = world->m_perInstanceData.Find(DG_HIGHTFIELD_DATA_ID);
 	if (!nodeData) {
 		m_instanceData = (dgPerIntanceData*) new dgPerIntanceData();
 		m_instanceData->m_refCount = 0;
 		m_instanceData->m_world = world;
-		for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i++) {
+		for (dgInt32 i = 0 ; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
 			m_instanceData->m_vertex[i] = NULL;
 			m_instanceData->m_vertexCount[i] = 0;
 			m_instanceData->m_vertex[i].SetAllocator(world->GetAllocator());
 			AllocateVertex(world, i);
 		}
-		nodeData = world->m_perInstanceData.Insert(m_instanceData, DG_HIGHTFIELD_DATA_ID);
+		nodeData = world->m_perInstanceData.Insert (m_instanceData, DG_HIGHTFIELD_DATA_ID);
 	}
-	m_instanceData = (dgPerIntanceData*)nodeData->GetInfo();
-
+	m_instanceData = (dgPerIntanceData*) nodeData->GetInfo();
 	m_instanceData->m_refCount ++;
-	SetCollisionBBox(m_minBox, m_maxBox);
 }
 
-dgCollisionHeightField::~dgCollisionHeightField(void)
+void dgCollisionHeightField::ReleaseInstanceData()
 {
+	dgScopeSpinLock lock(&m_instanceDataLock);
 	m_instanceData->m_refCount --;
 	if (!m_instanceData->m_refCount) {
 		dgWorld* const world = m_instanceData->m_world;
 		delete m_instanceData;
 		world->m_perInstanceData.Remove(DG_HIGHTFIELD_DATA_ID);
 	}
-	dgFreeStack(m_elevationMap);
-	dgFreeStack(m_atributeMap);
-	dgFreeStack(m_diagonals);
-
-	if (m_horizontalDisplacement) {
-		dgFreeStack(m_horizontalDisplacement);
-	}
 }
 
 void dgCollisionHeightField::Serialize(dgSerialize callback, void* const userData) const
@@ -405,6 +412,27 @@ void dgCollisionHeightField::SetHorizontalDisplacement (const dgUnsigned16* cons
 	}
 }
 
+void dgCollisionHeightField::SetElevation (dgInt32 x0, dgInt32 z0, dgInt32 width, dgInt32 height, const void* const elevationMap)
+{
+	dgAssert ((x0 >= 0) && ((x0 + width) <= m_width));
+	dgAssert ((z0 >= 0) && ((z0 + height) <= m_height));
+	if ((width <= 0) || (height <= 0)) {
+		return;
+	}
+
+	const dgInt32 elementSize = (m_elevationDataType == m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16);
+	const dgInt8* const src = (dgInt8*)elevationMap;
+	dgInt8* const dst = (dgInt8*)m_elevationMap;
+	for (dgInt32 z = 0; z < height; z ++) {
+		memcpy (&dst[((z0 + z) * m_width + x0) * elementSize], &src[z * width * elementSize], width * elementSize);
+	}
+
+	// only the cells that share the new vertices and the blocks above them are refreshed
+	UpdateElevationPyramid(dgMax (x0 - 1, 0), dgMin (x0 + width - 1, m_width - 2), dgMax (z0 - 1, 0), dgMin (z0 + height - 1, m_height - 2));
+	CalculateAABB();
+	SetCollisionBBox(m_minBox, m_maxBox);
+}
+
 void dgCollisionHeightField::AllocateVertex(dgWorld* const world, dgInt32 threadIndex) const
 {
 	m_instanceData->m_vertex[threadIndex].Resize (m_instanceData->m_vertex[threadIndex].GetElementsCapacity() * 2);
@@ -459,31 +487,84 @@ DG_INLINE void dgCollisionHeightField::CalculateMinExtend3d(const dgVector& p0,
 	boxP1 = boxP1.GetMin(maxBox);
 }
 
-void dgCollisionHeightField::CalculateAABB()
+void dgCollisionHeightField::BuildElevationPyramid()
 {
-	dgFloat32 y0 = dgFloat32 (dgFloat32 (1.0e10f));
-	dgFloat32 y1 = dgFloat32 (-dgFloat32 (1.0e10f));
-	switch (m_elevationDataType) 
-	{
-		case m_float32Bit:
-		{
-			const dgFloat32* const elevation = (dgFloat32*)m_elevationMap;
-			for (dgInt32 i = 0; i < m_width * m_height; i ++) {
-				y0 = dgMin(y0, elevation[i]);
-				y1 = dgMax(y1, elevation[i]);
-			}
-			break;
-		}
+	dgInt32 count = 0;
+	m_pyramidLevels = 0;
+	m_pyramidOffset[0] = 0;
+	while ((GetPyramidWidth(m_pyramidLevels) > 1) || (GetPyramidHeight(m_pyramidLevels) > 1)) {
+		m_pyramidLevels ++;
+		dgAssert (m_pyramidLevels < DG_HEIGHTFIELD_MAX_PYRAMID_LEVELS);
+		m_pyramidOffset[m_pyramidLevels] = count;
+		count += GetPyramidWidth(m_pyramidLevels) * GetPyramidHeight(m_pyramidLevels);
+	}
 
-		case m_unsigned16Bit:
-		{
-			const dgUnsigned16* const elevation = (dgUnsigned16*)m_elevationMap;
-			for (dgInt32 i = 0; i < m_width * m_height; i ++) {
-				y0 = dgMin(y0, dgFloat32 (elevation[i]));
-				y1 = dgMax(y1, dgFloat32 (elevation[i]));
+	if (m_elevationPyramid) {
+		dgFreeStack(m_elevationPyramid);
+		m_elevationPyramid = NULL;
+	}
+	if (count) {
+		m_elevationPyramid = (dgElevationBound*)dgMallocStack(count * sizeof (dgElevationBound));
+	}
+	UpdateElevationPyramid(0, m_width - 2, 0, m_height - 2);
+}
+
+void dgCollisionHeightField::UpdateElevationPyramid(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1)
+{
+	// x and z are a range of cells, each level refreshes the blocks that contain the range of the level below
+	for (dgInt32 level = 1; level <= m_pyramidLevels; level ++) {
+		x0 >>= 1;
+		x1 >>= 1;
+		z0 >>= 1;
+		z1 >>= 1;
+		const dgInt32 width = GetPyramidWidth(level);
+		const dgInt32 childWidth = GetPyramidWidth(level - 1);
+		const dgInt32 childHeight = GetPyramidHeight(level - 1);
+		dgElevationBound* const bounds = &m_elevationPyramid[m_pyramidOffset[level]];
+		for (dgInt32 z = z0; z <= z1; z ++) {
+			for (dgInt32 x = x0; x <= x1; x ++) {
+				dgFloat32 minHeight = dgFloat32 (1.0e10f);
+				dgFloat32 maxHeight = dgFloat32 (-1.0e10f);
+				for (dgInt32 i = 0; i < 4; i ++) {
+					const dgInt32 childX = x * 2 + (i & 1);
+					const dgInt32 childZ = z * 2 + (i >> 1);
+					if ((childX < childWidth) && (childZ < childHeight)) {
+						dgFloat32 childMin;
+						dgFloat32 childMax;
+						GetElevationBound(level - 1, childX, childZ, childMin, childMax);
+						minHeight = dgMin (minHeight, childMin);
+						maxHeight = dgMax (maxHeight, childMax);
+					}
+				}
+				bounds[z * width + x].m_min = minHeight;
+				bounds[z * width + x].m_max = maxHeight;
 			}
 		}
 	}
+}
+
+void dgCollisionHeightField::GetElevationBound(dgInt32 level, dgInt32 x, dgInt32 z, dgFloat32& minHeight, dgFloat32& maxHeight) const
+{
+	if (level) {
+		const dgElevationBound& bound = m_elevationPyramid[m_pyramidOffset[level] + z * GetPyramidWidth(level) + x];
+		minHeight = bound.m_min;
+		maxHeight = bound.m_max;
+	} else {
+		const dgInt32 base = z * m_width + x;
+		const dgFloat32 h0 = GetElevation(base);
+		const dgFloat32 h1 = GetElevation(base + 1);
+		const dgFloat32 h2 = GetElevation(base + m_width);
+		const dgFloat32 h3 = GetElevation(base + m_width + 1);
+		minHeight = dgMin (dgMin (h0, h1), dgMin (h2, h3));
+		maxHeight = dgMax (dgMax (h0, h1), dgMax (h2, h3));
+	}
+}
+
+void dgCollisionHeightField::CalculateAABB()
+{
+	dgFloat32 y0;
+	dgFloat32 y1;
+	GetElevationBound(m_pyramidLevels, 0, 0, y0, y1);
 
 	m_minBox = dgVector (dgFloat32 (dgFloat32 (0.0f)),                  y0 * m_verticalScale, dgFloat32 (dgFloat32 (0.0f)),               dgFloat32 (0.0f)); 
 	m_maxBox = dgVector (dgFloat32 (m_width - 1) * m_horizontalScale_x, y1 * m_verticalScale, dgFloat32 (m_height-1) * m_horizontalScale_z, dgFloat32 (0.0f)); 
@@ -619,89 +700,119 @@ dgFloat32 dgCollisionHeightField::RayCast (const dgVector& q0, const dgVector& q
 
 	// clip the line against the bounding box
 	if (dgRayBoxClip (p0, p1, boxP0, boxP1)) { 
-		dgVector dp (p1 - p0);
-		dgVector normalOut (dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f));
+		dgInt32 stackLevel[DG_HEIGHTFIELD_MAX_PYRAMID_LEVELS * 4];
+		dgInt32 stackX[DG_HEIGHTFIELD_MAX_PYRAMID_LEVELS * 4];
+		dgInt32 stackZ[DG_HEIGHTFIELD_MAX_PYRAMID_LEVELS * 4];
 
-		dgFloat32 scale_x = m_horizontalScale_x;
-		dgFloat32 invScale_x = m_horizontalScaleInv_x;
-		dgFloat32 scale_z = m_horizontalScale_z;
-		dgFloat32 invScale_z = m_horizontalScaleInv_z;
-		dgInt32 ix0 = dgFastInt (p0.m_x * invScale_x);
-		dgInt32 iz0 = dgFastInt (p0.m_z * invScale_z);
-
-		// implement a 3ddda line algorithm 
-		dgInt32 xInc;
-		dgFloat32 tx;
-		dgFloat32 stepX;
-		if (dp.m_x > dgFloat32 (0.0f)) {
-			xInc = 1;
-			dgFloat32 val = dgFloat32 (1.0f) / dp.m_x;
-			stepX = scale_x * val;
-			tx = (scale_x * (ix0 + dgFloat32 (1.0f)) - p0.m_x) * val;
-		} else if (dp.m_x < dgFloat32 (0.0f)) {
-			xInc = -1;
-			dgFloat32 val = -dgFloat32 (1.0f) / dp.m_x;
-			stepX = scale_x * val;
-			tx = -(scale_x * ix0 - p0.m_x) * val;
-		} else {
-			xInc = 0;
-			stepX = dgFloat32 (0.0f);
-			tx = dgFloat32 (1.0e10f);
-		}
+		const dgVector dp (q1 - q0);
+		const dgFloat32 invDx = (dgAbs (dp.m_x) > dgFloat32 (1.0e-12f)) ? dgFloat32 (1.0f) / dp.m_x : dgFloat32 (0.0f);
+		const dgFloat32 invDz = (dgAbs (dp.m_z) > dgFloat32 (1.0e-12f)) ? dgFloat32 (1.0f) / dp.m_z : dgFloat32 (0.0f);
+		const dgFloat32 padX = m_horizontalScale_x * dgFloat32 (1.0e-3f);
+		const dgFloat32 padZ = m_horizontalScale_z * dgFloat32 (1.0e-3f);
+		const dgFloat32 padY = dgFloat32 (1.0e-3f);
 
-		dgInt32 zInc;
-		dgFloat32 tz;
-		dgFloat32 stepZ;
-		if (dp.m_z > dgFloat32 (0.0f)) {
-			zInc = 1;
-			dgFloat32 val = dgFloat32 (1.0f) / dp.m_z;
-			stepZ = scale_z * val;
-			tz = (scale_z * (iz0 + dgFloat32 (1.0f)) - p0.m_z) * val;
-		} else if (dp.m_z < dgFloat32 (0.0f)) {
-			zInc = -1;
-			dgFloat32 val = -dgFloat32 (1.0f) / dp.m_z;
-			stepZ = scale_z * val;
-			tz = -(scale_z * iz0 - p0.m_z) * val;
-		} else {
-			zInc = 0;
-			stepZ = dgFloat32 (0.0f);
-			tz = dgFloat32 (1.0e10f);
-		}
-
-		dgFloat32 txAcc = tx;
-		dgFloat32 tzAcc = tz;
-		dgInt32 xIndex0 = ix0;
-		dgInt32 zIndex0 = iz0;
+		dgVector normalOut (dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f));
 		dgFastRayTest ray (q0, q1); 
 
-		// for each cell touched by the line
-		do {
-			dgFloat32 t = RayCastCell (ray, xIndex0, zIndex0, normalOut, maxT);
-			if (t < maxT) {
-				// bail out at the first intersection and copy the data into the descriptor
-				dgAssert (normalOut.m_w == dgFloat32 (0.0f));
-				contactOut.m_normal = normalOut.Normalize();
-				contactOut.m_shapeId0 = m_atributeMap[zIndex0 * m_width + xIndex0];
-				contactOut.m_shapeId1 = m_atributeMap[zIndex0 * m_width + xIndex0];
-
-				if (m_userRayCastCallback) {
-					dgVector normal (body->GetCollision()->GetGlobalMatrix().RotateVector (contactOut.m_normal));
-					m_userRayCastCallback (body, this, t, xIndex0, zIndex0, &normal, dgInt32 (contactOut.m_shapeId0), userData);
+		// walk the elevation pyramid front to back, skipping the blocks the segment passes above or below,
+		// the first cell hit is the closest because the cells are visited in the order the segment enters them
+		dgInt32 stack = 1;
+		stackLevel[0] = m_pyramidLevels;
+		stackX[0] = 0;
+		stackZ[0] = 0;
+		while (stack) {
+			stack --;
+			const dgInt32 level = stackLevel[stack];
+			const dgInt32 xIndex0 = stackX[stack];
+			const dgInt32 zIndex0 = stackZ[stack];
+			if (!level) {
+				dgFloat32 t = RayCastCell (ray, xIndex0, zIndex0, normalOut, maxT);
+				if (t < maxT) {
+					// bail out at the first intersection and copy the data into the descriptor
+					dgAssert (normalOut.m_w == dgFloat32 (0.0f));
+					contactOut.m_normal = normalOut.Normalize();
+					contactOut.m_shapeId0 = m_atributeMap[zIndex0 * m_width + xIndex0];
+					contactOut.m_shapeId1 = m_atributeMap[zIndex0 * m_width + xIndex0];
+
+					if (m_userRayCastCallback) {
+						dgVector normal (body->GetCollision()->GetGlobalMatrix().RotateVector (contactOut.m_normal));
+						m_userRayCastCallback (body, this, t, xIndex0, zIndex0, &normal, dgInt32 (contactOut.m_shapeId0), userData);
+					}
+
+					return t;
 				}
+				continue;
+			}
 
-				return t;
+			dgInt32 childCount = 0;
+			dgInt32 childX[4];
+			dgInt32 childZ[4];
+			dgFloat32 childEntry[4];
+			const dgInt32 childWidth = GetPyramidWidth(level - 1);
+			const dgInt32 childHeight = GetPyramidHeight(level - 1);
+			for (dgInt32 i = 0; i < 4; i ++) {
+				const dgInt32 x = xIndex0 * 2 + (i & 1);
+				const dgInt32 z = zIndex0 * 2 + (i >> 1);
+				if ((x < childWidth) && (z < childHeight)) {
+					const dgInt32 size = 1 << (level - 1);
+					const dgFloat32 x0 = dgFloat32 (x * size) * m_horizontalScale_x - padX;
+					const dgFloat32 x1 = dgFloat32 (dgMin ((x + 1) * size, m_width - 1)) * m_horizontalScale_x + padX;
+					const dgFloat32 z0 = dgFloat32 (z * size) * m_horizontalScale_z - padZ;
+					const dgFloat32 z1 = dgFloat32 (dgMin ((z + 1) * size, m_height - 1)) * m_horizontalScale_z + padZ;
+
+					// parametric range of the segment over the block
+					dgFloat32 tEntry = dgFloat32 (0.0f);
+					dgFloat32 tExit = maxT;
+					if (invDx != dgFloat32 (0.0f)) {
+						const dgFloat32 tx0 = (x0 - q0.m_x) * invDx;
+						const dgFloat32 tx1 = (x1 - q0.m_x) * invDx;
+						tEntry = dgMax (tEntry, dgMin (tx0, tx1));
+						tExit = dgMin (tExit, dgMax (tx0, tx1));
+					} else if ((q0.m_x < x0) || (q0.m_x > x1)) {
+						continue;
+					}
+					if (invDz != dgFloat32 (0.0f)) {
+						const dgFloat32 tz0 = (z0 - q0.m_z) * invDz;
+						const dgFloat32 tz1 = (z1 - q0.m_z) * invDz;
+						tEntry = dgMax (tEntry, dgMin (tz0, tz1));
+						tExit = dgMin (tExit, dgMax (tz0, tz1));
+					} else if ((q0.m_z < z0) || (q0.m_z > z1)) {
+						continue;
+					}
+
+					if (tEntry <= tExit) {
+						dgFloat32 minHeight;
+						dgFloat32 maxHeight;
+						GetElevationBound(level - 1, x, z, minHeight, maxHeight);
+						minHeight *= m_verticalScale;
+						maxHeight *= m_verticalScale;
+						const dgFloat32 y0 = q0.m_y + dp.m_y * tEntry;
+						const dgFloat32 y1 = q0.m_y + dp.m_y * tExit;
+						if ((dgMax (y0, y1) >= (dgMin (minHeight, maxHeight) - padY)) && (dgMin (y0, y1) <= (dgMax (minHeight, maxHeight) + padY))) {
+							dgInt32 j = childCount;
+							for (; j && (tEntry > childEntry[j - 1]); j --) {
+								childX[j] = childX[j - 1];
+								childZ[j] = childZ[j - 1];
+								childEntry[j] = childEntry[j - 1];
+							}
+							childX[j] = x;
+							childZ[j] = z;
+							childEntry[j] = tEntry;
+							childCount ++;
+						}
+					}
+				}
 			}
 
-			if (txAcc < tzAcc) {
-				xIndex0 += xInc;
-				tx = txAcc;
-				txAcc += stepX;
-			} else {
-				zIndex0 += zInc;
-				tz = tzAcc;
-				tzAcc += stepZ;
+			// the children are sorted far to near, so the nearest one is popped first
+			for (dgInt32 i = 0; i < childCount; i ++) {
+				stackLevel[stack] = level - 1;
+				stackX[stack] = childX[i];
+				stackZ[stack] = childZ[i];
+				stack ++;
+				dgAssert (stack < DG_HEIGHTFIELD_MAX_PYRAMID_LEVELS * 4);
 			}
-		} while ((tx <= dgFloat32 (1.0f)) || (tz <= dgFloat32 (1.0f)));
+		}
 	}
 
 	// if no cell was hit, return a large value
@@ -881,33 +992,65 @@ void dgCollisionHeightField::DebugCollision (const dgMatrix& matrix, dgCollision
 	}
 }
 
-void dgCollisionHeightField::CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgFloat32* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const
+void dgCollisionHeightField::CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgFloat32& minHeight, dgFloat32& maxHeight) const
 {
-	dgInt32 base = z0 * m_width;
-	for (dgInt32 z = z0; z <= z1; z++) {
-		for (dgInt32 x = x0; x <= x1; x++) {
-			dgFloat32 high = elevation[base + x];
-			minHeight = dgMin(high, minHeight);
-			maxHeight = dgMax(high, maxHeight);
+	dgInt32 stackLevel[DG_HEIGHTFIELD_MAX_PYRAMID_LEVELS * 4];
+	dgInt32 stackX[DG_HEIGHTFIELD_MAX_PYRAMID_LEVELS * 4];
+	dgInt32 stackZ[DG_HEIGHTFIELD_MAX_PYRAMID_LEVELS * 4];
+
+	// x and z are a range of vertices, convert it to the range of cells made of those vertices
+	const dgInt32 cellX0 = dgClamp (x0, dgInt32 (0), m_width - 2);
+	const dgInt32 cellX1 = dgClamp (x1 - 1, cellX0, m_width - 2);
+	const dgInt32 cellZ0 = dgClamp (z0, dgInt32 (0), m_height - 2);
+	const dgInt32 cellZ1 = dgClamp (z1 - 1, cellZ0, m_height - 2);
+
+	// blocks inside the range are taken whole, blocks crossing its border are split,
+	// and blocks that can not widen the current range are skipped
+	dgInt32 stack = 1;
+	stackLevel[0] = m_pyramidLevels;
+	stackX[0] = 0;
+	stackZ[0] = 0;
+	while (stack) {
+		stack --;
+		const dgInt32 level = stackLevel[stack];
+		const dgInt32 x = stackX[stack];
+		const dgInt32 z = stackZ[stack];
+		const dgInt32 blockX0 = x << level;
+		const dgInt32 blockZ0 = z << level;
+		const dgInt32 blockX1 = dgMin (((x + 1) << level) - 1, m_width - 2);
+		const dgInt32 blockZ1 = dgMin (((z + 1) << level) - 1, m_height - 2);
+		if ((blockX0 > cellX1) || (blockX1 < cellX0) || (blockZ0 > cellZ1) || (blockZ1 < cellZ0)) {
+			continue;
 		}
-		base += m_width;
-	}
-}
 
-void dgCollisionHeightField::CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgUnsigned16* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const
-{
-	dgInt32 base = z0 * m_width;
-	for (dgInt32 z = z0; z <= z1; z++) {
-		for (dgInt32 x = x0; x <= x1; x++) {
-			dgFloat32 high = dgFloat32 (elevation[base + x]);
-			minHeight = dgMin(high, minHeight);
-			maxHeight = dgMax(high, maxHeight);
+		dgFloat32 blockMin;
+		dgFloat32 blockMax;
+		GetElevationBound(level, x, z, blockMin, blockMax);
+		if ((blockMin >= minHeight) && (blockMax <= maxHeight)) {
+			continue;
+		}
+
+		if (!level || ((blockX0 >= cellX0) && (blockX1 <= cellX1) && (blockZ0 >= cellZ0) && (blockZ1 <= cellZ1))) {
+			minHeight = dgMin (minHeight, blockMin);
+			maxHeight = dgMax (maxHeight, blockMax);
+		} else {
+			const dgInt32 childWidth = GetPyramidWidth(level - 1);
+			const dgInt32 childHeight = GetPyramidHeight(level - 1);
+			for (dgInt32 i = 0; i < 4; i ++) {
+				const dgInt32 childX = x * 2 + (i & 1);
+				const dgInt32 childZ = z * 2 + (i >> 1);
+				if ((childX < childWidth) && (childZ < childHeight)) {
+					stackLevel[stack] = level - 1;
+					stackX[stack] = childX;
+					stackZ[stack] = childZ;
+					stack ++;
+					dgAssert (stack < DG_HEIGHTFIELD_MAX_PYRAMID_LEVELS * 4);
+				}
+			}
 		}
-		base += m_width;
 	}
 }
 
-
 void dgCollisionHeightField::GetLocalAABB (const dgVector& q0, const dgVector& q1, dgVector& boxP0, dgVector& boxP1) const
 {
 	// the user data is the pointer to the collision geometry
@@ -929,20 +1072,7 @@ void dgCollisionHeightField::GetLocalAABB (const dgVector& q0, const dgVector& q
 	dgFloat32 minHeight = dgFloat32 (1.0e10f);
 	dgFloat32 maxHeight = dgFloat32 (-1.0e10f);
 	//dgInt32 base = z0 * m_width;
-	switch (m_elevationDataType) 
-	{
-		case m_float32Bit:
-		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgFloat32*)m_elevationMap, minHeight, maxHeight);
-			break;
-		}
-
-		case m_unsigned16Bit:
-		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgUnsigned16*)m_elevationMap, minHeight, maxHeight);
-			break;
-		}
-	}
+	CalculateMinAndMaxElevation(x0, x1, z0, z1, minHeight, maxHeight);
 
 	boxP0.m_y = m_verticalScale * minHeight;
 	boxP1.m_y = m_verticalScale * maxHeight;
@@ -997,20 +1127,7 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 	dgFloat32 minHeight = dgFloat32 (1.0e10f);
 	dgFloat32 maxHeight = dgFloat32 (-1.0e10f);
 //	dgInt32 base = z0 * m_width;
-	switch (m_elevationDataType) 
-	{
-		case m_float32Bit:
-		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgFloat32*)m_elevationMap, minHeight, maxHeight);
-			break;
-		}
-
-		case m_unsigned16Bit:
-		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgUnsigned16*)m_elevationMap, minHeight, maxHeight);
-			break;
-		}
-	}
+	CalculateMinAndMaxElevation(x0, x1, z0, z1, minHeight, maxHeight);
 
 	minHeight *= m_verticalScale;
 	maxHeight *= m_verticalScale;
@@ -1070,13 +1187,15 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 		dgInt32 index = 0;
 		dgInt32 faceCount = 0;
 		dgInt32 step = x1 - x0 + 1;
-		dgInt32* const indices = data->m_globalFaceVertexIndex;
-		dgInt32* const faceIndexCount = data->m_meshData.m_globalFaceIndexCount;
+		const dgInt32 maxFaceCount = 2 * (x1 - x0) * (z1 - z0);
+		data->ReserveFaces (maxFaceCount, maxFaceCount * 9);
+		dgInt32* const indices = &data->m_meshData->m_globalFaceVertexIndex[0];
+		dgInt32* const faceIndexCount = &data->m_meshData->m_globalFaceIndexCount[0];
 		dgInt32 faceSize = dgInt32 (dgMax (m_horizontalScale_x, m_horizontalScale_z) * dgFloat32 (2.0f)); 
 
-		for (dgInt32 z = z0; (z < z1) && (faceCount < DG_MAX_COLLIDING_FACES); z ++) {
+		for (dgInt32 z = z0; z < z1; z ++) {
 			dgInt32 zStep = z * m_width;
-			for (dgInt32 x = x0; (x < x1) && (faceCount < DG_MAX_COLLIDING_FACES); x ++) {
+			for (dgInt32 x = x0; x < x1; x ++) {
 				const dgInt32* const indirectIndex = &m_cellIndices[dgInt32 (m_diagonals[zStep + x])][0];
 
 				dgInt32 vIndex[4];
@@ -1145,12 +1264,7 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 			vertexIndex ++;
 		}
 
-		#ifdef _DEBUG
-		dgAssert (faceCount < DG_MAX_COLLIDING_FACES);
-		if (faceCount >= DG_MAX_COLLIDING_FACES) {
-			dgTrace (("buffer Over float, try using a lower resolution mesh for collision\n"));
-		}
-		#endif
+		dgAssert (faceCount == maxFaceCount);
 
 		const int maxIndex = index;
 		dgInt32 stepBase = (x1 - x0) * (2 * 9);
@@ -1159,7 +1273,8 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 			const dgInt32 triangleIndexBase = (z - z0) * stepBase;
 			for (dgInt32 x = x0; x < (x1 - 1); x ++) {
 				dgInt32 index1 = (x - x0) * (2 * 9) + triangleIndexBase;
-				if (index1 < maxIndex) {
+				// the edge map reads the triangles of this cell and the next one
+				if ((index1 + 2 * 2 * 9) <= maxIndex) {
 					const dgInt32 code = (m_diagonals[diagBase + x] << 1) + m_diagonals[diagBase + x + 1];
 					const dgInt32* const edgeMap = &m_horizontalEdgeMap[code][0];
 				
@@ -1190,7 +1305,8 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 			const dgInt32 triangleIndexBase = (x - x0) * (2 * 9);
 			for (dgInt32 z = z0; z < (z1 - 1); z ++) {	
 				dgInt32 index1 = (z - z0) * stepBase + triangleIndexBase;
-				if (index1 < maxIndex) {
+				// the edge map reads the triangles of this cell and the one in the next row
+				if ((index1 + stepBase + 2 * 9) <= maxIndex) {
 					const dgInt32 diagBase = m_width * z;
 					const dgInt32 code = (m_diagonals[diagBase + x] << 1) + m_diagonals[diagBase + m_width + x];
 					const dgInt32* const edgeMap = &m_verticalEdgeMap[code][0];
@@ -1223,8 +1339,8 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 		dgInt32 faceIndexCount0 = 0; 
 		dgInt32 faceIndexCount1 = 0; 
 
-		dgInt32* const address = data->m_meshData.m_globalFaceIndexStart;
-		dgFloat32* const hitDistance = data->m_meshData.m_globalHitDistance;
+		dgInt32* const address = &data->m_meshData->m_globalFaceIndexStart[0];
+		dgFloat32* const hitDistance = &data->m_meshData->m_globalHitDistance[0];
 		
 		if (data->m_doContinuesCollisionTest) {
 			dgFastRayTest ray (dgVector (dgFloat32 (0.0f)), data->m_boxDistanceTravelInMeshSpace);
@@ -26,6 +26,9 @@
 #include "dgCollisionMesh.h"
 
 class dgCollisionHeightField;
+
+#define DG_HEIGHTFIELD_MAX_PYRAMID_LEVELS	32
+
 typedef dgFloat32 (*dgCollisionHeightFieldRayCastCallback) (const dgBody* const body, const dgCollisionHeightField* const heightFieldCollision, dgFloat32 interception, dgInt32 row, dgInt32 col, dgVector* const normal, int faceId, void* const usedData);
 
 
@@ -61,8 +64,17 @@ class dgCollisionHeightField: public dgCollisionMesh
 	dgCollisionHeightFieldRayCastCallback GetDebugRayCastCallback() const { return m_userRayCastCallback;} 
 
 	void SetHorizontalDisplacement (const dgUnsigned16* const displacemnet, dgFloat32 scale);
+	void SetElevation (dgInt32 x0, dgInt32 z0, dgInt32 width, dgInt32 height, const void* const elevationMap);
 
 	private:
+	// elevation range of a block of cells
+	class dgElevationBound
+	{
+		public:
+		dgFloat32 m_min;
+		dgFloat32 m_max;
+	};
+
 	class dgPerIntanceData
 	{
 		public:
@@ -73,8 +85,12 @@ class dgCollisionHeightField: public dgCollisionMesh
 	};
 
 	void CalculateAABB();
-	void CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgUnsigned16* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const;
-	void CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgFloat32* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const;
+	void AcquireInstanceData(dgWorld* const world);
+	void ReleaseInstanceData();
+	void BuildElevationPyramid();
+	void UpdateElevationPyramid(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1);
+	void GetElevationBound(dgInt32 level, dgInt32 x, dgInt32 z, dgFloat32& minHeight, dgFloat32& maxHeight) const;
+	void CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgFloat32& minHeight, dgFloat32& maxHeight) const;
 		
 	void AllocateVertex(dgWorld* const world, dgInt32 thread) const;
 	void CalculateMinExtend2d (const dgVector& p0, const dgVector& p1, dgVector& boxP0, dgVector& boxP1) const;
@@ -96,6 +112,21 @@ class dgCollisionHeightField: public dgCollisionMesh
 	
 	void AddDisplacement (dgVector* const vertex, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1) const;
 
+	DG_INLINE dgFloat32 GetElevation(dgInt32 index) const
+	{
+		return (m_elevationDataType == m_float32Bit) ? ((dgFloat32*)m_elevationMap)[index] : dgFloat32(((dgUnsigned16*)m_elevationMap)[index]);
+	}
+
+	DG_INLINE dgInt32 GetPyramidWidth(dgInt32 level) const
+	{
+		return (m_width - 1 + (1 << level) - 1) >> level;
+	}
+
+	DG_INLINE dgInt32 GetPyramidHeight(dgInt32 level) const
+	{
+		return (m_height - 1 + (1 << level) - 1) >> level;
+	}
+
 	DG_INLINE dgInt32 dgFastInt(dgFloat32 x) const
 	{
 		dgInt32 i = dgInt32(x);
@@ -115,6 +146,10 @@ class dgCollisionHeightField: public dgCollisionMesh
 	dgInt8* m_diagonals;
 	void* m_elevationMap;
 	dgUnsigned16* m_horizontalDisplacement;
+	// level l bounds blocks of 2^l x 2^l cells, level zero is read from the elevation map
+	dgElevationBound* m_elevationPyramid;
+	dgInt32 m_pyramidOffset[DG_HEIGHTFIELD_MAX_PYRAMID_LEVELS];
+	dgInt32 m_pyramidLevels;
 	dgFloat32 m_verticalScale;
 	dgFloat32 m_horizontalScale_x;
 	dgFloat32 m_horizontalScaleInv_x;
@@ -129,12 +164,14 @@ class dgCollisionHeightField: public dgCollisionMesh
 	static dgVector m_yMask;
 	static dgVector m_padding;
 	static dgVector m_elevationPadding;
+	static dgInt32 m_instanceDataLock;
 	static dgInt32 m_cellIndices[][4];
 	static dgInt32 m_verticalEdgeMap[][7];
 	static dgInt32 m_horizontalEdgeMap[][7];
 	
 	dgPerIntanceData* m_instanceData;
 	friend class dgCollisionCompound;
+	friend class dgCollisionTiledHeightField;
 };
 
 
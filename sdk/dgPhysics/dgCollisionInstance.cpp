@@ -34,6 +34,7 @@
 #include "dgCollisionInstance.h"
 #include "dgCollisionCompound.h"
 #include "dgCollisionHeightField.h"
+#include "dgCollisionTiledHeightField.h"
 #include "dgCollisionConvexPolygon.h"
 #include "dgCollisionChamferCylinder.h"
 #include "dgCollisionCompoundFractured.h"
@@ -190,6 +191,12 @@ dgCollisionInstance::dgCollisionInstance(const dgWorld* const constWorld, dgDese
 					break;
 				}
 
+				case m_tiledHeightField:
+				{
+					collision = new (allocator) dgCollisionTiledHeightField (world, serialize, userData, revisionNumber);
+					break;
+				}
+
 				case m_boundingBoxHierachy:
 				{
 					collision = new (allocator) dgCollisionBVH (world, serialize, userData, revisionNumber);
@@ -148,7 +148,7 @@ void dgCollisionLumpedMassParticles::SetOwnerAndMassPraperties (dgDynamicBody* c
 	body->m_collision->SetScale(dgVector (dgFloat32 (1.0f)));
 	body->m_collision->SetLocalMatrix (dgGetIdentityMatrix());
 	matrix.m_posit = position;
-	body->m_matrix = matrix;
+	body->GetStateMatrix() = matrix;
 	body->m_localCentreOfMass = xMassSum * invMass;
 
 	//dgVector inertia (xxMassSum.Scale(invMass) - body->m_localCentreOfMass); 
@@ -133,7 +133,7 @@ void dgCollisionMassSpringDamperSystem::CalculateAcceleration(dgFloat32 timestep
 	dgVector deltaOmega(m_body->m_invWorldInertiaMatrix.RotateVector(m_body->m_externalTorque.Scale(timestep)));
 
 	m_body->m_alpha = dgVector::m_zero;
-	m_body->m_omega = dgVector::m_zero;
+	m_body->GetStateOmega() = dgVector::m_zero;
 	m_body->m_externalForce = dgVector::m_zero;
 	m_body->m_externalTorque = dgVector::m_zero;
 
@@ -262,9 +262,8 @@ void dgCollisionMassSpringDamperSystem::CalculateAcceleration(dgFloat32 timestep
 	//dgVector deltaOmega(m_body->m_invWorldInertiaMatrix.RotateVector(m_body->m_externalTorque.Scale(timestep)));
 
 	dgWorld* const world = m_body->GetWorld();
-	world->m_solverJacobiansMemory.ResizeIfNecessary(GetMemoryBufferSizeInBytes() + 1024);
-
-	dgVector* const normalAccel = (dgVector*)&world->m_solverJacobiansMemory[0];
+	dgFrameArenaScope scratchScope (world->m_frameArena, 0);
+	dgVector* const normalAccel = (dgVector*)world->m_frameArena.Alloc(GetMemoryBufferSizeInBytes() + 1024, 0);
 	dgVector* const normalDir = &normalAccel[m_particlesCount];
 	dgVector* const diagonal = &normalDir[m_particlesCount];
 	dgFloat32* const frictionCoeffecient = (dgFloat32*)&diagonal[m_particlesCount];
@@ -278,7 +277,7 @@ void dgCollisionMassSpringDamperSystem::CalculateAcceleration(dgFloat32 timestep
 
 	dgAssert(m_body->IsRTTIType(dgBody::m_dynamicBodyRTTI));
 	m_body->m_alpha = dgVector::m_zero;
-	m_body->m_omega = dgVector::m_zero;
+	m_body->GetStateOmega() = dgVector::m_zero;
 	m_body->m_externalForce = dgVector::m_zero;
 	m_body->m_externalTorque = dgVector::m_zero;
 
@@ -48,6 +48,7 @@ dgPolygonMeshDesc::dgPolygonMeshDesc(dgCollisionParamProxy& proxy, void* const u
 	,m_faceVertexIndex(NULL)
 	,m_faceIndexStart(NULL)
 	,m_hitDistance(NULL)
+	,m_meshData(&proxy.m_body0->GetWorld()->m_polygonMeshData[proxy.m_threadIndex])
 	,m_maxT(dgFloat32 (1.0f))
 	,m_doContinuesCollisionTest(proxy.m_continueCollision)
 {
@@ -111,7 +112,7 @@ void dgPolygonMeshDesc::SortFaceArray ()
 {
 	dgInt32 stride = 8;
 	if (m_faceCount >= 8) {
-		dgInt32 stack[DG_MAX_COLLIDING_FACES][2];
+		dgInt32 stack[64][2];
 
 		stack[0][0] = 0;
 		stack[0][1] = m_faceCount - 1;
@@ -137,15 +138,29 @@ void dgPolygonMeshDesc::SortFaceArray ()
 					}
 				} while (i <= j);
 
-				if (i < hi) {
-					stack[stackIndex][0] = i;
-					stack[stackIndex][1] = hi;
-					stackIndex ++;
-				}
-				if (lo < j) {
-					stack[stackIndex][0] = lo;
-					stack[stackIndex][1] = j;
-					stackIndex ++;
+				// push the larger partition first so the stack depth stays below log2 of the face count
+				if ((hi - i) > (j - lo)) {
+					if (i < hi) {
+						stack[stackIndex][0] = i;
+						stack[stackIndex][1] = hi;
+						stackIndex ++;
+					}
+					if (lo < j) {
+						stack[stackIndex][0] = lo;
+						stack[stackIndex][1] = j;
+						stackIndex ++;
+					}
+				} else {
+					if (lo < j) {
+						stack[stackIndex][0] = lo;
+						stack[stackIndex][1] = j;
+						stackIndex ++;
+					}
+					if (i < hi) {
+						stack[stackIndex][0] = i;
+						stack[stackIndex][1] = hi;
+						stackIndex ++;
+					}
 				}
 				dgAssert (stackIndex < dgInt32 (sizeof (stack) / (2 * sizeof (stack[0][0]))));
 			}
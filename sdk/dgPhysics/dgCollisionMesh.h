@@ -28,9 +28,6 @@
 #include "dgCollisionInstance.h"
 
 
-#define DG_MAX_COLLIDING_FACES			512
-#define DG_MAX_COLLIDING_INDICES		(DG_MAX_COLLIDING_FACES * (4 * 2 + 3))
-
 
 class dgCollisionMesh;
 typedef void (*dgCollisionMeshCollisionCallback) (const dgBody* const bodyWithTreeCollision, const dgBody* const body, dgInt32 faceID, 
@@ -41,12 +38,30 @@ DG_MSC_VECTOR_ALIGMENT
 class dgPolygonMeshDesc: public dgFastAABBInfo
 {
 	public:
+	// per thread face buffers owned by the world, they grow to fit the faces of the largest query
 	class dgMesh
 	{
 		public:
-		dgInt32 m_globalFaceIndexCount[DG_MAX_COLLIDING_FACES];
-		dgInt32 m_globalFaceIndexStart[DG_MAX_COLLIDING_FACES];
-		dgFloat32 m_globalHitDistance[DG_MAX_COLLIDING_FACES];
+		void SetArena (dgFrameArena* const arena, dgInt32 threadIndex)
+		{
+			m_globalFaceIndexCount.SetArena(arena, threadIndex);
+			m_globalFaceIndexStart.SetArena(arena, threadIndex);
+			m_globalHitDistance.SetArena(arena, threadIndex);
+			m_globalFaceVertexIndex.SetArena(arena, threadIndex);
+		}
+
+		void Reset ()
+		{
+			m_globalFaceIndexCount.Reset();
+			m_globalFaceIndexStart.Reset();
+			m_globalHitDistance.Reset();
+			m_globalFaceVertexIndex.Reset();
+		}
+
+		dgFrameArray<dgInt32> m_globalFaceIndexCount;
+		dgFrameArray<dgInt32> m_globalFaceIndexStart;
+		dgFrameArray<dgFloat32> m_globalHitDistance;
+		dgFrameArray<dgInt32> m_globalFaceVertexIndex;
 	};
 
 	// colliding box in polygonSoup local space
@@ -54,6 +69,7 @@ class dgPolygonMeshDesc: public dgFastAABBInfo
 		:dgFastAABBInfo()
 		,m_boxDistanceTravelInMeshSpace(dgFloat32 (0.0f))
 		,m_maxT(dgFloat32 (1.0f))
+		,m_meshData(NULL)
 		,m_doContinuesCollisionTest(false)
 	{
 	}
@@ -67,6 +83,15 @@ class dgPolygonMeshDesc: public dgFastAABBInfo
 	}
 
 
+	// make room for faceCount faces and indexCount indices, pointers to the face buffers taken before the call are no longer valid
+	DG_INLINE void ReserveFaces (dgInt32 faceCount, dgInt32 indexCount) const
+	{
+		m_meshData->m_globalFaceIndexCount.ResizeIfNecessary(faceCount);
+		m_meshData->m_globalFaceIndexStart.ResizeIfNecessary(faceCount);
+		m_meshData->m_globalHitDistance.ResizeIfNecessary(faceCount);
+		m_meshData->m_globalFaceVertexIndex.ResizeIfNecessary(indexCount);
+	}
+
 	DG_INLINE dgInt32 GetFaceIndexCount(dgInt32 indexCount) const
 	{
 		return indexCount * 2 + 3;
@@ -120,11 +145,10 @@ class dgPolygonMeshDesc: public dgFastAABBInfo
 	dgInt32* m_faceIndexStart;
 	dgFloat32* m_hitDistance;
 	const dgCollisionMesh* m_me;
+	dgMesh* m_meshData;
 	dgInt32 m_globalIndexCount;
 	dgFloat32 m_maxT;
 	bool m_doContinuesCollisionTest;
-	dgInt32 m_globalFaceVertexIndex[DG_MAX_COLLIDING_INDICES];
-	dgMesh m_meshData;
 } DG_GCC_VECTOR_ALIGMENT;
 
 DG_MSC_VECTOR_ALIGMENT 
@@ -92,7 +92,7 @@ void dgCollisionScene::CollidePair (dgBroadPhase::dgPair* const pair, dgCollisio
 	const dgMatrix& otherMatrix = otherInstance->GetGlobalMatrix();
 	dgMatrix matrix (otherMatrix * myMatrix.Inverse());
 
-	const dgVector& hullVeloc = otherBody->m_veloc;
+	const dgVector& hullVeloc = otherBody->GetStateVeloc();
 	dgAssert (hullVeloc.m_w == dgFloat32 (0.0f));
 	dgFloat32 baseLinearSpeed = dgSqrt (hullVeloc.DotProduct(hullVeloc).GetScalar());
 
@@ -104,7 +104,7 @@ void dgCollisionScene::CollidePair (dgBroadPhase::dgPair* const pair, dgCollisio
 		dgVector p1;
 		otherInstance->CalcAABB (matrix, p0, p1);
 
-		const dgVector& hullOmega = otherBody->m_omega;
+		const dgVector& hullOmega = otherBody->GetStateOmega();
 		dgAssert (hullOmega.m_w == dgFloat32 (0.0f));
 
 		dgFloat32 minRadius = otherInstance->GetBoxMinRadius();
@@ -262,15 +262,15 @@ void dgCollisionScene::CollideCompoundPair (dgBroadPhase::dgPair* const pair, dg
 
 	const dgContactMaterial* const material = contactJoint->GetMaterial();
 
-	dgMatrix myMatrix (myCompoundInstance->GetLocalMatrix() * myBody->m_matrix);
-	dgMatrix otherMatrix (otherCompoundInstance->GetLocalMatrix() * otherBody->m_matrix);
+	dgMatrix myMatrix (myCompoundInstance->GetLocalMatrix() * myBody->GetStateMatrix());
+	dgMatrix otherMatrix (otherCompoundInstance->GetLocalMatrix() * otherBody->GetStateMatrix());
 	dgOOBBTestData data (otherMatrix * myMatrix.Inverse());
 
 	dgInt32 stack = 1;
 	stackPool[0][0] = m_root;
 	stackPool[0][1] = otherCompound->m_root;
 
-	const dgVector& hullVeloc = otherBody->m_veloc;
+	const dgVector& hullVeloc = otherBody->GetStateVeloc();
 	dgAssert (hullVeloc.m_w == dgFloat32 (0.0f));
 	dgFloat32 baseLinearSpeed = dgSqrt (hullVeloc.DotProduct(hullVeloc).GetScalar());
 
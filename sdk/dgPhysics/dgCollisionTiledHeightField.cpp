@@ -0,0 +1,663 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "dgPhysicsStdafx.h"
+#include "dgBody.h"
+#include "dgWorld.h"
+#include "dgCollisionTiledHeightField.h"
+
+
+dgVector dgCollisionTiledHeightField::m_padding (dgFloat32 (0.25f), dgFloat32 (0.25f), dgFloat32 (0.25f), dgFloat32 (0.0f));
+
+static DG_INLINE dgInt32 dgTileFloorDiv (dgInt32 a, dgInt32 b)
+{
+	dgInt32 q = a / b;
+	if ((q * b) > a) {
+		q --;
+	}
+	return q;
+}
+
+dgCollisionTiledHeightField::dgCollisionTiledHeightField (dgWorld* const world, dgInt32 tileSize, dgInt32 contructionMode,
+	dgCollisionHeightField::dgElevationType elevationDataType, dgFloat32 verticalScale,
+	dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z)
+	:dgCollisionMesh (world, m_tiledHeightField)
+	,m_world(world)
+	,m_tiles(world->GetAllocator())
+	,m_pending(world->GetAllocator())
+	,m_tileSize(dgMax (tileSize, 1))
+	,m_diagonalMode (dgClamp (contructionMode, dgInt32 (dgCollisionHeightField::m_normalDiagonals), dgInt32 (dgCollisionHeightField::m_starInvertexDiagonals)))
+	,m_pendingLock(0)
+	,m_verticalScale(verticalScale)
+	,m_horizontalScale_x(horizontalScale_x)
+	,m_horizontalScale_z(horizontalScale_z)
+	,m_elevationDataType(elevationDataType)
+{
+	m_rtti |= dgCollisionTiledHeightField_RTTI;
+	Init();
+}
+
+dgCollisionTiledHeightField::dgCollisionTiledHeightField (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber)
+	:dgCollisionMesh (world, deserialization, userData, revisionNumber)
+	,m_world(world)
+	,m_tiles(world->GetAllocator())
+	,m_pending(world->GetAllocator())
+	,m_pendingLock(0)
+{
+	dgAssert (m_rtti | dgCollisionTiledHeightField_RTTI);
+
+	dgInt32 tileCount;
+	dgInt32 elevationDataType;
+	deserialization (userData, &m_tileSize, sizeof (dgInt32));
+	deserialization (userData, &m_diagonalMode, sizeof (dgInt32));
+	deserialization (userData, &elevationDataType, sizeof (dgInt32));
+	deserialization (userData, &m_verticalScale, sizeof (dgFloat32));
+	deserialization (userData, &m_horizontalScale_x, sizeof (dgFloat32));
+	deserialization (userData, &m_horizontalScale_z, sizeof (dgFloat32));
+	deserialization (userData, &tileCount, sizeof (dgInt32));
+	m_elevationDataType = dgCollisionHeightField::dgElevationType (elevationDataType);
+
+	for (dgInt32 i = 0; i < tileCount; i ++) {
+		dgInt32 tileX;
+		dgInt32 tileZ;
+		deserialization (userData, &tileX, sizeof (dgInt32));
+		deserialization (userData, &tileZ, sizeof (dgInt32));
+		dgCollisionHeightField* const tile = new (world->GetAllocator()) dgCollisionHeightField (world, deserialization, userData, revisionNumber);
+		m_tiles.Insert (tile, GetTileKey (tileX, tileZ));
+	}
+	Init();
+}
+
+dgCollisionTiledHeightField::~dgCollisionTiledHeightField(void)
+{
+	for (dgList<dgTileChange>::dgListNode* node = m_pending.GetFirst(); node; node = node->GetNext()) {
+		dgTileChange& change = node->GetInfo();
+		if (change.m_tile) {
+			change.m_tile->Release();
+		}
+		if (change.m_elevation) {
+			dgFreeStack (change.m_elevation);
+		}
+	}
+
+	dgTileMap::Iterator iter (m_tiles);
+	for (iter.Begin(); iter; iter ++) {
+		iter.GetNode()->GetInfo()->Release();
+	}
+}
+
+void dgCollisionTiledHeightField::Init ()
+{
+	m_tileWidth_x = dgFloat32 (m_tileSize) * m_horizontalScale_x;
+	m_tileWidth_z = dgFloat32 (m_tileSize) * m_horizontalScale_z;
+	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		m_buffers[i].m_vertex.SetAllocator(m_world->GetAllocator());
+		m_buffers[i].m_indices.SetAllocator(m_world->GetAllocator());
+		m_buffers[i].m_hitDistance.SetAllocator(m_world->GetAllocator());
+		m_buffers[i].m_remap.SetAllocator(m_world->GetAllocator());
+	}
+	CalculateAABB();
+	SetCollisionBBox(m_minBox, m_maxBox);
+}
+
+void dgCollisionTiledHeightField::Serialize(dgSerialize callback, void* const userData) const
+{
+	SerializeLow(callback, userData);
+
+	dgInt32 elevationDataType = m_elevationDataType;
+	dgInt32 tileCount = m_tiles.GetCount();
+	callback (userData, &m_tileSize, sizeof (dgInt32));
+	callback (userData, &m_diagonalMode, sizeof (dgInt32));
+	callback (userData, &elevationDataType, sizeof (dgInt32));
+	callback (userData, &m_verticalScale, sizeof (dgFloat32));
+	callback (userData, &m_horizontalScale_x, sizeof (dgFloat32));
+	callback (userData, &m_horizontalScale_z, sizeof (dgFloat32));
+	callback (userData, &tileCount, sizeof (dgInt32));
+
+	// changes that were not committed are not saved
+	dgTileMap::Iterator iter (m_tiles);
+	for (iter.Begin(); iter; iter ++) {
+		dgInt32 tileX = GetTileX (iter.GetKey());
+		dgInt32 tileZ = GetTileZ (iter.GetKey());
+		callback (userData, &tileX, sizeof (dgInt32));
+		callback (userData, &tileZ, sizeof (dgInt32));
+		iter.GetNode()->GetInfo()->Serialize (callback, userData);
+	}
+}
+
+dgCollisionHeightField* dgCollisionTiledHeightField::CreateTile (const void* const elevationMap, const dgInt8* const atributeMap) const
+{
+	const dgInt32 size = m_tileSize + 1;
+	if (atributeMap) {
+		return new (m_world->GetAllocator()) dgCollisionHeightField (m_world, size, size, m_diagonalMode, elevationMap, m_elevationDataType, m_verticalScale, atributeMap, m_horizontalScale_x, m_horizontalScale_z);
+	}
+	dgStack<dgInt8> atributes (size * size);
+	memset (&atributes[0], 0, size * size * sizeof (dgInt8));
+	return new (m_world->GetAllocator()) dgCollisionHeightField (m_world, size, size, m_diagonalMode, elevationMap, m_elevationDataType, m_verticalScale, &atributes[0], m_horizontalScale_x, m_horizontalScale_z);
+}
+
+void dgCollisionTiledHeightField::QueueChange (const dgTileChange& change)
+{
+	dgScopeSpinLock lock(&m_pendingLock);
+	m_pending.Append(change);
+}
+
+void dgCollisionTiledHeightField::AddTile (dgInt32 tileX, dgInt32 tileZ, const void* const elevationMap, const dgInt8* const atributeMap)
+{
+	// the tile is built here, so streaming threads pay for the construction and the commit only links it
+	dgTileChange change;
+	change.m_type = m_addTile;
+	change.m_x = tileX;
+	change.m_z = tileZ;
+	change.m_width = 0;
+	change.m_height = 0;
+	change.m_tile = CreateTile (elevationMap, atributeMap);
+	change.m_elevation = NULL;
+	QueueChange (change);
+}
+
+void dgCollisionTiledHeightField::RemoveTile (dgInt32 tileX, dgInt32 tileZ)
+{
+	dgTileChange change;
+	change.m_type = m_removeTile;
+	change.m_x = tileX;
+	change.m_z = tileZ;
+	change.m_width = 0;
+	change.m_height = 0;
+	change.m_tile = NULL;
+	change.m_elevation = NULL;
+	QueueChange (change);
+}
+
+void dgCollisionTiledHeightField::SetElevation (dgInt32 x0, dgInt32 z0, dgInt32 width, dgInt32 height, const void* const elevationMap)
+{
+	if ((width <= 0) || (height <= 0)) {
+		return;
+	}
+
+	const dgInt32 size = width * height * ((m_elevationDataType == dgCollisionHeightField::m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16));
+	dgTileChange change;
+	change.m_type = m_setElevation;
+	change.m_x = x0;
+	change.m_z = z0;
+	change.m_width = width;
+	change.m_height = height;
+	change.m_tile = NULL;
+	change.m_elevation = dgMallocStack (size);
+	memcpy (change.m_elevation, elevationMap, size);
+	QueueChange (change);
+}
+
+dgInt32 dgCollisionTiledHeightField::GetTileCount () const
+{
+	return m_tiles.GetCount();
+}
+
+bool dgCollisionTiledHeightField::HasTile (dgInt32 tileX, dgInt32 tileZ) const
+{
+	return FindTile (tileX, tileZ) ? true : false;
+}
+
+void dgCollisionTiledHeightField::GetTileBox (const dgCollisionHeightField* const tile, dgInt32 tileX, dgInt32 tileZ, dgVector& boxP0, dgVector& boxP1) const
+{
+	const dgVector origin (GetTileOrigin (tileX, tileZ));
+	boxP0 = tile->m_minBox + origin;
+	boxP1 = tile->m_maxBox + origin;
+}
+
+void dgCollisionTiledHeightField::ApplyElevation (const dgTileChange& change, dgVector& boxP0, dgVector& boxP1)
+{
+	// an edit can straddle several tiles, the samples on a shared border are written to every tile that holds them
+	const dgInt32 elementSize = (m_elevationDataType == dgCollisionHeightField::m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16);
+	const dgInt8* const src = (dgInt8*)change.m_elevation;
+	const dgInt32 x1 = change.m_x + change.m_width - 1;
+	const dgInt32 z1 = change.m_z + change.m_height - 1;
+	const dgInt32 tileX0 = dgTileFloorDiv (change.m_x - 1, m_tileSize);
+	const dgInt32 tileX1 = dgTileFloorDiv (x1, m_tileSize);
+	const dgInt32 tileZ0 = dgTileFloorDiv (change.m_z - 1, m_tileSize);
+	const dgInt32 tileZ1 = dgTileFloorDiv (z1, m_tileSize);
+
+	for (dgInt32 tileZ = tileZ0; tileZ <= tileZ1; tileZ ++) {
+		for (dgInt32 tileX = tileX0; tileX <= tileX1; tileX ++) {
+			dgCollisionHeightField* const tile = FindTile (tileX, tileZ);
+			if (tile) {
+				const dgInt32 baseX = tileX * m_tileSize;
+				const dgInt32 baseZ = tileZ * m_tileSize;
+				const dgInt32 x0 = dgMax (change.m_x, baseX);
+				const dgInt32 z0 = dgMax (change.m_z, baseZ);
+				const dgInt32 width = dgMin (x1, baseX + m_tileSize) - x0 + 1;
+				const dgInt32 height = dgMin (z1, baseZ + m_tileSize) - z0 + 1;
+
+				dgStack<dgInt8> buffer (width * height * elementSize);
+				for (dgInt32 z = 0; z < height; z ++) {
+					memcpy (&buffer[z * width * elementSize], &src[((z0 + z - change.m_z) * change.m_width + x0 - change.m_x) * elementSize], width * elementSize);
+				}
+
+				dgVector p0;
+				dgVector p1;
+				GetTileBox (tile, tileX, tileZ, p0, p1);
+				boxP0 = boxP0.GetMin(p0);
+				boxP1 = boxP1.GetMax(p1);
+
+				tile->SetElevation (x0 - baseX, z0 - baseZ, width, height, &buffer[0]);
+
+				GetTileBox (tile, tileX, tileZ, p0, p1);
+				boxP0 = boxP0.GetMin(p0);
+				boxP1 = boxP1.GetMax(p1);
+			}
+		}
+	}
+
+	// only the cells sharing the edited samples changed
+	if (boxP0.m_x <= boxP1.m_x) {
+		boxP0.m_x = dgFloat32 (change.m_x - 1) * m_horizontalScale_x;
+		boxP0.m_z = dgFloat32 (change.m_z - 1) * m_horizontalScale_z;
+		boxP1.m_x = dgFloat32 (x1 + 1) * m_horizontalScale_x;
+		boxP1.m_z = dgFloat32 (z1 + 1) * m_horizontalScale_z;
+	}
+}
+
+dgInt32 dgCollisionTiledHeightField::CommitChanges ()
+{
+	dgList<dgTileChange> changes (m_world->GetAllocator());
+	{
+		dgScopeSpinLock lock(&m_pendingLock);
+		changes.Merge (m_pending);
+	}
+
+	const dgInt32 changesCount = changes.GetCount();
+	if (!changesCount) {
+		return 0;
+	}
+
+	dgInt32 dirtyCount = 0;
+	dgStack<dgVector> dirtyBoxes (changesCount * 2);
+	for (dgList<dgTileChange>::dgListNode* node = changes.GetFirst(); node; node = node->GetNext()) {
+		dgTileChange& change = node->GetInfo();
+		dgVector boxP0 (dgFloat32 (1.0e10f));
+		dgVector boxP1 (dgFloat32 (-1.0e10f));
+
+		switch (change.m_type)
+		{
+			case m_addTile:
+			{
+				const dgUnsigned64 key = GetTileKey (change.m_x, change.m_z);
+				dgTileMap::dgTreeNode* const tileNode = m_tiles.Find (key);
+				if (tileNode) {
+					dgCollisionHeightField* const oldTile = tileNode->GetInfo();
+					GetTileBox (oldTile, change.m_x, change.m_z, boxP0, boxP1);
+					oldTile->Release();
+					tileNode->GetInfo() = change.m_tile;
+				} else {
+					m_tiles.Insert (change.m_tile, key);
+				}
+
+				dgVector p0;
+				dgVector p1;
+				GetTileBox (change.m_tile, change.m_x, change.m_z, p0, p1);
+				boxP0 = boxP0.GetMin(p0);
+				boxP1 = boxP1.GetMax(p1);
+				change.m_tile = NULL;
+				break;
+			}
+
+			case m_removeTile:
+			{
+				dgTileMap::dgTreeNode* const tileNode = m_tiles.Find (GetTileKey (change.m_x, change.m_z));
+				if (tileNode) {
+					dgCollisionHeightField* const oldTile = tileNode->GetInfo();
+					GetTileBox (oldTile, change.m_x, change.m_z, boxP0, boxP1);
+					oldTile->Release();
+					m_tiles.Remove (tileNode);
+				}
+				break;
+			}
+
+			case m_setElevation:
+			{
+				ApplyElevation (change, boxP0, boxP1);
+				dgFreeStack (change.m_elevation);
+				change.m_elevation = NULL;
+				break;
+			}
+		}
+
+		if (boxP0.m_x <= boxP1.m_x) {
+			dirtyBoxes[dirtyCount * 2 + 0] = (boxP0 - m_padding) & dgVector::m_triplexMask;
+			dirtyBoxes[dirtyCount * 2 + 1] = (boxP1 + m_padding) & dgVector::m_triplexMask;
+			dirtyCount ++;
+		}
+	}
+
+	CalculateAABB();
+	SetCollisionBBox(m_minBox, m_maxBox);
+	if (dirtyCount) {
+		m_world->InvalidateCollisionRegions (this, &dirtyBoxes[0], dirtyCount);
+	}
+	return changesCount;
+}
+
+void dgCollisionTiledHeightField::CalculateAABB ()
+{
+	if (!m_tiles.GetCount()) {
+		m_minBox = dgVector (dgFloat32 (0.0f));
+		m_maxBox = dgVector (dgFloat32 (0.0f));
+		return;
+	}
+
+	m_minBox = dgVector (dgFloat32 (1.0e10f), dgFloat32 (1.0e10f), dgFloat32 (1.0e10f), dgFloat32 (0.0f));
+	m_maxBox = dgVector (dgFloat32 (-1.0e10f), dgFloat32 (-1.0e10f), dgFloat32 (-1.0e10f), dgFloat32 (0.0f));
+	dgTileMap::Iterator iter (m_tiles);
+	for (iter.Begin(); iter; iter ++) {
+		dgVector p0;
+		dgVector p1;
+		GetTileBox (iter.GetNode()->GetInfo(), GetTileX (iter.GetKey()), GetTileZ (iter.GetKey()), p0, p1);
+		m_minBox = m_minBox.GetMin(p0);
+		m_maxBox = m_maxBox.GetMax(p1);
+	}
+}
+
+void dgCollisionTiledHeightField::GetTileRange (const dgVector& p0, const dgVector& p1, dgInt32& x0, dgInt32& x1, dgInt32& z0, dgInt32& z1) const
+{
+	// same padding the tiles apply to a query box, so a box near a seam reaches the cells of both tiles
+	const dgVector scale (m_horizontalScale_x, dgFloat32 (0.0f), m_horizontalScale_z, dgFloat32 (0.0f));
+	const dgVector q0 ((p0 - m_padding).GetMax(m_minBox));
+	const dgVector q1 ((p1 + scale + m_padding).GetMin(m_maxBox));
+
+	x0 = dgInt32 (dgFloor (q0.m_x / m_tileWidth_x));
+	z0 = dgInt32 (dgFloor (q0.m_z / m_tileWidth_z));
+	x1 = dgInt32 (dgFloor (q1.m_x / m_tileWidth_x));
+	z1 = dgInt32 (dgFloor (q1.m_z / m_tileWidth_z));
+	if ((q0.m_x > q1.m_x) || (q0.m_z > q1.m_z) || !m_tiles.GetCount()) {
+		x1 = x0 - 1;
+		z1 = z0 - 1;
+	}
+}
+
+dgVector dgCollisionTiledHeightField::SupportVertex (const dgVector& dir, dgInt32* const vertexIndex) const
+{
+	dgFloat32 maxProject (dgFloat32 (-1.e-20f));
+	dgVector support (dgFloat32 (0.0f));
+	dgTileMap::Iterator iter (m_tiles);
+	for (iter.Begin(); iter; iter ++) {
+		const dgVector p (iter.GetNode()->GetInfo()->SupportVertex (dir, NULL) + GetTileOrigin (GetTileX (iter.GetKey()), GetTileZ (iter.GetKey())));
+		dgFloat32 project = dir.DotProduct(p).GetScalar();
+		if (project > maxProject) {
+			maxProject = project;
+			support = p;
+		}
+	}
+	return support;
+}
+
+dgVector dgCollisionTiledHeightField::SupportVertexSpecial (const dgVector& dir, dgFloat32 skinThickness, dgInt32* const vertexIndex) const
+{
+	dgAssert (0);
+	return SupportVertex (dir, vertexIndex);
+}
+
+void dgCollisionTiledHeightField::GetCollisionInfo(dgCollisionInfo* const info) const
+{
+	dgCollision::GetCollisionInfo(info);
+
+	dgCollisionInfo::dgTiledHeightMapCollisionData& data = info->m_tiledHeightFieldCollision;
+	data.m_tileSize = m_tileSize;
+	data.m_tileCount = m_tiles.GetCount();
+	data.m_gridsDiagonals = m_diagonalMode;
+	data.m_elevationDataType = m_elevationDataType;
+	data.m_verticalScale = m_verticalScale;
+	data.m_horizonalScale_x = m_horizontalScale_x;
+	data.m_horizonalScale_z = m_horizontalScale_z;
+}
+
+void dgCollisionTiledHeightField::GetVertexListIndexList (const dgVector& p0, const dgVector& p1, dgMeshVertexListIndexList &data) const
+{
+	dgAssert (0);
+	data.m_vertexCount = 0;
+}
+
+void dgCollisionTiledHeightField::DebugCollision (const dgMatrix& matrix, dgCollision::OnDebugCollisionMeshCallback callback, void* const userData) const
+{
+	dgTileMap::Iterator iter (m_tiles);
+	for (iter.Begin(); iter; iter ++) {
+		dgMatrix tileMatrix (matrix);
+		tileMatrix.m_posit = matrix.TransformVector (GetTileOrigin (GetTileX (iter.GetKey()), GetTileZ (iter.GetKey())));
+		iter.GetNode()->GetInfo()->DebugCollision (tileMatrix, callback, userData);
+	}
+}
+
+void dgCollisionTiledHeightField::GetLocalAABB (const dgVector& q0, const dgVector& q1, dgVector& boxP0, dgVector& boxP1) const
+{
+	dgInt32 x0;
+	dgInt32 x1;
+	dgInt32 z0;
+	dgInt32 z1;
+	GetTileRange (q0, q1, x0, x1, z0, z1);
+
+	// an empty box has its vertical extent inverted, like a height field query that hits no cells
+	boxP0 = dgVector (q0.m_x, dgFloat32 (1.0e10f), q0.m_z, dgFloat32 (0.0f));
+	boxP1 = dgVector (q1.m_x, dgFloat32 (-1.0e10f), q1.m_z, dgFloat32 (0.0f));
+	bool first = true;
+	for (dgInt32 z = z0; z <= z1; z ++) {
+		for (dgInt32 x = x0; x <= x1; x ++) {
+			const dgCollisionHeightField* const tile = FindTile (x, z);
+			if (tile) {
+				dgVector p0;
+				dgVector p1;
+				const dgVector origin (GetTileOrigin (x, z));
+				tile->GetLocalAABB (q0 - origin, q1 - origin, p0, p1);
+				if (first) {
+					boxP0 = p0 + origin;
+					boxP1 = p1 + origin;
+					first = false;
+				} else {
+					boxP0 = boxP0.GetMin(p0 + origin);
+					boxP1 = boxP1.GetMax(p1 + origin);
+				}
+			}
+		}
+	}
+}
+
+dgFloat32 dgCollisionTiledHeightField::RayCast (const dgVector& q0, const dgVector& q1, dgFloat32 maxT, dgContactPoint& contactOut, const dgBody* const body, void* const userData, OnRayPrecastAction preFilter) const
+{
+	if (!m_tiles.GetCount()) {
+		return dgFloat32 (1.2f);
+	}
+
+	dgVector p0 (q0);
+	dgVector p1 (q1);
+	if (!dgRayBoxClip (p0, p1, m_minBox - m_padding, m_maxBox + m_padding)) {
+		return dgFloat32 (1.2f);
+	}
+
+	// walk the tiles the segment crosses front to back, the first tile with a hit has the closest one
+	const dgVector dp (q1 - q0);
+	dgInt32 x = dgInt32 (dgFloor (p0.m_x / m_tileWidth_x));
+	dgInt32 z = dgInt32 (dgFloor (p0.m_z / m_tileWidth_z));
+	const dgInt32 x1 = dgInt32 (dgFloor (p1.m_x / m_tileWidth_x));
+	const dgInt32 z1 = dgInt32 (dgFloor (p1.m_z / m_tileWidth_z));
+
+	const dgInt32 stepX = (dp.m_x >= dgFloat32 (0.0f)) ? 1 : -1;
+	const dgInt32 stepZ = (dp.m_z >= dgFloat32 (0.0f)) ? 1 : -1;
+	const bool moveX = dgAbs (dp.m_x) > dgFloat32 (1.0e-12f);
+	const bool moveZ = dgAbs (dp.m_z) > dgFloat32 (1.0e-12f);
+	const dgFloat32 deltaX = moveX ? m_tileWidth_x / dgAbs (dp.m_x) : dgFloat32 (1.0e10f);
+	const dgFloat32 deltaZ = moveZ ? m_tileWidth_z / dgAbs (dp.m_z) : dgFloat32 (1.0e10f);
+	dgFloat32 nextX = moveX ? (dgFloat32 (x + (stepX > 0)) * m_tileWidth_x - q0.m_x) / dp.m_x : dgFloat32 (1.0e10f);
+	dgFloat32 nextZ = moveZ ? (dgFloat32 (z + (stepZ > 0)) * m_tileWidth_z - q0.m_z) / dp.m_z : dgFloat32 (1.0e10f);
+
+	const dgInt32 count = dgAbs (x1 - x) + dgAbs (z1 - z) + 1;
+	for (dgInt32 i = 0; i < count; i ++) {
+		const dgCollisionHeightField* const tile = FindTile (x, z);
+		if (tile) {
+			const dgVector origin (GetTileOrigin (x, z));
+			dgFloat32 t = tile->RayCast (q0 - origin, q1 - origin, maxT, contactOut, body, userData, preFilter);
+			if (t < maxT) {
+				return t;
+			}
+		}
+
+		if (nextX < nextZ) {
+			if (nextX > maxT) {
+				break;
+			}
+			x += stepX;
+			nextX += deltaX;
+		} else {
+			if (nextZ > maxT) {
+				break;
+			}
+			z += stepZ;
+			nextZ += deltaZ;
+		}
+	}
+
+	// if no tile was hit, return a large value
+	return dgFloat32 (1.2f);
+}
+
+void dgCollisionTiledHeightField::MergeTileFaces (const dgPolygonMeshDesc* const data, const dgVector& origin, dgInt32& faceCount, dgInt32& vertexCount) const
+{
+	// the face layout of a height field is three vertex, the face id, the face normal,
+	// three edge normals and the face size. vertex and normals are shared by the faces of a tile,
+	// so they are compacted into the output with a remap table
+	dgThreadBuffer& buffer = m_buffers[data->m_threadNumber];
+	const dgVector* const vertex = (dgVector*)data->m_vertex;
+	const dgInt32* const indices = data->m_faceVertexIndex;
+	const dgInt32* const address = data->m_faceIndexStart;
+
+	dgInt32 maxIndex = 0;
+	for (dgInt32 i = 0; i < data->m_faceCount; i ++) {
+		const dgInt32* const face = &indices[address[i]];
+		maxIndex = dgMax (maxIndex, face[0], face[1]);
+		maxIndex = dgMax (maxIndex, face[2], face[4]);
+		maxIndex = dgMax (maxIndex, face[5], face[6]);
+		maxIndex = dgMax (maxIndex, face[7]);
+	}
+	buffer.m_remap.ResizeIfNecessary(maxIndex);
+	dgInt32* const remap = &buffer.m_remap[0];
+	for (dgInt32 i = 0; i <= maxIndex; i ++) {
+		remap[i] = -1;
+	}
+
+	for (dgInt32 i = 0; i < data->m_faceCount; i ++) {
+		const dgInt32* const face = &indices[address[i]];
+		for (dgInt32 j = 0; j < 9; j ++) {
+			dgInt32 index = face[j];
+			if ((j != 3) && (j != 8)) {
+				if (remap[index] < 0) {
+					remap[index] = vertexCount;
+					buffer.m_vertex[vertexCount] = (j < 3) ? vertex[index] + origin : vertex[index];
+					vertexCount ++;
+				}
+				index = remap[index];
+			}
+			buffer.m_indices[faceCount * 9 + j] = index;
+		}
+		buffer.m_hitDistance[faceCount] = data->m_hitDistance[i];
+		faceCount ++;
+	}
+}
+
+void dgCollisionTiledHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) const
+{
+	dgInt32 x0;
+	dgInt32 x1;
+	dgInt32 z0;
+	dgInt32 z1;
+
+	const dgVector posit (data->m_posit);
+	const dgVector boxP0 (data->m_p0);
+	const dgVector boxP1 (data->m_p1);
+	const dgVector travelP0 (data->m_boxDistanceTravelInMeshSpace & (data->m_boxDistanceTravelInMeshSpace < dgVector (dgFloat32 (0.0f))));
+	const dgVector travelP1 (data->m_boxDistanceTravelInMeshSpace & (data->m_boxDistanceTravelInMeshSpace > dgVector (dgFloat32 (0.0f))));
+	GetTileRange (boxP0 + travelP0, boxP1 + travelP1, x0, x1, z0, z1);
+
+	// each tile sees the query box in its own space and writes its faces over the descriptor arrays,
+	// so they are gathered in the thread buffer before the next tile runs
+	dgInt32 faceCount = 0;
+	dgInt32 vertexCount = 0;
+	for (dgInt32 z = z0; z <= z1; z ++) {
+		for (dgInt32 x = x0; x <= x1; x ++) {
+			const dgCollisionHeightField* const tile = FindTile (x, z);
+			if (tile) {
+				const dgVector origin (GetTileOrigin (x, z));
+				data->m_posit = posit - origin;
+				data->m_p0 = boxP0 - origin;
+				data->m_p1 = boxP1 - origin;
+				data->m_faceCount = 0;
+				tile->GetCollidingFaces (data);
+				if (data->m_faceCount) {
+					MergeTileFaces (data, origin, faceCount, vertexCount);
+				}
+			}
+		}
+	}
+	data->m_posit = posit;
+	data->m_p0 = boxP0;
+	data->m_p1 = boxP1;
+	data->m_faceCount = 0;
+	data->m_separationDistance = dgFloat32 (0.0f);
+
+	if (faceCount) {
+		dgThreadBuffer& buffer = m_buffers[data->m_threadNumber];
+		data->ReserveFaces (faceCount, faceCount * 9);
+		dgInt32* const indices = &data->m_meshData->m_globalFaceVertexIndex[0];
+		dgInt32* const faceIndexCount = &data->m_meshData->m_globalFaceIndexCount[0];
+		dgInt32* const address = &data->m_meshData->m_globalFaceIndexStart[0];
+		dgFloat32* const hitDistance = &data->m_meshData->m_globalHitDistance[0];
+
+		memcpy (indices, &buffer.m_indices[0], faceCount * 9 * sizeof (dgInt32));
+		for (dgInt32 i = 0; i < faceCount; i ++) {
+			faceIndexCount[i] = 3;
+			address[i] = i * 9;
+			hitDistance[i] = buffer.m_hitDistance[i];
+		}
+
+		data->m_faceCount = faceCount;
+		data->m_vertex = &buffer.m_vertex[0].m_x;
+		data->m_faceVertexIndex = indices;
+		data->m_faceIndexStart = address;
+		data->m_hitDistance = hitDistance;
+		data->m_faceIndexCount = faceIndexCount;
+		data->m_vertexStrideInBytes = sizeof (dgVector);
+
+		if (GetDebugCollisionCallback()) {
+			dgTriplex triplex[3];
+			const dgVector* const vertex = &buffer.m_vertex[0];
+			const dgVector scale = data->m_polySoupInstance->GetScale();
+			dgMatrix matrix(data->m_polySoupInstance->GetLocalMatrix() * data->m_polySoupBody->GetMatrix());
+
+			for (dgInt32 i = 0; i < data->m_faceCount; i ++) {
+				dgInt32 base1 = address[i];
+				for (dgInt32 j = 0; j < 3; j ++) {
+					dgInt32 index1 = data->m_faceVertexIndex[base1 + j];
+					dgVector p (matrix.TransformVector(scale * dgVector(vertex[index1])));
+					triplex[j].m_x = p.m_x;
+					triplex[j].m_y = p.m_y;
+					triplex[j].m_z = p.m_z;
+				}
+				GetDebugCollisionCallback() (data->m_polySoupBody, data->m_objBody, data->m_faceVertexIndex[base1 + 4], 3, &triplex[0].m_x, sizeof (dgTriplex));
+			}
+		}
+	}
+}
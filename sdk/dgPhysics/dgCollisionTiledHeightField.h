@@ -0,0 +1,152 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef __DGCOLLISION_TILED_HEIGHT_FIELD__
+#define __DGCOLLISION_TILED_HEIGHT_FIELD__
+
+#include "dgCollision.h"
+#include "dgCollisionMesh.h"
+#include "dgCollisionHeightField.h"
+
+
+// a terrain made of square height field tiles of tileSize x tileSize cells, tile (x, z) starts at
+// cell (x * tileSize, z * tileSize) and shares its last row and column of samples with its neighbors.
+// only resident tiles use memory. tiles and elevation edits can be queued from any thread,
+// they are applied by CommitChanges, which must not run while the world is updating.
+class dgCollisionTiledHeightField: public dgCollisionMesh
+{
+	public:
+	dgCollisionTiledHeightField (dgWorld* const world, dgInt32 tileSize, dgInt32 contructionMode,
+								 dgCollisionHeightField::dgElevationType elevationDataType, dgFloat32 verticalScale,
+								 dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z);
+	dgCollisionTiledHeightField (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber);
+	virtual ~dgCollisionTiledHeightField(void);
+
+	void AddTile (dgInt32 tileX, dgInt32 tileZ, const void* const elevationMap, const dgInt8* const atributeMap);
+	void RemoveTile (dgInt32 tileX, dgInt32 tileZ);
+	void SetElevation (dgInt32 x0, dgInt32 z0, dgInt32 width, dgInt32 height, const void* const elevationMap);
+	dgInt32 CommitChanges ();
+
+	dgInt32 GetTileCount () const;
+	bool HasTile (dgInt32 tileX, dgInt32 tileZ) const;
+
+	private:
+	enum dgTileChangeType
+	{
+		m_addTile,
+		m_removeTile,
+		m_setElevation,
+	};
+
+	// a change waiting for the next commit, new tiles are fully built by the thread that queued them
+	class dgTileChange
+	{
+		public:
+		dgTileChangeType m_type;
+		dgInt32 m_x;
+		dgInt32 m_z;
+		dgInt32 m_width;
+		dgInt32 m_height;
+		dgCollisionHeightField* m_tile;
+		void* m_elevation;
+	};
+
+	// faces of all the tiles a query overlaps are gathered here before they are handed to the caller
+	class dgThreadBuffer
+	{
+		public:
+		dgArray<dgVector> m_vertex;
+		dgArray<dgInt32> m_indices;
+		dgArray<dgFloat32> m_hitDistance;
+		dgArray<dgInt32> m_remap;
+	};
+
+	typedef dgTree<dgCollisionHeightField*, dgUnsigned64> dgTileMap;
+
+	virtual void Serialize(dgSerialize callback, void* const userData) const;
+	virtual dgFloat32 RayCast (const dgVector& localP0, const dgVector& localP1, dgFloat32 maxT, dgContactPoint& contactOut, const dgBody* const body, void* const userData, OnRayPrecastAction preFilter) const;
+	virtual void GetCollidingFaces (dgPolygonMeshDesc* const data) const;
+
+	virtual void GetCollisionInfo(dgCollisionInfo* const info) const;
+	virtual dgVector SupportVertex (const dgVector& dir, dgInt32* const vertexIndex) const;
+	virtual dgVector SupportVertexSpecial (const dgVector& dir, dgFloat32 skinThickness, dgInt32* const vertexIndex) const;
+	virtual dgVector SupportVertexSpecialProjectPoint (const dgVector& point, const dgVector& dir) const {return point;};
+
+	virtual void DebugCollision (const dgMatrix& matrixPtr, dgCollision::OnDebugCollisionMeshCallback callback, void* const userData) const;
+	void GetVertexListIndexList (const dgVector& p0, const dgVector& p1, dgMeshVertexListIndexList &data) const;
+	void GetLocalAABB (const dgVector& p0, const dgVector& p1, dgVector& boxP0, dgVector& boxP1) const;
+
+	void Init ();
+	void CalculateAABB ();
+	void QueueChange (const dgTileChange& change);
+	void ApplyElevation (const dgTileChange& change, dgVector& boxP0, dgVector& boxP1);
+	void GetTileRange (const dgVector& p0, const dgVector& p1, dgInt32& x0, dgInt32& x1, dgInt32& z0, dgInt32& z1) const;
+	void GetTileBox (const dgCollisionHeightField* const tile, dgInt32 tileX, dgInt32 tileZ, dgVector& boxP0, dgVector& boxP1) const;
+	void MergeTileFaces (const dgPolygonMeshDesc* const data, const dgVector& origin, dgInt32& faceCount, dgInt32& vertexCount) const;
+	dgCollisionHeightField* CreateTile (const void* const elevationMap, const dgInt8* const atributeMap) const;
+
+	DG_INLINE dgCollisionHeightField* FindTile (dgInt32 tileX, dgInt32 tileZ) const
+	{
+		dgTileMap::dgTreeNode* const node = m_tiles.Find(GetTileKey(tileX, tileZ));
+		return node ? node->GetInfo() : NULL;
+	}
+
+	DG_INLINE dgVector GetTileOrigin (dgInt32 tileX, dgInt32 tileZ) const
+	{
+		return dgVector (dgFloat32 (tileX) * m_tileWidth_x, dgFloat32 (0.0f), dgFloat32 (tileZ) * m_tileWidth_z, dgFloat32 (0.0f));
+	}
+
+	static DG_INLINE dgUnsigned64 GetTileKey (dgInt32 tileX, dgInt32 tileZ)
+	{
+		return (dgUnsigned64 (dgUnsigned32 (tileZ)) << 32) | dgUnsigned64 (dgUnsigned32 (tileX));
+	}
+
+	static DG_INLINE dgInt32 GetTileX (dgUnsigned64 key)
+	{
+		return dgInt32 (dgUnsigned32 (key));
+	}
+
+	static DG_INLINE dgInt32 GetTileZ (dgUnsigned64 key)
+	{
+		return dgInt32 (dgUnsigned32 (key >> 32));
+	}
+
+	dgVector m_minBox;
+	dgVector m_maxBox;
+	dgWorld* m_world;
+	dgTileMap m_tiles;
+	dgList<dgTileChange> m_pending;
+	mutable dgThreadBuffer m_buffers[DG_MAX_THREADS_HIVE_COUNT];
+	dgInt32 m_tileSize;
+	dgInt32 m_diagonalMode;
+	dgInt32 m_pendingLock;
+	dgFloat32 m_verticalScale;
+	dgFloat32 m_horizontalScale_x;
+	dgFloat32 m_horizontalScale_z;
+	dgFloat32 m_tileWidth_x;
+	dgFloat32 m_tileWidth_z;
+	dgCollisionHeightField::dgElevationType m_elevationDataType;
+
+	static dgVector m_padding;
+	friend class dgCollisionCompound;
+};
+
+#endif
@@ -154,14 +154,20 @@ void dgCollisionUserMesh::GetCollidingFaces (dgPolygonMeshDesc* const data) cons
 		dgInt32 faceIndexCount1 = 0; 
 		dgInt32 stride = data->m_vertexStrideInBytes / sizeof (dgFloat32);
 		dgFloat32* const vertex = data->m_vertex;
-		dgInt32* const address = data->m_meshData.m_globalFaceIndexStart;
-		dgFloat32* const hitDistance = data->m_meshData.m_globalHitDistance;
 		const dgInt32* const srcIndices = data->m_faceVertexIndex;
-		dgInt32* const dstIndices = data->m_globalFaceVertexIndex;
 		dgInt32* const faceIndexCountArray = data->m_faceIndexCount; 
 
+		dgInt32 indexCount = 0;
+		for (dgInt32 i = 0; i < data->m_faceCount; i ++) {
+			indexCount += data->GetFaceIndexCount(faceIndexCountArray[i]);
+		}
+		data->ReserveFaces (data->m_faceCount, indexCount);
+		dgInt32* const address = &data->m_meshData->m_globalFaceIndexStart[0];
+		dgFloat32* const hitDistance = &data->m_meshData->m_globalHitDistance[0];
+		dgInt32* const dstIndices = &data->m_meshData->m_globalFaceVertexIndex[0];
+
 		if (data->m_doContinuesCollisionTest) {
-			for (dgInt32 i = 0; (i < data->m_faceCount) && (faceIndexCount0 < (DG_MAX_COLLIDING_INDICES - 32)); i ++) {
+			for (dgInt32 i = 0; i < data->m_faceCount; i ++) {
 				dgInt32 indexCount = faceIndexCountArray[i];
 				const dgInt32* const indexArray = &srcIndices[faceIndexCount1]; 
 
@@ -181,7 +187,7 @@ void dgCollisionUserMesh::GetCollidingFaces (dgPolygonMeshDesc* const data) cons
 				faceIndexCount1 += faceIndexCount;
 			}
 		} else {
-			for (dgInt32 i = 0; (i < data->m_faceCount) && (faceIndexCount0 < (DG_MAX_COLLIDING_INDICES - 32)); i ++) {
+			for (dgInt32 i = 0; i < data->m_faceCount; i ++) {
 				dgInt32 indexCount = faceIndexCountArray[i];
 				const dgInt32* const indexArray = &srcIndices[faceIndexCount1]; 
 
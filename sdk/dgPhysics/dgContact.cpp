@@ -66,7 +66,7 @@ dgContactMaterial::dgContactMaterial()
 }
 
 dgContact::dgContact(dgWorld* const world, const dgContactMaterial* const material)
-	:dgConstraint(), dgList<dgContactMaterial>(world->GetAllocator())
+	:dgConstraint()
 	,m_positAcc (dgFloat32(0.0f))
 	,m_rotationAcc (dgFloat32(1.0f), dgFloat32(0.0f), dgFloat32(0.0f), dgFloat32(0.0f))
 	,m_closestDistance (dgFloat32 (0.0f))
@@ -74,6 +74,11 @@ dgContact::dgContact(dgWorld* const world, const dgContactMaterial* const materi
 	,m_timeOfImpact(dgFloat32 (0.0f))
 	,m_material(material)
 	,m_contactNode(NULL)
+	,m_contacts(NULL)
+	,m_contactCount(0)
+	,m_contactCapacity(0)
+	,m_removedCount(0)
+	,m_simplexCacheCount(0)
 	,m_contactPruningTolereance(world->GetContactMergeTolerance())
 	,m_broadphaseLru(0)
 	,m_isNewContact(1)
@@ -86,7 +91,7 @@ dgContact::dgContact(dgWorld* const world, const dgContactMaterial* const materi
 }
 
 dgContact::dgContact(dgContact* const clone)
-	:dgConstraint(*clone), dgList<dgContactMaterial>(clone->GetAllocator())
+	:dgConstraint(*clone)
 	,m_positAcc(clone->m_positAcc)
 	,m_rotationAcc(clone->m_rotationAcc)
 	,m_separtingVector (clone->m_separtingVector)
@@ -95,6 +100,11 @@ dgContact::dgContact(dgContact* const clone)
 	,m_timeOfImpact(clone->m_timeOfImpact)
 	,m_material(clone->m_material)
 	,m_contactNode(clone->m_contactNode)
+	,m_contacts(NULL)
+	,m_contactCount(0)
+	,m_contactCapacity(0)
+	,m_removedCount(0)
+	,m_simplexCacheCount(clone->m_simplexCacheCount)
 	,m_contactPruningTolereance(clone->m_contactPruningTolereance)
 	,m_broadphaseLru(clone->m_broadphaseLru)
 	,m_isNewContact(clone->m_isNewContact)
@@ -107,12 +117,23 @@ dgContact::dgContact(dgContact* const clone)
 	m_constId = m_contactConstraint;
 	m_contactActive = clone->m_contactActive;
 	m_enableCollision = clone->m_enableCollision;
-	Merge (*clone);
+
+	ReserveContacts (clone->m_contactCount);
+	for (dgInt32 i = 0; i < clone->m_contactCount; i ++) {
+		m_contacts[i] = clone->m_contacts[i];
+	}
+	m_contactCount = clone->m_contactCount;
+	m_removedCount = clone->m_removedCount;
+	for (dgInt32 i = 0; i < m_simplexCacheCount; i ++) {
+		m_simplexCache[i] = clone->m_simplexCache[i];
+	}
 }
 
 dgContact::~dgContact()
 {
-	dgList<dgContactMaterial>::RemoveAll();
+	if (m_contacts) {
+		dgFree (m_contacts);
+	}
 
 	if (m_contactNode) {
 		dgAssert (m_body0);
@@ -135,6 +156,55 @@ void dgContact::SwapBodies()
 	dgSwap (m_link0, m_link1);
 }
 
+void dgContact::ReserveContacts(dgInt32 count)
+{
+	// the point buffer only grows, so a pair in steady contact never allocates again
+	if (count > m_contactCapacity) {
+		dgAssert (m_body0);
+		dgInt32 capacity = dgMax (count, m_contactCapacity * 2, dgInt32 (4));
+		dgContactMaterial* const contacts = (dgContactMaterial*) dgMalloc (capacity * sizeof (dgContactMaterial), m_body0->m_world->GetAllocator());
+		dgAssert ((((dgUnsigned64) contacts) & 15) == 0);
+		for (dgInt32 i = 0; i < m_contactCount; i ++) {
+			contacts[i] = m_contacts[i];
+		}
+		for (dgInt32 i = m_contactCount; i < capacity; i ++) {
+			new (&contacts[i]) dgContactMaterial();
+		}
+		if (m_contacts) {
+			dgFree (m_contacts);
+		}
+		m_contacts = contacts;
+		m_contactCapacity = capacity;
+	}
+}
+
+void dgContact::RemoveContact(dgContactMaterial* const contact)
+{
+	dgAssert (contact >= m_contacts);
+	dgAssert (contact < &m_contacts[m_contactCount]);
+	if (!(contact->m_flags & dgContactMaterial::m_removedContact)) {
+		contact->m_flags |= dgContactMaterial::m_removedContact;
+		m_removedCount ++;
+	}
+}
+
+void dgContact::CompactContacts()
+{
+	if (m_removedCount) {
+		dgInt32 count = 0;
+		for (dgInt32 i = 0; i < m_contactCount; i ++) {
+			if (!(m_contacts[i].m_flags & dgContactMaterial::m_removedContact)) {
+				if (count != i) {
+					m_contacts[count] = m_contacts[i];
+				}
+				count ++;
+			}
+		}
+		m_contactCount = count;
+		m_removedCount = 0;
+	}
+}
+
 void dgContact::GetInfo (dgConstraintInfo* const info) const
 {
 	memset (info, 0, sizeof (dgConstraintInfo));
@@ -166,12 +236,10 @@ dgUnsigned32 dgContact::JacobianDerivative (dgContraintDescritor& params)
 {
 	dgInt32 frictionIndex = 0;
 	if (m_maxDOF) {
-		dgInt32 i = 0;
-		frictionIndex = GetCount();
-		for (dgList<dgContactMaterial>::dgListNode* node = GetFirst(); node; node = node->GetNext()) {
-			const dgContactMaterial& contact = node->GetInfo(); 
-			JacobianContactDerivative (params, contact, i, frictionIndex);
-			i ++;
+		CompactContacts();
+		frictionIndex = m_contactCount;
+		for (dgInt32 i = 0; i < m_contactCount; i ++) {
+			JacobianContactDerivative (params, m_contacts[i], i, frictionIndex);
 		}
 	}
 
@@ -291,10 +359,10 @@ void dgContact::JacobianContactDerivative (dgContraintDescritor& params, const d
 
 void dgContact::JointAccelerations(dgJointAccelerationDecriptor* const params)
 {
-	const dgVector& bodyVeloc0 = m_body0->m_veloc;
-	const dgVector& bodyOmega0 = m_body0->m_omega;
-	const dgVector& bodyVeloc1 = m_body1->m_veloc;
-	const dgVector& bodyOmega1 = m_body1->m_omega;
+	const dgVector& bodyVeloc0 = m_body0->GetStateVeloc();
+	const dgVector& bodyOmega0 = m_body0->GetStateOmega();
+	const dgVector& bodyVeloc1 = m_body1->GetStateVeloc();
+	const dgVector& bodyOmega1 = m_body1->GetStateOmega();
 
 	const dgInt32 count = params->m_rowsCount;
 
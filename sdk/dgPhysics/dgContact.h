@@ -120,6 +120,7 @@ class dgContactMaterial: public dgContactPoint
 		m_override0Friction = 1<<5,
 		m_override1Friction = 1<<6,
 		m_overrideNormalAccel = 1<<7,
+		m_removedContact = 1<<8,
 	};
 
 	DG_MSC_VECTOR_ALIGMENT 
@@ -183,7 +184,7 @@ class dgContactMaterial: public dgContactPoint
 
 
 DG_MSC_VECTOR_ALIGMENT 
-class dgContact: public dgConstraint, public dgList<dgContactMaterial>
+class dgContact: public dgConstraint
 {
 	public:
 	void ResetSkeleton();
@@ -195,6 +196,11 @@ class dgContact: public dgConstraint, public dgList<dgContactMaterial>
 	dgFloat32 GetPruningTolerance() const;
 	void SetPruningTolerance(dgFloat32 tolerance);
 
+	dgInt32 GetCount() const;
+	dgContactMaterial* GetFirstContact() const;
+	dgContactMaterial* GetNextContact(const dgContactMaterial* const contact) const;
+	void RemoveContact(dgContactMaterial* const contact);
+
 	protected:
 	dgContact(dgContact* const clone);
 	dgContact(dgWorld* const world, const dgContactMaterial* const material);
@@ -216,15 +222,23 @@ class dgContact: public dgConstraint, public dgList<dgContactMaterial>
 
 	void AppendToContactList();
 	void SwapBodies();
+	void ReserveContacts(dgInt32 count);
+	void CompactContacts();
 
 	dgVector m_positAcc;
 	dgQuaternion m_rotationAcc;
 	dgVector m_separtingVector;
+	dgVector m_simplexCache[3];
 	dgFloat32 m_closestDistance;
 	dgFloat32 m_separationDistance;
 	dgFloat32 m_timeOfImpact;
 	const dgContactMaterial* m_material;
 	dgContactList::dgListNode* m_contactNode;
+	dgContactMaterial* m_contacts;
+	dgInt32 m_contactCount;
+	dgInt32 m_contactCapacity;
+	dgInt32 m_removedCount;
+	dgInt32 m_simplexCacheCount;
 	dgFloat32 m_contactPruningTolereance;
 	dgUnsigned32 m_broadphaseLru;
 	dgUnsigned32 m_isNewContact				: 1;
@@ -321,6 +335,33 @@ DG_INLINE void dgContact::SetPruningTolerance(dgFloat32 tolerance)
 }
 
 
+DG_INLINE dgInt32 dgContact::GetCount() const
+{
+	return m_contactCount - m_removedCount;
+}
+
+DG_INLINE dgContactMaterial* dgContact::GetFirstContact() const
+{
+	for (dgInt32 i = 0; i < m_contactCount; i ++) {
+		if (!(m_contacts[i].m_flags & dgContactMaterial::m_removedContact)) {
+			return &m_contacts[i];
+		}
+	}
+	return NULL;
+}
+
+DG_INLINE dgContactMaterial* dgContact::GetNextContact(const dgContactMaterial* const contact) const
+{
+	// removed points stay in place until the next compaction, so iterators held by the caller remain valid
+	const dgContactMaterial* const end = m_contacts + m_contactCount;
+	for (const dgContactMaterial* ptr = contact + 1; ptr < end; ptr ++) {
+		if (!(ptr->m_flags & dgContactMaterial::m_removedContact)) {
+			return (dgContactMaterial*) ptr;
+		}
+	}
+	return NULL;
+}
+
 DG_INLINE void dgContact::ResetSkeleton()
 {
 	m_skeletonSelfCollision = 0;
@@ -63,16 +63,20 @@ dgContactSolver::dgContactSolver(dgCollisionInstance* const instance)
 	,m_instance0(instance)
 	,m_instance1(instance)
 	,m_vertexIndex(0)
+	,m_useSimplexCache(false)
+	,m_simplexCacheHit(false)
 {
 }
 
-dgContactSolver::dgContactSolver(dgCollisionParamProxy* const proxy)
+dgContactSolver::dgContactSolver(dgCollisionParamProxy* const proxy, bool useSimplexCache)
 	:dgDownHeap<dgMinkFace*, dgFloat32>(m_heapBuffer, sizeof (m_heapBuffer))
 	,m_normal (proxy->m_contactJoint->m_separtingVector)
 	,m_proxy (proxy)
 	,m_instance0(proxy->m_instance0)
 	,m_instance1(proxy->m_instance1)
 	,m_vertexIndex(0)
+	,m_useSimplexCache(useSimplexCache)
+	,m_simplexCacheHit(false)
 {
 }
 
@@ -93,6 +97,13 @@ DG_INLINE void dgContactSolver::SupportVertex(const dgVector& dir0, dgInt32 vert
 }
 
 
+DG_INLINE void dgContactSolver::CopySimplexVertex(dgInt32 dst, dgInt32 src)
+{
+	m_hullSum[dst] = m_hullSum[src];
+	m_hullDiff[dst] = m_hullDiff[src];
+	m_simplexDir[dst] = m_simplexDir[src];
+}
+
 DG_INLINE dgBigVector dgContactSolver::ReduceLine(dgInt32& indexOut)
 {
 	const dgBigVector p0(m_hullDiff[0]);
@@ -110,8 +121,7 @@ DG_INLINE dgBigVector dgContactSolver::ReduceLine(dgInt32& indexOut)
 		if (alpha0 > mag2) {
 			v = p1;
 			indexOut = 1;
-			m_hullSum[0] = m_hullSum[1];
-			m_hullDiff[0] = m_hullDiff[1];
+			CopySimplexVertex(0, 1);
 		} else if (alpha0 < dgFloat64(0.0f)) {
 			v = p0;
 			indexOut = 1;
@@ -145,11 +155,9 @@ DG_INLINE dgBigVector dgContactSolver::ReduceTriangle (dgInt32& indexOut)
 		if (u2 < dgFloat32(0.0f)) {
 			// this looks funny but it is correct
 		} else if (u1 < dgFloat32(0.0f)) {
-			m_hullSum[1] = m_hullSum[2];
-			m_hullDiff[1] = m_hullDiff[2];
+			CopySimplexVertex(1, 2);
 		} else if ((u1 + u2) > det) {
-			m_hullSum[0] = m_hullSum[2];
-			m_hullDiff[0] = m_hullDiff[2];
+			CopySimplexVertex(0, 2);
 		} else {
 			return p0 + (e10.Scale(u1) + e20.Scale(u2)).Scale(dgFloat64(1.0f) / det);
 		}
@@ -197,14 +205,11 @@ DG_INLINE dgBigVector dgContactSolver::ReduceTetrahedrum (dgInt32& indexOut)
 				if (u3 < dgFloat64(0.0f)) {
 					// this looks funny but it is correct
 				} else if (u2 < dgFloat64(0.0f)) {
-					m_hullSum[2] = m_hullSum[3];
-					m_hullDiff[2] = m_hullDiff[3];
+					CopySimplexVertex(2, 3);
 				} else if (u1 < dgFloat64(0.0f)) {
-					m_hullSum[1] = m_hullSum[3];
-					m_hullDiff[1] = m_hullDiff[3];
+					CopySimplexVertex(1, 3);
 				} else if (u1 + u2 + u3 > dgFloat64(1.0f)) {
-					m_hullSum[0] = m_hullSum[3];
-					m_hullDiff[0] = m_hullDiff[3];
+					CopySimplexVertex(0, 3);
 				} else {
 					return dgBigVector::m_zero;
 				}
@@ -221,13 +226,55 @@ DG_INLINE dgBigVector dgContactSolver::ReduceTetrahedrum (dgInt32& indexOut)
 }
 
 
+// rebuild the last simplex of this pair from its support directions, which are kept in
+// the space of shape 0, so that a pair that did not change features converges on the
+// first iteration. vertices that collapse at the new pose are dropped.
+DG_INLINE dgInt32 dgContactSolver::WarmStartSimplex()
+{
+	const dgContact* const contact = m_proxy->m_contactJoint;
+	const dgMatrix& matrix0 = m_instance0->m_globalMatrix;
+
+	dgInt32 count = 0;
+	for (dgInt32 i = 0; i < contact->m_simplexCacheCount; i ++) {
+		m_simplexDir[count] = matrix0.RotateVector(contact->m_simplexCache[i]);
+		SupportVertex (m_simplexDir[count], count);
+		bool valid = true;
+		if (count == 1) {
+			const dgVector e10 (m_hullDiff[1] - m_hullDiff[0]);
+			valid = e10.DotProduct(e10).GetScalar() > dgFloat32 (1.0e-12f);
+		} else if (count == 2) {
+			const dgVector e10 (m_hullDiff[1] - m_hullDiff[0]);
+			const dgVector e20 (m_hullDiff[2] - m_hullDiff[0]);
+			const dgVector normal (e10.CrossProduct(e20));
+			valid = normal.DotProduct(normal).GetScalar() > dgFloat32 (1.0e-16f);
+		}
+		count += valid ? 1 : 0;
+	}
+	return count;
+}
+
+DG_INLINE void dgContactSolver::SaveSimplexCache(dgInt32 count)
+{
+	dgContact* const contact = m_proxy->m_contactJoint;
+	const dgMatrix& matrix0 = m_instance0->m_globalMatrix;
+	for (dgInt32 i = 0; i < count; i ++) {
+		contact->m_simplexCache[i] = matrix0.UnrotateVector(m_simplexDir[i]);
+	}
+	contact->m_simplexCacheCount = count;
+}
+
 //DG_INLINE dgInt32 dgContactSolver::CalculateClosestSimplex ()
 dgInt32 dgContactSolver::CalculateClosestSimplex()
 {
 	dgBigVector v(dgFloat32 (0.0f));
 	dgInt32 index = 1;
+	const dgInt32 cachedCount = (m_useSimplexCache && (m_vertexIndex <= 0)) ? WarmStartSimplex() : 0;
+	if (cachedCount) {
+		m_vertexIndex = cachedCount;
+	}
 	if (m_vertexIndex <= 0) {
-		SupportVertex (m_proxy->m_contactJoint->m_separtingVector, 0);
+		m_simplexDir[0] = m_proxy->m_contactJoint->m_separtingVector;
+		SupportVertex (m_simplexDir[0], 0);
 		v = m_hullDiff[0];
 	} else {
 		switch (m_vertexIndex) 
@@ -266,6 +313,9 @@ dgInt32 dgContactSolver::CalculateClosestSimplex()
 		dgFloat64 dist = v.DotProduct(v).GetScalar();
 		if (dist < dgFloat32 (1.0e-9f)) {
 			// very deep penetration, resolve with generic minkowsky solver
+			if (m_useSimplexCache) {
+				SaveSimplexCache(0);
+			}
 			return -index; 
 		}
 
@@ -276,11 +326,15 @@ dgInt32 dgContactSolver::CalculateClosestSimplex()
 		cycling ++;
 		if (cycling > 4) {
 			// for now return -1
+			if (m_useSimplexCache) {
+				SaveSimplexCache(0);
+			}
 			return -index;
 		}
 
 		const dgVector dir (v.Scale (-dgRsqrt(dist)));
 		dgAssert (dir.m_w == dgFloat32 (0.0f));
+		m_simplexDir[index] = dir;
 		SupportVertex (dir, index);
 
 		const dgBigVector w (m_hullDiff[index]);
@@ -289,6 +343,10 @@ dgInt32 dgContactSolver::CalculateClosestSimplex()
 		const dgFloat64 dist1 = dir.DotProduct(wv).GetScalar();
 		if (dist1 < dgFloat64 (1.0e-3f)) {
 			m_normal = dir;
+			if (m_useSimplexCache) {
+				m_simplexCacheHit = cachedCount && !iter;
+				SaveSimplexCache(index);
+			}
 			break;
 		}
 
@@ -316,6 +374,9 @@ dgInt32 dgContactSolver::CalculateClosestSimplex()
 
 		iter ++;
 	} while (iter < DG_CONNICS_CONTATS_ITERATIONS); 
+	if (m_useSimplexCache && (iter >= DG_CONNICS_CONTATS_ITERATIONS)) {
+		SaveSimplexCache(0);
+	}
 	return (index < 4) ? index : -4;
 }
 
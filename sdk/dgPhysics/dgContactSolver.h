@@ -53,7 +53,7 @@ DG_MSC_VECTOR_ALIGMENT
 class dgContactSolver: public dgDownHeap<dgMinkFace *, dgFloat32>  
 {
 	public: 
-	dgContactSolver(dgCollisionParamProxy* const proxy);
+	dgContactSolver(dgCollisionParamProxy* const proxy, bool useSimplexCache = false);
 	dgContactSolver(dgCollisionInstance* const instance0);
 
 	bool CalculateClosestPoints();
@@ -64,6 +64,7 @@ class dgContactSolver: public dgDownHeap<dgMinkFace *, dgFloat32>
 	const dgVector& GetNormal() const {return m_normal;}
 	const dgVector& GetPoint0() const {return m_closestPoint0;}
 	const dgVector& GetPoint1() const {return m_closestPoint1;}
+	bool IsSimplexCacheHit() const {return m_simplexCacheHit;}
 	
 	private:
 	class dgPerimenterEdge
@@ -85,6 +86,9 @@ class dgContactSolver: public dgDownHeap<dgMinkFace *, dgFloat32>
 	DG_INLINE void DeleteFace(dgMinkFace* const face);
 	DG_INLINE dgMinkFace* AddFace(dgInt32 v0, dgInt32 v1, dgInt32 v2);
 	DG_INLINE void SupportVertex(const dgVector& dir, dgInt32 vertexIndex);
+	DG_INLINE void CopySimplexVertex(dgInt32 dst, dgInt32 src);
+	DG_INLINE dgInt32 WarmStartSimplex();
+	DG_INLINE void SaveSimplexCache(dgInt32 count);
 	
 	DG_INLINE void TranslateSimplex(const dgVector& step);
 	
@@ -112,9 +116,12 @@ class dgContactSolver: public dgDownHeap<dgMinkFace *, dgFloat32>
 	dgFaceFreeList* m_freeFace; 
 	dgInt32 m_vertexIndex;
 	dgInt32 m_faceIndex;
+	bool m_useSimplexCache;
+	bool m_simplexCacheHit;
 
 	dgVector m_hullDiff[DG_CONVEX_MINK_MAX_POINTS];
 	dgVector m_hullSum[DG_CONVEX_MINK_MAX_POINTS];
+	dgVector m_simplexDir[4];
 	dgMinkFace* m_faceStack[DG_CONVEX_MINK_STACK_SIZE];
 	dgMinkFace* m_coneFaceList[DG_CONVEX_MINK_STACK_SIZE];
 	dgMinkFace* m_deletedFaceList[DG_CONVEX_MINK_STACK_SIZE];
@@ -83,7 +83,7 @@ dgMatrix dgDynamicBodyAsymetric::CalculateLocalInertiaMatrix() const
 
 dgMatrix dgDynamicBodyAsymetric::CalculateInertiaMatrix() const
 {
-	dgMatrix matrix(m_principalAxis * m_matrix);
+	dgMatrix matrix(m_principalAxis * GetStateMatrix());
 	matrix.m_posit = dgVector::m_wOne;
 	dgMatrix diagonal(dgGetIdentityMatrix());
 	diagonal[0][0] = m_mass[0];
@@ -94,7 +94,7 @@ dgMatrix dgDynamicBodyAsymetric::CalculateInertiaMatrix() const
 
 dgMatrix dgDynamicBodyAsymetric::CalculateInvInertiaMatrix() const
 {
-	dgMatrix matrix(m_principalAxis * m_matrix);
+	dgMatrix matrix(m_principalAxis * GetStateMatrix());
 	matrix.m_posit = dgVector::m_wOne;
 	dgMatrix diagonal(dgGetIdentityMatrix());
 	diagonal[0][0] = m_invMass[0];
@@ -212,7 +212,7 @@ dgVector dgDynamicBody::GetAlpha() const
 
 dgVector dgDynamicBody::GetAccel() const
 {
-	return m_accel;
+	return GetStateAccel();
 }
 
 void dgDynamicBody::SetAlpha(const dgVector& alpha)
@@ -222,7 +222,7 @@ void dgDynamicBody::SetAlpha(const dgVector& alpha)
 
 void dgDynamicBody::SetAccel(const dgVector& accel)
 {
-	m_accel = accel;
+	GetStateAccel() = accel;
 }
 
 
@@ -235,7 +235,7 @@ bool dgDynamicBody::IsInEquilibrium() const
 		if (deltaAccel2 > DG_ERR_TOLERANCE2) {
 			return false;
 		}
-		dgVector deltaAlpha(m_matrix.UnrotateVector(m_externalTorque - m_savedExternalTorque) * m_invMass);
+		dgVector deltaAlpha(GetStateMatrix().UnrotateVector(m_externalTorque - m_savedExternalTorque) * m_invMass);
 		dgAssert(deltaAlpha.m_w == 0.0f);
 		dgFloat32 deltaAlpha2 = deltaAlpha.DotProduct(deltaAlpha).GetScalar();
 		if (deltaAlpha2 > DG_ERR_TOLERANCE2) {
@@ -255,7 +255,7 @@ void dgDynamicBody::ApplyExtenalForces (dgFloat32 timestep, dgInt32 threadIndex)
 	}
 
 	m_gyroRotation = m_rotation;
-	m_gyroTorque = m_omega.CrossProduct(CalculateAngularMomentum());
+	m_gyroTorque = GetStateOmega().CrossProduct(CalculateAngularMomentum());
 
 	m_externalForce += m_impulseForce;
 	m_externalTorque += m_impulseTorque;
@@ -277,13 +277,15 @@ void dgDynamicBody::AddDampingAcceleration(dgFloat32 timestep)
 */
 	dgVector damp (GetDampCoeffcient (timestep));
 	if (m_linearDampOn) {
-		m_veloc = m_veloc.Scale(damp.m_w);
+		dgVector& veloc = GetStateVeloc();
+		veloc = veloc.Scale(damp.m_w);
 	}
 
 	if (m_angularDampOn) {
 		dgVector omegaDamp(damp & dgVector::m_triplexMask);
-		dgVector omega(m_matrix.UnrotateVector(m_omega) * omegaDamp);
-		m_omega = m_matrix.RotateVector(omega);
+		const dgMatrix& matrix = GetStateMatrix();
+		dgVector omega(matrix.UnrotateVector(GetStateOmega()) * omegaDamp);
+		GetStateOmega() = matrix.RotateVector(omega);
 	}
 }
 
@@ -328,8 +330,9 @@ void dgDynamicBody::IntegrateImplicit(dgFloat32 timestep)
 	// Iy * ay + (Ix - Iz) * dwz * ax + (Ix - Iz) * dwx * az = Ty - (Ix - Iz) * wz * wx
 	// Iz * az + (Iy - Ix) * dwx * ay + (Iy - Ix) * dwy * ax = Tz - (Iy - Ix) * wx * wy
 
-	dgVector localOmega(m_matrix.UnrotateVector(m_omega));
-	dgVector localTorque(m_matrix.UnrotateVector(m_externalTorque - m_gyroTorque));
+	const dgMatrix& matrix = GetStateMatrix();
+	dgVector localOmega(matrix.UnrotateVector(GetStateOmega()));
+	dgVector localTorque(matrix.UnrotateVector(m_externalTorque - m_gyroTorque));
 
 	// and solving for alpha we get the angular acceleration at t + dt
 	// calculate gradient at a full time step
@@ -389,11 +392,12 @@ void dgDynamicBody::IntegrateImplicit(dgFloat32 timestep)
 	gradientStep[0] = (gradientStep[0] - jacobianMatrix[0][1] * gradientStep[1] - jacobianMatrix[0][2] * gradientStep[2]) / jacobianMatrix[0][0];
 	localOmega += gradientStep;
 
-	m_accel = m_externalForce.Scale(m_invMass.m_w);
-	m_alpha = m_matrix.RotateVector(localTorque * m_invMass);
+	dgVector accel(m_externalForce.Scale(m_invMass.m_w));
+	GetStateAccel() = accel;
+	m_alpha = matrix.RotateVector(localTorque * m_invMass);
 
-	m_veloc += m_accel.Scale(timestep);
-	m_omega = m_matrix.RotateVector(localOmega);
+	GetStateVeloc() += accel.Scale(timestep);
+	GetStateOmega() = matrix.RotateVector(localOmega);
 }
 
 void dgDynamicBody::IntegrateExplicit(dgFloat32 timestep, dgInt32 method)
@@ -405,9 +409,11 @@ void dgDynamicBody::IntegrateExplicit(dgFloat32 timestep, dgInt32 method)
 	// f(t + dt) = f(t) + f'(t) * dt
 
 	dgVector externalTorque(m_externalTorque - m_gyroTorque);
-	m_accel = m_externalForce.Scale(m_invMass.m_w);
+	const dgMatrix& bodyMatrix = GetStateMatrix();
+	dgVector& omega = GetStateOmega();
+	GetStateAccel() = m_externalForce.Scale(m_invMass.m_w);
 	m_alpha = externalTorque * m_invMass;
-	m_veloc += m_accel.Scale(timestep);
+	GetStateVeloc() += GetStateAccel().Scale(timestep);
 
 	dgTrace (("forward Euler %d: ", method));
 	switch (method)
@@ -418,8 +424,8 @@ void dgDynamicBody::IntegrateExplicit(dgFloat32 timestep, dgInt32 method)
 			dgVector dt (timestep * dgFloat32(0.25f));
 			for (dgInt32 i = 0; i < 4; i++) {
 				dgVector toque(m_externalTorque - m_gyroTorque);
-				dgVector alpha(m_matrix.RotateVector(m_invMass * m_matrix.UnrotateVector(toque)));
-				m_omega += alpha * dt;
+				dgVector alpha(bodyMatrix.RotateVector(m_invMass * bodyMatrix.UnrotateVector(toque)));
+				omega += alpha * dt;
 			}
 			break;
 		}
@@ -429,15 +435,15 @@ void dgDynamicBody::IntegrateExplicit(dgFloat32 timestep, dgInt32 method)
 			// subdivide time step and recalculate gyro toque, 
 			// but keeps everything else constants during the sub steps.
 			dgVector dt (timestep * dgFloat32(0.25f));
-			dgVector externTorque(m_matrix.UnrotateVector(m_externalTorque));
-			dgVector localOmega(m_matrix.UnrotateVector(m_omega));
+			dgVector externTorque(bodyMatrix.UnrotateVector(m_externalTorque));
+			dgVector localOmega(bodyMatrix.UnrotateVector(omega));
 			for (dgInt32 i = 0; i < 4; i++) {
 				dgVector gyroTorque(localOmega.CrossProduct(m_mass * localOmega));
 				dgVector torque(externTorque - gyroTorque);
 				dgVector alpha(torque * m_invMass);
 				localOmega += alpha * dt;
 			}
-			m_omega = m_matrix.RotateVector(localOmega);
+			omega = bodyMatrix.RotateVector(localOmega);
 			break;
 		}
 
@@ -446,22 +452,22 @@ void dgDynamicBody::IntegrateExplicit(dgFloat32 timestep, dgInt32 method)
 			// subdivide time step, recalculate gyro toque and rotation matrix, 
 			// but still doing forward Euler steps.
 			dgVector dt (timestep * dgFloat32(0.25f));
-			dgVector externTorque(m_matrix.UnrotateVector(m_externalTorque));
+			dgVector externTorque(bodyMatrix.UnrotateVector(m_externalTorque));
 			for (dgInt32 i = 0; i < 4; i++) {
 				dgMatrix matrix(m_gyroRotation, dgVector::m_wOne);
-				dgVector localOmega(matrix.UnrotateVector(m_omega));
+				dgVector localOmega(matrix.UnrotateVector(omega));
 				dgVector gyroTorque(localOmega.CrossProduct(m_mass * localOmega));
 				dgVector torque(externTorque - gyroTorque);
 				dgVector alpha(torque * m_invMass);
 				localOmega += alpha * dt;
-				m_omega = matrix.RotateVector(localOmega);
+				omega = matrix.RotateVector(localOmega);
 
 				// integrate rotation here
-				dgAssert(m_veloc.m_w == dgFloat32(0.0f));
-				dgAssert(m_omega.m_w == dgFloat32(0.0f));
-				dgFloat32 omegaMag2 = m_omega.DotProduct(m_omega).GetScalar() + dgFloat32 (1.0e-12f);;
+				dgAssert(GetStateVeloc().m_w == dgFloat32(0.0f));
+				dgAssert(omega.m_w == dgFloat32(0.0f));
+				dgFloat32 omegaMag2 = omega.DotProduct(omega).GetScalar() + dgFloat32 (1.0e-12f);;
 					dgFloat32 invOmegaMag = dgRsqrt(omegaMag2);
-					dgVector omegaAxis(m_omega.Scale(invOmegaMag));
+					dgVector omegaAxis(omega.Scale(invOmegaMag));
 					dgFloat32 omegaAngle = invOmegaMag * omegaMag2 * dt.GetScalar();
 					dgQuaternion deltaRotation(omegaAxis, omegaAngle);
 				m_gyroRotation = m_gyroRotation * deltaRotation;
@@ -477,11 +483,11 @@ void dgDynamicBody::IntegrateExplicit(dgFloat32 timestep, dgInt32 method)
 			// but backward Euler at each step.
 			dgVector dt(timestep * dgFloat32(0.25f));
 			dgVector dtHalf(dt * dgVector::m_half);
-			dgVector externTorque(m_matrix.UnrotateVector(m_externalTorque));
+			dgVector externTorque(bodyMatrix.UnrotateVector(m_externalTorque));
 
 			for (dgInt32 i = 0; i < 4; i++) {
 				dgMatrix matrix(m_gyroRotation, dgVector::m_wOne);
-				dgVector localOmega(matrix.UnrotateVector(m_omega));
+				dgVector localOmega(matrix.UnrotateVector(omega));
 				dgVector gyroTorque(localOmega.CrossProduct(m_mass * localOmega));
 				dgVector torque(externTorque - gyroTorque);
 
@@ -532,14 +538,14 @@ void dgDynamicBody::IntegrateExplicit(dgFloat32 timestep, dgInt32 method)
 				gradientStep[0] = (gradientStep[0] - jacobianMatrix[0][1] * gradientStep[1] - jacobianMatrix[0][2] * gradientStep[2]) / jacobianMatrix[0][0];
 				localOmega += gradientStep;
 
-				m_omega = matrix.RotateVector(localOmega);
+				omega = matrix.RotateVector(localOmega);
 
 				// integrate rotation here
-				dgAssert(m_veloc.m_w == dgFloat32(0.0f));
-				dgAssert(m_omega.m_w == dgFloat32(0.0f));
-				dgFloat32 omegaMag2 = m_omega.DotProduct(m_omega).GetScalar() + dgFloat32 (1.0e-12f);
+				dgAssert(GetStateVeloc().m_w == dgFloat32(0.0f));
+				dgAssert(omega.m_w == dgFloat32(0.0f));
+				dgFloat32 omegaMag2 = omega.DotProduct(omega).GetScalar() + dgFloat32 (1.0e-12f);
 				dgFloat32 invOmegaMag = dgRsqrt(omegaMag2);
-				dgVector omegaAxis(m_omega.Scale(invOmegaMag));
+				dgVector omegaAxis(omega.Scale(invOmegaMag));
 				dgFloat32 omegaAngle = invOmegaMag * omegaMag2 * dt.GetScalar();
 				dgQuaternion deltaRotation(omegaAxis, omegaAngle);
 				m_gyroRotation = m_gyroRotation * deltaRotation;
@@ -571,7 +577,7 @@ if (m_uniqueID == 4)
 			lumpedMassShape->IntegrateForces(timestep);
 		}
 	} else {
-		m_accel = dgVector::m_zero;
+		GetStateAccel() = dgVector::m_zero;
 		m_alpha = dgVector::m_zero;
 	}
 }
@@ -112,6 +112,10 @@ class dgDynamicBody : public dgBody
 
 	friend class dgWorld;
 	friend class dgSolver;
+	friend class dgSolverSse::dgSolver;
+	friend class dgSolverAvx::dgSolver;
+	friend class dgSolverAvx2::dgSolver;
+	friend class dgSolverAvx512::dgSolver;
 	friend class dgBroadPhase;
 	friend class dgBodyMasterList;
 	friend class dgInverseDynamics;
@@ -215,12 +219,12 @@ DG_INLINE void dgDynamicBody::SetTorque (const dgVector& torque)
 
 DG_INLINE dgVector dgDynamicBody::PredictLinearVelocity(dgFloat32 timestep) const
 {
-	return 	m_veloc + m_externalForce.Scale (timestep * m_invMass.m_w);
+	return 	GetStateVeloc() + m_externalForce.Scale (timestep * m_invMass.m_w);
 }
 
 DG_INLINE dgVector dgDynamicBody::PredictAngularVelocity(dgFloat32 timestep) const
 {
-	return m_omega + m_invWorldInertiaMatrix.RotateVector(m_externalTorque).Scale (timestep);
+	return GetStateOmega() + m_invWorldInertiaMatrix.RotateVector(m_externalTorque).Scale (timestep);
 }
 
 
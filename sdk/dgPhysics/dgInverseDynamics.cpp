@@ -1298,10 +1298,10 @@ dgTrace(("inv dyn %d\n", xxx));
 		dgVector velocStep(externalForce[i].m_linear.Scale(timestep * body->m_invMass.m_w));
 		dgVector omegaStep(body->m_invWorldInertiaMatrix.RotateVector(externalForce[i].m_angular) * timestep4);
 
-		velocity0[i].m_linear = body->m_veloc;
-		velocity0[i].m_angular = body->m_omega;
-		velocity1[i].m_linear = body->m_veloc + velocStep;
-		velocity1[i].m_angular = body->m_omega + omegaStep;
+		velocity0[i].m_linear = body->GetStateVeloc();
+		velocity0[i].m_angular = body->GetStateOmega();
+		velocity1[i].m_linear = body->GetStateVeloc() + velocStep;
+		velocity1[i].m_angular = body->GetStateOmega() + omegaStep;
 
 dgTrace(("%d v(%f %f %f) w(%f %f %f)\n", body->m_uniqueID,
 	velocity1[i].m_linear.m_x, velocity1[i].m_linear.m_y, velocity1[i].m_linear.m_z,
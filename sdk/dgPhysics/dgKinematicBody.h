@@ -50,8 +50,8 @@ class dgKinematicBody: public dgBody
 	virtual void SetLinearDamping (dgFloat32 linearDamp) {}
 	virtual void SetAngularDamping (const dgVector& angularDamp) {}
 
-	virtual dgVector PredictLinearVelocity(dgFloat32 timestep) const {return m_veloc;}
-	virtual dgVector PredictAngularVelocity(dgFloat32 timestep) const {return m_omega;}
+	virtual dgVector PredictLinearVelocity(dgFloat32 timestep) const {return GetStateVeloc();}
+	virtual dgVector PredictAngularVelocity(dgFloat32 timestep) const {return GetStateOmega();}
 
 	virtual bool IsInEquilibrium  () const {return true;}
 	virtual void SetCollidable (bool state) {m_collidable = state;}
@@ -42,6 +42,7 @@
 #include "dgWorldDynamicUpdate.h"
 #include "dgCollisionConvexHull.h"
 #include "dgCollisionHeightField.h"
+#include "dgCollisionTiledHeightField.h"
 #include "dgCollisionConvexPolygon.h"
 #include "dgCollisionDeformableMesh.h"
 #include "dgCollisionChamferCylinder.h"
@@ -315,6 +316,18 @@ dgCollisionInstance* dgWorld::CreateHeightField(
 	return instance;
 }
 
+dgCollisionInstance* dgWorld::CreateTiledHeightField(
+	dgInt32 tileSize, dgInt32 contructionMode, dgInt32 elevationDataType, 
+	dgFloat32 verticalScale, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z)
+{
+	dgCollision* const collision = new  (m_allocator) dgCollisionTiledHeightField (this, tileSize, contructionMode, 
+																				   elevationDataType ? dgCollisionHeightField::m_unsigned16Bit : dgCollisionHeightField::m_float32Bit,	
+																				   verticalScale, horizontalScale_x, horizontalScale_z);
+	dgCollisionInstance* const instance = CreateInstance (collision, 0, dgGetIdentityMatrix()); 
+	collision->Release();
+	return instance;
+}
+
 dgCollisionInstance* dgWorld::CreateInstance (const dgCollision* const child, dgInt32 shapeID, const dgMatrix& offsetMatrix)
 {
 	dgAssert (dgAbs (offsetMatrix[0].DotProduct(offsetMatrix[0]).GetScalar() - dgFloat32 (1.0f)) < dgFloat32 (1.0e-5f));
@@ -439,16 +452,18 @@ dgInt32 dgWorld::ClosestPoint(const dgCollisionInstance* const collisionSrcA, co
 {
 	dgKinematicBody collideBodyA;
 	dgKinematicBody collideBodyB;
+	m_bodyState.AttachScratchBody(&collideBodyA, threadIndex, 0);
+	m_bodyState.AttachScratchBody(&collideBodyB, threadIndex, 1);
 	dgContactPoint contacts[DG_MAX_CONTATCS];
 
 	dgCollisionInstance collisionA(*collisionSrcA, collisionSrcA->GetChildShape());
 	dgCollisionInstance collisionB(*collisionSrcB, collisionSrcB->GetChildShape());
 
-	collideBodyA.m_matrix = matrixA;
+	collideBodyA.GetStateMatrix() = matrixA;
 	collideBodyA.m_collision = &collisionA;
 	collisionA.SetGlobalMatrix(collisionA.GetLocalMatrix() * matrixA);
 
-	collideBodyB.m_matrix = matrixB;
+	collideBodyB.GetStateMatrix() = matrixB;
 	collideBodyB.m_collision = &collisionB;
 	collisionB.SetGlobalMatrix (collisionB.GetLocalMatrix() * matrixB);
 
@@ -504,18 +519,20 @@ bool dgWorld::IntersectionTest (const dgCollisionInstance* const collisionSrcA,
 {
 	dgKinematicBody collideBodyA;
 	dgKinematicBody collideBodyB;
+	m_bodyState.AttachScratchBody(&collideBodyA, threadIndex, 0);
+	m_bodyState.AttachScratchBody(&collideBodyB, threadIndex, 1);
 	dgCollisionInstance collisionA(*collisionSrcA, collisionSrcA->GetChildShape());
 	dgCollisionInstance collisionB(*collisionSrcB, collisionSrcB->GetChildShape());
 
 	collideBodyA.m_world = this;
 	collideBodyA.SetContinueCollisionMode(false); 
-	collideBodyA.m_matrix = matrixA;
+	collideBodyA.GetStateMatrix() = matrixA;
 	collideBodyA.m_collision = &collisionA;
 	collideBodyA.UpdateCollisionMatrix(dgFloat32 (0.0f), 0);
 
 	collideBodyB.m_world = this;
 	collideBodyB.SetContinueCollisionMode(false); 
-	collideBodyB.m_matrix = matrixB;
+	collideBodyB.GetStateMatrix() = matrixB;
 	collideBodyB.m_collision = &collisionB;
 	collideBodyB.UpdateCollisionMatrix(dgFloat32 (0.0f), 0);
 
@@ -725,13 +742,13 @@ void dgWorld::ProcessCachedContacts (dgContact* const contact, dgFloat32 timeste
 	dgAssert (contact->m_material);
 	dgAssert (contact->m_body0 != contact->m_body1);
 
-	dgList<dgContactMaterial>& list = *contact;
 	const dgContactMaterial* const material = contact->m_material;
 
-	dgList<dgContactMaterial>::dgListNode* nextContactNode;
-	for (dgList<dgContactMaterial>::dgListNode *contactNode = list.GetFirst(); contactNode; contactNode = nextContactNode) {
-		nextContactNode = contactNode->GetNext();
-		dgContactMaterial& contactMaterial = contactNode->GetInfo();
+	contact->CompactContacts();
+	const dgInt32 count = contact->m_contactCount;
+	dgContactMaterial* const contacts = contact->m_contacts;
+	for (dgInt32 i = 0; i < count; i ++) {
+		dgContactMaterial& contactMaterial = contacts[i];
 
 		dgAssert (dgCheckFloat(contactMaterial.m_point.m_x));
 		dgAssert (dgCheckFloat(contactMaterial.m_point.m_y));
@@ -776,27 +793,36 @@ void dgWorld::PopulateContacts (dgBroadPhase::dgPair* const pair, dgInt32 thread
 	const dgContactPoint* const contactArray = pair->m_contactBuffer;
 
 	dgInt32 contactCount = pair->m_contactCount;
-	dgList<dgContactMaterial>& list = *contact;
 
 	contact->m_timeOfImpact = pair->m_timestep;
 
-	dgInt32 count = 0;
+	// save the position and the accumulated forces of the cached points, they are overwritten in place below
+	contact->CompactContacts();
+	dgInt32 count = contact->m_contactCount;
 	dgVector cachePosition [DG_MAX_CONTATCS];
-	dgList<dgContactMaterial>::dgListNode *nodes[DG_MAX_CONTATCS];
-
-	for (dgList<dgContactMaterial>::dgListNode *contactNode = list.GetFirst(); contactNode; contactNode = contactNode->GetNext()) {
+	dgForceImpactPair cacheForces [DG_MAX_CONTATCS][3];
+	for (dgInt32 i = 0; i < count; i ++) {
+		const dgContactMaterial& cached = contact->m_contacts[i];
+		cachePosition[i] = cached.m_point;
+		cacheForces[i][0] = cached.m_normal_Force;
+		cacheForces[i][1] = cached.m_dir0_Force;
+		cacheForces[i][2] = cached.m_dir1_Force;
+	}
 
-		nodes[count] = contactNode;
-		cachePosition[count] = contactNode->GetInfo().m_point;
-		count ++;
+	if (contactCount > contact->m_contactCapacity) {
+		GlobalLock();
+		contact->ReserveContacts (contactCount);
+		GlobalUnlock();
 	}
+	contact->m_contactCount = contactCount;
+	dgContactMaterial* const contacts = contact->m_contacts;
 
-	const dgVector& v0 = body0->m_veloc;
-	const dgVector& w0 = body0->m_omega;
+	const dgVector& v0 = body0->GetStateVeloc();
+	const dgVector& w0 = body0->GetStateOmega();
 	const dgVector& com0 = body0->m_globalCentreOfMass;
 
-	const dgVector& v1 = body1->m_veloc;
-	const dgVector& w1 = body1->m_omega;
+	const dgVector& v1 = body1->GetStateVeloc();
+	const dgVector& w1 = body1->GetStateOmega();
 	const dgVector& com1 = body1->m_globalCentreOfMass;
 
 	dgVector controlDir0 (dgFloat32 (0.0f));
@@ -831,7 +857,6 @@ void dgWorld::PopulateContacts (dgBroadPhase::dgPair* const pair, dgInt32 thread
 //	dgFloat32 breakImpulse1 = dgFloat32 (0.0f);
 	for (dgInt32 i = 0; i < contactCount; i ++) {
 
-		dgList<dgContactMaterial>::dgListNode* contactNode = NULL;
 		dgFloat32 min = dgFloat32 (1.0e20f);
 		dgInt32 index = -1;
 		for (dgInt32 j = 0; j < count; j ++) {
@@ -841,23 +866,29 @@ void dgWorld::PopulateContacts (dgBroadPhase::dgPair* const pair, dgInt32 thread
 			if (diff < min) {
 				min = diff;
 				index = j;
-				contactNode = nodes[j];
 			}
 		}
 
-		if (contactNode) {
+		dgContactMaterial* const contactMaterial = &contacts[i];
+		if (index != -1) {
+			// the point persists, keep its forces to warm start the solver
+			contactMaterial->m_normal_Force = cacheForces[index][0];
+			contactMaterial->m_dir0_Force = cacheForces[index][1];
+			contactMaterial->m_dir1_Force = cacheForces[index][2];
 			count --;
-			dgAssert (index != -1);
-			nodes[index] = nodes[count];
 			cachePosition[index] = cachePosition[count];
+			cacheForces[index][0] = cacheForces[count][0];
+			cacheForces[index][1] = cacheForces[count][1];
+			cacheForces[index][2] = cacheForces[count][2];
 		} else {
-			GlobalLock();
-			contactNode = list.Append ();
-			GlobalUnlock();
+			contactMaterial->m_normal_Force.m_force = dgFloat32 (0.0f);
+			contactMaterial->m_normal_Force.m_impact = dgFloat32 (0.0f);
+			contactMaterial->m_dir0_Force.m_force = dgFloat32 (0.0f);
+			contactMaterial->m_dir0_Force.m_impact = dgFloat32 (0.0f);
+			contactMaterial->m_dir1_Force.m_force = dgFloat32 (0.0f);
+			contactMaterial->m_dir1_Force.m_impact = dgFloat32 (0.0f);
 		}
 
-		dgContactMaterial* const contactMaterial = &contactNode->GetInfo();
-
 		dgAssert (dgCheckFloat(contactArray[i].m_point.m_x));
 		dgAssert (dgCheckFloat(contactArray[i].m_point.m_y));
 		dgAssert (dgCheckFloat(contactArray[i].m_point.m_z));
@@ -954,14 +985,6 @@ void dgWorld::PopulateContacts (dgBroadPhase::dgPair* const pair, dgInt32 thread
 		//contactMaterial->m_dir1.m_w = dgFloat32 (0.0f); 
 	}
 
-	if (count) {
-		GlobalLock();
-		for (dgInt32 i = 0; i < count; i ++) {
-			list.Remove(nodes[i]);
-		}
-		GlobalUnlock();
-	}
-
 	contact->m_maxDOF = dgUnsigned32 (3 * contact->GetCount());
 	if (material->m_processContactPoint) {
 		material->m_processContactPoint(*contact, pair->m_timestep, threadIndex);
@@ -1212,6 +1235,8 @@ dgInt32 dgWorld::CollideContinue (
 {
 	dgKinematicBody collideBodyA;
 	dgKinematicBody collideBodyB;
+	m_bodyState.AttachScratchBody(&collideBodyA, threadIndex, 0);
+	m_bodyState.AttachScratchBody(&collideBodyB, threadIndex, 1);
 	dgCollisionInstance collisionA(*collisionSrcA, collisionSrcA->GetChildShape());
 	dgCollisionInstance collisionB(*collisionSrcB, collisionSrcB->GetChildShape());
 
@@ -1225,22 +1250,22 @@ dgInt32 dgWorld::CollideContinue (
 
 	collideBodyA.m_world = this;
 	collideBodyA.SetContinueCollisionMode(true); 
-	collideBodyA.m_matrix = matrixA;
+	collideBodyA.GetStateMatrix() = matrixA;
 	collideBodyA.m_collision = &collisionA;
 	collideBodyA.m_masterNode = NULL;
 	collideBodyA.m_broadPhaseNode = NULL;
-	collideBodyA.m_veloc = dgVector (velocA[0], velocA[1], velocA[2], dgFloat32 (0.0f));
-	collideBodyA.m_omega = dgVector (omegaA[0], omegaA[1], omegaA[2], dgFloat32 (0.0f));
+	collideBodyA.GetStateVeloc() = dgVector (velocA[0], velocA[1], velocA[2], dgFloat32 (0.0f));
+	collideBodyA.GetStateOmega() = dgVector (omegaA[0], omegaA[1], omegaA[2], dgFloat32 (0.0f));
 	collisionA.SetGlobalMatrix(collisionA.GetLocalMatrix() * matrixA);
 
 	collideBodyB.m_world = this;
 	collideBodyB.SetContinueCollisionMode(true); 
-	collideBodyB.m_matrix = matrixB;
+	collideBodyB.GetStateMatrix() = matrixB;
 	collideBodyB.m_collision = &collisionB;
 	collideBodyB.m_masterNode = NULL;
 	collideBodyB.m_broadPhaseNode = NULL;
-	collideBodyB.m_veloc = dgVector (velocB[0], velocB[1], velocB[2], dgFloat32 (0.0f));
-	collideBodyB.m_omega = dgVector (omegaB[0], omegaB[1], omegaB[2], dgFloat32 (0.0f));
+	collideBodyB.GetStateVeloc() = dgVector (velocB[0], velocB[1], velocB[2], dgFloat32 (0.0f));
+	collideBodyB.GetStateOmega() = dgVector (omegaB[0], omegaB[1], omegaB[2], dgFloat32 (0.0f));
 	collisionB.SetGlobalMatrix(collisionB.GetLocalMatrix() * matrixB);
 
 	dgContactMaterial material;
@@ -1269,7 +1294,7 @@ dgInt32 dgWorld::CollideContinue (
 		//dgFloat32 swapContactScale = (contactJoint.GetBody0() != &collideBodyA) ? dgFloat32 (-1.0f) : dgFloat32 (1.0f);
 		if (pair.m_flipContacts) {
  			for (dgInt32 i = 0; i < count; i++) {
-				dgVector step ((collideBodyA.m_veloc - collideBodyB.m_veloc).Scale (pair.m_timestep));
+				dgVector step ((collideBodyA.GetStateVeloc() - collideBodyB.GetStateVeloc()).Scale (pair.m_timestep));
 				points[i].m_x = contacts[i].m_point.m_x + step.m_x;
 				points[i].m_y = contacts[i].m_point.m_y + step.m_y;
 				points[i].m_z = contacts[i].m_point.m_z + step.m_z;
@@ -1306,6 +1331,8 @@ dgInt32 dgWorld::Collide (
 {
 	dgKinematicBody collideBodyA;
 	dgKinematicBody collideBodyB;
+	m_bodyState.AttachScratchBody(&collideBodyA, threadIndex, 0);
+	m_bodyState.AttachScratchBody(&collideBodyB, threadIndex, 1);
 	dgCollisionInstance collisionA(*collisionSrcA, collisionSrcA->GetChildShape());
 	dgCollisionInstance collisionB(*collisionSrcB, collisionSrcB->GetChildShape());
 
@@ -1319,13 +1346,13 @@ dgInt32 dgWorld::Collide (
 		
 	collideBodyA.m_world = this;
 	collideBodyA.SetContinueCollisionMode(false); 
-	collideBodyA.m_matrix = matrixA;
+	collideBodyA.GetStateMatrix() = matrixA;
 	collideBodyA.m_collision = &collisionA;
 	collideBodyA.UpdateCollisionMatrix(dgFloat32 (0.0f), 0);
 
 	collideBodyB.m_world = this;
 	collideBodyB.SetContinueCollisionMode(false); 
-	collideBodyB.m_matrix = matrixB;
+	collideBodyB.GetStateMatrix() = matrixB;
 	collideBodyB.m_collision = &collisionB;
 	collideBodyB.UpdateCollisionMatrix(dgFloat32 (0.0f), 0);
 
@@ -1503,9 +1530,10 @@ dgInt32 dgWorld::CalculateConvexToConvexContacts(dgCollisionParamProxy& proxy) c
 				}
 				case m_capsuleCollision:
 				{
+					// only coaxial capsules are degenerate, parallel capsules side by side are not
 					dgMatrix diff(instance0.GetGlobalMatrix() * instance1.GetGlobalMatrix().Inverse());
 					if (dgAbs(diff[0][0]) > dgFloat32(0.9999f)) {
-						if (dgAbs(diff.m_posit.m_x) < dgFloat32(1.0e-3f)) {
+						if ((dgAbs(diff.m_posit.m_y) < dgFloat32(1.0e-3f)) && (dgAbs(diff.m_posit.m_z) < dgFloat32(1.0e-3f))) {
 							diff.m_posit.m_y = dgFloat32(1.0e-3f);
 							instance0.SetGlobalMatrix(diff * instance1.GetGlobalMatrix());
 						}
@@ -1527,6 +1555,7 @@ dgInt32 dgWorld::CalculateConvexToConvexContacts(dgCollisionParamProxy& proxy) c
 		}
 		if (contactJoint->m_isNewContact) {
 			contactJoint->m_isNewContact = false;
+			contactJoint->m_simplexCacheCount = 0;
 			dgVector v((proxy.m_instance0->m_globalMatrix.m_posit - proxy.m_instance1->m_globalMatrix.m_posit) & dgVector::m_triplexMask);
 			dgFloat32 mag2 = v.DotProduct(v).m_x;
 			if (mag2 > dgFloat32(0.0f)) {
@@ -1536,11 +1565,35 @@ dgInt32 dgWorld::CalculateConvexToConvexContacts(dgCollisionParamProxy& proxy) c
 			}
 		}
 
-		dgContactSolver contactSolver(&proxy);
-		if (proxy.m_continueCollision) {
-			count = contactSolver.CalculateConvexCastContacts();
-		} else {
-			count = contactSolver.CalculateConvexToConvexContacts();
+		// common pairs of unscaled or uniformly scaled primitives have closed form kernels, 
+		// the kernel returns -1 for configurations it leaves to the minkowski solver
+		count = -1;
+		const dgInt32 type0 = instance0.GetCollisionPrimityType();
+		const dgInt32 type1 = instance1.GetCollisionPrimityType();
+		if (m_useAnalyticContacts && !proxy.m_continueCollision && !proxy.m_intersectionTestOnly && (type0 < m_nullCollision) && (type1 < m_nullCollision)) {
+			const dgContactKernel& kernel = m_contactKernels[type0][type1];
+			if (kernel.m_kernel && (instance0.GetScaleType() <= dgCollisionInstance::m_uniform) && (instance1.GetScaleType() <= dgCollisionInstance::m_uniform)) {
+				count = CalculateAnalyticContacts(proxy, kernel);
+			}
+		}
+
+		if (count < 0) {
+			// the simplex cache belongs to the pair of body shapes, compound children and
+			// mesh faces share the contact joint and always start from the separating vector
+			const bool useSimplexCache = !proxy.m_continueCollision && (collision0 == proxy.m_body0->m_collision) && (collision1 == proxy.m_body1->m_collision);
+			dgContactSolver contactSolver(&proxy, useSimplexCache);
+			if (proxy.m_continueCollision) {
+				count = contactSolver.CalculateConvexCastContacts();
+			} else {
+				count = contactSolver.CalculateConvexToConvexContacts();
+			}
+			if (useSimplexCache) {
+				dgNarrowPhaseCounters& counters = ((dgWorld*)this)->m_narrowPhaseCounters[proxy.m_threadIndex];
+				counters.m_simplexCacheQueries ++;
+				if (contactSolver.IsSimplexCacheHit()) {
+					counters.m_simplexCacheHits ++;
+				}
+			}
 		}
 
 		proxy.m_closestPointBody0 += origin;
@@ -1618,8 +1671,8 @@ dgInt32 dgWorld::CalculateConvexToNonConvexContacts(dgCollisionParamProxy& proxy
 		if (proxy.m_continueCollision) {
 			data.m_doContinuesCollisionTest = true;
 
-			const dgVector& hullVeloc = data.m_objBody->m_veloc;
-			const dgVector& hullOmega = data.m_objBody->m_omega;
+			const dgVector& hullVeloc = data.m_objBody->GetStateVeloc();
+			const dgVector& hullOmega = data.m_objBody->GetStateOmega();
 
 			dgFloat32 baseLinearSpeed = dgSqrt(hullVeloc.DotProduct(hullVeloc).GetScalar());
 			if (baseLinearSpeed > dgFloat32(1.0e-6f)) {
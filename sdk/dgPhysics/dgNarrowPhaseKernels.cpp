@@ -0,0 +1,1394 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "dgPhysicsStdafx.h"
+
+#include "dgWorld.h"
+#include "dgContact.h"
+#include "dgCollisionBox.h"
+#include "dgContactSolver.h"
+#include "dgCollisionSphere.h"
+#include "dgCollisionCapsule.h"
+#include "dgCollisionInstance.h"
+
+// closed form contact kernels for the common pairs of primitives.
+// they write the same data into the proxy that dgContactSolver does: the normal points
+// from shape1 toward shape0, round shapes are shrunk by DG_PENETRATION_TOL the way their
+// special support functions are, and the contact points lie on the plane half way
+// between the two closest points.
+// shapes with a uniform scale are collided with their scaled dimensions, the round
+// shapes are shrunk before they are scaled, the same as the scaled special support.
+// convex hulls, cylinders, cones and chamfer cylinders have no kernel, their pairs
+// always go through the convex solver.
+
+// same 0.25 degrees tilt the box plane intersection uses to pick a vertex, an edge or a face
+#define DG_KERNEL_FEATURE_TILT		dgFloat32 (0.005f)
+#define DG_KERNEL_PARALLEL_EDGES	dgFloat32 (0.998f)
+#define DG_KERNEL_MAX_FEATURE		16
+
+
+// uniform scale of an instance, one for unscaled instances
+static DG_INLINE dgFloat32 dgKernelScale (const dgCollisionInstance* const instance)
+{
+	dgAssert ((instance->GetScaleType() == dgCollisionInstance::m_unit) || (instance->GetScaleType() == dgCollisionInstance::m_uniform));
+	return instance->GetScale().m_x;
+}
+
+// section of the box by the plane through origin, in local space
+static dgInt32 dgBoxPlaneSection (const dgVector& size, const dgVector& normal, const dgVector& origin, dgVector* const section)
+{
+	dgVector vertex[8];
+	dgFloat32 test[8];
+	for (dgInt32 i = 0; i < 8; i ++) {
+		vertex[i] = dgVector ((i & 1) ? size.m_x : -size.m_x, (i & 2) ? size.m_y : -size.m_y, (i & 4) ? size.m_z : -size.m_z, dgFloat32 (0.0f));
+		test[i] = normal.DotProduct(vertex[i] - origin).GetScalar();
+	}
+
+	dgInt32 count = 0;
+	dgVector centre (dgVector::m_zero);
+	for (dgInt32 i = 0; i < 8; i ++) {
+		for (dgInt32 axis = 1; axis < 8; axis <<= 1) {
+			const dgInt32 j = i | axis;
+			if ((j != i) && ((test[i] * test[j]) < dgFloat32 (0.0f))) {
+				const dgFloat32 t = test[i] / (test[i] - test[j]);
+				section[count] = vertex[i] + (vertex[j] - vertex[i]).Scale (t);
+				centre += section[count];
+				count ++;
+			}
+		}
+	}
+	if (count < 3) {
+		return count;
+	}
+
+	// sort the points around the centre by pseudo angle
+	centre = centre.Scale (dgFloat32 (1.0f) / count);
+	const dgVector axis0 ((section[0] - centre).Normalize());
+	const dgVector axis1 (normal.CrossProduct(axis0));
+	dgFloat32 angle[6];
+	for (dgInt32 i = 0; i < count; i ++) {
+		const dgVector dp (section[i] - centre);
+		const dgFloat32 x = axis0.DotProduct(dp).GetScalar();
+		const dgFloat32 y = axis1.DotProduct(dp).GetScalar();
+		const dgFloat32 p = y / (dgAbs (x) + dgAbs (y) + dgFloat32 (1.0e-12f));
+		angle[i] = (x < dgFloat32 (0.0f)) ? dgFloat32 (2.0f) - p : ((y < dgFloat32 (0.0f)) ? dgFloat32 (4.0f) + p : p);
+	}
+	for (dgInt32 i = 1; i < count; i ++) {
+		const dgFloat32 key = angle[i];
+		const dgVector point (section[i]);
+		dgInt32 j = i - 1;
+		for (; (j >= 0) && (angle[j] > key); j --) {
+			angle[j + 1] = angle[j];
+			section[j + 1] = section[j];
+		}
+		angle[j + 1] = key;
+		section[j + 1] = point;
+	}
+	return count;
+}
+
+// contact feature of the box along dir, the same the box plane intersection returns: when the
+// box reaches past the plane through origin it is the section of the box by that plane, otherwise
+// the vertices on the supporting plane of dir within the feature tilt, a vertex, an edge or a face.
+static dgInt32 dgBoxSupportFeature (const dgMatrix& matrix, const dgVector& size, const dgVector& dir, const dgVector& origin, dgVector* const feature)
+{
+	dgInt32 freeAxis[3];
+	dgInt32 freeCount = 0;
+	dgVector support (dgVector::m_zero);
+	const dgVector localDir (matrix.UnrotateVector(dir));
+	const dgVector localOrigin (matrix.UntransformVector(origin));
+	for (dgInt32 i = 0; i < 3; i ++) {
+		support[i] = (localDir[i] > dgFloat32 (0.0f)) ? size[i] : -size[i];
+		if (dgAbs (localDir[i]) < DG_KERNEL_FEATURE_TILT) {
+			freeAxis[freeCount] = i;
+			freeCount ++;
+		}
+	}
+
+	dgInt32 count = 0;
+	if (localDir.DotProduct(support - localOrigin).GetScalar() > DG_PENETRATION_TOL) {
+		count = dgBoxPlaneSection (size, localDir, localOrigin, feature);
+	} else {
+		for (dgInt32 i = 0; i < freeCount; i ++) {
+			support[freeAxis[i]] = dgFloat32 (0.0f);
+		}
+		switch (freeCount)
+		{
+			case 0:
+			{
+				feature[0] = support;
+				count = 1;
+				break;
+			}
+
+			case 1:
+			{
+				const dgInt32 i = freeAxis[0];
+				feature[0] = support;
+				feature[1] = support;
+				feature[0][i] = size[i];
+				feature[1][i] = -size[i];
+				count = 2;
+				break;
+			}
+
+			default:
+			{
+				const dgInt32 i = freeAxis[0];
+				const dgInt32 j = freeAxis[1];
+				const dgFloat32 sign[4][2] = {{dgFloat32 (1.0f), dgFloat32 (1.0f)}, {dgFloat32 (-1.0f), dgFloat32 (1.0f)}, {dgFloat32 (-1.0f), dgFloat32 (-1.0f)}, {dgFloat32 (1.0f), dgFloat32 (-1.0f)}};
+				for (dgInt32 k = 0; k < 4; k ++) {
+					feature[k] = support;
+					feature[k][i] = size[i] * sign[k][0];
+					feature[k][j] = size[j] * sign[k][1];
+				}
+				count = 4;
+			}
+		}
+	}
+
+	for (dgInt32 i = 0; i < count; i ++) {
+		feature[i].m_w = dgFloat32 (0.0f);
+		feature[i] = matrix.TransformVector(feature[i]);
+	}
+	return count;
+}
+
+// the capsule end points that reach the contact plane, same test the capsule plane intersection does
+static dgInt32 dgCapsuleSupportFeature (const dgVector& p0, const dgVector& p1, dgFloat32 radius, const dgVector& normal, const dgVector& origin, dgVector* const feature)
+{
+	dgInt32 count = 0;
+	const dgFloat32 radius2 = radius * radius;
+	const dgFloat32 dist0 = normal.DotProduct(p0 - origin).GetScalar();
+	if ((dist0 * dist0 - dgFloat32 (5.0e-5f)) < radius2) {
+		feature[count] = p0;
+		count ++;
+	}
+	const dgFloat32 dist1 = normal.DotProduct(p1 - origin).GetScalar();
+	if ((dist1 * dist1 - dgFloat32 (5.0e-5f)) < radius2) {
+		feature[count] = p1;
+		count ++;
+	}
+	return count;
+}
+
+class dgKernelBoxShape
+{
+	public:
+	dgKernelBoxShape (const dgMatrix& matrix, const dgVector& size)
+		:m_matrix (matrix)
+		,m_size (size)
+	{
+	}
+
+	dgInt32 SupportFeature (const dgVector& dir, const dgVector& origin, dgVector* const feature) const
+	{
+		return dgBoxSupportFeature (m_matrix, m_size, dir, origin, feature);
+	}
+
+	const dgMatrix& m_matrix;
+	const dgVector& m_size;
+};
+
+class dgKernelCapsuleShape
+{
+	public:
+	dgKernelCapsuleShape (const dgVector& p0, const dgVector& p1, dgFloat32 radius)
+		:m_p0 (p0)
+		,m_p1 (p1)
+		,m_radius (radius)
+	{
+	}
+
+	dgInt32 SupportFeature (const dgVector& dir, const dgVector& origin, dgVector* const feature) const
+	{
+		return dgCapsuleSupportFeature (m_p0, m_p1, m_radius, dir, origin, feature);
+	}
+
+	const dgVector& m_p0;
+	const dgVector& m_p1;
+	dgFloat32 m_radius;
+};
+
+// contact feature of one shape picked the way dgContactSolver::CalculateContacts does: from the plane
+// through origin when the shapes overlap, otherwise, or when that plane misses the feature, from up to
+// three planes stepped into the shape from its closest point. an empty feature means no contacts.
+template <class dgKernelShape>
+static dgInt32 dgContactFeature (const dgKernelShape& shape, const dgVector& dir, const dgVector& origin, const dgVector& point, const dgVector& step, bool overlap, dgVector* const feature)
+{
+	dgInt32 count = overlap ? shape.SupportFeature (dir, origin, feature) : 0;
+	dgVector alternatePoint (point);
+	for (dgInt32 i = 0; (i < 3) && !count; i ++) {
+		alternatePoint += step;
+		count = shape.SupportFeature (dir, alternatePoint, feature);
+	}
+	return count;
+}
+
+static dgVector dgClosestPointOnSegment (const dgVector& point, const dgVector& p0, const dgVector& p1)
+{
+	const dgVector dp (p1 - p0);
+	const dgFloat32 den = dp.DotProduct(dp).GetScalar();
+	if (den < dgFloat32 (1.0e-12f)) {
+		return p0;
+	}
+	const dgFloat32 t = dgClamp (dp.DotProduct(point - p0).GetScalar() / den, dgFloat32 (0.0f), dgFloat32 (1.0f));
+	return p0 + dp.Scale (t);
+}
+
+// parameter of the point of segment p0 + t * dir, t in [0, 1], closest to a box of half extents size.
+// the square distance is a convex piecewise quadratic of t, the pieces break where the segment
+// crosses a slab plane, so the minimum of each piece is found in closed form.
+static dgFloat32 dgSegmentToBoxParam (const dgVector& p0, const dgVector& dir, const dgVector& size, dgFloat32& dist2Out)
+{
+	dgFloat32 knots[8];
+	dgInt32 knotCount = 0;
+	knots[knotCount++] = dgFloat32 (0.0f);
+	knots[knotCount++] = dgFloat32 (1.0f);
+	for (dgInt32 i = 0; i < 3; i ++) {
+		if (dgAbs (dir[i]) > dgFloat32 (1.0e-12f)) {
+			const dgFloat32 den = dgFloat32 (1.0f) / dir[i];
+			const dgFloat32 t0 = (size[i] - p0[i]) * den;
+			const dgFloat32 t1 = (-size[i] - p0[i]) * den;
+			if ((t0 > dgFloat32 (0.0f)) && (t0 < dgFloat32 (1.0f))) {
+				knots[knotCount++] = t0;
+			}
+			if ((t1 > dgFloat32 (0.0f)) && (t1 < dgFloat32 (1.0f))) {
+				knots[knotCount++] = t1;
+			}
+		}
+	}
+
+	for (dgInt32 i = 1; i < knotCount; i ++) {
+		const dgFloat32 key = knots[i];
+		dgInt32 j = i - 1;
+		for (; (j >= 0) && (knots[j] > key); j --) {
+			knots[j + 1] = knots[j];
+		}
+		knots[j + 1] = key;
+	}
+
+	dgFloat32 param = dgFloat32 (0.0f);
+	dgFloat32 minDist2 = dgFloat32 (1.0e20f);
+	for (dgInt32 k = 1; k < knotCount; k ++) {
+		const dgFloat32 t0 = knots[k - 1];
+		const dgFloat32 t1 = knots[k];
+		const dgFloat32 tm = (t0 + t1) * dgFloat32 (0.5f);
+
+		dgFloat32 a = dgFloat32 (0.0f);
+		dgFloat32 b = dgFloat32 (0.0f);
+		for (dgInt32 i = 0; i < 3; i ++) {
+			const dgFloat32 x = p0[i] + dir[i] * tm;
+			if (x > size[i]) {
+				a += dir[i] * dir[i];
+				b += dir[i] * (p0[i] - size[i]);
+			} else if (x < -size[i]) {
+				a += dir[i] * dir[i];
+				b += dir[i] * (p0[i] + size[i]);
+			}
+		}
+		const dgFloat32 t = (a > dgFloat32 (1.0e-12f)) ? dgClamp (-b / a, t0, t1) : t0;
+
+		dgFloat32 dist2 = dgFloat32 (0.0f);
+		for (dgInt32 i = 0; i < 3; i ++) {
+			const dgFloat32 x = p0[i] + dir[i] * t;
+			const dgFloat32 d = x - dgClamp (x, -size[i], size[i]);
+			dist2 += d * d;
+		}
+		if (dist2 < minDist2) {
+			minDist2 = dist2;
+			param = t;
+		}
+	}
+	dist2Out = minDist2;
+	return param;
+}
+
+// clips a convex polygon or a segment with the prism that a convex polygon sweeps along the normal
+static dgInt32 dgClipContactFeature (const dgVector& normal, dgInt32 count, const dgVector* const feature, dgInt32 clipperCount, const dgVector* const clipper, dgVector* const contactOut)
+{
+	dgAssert (clipperCount >= 3);
+	dgVector centre (dgVector::m_zero);
+	for (dgInt32 i = 0; i < clipperCount; i ++) {
+		centre += clipper[i];
+	}
+	centre = centre.Scale (dgFloat32 (1.0f) / clipperCount);
+
+	if (count == 2) {
+		dgFloat32 t0 = dgFloat32 (0.0f);
+		dgFloat32 t1 = dgFloat32 (1.0f);
+		const dgVector dp (feature[1] - feature[0]);
+		dgInt32 i0 = clipperCount - 1;
+		for (dgInt32 i1 = 0; (i1 < clipperCount) && (t0 <= t1); i1 ++) {
+			dgVector side (normal.CrossProduct(clipper[i1] - clipper[i0]));
+			if (side.DotProduct(centre - clipper[i0]).GetScalar() < dgFloat32 (0.0f)) {
+				side = side.Scale (dgFloat32 (-1.0f));
+			}
+			const dgFloat32 dist = side.DotProduct(feature[0] - clipper[i0]).GetScalar();
+			const dgFloat32 slope = side.DotProduct(dp).GetScalar();
+			if (dgAbs (slope) < dgFloat32 (1.0e-12f)) {
+				if (dist < dgFloat32 (0.0f)) {
+					t1 = dgFloat32 (-1.0f);
+				}
+			} else {
+				const dgFloat32 t = -dist / slope;
+				if (slope > dgFloat32 (0.0f)) {
+					t0 = dgMax (t0, t);
+				} else {
+					t1 = dgMin (t1, t);
+				}
+			}
+			i0 = i1;
+		}
+
+		dgInt32 contactCount = 0;
+		if (t0 <= t1) {
+			contactOut[contactCount++] = feature[0] + dp.Scale (t0);
+			if ((t1 - t0) * dp.DotProduct(dp).GetScalar() > dgFloat32 (1.0e-6f)) {
+				contactOut[contactCount++] = feature[0] + dp.Scale (t1);
+			}
+		}
+		return contactCount;
+	}
+
+	dgVector buffer[2][DG_KERNEL_MAX_FEATURE];
+	dgInt32 inCount = count;
+	for (dgInt32 i = 0; i < count; i ++) {
+		buffer[0][i] = feature[i];
+	}
+
+	dgInt32 index = 0;
+	dgInt32 i0 = clipperCount - 1;
+	for (dgInt32 i1 = 0; (i1 < clipperCount) && inCount; i1 ++) {
+		dgVector side (normal.CrossProduct(clipper[i1] - clipper[i0]));
+		if (side.DotProduct(centre - clipper[i0]).GetScalar() < dgFloat32 (0.0f)) {
+			side = side.Scale (dgFloat32 (-1.0f));
+		}
+
+		const dgVector* const polyIn = buffer[index];
+		dgVector* const polyOut = buffer[index ^ 1];
+		dgInt32 outCount = 0;
+		dgInt32 j0 = inCount - 1;
+		dgFloat32 dist0 = side.DotProduct(polyIn[j0] - clipper[i0]).GetScalar();
+		for (dgInt32 j1 = 0; j1 < inCount; j1 ++) {
+			const dgFloat32 dist1 = side.DotProduct(polyIn[j1] - clipper[i0]).GetScalar();
+			if ((dist0 * dist1) < dgFloat32 (0.0f)) {
+				const dgFloat32 t = dist0 / (dist0 - dist1);
+				polyOut[outCount++] = polyIn[j0] + (polyIn[j1] - polyIn[j0]).Scale (t);
+			}
+			if (dist1 >= dgFloat32 (0.0f)) {
+				polyOut[outCount++] = polyIn[j1];
+			}
+			dgAssert (outCount < DG_KERNEL_MAX_FEATURE);
+			j0 = j1;
+			dist0 = dist1;
+		}
+		inCount = outCount;
+		index ^= 1;
+		i0 = i1;
+	}
+
+	for (dgInt32 i = 0; i < inCount; i ++) {
+		contactOut[i] = buffer[index][i];
+	}
+	return inCount;
+}
+
+// intersects the contact features of the two shapes on the plane through origin,
+// the cases are the same dgContactSolver::CalculateContacts handles, and like it
+// an empty intersection leaves the pair active but without contacts
+static dgInt32 dgIntersectContactFeatures (const dgVector& normal, const dgVector& origin, dgInt32 count0, dgVector* const feature0, dgInt32 count1, dgVector* const feature1, dgVector* const contactOut)
+{
+	for (dgInt32 i = 0; i < count0; i ++) {
+		feature0[i] -= normal.Scale (normal.DotProduct(feature0[i] - origin).GetScalar());
+	}
+	for (dgInt32 i = 0; i < count1; i ++) {
+		feature1[i] -= normal.Scale (normal.DotProduct(feature1[i] - origin).GetScalar());
+	}
+
+	dgInt32 count = 0;
+	if (!count0 || !count1) {
+		count = 0;
+	} else if (count1 == 1) {
+		contactOut[0] = feature1[0];
+		count = 1;
+	} else if (count0 == 1) {
+		contactOut[0] = feature0[0];
+		count = 1;
+	} else if ((count0 == 2) && (count1 == 2)) {
+		const dgVector& p0 = feature1[0];
+		const dgVector& q0 = feature0[0];
+		const dgVector& q1 = feature0[1];
+		dgVector p10 (feature1[1] - p0);
+		dgVector q10 (q1 - q0);
+		const dgFloat32 length = dgSqrt (p10.DotProduct(p10).GetScalar() + dgFloat32 (1.0e-8f));
+		p10 = p10.Scale (dgFloat32 (1.0f) / length);
+		q10 = q10.Scale (dgRsqrt (q10.DotProduct(q10).GetScalar() + dgFloat32 (1.0e-8f)));
+		if (dgAbs (q10.DotProduct(p10).GetScalar()) > DG_KERNEL_PARALLEL_EDGES) {
+			dgFloat32 ql0 = p10.DotProduct(q0 - p0).GetScalar();
+			dgFloat32 ql1 = p10.DotProduct(q1 - p0).GetScalar();
+			if (ql0 > ql1) {
+				dgSwap (ql0, ql1);
+			}
+			const dgFloat32 clip0 = dgMax (ql0, dgFloat32 (0.0f));
+			const dgFloat32 clip1 = dgMin (ql1, length);
+			if (clip1 >= clip0) {
+				contactOut[count++] = p0 + p10.Scale (clip0);
+				if ((clip1 - clip0) > dgFloat32 (1.0e-3f)) {
+					contactOut[count++] = p0 + p10.Scale (clip1);
+				}
+			}
+		} else {
+			dgVector c0;
+			dgVector c1;
+			dgRayToRayDistance (feature1[0], feature1[1], q0, q1, c0, c1);
+			contactOut[0] = (c0 + c1).Scale (dgFloat32 (0.5f));
+			count = 1;
+		}
+	} else if (count0 >= 3) {
+		count = dgClipContactFeature (normal, count1, feature1, count0, feature0, contactOut);
+	} else {
+		count = dgClipContactFeature (normal, count0, feature0, count1, feature1, contactOut);
+	}
+	return count;
+}
+
+void dgWorld::InitContactKernels ()
+{
+	memset (m_contactKernels, 0, sizeof (m_contactKernels));
+	m_contactKernels[m_sphereCollision][m_sphereCollision].m_kernel = &dgWorld::CalculateSphereSphereContacts;
+	m_contactKernels[m_sphereCollision][m_capsuleCollision].m_kernel = &dgWorld::CalculateSphereCapsuleContacts;
+	m_contactKernels[m_sphereCollision][m_boxCollision].m_kernel = &dgWorld::CalculateSphereBoxContacts;
+	m_contactKernels[m_capsuleCollision][m_capsuleCollision].m_kernel = &dgWorld::CalculateCapsuleCapsuleContacts;
+	m_contactKernels[m_capsuleCollision][m_boxCollision].m_kernel = &dgWorld::CalculateCapsuleBoxContacts;
+	m_contactKernels[m_boxCollision][m_boxCollision].m_kernel = &dgWorld::CalculateBoxBoxContacts;
+
+	// the mirrored pairs run the same kernel with the shapes swapped
+	for (dgInt32 i = 0; i < m_nullCollision; i ++) {
+		for (dgInt32 j = 0; j < i; j ++) {
+			if (m_contactKernels[j][i].m_kernel && !m_contactKernels[i][j].m_kernel) {
+				m_contactKernels[i][j].m_kernel = m_contactKernels[j][i].m_kernel;
+				m_contactKernels[i][j].m_swapShapes = true;
+			}
+		}
+	}
+}
+
+dgInt32 dgWorld::CalculateAnalyticContacts (dgCollisionParamProxy& proxy, const dgContactKernel& kernel) const
+{
+	if (!kernel.m_swapShapes) {
+		return (this->*kernel.m_kernel)(proxy);
+	}
+
+	dgSwap (proxy.m_instance0, proxy.m_instance1);
+	const dgInt32 count = (this->*kernel.m_kernel)(proxy);
+	dgSwap (proxy.m_instance0, proxy.m_instance1);
+	if (count >= 0) {
+		dgSwap (proxy.m_closestPointBody0, proxy.m_closestPointBody1);
+		proxy.m_normal = proxy.m_normal.Scale (dgFloat32 (-1.0f));
+		dgContactPoint* const contactOut = proxy.m_contacts;
+		for (dgInt32 i = 0; i < count; i ++) {
+			contactOut[i].m_normal = proxy.m_normal;
+		}
+	}
+	return count;
+}
+
+bool dgWorld::SetAnalyticClosestPoints (dgCollisionParamProxy& proxy, const dgVector& normal, const dgVector& point0, const dgVector& point1, dgFloat32& separation) const
+{
+	dgContact* const contactJoint = proxy.m_contactJoint;
+	separation = normal.DotProduct(point0 - point1).GetScalar() - proxy.m_skinThickness - DG_PENETRATION_TOL;
+
+	proxy.m_normal = normal;
+	proxy.m_closestPointBody0 = point0;
+	proxy.m_closestPointBody1 = point1;
+	contactJoint->m_closestDistance = separation;
+	contactJoint->m_separationDistance = separation;
+	if (separation > dgFloat32 (1.0e-5f)) {
+		return false;
+	}
+	contactJoint->m_contactActive = 1;
+	return proxy.m_instance0->GetCollisionMode() & proxy.m_instance1->GetCollisionMode();
+}
+
+dgInt32 dgWorld::SetAnalyticContacts (dgCollisionParamProxy& proxy, const dgVector& normal, dgFloat32 separation, const dgVector* const points, dgInt32 count) const
+{
+	count = dgMin (proxy.m_maxContacts, count);
+	dgContactPoint* const contactOut = proxy.m_contacts;
+	for (dgInt32 i = 0; i < count; i ++) {
+		contactOut[i].m_point = points[i];
+		contactOut[i].m_normal = normal;
+		contactOut[i].m_penetration = -separation;
+	}
+	return count;
+}
+
+// a single contact half way between the closest points
+dgInt32 dgWorld::SetAnalyticPointContact (dgCollisionParamProxy& proxy, const dgVector& normal, const dgVector& point0, const dgVector& point1) const
+{
+	dgFloat32 separation;
+	if (!SetAnalyticClosestPoints (proxy, normal, point0, point1, separation)) {
+		return 0;
+	}
+	const dgVector point ((point0 + point1).Scale (dgFloat32 (0.5f)));
+	return SetAnalyticContacts (proxy, normal, separation, &point, 1);
+}
+
+dgInt32 dgWorld::CalculateRoundContacts (dgCollisionParamProxy& proxy, const dgVector& center0, dgFloat32 radius0, const dgVector& center1, dgFloat32 radius1) const
+{
+	dgVector normal (dgVector::m_zero);
+	const dgVector dir ((center0 - center1) & dgVector::m_triplexMask);
+	const dgFloat32 mag2 = dir.DotProduct(dir).GetScalar();
+	if (mag2 > dgFloat32 (1.0e-12f)) {
+		normal = dir.Scale (dgRsqrt (mag2));
+	} else {
+		normal.m_x = dgFloat32 (1.0f);
+	}
+
+	const dgVector point0 (center0 - normal.Scale (radius0));
+	const dgVector point1 (center1 + normal.Scale (radius1));
+	return SetAnalyticPointContact (proxy, normal, point0, point1);
+}
+
+dgInt32 dgWorld::CalculateSphereSphereContacts (dgCollisionParamProxy& proxy) const
+{
+	const dgCollisionSphere* const sphere0 = (dgCollisionSphere*)proxy.m_instance0->GetChildShape();
+	const dgCollisionSphere* const sphere1 = (dgCollisionSphere*)proxy.m_instance1->GetChildShape();
+	const dgVector& center0 = proxy.m_instance0->GetGlobalMatrix().m_posit;
+	const dgVector& center1 = proxy.m_instance1->GetGlobalMatrix().m_posit;
+	const dgFloat32 radius0 = (sphere0->m_radius - DG_PENETRATION_TOL) * dgKernelScale (proxy.m_instance0);
+	const dgFloat32 radius1 = (sphere1->m_radius - DG_PENETRATION_TOL) * dgKernelScale (proxy.m_instance1);
+	return CalculateRoundContacts (proxy, center0, radius0, center1, radius1);
+}
+
+dgInt32 dgWorld::CalculateSphereCapsuleContacts (dgCollisionParamProxy& proxy) const
+{
+	const dgCollisionSphere* const sphere = (dgCollisionSphere*)proxy.m_instance0->GetChildShape();
+	const dgCollisionCapsule* const capsule = (dgCollisionCapsule*)proxy.m_instance1->GetChildShape();
+	if (capsule->m_radio0 != capsule->m_radio1) {
+		return -1;
+	}
+
+	const dgFloat32 scale0 = dgKernelScale (proxy.m_instance0);
+	const dgFloat32 scale1 = dgKernelScale (proxy.m_instance1);
+	const dgMatrix& matrix1 = proxy.m_instance1->GetGlobalMatrix();
+	const dgVector p0 (matrix1.m_posit - matrix1.m_front.Scale (capsule->m_height * scale1));
+	const dgVector p1 (matrix1.m_posit + matrix1.m_front.Scale (capsule->m_height * scale1));
+	const dgVector& center = proxy.m_instance0->GetGlobalMatrix().m_posit;
+	return CalculateRoundContacts (proxy, center, (sphere->m_radius - DG_PENETRATION_TOL) * scale0, dgClosestPointOnSegment (center, p0, p1), (capsule->m_radio0 - DG_PENETRATION_TOL) * scale1);
+}
+
+dgInt32 dgWorld::CalculateSphereBoxContacts (dgCollisionParamProxy& proxy) const
+{
+	const dgCollisionSphere* const sphere = (dgCollisionSphere*)proxy.m_instance0->GetChildShape();
+	const dgCollisionBox* const box = (dgCollisionBox*)proxy.m_instance1->GetChildShape();
+	const dgMatrix& matrix1 = proxy.m_instance1->GetGlobalMatrix();
+	const dgVector size (box->m_size[0].Scale (dgKernelScale (proxy.m_instance1)));
+	const dgVector& center = proxy.m_instance0->GetGlobalMatrix().m_posit;
+
+	const dgVector localCenter (matrix1.UntransformVector(center));
+	const dgVector clamped (localCenter.GetMax(size.Scale (dgFloat32 (-1.0f))).GetMin(size));
+	const dgVector diff (localCenter - clamped);
+	const dgFloat32 mag2 = diff.DotProduct(diff).GetScalar();
+
+	dgVector localNormal (dgVector::m_zero);
+	dgVector localPoint (clamped);
+	if (mag2 > dgFloat32 (1.0e-12f)) {
+		localNormal = diff.Scale (dgRsqrt (mag2));
+	} else {
+		// the center is inside the box, push it out through the closest face
+		dgInt32 axis = 0;
+		dgFloat32 minDepth = dgFloat32 (1.0e10f);
+		for (dgInt32 i = 0; i < 3; i ++) {
+			const dgFloat32 depth = size[i] - dgAbs (localCenter[i]);
+			if (depth < minDepth) {
+				minDepth = depth;
+				axis = i;
+			}
+		}
+		const dgFloat32 sign = (localCenter[axis] >= dgFloat32 (0.0f)) ? dgFloat32 (1.0f) : dgFloat32 (-1.0f);
+		localNormal[axis] = sign;
+		localPoint[axis] = size[axis] * sign;
+	}
+
+	const dgVector normal (matrix1.RotateVector(localNormal));
+	const dgVector point0 (center - normal.Scale ((sphere->m_radius - DG_PENETRATION_TOL) * dgKernelScale (proxy.m_instance0)));
+	const dgVector point1 (matrix1.TransformVector(localPoint));
+	return SetAnalyticPointContact (proxy, normal, point0, point1);
+}
+
+dgInt32 dgWorld::CalculateCapsuleCapsuleContacts (dgCollisionParamProxy& proxy) const
+{
+	const dgCollisionCapsule* const capsule0 = (dgCollisionCapsule*)proxy.m_instance0->GetChildShape();
+	const dgCollisionCapsule* const capsule1 = (dgCollisionCapsule*)proxy.m_instance1->GetChildShape();
+	if ((capsule0->m_radio0 != capsule0->m_radio1) || (capsule1->m_radio0 != capsule1->m_radio1)) {
+		return -1;
+	}
+
+	const dgFloat32 scale0 = dgKernelScale (proxy.m_instance0);
+	const dgFloat32 scale1 = dgKernelScale (proxy.m_instance1);
+	const dgMatrix& matrix0 = proxy.m_instance0->GetGlobalMatrix();
+	const dgMatrix& matrix1 = proxy.m_instance1->GetGlobalMatrix();
+	const dgVector p0 (matrix0.m_posit - matrix0.m_front.Scale (capsule0->m_height * scale0));
+	const dgVector p1 (matrix0.m_posit + matrix0.m_front.Scale (capsule0->m_height * scale0));
+	const dgVector q0 (matrix1.m_posit - matrix1.m_front.Scale (capsule1->m_height * scale1));
+	const dgVector q1 (matrix1.m_posit + matrix1.m_front.Scale (capsule1->m_height * scale1));
+
+	dgVector c0;
+	dgVector c1;
+	dgRayToRayDistance (p0, p1, q0, q1, c0, c1);
+
+	dgVector normal ((c0 - c1) & dgVector::m_triplexMask);
+	dgFloat32 mag2 = normal.DotProduct(normal).GetScalar();
+	if (mag2 < dgFloat32 (1.0e-12f)) {
+		// the axes cross, separate along their common perpendicular
+		normal = matrix0.m_front.CrossProduct(matrix1.m_front);
+		mag2 = normal.DotProduct(normal).GetScalar();
+		if (mag2 < dgFloat32 (1.0e-12f)) {
+			normal = matrix0.m_up;
+			mag2 = dgFloat32 (1.0f);
+		}
+		if (normal.DotProduct(matrix0.m_posit - matrix1.m_posit).GetScalar() < dgFloat32 (0.0f)) {
+			normal = normal.Scale (dgFloat32 (-1.0f));
+		}
+	}
+	normal = normal.Scale (dgRsqrt (mag2));
+
+	const dgVector point0 (c0 - normal.Scale ((capsule0->m_radio0 - DG_PENETRATION_TOL) * scale0));
+	const dgVector point1 (c1 + normal.Scale ((capsule1->m_radio0 - DG_PENETRATION_TOL) * scale1));
+	return CalculateCapsuleCapsuleManifold (proxy, normal, point0, point1, p0, p1, capsule0->m_radio0 * scale0, q0, q1, capsule1->m_radio0 * scale1);
+}
+
+// contacts of two capsules given their closest points, p0 p1 and q0 q1 are the end points of their axes
+dgInt32 dgWorld::CalculateCapsuleCapsuleManifold (dgCollisionParamProxy& proxy, const dgVector& normal, const dgVector& point0, const dgVector& point1, const dgVector& p0, const dgVector& p1, dgFloat32 radius0, const dgVector& q0, const dgVector& q1, dgFloat32 radius1) const
+{
+	dgFloat32 separation;
+	if (!SetAnalyticClosestPoints (proxy, normal, point0, point1, separation)) {
+		return 0;
+	}
+
+	dgVector feature0[2];
+	dgVector feature1[2];
+	dgVector contacts[2];
+	const dgVector origin ((point0 + point1).Scale (dgFloat32 (0.5f)));
+	const dgVector step (normal.Scale (DG_PENETRATION_TOL * dgFloat32 (2.0f)));
+	const bool overlap = normal.DotProduct(point0 - point1).GetScalar() < dgFloat32 (0.0f);
+	const dgInt32 count0 = dgContactFeature (dgKernelCapsuleShape (p0, p1, radius0), normal, origin, point0, step, overlap, feature0);
+	const dgInt32 count1 = dgContactFeature (dgKernelCapsuleShape (q0, q1, radius1), normal, origin, point1, step.Scale (dgFloat32 (-1.0f)), overlap, feature1);
+	const dgInt32 count = dgIntersectContactFeatures (normal, origin, count0, feature0, count1, feature1, contacts);
+	return SetAnalyticContacts (proxy, normal, separation, contacts, count);
+}
+
+dgInt32 dgWorld::CalculateCapsuleBoxContacts (dgCollisionParamProxy& proxy) const
+{
+	const dgCollisionCapsule* const capsule = (dgCollisionCapsule*)proxy.m_instance0->GetChildShape();
+	const dgCollisionBox* const box = (dgCollisionBox*)proxy.m_instance1->GetChildShape();
+	if (capsule->m_radio0 != capsule->m_radio1) {
+		return -1;
+	}
+
+	const dgFloat32 scale0 = dgKernelScale (proxy.m_instance0);
+	const dgMatrix& matrix0 = proxy.m_instance0->GetGlobalMatrix();
+	const dgMatrix& matrix1 = proxy.m_instance1->GetGlobalMatrix();
+	const dgVector size (box->m_size[0].Scale (dgKernelScale (proxy.m_instance1)));
+	const dgFloat32 radius = (capsule->m_radio0 - DG_PENETRATION_TOL) * scale0;
+	const dgVector p0 (matrix0.m_posit - matrix0.m_front.Scale (capsule->m_height * scale0));
+	const dgVector p1 (matrix0.m_posit + matrix0.m_front.Scale (capsule->m_height * scale0));
+
+	// everything in the space of the box
+	const dgVector a (matrix1.UntransformVector(p0));
+	const dgVector b (matrix1.UntransformVector(p1));
+	const dgVector dir (b - a);
+
+	dgFloat32 dist2;
+	dgVector localNormal (dgVector::m_zero);
+	dgVector localPoint0;
+	dgVector localPoint1;
+	const dgFloat32 t = dgSegmentToBoxParam (a, dir, size, dist2);
+	if (dist2 > dgFloat32 (1.0e-10f)) {
+		const dgVector q (a + dir.Scale (t));
+		const dgVector clamped (q.GetMax(size.Scale (dgFloat32 (-1.0f))).GetMin(size));
+		const dgVector diff (q - clamped);
+		localNormal = diff.Scale (dgRsqrt (diff.DotProduct(diff).GetScalar()));
+		localPoint0 = q - localNormal.Scale (radius);
+		localPoint1 = clamped;
+	} else {
+		// the axis goes through the box, find the axis of least penetration among
+		// the box faces and the cross products of the capsule axis with the box edges
+		dgVector axis[6];
+		dgInt32 axisCount = 3;
+		axis[0] = dgVector (dgFloat32 (1.0f), dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f));
+		axis[1] = dgVector (dgFloat32 (0.0f), dgFloat32 (1.0f), dgFloat32 (0.0f), dgFloat32 (0.0f));
+		axis[2] = dgVector (dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (1.0f), dgFloat32 (0.0f));
+		for (dgInt32 i = 0; i < 3; i ++) {
+			const dgVector cross (dir.CrossProduct(axis[i]));
+			const dgFloat32 mag2 = cross.DotProduct(cross).GetScalar();
+			if (mag2 > dgFloat32 (1.0e-6f) * dir.DotProduct(dir).GetScalar()) {
+				axis[axisCount] = cross.Scale (dgRsqrt (mag2));
+				axisCount ++;
+			}
+		}
+
+		dgFloat32 minDepth = dgFloat32 (1.0e10f);
+		for (dgInt32 i = 0; i < axisCount; i ++) {
+			const dgVector& n = axis[i];
+			const dgFloat32 boxRadius = size.DotProduct(n.Abs()).GetScalar();
+			const dgFloat32 sa = n.DotProduct(a).GetScalar();
+			const dgFloat32 sb = n.DotProduct(b).GetScalar();
+			const dgFloat32 depthPos = boxRadius - dgMin (sa, sb);
+			const dgFloat32 depthNeg = dgMax (sa, sb) + boxRadius;
+			const dgFloat32 depth = dgMin (depthPos, depthNeg);
+			// edge axes must be clearly better than the faces
+			const dgFloat32 bias = (i < 3) ? dgFloat32 (0.0f) : DG_PENETRATION_TOL * dgFloat32 (0.25f);
+			if ((depth + bias) < minDepth) {
+				minDepth = depth;
+				localNormal = (depthPos <= depthNeg) ? n : n.Scale (dgFloat32 (-1.0f));
+			}
+		}
+
+		const dgFloat32 sa = localNormal.DotProduct(a).GetScalar();
+		const dgFloat32 sb = localNormal.DotProduct(b).GetScalar();
+		const dgVector core ((dgAbs (sa - sb) < dgFloat32 (1.0e-6f)) ? (a + b).Scale (dgFloat32 (0.5f)) : ((sa < sb) ? a : b));
+		const dgFloat32 boxRadius = size.DotProduct(localNormal.Abs()).GetScalar();
+		localPoint0 = core - localNormal.Scale (radius);
+		localPoint1 = core - localNormal.Scale (localNormal.DotProduct(core).GetScalar() - boxRadius);
+	}
+
+	dgFloat32 separation;
+	const dgVector normal (matrix1.RotateVector(localNormal));
+	const dgVector point0 (matrix1.TransformVector(localPoint0));
+	const dgVector point1 (matrix1.TransformVector(localPoint1));
+	if (!SetAnalyticClosestPoints (proxy, normal, point0, point1, separation)) {
+		return 0;
+	}
+
+	dgVector feature0[2];
+	dgVector feature1[6];
+	dgVector contacts[DG_KERNEL_MAX_FEATURE];
+	const dgVector origin ((point0 + point1).Scale (dgFloat32 (0.5f)));
+	const dgVector step (normal.Scale (DG_PENETRATION_TOL * dgFloat32 (2.0f)));
+	const bool overlap = normal.DotProduct(point0 - point1).GetScalar() < dgFloat32 (0.0f);
+	const dgInt32 count0 = dgContactFeature (dgKernelCapsuleShape (p0, p1, capsule->m_radio0 * scale0), normal, origin, point0, step, overlap, feature0);
+	const dgInt32 count1 = dgContactFeature (dgKernelBoxShape (matrix1, size), normal, origin, point1, step.Scale (dgFloat32 (-1.0f)), overlap, feature1);
+	const dgInt32 count = dgIntersectContactFeatures (normal, origin, count0, feature0, count1, feature1, contacts);
+	return SetAnalyticContacts (proxy, normal, separation, contacts, count);
+}
+
+dgInt32 dgWorld::CalculateBoxBoxContacts (dgCollisionParamProxy& proxy) const
+{
+	const dgCollisionBox* const box0 = (dgCollisionBox*)proxy.m_instance0->GetChildShape();
+	const dgCollisionBox* const box1 = (dgCollisionBox*)proxy.m_instance1->GetChildShape();
+	const dgMatrix& matrix0 = proxy.m_instance0->GetGlobalMatrix();
+	const dgMatrix& matrix1 = proxy.m_instance1->GetGlobalMatrix();
+	const dgVector size0 (box0->m_size[0].Scale (dgKernelScale (proxy.m_instance0)));
+	const dgVector size1 (box1->m_size[0].Scale (dgKernelScale (proxy.m_instance1)));
+	const dgVector delta ((matrix0.m_posit - matrix1.m_posit) & dgVector::m_triplexMask);
+
+	// separating axis test over the 6 face normals and the 9 edge cross products,
+	// the separation along the best axis never exceeds the true distance, so it
+	// is still a valid bound for the conservative advancement of the broad phase
+	dgInt32 bestAxis = -1;
+	dgVector normal (dgVector::m_zero);
+	dgFloat32 bestSeparation = dgFloat32 (-1.0e10f);
+	for (dgInt32 k = 0; k < 15; k ++) {
+		dgVector axis;
+		if (k < 3) {
+			axis = matrix0[k];
+		} else if (k < 6) {
+			axis = matrix1[k - 3];
+		} else {
+			axis = matrix0[(k - 6) / 3].CrossProduct(matrix1[(k - 6) % 3]);
+			const dgFloat32 mag2 = axis.DotProduct(axis).GetScalar();
+			if (mag2 < dgFloat32 (1.0e-6f)) {
+				continue;
+			}
+			axis = axis.Scale (dgRsqrt (mag2));
+		}
+		axis = axis & dgVector::m_triplexMask;
+
+		const dgVector localAxis0 (matrix0.UnrotateVector(axis));
+		const dgVector localAxis1 (matrix1.UnrotateVector(axis));
+		const dgFloat32 dist = axis.DotProduct(delta).GetScalar();
+		const dgFloat32 radius0 = size0.DotProduct(localAxis0.Abs()).GetScalar();
+		const dgFloat32 radius1 = size1.DotProduct(localAxis1.Abs()).GetScalar();
+		const dgFloat32 separation = dgAbs (dist) - radius0 - radius1;
+
+		// faces of box1 and edges have to be clearly better to replace the current axis
+		const dgFloat32 bias = (k < 3) ? dgFloat32 (0.0f) : ((k < 6) ? dgFloat32 (1.0e-5f) : DG_PENETRATION_TOL * dgFloat32 (0.25f));
+		if (separation > (bestSeparation + bias)) {
+			bestAxis = k;
+			bestSeparation = separation;
+			normal = (dist >= dgFloat32 (0.0f)) ? axis : axis.Scale (dgFloat32 (-1.0f));
+		}
+	}
+	dgAssert (bestAxis >= 0);
+	return CalculateBoxBoxManifold (proxy, matrix0, size0, matrix1, size1, normal, bestAxis, bestSeparation);
+}
+
+// contacts of two boxes given the best separating axis, 0 to 2 are the faces of box0,
+// 3 to 5 the faces of box1 and 6 to 14 the cross products of their edges
+dgInt32 dgWorld::CalculateBoxBoxManifold (dgCollisionParamProxy& proxy, const dgMatrix& matrix0, const dgVector& size0, const dgMatrix& matrix1, const dgVector& size1, const dgVector& normal, dgInt32 bestAxis, dgFloat32 bestSeparation) const
+{
+	// closest points: the deepest vertex of the incident box and its projection
+	// on the reference face, or the closest points of the two crossing edges
+	dgVector point0;
+	dgVector point1;
+	const dgVector localNormal0 (matrix0.UnrotateVector(normal));
+	const dgVector localNormal1 (matrix1.UnrotateVector(normal));
+	dgVector support0 (dgVector::m_zero);
+	dgVector support1 (dgVector::m_zero);
+	for (dgInt32 i = 0; i < 3; i ++) {
+		support0[i] = (localNormal0[i] > dgFloat32 (0.0f)) ? -size0[i] : size0[i];
+		support1[i] = (localNormal1[i] > dgFloat32 (0.0f)) ? size1[i] : -size1[i];
+	}
+	if (bestAxis < 3) {
+		point1 = matrix1.TransformVector(support1);
+		point0 = point1 + normal.Scale (bestSeparation);
+	} else if (bestAxis < 6) {
+		point0 = matrix0.TransformVector(support0);
+		point1 = point0 - normal.Scale (bestSeparation);
+	} else {
+		const dgInt32 edge0 = (bestAxis - 6) / 3;
+		const dgInt32 edge1 = (bestAxis - 6) % 3;
+		dgVector e00 (support0);
+		dgVector e01 (support0);
+		dgVector e10 (support1);
+		dgVector e11 (support1);
+		e00[edge0] = size0[edge0];
+		e01[edge0] = -size0[edge0];
+		e10[edge1] = size1[edge1];
+		e11[edge1] = -size1[edge1];
+		dgRayToRayDistance (matrix0.TransformVector(e00), matrix0.TransformVector(e01), matrix1.TransformVector(e10), matrix1.TransformVector(e11), point0, point1);
+	}
+
+	dgFloat32 separation;
+	if (!SetAnalyticClosestPoints (proxy, normal, point0, point1, separation)) {
+		return 0;
+	}
+
+	dgVector feature0[6];
+	dgVector feature1[6];
+	dgVector contacts[DG_KERNEL_MAX_FEATURE];
+	const dgVector origin ((point0 + point1).Scale (dgFloat32 (0.5f)));
+	const dgVector step (normal.Scale (DG_PENETRATION_TOL * dgFloat32 (2.0f)));
+	const bool overlap = normal.DotProduct(point0 - point1).GetScalar() < dgFloat32 (0.0f);
+	const dgInt32 count0 = dgContactFeature (dgKernelBoxShape (matrix0, size0), normal.Scale (dgFloat32 (-1.0f)), origin, point0, step, overlap, feature0);
+	const dgInt32 count1 = dgContactFeature (dgKernelBoxShape (matrix1, size1), normal, origin, point1, step.Scale (dgFloat32 (-1.0f)), overlap, feature1);
+	const dgInt32 count = dgIntersectContactFeatures (normal, origin, count0, feature0, count1, feature1, contacts);
+	return SetAnalyticContacts (proxy, normal, separation, contacts, count);
+}
+
+
+// batched kernels: four pairs of the same kind are collided together, lane i of every
+// vector belongs to pair i and the unused lanes repeat the last pair. the lanes find the
+// closest features the same way the kernels above do, in the space of shape0 translated
+// to the origin that CalculateConvexToConvexContacts collides in, then the contacts of
+// each pair are written one at the time. pairs that would take a special path of the
+// scalar code are flagged with a negative feature and collided by CalculateContacts.
+
+static DG_INLINE dgVector dgKernelSelect (const dgVector& mask, const dgVector& a, const dgVector& b)
+{
+	return (a & mask) | b.AndNot (mask);
+}
+
+DG_MSC_VECTOR_ALIGMENT
+class dgKernelSoaVector
+{
+	public:
+	DG_INLINE dgKernelSoaVector ()
+	{
+	}
+
+	DG_INLINE dgKernelSoaVector (const dgVector& x, const dgVector& y, const dgVector& z)
+		:m_x (x)
+		,m_y (y)
+		,m_z (z)
+	{
+	}
+
+	// one vector of each pair
+	DG_INLINE dgKernelSoaVector (const dgVector* const lanes)
+	{
+		dgVector w;
+		dgVector::Transpose4x4 (m_x, m_y, m_z, w, lanes[0], lanes[1], lanes[2], lanes[3]);
+	}
+
+	DG_INLINE void Scatter (dgVector* const lanes, const dgVector& w) const
+	{
+		dgVector::Transpose4x4 (lanes[0], lanes[1], lanes[2], lanes[3], m_x, m_y, m_z, w);
+	}
+
+	DG_INLINE dgKernelSoaVector operator+ (const dgKernelSoaVector& A) const
+	{
+		return dgKernelSoaVector (m_x + A.m_x, m_y + A.m_y, m_z + A.m_z);
+	}
+
+	DG_INLINE dgKernelSoaVector operator- (const dgKernelSoaVector& A) const
+	{
+		return dgKernelSoaVector (m_x - A.m_x, m_y - A.m_y, m_z - A.m_z);
+	}
+
+	DG_INLINE dgKernelSoaVector Scale (const dgVector& scale) const
+	{
+		return dgKernelSoaVector (m_x * scale, m_y * scale, m_z * scale);
+	}
+
+	DG_INLINE dgVector DotProduct (const dgKernelSoaVector& A) const
+	{
+		return m_x * A.m_x + m_y * A.m_y + m_z * A.m_z;
+	}
+
+	DG_INLINE dgKernelSoaVector CrossProduct (const dgKernelSoaVector& A) const
+	{
+		return dgKernelSoaVector (m_y * A.m_z - m_z * A.m_y, m_z * A.m_x - m_x * A.m_z, m_x * A.m_y - m_y * A.m_x);
+	}
+
+	DG_INLINE dgKernelSoaVector Select (const dgVector& mask, const dgKernelSoaVector& A) const
+	{
+		return dgKernelSoaVector (dgKernelSelect (mask, A.m_x, m_x), dgKernelSelect (mask, A.m_y, m_y), dgKernelSelect (mask, A.m_z, m_z));
+	}
+
+	dgVector m_x;
+	dgVector m_y;
+	dgVector m_z;
+} DG_GCC_VECTOR_ALIGMENT;
+
+// the rotation of shape0 and shape1 and the position of shape1 relative to shape0 of each pair
+DG_MSC_VECTOR_ALIGMENT
+class dgKernelSoaPairs
+{
+	public:
+	dgKernelSoaPairs (dgContact* const* const contacts, dgInt32 count)
+	{
+		dgVector front0[DG_CONTACT_BATCH_SIZE];
+		dgVector up0[DG_CONTACT_BATCH_SIZE];
+		dgVector right0[DG_CONTACT_BATCH_SIZE];
+		dgVector front1[DG_CONTACT_BATCH_SIZE];
+		dgVector up1[DG_CONTACT_BATCH_SIZE];
+		dgVector right1[DG_CONTACT_BATCH_SIZE];
+		dgVector posit1[DG_CONTACT_BATCH_SIZE];
+		for (dgInt32 i = 0; i < DG_CONTACT_BATCH_SIZE; i ++) {
+			const dgContact* const contact = contacts[dgMin (i, count - 1)];
+			const dgMatrix& matrix0 = contact->GetBody0()->GetCollision()->GetGlobalMatrix();
+			const dgMatrix& matrix1 = contact->GetBody1()->GetCollision()->GetGlobalMatrix();
+			front0[i] = matrix0.m_front;
+			up0[i] = matrix0.m_up;
+			right0[i] = matrix0.m_right;
+			front1[i] = matrix1.m_front;
+			up1[i] = matrix1.m_up;
+			right1[i] = matrix1.m_right;
+			posit1[i] = matrix1.m_posit - (matrix0.m_posit & dgVector::m_triplexMask);
+		}
+		m_matrix0[0] = dgKernelSoaVector (front0);
+		m_matrix0[1] = dgKernelSoaVector (up0);
+		m_matrix0[2] = dgKernelSoaVector (right0);
+		m_matrix1[0] = dgKernelSoaVector (front1);
+		m_matrix1[1] = dgKernelSoaVector (up1);
+		m_matrix1[2] = dgKernelSoaVector (right1);
+		m_posit1 = dgKernelSoaVector (posit1);
+	}
+
+	dgKernelSoaVector m_matrix0[3];
+	dgKernelSoaVector m_matrix1[3];
+	dgKernelSoaVector m_posit1;
+} DG_GCC_VECTOR_ALIGMENT;
+
+// the four lanes of a vector
+static DG_INLINE dgVector dgKernelLanes (const dgFloat32* const lanes)
+{
+	return dgVector (lanes[0], lanes[1], lanes[2], lanes[3]);
+}
+
+static void dgSetBatchFeatures (dgInt32* const features, const dgVector& feature, const dgVector& fallback)
+{
+	const dgInt32 mask = fallback.GetSignMask();
+	for (dgInt32 i = 0; i < DG_CONTACT_BATCH_SIZE; i ++) {
+		features[i] = (mask & (1 << i)) ? -1 : dgInt32 (feature[i]);
+	}
+}
+
+dgInt32 dgWorld::GetContactBatchType (const dgContact* const contact) const
+{
+	if (!(m_useAnalyticContacts & m_useBatchedContacts) || contact->m_material->m_contactGeneration) {
+		return -1;
+	}
+
+	const dgCollisionInstance* const instance0 = contact->GetBody0()->GetCollision();
+	const dgCollisionInstance* const instance1 = contact->GetBody1()->GetCollision();
+	if ((instance0->GetScaleType() != dgCollisionInstance::m_unit) || (instance1->GetScaleType() != dgCollisionInstance::m_unit)) {
+		return -1;
+	}
+
+	const dgInt32 type0 = instance0->GetCollisionPrimityType();
+	const dgInt32 type1 = instance1->GetCollisionPrimityType();
+	if ((type0 == m_sphereCollision) && (type1 == m_sphereCollision)) {
+		return m_sphereSphereBatch;
+	} else if (((type0 == m_sphereCollision) && (type1 == m_boxCollision)) || ((type0 == m_boxCollision) && (type1 == m_sphereCollision))) {
+		return m_sphereBoxBatch;
+	} else if ((type0 == m_boxCollision) && (type1 == m_boxCollision)) {
+		return m_boxBoxBatch;
+	} else if ((type0 == m_capsuleCollision) && (type1 == m_capsuleCollision)) {
+		const dgCollisionCapsule* const capsule0 = (dgCollisionCapsule*)instance0->GetChildShape();
+		const dgCollisionCapsule* const capsule1 = (dgCollisionCapsule*)instance1->GetChildShape();
+		if ((capsule0->m_radio0 == capsule0->m_radio1) && (capsule1->m_radio0 == capsule1->m_radio1)) {
+			return m_capsuleCapsuleBatch;
+		}
+	}
+	return -1;
+}
+
+void dgWorld::CalculateContactBatch (dgContactBatch& batch) const
+{
+	dgAssert (batch.m_count > 0);
+	dgAssert (batch.m_count <= DG_CONTACT_BATCH_SIZE);
+	switch (batch.m_type)
+	{
+		case m_sphereSphereBatch:
+			CalculateSphereSphereBatch (batch);
+			break;
+		case m_sphereBoxBatch:
+			CalculateSphereBoxBatch (batch);
+			break;
+		case m_capsuleCapsuleBatch:
+			CalculateCapsuleCapsuleBatch (batch);
+			break;
+		default:
+			dgAssert (batch.m_type == m_boxBoxBatch);
+			CalculateBoxBoxBatch (batch);
+	}
+}
+
+void dgWorld::CalculateSphereSphereBatch (dgContactBatch& batch) const
+{
+	dgFloat32 radius0[DG_CONTACT_BATCH_SIZE];
+	dgFloat32 radius1[DG_CONTACT_BATCH_SIZE];
+	for (dgInt32 i = 0; i < DG_CONTACT_BATCH_SIZE; i ++) {
+		const dgContact* const contact = batch.m_contacts[dgMin (i, batch.m_count - 1)];
+		radius0[i] = ((dgCollisionSphere*)contact->GetBody0()->GetCollision()->GetChildShape())->m_radius - DG_PENETRATION_TOL;
+		radius1[i] = ((dgCollisionSphere*)contact->GetBody1()->GetCollision()->GetChildShape())->m_radius - DG_PENETRATION_TOL;
+	}
+
+	// sphere0 is at the origin
+	const dgKernelSoaPairs pairs (batch.m_contacts, batch.m_count);
+	const dgKernelSoaVector& center1 = pairs.m_posit1;
+	const dgKernelSoaVector dir (center1.Scale (dgVector::m_negOne));
+	const dgVector mag2 (dir.DotProduct (dir));
+
+	// CalculateConvexToConvexContacts nudges concentric spheres apart
+	const dgVector fallback (mag2 < dgVector (dgFloat32 (1.0e-6f)));
+	const dgKernelSoaVector normal (dir.Scale (mag2.GetMax (dgVector (dgFloat32 (1.0e-6f))).Sqrt().Reciproc()));
+	const dgKernelSoaVector point0 (normal.Scale (dgKernelLanes (radius0) * dgVector::m_negOne));
+	const dgKernelSoaVector point1 (center1 + normal.Scale (dgKernelLanes (radius1)));
+
+	normal.Scatter (batch.m_normal, dgVector::m_zero);
+	point0.Scatter (batch.m_point0, dgVector::m_one);
+	point1.Scatter (batch.m_point1, dgVector::m_one);
+	dgSetBatchFeatures (batch.m_feature, dgVector::m_zero, fallback);
+}
+
+void dgWorld::CalculateSphereBoxBatch (dgContactBatch& batch) const
+{
+	dgVector size[DG_CONTACT_BATCH_SIZE];
+	dgFloat32 radius[DG_CONTACT_BATCH_SIZE];
+	dgInt32 swapMask = 0;
+	for (dgInt32 i = 0; i < DG_CONTACT_BATCH_SIZE; i ++) {
+		const dgContact* const contact = batch.m_contacts[dgMin (i, batch.m_count - 1)];
+		const dgCollisionInstance* sphere = contact->GetBody0()->GetCollision();
+		const dgCollisionInstance* box = contact->GetBody1()->GetCollision();
+		if (sphere->GetCollisionPrimityType() != m_sphereCollision) {
+			dgSwap (sphere, box);
+			swapMask |= 1 << i;
+		}
+		size[i] = ((dgCollisionBox*)box->GetChildShape())->m_size[0];
+		radius[i] = ((dgCollisionSphere*)sphere->GetChildShape())->m_radius - DG_PENETRATION_TOL;
+	}
+
+	// the lanes with the box as shape0 have the box at the origin and the sphere at posit1
+	const dgKernelSoaPairs pairs (batch.m_contacts, batch.m_count);
+	const dgVector swap (dgVector (swapMask & 1 ? -1 : 0, swapMask & 2 ? -1 : 0, swapMask & 4 ? -1 : 0, swapMask & 8 ? -1 : 0));
+	const dgKernelSoaVector zero (dgVector::m_zero, dgVector::m_zero, dgVector::m_zero);
+	const dgKernelSoaVector center (zero.Select (swap, pairs.m_posit1));
+	const dgKernelSoaVector posit (pairs.m_posit1.Select (swap, zero));
+	const dgKernelSoaVector axis[3] = {pairs.m_matrix1[0].Select (swap, pairs.m_matrix0[0]), pairs.m_matrix1[1].Select (swap, pairs.m_matrix0[1]), pairs.m_matrix1[2].Select (swap, pairs.m_matrix0[2])};
+	const dgKernelSoaVector boxSize (size);
+
+	const dgKernelSoaVector step (center - posit);
+	const dgKernelSoaVector localCenter (axis[0].DotProduct (step), axis[1].DotProduct (step), axis[2].DotProduct (step));
+	const dgKernelSoaVector clamped (
+		localCenter.m_x.GetMax (boxSize.m_x * dgVector::m_negOne).GetMin (boxSize.m_x),
+		localCenter.m_y.GetMax (boxSize.m_y * dgVector::m_negOne).GetMin (boxSize.m_y),
+		localCenter.m_z.GetMax (boxSize.m_z * dgVector::m_negOne).GetMin (boxSize.m_z));
+	const dgKernelSoaVector diff (localCenter - clamped);
+	const dgVector mag2 (diff.DotProduct (diff));
+
+	// a center inside the box is pushed out through the closest face by the scalar kernel
+	const dgVector fallback (mag2 <= dgVector (dgFloat32 (1.0e-12f)));
+	const dgKernelSoaVector localNormal (diff.Scale (mag2.GetMax (dgVector (dgFloat32 (1.0e-12f))).Sqrt().Reciproc()));
+	const dgKernelSoaVector normal (axis[0].Scale (localNormal.m_x) + axis[1].Scale (localNormal.m_y) + axis[2].Scale (localNormal.m_z));
+	const dgKernelSoaVector spherePoint (center - normal.Scale (dgKernelLanes (radius)));
+	const dgKernelSoaVector boxPoint (axis[0].Scale (clamped.m_x) + axis[1].Scale (clamped.m_y) + axis[2].Scale (clamped.m_z) + posit);
+
+	normal.Scatter (batch.m_normal, dgVector::m_zero);
+	spherePoint.Scatter (batch.m_point0, dgVector::m_one);
+	boxPoint.Scatter (batch.m_point1, dgVector::m_one);
+	for (dgInt32 i = 0; i < DG_CONTACT_BATCH_SIZE; i ++) {
+		if (swapMask & (1 << i)) {
+			dgSwap (batch.m_point0[i], batch.m_point1[i]);
+			batch.m_normal[i] = batch.m_normal[i] * dgVector::m_negOne;
+		}
+	}
+	dgSetBatchFeatures (batch.m_feature, dgVector::m_zero, fallback);
+}
+
+void dgWorld::CalculateCapsuleCapsuleBatch (dgContactBatch& batch) const
+{
+	dgFloat32 height0[DG_CONTACT_BATCH_SIZE];
+	dgFloat32 height1[DG_CONTACT_BATCH_SIZE];
+	dgFloat32 radius0[DG_CONTACT_BATCH_SIZE];
+	dgFloat32 radius1[DG_CONTACT_BATCH_SIZE];
+	for (dgInt32 i = 0; i < DG_CONTACT_BATCH_SIZE; i ++) {
+		const dgContact* const contact = batch.m_contacts[dgMin (i, batch.m_count - 1)];
+		const dgCollisionCapsule* const capsule0 = (dgCollisionCapsule*)contact->GetBody0()->GetCollision()->GetChildShape();
+		const dgCollisionCapsule* const capsule1 = (dgCollisionCapsule*)contact->GetBody1()->GetCollision()->GetChildShape();
+		height0[i] = capsule0->m_height;
+		height1[i] = capsule1->m_height;
+		radius0[i] = capsule0->m_radio0 - DG_PENETRATION_TOL;
+		radius1[i] = capsule1->m_radio0 - DG_PENETRATION_TOL;
+	}
+
+	const dgKernelSoaPairs pairs (batch.m_contacts, batch.m_count);
+	const dgKernelSoaVector& front0 = pairs.m_matrix0[0];
+	const dgKernelSoaVector& front1 = pairs.m_matrix1[0];
+	const dgKernelSoaVector& posit1 = pairs.m_posit1;
+
+	// CalculateConvexToConvexContacts nudges coaxial capsules apart
+	const dgVector tol (dgFloat32 (1.0e-3f));
+	const dgKernelSoaVector offset (posit1.Scale (dgVector::m_negOne));
+	const dgVector coaxial ((front0.DotProduct (front1).Abs() > dgVector (dgFloat32 (0.9999f))) & (pairs.m_matrix1[1].DotProduct (offset).Abs() < tol) & (pairs.m_matrix1[2].DotProduct (offset).Abs() < tol));
+
+	// closest points of the two segments, the same steps dgRayToRayDistance takes
+	const dgKernelSoaVector extend0 (front0.Scale (dgKernelLanes (height0)));
+	const dgKernelSoaVector extend1 (front1.Scale (dgKernelLanes (height1)));
+	const dgKernelSoaVector p0 (extend0.Scale (dgVector::m_negOne));
+	const dgKernelSoaVector q0 (posit1 - extend1);
+	const dgKernelSoaVector u (extend0 - p0);
+	const dgKernelSoaVector v ((posit1 + extend1) - q0);
+	const dgKernelSoaVector w (p0 - q0);
+
+	const dgVector a (u.DotProduct (u));
+	const dgVector b (u.DotProduct (v));
+	const dgVector c (v.DotProduct (v));
+	const dgVector d (u.DotProduct (w));
+	const dgVector e (v.DotProduct (w));
+	const dgVector D (a * c - b * b);
+
+	const dgVector zero (dgVector::m_zero);
+	const dgVector parallel (D < dgVector (dgFloat32 (1.0e-8f)));
+	const dgVector lineS (b * e - c * d);
+	const dgVector lineT (a * e - b * d);
+	const dgVector sLow (lineS < zero);
+	const dgVector sHigh ((lineS > D).AndNot (sLow));
+	dgVector sN (dgKernelSelect (parallel | sLow, zero, dgKernelSelect (sHigh, D, lineS)));
+	dgVector sD (dgKernelSelect (parallel, dgVector::m_one, D));
+	dgVector tN (dgKernelSelect (parallel | sLow, e, dgKernelSelect (sHigh, e + b, lineT)));
+	const dgVector tD (dgKernelSelect (parallel | sLow | sHigh, c, D));
+
+	const dgVector tLow (tN < zero);
+	const dgVector tHigh ((tN > tD).AndNot (tLow));
+	const dgVector edgeS (dgKernelSelect (tLow, zero - d, (zero - d) + b));
+	const dgVector edgeLow (edgeS < zero);
+	const dgVector edgeHigh ((edgeS > a).AndNot (edgeLow));
+	const dgVector edge (tLow | tHigh);
+	sN = dgKernelSelect (edge, dgKernelSelect (edgeLow, zero, dgKernelSelect (edgeHigh, sD, edgeS)), sN);
+	sD = dgKernelSelect (edge.AndNot (edgeLow | edgeHigh), a, sD);
+	tN = dgKernelSelect (tLow, zero, dgKernelSelect (tHigh, tD, tN));
+
+	const dgVector tiny (dgFloat32 (1.0e-8f));
+	const dgVector sc ((sN * sD.Reciproc()).AndNot (sN.Abs() < tiny));
+	const dgVector tc ((tN * tD.Reciproc()).AndNot (tN.Abs() < tiny));
+	const dgKernelSoaVector c0 (p0 + u.Scale (sc));
+	const dgKernelSoaVector c1 (q0 + v.Scale (tc));
+
+	// crossing axes are separated along their common perpendicular by the scalar kernel
+	const dgKernelSoaVector dir (c0 - c1);
+	const dgVector mag2 (dir.DotProduct (dir));
+	const dgVector fallback (coaxial | (mag2 < dgVector (dgFloat32 (1.0e-12f))));
+	const dgKernelSoaVector normal (dir.Scale (mag2.GetMax (dgVector (dgFloat32 (1.0e-12f))).Sqrt().Reciproc()));
+	const dgKernelSoaVector point0 (c0 - normal.Scale (dgKernelLanes (radius0)));
+	const dgKernelSoaVector point1 (c1 + normal.Scale (dgKernelLanes (radius1)));
+
+	normal.Scatter (batch.m_normal, dgVector::m_zero);
+	point0.Scatter (batch.m_point0, dgVector::m_one);
+	point1.Scatter (batch.m_point1, dgVector::m_one);
+	dgSetBatchFeatures (batch.m_feature, dgVector::m_zero, fallback);
+}
+
+void dgWorld::CalculateBoxBoxBatch (dgContactBatch& batch) const
+{
+	dgVector size0[DG_CONTACT_BATCH_SIZE];
+	dgVector size1[DG_CONTACT_BATCH_SIZE];
+	for (dgInt32 i = 0; i < DG_CONTACT_BATCH_SIZE; i ++) {
+		const dgContact* const contact = batch.m_contacts[dgMin (i, batch.m_count - 1)];
+		size0[i] = ((dgCollisionBox*)contact->GetBody0()->GetCollision()->GetChildShape())->m_size[0];
+		size1[i] = ((dgCollisionBox*)contact->GetBody1()->GetCollision()->GetChildShape())->m_size[0];
+	}
+
+	const dgKernelSoaPairs pairs (batch.m_contacts, batch.m_count);
+	const dgKernelSoaVector boxSize0 (size0);
+	const dgKernelSoaVector boxSize1 (size1);
+	const dgKernelSoaVector delta (pairs.m_posit1.Scale (dgVector::m_negOne));
+
+	// the separating axis test of CalculateBoxBoxContacts on the four pairs at once
+	const dgVector zero (dgVector::m_zero);
+	dgVector bestAxis (dgVector::m_negOne);
+	dgVector bestSeparation (dgFloat32 (-1.0e10f));
+	dgKernelSoaVector normal (zero, zero, zero);
+	for (dgInt32 k = 0; k < 15; k ++) {
+		dgKernelSoaVector axis;
+		dgVector skip (dgVector::m_zero);
+		if (k < 3) {
+			axis = pairs.m_matrix0[k];
+		} else if (k < 6) {
+			axis = pairs.m_matrix1[k - 3];
+		} else {
+			axis = pairs.m_matrix0[(k - 6) / 3].CrossProduct(pairs.m_matrix1[(k - 6) % 3]);
+			const dgVector mag2 (axis.DotProduct (axis));
+			skip = mag2 < dgVector (dgFloat32 (1.0e-6f));
+			axis = axis.Scale (mag2.GetMax (dgVector (dgFloat32 (1.0e-6f))).Sqrt().Reciproc());
+		}
+
+		const dgKernelSoaVector localAxis0 (pairs.m_matrix0[0].DotProduct (axis), pairs.m_matrix0[1].DotProduct (axis), pairs.m_matrix0[2].DotProduct (axis));
+		const dgKernelSoaVector localAxis1 (pairs.m_matrix1[0].DotProduct (axis), pairs.m_matrix1[1].DotProduct (axis), pairs.m_matrix1[2].DotProduct (axis));
+		const dgKernelSoaVector absAxis0 (localAxis0.m_x.Abs(), localAxis0.m_y.Abs(), localAxis0.m_z.Abs());
+		const dgKernelSoaVector absAxis1 (localAxis1.m_x.Abs(), localAxis1.m_y.Abs(), localAxis1.m_z.Abs());
+		const dgVector dist (axis.DotProduct (delta));
+		const dgVector separation (dist.Abs() - boxSize0.DotProduct (absAxis0) - boxSize1.DotProduct (absAxis1));
+
+		const dgVector bias ((k < 3) ? dgFloat32 (0.0f) : ((k < 6) ? dgFloat32 (1.0e-5f) : DG_PENETRATION_TOL * dgFloat32 (0.25f)));
+		const dgVector better ((separation > (bestSeparation + bias)).AndNot (skip));
+		bestAxis = dgKernelSelect (better, dgVector (dgFloat32 (k)), bestAxis);
+		bestSeparation = dgKernelSelect (better, separation, bestSeparation);
+		normal = normal.Select (better, axis.Select (dist < zero, axis.Scale (dgVector::m_negOne)));
+	}
+
+	normal.Scatter (batch.m_normal, dgVector::m_zero);
+	for (dgInt32 i = 0; i < DG_CONTACT_BATCH_SIZE; i ++) {
+		batch.m_separation[i] = bestSeparation[i];
+	}
+	// only a separation that is not a number leaves a pair without an axis
+	dgSetBatchFeatures (batch.m_feature, bestAxis, bestAxis < zero);
+}
+
+void dgWorld::CalculateBatchedPairContacts (dgBroadPhase::dgPair* const pair, const dgContactBatch& batch, dgInt32 lane, dgInt32 threadIndex)
+{
+	if (batch.m_feature[lane] < 0) {
+		CalculateContacts (pair, threadIndex, false, false);
+		return;
+	}
+
+	dgContact* const contact = pair->m_contact;
+	dgBody* const body0 = contact->m_body0;
+	dgBody* const body1 = contact->m_body1;
+	dgCollisionInstance* const collision0 = body0->m_collision;
+	dgCollisionInstance* const collision1 = body1->m_collision;
+	dgAssert (contact == batch.m_contacts[lane]);
+
+	dgCollisionParamProxy proxy (contact, pair->m_contactBuffer, threadIndex, false, false);
+	proxy.m_timestep = pair->m_timestep;
+	proxy.m_maxContacts = DG_MAX_CONTATCS;
+	proxy.m_skinThickness = contact->m_material->m_skinThickness;
+	proxy.m_body0 = body0;
+	proxy.m_body1 = body1;
+	proxy.m_instance0 = collision0;
+	proxy.m_instance1 = collision1;
+
+	// the joint ends up in the same state CalculateConvexToConvexContacts leaves it
+	contact->m_closestDistance = dgFloat32 (1.0e10f);
+	contact->m_separationDistance = dgFloat32 (0.0f);
+	const dgVector origin (collision0->GetGlobalMatrix().m_posit & dgVector::m_triplexMask);
+	if (contact->m_isNewContact) {
+		contact->m_isNewContact = false;
+		contact->m_simplexCacheCount = 0;
+		const dgVector v ((collision0->GetGlobalMatrix().m_posit - collision1->GetGlobalMatrix().m_posit) & dgVector::m_triplexMask);
+		const dgFloat32 mag2 = v.DotProduct(v).GetScalar();
+		if (mag2 > dgFloat32 (0.0f)) {
+			contact->m_separtingVector = v.Scale (dgRsqrt (mag2));
+		} else {
+			contact->m_separtingVector = collision0->GetGlobalMatrix().m_up;
+		}
+	}
+
+	dgInt32 count = 0;
+	const dgVector& normal = batch.m_normal[lane];
+	const dgVector& point0 = batch.m_point0[lane];
+	const dgVector& point1 = batch.m_point1[lane];
+	switch (batch.m_type)
+	{
+		case m_sphereSphereBatch:
+		case m_sphereBoxBatch:
+		{
+			count = SetAnalyticPointContact (proxy, normal, point0, point1);
+			break;
+		}
+
+		case m_capsuleCapsuleBatch:
+		{
+			const dgCollisionCapsule* const capsule0 = (dgCollisionCapsule*)collision0->GetChildShape();
+			const dgCollisionCapsule* const capsule1 = (dgCollisionCapsule*)collision1->GetChildShape();
+			const dgMatrix& matrix0 = collision0->GetGlobalMatrix();
+			const dgMatrix& matrix1 = collision1->GetGlobalMatrix();
+			const dgVector posit1 (matrix1.m_posit - origin);
+			const dgVector p0 (dgVector::m_wOne - matrix0.m_front.Scale (capsule0->m_height));
+			const dgVector p1 (dgVector::m_wOne + matrix0.m_front.Scale (capsule0->m_height));
+			const dgVector q0 (posit1 - matrix1.m_front.Scale (capsule1->m_height));
+			const dgVector q1 (posit1 + matrix1.m_front.Scale (capsule1->m_height));
+			count = CalculateCapsuleCapsuleManifold (proxy, normal, point0, point1, p0, p1, capsule0->m_radio0, q0, q1, capsule1->m_radio0);
+			break;
+		}
+
+		default:
+		{
+			dgAssert (batch.m_type == m_boxBoxBatch);
+			const dgCollisionBox* const box0 = (dgCollisionBox*)collision0->GetChildShape();
+			const dgCollisionBox* const box1 = (dgCollisionBox*)collision1->GetChildShape();
+			dgMatrix matrix0 (collision0->GetGlobalMatrix());
+			dgMatrix matrix1 (collision1->GetGlobalMatrix());
+			matrix0.m_posit = dgVector::m_wOne;
+			matrix1.m_posit -= origin;
+			count = CalculateBoxBoxManifold (proxy, matrix0, box0->m_size[0], matrix1, box1->m_size[0], normal, batch.m_feature[lane], batch.m_separation[lane]);
+		}
+	}
+
+	dgContactPoint* const contactOut = proxy.m_contacts;
+	for (dgInt32 i = 0; i < count; i ++) {
+		contactOut[i].m_point += origin;
+		contactOut[i].m_body0 = body0;
+		contactOut[i].m_body1 = body1;
+		contactOut[i].m_collision0 = collision0;
+		contactOut[i].m_collision1 = collision1;
+		contactOut[i].m_shapeId0 = collision0->GetUserDataID();
+		contactOut[i].m_shapeId1 = collision1->GetUserDataID();
+	}
+
+	pair->m_flipContacts = false;
+	pair->m_contactCount = count;
+	pair->m_timestep = proxy.m_timestep;
+}
@@ -51,6 +51,7 @@
 #include "dgCorkscrewConstraint.h"
 #include "dgBroadPhaseAggregate.h"
 #include "dgCollisionHeightField.h"
+#include "dgCollisionTiledHeightField.h"
 #include "dgCollisionConvexPolygon.h"
 #include "dgCollisionDeformableMesh.h"
 #include "dgCollisionCompoundFractured.h"
@@ -34,6 +34,11 @@
 
 #include <dg.h>
 
+// solvers of the static plugins in dgWorldPluginSse.cpp, dgWorldPluginAvx.cpp, dgWorldPluginAvx2.cpp and dgWorldPluginAvx512.cpp
+namespace dgSolverSse { class dgSolver; }
+namespace dgSolverAvx { class dgSolver; }
+namespace dgSolverAvx2 { class dgSolver; }
+namespace dgSolverAvx512 { class dgSolver; }
 
 
 //#define DG_PROFILE_PHYSICS
@@ -31,6 +31,8 @@
 #include "dgCollisionScene.h"
 #include "dgCollisionSphere.h"
 #include "dgInverseDynamics.h"
+#include "dgBroadPhaseBvh4.h"
+#include "dgBroadPhaseHashGrid.h"
 #include "dgBroadPhaseMixed.h"
 #include "dgCollisionCapsule.h"
 #include "dgCollisionInstance.h"
@@ -226,12 +228,10 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	,m_postUpdateCallback(NULL)
 	,m_listeners(allocator)
 	,m_perInstanceData(allocator)
-	,m_bodiesMemory (allocator, 64)
-	,m_jointsMemory (allocator, 64)
-	,m_clusterMemory (allocator, 64)
-	,m_solverJacobiansMemory (allocator, 64)
-	,m_solverRightHandSideMemory (allocator, 64)
-	,m_solverForceAccumulatorMemory (allocator, 64)
+	,m_frameArena (allocator)
+	,m_bodiesMemory (&m_frameArena, 0)
+	,m_jointsMemory (&m_frameArena, 0)
+	,m_clusterMemory (&m_frameArena, 0)
 	,m_concurrentUpdate(false)
 {
 	//TestAStart();
@@ -244,9 +244,10 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	m_bodiesMemory.Resize(1024);
 	m_clusterMemory.Resize(1024);
 	m_jointsMemory.Resize(1024 * 2);
-	m_solverJacobiansMemory.Resize(1024 * 64);
-	m_solverRightHandSideMemory.Resize(1024 * 64);
-	m_solverForceAccumulatorMemory.Resize(1024 * 32);
+
+	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		m_polygonMeshData[i].SetArena(&m_frameArena, i);
+	}
 
 	m_savetimestep = dgFloat32 (0.0f);
 	m_allocator = allocator;
@@ -268,6 +269,9 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	m_clusterLRU = 0;
 
 	m_useParallelSolver = 0;
+	m_useAnalyticContacts = 1;
+	m_useBatchedContacts = 0;
+	InitContactKernels();
 
 	m_solverIterations = DG_DEFAULT_SOLVER_ITERATION_COUNT;
 	m_dynamicsLru = 0;
@@ -322,7 +326,10 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	pointCollison->Release();
 
 	AddSentinelBody();
-//	LoadPlugins();
+
+	// pick the best solver the cpu supports
+	LoadStaticPlugins();
+	SelectPlugin(GetpreferedPlugin());
 }
 
 dgWorld::~dgWorld()
@@ -427,6 +434,26 @@ dgInt32 dgWorld::GetParallelSolverOnLargeIsland() const
 	return m_useParallelSolver ? 1 : 0;
 }
 
+void dgWorld::EnableAnalyticContacts(dgInt32 mode)
+{
+	m_useAnalyticContacts = mode ? 1 : 0;
+}
+
+dgInt32 dgWorld::GetAnalyticContacts() const
+{
+	return m_useAnalyticContacts ? 1 : 0;
+}
+
+void dgWorld::EnableBatchedContacts(dgInt32 mode)
+{
+	m_useBatchedContacts = mode ? 1 : 0;
+}
+
+dgInt32 dgWorld::GetBatchedContacts() const
+{
+	return m_useBatchedContacts ? 1 : 0;
+}
+
 
 void dgWorld::SetFrictionThreshold (dgFloat32 acceleration)
 {
@@ -450,6 +477,7 @@ void dgWorld::InitBody (dgBody* const body, dgCollisionInstance* const collision
 
 	m_bodiesUniqueID ++;
 	body->m_world = this;
+	m_bodyState.AddBody(body);
 
 	body->m_spawnnedFromCallback = dgUnsigned32 (m_inUpdate ? true : false);
 	body->m_uniqueID = dgInt32 (m_bodiesUniqueID);
@@ -554,6 +582,7 @@ void dgWorld::DestroyBody(dgBody* const body)
 
 	dgAssert (body->m_collision);
 	body->m_collision->Release();
+	m_bodyState.RemoveBody(body);
 	delete body;
 }
 
@@ -942,44 +971,52 @@ void dgWorld::Sync ()
 	}
 }
 
-void dgWorld::UpdateTransforms(dgBodyMasterList::dgListNode* node, dgInt32 threadID)
+void dgWorld::UpdateTransforms(dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
-	const dgInt32 threadsCount = GetThreadCount();
-	while (node) {
-		dgBody* const body = node->GetInfo().GetBody();
+	dgBody** const bodyArray = &m_bodyArray[0];
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBody* const body = bodyArray[i];
 		if (body->m_transformIsDirty && body->m_matrixUpdate) {
-			body->m_matrixUpdate (*body, body->m_matrix, threadID);
+			body->m_matrixUpdate (*body, body->GetStateMatrix(), threadID);
 		}
 		body->m_transformIsDirty = false;
-
-		for (dgInt32 i = 0; i < threadsCount; i++) {
-			node = node ? node->GetNext() : NULL;
-		}
 	}
 }
 
-void dgWorld::UpdateTransforms(void* const context, void* const nodePtr, dgInt32 threadID)
+void dgWorld::UpdateTransforms(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
 {
 	dgWorld* const world = (dgWorld*)context;
-	dgBodyMasterList::dgListNode* node = (dgBodyMasterList::dgListNode*) nodePtr;
-	world->UpdateTransforms(node, threadID);
+	world->UpdateTransforms(start, end, threadID);
 }
 
-void dgWorld::RunStep ()
+// the step arrays keep their capacity, so after the first steps they are laid out in the pre sized sub arenas
+void dgWorld::ResetFrameMemory ()
 {
-	static int zzzz;
-	if (zzzz == 50) {
-		DG_START_RECORDING("../../../../sdk/dProfiler/xxxx.tt");
+	m_frameArena.Reset(GetThreadCount());
+	m_bodiesMemory.Reset();
+	m_jointsMemory.Reset();
+	m_clusterMemory.Reset();
+	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		m_polygonMeshData[i].Reset();
 	}
-	if (zzzz == 500) {
-		DG_STOP_RECORDING();
-	}
-	zzzz++;
+}
 
+void dgWorld::RunStep ()
+{
 	DG_TRACKTIME(__FUNCTION__);
 	dgUnsigned64 timeAcc = dgGetTimeInMicrosenconds();
+
+	dgUnsigned64 busyTime[DG_MAX_THREADS_HIVE_COUNT];
+	const dgInt32 threadCount = GetThreadCount();
+	for (dgInt32 i = 0; i < threadCount; i ++) {
+		busyTime[i] = GetThreadBusyTime(i);
+	}
+	m_stepStats.Clear();
+	memset (m_narrowPhaseCounters, 0, sizeof (m_narrowPhaseCounters));
+
 	dgFloat32 step = m_savetimestep / m_numberOfSubsteps;
 	for (dgUnsigned32 i = 0; i < m_numberOfSubsteps; i ++) {
+		ResetFrameMemory();
 		dgInterlockedExchange(&m_delayDelateLock, 1);
 		StepDynamics (step);
 		dgInterlockedExchange(&m_delayDelateLock, 0);
@@ -991,20 +1028,33 @@ void dgWorld::RunStep ()
 		bodyList.DestroyBodies (*this);
 	}
 
-	const dgBodyMasterList* const masterList = this;
-	dgBodyMasterList::dgListNode* node = masterList->GetFirst();
-	const dgInt32 threadsCount = GetThreadCount();
-	for (dgInt32 i = 0; i < threadsCount; i++) {
-		QueueJob(UpdateTransforms, this, node, "dgWorld::UpdateTransforms");
-		node = node ? node->GetNext() : NULL;
-	}
-	SynchronizationBarrier();
+	const dgUnsigned64 transformTime = dgGetTimeInMicrosenconds();
+	const dgInt32 bodyCount = BuildBodyArray();
+	ParallelFor(0, bodyCount, DG_PARALLEL_BODY_GRAIN_SIZE, UpdateTransforms, this, "dgWorld::UpdateTransforms");
+	m_stepStats.m_transformTime = dgGetTimeInMicrosenconds() - transformTime;
 
 	if (m_postUpdateCallback) {
 		m_postUpdateCallback (this, m_savetimestep);
 	}
 
-	m_lastExecutionTime = (dgGetTimeInMicrosenconds() - timeAcc) * dgFloat32 (1.0e-6f);
+	const dgUnsigned64 stepTime = dgGetTimeInMicrosenconds() - timeAcc;
+	m_lastExecutionTime = stepTime * dgFloat32 (1.0e-6f);
+
+	m_stepStats.m_stepTime = stepTime;
+	m_stepStats.m_threadCount = threadCount;
+	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		m_stepStats.m_simplexCacheQueries += m_narrowPhaseCounters[i].m_simplexCacheQueries;
+		m_stepStats.m_simplexCacheHits += m_narrowPhaseCounters[i].m_simplexCacheHits;
+	}
+	if (threadCount == 1) {
+		// without worker threads all the jobs run in the calling thread
+		m_stepStats.m_threadBusyTime[0] = stepTime;
+	} else {
+		for (dgInt32 i = 0; i < threadCount; i ++) {
+			m_stepStats.m_threadBusyTime[i] = GetThreadBusyTime(i) - busyTime[i];
+		}
+	}
+	m_lastStepStats = m_stepStats;
 
 	if (!m_concurrentUpdate) {
 		m_mutex.Release();
@@ -1070,6 +1120,14 @@ void dgWorld::SetBroadPhaseType(dgInt32 type)
 				newBroadPhase = new (m_allocator) dgBroadPhaseSegregated (this);
 				break;
 
+			case m_broadphaseBvh4:
+				newBroadPhase = new (m_allocator) dgBroadPhaseBvh4 (this);
+				break;
+
+			case m_broadphaseHashGrid:
+				newBroadPhase = new (m_allocator) dgBroadPhaseHashGrid (this);
+				break;
+
 			case m_broadphaseMixed:
 			default:
 				newBroadPhase = new (m_allocator) dgBroadPhaseMixed(this);
@@ -1092,6 +1150,14 @@ void dgWorld::ResetBroadPhase()
 			newBroadPhase = new (m_allocator) dgBroadPhaseSegregated (this);
 			break;
 
+		case m_broadphaseBvh4:
+			newBroadPhase = new (m_allocator) dgBroadPhaseBvh4 (this);
+			break;
+
+		case m_broadphaseHashGrid:
+			newBroadPhase = new (m_allocator) dgBroadPhaseHashGrid (this);
+			break;
+
 		case m_broadphaseMixed:
 		default:
 			newBroadPhase = new (m_allocator) dgBroadPhaseMixed(this);
@@ -1109,6 +1175,56 @@ dgContact* dgWorld::FindContactJoint (const dgBody* body0, const dgBody* body1)
 	return m_broadPhase->m_contactCache.FindContactJoint(body0, body1);
 }
 
+class dgInvalidateRegionContext
+{
+	public:
+	dgWorld* m_world;
+	dgBody* m_shapeBody;
+};
+
+dgInt32 dgWorld::OnInvalidateRegionBody (dgBody* body, void* const userData)
+{
+	dgInvalidateRegionContext* const context = (dgInvalidateRegionContext*)userData;
+	if ((body != context->m_shapeBody) && (body->GetInvMass().m_w > dgFloat32 (0.0f))) {
+		body->SetSleepState (false);
+		dgContact* const contact = context->m_world->FindContactJoint (body, context->m_shapeBody);
+		if (contact) {
+			// a cached contact would survive the shape change because the bodies are not moving
+			contact->m_positAcc = dgVector (dgFloat32 (10.0f));
+		}
+	}
+	return 1;
+}
+
+void dgWorld::InvalidateCollisionRegions (const dgCollision* const shape, const dgVector* const boxes, dgInt32 count)
+{
+	// boxes are pairs of min and max points in shape space. the bodies using the shape get
+	// a new broad phase box and the bodies over the changed regions are woken up
+	dgBodyMasterList& me = *this;
+	for (dgBodyMasterList::dgListNode* node = me.GetFirst()->GetNext(); node; node = node->GetNext()) {
+		dgBody* const body = node->GetInfo().GetBody();
+		dgCollisionInstance* const instance = body->GetCollision();
+		if (instance->GetChildShape() == shape) {
+			body->m_equilibrium = false;
+			body->UpdateCollisionMatrix (dgFloat32 (0.0f), 0);
+
+			dgInvalidateRegionContext context;
+			context.m_world = this;
+			context.m_shapeBody = body;
+			const dgVector& scale = instance->GetScale();
+			const dgMatrix& matrix = instance->GetGlobalMatrix();
+			for (dgInt32 i = 0; i < count; i ++) {
+				dgVector p0;
+				dgVector p1;
+				const dgVector q0 (scale * boxes[i * 2 + 0]);
+				const dgVector q1 (scale * boxes[i * 2 + 1]);
+				matrix.TransformBBox (q0.GetMin(q1), q0.GetMax(q1), p0, p1);
+				m_broadPhase->ForEachBodyInAABB (p0, p1, OnInvalidateRegionBody, &context);
+			}
+		}
+	}
+}
+
 dgSkeletonContainer* dgWorld::CreateNewtonSkeletonContainer (dgBody* const rootBone)
 {
 	dgAssert (rootBone);
@@ -1279,21 +1395,24 @@ void dgWorld::UpdateSkeletons()
 		dgUnsigned32 lru = m_dynamicsLru;
 
 		dgBodyMasterList& masterList = *this;
-		m_solverJacobiansMemory.ResizeIfNecessary((2 * (masterList.m_constraintCount + 1024)) * sizeof (dgBilateralConstraint*));
-		dgBilateralConstraint** const jointList = (dgBilateralConstraint**)&m_solverJacobiansMemory[0];
+		dgFrameArenaScope scratchScope (m_frameArena, 0);
+		dgBilateralConstraint** const jointList = dgFrameAlloca(m_frameArena, dgBilateralConstraint*, 2 * (masterList.m_constraintCount + 1024), 0);
 
-		dgInt32 jointCount = 0;
-		for (dgBodyMasterList::dgListNode* node = masterList.GetFirst(); node; node = node->GetNext()) {
-			const dgBodyMasterListRow& graphNode = node->GetInfo();
-			dgBody* const srcBody = graphNode.GetBody();
+		const dgInt32 bodyCount = masterList.BuildJointGraph();
+		const dgInt32* const jointGraphStart = &masterList.m_jointGraphStart[0];
+		const dgBodyMasterListCell* const jointGraph = &masterList.m_jointGraph[0];
 
-			for (dgBodyMasterListRow::dgListNode* jointNode = srcBody->m_masterNode->GetInfo().GetLast(); jointNode; jointNode = jointNode->GetPrev()) {
-				dgBodyMasterListCell* const cell = &jointNode->GetInfo();
+		// visit the sentinel row first, in the same order as the master list
+		dgInt32 jointCount = 0;
+		for (dgInt32 i = 0; i <= bodyCount; i ++) {
+			const dgInt32 row = i ? i - 1 : bodyCount;
+			for (dgInt32 j = jointGraphStart[row + 1] - 1; j >= jointGraphStart[row]; j --) {
+				const dgBodyMasterListCell* const cell = &jointGraph[j];
 				dgConstraint* const constraint = cell->m_joint;
 				dgAssert(constraint);
-				dgAssert((constraint->m_body0 == srcBody) || (constraint->m_body1 == srcBody));
+				dgAssert(constraint->IsBilateral());
 				dgAssert((constraint->m_body0 == cell->m_bodyNode) || (constraint->m_body1 == cell->m_bodyNode));
-				if (constraint->IsBilateral() && (constraint->m_solverModel < 2) && (constraint->m_dynamicsLru != lru)) {
+				if ((constraint->m_solverModel < 2) && (constraint->m_dynamicsLru != lru)) {
 					constraint->m_dynamicsLru = lru;
 					jointList[jointCount] = (dgBilateralConstraint*)constraint;
 					jointCount++;
@@ -1348,9 +1467,9 @@ void dgWorld::UpdateSkeletons()
 						dgSkeletonContainer::dgNode* const parentNode = queue.m_pool[index];
 						dgDynamicBody* const parentBody = skeleton->GetBody(parentNode);
 
-						for (dgBodyMasterListRow::dgListNode* jointNode1 = parentBody->m_masterNode->GetInfo().GetFirst(); jointNode1; jointNode1 = jointNode1->GetNext()) {
-							dgBodyMasterListCell* const cell1 = &jointNode1->GetInfo();
-							dgConstraint* const constraint1 = cell1->m_joint;
+						const dgInt32 parentRow = parentBody->m_graphIndex;
+						for (dgInt32 k = jointGraphStart[parentRow]; k < jointGraphStart[parentRow + 1]; k ++) {
+							dgConstraint* const constraint1 = jointGraph[k].m_joint;
 							if (constraint1->IsBilateral() && (constraint1->m_dynamicsLru != lru)) {
 								constraint1->m_dynamicsLru = lru;
 
@@ -27,6 +27,7 @@
 #include "dgCollision.h"
 #include "dgBroadPhase.h"
 #include "dgWorldPlugins.h"
+#include "dgCollisionMesh.h"
 #include "dgCollisionScene.h"
 #include "dgBodyMasterList.h"
 #include "dgWorldDynamicUpdate.h"
@@ -155,6 +156,45 @@ class dgDeadBodies: public dgTree<dgBody*, void* >
 
 typedef void (*dgPostUpdateCallback) (const dgWorld* const world, dgFloat32 timestep);
 
+// per phase timing of the last update, all times are in micro seconds and added over all sub steps
+class dgWorldStepStats
+{
+	public:
+	dgWorldStepStats()
+	{
+		Clear();
+	}
+
+	void Clear()
+	{
+		memset (this, 0, sizeof (dgWorldStepStats));
+	}
+
+	dgUnsigned64 m_stepTime;
+	dgUnsigned64 m_broadPhaseTime;
+	dgUnsigned64 m_narrowPhaseTime;
+	dgUnsigned64 m_clusterTime;
+	dgUnsigned64 m_solverTime;
+	dgUnsigned64 m_transformTime;
+	dgUnsigned64 m_threadBusyTime[DG_MAX_THREADS_HIVE_COUNT];
+	dgInt32 m_bodyCount;
+	dgInt32 m_contactCount;
+	dgInt32 m_clusterCount;
+	dgInt32 m_threadCount;
+	dgInt32 m_simplexCacheQueries;
+	dgInt32 m_simplexCacheHits;
+};
+
+// narrow phase counters of one thread, summed into the step stats at the end of the step.
+// padded to a cache line so that threads never write to the same line
+class dgNarrowPhaseCounters
+{
+	public:
+	dgInt32 m_simplexCacheQueries;
+	dgInt32 m_simplexCacheHits;
+	dgInt32 m_padding[14];
+};
+
 DG_MSC_VECTOR_ALIGMENT
 class dgWorld
 	:public dgBodyMasterList
@@ -189,6 +229,8 @@ class dgWorld
 	{
 		m_broadphaseMixed,
 		m_broadphaseSegregated,
+		m_broadphaseBvh4,
+		m_broadphaseHashGrid,
 	};
 
 	class dgListener
@@ -241,6 +283,7 @@ class dgWorld
 	~dgWorld();
 
 	dgFloat32 GetUpdateTime() const;
+	const dgWorldStepStats& GetStepStats() const;
 	dgBroadPhase* GetBroadPhase() const;
 
 	dgInt32 GetSolverIterations() const;
@@ -251,6 +294,12 @@ class dgWorld
 	void EnableParallelSolverOnLargeIsland(dgInt32 mode);
 	dgInt32 GetParallelSolverOnLargeIsland() const;
 
+	void EnableAnalyticContacts(dgInt32 mode);
+	dgInt32 GetAnalyticContacts() const;
+
+	void EnableBatchedContacts(dgInt32 mode);
+	dgInt32 GetBatchedContacts() const;
+
 	void FlushCache();
 
 	virtual dgUnsigned64 GetTimeInMicrosenconds() const;
@@ -340,6 +389,7 @@ class dgWorld
 	dgCollisionInstance* CreateBVH ();	
 	dgCollisionInstance* CreateStaticUserMesh (const dgVector& boxP0, const dgVector& boxP1, const dgUserMeshCreation& data);
 	dgCollisionInstance* CreateHeightField (dgInt32 width, dgInt32 height, dgInt32 contructionMode, dgInt32 elevationDataType, const void* const elevationMap, const dgInt8* const atributeMap, dgFloat32 verticalScale, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z);
+	dgCollisionInstance* CreateTiledHeightField (dgInt32 tileSize, dgInt32 contructionMode, dgInt32 elevationDataType, dgFloat32 verticalScale, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z);
 	dgCollisionInstance* CreateScene ();	
 
 	dgBroadPhaseAggregate* CreateAggreGate() const; 
@@ -395,6 +445,7 @@ class dgWorld
 	dgContactMaterial* GetFirstMaterial () const;
 	dgContactMaterial* GetNextMaterial (dgContactMaterial* material) const;
 	dgContact* FindContactJoint (const dgBody* body0, const dgBody* body1) const;
+	void InvalidateCollisionRegions (const dgCollision* const shape, const dgVector* const boxes, dgInt32 count);
 
 	void SetThreadsCount (dgInt32 count);
 	
@@ -407,6 +458,7 @@ class dgWorld
 
 	dgDynamicBody* GetSentinelBody() const;
 	dgMemoryAllocator* GetAllocator() const;
+	dgFrameArena& GetFrameArena();
 
 	dgInt32 GetBroadPhaseType() const;
 	void SetBroadPhaseType (dgInt32 type);
@@ -428,7 +480,41 @@ class dgWorld
 		dgFloat32 m_dist;
 	};
 
+	class dgContactKernel
+	{
+		public:
+		dgInt32 (dgWorld::*m_kernel) (dgCollisionParamProxy& proxy) const;
+		bool m_swapShapes;
+	};
+
+	enum dgContactBatchType
+	{
+		m_sphereSphereBatch,
+		m_sphereBoxBatch,
+		m_capsuleCapsuleBatch,
+		m_boxBoxBatch,
+		m_contactBatchTypes,
+	};
+
+	// up to four pairs of the same kind collided together, the closest features of each
+	// lane are found with the vector lanes and the contacts are then written one pair at
+	// the time, a negative feature sends the pair back to CalculateContacts
+	DG_MSC_VECTOR_ALIGMENT
+	class dgContactBatch
+	{
+		public:
+		dgVector m_normal[DG_CONTACT_BATCH_SIZE];
+		dgVector m_point0[DG_CONTACT_BATCH_SIZE];
+		dgVector m_point1[DG_CONTACT_BATCH_SIZE];
+		dgContact* m_contacts[DG_CONTACT_BATCH_SIZE];
+		dgFloat32 m_separation[DG_CONTACT_BATCH_SIZE];
+		dgInt32 m_feature[DG_CONTACT_BATCH_SIZE];
+		dgInt32 m_type;
+		dgInt32 m_count;
+	} DG_GCC_VECTOR_ALIGMENT;
+
 	void RunStep ();
+	void ResetFrameMemory ();
 	void CalculateContacts (dgBroadPhase::dgPair* const pair, dgInt32 threadIndex, bool ccdMode, bool intersectionTestOnly);
 	dgInt32 PruneContacts (dgInt32 count, dgContactPoint* const contact, dgFloat32 distTolerenace, dgInt32 maxCount = (DG_CONSTRAINT_MAX_ROWS / 3)) const;
 	dgInt32 ReduceContacts (dgInt32 count, dgContactPoint* const contact, dgInt32 maxCount, dgFloat32 tol, dgInt32 arrayIsSorted = 0) const;
@@ -440,6 +526,29 @@ class dgWorld
 	dgInt32 CalculateConvexToConvexContacts (dgCollisionParamProxy& proxy) const;
 	dgInt32 PruneContactsByRank(dgInt32 count, dgCollisionParamProxy& proxy, dgInt32 maxCount) const;
 	
+	void InitContactKernels ();
+	dgInt32 CalculateAnalyticContacts (dgCollisionParamProxy& proxy, const dgContactKernel& kernel) const;
+	dgInt32 CalculateSphereSphereContacts (dgCollisionParamProxy& proxy) const;
+	dgInt32 CalculateSphereCapsuleContacts (dgCollisionParamProxy& proxy) const;
+	dgInt32 CalculateSphereBoxContacts (dgCollisionParamProxy& proxy) const;
+	dgInt32 CalculateCapsuleCapsuleContacts (dgCollisionParamProxy& proxy) const;
+	dgInt32 CalculateCapsuleBoxContacts (dgCollisionParamProxy& proxy) const;
+	dgInt32 CalculateBoxBoxContacts (dgCollisionParamProxy& proxy) const;
+	dgInt32 CalculateRoundContacts (dgCollisionParamProxy& proxy, const dgVector& center0, dgFloat32 radius0, const dgVector& center1, dgFloat32 radius1) const;
+	bool SetAnalyticClosestPoints (dgCollisionParamProxy& proxy, const dgVector& normal, const dgVector& point0, const dgVector& point1, dgFloat32& separation) const;
+	dgInt32 SetAnalyticContacts (dgCollisionParamProxy& proxy, const dgVector& normal, dgFloat32 separation, const dgVector* const points, dgInt32 count) const;
+	dgInt32 SetAnalyticPointContact (dgCollisionParamProxy& proxy, const dgVector& normal, const dgVector& point0, const dgVector& point1) const;
+	dgInt32 CalculateCapsuleCapsuleManifold (dgCollisionParamProxy& proxy, const dgVector& normal, const dgVector& point0, const dgVector& point1, const dgVector& p0, const dgVector& p1, dgFloat32 radius0, const dgVector& q0, const dgVector& q1, dgFloat32 radius1) const;
+	dgInt32 CalculateBoxBoxManifold (dgCollisionParamProxy& proxy, const dgMatrix& matrix0, const dgVector& size0, const dgMatrix& matrix1, const dgVector& size1, const dgVector& normal, dgInt32 bestAxis, dgFloat32 bestSeparation) const;
+
+	dgInt32 GetContactBatchType (const dgContact* const contact) const;
+	void CalculateContactBatch (dgContactBatch& batch) const;
+	void CalculateSphereSphereBatch (dgContactBatch& batch) const;
+	void CalculateSphereBoxBatch (dgContactBatch& batch) const;
+	void CalculateCapsuleCapsuleBatch (dgContactBatch& batch) const;
+	void CalculateBoxBoxBatch (dgContactBatch& batch) const;
+	void CalculateBatchedPairContacts (dgBroadPhase::dgPair* const pair, const dgContactBatch& batch, dgInt32 lane, dgInt32 threadIndex);
+
 	void PopulateContacts (dgBroadPhase::dgPair* const pair, dgInt32 threadIndex);	
 	void ProcessContacts (dgBroadPhase::dgPair* const pair, dgInt32 threadIndex);
 	void ProcessCachedContacts (dgContact* const contact, dgFloat32 timestep, dgInt32 threadIndex) const;
@@ -465,11 +574,12 @@ class dgWorld
 	
 	virtual void Execute (dgInt32 threadID);
 	virtual void TickCallback (dgInt32 threadID);
-	void UpdateTransforms(dgBodyMasterList::dgListNode* node, dgInt32 threadID);
+	void UpdateTransforms(dgInt32 start, dgInt32 end, dgInt32 threadID);
 
 	static dgUnsigned32 dgApi GetPerformanceCount ();
-	static void UpdateTransforms(void* const context, void* const node, dgInt32 threadID);
+	static void UpdateTransforms(void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
 	static dgInt32 SortFaces (const dgAdressDistPair* const A, const dgAdressDistPair* const B, void* const context);
+	static dgInt32 OnInvalidateRegionBody (dgBody* body, void* const userData);
 	static dgInt32 CompareJointByInvMass (const dgBilateralConstraint* const jointA, const dgBilateralConstraint* const jointB, void* notUsed);
 
 	dgUnsigned32 m_numberOfSubsteps;
@@ -480,6 +590,8 @@ class dgWorld
 	dgUnsigned32 m_defualtBodyGroupID;
 	dgUnsigned32 m_bodiesUniqueID;
 	dgUnsigned32 m_useParallelSolver;
+	dgUnsigned32 m_useAnalyticContacts;
+	dgUnsigned32 m_useBatchedContacts;
 	dgUnsigned32 m_genericLRUMark;
 	dgInt32 m_delayDelateLock;
 	dgInt32 m_clusterLRU;
@@ -494,6 +606,10 @@ class dgWorld
 	dgFloat32 m_lastExecutionTime;
 
 	dgSolverProgressiveSleepEntry m_sleepTable[DG_SLEEP_ENTRIES];
+	dgContactKernel m_contactKernels[m_nullCollision][m_nullCollision];
+	dgWorldStepStats m_stepStats;
+	dgWorldStepStats m_lastStepStats;
+	dgNarrowPhaseCounters m_narrowPhaseCounters[DG_MAX_THREADS_HIVE_COUNT];
 	
 	dgBroadPhase* m_broadPhase; 
 	dgDynamicBody* m_sentinelBody;
@@ -512,18 +628,21 @@ class dgWorld
 
 	dgListenerList m_listeners;
 	dgTree<void*, unsigned> m_perInstanceData;
-	dgArray<dgBodyInfo> m_bodiesMemory; 
-	dgArray<dgJointInfo> m_jointsMemory; 
-	dgArray<dgBodyCluster> m_clusterMemory;
-	dgArray<dgUnsigned8> m_solverJacobiansMemory;  
-	dgArray<dgUnsigned8> m_solverRightHandSideMemory;
-	dgArray<dgUnsigned8> m_solverForceAccumulatorMemory;
+	dgFrameArena m_frameArena;
+	dgFrameArray<dgBodyInfo> m_bodiesMemory; 
+	dgFrameArray<dgJointInfo> m_jointsMemory; 
+	dgFrameArray<dgBodyCluster> m_clusterMemory;
+	dgPolygonMeshDesc::dgMesh m_polygonMeshData[DG_MAX_THREADS_HIVE_COUNT];
 	
 	
 	bool m_concurrentUpdate;
 	
 	friend class dgBody;
 	friend class dgSolver;
+	friend class dgSolverSse::dgSolver;
+	friend class dgSolverAvx::dgSolver;
+	friend class dgSolverAvx2::dgSolver;
+	friend class dgSolverAvx512::dgSolver;
 	friend class dgContact;
 	friend class dgBroadPhase;
 	friend class dgDeadBodies;
@@ -536,8 +655,11 @@ class dgWorld
 	friend class dgCollisionScene;
 	friend class dgCollisionConvex;
 	friend class dgBroadPhaseMixed;
+	friend class dgBroadPhaseBvh4;
+	friend class dgBroadPhaseHashGrid;
 	friend class dgCollisionInstance;
 	friend class dgCollisionCompound;
+	friend class dgPolygonMeshDesc;
 	friend class dgParallelBodySolver;
 	friend class dgWorldDynamicUpdate;
 	friend class dgParallelSolverClear;	
@@ -571,6 +693,11 @@ inline dgMemoryAllocator* dgWorld::GetAllocator() const
 	return m_allocator;
 }
 
+inline dgFrameArena& dgWorld::GetFrameArena()
+{
+	return m_frameArena;
+}
+
 inline dgBroadPhase* dgWorld::GetBroadPhase() const
 {
 	return m_broadPhase;
@@ -591,6 +718,11 @@ inline dgFloat32 dgWorld::GetUpdateTime() const
 	return m_lastExecutionTime;
 }
 
+inline const dgWorldStepStats& dgWorld::GetStepStats() const
+{
+	return m_lastStepStats;
+}
+
 inline void dgWorld::SetPostUpdateCallback(const dgWorld* const newtonWorld, dgPostUpdateCallback callback)
 {
 	m_postUpdateCallback = callback;
@@ -58,15 +58,9 @@ class dgWorldDynamicUpdateSyncDescriptor
 
 void dgJacobianMemory::Init(dgWorld* const world, dgInt32 rowsCount, dgInt32 bodyCount)
 {
-	world->m_solverJacobiansMemory.ResizeIfNecessary((rowsCount + 1) * sizeof(dgLeftHandSide));
-	m_leftHandSizeBuffer = (dgLeftHandSide*)&world->m_solverJacobiansMemory[0];
-
-	world->m_solverRightHandSideMemory.ResizeIfNecessary((rowsCount + 1) * sizeof(dgRightHandSide));
-	m_righHandSizeBuffer = (dgRightHandSide*)&world->m_solverRightHandSideMemory[0];
-
-	world->m_solverForceAccumulatorMemory.ResizeIfNecessary((bodyCount + 8) * sizeof(dgJacobian));
-	m_internalForcesBuffer = (dgJacobian*)&world->m_solverForceAccumulatorMemory[0];
-	dgAssert(bodyCount <= (((world->m_solverForceAccumulatorMemory.GetBytesCapacity() - 16) / dgInt32(sizeof(dgJacobian))) & (-8)));
+	m_leftHandSizeBuffer = dgFrameAlloca(world->m_frameArena, dgLeftHandSide, rowsCount + 1, 0);
+	m_righHandSizeBuffer = dgFrameAlloca(world->m_frameArena, dgRightHandSide, rowsCount + 1, 0);
+	m_internalForcesBuffer = dgFrameAlloca(world->m_frameArena, dgJacobian, bodyCount + 8, 0);
 
 	dgAssert((dgUnsigned64(m_leftHandSizeBuffer) & 0x01f) == 0);
 	dgAssert((dgUnsigned64(m_internalForcesBuffer) & 0x01f) == 0);
@@ -108,8 +102,10 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 	sentinelBody->m_equilibrium = 1;
 	sentinelBody->m_dynamicsLru = m_markLru;
 
+	const dgUnsigned64 clusterTime = dgGetTimeInMicrosenconds();
 	BuildClusters(timestep);
 //	BuildClustersOld(timestep);
+	const dgUnsigned64 solverTime = dgGetTimeInMicrosenconds();
 
 	const dgInt32 threadCount = world->GetThreadCount();	
 
@@ -157,6 +153,11 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 	}
 
 	m_clusterData = NULL;
+
+	dgWorldStepStats& stats = world->m_stepStats;
+	stats.m_clusterTime += solverTime - clusterTime;
+	stats.m_solverTime += dgGetTimeInMicrosenconds() - solverTime;
+	stats.m_clusterCount = m_clusters;
 }
 
 dgInt32 dgWorldDynamicUpdate::CompareKey(dgInt32 highA, dgInt32 lowA, dgInt32 highB, dgInt32 lowB)
@@ -184,6 +185,27 @@ dgInt32 dgWorldDynamicUpdate::CompareClusterInfos(const dgBodyCluster* const clu
 	return CompareKey(clusterA->m_jointCount, clusterA->m_bodyStart, clusterB->m_jointCount, clusterB->m_bodyStart);
 }
 
+class dgClusterBuildDescriptor
+{
+	public:
+	class dgBlockSum
+	{
+		public:
+		dgInt32 m_rowCount;
+		dgInt32 m_bodyCount;
+		dgInt32 m_jointCount;
+		dgInt32 m_softBodiesCount;
+	};
+
+	dgWorldDynamicUpdate* m_dynamics;
+	dgBody** m_bodyArray;
+	dgJointInfo* m_jointArray;
+	dgBodyCluster* m_clusterArray;
+	dgInt32 m_clustersCount;
+	dgInt32 m_blocksCount;
+	dgBlockSum m_blocks[DG_MAX_THREADS_HIVE_COUNT];
+};
+
 DG_INLINE dgBody* dgWorldDynamicUpdate::FindRoot(dgBody* const body) const
 {
 	dgBody* node = body;
@@ -193,6 +215,8 @@ DG_INLINE dgBody* dgWorldDynamicUpdate::FindRoot(dgBody* const body) const
 
 DG_INLINE dgBody* dgWorldDynamicUpdate::FindRootAndSplit(dgBody* const body) const
 {
+	// path halving, only non root nodes are written, and a node parent can only move up the tree,
+	// so this is safe to run concurrently with other finds and links
 	dgBody* node = body;
 	while (node->m_disjointInfo.m_parent != node) {
 		dgBody* const prev = node;
@@ -204,25 +228,186 @@ DG_INLINE dgBody* dgWorldDynamicUpdate::FindRootAndSplit(dgBody* const body) con
 
 DG_INLINE void dgWorldDynamicUpdate::UnionSet(const dgConstraint* const joint) const
 {
+	// lock free link by index: the root with the larger unique id is linked under the other root,
+	// parents always have a smaller id than their children, so concurrent links can not form cycles
+	// and the final root of each set is the body with the smallest id, regardless of thread scheduling.
 	dgBody* const body0 = joint->GetBody0();
 	dgBody* const body1 = joint->GetBody1();
-	dgBody* root0 = FindRootAndSplit(body0);
-	dgBody* root1 = FindRootAndSplit(body1);
-	if (root0 != root1) {
-		if (root0->m_disjointInfo.m_rank < root1->m_disjointInfo.m_rank) {
+	for (;;) {
+		dgBody* root0 = FindRootAndSplit(body0);
+		dgBody* root1 = FindRootAndSplit(body1);
+		if (root0 == root1) {
+			break;
+		}
+		if (root0->m_uniqueID > root1->m_uniqueID) {
 			dgSwap(root0, root1);
 		}
-		root1->m_disjointInfo.m_parent = root0;
-		if (root0->m_disjointInfo.m_rank == root1->m_disjointInfo.m_rank) {
-			root0->m_disjointInfo.m_rank += 1;
-			dgAssert (root0->m_disjointInfo.m_rank <= 6);
+		if (dgInterlockedCompareExchange((void**)&root1->m_disjointInfo.m_parent, root0, root1) == root1) {
+			break;
+		}
+	}
+}
+
+void dgWorldDynamicUpdate::UnionSetsKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgClusterBuildDescriptor* const descriptor = (dgClusterBuildDescriptor*) context;
+	const dgWorldDynamicUpdate* const me = descriptor->m_dynamics;
+	const dgJointInfo* const jointArray = descriptor->m_jointArray;
+	for (dgInt32 i = start; i < end; i ++) {
+		const dgConstraint* const joint = jointArray[i].m_joint;
+		dgAssert(joint->GetBody0()->m_invMass.m_w > dgFloat32(0.0f));
+		if (joint->GetBody1()->m_invMass.m_w > dgFloat32 (0.0f)) {
+			me->UnionSet(joint);
+		}
+	}
+}
+
+void dgWorldDynamicUpdate::FlattenSetsKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgClusterBuildDescriptor* const descriptor = (dgClusterBuildDescriptor*) context;
+	const dgWorldDynamicUpdate* const me = descriptor->m_dynamics;
+	dgBody** const bodyArray = descriptor->m_bodyArray;
+	for (dgInt32 i = start; i < end; i ++) {
+		dgBody* const body = bodyArray[i];
+		if (body->GetInvMass().m_w != dgFloat32(0.0f)) {
+			dgBody* const root = me->FindRoot(body);
+			if (root != body) {
+				body->m_disjointInfo.m_parent = root;
+				dgAtomicExchangeAndAdd(&root->m_disjointInfo.m_bodyCount, 1);
+			}
+			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI) && !body->m_equilibrium) {
+				dgInterlockedExchange(&root->m_disjointInfo.m_equilibrium, 0);
+			}
+		}
+	}
+}
+
+void dgWorldDynamicUpdate::CountSetJointsKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgClusterBuildDescriptor* const descriptor = (dgClusterBuildDescriptor*) context;
+	const dgJointInfo* const jointArray = descriptor->m_jointArray;
+	for (dgInt32 i = start; i < end; i ++) {
+		const dgConstraint* const joint = jointArray[i].m_joint;
+		// sets are flat by now, body0 parent is its root
+		dgBody* const root = joint->GetBody0()->m_disjointInfo.m_parent;
+		dgAssert (root->m_disjointInfo.m_parent == root);
+		dgAtomicExchangeAndAdd(&root->m_disjointInfo.m_jointCount, 1);
+		dgAtomicExchangeAndAdd(&root->m_disjointInfo.m_rowCount, joint->m_maxDOF);
+	}
+}
+
+void dgWorldDynamicUpdate::ClusterBlockSumKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgClusterBuildDescriptor* const descriptor = (dgClusterBuildDescriptor*) context;
+	const dgBodyCluster* const clusterArray = descriptor->m_clusterArray;
+	const dgInt32 clustersCount = descriptor->m_clustersCount;
+	const dgInt32 blocksCount = descriptor->m_blocksCount;
+	for (dgInt32 i = start; i < end; i ++) {
+		dgClusterBuildDescriptor::dgBlockSum& block = descriptor->m_blocks[i];
+		block.m_rowCount = 0;
+		block.m_bodyCount = 0;
+		block.m_jointCount = 0;
+		block.m_softBodiesCount = 0;
+		const dgInt32 clusterStart = clustersCount * i / blocksCount;
+		const dgInt32 clusterEnd = clustersCount * (i + 1) / blocksCount;
+		for (dgInt32 j = clusterStart; j < clusterEnd; j ++) {
+			const dgBodyCluster& cluster = clusterArray[j];
+			block.m_rowCount += cluster.m_rowCount;
+			block.m_bodyCount += cluster.m_bodyCount;
+			block.m_softBodiesCount += cluster.m_hasSoftBodies;
+			block.m_jointCount += cluster.m_jointCount ? cluster.m_jointCount : 1;
+		}
+	}
+}
+
+void dgWorldDynamicUpdate::ClusterBlockStartKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgClusterBuildDescriptor* const descriptor = (dgClusterBuildDescriptor*) context;
+	dgBodyCluster* const clusterArray = descriptor->m_clusterArray;
+	const dgInt32 clustersCount = descriptor->m_clustersCount;
+	const dgInt32 blocksCount = descriptor->m_blocksCount;
+	for (dgInt32 i = start; i < end; i ++) {
+		// blocks hold their exclusive start offsets after the serial scan
+		const dgClusterBuildDescriptor::dgBlockSum& block = descriptor->m_blocks[i];
+		dgInt32 rowStart = block.m_rowCount;
+		dgInt32 bodyStart = block.m_bodyCount;
+		dgInt32 jointStart = block.m_jointCount;
+		const dgInt32 clusterStart = clustersCount * i / blocksCount;
+		const dgInt32 clusterEnd = clustersCount * (i + 1) / blocksCount;
+		for (dgInt32 j = clusterStart; j < clusterEnd; j ++) {
+			dgBodyCluster& cluster = clusterArray[j];
+			cluster.m_rowStart = rowStart;
+			cluster.m_bodyStart = bodyStart;
+			cluster.m_jointStart = jointStart;
+
+			rowStart += cluster.m_rowCount;
+			bodyStart += cluster.m_bodyCount;
+			jointStart += cluster.m_jointCount ? cluster.m_jointCount : 1;
+		}
+	}
+}
+
+void dgWorldDynamicUpdate::BuildClusterArraysKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID)
+{
+	DG_TRACKTIME(__FUNCTION__);
+	dgClusterBuildDescriptor* const descriptor = (dgClusterBuildDescriptor*) context;
+	dgWorld* const world = (dgWorld*) descriptor->m_dynamics;
+	const dgBodyCluster* const clusterArray = descriptor->m_clusterArray;
+	dgJointInfo* const jointArray = descriptor->m_jointArray;
+	dgBody* const sentinelBody = world->GetSentinelBody();
+
+	for (dgInt32 i = start; i < end; i ++) {
+		const dgBodyCluster& cluster = clusterArray[i];
+		dgBodyInfo* const bodyArray = &world->m_bodiesMemory[cluster.m_bodyStart];
+		dgJointInfo* const jointSetArray = &jointArray[cluster.m_jointStart];
+		bodyArray[0].m_body = sentinelBody;
+
+		if (cluster.m_jointCount) {
+			dgInt32 bodyIndex = 1;
+			dgInt32 rowStart = cluster.m_rowStart;
+			for (dgInt32 j = 0; j < cluster.m_jointCount; j++) {
+				dgJointInfo* const jointInfo = &jointSetArray[j];
+				dgConstraint* const joint = jointInfo->m_joint;
+				dgBody* const body0 = joint->m_body0;
+				dgBody* const body1 = joint->m_body1;
+
+				dgAssert(body0->GetInvMass().m_w != dgFloat32(0.0f));
+				if (body0->m_disjointInfo.m_rank >= 0) {
+					body0->m_disjointInfo.m_rank = -1;
+					body0->m_index = bodyIndex;
+					bodyArray[bodyIndex].m_body = body0;
+					bodyIndex++;
+					dgAssert(bodyIndex <= cluster.m_bodyCount);
+				}
+				dgInt32 m0 = body0->m_index;
+
+				dgInt32 m1 = 0;
+				if (body1->GetInvMass().m_w != dgFloat32(0.0f)) {
+					if (body1->m_disjointInfo.m_rank >= 0) {
+						body1->m_disjointInfo.m_rank = -1;
+						body1->m_index = bodyIndex;
+						bodyArray[bodyIndex].m_body = body1;
+						bodyIndex++;
+						dgAssert(bodyIndex <= cluster.m_bodyCount);
+					}
+					m1 = body1->m_index;
+				}
+
+				jointInfo->m_m0 = m0;
+				jointInfo->m_m1 = m1;
+				jointInfo->m_pairStart = rowStart;
+				rowStart += jointInfo->m_pairCount;
+			}
+		} else {
+			dgAssert(cluster.m_bodyCount == 2);
+			bodyArray[1].m_body = jointSetArray[0].m_body;
 		}
-		root0->m_disjointInfo.m_rowCount += root1->m_disjointInfo.m_rowCount;
-		root0->m_disjointInfo.m_bodyCount += root1->m_disjointInfo.m_bodyCount;
-		root0->m_disjointInfo.m_jointCount += root1->m_disjointInfo.m_jointCount;
 	}
-	root0->m_disjointInfo.m_jointCount ++;
-	root0->m_disjointInfo.m_rowCount += joint->m_maxDOF;
 }
 
 void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
@@ -230,22 +415,22 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 	DG_TRACKTIME(__FUNCTION__);
 	dgWorld* const world = (dgWorld*) this;
 	dgContactList& contactList = *world;
-	dgBodyMasterList& masterList = *world;
 	const dgBilateralConstraintList& jointList = *world;
 	dgInt32 jointCount = contactList.m_activeContactsCount;
 
-	dgArray<dgJointInfo>& jointArray = world->m_jointsMemory;
+	dgFrameArray<dgJointInfo>& jointArray = world->m_jointsMemory;
 	jointArray.ResizeIfNecessary(jointCount + jointList.GetCount());
 	dgJointInfo* const baseJointArray = &jointArray[0];
 
+	// body array is in master list order, static bodies first
+	const dgInt32 bodyCount = world->BuildBodyArray();
+	dgBody** const bodyArray = bodyCount ? &world->m_bodyArray[0] : NULL;
+
 #ifdef _DEBUG
-	for (dgBodyMasterList::dgListNode* node = masterList.GetLast(); node; node = node->GetPrev()) {
-		const dgBodyMasterListRow& graphNode = node->GetInfo();
-		dgBody* const body = graphNode.GetBody();
-		if (body->GetInvMass().m_w == dgFloat32(0.0f)) {
-			for (; node; node = node->GetPrev()) {
-				//dgAssert ((body->GetType() == dgBody::m_kinamticBody) ||(node->GetInfo().GetBody()->GetInvMass().m_w == dgFloat32(0.0f)));
-				dgAssert(node->GetInfo().GetBody()->GetInvMass().m_w == dgFloat32(0.0f));
+	for (dgInt32 i = bodyCount - 1; i >= 0; i --) {
+		if (bodyArray[i]->GetInvMass().m_w == dgFloat32(0.0f)) {
+			for (; i >= 0; i --) {
+				dgAssert(bodyArray[i]->GetInvMass().m_w == dgFloat32(0.0f));
 			}
 			break;
 		}
@@ -259,49 +444,41 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 		jointCount++;
 	}
 
-	// form all disjoints sets
-	for (dgInt32 i = 0; i < jointCount; i ++) {
-		dgConstraint* const contact = baseJointArray[i].m_joint;
-		dgAssert(contact->GetBody0()->m_invMass.m_w > dgFloat32(0.0f));
-		if (contact->GetBody1()->m_invMass.m_w > dgFloat32 (0.0f)) {
-			UnionSet(contact);
-		} else {
-			dgBody* const root = FindRootAndSplit(contact->GetBody0());
-			root->m_disjointInfo.m_jointCount += 1;
-			root->m_disjointInfo.m_rowCount += contact->m_maxDOF;
-		}
-	}
+	dgClusterBuildDescriptor descriptor;
+	descriptor.m_dynamics = this;
+	descriptor.m_bodyArray = bodyArray;
+	descriptor.m_jointArray = baseJointArray;
+	descriptor.m_clusterArray = NULL;
+	descriptor.m_clustersCount = 0;
+	descriptor.m_blocksCount = 0;
+
+	// form all disjoints sets, then flatten them so that every body points to its root 
+	// and accumulate the set body, joint and row counts and the set equilibrium state.
+	world->ParallelFor(0, jointCount, DG_PARALLEL_JOINT_GRAIN_SIZE, UnionSetsKernel, &descriptor, "dgWorldDynamicUpdate::UnionSets");
+	world->ParallelFor(0, bodyCount, DG_PARALLEL_BODY_GRAIN_SIZE, FlattenSetsKernel, &descriptor, "dgWorldDynamicUpdate::FlattenSets");
+	world->ParallelFor(0, jointCount, DG_PARALLEL_JOINT_GRAIN_SIZE, CountSetJointsKernel, &descriptor, "dgWorldDynamicUpdate::CountSetJoints");
 
 	// find and tag all sleeping disjoint sets, 
 	// and add single bodies as a set of zero joints and one body
-	dgInt32 bodyInfoCount = 0;
 	dgInt32 clustersCount = 0;
 	dgInt32 augmentedJointCount = jointCount;
 
-	dgArray<dgBodyCluster>& clusterMemory = world->m_clusterMemory;
-	for (dgBodyMasterList::dgListNode* node = masterList.GetLast(); node && (node->GetInfo().GetBody()->GetInvMass().m_w != dgFloat32(0.0f)); node = node->GetPrev()) {
-		dgBody* const body = node->GetInfo().GetBody();
-		if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
-			dgBody* root = body;
-			bool state = true;
-			do {
-				state &= root->m_equilibrium;
-				root = root->m_disjointInfo.m_parent;
-			} while (root->m_disjointInfo.m_parent != root);
-			root->m_resting &= state;
-
-			if (!root->m_resting && !root->m_disjointInfo.m_jointCount) {
+	dgFrameArray<dgBodyCluster>& clusterMemory = world->m_clusterMemory;
+	for (dgInt32 i = bodyCount - 1; (i >= 0) && (bodyArray[i]->GetInvMass().m_w != dgFloat32(0.0f)); i --) {
+		dgBody* const body = bodyArray[i];
+		if (body->m_disjointInfo.m_parent == body) {
+			body->m_resting &= body->m_disjointInfo.m_equilibrium;
+			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI) && !body->m_resting && !body->m_disjointInfo.m_jointCount) {
 				dgJointInfo& jointInfo = jointArray[augmentedJointCount];
 
-				dgAssert (root == body);
-				dgAssert (root->m_index == -1);
-				dgAssert (root->m_disjointInfo.m_bodyCount == 1);
+				dgAssert (body->m_index == -1);
+				dgAssert (body->m_disjointInfo.m_bodyCount == 1);
 
-				root->m_index = clustersCount;
+				body->m_index = clustersCount;
 				jointInfo.m_body = body;
 				jointInfo.m_jointCount = 0;
-				jointInfo.m_setId = root->m_index;
-				jointInfo.m_bodyCount = root->m_disjointInfo.m_bodyCount;
+				jointInfo.m_setId = body->m_index;
+				jointInfo.m_bodyCount = body->m_disjointInfo.m_bodyCount;
 				jointInfo.m_pairCount = 0;
 
 				dgBodyCluster& cluster = clusterMemory[clustersCount];
@@ -310,21 +487,22 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 				cluster.m_rowCount = 0;
 				cluster.m_hasSoftBodies = 0;
 				cluster.m_isContinueCollision = 0;
-				cluster.m_bodyStart = root->m_index;
+				cluster.m_bodyStart = body->m_index;
 
 				clustersCount ++;
-				bodyInfoCount += 2;
 				augmentedJointCount ++;
 			}
 		}
 	}
 
 	// remove all sleeping joints sets
+	// adding the single body sets may have grown the joint array, so the base pointer is stale
 	dgJointInfo* const augmentedJointArray = &jointArray[0];
+	descriptor.m_jointArray = augmentedJointArray;
 	for (dgInt32 i = jointCount - 1; i >= 0; i --) {
 		dgJointInfo* const jointInfo = &augmentedJointArray[i];
 		dgConstraint* const constraint = jointInfo->m_joint;
-		dgBody* const root = FindRoot (constraint->GetBody0());
+		dgBody* const root = constraint->GetBody0()->m_disjointInfo.m_parent;
 		if (root->m_resting) {
 			augmentedJointCount --;
 			augmentedJointArray[i] = augmentedJointArray[augmentedJointCount];
@@ -341,7 +519,6 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 				cluster.m_isContinueCollision = 0;
 
 				clustersCount++;
-				bodyInfoCount += root->m_disjointInfo.m_bodyCount + 1;
 			}
 			jointInfo->m_setId = root->m_index;
 			jointInfo->m_pairCount = constraint->m_maxDOF;
@@ -354,72 +531,38 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 	dgSort(augmentedJointArray, augmentedJointCount, CompareJointInfos);
 	dgSort(m_clusterData, clustersCount, CompareClusterInfos);
 
+	// two pass parallel prefix sum of the cluster row, body and joint counts
+	const dgInt32 threadCount = world->GetThreadCount();
+	const dgInt32 blocksCount = dgClamp((clustersCount + DG_PARALLEL_CLUSTER_GRAIN_SIZE - 1) / DG_PARALLEL_CLUSTER_GRAIN_SIZE, 1, dgMax(threadCount, 1));
+	descriptor.m_clusterArray = m_clusterData;
+	descriptor.m_clustersCount = clustersCount;
+	descriptor.m_blocksCount = blocksCount;
+	world->ParallelFor(0, blocksCount, 1, ClusterBlockSumKernel, &descriptor, "dgWorldDynamicUpdate::ClusterBlockSum");
+
 	dgInt32 rowStart = 0;
 	dgInt32 bodyStart = 0;
 	dgInt32 jointStart = 0;
 	dgInt32 softBodiesCount = 0;
-	for (dgInt32 i = 0; i < clustersCount; i++) {
-		dgBodyCluster& cluster = m_clusterData[i];
-		cluster.m_rowStart = rowStart;
-		cluster.m_bodyStart = bodyStart;
-		cluster.m_jointStart = jointStart;
-
-		rowStart += cluster.m_rowCount;
-		bodyStart += cluster.m_bodyCount;
-		softBodiesCount += cluster.m_hasSoftBodies;
-		jointStart += cluster.m_jointCount ? cluster.m_jointCount : 1;
+	for (dgInt32 i = 0; i < blocksCount; i++) {
+		dgClusterBuildDescriptor::dgBlockSum& block = descriptor.m_blocks[i];
+		const dgInt32 rowCount = block.m_rowCount;
+		const dgInt32 bodyCount = block.m_bodyCount;
+		const dgInt32 jointCount = block.m_jointCount;
+		block.m_rowCount = rowStart;
+		block.m_bodyCount = bodyStart;
+		block.m_jointCount = jointStart;
+
+		rowStart += rowCount;
+		bodyStart += bodyCount;
+		jointStart += jointCount;
+		softBodiesCount += block.m_softBodiesCount;
 	}
+	world->ParallelFor(0, blocksCount, 1, ClusterBlockStartKernel, &descriptor, "dgWorldDynamicUpdate::ClusterBlockStart");
+
 	m_solverMemory.Init(world, rowStart, bodyStart);
 	world->m_bodiesMemory.ResizeIfNecessary(bodyStart);
+	world->ParallelFor(0, clustersCount, DG_PARALLEL_CLUSTER_GRAIN_SIZE, BuildClusterArraysKernel, &descriptor, "dgWorldDynamicUpdate::BuildClusterArrays");
 
-	rowStart = 0;
-	for (dgInt32 i = 0; i < clustersCount; i++) {
-		const dgBodyCluster& cluster = m_clusterData[i];
-		dgBodyInfo* const bodyArray = &world->m_bodiesMemory[cluster.m_bodyStart];
-		dgJointInfo* const jointSetArray = &augmentedJointArray[cluster.m_jointStart];
-		bodyArray[0].m_body = world->GetSentinelBody();
-
-		if (cluster.m_jointCount) {
-			dgInt32 bodyIndex = 1;
-			for (dgInt32 j = 0; j < cluster.m_jointCount; j++) {
-				dgJointInfo* const jointInfo = &jointSetArray[j];
-				dgConstraint* const joint = jointInfo->m_joint;
-				dgBody* const body0 = joint->m_body0;
-				dgBody* const body1 = joint->m_body1;
-
-				dgAssert(body0->GetInvMass().m_w != dgFloat32(0.0f));
-				if (body0->m_disjointInfo.m_rank >= 0) {
-					body0->m_disjointInfo.m_rank = -1;
-					body0->m_index = bodyIndex;
-					bodyArray[bodyIndex].m_body = body0;
-					bodyIndex++;
-					dgAssert(bodyIndex <= cluster.m_bodyCount);
-				}
-				dgInt32 m0 = body0->m_index;
-
-				dgInt32 m1 = 0;
-				if (body1->GetInvMass().m_w != dgFloat32(0.0f)) {
-					if (body1->m_disjointInfo.m_rank >= 0) {
-						body1->m_disjointInfo.m_rank = -1;
-						body1->m_index = bodyIndex;
-						bodyArray[bodyIndex].m_body = body1;
-						bodyIndex++;
-						dgAssert(bodyIndex <= cluster.m_bodyCount);
-					}
-					m1 = body1->m_index;
-				}
-				
-				jointInfo->m_m0 = m0;
-				jointInfo->m_m1 = m1;
-				jointInfo->m_pairStart = rowStart;
-				rowStart += jointInfo->m_pairCount; 
-			}
-		} else {
-			dgAssert(cluster.m_bodyCount == 2);
-			bodyArray[1].m_body = jointSetArray[0].m_body;
-		}
-	}
-	
 	m_bodies = bodyStart;
 	m_joints = jointStart;
 	m_clusters = clustersCount;
@@ -438,18 +581,17 @@ void dgWorldDynamicUpdate::BuildClustersOld(dgFloat32 timestep)
 	m_joints = 0;
 	m_clusters = 0;
 	dgAssert (masterList.GetFirst()->GetInfo().GetBody() == world->m_sentinelBody);
-	world->m_solverJacobiansMemory.ResizeIfNecessary ((2 * (masterList.m_constraintCount + 1024)) * sizeof (dgDynamicBody*));
-	dgDynamicBody** const stackPoolBuffer = (dgDynamicBody**)&world->m_solverJacobiansMemory[0];
+	dgDynamicBody** const stackPoolBuffer = dgFrameAlloca(world->m_frameArena, dgDynamicBody*, 2 * (masterList.m_constraintCount + 1024), 0);
 
-	for (dgBodyMasterList::dgListNode* node = masterList.GetLast(); node; node = node->GetPrev()) {
-		const dgBodyMasterListRow& graphNode = node->GetInfo();
-		dgBody* const body = graphNode.GetBody();
+	const dgInt32 bodyCount = masterList.BuildBodyArray();
+	dgBody** const bodyArray = bodyCount ? &masterList.m_bodyArray[0] : NULL;
+	for (dgInt32 i = bodyCount - 1; i >= 0; i --) {
+		dgBody* const body = bodyArray[i];
 		
 		if (body->GetInvMass().m_w == dgFloat32(0.0f)) {
 #ifdef _DEBUG
-			for (; node; node = node->GetPrev()) {
-				//dgAssert ((body->GetType() == dgBody::m_kinamticBody) ||(node->GetInfo().GetBody()->GetInvMass().m_w == dgFloat32(0.0f)));
-				dgAssert(node->GetInfo().GetBody()->GetInvMass().m_w == dgFloat32(0.0f));
+			for (; i >= 0; i --) {
+				dgAssert(bodyArray[i]->GetInvMass().m_w == dgFloat32(0.0f));
 			}
 #endif
 			break;
@@ -638,11 +780,11 @@ void dgWorldDynamicUpdate::SpanningTree (dgDynamicBody* const body, dgDynamicBod
 			if (joint->GetId() == dgConstraint::m_contactConstraint) {
 				if (body0->m_continueCollisionMode | body1->m_continueCollisionMode) {
 					dgInt32 ccdJoint = false;
-					const dgVector& veloc0 = body0->m_veloc;
-					const dgVector& veloc1 = body1->m_veloc;
+					const dgVector& veloc0 = body0->GetStateVeloc();
+					const dgVector& veloc1 = body1->GetStateVeloc();
 
-					const dgVector& omega0 = body0->m_omega;
-					const dgVector& omega1 = body1->m_omega;
+					const dgVector& omega0 = body0->GetStateOmega();
+					const dgVector& omega1 = body1->GetStateOmega();
 
 					const dgVector& com0 = body0->m_globalCentreOfMass;
 					const dgVector& com1 = body1->m_globalCentreOfMass;
@@ -663,7 +805,7 @@ void dgWorldDynamicUpdate::SpanningTree (dgDynamicBody* const body, dgDynamicBod
 						dgInt64 attrib1[16];
 						dgFloat32 penetrations[16];
 						dgFloat32 timeToImpact = timestep;
-						const dgInt32 ccdContactCount = world->CollideContinue(collision0, body0->m_matrix, veloc0, omega0, collision1, body1->m_matrix, veloc1, omega1,
+						const dgInt32 ccdContactCount = world->CollideContinue(collision0, body0->GetStateMatrix(), veloc0, omega0, collision1, body1->GetStateMatrix(), veloc1, omega1,
 																			   timeToImpact, points, normals, penetrations, attrib0, attrib1, 6, 0);
 
 						for (dgInt32 j = 0; j < ccdContactCount; j++) {
@@ -716,10 +858,11 @@ dgInt32 dgWorldDynamicUpdate::SortClusters(const dgBodyCluster* const cluster, d
 	const dgInt32 bodyCount = cluster->m_bodyCount;
 	const dgInt32 jointCount = cluster->m_jointCount;
 
-	dgJointInfo* const tmpInfoList = dgAlloca(dgJointInfo, cluster->m_jointCount);
-	dgJointInfo** queueBuffer = dgAlloca(dgJointInfo*, cluster->m_jointCount * 2 + 1024 * 8);
-	dgBodyJacobianPair* const bodyJoint = dgAlloca (dgBodyJacobianPair, cluster->m_jointCount * 2);
-	dgInt32* const bodyJointList = dgAlloca (dgInt32, bodyCount + 1);
+	dgFrameArenaScope scratchScope (world->m_frameArena, threadID);
+	dgJointInfo* const tmpInfoList = dgFrameAlloca(world->m_frameArena, dgJointInfo, cluster->m_jointCount, threadID);
+	dgJointInfo** queueBuffer = dgFrameAlloca(world->m_frameArena, dgJointInfo*, cluster->m_jointCount * 2 + 1024 * 8, threadID);
+	dgBodyJacobianPair* const bodyJoint = dgFrameAlloca(world->m_frameArena, dgBodyJacobianPair, cluster->m_jointCount * 2, threadID);
+	dgInt32* const bodyJointList = dgFrameAlloca(world->m_frameArena, dgInt32, bodyCount + 1, threadID);
 
 	dgQueue<dgJointInfo*> queue(queueBuffer, cluster->m_jointCount * 2 + 1024 * 8);
 	dgFloat32 heaviestMass = dgFloat32(1.0e20f);
@@ -1095,7 +1238,7 @@ void dgWorldDynamicUpdate::BuildJacobianMatrix(dgBodyCluster* const cluster, dgI
 	dgJacobian* const internalForces = &m_solverMemory.m_internalForcesBuffer[cluster->m_bodyStart];
 
 	dgAssert(((dgDynamicBody*)bodyArray[0].m_body)->IsRTTIType(dgBody::m_dynamicBodyRTTI));
-	dgAssert((((dgDynamicBody*)bodyArray[0].m_body)->m_accel.DotProduct(((dgDynamicBody*)bodyArray[0].m_body)->m_accel)).GetScalar() == dgFloat32(0.0f));
+	dgAssert((((dgDynamicBody*)bodyArray[0].m_body)->GetStateAccel().DotProduct(((dgDynamicBody*)bodyArray[0].m_body)->GetStateAccel())).GetScalar() == dgFloat32(0.0f));
 	dgAssert((((dgDynamicBody*)bodyArray[0].m_body)->m_alpha.DotProduct(((dgDynamicBody*)bodyArray[0].m_body)->m_alpha)).GetScalar() == dgFloat32(0.0f));
 	dgAssert((((dgDynamicBody*)bodyArray[0].m_body)->m_externalForce.DotProduct(((dgDynamicBody*)bodyArray[0].m_body)->m_externalForce)).GetScalar() == dgFloat32(0.0f));
 	dgAssert((((dgDynamicBody*)bodyArray[0].m_body)->m_externalTorque.DotProduct(((dgDynamicBody*)bodyArray[0].m_body)->m_externalTorque)).GetScalar() == dgFloat32(0.0f));
@@ -1114,8 +1257,8 @@ void dgWorldDynamicUpdate::BuildJacobianMatrix(dgBodyCluster* const cluster, dgI
 			}
 
 			// re use these variables for temp storage 
-			body->m_accel = body->m_veloc;
-			body->m_alpha = body->m_omega;
+			body->GetStateAccel() = body->GetStateVeloc();
+			body->m_alpha = body->GetStateOmega();
 
 			internalForces[i].m_linear = dgVector::m_zero;
 			internalForces[i].m_angular = dgVector::m_zero;
@@ -1131,8 +1274,8 @@ void dgWorldDynamicUpdate::BuildJacobianMatrix(dgBodyCluster* const cluster, dgI
 			}
 
 			// re use these variables for temp storage 
-			body->m_accel = body->m_veloc;
-			body->m_alpha = body->m_omega;
+			body->GetStateAccel() = body->GetStateVeloc();
+			body->m_alpha = body->GetStateOmega();
 
 			internalForces[i].m_linear = dgVector::m_zero;
 			internalForces[i].m_angular = dgVector::m_zero;
@@ -1209,21 +1352,24 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 		dgAssert(body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body->IsRTTIType(dgBody::m_kinematicBody));
 
 		body->m_equilibrium = 1;
-		dgVector isMovingMask(body->m_veloc + body->m_omega + body->m_accel + body->m_alpha);
+		dgVector& bodyVeloc = body->GetStateVeloc();
+		dgVector& bodyOmega = body->GetStateOmega();
+		const dgVector& bodyAccel = body->GetStateAccel();
+		dgVector isMovingMask(bodyVeloc + bodyOmega + bodyAccel + body->m_alpha);
 		if ((isMovingMask.TestZero().GetSignMask() & 7) != 7) {
 			dgAssert(body->m_invMass.m_w);
 			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
 				body->IntegrateVelocity(timestep);
 			}
 
-			dgAssert(body->m_accel.m_w == dgFloat32(0.0f));
+			dgAssert(bodyAccel.m_w == dgFloat32(0.0f));
 			dgAssert(body->m_alpha.m_w == dgFloat32(0.0f));
-			dgAssert(body->m_veloc.m_w == dgFloat32(0.0f));
-			dgAssert(body->m_omega.m_w == dgFloat32(0.0f));
-			dgFloat32 accel2 = body->m_accel.DotProduct(body->m_accel).GetScalar();
+			dgAssert(bodyVeloc.m_w == dgFloat32(0.0f));
+			dgAssert(bodyOmega.m_w == dgFloat32(0.0f));
+			dgFloat32 accel2 = bodyAccel.DotProduct(bodyAccel).GetScalar();
 			dgFloat32 alpha2 = body->m_alpha.DotProduct(body->m_alpha).GetScalar();
-			dgFloat32 speed2 = body->m_veloc.DotProduct(body->m_veloc).GetScalar();
-			dgFloat32 omega2 = body->m_omega.DotProduct(body->m_omega).GetScalar();
+			dgFloat32 speed2 = bodyVeloc.DotProduct(bodyVeloc).GetScalar();
+			dgFloat32 omega2 = bodyOmega.DotProduct(bodyOmega).GetScalar();
 
 			maxAccel = dgMax(maxAccel, accel2);
 			maxAlpha = dgMax(maxAlpha, alpha2);
@@ -1231,10 +1377,10 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 			maxOmega = dgMax(maxOmega, omega2);
 			bool equilibrium = (accel2 < accelFreeze) && (alpha2 < accelFreeze) && (speed2 < speedFreeze) && (omega2 < speedFreeze);
 			if (equilibrium) {
-				dgVector veloc(body->m_veloc * velocDragVect);
-				dgVector omega(body->m_omega * velocDragVect);
-				body->m_veloc = (veloc.DotProduct(veloc) > m_velocTol) & veloc;
-				body->m_omega = (omega.DotProduct(omega) > m_velocTol) & omega;
+				dgVector veloc(bodyVeloc * velocDragVect);
+				dgVector omega(bodyOmega * velocDragVect);
+				bodyVeloc = (veloc.DotProduct(veloc) > m_velocTol) & veloc;
+				bodyOmega = (omega.DotProduct(omega) > m_velocTol) & omega;
 			}
 
 			body->m_equilibrium = equilibrium ? 1 : 0;
@@ -1257,10 +1403,10 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 			for (dgInt32 i = 0; i < count; i++) {
 				dgBody* const body = bodyArray[i].m_body;
 				dgAssert(body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
-				body->m_accel = dgVector::m_zero;
+				body->GetStateAccel() = dgVector::m_zero;
 				body->m_alpha = dgVector::m_zero;
-				body->m_veloc = dgVector::m_zero;
-				body->m_omega = dgVector::m_zero;
+				body->GetStateVeloc() = dgVector::m_zero;
+				body->GetStateOmega() = dgVector::m_zero;
 				body->m_sleeping = body->m_autoSleep;
 			}
 		} else {
@@ -1295,10 +1441,10 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 				if (state1) {
 					for (dgInt32 i = 0; i < count; i++) {
 						dgBody* const body = bodyArray[i].m_body;
-						body->m_accel = dgVector::m_zero;
+						body->GetStateAccel() = dgVector::m_zero;
 						body->m_alpha = dgVector::m_zero;
-						body->m_veloc = dgVector::m_zero;
-						body->m_omega = dgVector::m_zero;
+						body->GetStateVeloc() = dgVector::m_zero;
+						body->GetStateOmega() = dgVector::m_zero;
 						body->m_sleeping = body->m_autoSleep;
 						if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
 							dgDynamicBody* const dynBody = (dgDynamicBody*)body;
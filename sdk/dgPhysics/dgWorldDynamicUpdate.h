@@ -36,6 +36,9 @@
 #define	DG_PSD_DAMP_TOL					dgFloat32 (1.0e-3f)
 #define	DG_SOLVER_MAX_ERROR				(DG_FREEZE_MAG * dgFloat32 (0.5f))
 
+#define DG_PARALLEL_JOINT_GRAIN_SIZE	64
+#define DG_PARALLEL_CLUSTER_GRAIN_SIZE	64
+
 
 // the solver is a RK order 4, but instead of weighting the intermediate derivative by the usual 1/6, 1/3, 1/3, 1/6 coefficients
 // I am using 1/4, 1/4, 1/4, 1/4.
@@ -53,6 +56,7 @@
 class dgBody;
 class dgDynamicBody;
 class dgWorldDynamicUpdateSyncDescriptor;
+class dgClusterBuildDescriptor;
 
 
 class dgClusterCallbackStruct
@@ -235,6 +239,12 @@ class dgWorldDynamicUpdate
 
 	void BuildClustersOld(dgFloat32 timestep);
 	void BuildClusters(dgFloat32 timestep);
+	static void UnionSetsKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void FlattenSetsKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void CountSetJointsKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void ClusterBlockSumKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void ClusterBlockStartKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
+	static void BuildClusterArraysKernel (void* const context, dgInt32 start, dgInt32 end, dgInt32 threadID);
 
 	dgBodyCluster MergeClusters(const dgBodyCluster* const clusterArray, dgInt32 clustersCount) const;
 	dgInt32 SortClusters(const dgBodyCluster* const cluster, dgFloat32 timestep, dgInt32 threadID) const;
@@ -159,9 +159,10 @@ void dgParallelBodySolver::CalculateJointForces(const dgBodyCluster& cluster, dg
 	m_threadCounts = m_world->GetThreadCount();
 	m_jointCount = ((m_cluster->m_jointCount + DG_WORK_GROUP_SIZE - 1) & -dgInt32(DG_WORK_GROUP_SIZE - 1)) / DG_WORK_GROUP_SIZE;
 
-	m_soaRowStart = dgAlloca(dgInt32, m_jointCount);
-	m_bodyProxyArray = dgAlloca(dgBodyProxy, cluster.m_bodyCount);
-	m_bodyJacobiansPairs = dgAlloca (dgBodyJacobianPair, cluster.m_jointCount * 2);
+	dgFrameArenaScope scratchScope (m_world->m_frameArena, 0);
+	m_soaRowStart = dgFrameAlloca(m_world->m_frameArena, dgInt32, m_jointCount, 0);
+	m_bodyProxyArray = dgFrameAlloca(m_world->m_frameArena, dgBodyProxy, cluster.m_bodyCount, 0);
+	m_bodyJacobiansPairs = dgFrameAlloca(m_world->m_frameArena, dgBodyJacobianPair, cluster.m_jointCount * 2, 0);
 
 	InitWeights();
 	InitBodyArray();
@@ -268,6 +269,7 @@ void dgParallelBodySolver::InitWeights()
 
 void dgParallelBodySolver::InitBodyArray()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(InitBodyArrayKernel, this, NULL, "dgParallelBodySolver::InitBodyArray");
 	}
@@ -301,6 +303,7 @@ DG_INLINE void dgParallelBodySolver::SortWorkGroup(dgInt32 base) const
 void dgParallelBodySolver::InitJacobianMatrix()
 {
 	m_jacobianMatrixRowAtomicIndex = 0;
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(InitJacobianMatrixKernel, this, NULL, "dgParallelBodySolver::InitJacobianMatrix");
 	}
@@ -316,6 +319,7 @@ void dgParallelBodySolver::InitJacobianMatrix()
 		bodyProxyArray[index].m_jointStart = i;
 	}
 
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(InitInternalForcesKernel, this, NULL, "dgParallelBodySolver::InitInternalForces");
 	}
@@ -351,6 +355,7 @@ void dgParallelBodySolver::InitJacobianMatrix()
 	m_massMatrix.ResizeIfNecessary(size);
 
 	m_soaRowsCount = 0;
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(TransposeMassMatrixKernel, this, NULL, "dgParallelBodySolver::TransposeMassMatrix");
 	}
@@ -359,12 +364,14 @@ void dgParallelBodySolver::InitJacobianMatrix()
 
 void dgParallelBodySolver::CalculateJointsAcceleration()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(CalculateJointsAccelerationKernel, this, NULL, "dgParallelBodySolver::CalculateJointsAcceleration");
 	}
 	m_world->SynchronizationBarrier();
 	m_firstPassCoef = dgFloat32(1.0f);
 
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(UpdateRowAccelerationKernel, this, NULL, "dgParallelBodySolver::UpdateRowAcceleration");
 	}
@@ -373,6 +380,7 @@ void dgParallelBodySolver::CalculateJointsAcceleration()
 
 void dgParallelBodySolver::CalculateBodiesAcceleration()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(CalculateBodiesAccelerationKernel, this, NULL, "dgParallelBodySolver::CalculateBodiesAcceleration");
 	}
@@ -382,7 +390,9 @@ void dgParallelBodySolver::CalculateBodiesAcceleration()
 
 void dgParallelBodySolver::CalculateJointsForce()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
+		m_accelNorm[i] = dgFloat32(0.0f);
 		m_world->QueueJob(CalculateJointsForceKernel, this, NULL, "dgParallelBodySolver::CalculateJointsForce");
 	}
 	m_world->SynchronizationBarrier();
@@ -390,6 +400,7 @@ void dgParallelBodySolver::CalculateJointsForce()
 
 void dgParallelBodySolver::CalculateBodyForce()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(CalculateBodyForceKernel, this, NULL, "dgParallelBodySolver::CalculateBodyForce");
 	}
@@ -402,6 +413,7 @@ void dgParallelBodySolver::CalculateBodyForce()
 
 void dgParallelBodySolver::IntegrateBodiesVelocity()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(IntegrateBodiesVelocityKernel, this, NULL, "dgParallelBodySolver::IntegrateBodiesVelocity");
 	}
@@ -411,7 +423,9 @@ void dgParallelBodySolver::IntegrateBodiesVelocity()
 
 void dgParallelBodySolver::UpdateForceFeedback()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
+		m_hasJointFeeback[i] = 0;
 		m_world->QueueJob(UpdateForceFeedbackKernel, this, NULL, "dgParallelBodySolver::UpdateForceFeedback");
 	}
 	m_world->SynchronizationBarrier();
@@ -419,6 +433,7 @@ void dgParallelBodySolver::UpdateForceFeedback()
 
 void dgParallelBodySolver::UpdateKinematicFeedback()
 {
+	m_atomicIndex = 0;
 	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		m_world->QueueJob(UpdateKinematicFeedbackKernel, this, NULL, "dgParallelBodySolver::UpdateKinematicFeedback");
 	}
@@ -430,16 +445,15 @@ void dgParallelBodySolver::InitBodyArray(dgInt32 threadID)
 	const dgBodyInfo* const bodyArray = m_bodyArray;
 	dgBodyProxy* const bodyProxyArray = m_bodyProxyArray;
 
-	const dgInt32 step = m_threadCounts;;
 	const dgInt32 bodyCount = m_cluster->m_bodyCount;
-	for (dgInt32 i = threadID; i < bodyCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		const dgBodyInfo* const bodyInfo = &bodyArray[i];
 		dgBody* const body = (dgDynamicBody*)bodyInfo->m_body;
 		body->AddDampingAcceleration(m_timestep);
 		body->CalcInvInertiaMatrix();
 
-		body->m_accel = body->m_veloc;
-		body->m_alpha = body->m_omega;
+		body->GetStateAccel() = body->GetStateVeloc();
+		body->m_alpha = body->GetStateOmega();
 
 		const dgFloat32 w = bodyProxyArray[i].m_weight ? bodyProxyArray[i].m_weight : dgFloat32(1.0f);
 		bodyProxyArray[i].m_weight = w;
@@ -456,9 +470,8 @@ void dgParallelBodySolver::CalculateJointsAcceleration(dgInt32 threadID)
 	dgRightHandSide* const rightHandSide = &m_world->m_solverMemory.m_righHandSizeBuffer[0];
 	const dgLeftHandSide* const leftHandSide = &m_world->m_solverMemory.m_leftHandSizeBuffer[0];
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_cluster->m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgJointInfo* const jointInfo = &m_jointArray[i];
 		dgConstraint* const constraint = jointInfo->m_joint;
 		const dgInt32 pairStart = jointInfo->m_pairStart;
@@ -660,9 +673,8 @@ void dgParallelBodySolver::CalculateJointsForce(dgInt32 threadID)
 	dgSolverSoaElement* const massMatrix = &m_massMatrix[0];
 	dgFloat32 accNorm = dgFloat32(0.0f);
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		const dgInt32 rowStart = soaRowStart[i];
 		dgJointInfo* const jointInfo = &m_jointArray[i * DG_WORK_GROUP_SIZE];
 
@@ -693,7 +705,7 @@ void dgParallelBodySolver::CalculateJointsForce(dgInt32 threadID)
 		}
 		accNorm += accel2;
 	}
-	m_accelNorm[threadID] = accNorm;
+	m_accelNorm[threadID] += accNorm;
 }
 
 void dgParallelBodySolver::UpdateRowAcceleration(dgInt32 threadID)
@@ -704,9 +716,8 @@ void dgParallelBodySolver::UpdateRowAcceleration(dgInt32 threadID)
 	const dgInt32* const soaRowStart = m_soaRowStart;
 	const dgJointInfo* const jointInfoArray = m_jointArray;
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		const dgInt32 rowStart = soaRowStart[i];
 		const dgJointInfo* const jointInfoBase = &jointInfoArray[i * DG_WORK_GROUP_SIZE];
 
@@ -732,9 +743,8 @@ void dgParallelBodySolver::CalculateBodyForce(dgInt32 threadID)
 	const dgRightHandSide* const rightHandSide = &m_world->m_solverMemory.m_righHandSizeBuffer[0];
 	const dgWorkGroupFloat* const leftHandSide = (dgWorkGroupFloat*)&m_world->m_solverMemory.m_leftHandSizeBuffer[0].m_Jt.m_jacobianM0;
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 bodyCount = m_cluster->m_bodyCount;
-	for (dgInt32 i = threadID; i < bodyCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgWorkGroupFloat forceAcc(dgVector::m_zero);
 
 		const dgBodyProxy* const startJoints = &bodyProxyArray[i];
@@ -766,9 +776,8 @@ void dgParallelBodySolver::InitInternalForces(dgInt32 threadID)
 	const dgRightHandSide* const rightHandSide = &m_world->m_solverMemory.m_righHandSizeBuffer[0];
 	const dgWorkGroupFloat* const leftHandSide = (dgWorkGroupFloat*)&m_world->m_solverMemory.m_leftHandSizeBuffer[0].m_Jt.m_jacobianM0;
 
-	const dgInt32 step = m_threadCounts;;
 	const dgInt32 bodyCount = m_cluster->m_bodyCount;
-	for (dgInt32 i = threadID; i < bodyCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgWorkGroupFloat forceAcc(dgVector::m_zero);
 		
 		const dgBodyProxy* const startJoints = &bodyProxyArray[i];
@@ -802,9 +811,8 @@ void dgParallelBodySolver::IntegrateBodiesVelocity(dgInt32 threadID)
 	const dgBodyProxy* const bodyProxyArray = m_bodyProxyArray;
 	dgJacobian* const internalForces = &m_world->m_solverMemory.m_internalForcesBuffer[0];
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 bodyCount = m_cluster->m_bodyCount;
-	for (dgInt32 i = threadID; i < bodyCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgDynamicBody* const body = (dgDynamicBody*)m_bodyArray[i].m_body;
 		dgAssert(body->m_index == i);
 
@@ -818,8 +826,8 @@ void dgParallelBodySolver::IntegrateBodiesVelocity(dgInt32 threadID)
 			const dgVector omegaStep((body->m_invWorldInertiaMatrix.RotateVector(torque)) * timestep4);
 
 			if (!body->m_resting) {
-				body->m_veloc += velocStep;
-				body->m_omega += omegaStep;
+				body->GetStateVeloc() += velocStep;
+				body->GetStateOmega() += omegaStep;
 			} else {
 				const dgVector velocStep2(velocStep.DotProduct(velocStep));
 				const dgVector omegaStep2(omegaStep.DotProduct(omegaStep));
@@ -827,8 +835,8 @@ void dgParallelBodySolver::IntegrateBodiesVelocity(dgInt32 threadID)
 				const dgInt32 equilibrium = test.GetSignMask() ? 0 : 1;
 				body->m_resting &= equilibrium;
 			}
-			dgAssert(body->m_veloc.m_w == dgFloat32(0.0f));
-			dgAssert(body->m_omega.m_w == dgFloat32(0.0f));
+			dgAssert(body->GetStateVeloc().m_w == dgFloat32(0.0f));
+			dgAssert(body->GetStateOmega().m_w == dgFloat32(0.0f));
 		}
 	}
 }
@@ -838,9 +846,8 @@ void dgParallelBodySolver::CalculateBodiesAcceleration(dgInt32 threadID)
 	dgVector invTime(m_invTimestep);
 	dgFloat32 maxAccNorm2 = DG_SOLVER_MAX_ERROR * DG_SOLVER_MAX_ERROR;
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 bodyCount = m_cluster->m_bodyCount;
-	for (dgInt32 i = threadID; i < bodyCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < bodyCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgDynamicBody* const body = (dgDynamicBody*)m_bodyArray[i].m_body;
 		m_world->CalculateNetAcceleration(body, invTime, maxAccNorm2);
 	}
@@ -851,9 +858,8 @@ void dgParallelBodySolver::UpdateForceFeedback(dgInt32 threadID)
 	const dgRightHandSide* const rightHandSide = &m_world->m_solverMemory.m_righHandSizeBuffer[0];
 	dgInt32 hasJointFeeback = 0;
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_cluster->m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgJointInfo* const jointInfo = &m_jointArray[i];
 		dgConstraint* const constraint = jointInfo->m_joint;
 		const dgInt32 first = jointInfo->m_pairStart;
@@ -867,15 +873,14 @@ void dgParallelBodySolver::UpdateForceFeedback(dgInt32 threadID)
 		}
 		hasJointFeeback |= (constraint->m_updaFeedbackCallback ? 1 : 0);
 	}
-	m_hasJointFeeback[threadID] = hasJointFeeback;
+	m_hasJointFeeback[threadID] |= hasJointFeeback;
 }
 
 
 void dgParallelBodySolver::UpdateKinematicFeedback(dgInt32 threadID)
 {
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_cluster->m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgJointInfo* const jointInfo = &m_jointArray[i];
 		if (jointInfo->m_joint->m_updaFeedbackCallback) {
 			jointInfo->m_joint->m_updaFeedbackCallback(*jointInfo->m_joint, m_timestep, threadID);
@@ -969,9 +974,8 @@ void dgParallelBodySolver::InitJacobianMatrix(dgInt32 threadID)
 	constraintParams.m_timestep = m_timestep;
 	constraintParams.m_invTimestep = m_invTimestep;
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_cluster->m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		dgJointInfo* const jointInfo = &m_jointArray[i];
 		dgConstraint* const constraint = jointInfo->m_joint;
 		dgAssert(jointInfo->m_m0 >= 0);
@@ -1095,9 +1099,8 @@ void dgParallelBodySolver::TransposeMassMatrix(dgInt32 threadID)
 	const dgJointInfo* const jointInfoArray = m_jointArray;
 	dgSolverSoaElement* const massMatrixArray = &m_massMatrix[0];
 
-	const dgInt32 step = m_threadCounts;
 	const dgInt32 jointCount = m_jointCount;
-	for (dgInt32 i = threadID; i < jointCount; i += step) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1); i < jointCount; i = dgAtomicExchangeAndAdd(&m_atomicIndex, 1)) {
 		const dgInt32 index = i * DG_WORK_GROUP_SIZE;
 		const dgInt32 rowCount = jointInfoArray[index].m_pairCount;
 		const dgInt32 rowSoaStart = dgAtomicExchangeAndAdd(&m_soaRowsCount, rowCount);
@@ -1123,7 +1126,7 @@ void dgParallelBodySolver::CalculateForces()
 			CalculateBodyForce();
 			accNorm = dgFloat32(0.0f);
 			for (dgInt32 i = 0; i < threadCounts; i++) {
-				accNorm = dgMax(accNorm, m_accelNorm[i]);
+				accNorm += m_accelNorm[i];
 			}
 		}
 		IntegrateBodiesVelocity();
@@ -1132,7 +1135,7 @@ void dgParallelBodySolver::CalculateForces()
 	UpdateForceFeedback();
 
 	dgInt32 hasJointFeeback = 0;
-	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i++) {
+	for (dgInt32 i = 0; i < m_threadCounts; i++) {
 		hasJointFeeback |= m_hasJointFeeback[i];
 	}
 	CalculateBodiesAcceleration();
@@ -308,6 +308,7 @@ class dgParallelBodySolver
 
 	dgInt32 m_jointCount;
 	dgInt32 m_jacobianMatrixRowAtomicIndex;
+	dgInt32 m_atomicIndex;
 	dgInt32 m_solverPasses;
 	dgInt32 m_threadCounts;
 	dgInt32 m_soaRowsCount;
@@ -333,6 +334,7 @@ DG_INLINE dgParallelBodySolver::dgParallelBodySolver(dgMemoryAllocator* const al
 	,m_firstPassCoef(dgFloat32(0.0f))
 	,m_jointCount(0)
 	,m_jacobianMatrixRowAtomicIndex(0)
+	,m_atomicIndex(0)
 	,m_solverPasses(0)
 	,m_threadCounts(0)
 	,m_soaRowsCount(0)
@@ -55,7 +55,7 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 			dgVector zero(dgVector::m_zero);
 			for (dgInt32 i = 1; i < cluster->m_bodyCount; i++) {
 				dgDynamicBody* const body = (dgDynamicBody*)bodyArray[i].m_body;
-				body->m_accel = zero;
+				body->GetStateAccel() = zero;
 				body->m_alpha = zero;
 			}
 		}
@@ -88,10 +88,13 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 			if (body->IsRTTIType (dgBody::m_dynamicBodyRTTI)) {
 				dgAssert (body->m_invMass.m_w);
 
-				const dgFloat32 accel2 = body->m_accel.DotProduct(body->m_accel).GetScalar();
+				dgVector& bodyVeloc = body->GetStateVeloc();
+				dgVector& bodyOmega = body->GetStateOmega();
+				const dgVector& bodyAccel = body->GetStateAccel();
+				const dgFloat32 accel2 = bodyAccel.DotProduct(bodyAccel).GetScalar();
 				const dgFloat32 alpha2 = body->m_alpha.DotProduct(body->m_alpha).GetScalar();
-				const dgFloat32 speed2 = body->m_veloc.DotProduct(body->m_veloc).GetScalar();
-				const dgFloat32 omega2 = body->m_omega.DotProduct(body->m_omega).GetScalar();
+				const dgFloat32 speed2 = bodyVeloc.DotProduct(bodyVeloc).GetScalar();
+				const dgFloat32 omega2 = bodyOmega.DotProduct(bodyOmega).GetScalar();
 
 				maxAccel = dgMax (maxAccel, accel2);
 				maxAlpha = dgMax (maxAlpha, alpha2);
@@ -100,10 +103,10 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 
 				bool equilibrium = (accel2 < accelFreeze) && (alpha2 < accelFreeze) && (speed2 < speedFreeze) && (omega2 < speedFreeze);
 				if (equilibrium) {
-					dgVector veloc (body->m_veloc * forceDampVect);
-					dgVector omega = body->m_omega * forceDampVect;
-					body->m_veloc = (veloc.DotProduct(veloc) > m_velocTol) & veloc;
-					body->m_omega = (omega.DotProduct(omega) > m_velocTol) & omega;
+					dgVector veloc (bodyVeloc * forceDampVect);
+					dgVector omega = bodyOmega * forceDampVect;
+					bodyVeloc = (veloc.DotProduct(veloc) > m_velocTol) & veloc;
+					bodyOmega = (omega.DotProduct(omega) > m_velocTol) & omega;
 
 				}
 				body->m_equilibrium = equilibrium ? 1 : 0;
@@ -113,7 +116,7 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 				sleepCounter = dgMin (sleepCounter, body->m_sleepingCounter);
 			}
 			// clear accel and angular acceleration
-			body->m_accel = dgVector::m_zero;
+			body->GetStateAccel() = dgVector::m_zero;
 			body->m_alpha = dgVector::m_zero;
 		}
 
@@ -123,10 +126,10 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 				for (dgInt32 i = 1; i < bodyCount; i ++) {
 					dgBody* const body = bodyArray[i].m_body;
 					dgAssert (body->IsRTTIType (dgBody::m_dynamicBodyRTTI) || body->IsRTTIType (dgBody::m_kinematicBodyRTTI));
-					body->m_accel = dgVector::m_zero;
+					body->GetStateAccel() = dgVector::m_zero;
 					body->m_alpha = dgVector::m_zero;
-					body->m_veloc = dgVector::m_zero;
-					body->m_omega = dgVector::m_zero;
+					body->GetStateVeloc() = dgVector::m_zero;
+					body->GetStateOmega() = dgVector::m_zero;
 				}
 			} else {
 				// cluster is not sleeping but may be resting with small residual velocity for a long time
@@ -160,10 +163,10 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 						for (dgInt32 i = 1; i < bodyCount; i ++) {
 							dgBody* const body = bodyArray[i].m_body;
 							dgAssert (body->IsRTTIType (dgBody::m_dynamicBodyRTTI) || body->IsRTTIType (dgBody::m_kinematicBodyRTTI));
-							body->m_accel = dgVector::m_zero;
+							body->GetStateAccel() = dgVector::m_zero;
 							body->m_alpha = dgVector::m_zero;
-							body->m_veloc = dgVector::m_zero;
-							body->m_omega = dgVector::m_zero;
+							body->GetStateVeloc() = dgVector::m_zero;
+							body->GetStateOmega() = dgVector::m_zero;
 							body->m_equilibrium = 1;
 						}
 					} else {
@@ -253,17 +256,16 @@ void dgWorldDynamicUpdate::ResolveClusterForces(dgBodyCluster* const cluster, dg
 									const dgBody* const body0 = contact->m_body0;
 									const dgBody* const body1 = contact->m_body1;
 
-									const dgVector& veloc0 = body0->m_veloc;
-									const dgVector& veloc1 = body1->m_veloc;
+									const dgVector& veloc0 = body0->GetStateVeloc();
+									const dgVector& veloc1 = body1->GetStateVeloc();
 
-									const dgVector& omega0 = body0->m_omega;
-									const dgVector& omega1 = body1->m_omega;
+									const dgVector& omega0 = body0->GetStateOmega();
+									const dgVector& omega1 = body1->GetStateOmega();
 
 									const dgVector& com0 = body0->m_globalCentreOfMass;
 									const dgVector& com1 = body1->m_globalCentreOfMass;
 									
-									for (dgList<dgContactMaterial>::dgListNode* node = contact->GetFirst(); node; node = node->GetNext()) {
-										const dgContactMaterial* const contactMaterial = &node->GetInfo();
+									for (const dgContactMaterial* contactMaterial = contact->GetFirstContact(); contactMaterial; contactMaterial = contact->GetNextContact(contactMaterial)) {
 										dgVector vel0 (veloc0 + omega0.CrossProduct(contactMaterial->m_point - com0));
 										dgVector vel1 (veloc1 + omega1.CrossProduct(contactMaterial->m_point - com1));
 										dgVector vRel (vel0 - vel1);
@@ -359,13 +361,13 @@ void dgWorldDynamicUpdate::CalculateNetAcceleration(dgBody* const body, const dg
 {
 	dgAssert(body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
 	// the initial velocity and angular velocity were stored in m_accel and body->m_alpha for memory saving
-	dgVector accel (invTimeStep * (body->m_veloc - body->m_accel));
-	dgVector alpha (invTimeStep * (body->m_omega - body->m_alpha));
+	dgVector accel (invTimeStep * (body->GetStateVeloc() - body->GetStateAccel()));
+	dgVector alpha (invTimeStep * (body->GetStateOmega() - body->m_alpha));
 	dgVector accelTest((accel.DotProduct(accel) > maxAccNorm2) | (alpha.DotProduct(alpha) > maxAccNorm2));
 	accel = accel & accelTest;
 	alpha = alpha & accelTest;
 
-	body->m_accel = accel;
+	body->GetStateAccel() = accel;
 	body->m_alpha = alpha;
 }
 
@@ -591,7 +593,7 @@ dgJacobian dgWorldDynamicUpdate::IntegrateForceAndToque(dgDynamicBody* const bod
 #ifdef DG_TEST_GYRO
 	dgVector dtHalf(timestep * dgVector::m_half);
 	dgMatrix matrix(body->m_gyroRotation, dgVector::m_wOne);
-	dgVector localOmega(matrix.UnrotateVector(body->m_omega));
+	dgVector localOmega(matrix.UnrotateVector(body->GetStateOmega()));
 	dgVector localTorque(matrix.UnrotateVector(torque));
 
 	// and solving for alpha we get the angular acceleration at t + dt
@@ -773,8 +775,8 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 					const dgVector torque(internalForces[i].m_angular + body->m_externalTorque - body->m_gyroTorque);
 					dgJacobian velocStep(IntegrateForceAndToque(body, force, torque, timestep4));
 					if (!body->m_resting) {
-						body->m_veloc += velocStep.m_linear;
-						body->m_omega += velocStep.m_angular;
+						body->GetStateVeloc() += velocStep.m_linear;
+						body->GetStateOmega() += velocStep.m_angular;
 					} else {
 						const dgVector velocStep2(velocStep.m_linear.DotProduct(velocStep.m_linear));
 						const dgVector omegaStep2(velocStep.m_angular.DotProduct(velocStep.m_angular));
@@ -783,8 +785,8 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 						body->m_resting &= equilibrium;
 					}
 
-					dgAssert(body->m_veloc.m_w == dgFloat32(0.0f));
-					dgAssert(body->m_omega.m_w == dgFloat32(0.0f));
+					dgAssert(body->GetStateVeloc().m_w == dgFloat32(0.0f));
+					dgAssert(body->GetStateOmega().m_w == dgFloat32(0.0f));
 				}
 			}
 		} else {
@@ -793,8 +795,8 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 				const dgVector& linearMomentum = internalForces[i].m_linear;
 				const dgVector& angularMomentum = internalForces[i].m_angular;
 
-				body->m_veloc += linearMomentum.Scale(body->m_invMass.m_w);
-				body->m_omega += body->m_invWorldInertiaMatrix.RotateVector(angularMomentum);
+				body->GetStateVeloc() += linearMomentum.Scale(body->m_invMass.m_w);
+				body->GetStateOmega() += body->m_invWorldInertiaMatrix.RotateVector(angularMomentum);
 			}
 		}
 	}
@@ -837,7 +839,7 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 		for (dgInt32 i = 1; i < bodyCount; i++) {
 			dgBody* const body = bodyArray[i].m_body;
 			dgAssert(body->IsRTTIType(dgBody::m_dynamicBodyRTTI) || body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
-			body->m_accel = dgVector::m_zero;
+			body->GetStateAccel() = dgVector::m_zero;
 			body->m_alpha = dgVector::m_zero;
 		}
 	}
@@ -0,0 +1,110 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+* 
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* 
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+// Avx512 build of the soa solver in sdk/dgNewtonAvx512, linked into the engine as a static plugin.
+// the solver source is compiled inside its own namespace so that each instruction set gets 
+// its own dgSolver and dgSoaFloat classes, and only that code is generated for the target isa,
+// so the rest of the engine still runs on cpus without it.
+
+#include "dgPhysicsStdafx.h"
+#include "dgBody.h"
+#include "dgWorld.h"
+#include "dgConstraint.h"
+#include "dgDynamicBody.h"
+#include "dgWorldPlugins.h"
+#include "dgWorldDynamicUpdate.h"
+#include "dgWorldDynamicsParallelSolver.h"
+
+#ifdef DG_USE_STATIC_SOLVER_PLUGINS
+
+#include <immintrin.h>
+#include "../dgNewtonAvx512/dgNewtonPluginStdafx.h"
+
+#if defined (__clang__)
+	#pragma clang attribute push (__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+#elif defined (__GNUC__)
+	#pragma GCC push_options
+	#pragma GCC target ("avx512f,avx2,fma")
+#endif
+
+namespace dgSolverAvx512
+{
+	#include "../dgNewtonAvx512/dgSolver.cpp"
+
+	DG_MSC_AVX512_ALIGMENT
+	class dgStaticPlugin: public dgWorldPlugin, public dgSolver
+	{
+		public:
+		dgStaticPlugin(dgWorld* const world, dgMemoryAllocator* const allocator, dgInt32 score)
+			:dgWorldPlugin(world, allocator)
+			,dgSolver(world, allocator)
+			,m_score(score)
+		{
+		}
+
+		virtual const char* GetId() const
+		{
+			#ifdef _DEBUG
+				return "newtonAVX512_d";
+			#else
+				return "newtonAVX512";
+			#endif
+		}
+
+		virtual dgInt32 GetScore() const
+		{
+			return m_score;
+		}
+
+		virtual void CalculateJointForces(const dgBodyCluster& cluster, dgBodyInfo* const bodyArray, dgJointInfo* const jointArray, dgFloat32 timestep)
+		{
+			DG_TRACKTIME_NAMED(GetId());
+			dgSolver::CalculateJointForces(cluster, bodyArray, jointArray, timestep);
+		}
+
+		DG_CLASS_ALLOCATOR(allocator)
+
+		dgInt32 m_score;
+	} DG_GCC_AVX512_ALIGMENT;
+}
+
+#if defined (__clang__)
+	#pragma clang attribute pop
+#elif defined (__GNUC__)
+	#pragma GCC pop_options
+#endif
+
+dgWorldPlugin* dgCreateAvx512SolverPlugin(dgWorld* const world, dgMemoryAllocator* const allocator)
+{
+	// check for instruction set support (avx512f, avx2 and fmad3)
+	const dgUnsigned32 requiredFeatures = DG_CPU_FEATURE_AVX512F | DG_CPU_FEATURE_AVX2 | DG_CPU_FEATURE_FMA;
+	if ((dgGetCpuFeatures() & requiredFeatures) != requiredFeatures) {
+		return NULL;
+	}
+	// the soa rows are 64 bytes aligned, which 32 bit builds of the allocator do not guarantee
+	if (DG_MEMORY_GRANULARITY < DG_VECTOR_AVX512_SIZE) {
+		return NULL;
+	}
+	return new (allocator) dgSolverAvx512::dgStaticPlugin(world, allocator, dgIsIntelCpu() ? 5 : 4);
+}
+
+#endif
@@ -23,7 +23,10 @@
 #include "dgWorld.h"
 #include "dgWorldPlugins.h"
 
-
+#if (defined (_POSIX_VER) || defined (_POSIX_VER_64) || defined (_MACOSX_VER))
+	#include <dlfcn.h>
+	#include <dirent.h>
+#endif
 	
 
 dgWorldPluginList::dgWorldPluginList(dgMemoryAllocator* const allocator)
@@ -38,13 +41,45 @@ dgWorldPluginList::~dgWorldPluginList()
 }
 
 
+dgWorldPluginList::dgListNode* dgWorldPluginList::AddPlugin(dgWorldPlugin* const plugin, void* const module)
+{
+	// a solver already in the list, usually one of the static plugins, is not added twice
+	for (dgListNode* node = GetFirst(); node; node = node->GetNext()) {
+		if (!strcmp(node->GetInfo().m_plugin->GetId(), plugin->GetId())) {
+			return NULL;
+		}
+	}
+
+	dgListNode* const node = Append(dgWorldPluginModulePair(plugin, module));
+	if (!m_preferedPlugin || (plugin->GetScore() > m_preferedPlugin->GetInfo().m_plugin->GetScore())) {
+		m_preferedPlugin = node;
+	}
+	return node;
+}
+
+void dgWorldPluginList::LoadStaticPlugins()
+{
+#ifdef DG_USE_STATIC_SOLVER_PLUGINS
+	dgWorld* const world = (dgWorld*) this;
+	dgMemoryAllocator* const allocator = GetAllocator();
+
+	InitPlugin staticPlugins[] = {dgCreateSseSolverPlugin, dgCreateAvxSolverPlugin, dgCreateAvx2SolverPlugin, dgCreateAvx512SolverPlugin};
+	for (dgInt32 i = 0; i < dgInt32 (sizeof (staticPlugins) / sizeof (staticPlugins[0])); i ++) {
+		// each plugin returns NULL if the cpu does not support its instruction set
+		dgWorldPlugin* const plugin = staticPlugins[i](world, allocator);
+		if (plugin && !AddPlugin(plugin, NULL)) {
+			delete plugin;
+		}
+	}
+#endif
+}
+
 void dgWorldPluginList::LoadVisualStudioPlugins(const char* const plugInPath)
 {
 #if _MSC_VER > 1700
 	char rootPathInPath[2048];
 	sprintf(rootPathInPath, "%s/*.dll", plugInPath);
 
-	dgInt32 score = 0;
 	dgWorld* const world = (dgWorld*) this;
 
 	// scan for all plugins in this folder
@@ -60,15 +95,7 @@ void dgWorldPluginList::LoadVisualStudioPlugins(const char* const plugInPath)
 				InitPlugin initModule = (InitPlugin)GetProcAddress(module, "GetPlugin");
 				if (initModule) {
 					dgWorldPlugin* const plugin = initModule(world, GetAllocator ());
-					if (plugin) {
-						dgWorldPluginModulePair entry(plugin, module);
-						dgListNode* const node = Append(entry);
-						dgInt32 pluginValue = plugin->GetScore();
-						if (pluginValue > score) {
-							score = pluginValue;
-							m_preferedPlugin = node; 
-						}
-					} else {
+					if (!(plugin && AddPlugin(plugin, module))) {
 						FreeLibrary(module);
 					}
 				} else {
@@ -83,25 +110,74 @@ void dgWorldPluginList::LoadVisualStudioPlugins(const char* const plugInPath)
 #endif	
 }
 
+void dgWorldPluginList::LoadPosixPlugins(const char* const plugInPath)
+{
+#if (defined (_POSIX_VER) || defined (_POSIX_VER_64) || defined (_MACOSX_VER))
+	char rootPathInPath[2048];
+	dgWorld* const world = (dgWorld*) this;
+
+	// scan for all plugins in this folder
+	DIR* const directory = opendir(plugInPath);
+	if (directory) {
+		for (dirent* entry = readdir(directory); entry; entry = readdir(directory)) {
+			const char* const extension = strrchr(entry->d_name, '.');
+			if (!extension || (strcmp(extension, ".so") && strcmp(extension, ".dylib"))) {
+				continue;
+			}
+
+			snprintf(rootPathInPath, sizeof (rootPathInPath), "%s/%s", plugInPath, entry->d_name);
+			void* const module = dlopen(rootPathInPath, RTLD_NOW | RTLD_LOCAL);
+
+			if (module) {
+				// get the interface function pointer to the Plug in classes
+				InitPlugin initModule = (InitPlugin)dlsym(module, "GetPlugin");
+				if (initModule) {
+					// the plugin checks the cpu instruction set and returns NULL if it can't run
+					dgWorldPlugin* const plugin = initModule(world, GetAllocator ());
+					if (!(plugin && AddPlugin(plugin, module))) {
+						dlclose(module);
+					}
+				} else {
+					dlclose(module);
+				}
+			}
+		}
+		closedir(directory);
+	}
+#endif	
+}
+
 void dgWorldPluginList::LoadPlugins(const char* const path)
 {
 #ifndef _NEWTON_USE_DOUBLE
+	UnloadPlugins();
+	LoadStaticPlugins();
 	#ifdef _MSC_VER
-		UnloadPlugins();
 		LoadVisualStudioPlugins(path);
+	#elif (defined (_POSIX_VER) || defined (_POSIX_VER_64) || defined (_MACOSX_VER))
+		LoadPosixPlugins(path);
 	#endif
+	m_currentPlugin = m_preferedPlugin;
 #endif
 }
 
 void dgWorldPluginList::UnloadPlugins()
 {
-#ifdef _MSC_VER
 	dgWorldPluginList& pluginsList = *this;
 	for (dgWorldPluginList::dgListNode* node = pluginsList.GetFirst(); node; node = node->GetNext()) {
-		HMODULE module = (HMODULE)node->GetInfo().m_module;
-		FreeLibrary(module);
-	}
+		void* const module = node->GetInfo().m_module;
+		if (!module) {
+			// static plugins are owned by the list
+			delete node->GetInfo().m_plugin;
+		} else {
+#ifdef _MSC_VER
+			FreeLibrary((HMODULE)module);
+#elif (defined (_POSIX_VER) || defined (_POSIX_VER_64) || defined (_MACOSX_VER))
+			dlclose(module);
 #endif
+		}
+	}
+	RemoveAll();
 	m_currentPlugin = NULL;
 	m_preferedPlugin = NULL;
 }
@@ -52,6 +52,17 @@ extern "C"
 #endif
 
 
+// the soa solvers in sdk/dgNewtonSse, sdk/dgNewtonAvx, sdk/dgNewtonAvx2 and sdk/dgNewtonAvx512 are also compiled
+// into the engine, so that the vectorized solver is available without loading any plugin file
+#if !defined (_NEWTON_USE_DOUBLE) && !defined (DG_DISABLE_STATIC_SOLVER_PLUGINS) && (defined (_WIN_32_VER) || defined (_WIN_64_VER) || defined (__i386__) || defined (__x86_64__))
+	#define DG_USE_STATIC_SOLVER_PLUGINS
+
+	dgWorldPlugin* dgCreateSseSolverPlugin(dgWorld* const world, dgMemoryAllocator* const allocator);
+	dgWorldPlugin* dgCreateAvxSolverPlugin(dgWorld* const world, dgMemoryAllocator* const allocator);
+	dgWorldPlugin* dgCreateAvx2SolverPlugin(dgWorld* const world, dgMemoryAllocator* const allocator);
+	dgWorldPlugin* dgCreateAvx512SolverPlugin(dgWorld* const world, dgMemoryAllocator* const allocator);
+#endif
+
 class dgWorldPluginModulePair
 {
 	public:
@@ -71,6 +82,7 @@ class dgWorldPluginList: public dgList<dgWorldPluginModulePair>
 	~dgWorldPluginList();
 
 	void LoadPlugins(const char* const path);
+	void LoadStaticPlugins();
 	void UnloadPlugins();
 
 	dgListNode* GetFirstPlugin();
@@ -81,7 +93,9 @@ class dgWorldPluginList: public dgList<dgWorldPluginModulePair>
 	void SelectPlugin(dgListNode* const plugin);
 
 	private:
+	dgListNode* AddPlugin(dgWorldPlugin* const plugin, void* const module);
 	void LoadVisualStudioPlugins(const char* const path);
+	void LoadPosixPlugins(const char* const path);
 
 	dgListNode* m_currentPlugin;
 	dgListNode* m_preferedPlugin;